@@ -0,0 +1,38 @@
+##
+# @file stm_bridge.launch.py
+# @brief Pont du véhicule chargé dans un conteneur de composants, communications
+# intra-processus actives : les nœuds ajoutés au même conteneur reçoivent IMU et
+# odométrie sans copie ni sérialisation
+#
+# Usage : ros2 launch stm_bridge stm_bridge.launch.py port:=/dev/ttyACM0 baud:=921600
+#
+
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import ComposableNodeContainer
+from launch_ros.descriptions import ComposableNode
+
+def generate_launch_description():
+    port = LaunchConfiguration('port')
+    baud = LaunchConfiguration('baud')
+    link_mode = LaunchConfiguration('link_mode')
+    return LaunchDescription([
+        DeclareLaunchArgument('port', default_value='/dev/ttyACM0'),
+        DeclareLaunchArgument('baud', default_value='115200'),
+        DeclareLaunchArgument('link_mode', default_value='raw', description="raw, envelope ou cobs"),
+        ComposableNodeContainer(
+            name='stm_container',
+            namespace='',
+            package='rclcpp_components',
+            executable='component_container_mt',
+            composable_node_descriptions=[
+                ComposableNode(
+                    package='stm_bridge',
+                    plugin='stm_bridge::StmBridge',
+                    name='stm_bridge',
+                    parameters=[{'port': port, 'baud': baud, 'link_mode': link_mode}],
+                    extra_arguments=[{'use_intra_process_comms': True}]),
+            ],
+            output='screen'),
+    ])
@@ -0,0 +1,433 @@
+/**
+ * @file    stm_bridge_node.cpp
+ * @brief   Pont ROS 2 du véhicule, construit sur la bibliothèque hôte (stm_proto.h).
+ * @details Un thread lit le port série et passe chaque bloc reçu à stp_decode() :
+ * les échantillons de télémétrie (types 0x01 à 0x05) deviennent des sensor_msgs/Imu
+ * et des vitesses roue, datés par la synchronisation d'horloge (échos REG_PING,
+ * stp_clock_t) plutôt qu'à l'arrivée des octets. La pose de l'odométrie embarquée est
+ * lue en une trame groupée (REG_ODOM_BASE) et publiée en nav_msgs/Odometry.
+ *
+ * cmd_vel (geometry_msgs/Twist) est traduit en une écriture groupée de REG_SERVO_CMD et
+ * REG_MOTOR_CMD, renvoyée à cmd_period tant que la consigne a moins de cmd_timeout ;
+ * ensuite une consigne nulle est émise une fois et le failsafe du firmware reprend la main.
+ *
+ * Publication : messages prêtés par le middleware quand il le permet
+ * (can_loan_messages()), sinon unique_ptr, transmis sans copie aux abonnés du même
+ * processus avec use_intra_process_comms (composant chargé dans un conteneur, cf.
+ * launch/stm_bridge.launch.py).
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <geometry_msgs/msg/twist.hpp>
+#include <geometry_msgs/msg/twist_stamped.hpp>
+#include <nav_msgs/msg/odometry.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <rclcpp_components/register_node_macro.hpp>
+#include <sensor_msgs/msg/imu.hpp>
+
+#include "proto_def.h"
+#include "stm_proto.h"
+
+namespace stm_bridge
+{
+
+/** @brief Registres utilisés (serial_cmd.h du firmware). */
+constexpr uint8_t REG_SERVO_CMD = 0x00;
+constexpr uint8_t REG_MOTOR_CMD = 0x01;
+constexpr uint8_t REG_PING = 0x53;
+constexpr uint8_t REG_ODOM_BASE = 0x5F;
+constexpr uint8_t REG_ODOM_COUNT = 5;
+constexpr uint8_t REG_CAPS = 0x7B;
+/** @brief Bit de lecture de l'entête de commande. */
+constexpr uint8_t CMD_READ = 0x80;
+/** @brief Course logicielle du servo (°, SERVO_CLAMP_*_CDEG / 100). */
+constexpr double SERVO_MAX_DEG = 20.0;
+/** @brief Échantillons décodés par lecture. */
+constexpr size_t SAMPLES_PER_READ = 256;
+/** @brief Échos en vol suivis (jeton modulo). */
+constexpr uint16_t PING_SLOTS = 64;
+
+using EchoFrame = PROTO_STRUCT(ECHO);
+using CapsFrame = PROTO_STRUCT(CAPS);
+
+/**
+ * @brief Débit termios d'un débit numérique (BAUD_RATES de serial_reg.py).
+ */
+static speed_t to_speed(int baud)
+{
+  switch (baud) {
+    case 115200: return B115200;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    case 2000000: return B2000000;
+    default: return B0;
+  }
+}
+
+/**
+ * @brief Publie un message prêté par le middleware si possible, sinon un unique_ptr
+ * (sans copie vers les abonnés intra-processus).
+ */
+template<typename MsgT, typename FillT>
+static void publish(rclcpp::Publisher<MsgT> & pub, FillT && fill)
+{
+  if (pub.can_loan_messages()) {
+    auto msg = pub.borrow_loaned_message();
+    fill(msg.get());
+    pub.publish(std::move(msg));
+  } else {
+    auto msg = std::make_unique<MsgT>();
+    fill(*msg);
+    pub.publish(std::move(msg));
+  }
+}
+
+class StmBridge : public rclcpp::Node
+{
+public:
+  explicit StmBridge(const rclcpp::NodeOptions & options)
+  : Node("stm_bridge", options)
+  {
+    port_ = declare_parameter<std::string>("port", "/dev/ttyACM0");
+    baud_ = declare_parameter<int>("baud", 115200);
+    const std::string mode = declare_parameter<std::string>("link_mode", "raw");
+    imu_frame_ = declare_parameter<std::string>("imu_frame", "imu_link");
+    odom_frame_ = declare_parameter<std::string>("odom_frame", "odom");
+    base_frame_ = declare_parameter<std::string>("base_frame", "base_link");
+    wheelbase_ = declare_parameter<double>("wheelbase", 0.26);
+    cmd_timeout_ = declare_parameter<double>("cmd_timeout", 0.5);
+    const double cmd_period = declare_parameter<double>("cmd_period", 0.05);
+    const double ping_period = declare_parameter<double>("ping_period", 0.5);
+    const double odom_period = declare_parameter<double>("odom_period", 0.05);
+
+    stp_splitter_init(&splitter_, mode == "cobs" ? STP_MODE_COBS :
+      mode == "envelope" ? STP_MODE_ENVELOPE : STP_MODE_RAW);
+    stp_decoder_init(&decoder_);
+    stp_clock_init(&clock_);
+    samples_.resize(SAMPLES_PER_READ);
+
+    if (!open_port()) {
+      throw std::runtime_error("stm_bridge: cannot open " + port_);
+    }
+
+    const auto qos = rclcpp::SensorDataQoS();
+    imu_pub_ = create_publisher<sensor_msgs::msg::Imu>("imu", qos);
+    speed_pub_ = create_publisher<geometry_msgs::msg::TwistStamped>("wheel_speed", qos);
+    odom_pub_ = create_publisher<nav_msgs::msg::Odometry>("odom", qos);
+    cmd_sub_ = create_subscription<geometry_msgs::msg::Twist>(
+      "cmd_vel", 10, [this](geometry_msgs::msg::Twist::ConstSharedPtr msg) {on_cmd(*msg);});
+
+    using std::chrono::duration;
+    cmd_timer_ = create_wall_timer(duration<double>(cmd_period), [this] {send_cmd();});
+    ping_timer_ = create_wall_timer(duration<double>(ping_period), [this] {send_ping();});
+    odom_timer_ = create_wall_timer(duration<double>(odom_period), [this] {
+        send_cmd_frame(CMD_READ | REG_ODOM_BASE, REG_ODOM_COUNT);
+      });
+
+    /* Capacités : bascule du découpage sur le format annoncé (enveloppé, COBS) */
+    send_cmd_frame(REG_CAPS, 0);
+    running_ = true;
+    reader_ = std::thread([this] {read_loop();});
+  }
+
+  ~StmBridge() override
+  {
+    running_ = false;
+    if (reader_.joinable()) {
+      reader_.join();
+    }
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+private:
+  /** @brief Ouvre le port en mode brut, lecture non bloquante pilotée par poll(). */
+  bool open_port()
+  {
+    const speed_t speed = to_speed(baud_);
+    if (speed == B0) {
+      RCLCPP_ERROR(get_logger(), "unsupported baud rate %d", baud_);
+      return false;
+    }
+    fd_ = ::open(port_.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd_ < 0) {
+      RCLCPP_ERROR(get_logger(), "%s: %s", port_.c_str(), std::strerror(errno));
+      return false;
+    }
+    termios tio{};
+    tcgetattr(fd_, &tio);
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tcsetattr(fd_, TCSANOW, &tio);
+    tcflush(fd_, TCIOFLUSH);
+    return true;
+  }
+
+  /** @brief Émet des octets (appelé depuis les timers, la souscription et le thread de lecture). */
+  void write_bytes(const uint8_t * data, size_t len)
+  {
+    std::lock_guard<std::mutex> lock(tx_mutex_);
+    while (len > 0) {
+      const ssize_t n = ::write(fd_, data, len);
+      if (n < 0) {
+        if (errno == EAGAIN) {
+          pollfd p{fd_, POLLOUT, 0};
+          ::poll(&p, 1, 10);
+          continue;
+        }
+        RCLCPP_WARN_THROTTLE(get_logger(), *get_clock(), 1000, "write: %s", std::strerror(errno));
+        return;
+      }
+      data += n;
+      len -= static_cast<size_t>(n);
+    }
+  }
+
+  void send_cmd_frame(uint8_t hdr, uint16_t value)
+  {
+    uint8_t frame[5];
+    write_bytes(frame, stp_build_cmd(frame, hdr, value));
+  }
+
+  /** @brief Consigne servo (°) et moteur (mm/s) en une trame groupée. */
+  void send_drive(int16_t servo_deg, int16_t motor_mms)
+  {
+    static_assert(REG_MOTOR_CMD == REG_SERVO_CMD + 1, "drive registers must be contiguous");
+    const int16_t values[2] = {servo_deg, motor_mms};
+    uint8_t frame[4 + 2 * STP_BURST_MAX_REGS];
+    write_bytes(frame, stp_build_burst(frame, REG_SERVO_CMD, values, 2));
+  }
+
+  /** @brief cmd_vel : vitesse linéaire (m/s) et lacet (rad/s) -> braquage Ackermann. */
+  void on_cmd(const geometry_msgs::msg::Twist & msg)
+  {
+    const double v = msg.linear.x;
+    double steer = 0.0;
+    if (std::fabs(v) > 1e-3) {
+      steer = std::atan(wheelbase_ * msg.angular.z / v) * 180.0 / M_PI;
+    }
+    steer = std::clamp(steer, -SERVO_MAX_DEG, SERVO_MAX_DEG);
+
+    std::lock_guard<std::mutex> lock(cmd_mutex_);
+    cmd_servo_ = static_cast<int16_t>(std::lround(steer));
+    cmd_motor_ = static_cast<int16_t>(std::clamp(std::lround(v * 1000.0), -32767L, 32767L));
+    cmd_stamp_ = now();
+    cmd_active_ = true;
+    send_drive(cmd_servo_, cmd_motor_);
+  }
+
+  /** @brief Entretien de la liaison tant que la consigne est récente, arrêt une fois sinon. */
+  void send_cmd()
+  {
+    std::lock_guard<std::mutex> lock(cmd_mutex_);
+    if (!cmd_active_) {
+      return;
+    }
+    if ((now() - cmd_stamp_).seconds() > cmd_timeout_) {
+      cmd_active_ = false;
+      send_drive(0, 0);
+      return;
+    }
+    send_drive(cmd_servo_, cmd_motor_);
+  }
+
+  /** @brief Écho REG_PING daté côté hôte (horloge ROS) pour la synchronisation. */
+  void send_ping()
+  {
+    const uint16_t token = ping_token_++ & 0x7FFF;
+    {
+      std::lock_guard<std::mutex> lock(clock_mutex_);
+      ping_h0_[token % PING_SLOTS] = {token, now().nanoseconds()};
+    }
+    send_cmd_frame(REG_PING, token);
+  }
+
+  /** @brief Date ROS d'une date firmware (arrivée si l'horloge n'est pas encore ajustée). */
+  rclcpp::Time stamp(uint32_t t32, const rclcpp::Time & arrival)
+  {
+    std::lock_guard<std::mutex> lock(clock_mutex_);
+    if (!clock_ready_) {
+      return arrival;
+    }
+    return rclcpp::Time(static_cast<int64_t>(stp_clock_mcu_to_host_ns(&clock_, t32)), RCL_ROS_TIME);
+  }
+
+  /** @brief Trames autres que la télémétrie : écho, capacités, réponses groupées. */
+  static void on_other(void * ctx, const stp_frame_t * fr)
+  {
+    static_cast<StmBridge *>(ctx)->handle_other(*fr);
+  }
+
+  void handle_other(const stp_frame_t & fr)
+  {
+    if (fr.kind == STP_KIND_ENV && fr.data[2] == TELEM_TYPE_ECHO && fr.len == sizeof(EchoFrame)) {
+      EchoFrame echo;
+      std::memcpy(&echo, fr.data, sizeof(echo));
+      const int64_t h3 = now().nanoseconds();
+      std::lock_guard<std::mutex> lock(clock_mutex_);
+      const auto & slot = ping_h0_[echo.token % PING_SLOTS];
+      if (slot.token == echo.token && slot.h0_ns != 0) {
+        stp_clock_add(&clock_, slot.h0_ns, h3, echo.t_rx, echo.t_tx);
+        clock_ready_ = stp_clock_fit(&clock_) != 0;
+      }
+    } else if (fr.kind == STP_KIND_ENV && fr.data[2] == TELEM_TYPE_CAPS && fr.len == sizeof(CapsFrame)) {
+      CapsFrame caps;
+      std::memcpy(&caps, fr.data, sizeof(caps));
+      stp_splitter_set_mode(&splitter_, (caps.link & CAPS_LINK_COBS) ? STP_MODE_COBS :
+        (caps.link & CAPS_LINK_ENVELOPE) ? STP_MODE_ENVELOPE : STP_MODE_RAW);
+      RCLCPP_INFO(get_logger(), "firmware protocol %u.%u", caps.version >> 8, caps.version & 0xFF);
+    } else if (fr.kind == STP_KIND_BURST && (fr.data[0] & 0x7F) == REG_ODOM_BASE &&
+      fr.data[1] >= REG_ODOM_COUNT)
+    {
+      int16_t v[REG_ODOM_COUNT];
+      std::memcpy(v, fr.data + 2, sizeof(v));
+      publish_odom(v);
+    }
+  }
+
+  /** @brief Pose embarquée (cm, c°) -> nav_msgs/Odometry, vitesse du dernier échantillon. */
+  void publish_odom(const int16_t v[REG_ODOM_COUNT])
+  {
+    const double yaw = v[2] / 100.0 * M_PI / 180.0;
+    const rclcpp::Time t = now();
+    publish(*odom_pub_, [&](nav_msgs::msg::Odometry & m) {
+        m.header.stamp = t;
+        m.header.frame_id = odom_frame_;
+        m.child_frame_id = base_frame_;
+        m.pose.pose.position.x = v[0] / 100.0;
+        m.pose.pose.position.y = v[1] / 100.0;
+        m.pose.pose.orientation.z = std::sin(yaw / 2.0);
+        m.pose.pose.orientation.w = std::cos(yaw / 2.0);
+        m.twist.twist.linear.x = last_speed_ / 1000.0;
+      });
+  }
+
+  /** @brief Échantillon de télémétrie -> Imu et vitesse roue. */
+  void publish_sample(const stp_sample_t & s, const rclcpp::Time & arrival)
+  {
+    const rclcpp::Time t = stamp(static_cast<uint32_t>(s.t_us), arrival);
+
+    if (s.valid & (STP_S_ACCEL | STP_S_GYRO)) {
+      publish(*imu_pub_, [&](sensor_msgs::msg::Imu & m) {
+          m.header.stamp = t;
+          m.header.frame_id = imu_frame_;
+          if (s.valid & STP_S_ATTITUDE) {
+            m.orientation.w = s.quat[0];
+            m.orientation.x = s.quat[1];
+            m.orientation.y = s.quat[2];
+            m.orientation.z = s.quat[3];
+          } else {
+            m.orientation_covariance[0] = -1.0;
+          }
+          m.linear_acceleration.x = s.accel[0] / 1000.0;
+          m.linear_acceleration.y = s.accel[1] / 1000.0;
+          m.linear_acceleration.z = s.accel[2] / 1000.0;
+          m.angular_velocity.x = s.gyro[0];
+          m.angular_velocity.y = s.gyro[1];
+          m.angular_velocity.z = s.gyro[2];
+        });
+    }
+    if (s.valid & STP_S_SPEED) {
+      last_speed_ = s.speed;
+      publish(*speed_pub_, [&](geometry_msgs::msg::TwistStamped & m) {
+          m.header.stamp = t;
+          m.header.frame_id = base_frame_;
+          m.twist.linear.x = s.speed / 1000.0;
+        });
+    }
+  }
+
+  /** @brief Lecture du port : un appel à stp_decode() par bloc reçu. */
+  void read_loop()
+  {
+    uint8_t buf[STP_RX_BUF_LEN];
+    pollfd p{fd_, POLLIN, 0};
+
+    while (running_ && rclcpp::ok()) {
+      if (::poll(&p, 1, 100) <= 0) {
+        continue;
+      }
+      const ssize_t n = ::read(fd_, buf, sizeof(buf));
+      if (n <= 0) {
+        if (n < 0 && errno != EAGAIN) {
+          RCLCPP_ERROR(get_logger(), "read: %s", std::strerror(errno));
+          return;
+        }
+        continue;
+      }
+
+      const rclcpp::Time arrival = now();
+      const uint8_t * data = buf;
+      size_t len = static_cast<size_t>(n);
+      size_t got;
+      /* out plein : reprise sur les octets en attente (data NULL) jusqu'à épuisement */
+      do {
+        got = stp_decode(&splitter_, &decoder_, data, len, samples_.data(), samples_.size(),
+            &StmBridge::on_other, this);
+        for (size_t i = 0; i < got; i++) {
+          publish_sample(samples_[i], arrival);
+        }
+        data = nullptr;
+        len = 0;
+      } while (got == samples_.size());
+    }
+  }
+
+  struct PingSlot
+  {
+    uint16_t token;
+    int64_t h0_ns;
+  };
+
+  std::string port_;
+  int baud_;
+  std::string imu_frame_, odom_frame_, base_frame_;
+  double wheelbase_, cmd_timeout_;
+  int fd_ = -1;
+
+  stp_splitter_t splitter_;
+  stp_decoder_t decoder_;
+  stp_clock_t clock_;
+  bool clock_ready_ = false;
+  std::vector<stp_sample_t> samples_;
+  float last_speed_ = 0.0f;
+
+  std::mutex tx_mutex_, cmd_mutex_, clock_mutex_;
+  PingSlot ping_h0_[PING_SLOTS] = {};
+  uint16_t ping_token_ = 0;
+  int16_t cmd_servo_ = 0, cmd_motor_ = 0;
+  rclcpp::Time cmd_stamp_;
+  bool cmd_active_ = false;
+
+  std::atomic<bool> running_{false};
+  std::thread reader_;
+
+  rclcpp::Publisher<sensor_msgs::msg::Imu>::SharedPtr imu_pub_;
+  rclcpp::Publisher<geometry_msgs::msg::TwistStamped>::SharedPtr speed_pub_;
+  rclcpp::Publisher<nav_msgs::msg::Odometry>::SharedPtr odom_pub_;
+  rclcpp::Subscription<geometry_msgs::msg::Twist>::SharedPtr cmd_sub_;
+  rclcpp::TimerBase::SharedPtr cmd_timer_, ping_timer_, odom_timer_;
+};
+
+}  // namespace stm_bridge
+
+RCLCPP_COMPONENTS_REGISTER_NODE(stm_bridge::StmBridge)
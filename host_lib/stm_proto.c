@@ -0,0 +1,577 @@
+/**
+ * @file    stm_proto.c
+ * @brief   Implémentation de la bibliothèque hôte du protocole (cf. stm_proto.h).
+ * @details Le découpage suit split_frames(), split_envelopes() et split_cobs() de
+ * serial_reg.py, le décodage _decode_and_show_imu() et decode_delta_batch(), la
+ * synchronisation ClockSync de clock_sync.py : les deux implémentations doivent
+ * rendre les mêmes trames et les mêmes valeurs.
+ */
+
+#include "stm_proto.h"
+#include "proto_def.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+_Static_assert(sizeof(stp_sample_t) == 64u, "stp_sample_t layout is shared with the Python bindings");
+
+/** @brief Synchronisations des trames. */
+#define STP_SYNC_ENV1           0xAAu
+#define STP_SYNC_ENV2           0x55u
+#define STP_SYNC_CMD            0xA5u
+#define STP_SYNC_BURST          0xA6u
+
+/** @brief Échappement des deltas du lot type 0x05 (suivi de la valeur absolue int16). */
+#define STP_DELTA_ESCAPE        (-128)
+
+/** @brief Accélération de la pesanteur (mm/s² par g) et degrés -> radians. */
+#define STP_G_TO_MM_S2          9806.65f
+#define STP_DEG_TO_RAD          0.017453292519943295f
+
+/** @brief Fraction des échanges retenue et minimum pour estimer une dérive (clock_sync.py). */
+#define STP_CLOCK_KEEP_DIV      4u
+#define STP_CLOCK_MIN_POINTS    8u
+
+/** @brief Échelles BMI088 (LSB/g et LSB/dps) indexées par code de gamme, identiques au firmware. */
+static const float accel_range_lsb[4] = {10922.67f, 5461.33f, 2730.67f, 1365.33f};
+static const float gyro_range_lsb[5]  = {16.4f, 32.768f, 65.6f, 131.2f, 262.4f};
+
+/** @brief Longueur de chaque champ de la trame type 0x03, dans l'ordre des bits (proto_def.h). */
+#define STP_X_FIELD_LEN(name, bit, len, fmt)    (len),
+static const uint8_t telem_field_len[8] = { PROTO_TELEM_FIELDS(STP_X_FIELD_LEN) };
+
+static uint8_t crc_table[256];
+static int crc_ready = 0;
+
+/** @brief Construit la table CRC-8 (polynôme 0x07). */
+static void crc_init(void){
+    for(unsigned i = 0; i < 256u; i++){
+        uint8_t c = (uint8_t)i;
+        for(unsigned b = 0; b < 8u; b++){
+            c = (uint8_t)((c & 0x80u) ? ((unsigned)(c << 1) ^ 0x07u) : (unsigned)(c << 1));
+        }
+        crc_table[i] = c;
+    }
+    crc_ready = 1;
+}
+
+uint8_t stp_crc8(const uint8_t *data, size_t len){
+    uint8_t crc = 0;
+
+    if(!crc_ready){
+        crc_init();
+    }
+    while(len--){
+        crc = crc_table[crc ^ *data++];
+    }
+    return crc;
+}
+
+static inline uint16_t rd_u16(const uint8_t *p){ return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline int16_t  rd_i16(const uint8_t *p){ return (int16_t)rd_u16(p); }
+static inline uint32_t rd_u32(const uint8_t *p){
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+static inline int32_t  rd_i32(const uint8_t *p){ return (int32_t)rd_u32(p); }
+static inline float    rd_f32(const uint8_t *p){ uint32_t u = rd_u32(p); float f; memcpy(&f, &u, 4); return f; }
+
+/* ---------------------------------------------------------------------------
+ * Découpage
+ * ------------------------------------------------------------------------- */
+
+void stp_splitter_init(stp_splitter_t *sp, uint8_t mode){
+    memset(sp, 0, sizeof(*sp));
+    sp->mode = mode;
+}
+
+void stp_splitter_set_mode(stp_splitter_t *sp, uint8_t mode){
+    sp->mode = mode;
+}
+
+size_t stp_push(stp_splitter_t *sp, const uint8_t *data, size_t len){
+    if(sp->pos != 0u){
+        memmove(sp->buf, sp->buf + sp->pos, sp->len - sp->pos);
+        sp->len -= sp->pos;
+        sp->pos = 0;
+    }
+
+    size_t room = STP_RX_BUF_LEN - sp->len;
+    if(len > room){
+        sp->overflow += len - room;
+        len = room;
+    }
+    memcpy(sp->buf + sp->len, data, len);
+    sp->len += len;
+    return len;
+}
+
+/**
+ * @brief  Vérifie qu'un bloc est une enveloppe complète [AA 55 | type | LEN | ... | CRC].
+ */
+static int is_envelope(const uint8_t *f, size_t n){
+    return n >= 5u && f[0] == STP_SYNC_ENV1 && f[1] == STP_SYNC_ENV2 &&
+           n == (size_t)f[3] + 5u && stp_crc8(f, n - 1u) == f[n - 1u];
+}
+
+/**
+ * @brief  Décode un bloc COBS (sans délimiteur) dans sp->cobs.
+ * @return Longueur décodée, 0 si le bloc est invalide ou trop long.
+ */
+static size_t cobs_decode(stp_splitter_t *sp, const uint8_t *blk, size_t n){
+    size_t pos = 0, out = 0;
+
+    while(pos < n){
+        const uint8_t code = blk[pos];
+        const size_t end = pos + code;
+        if(code == 0u || end > n || out + code > sizeof(sp->cobs)){
+            return 0;
+        }
+        memcpy(sp->cobs + out, blk + pos + 1u, code - 1u);
+        out += code - 1u;
+        pos = end;
+        if(code != 0xFFu && pos < n){
+            sp->cobs[out++] = 0;
+        }
+    }
+    return out;
+}
+
+/** @brief Rend la trame [pos, end) et avance. */
+static int emit(stp_splitter_t *sp, stp_frame_t *out, size_t start, size_t end, uint8_t kind){
+    out->data = sp->buf + start;
+    out->len  = (uint16_t)(end - start);
+    out->kind = kind;
+    sp->frames++;
+    return 1;
+}
+
+/** @brief Découpage d'un flux enveloppé ou mêlé (split_frames / split_envelopes). */
+static int next_raw(stp_splitter_t *sp, stp_frame_t *out){
+    const uint8_t *b = sp->buf;
+    const size_t n = sp->len;
+    const int env_only = (sp->mode == STP_MODE_ENVELOPE);
+
+    while(sp->pos < n){
+        const size_t pos = sp->pos;
+        const uint8_t b0 = b[pos];
+        size_t end;
+
+        if(b0 == STP_SYNC_ENV1){
+            if(n - pos < 2u) return 0;
+            if(b[pos + 1u] != STP_SYNC_ENV2){ sp->pos++; sp->skipped++; continue; }
+            if(n - pos < 4u) return 0;
+            end = pos + 4u + b[pos + 3u] + 1u;
+            if(end > n) return 0;
+            if(stp_crc8(b + pos, end - pos - 1u) == b[end - 1u]){
+                sp->pos = end;
+                return emit(sp, out, pos, end, STP_KIND_ENV);
+            }
+        }
+        else if(env_only){
+            /* Flux entièrement enveloppé : recalage direct sur la synchronisation suivante */
+            const uint8_t *p = memchr(b + pos, STP_SYNC_ENV1, n - pos);
+            const size_t skip = (p != NULL) ? (size_t)(p - (b + pos)) : (n - pos);
+            sp->pos += skip;
+            sp->skipped += skip;
+            continue;
+        }
+        else if(b0 == STP_SYNC_CMD){
+            end = pos + 5u;
+            if(end > n) return 0;
+            if(stp_crc8(b + pos + 1u, 3u) == b[end - 1u]){
+                sp->pos = end;
+                return emit(sp, out, pos + 1u, end, STP_KIND_CMD);
+            }
+        }
+        else if(b0 == STP_SYNC_BURST){
+            if(n - pos < 3u) return 0;
+            const uint8_t count = b[pos + 2u];
+            if(count != 0u){
+                end = pos + 4u + 2u * count;
+                if(end > n) return 0;
+                if(stp_crc8(b + pos + 1u, end - pos - 2u) == b[end - 1u]){
+                    sp->pos = end;
+                    return emit(sp, out, pos + 1u, end, STP_KIND_BURST);
+                }
+            }
+        }
+        else if((b0 & 0x80u) == 0u){
+            end = pos + 4u;
+            if(end > n) return 0;
+            if(stp_crc8(b + pos, 3u) == b[end - 1u]){
+                sp->pos = end;
+                return emit(sp, out, pos, end, STP_KIND_CMD);
+            }
+        }
+
+        sp->pos++;
+        sp->skipped++;
+    }
+    return 0;
+}
+
+/** @brief Découpage d'un flux COBS (split_cobs). */
+static int next_cobs(stp_splitter_t *sp, stp_frame_t *out){
+    while(sp->pos < sp->len){
+        const uint8_t *start = sp->buf + sp->pos;
+        const uint8_t *zero = memchr(start, 0, sp->len - sp->pos);
+        if(zero == NULL){
+            return 0;
+        }
+
+        const size_t blk = (size_t)(zero - start);
+        sp->pos += blk + 1u;
+        if(blk == 0u){
+            continue;
+        }
+
+        const size_t n = cobs_decode(sp, start, blk);
+        if(is_envelope(sp->cobs, n)){
+            out->data = sp->cobs;
+            out->len  = (uint16_t)n;
+            out->kind = STP_KIND_ENV;
+            sp->frames++;
+            return 1;
+        }
+        sp->skipped += blk + 1u;
+    }
+    return 0;
+}
+
+int stp_next(stp_splitter_t *sp, stp_frame_t *out){
+    return (sp->mode == STP_MODE_COBS) ? next_cobs(sp, out) : next_raw(sp, out);
+}
+
+/* ---------------------------------------------------------------------------
+ * Décodage de la télémétrie
+ * ------------------------------------------------------------------------- */
+
+void stp_decoder_init(stp_decoder_t *dec){
+    memset(dec, 0, sizeof(*dec));
+}
+
+/** @brief Déroule une date firmware 32 bits (monotone) sur 64 bits. */
+static uint64_t unwrap(stp_decoder_t *dec, uint32_t t32){
+    if(dec->started && t32 < dec->last_t32 && (dec->last_t32 - t32) > 0x80000000u){
+        dec->high += (uint64_t)1 << 32;
+    }
+    dec->last_t32 = t32;
+    return dec->high + t32;
+}
+
+/** @brief Axes bruts BMI088 -> mm/s² et rad/s (scale_raw_axes). */
+static void scale_raw(stp_sample_t *s, const int16_t axes[6], uint8_t ranges){
+    const float acc_k = STP_G_TO_MM_S2 / accel_range_lsb[ranges & 0x03u];
+    uint8_t g = (uint8_t)((ranges >> 2) & 0x07u);
+    const float gyr_k = STP_DEG_TO_RAD / gyro_range_lsb[(g > 4u) ? 4u : g];
+
+    for(unsigned i = 0; i < 3u; i++){
+        s->accel[i] = (float)axes[i] * acc_k;
+        s->gyro[i]  = (float)axes[3u + i] * gyr_k;
+    }
+    s->valid |= STP_S_ACCEL | STP_S_GYRO;
+}
+
+/** @brief Champs présents d'une trame type 0x03, dans l'ordre des bits. */
+static int decode_fields(stp_sample_t *s, const uint8_t *f, size_t len){
+    const uint8_t mask = f[10];
+    size_t off = 11u;
+
+    for(unsigned bit = 0; bit < 8u; bit++){
+        if(!(mask & (1u << bit))){
+            continue;
+        }
+        if(off + telem_field_len[bit] > len - 1u){
+            return 0;
+        }
+        const uint8_t *p = f + off;
+        switch(1u << bit){
+            case TELEM_F_ACCEL:
+                for(unsigned i = 0; i < 3u; i++) s->accel[i] = (float)rd_i32(p + 4u * i);
+                s->valid |= STP_S_ACCEL;
+                break;
+            case TELEM_F_GYRO:
+                for(unsigned i = 0; i < 3u; i++) s->gyro[i] = (float)rd_i32(p + 4u * i) * 1e-6f;
+                s->valid |= STP_S_GYRO;
+                break;
+            case TELEM_F_SPEED:
+                s->speed = (float)rd_i16(p);
+                s->valid |= STP_S_SPEED;
+                break;
+            case TELEM_F_ATTITUDE:
+                for(unsigned i = 0; i < 4u; i++) s->quat[i] = (float)rd_i16(p + 2u * i) / 16384.0f;
+                s->valid |= STP_S_ATTITUDE;
+                break;
+            default:
+                break;
+        }
+        off += telem_field_len[bit];
+    }
+    return 1;
+}
+
+size_t stp_decode_frame(stp_decoder_t *dec, const uint8_t *f, size_t len, stp_sample_t *out, size_t max){
+    if(len < 11u || max == 0u || f[0] != STP_SYNC_ENV1 || f[1] != STP_SYNC_ENV2){
+        return 0;
+    }
+
+    const uint8_t type = f[2];
+    const uint16_t seq = rd_u16(f + 4);
+    const uint32_t t32 = rd_u32(f + 6);
+    size_t n = 1;
+
+    memset(out, 0, sizeof(*out));
+    out->seq  = seq;
+    out->type = type;
+
+    switch(type){
+        case TELEM_TYPE_LEGACY:
+            if(len != sizeof(PROTO_STRUCT(LEGACY))) return 0;
+            for(unsigned i = 0; i < 3u; i++){
+                out->accel[i] = rd_f32(f + 10u + 4u * i);
+                out->gyro[i]  = rd_f32(f + 22u + 4u * i);
+            }
+            out->speed = rd_f32(f + 34u) * 1000.0f;
+            out->valid = STP_S_ACCEL | STP_S_GYRO | STP_S_SPEED;
+            break;
+
+        case TELEM_TYPE_FX:
+            if(len != sizeof(PROTO_STRUCT(FX))) return 0;
+            for(unsigned i = 0; i < 3u; i++){
+                out->accel[i] = (float)rd_i32(f + 10u + 4u * i);
+                out->gyro[i]  = (float)rd_i32(f + 22u + 4u * i) * 1e-6f;
+            }
+            out->speed = (float)rd_i16(f + 34u);
+            out->valid = STP_S_ACCEL | STP_S_GYRO | STP_S_SPEED;
+            break;
+
+        case TELEM_TYPE_COMPACT:{
+            if(len != sizeof(PROTO_STRUCT(COMPACT))) return 0;
+            int16_t axes[6];
+            for(unsigned i = 0; i < 6u; i++) axes[i] = rd_i16(f + 11u + 2u * i);
+            scale_raw(out, axes, f[10]);
+            out->speed = (float)rd_i16(f + 23u);
+            out->valid |= STP_S_SPEED;
+            break;
+        }
+
+        case TELEM_TYPE_FIELDS:
+            if(!decode_fields(out, f, len)) return 0;
+            break;
+
+        case TELEM_TYPE_DELTA:{
+            /* [seq | ts | ranges | count | speed | 6 x int16 | (dt u16 | 6 x (i8 | ESC int16)) x (count - 1)] */
+            if(len < 4u + 22u + 1u) return 0;
+            const uint8_t ranges = f[10];
+            const uint8_t count  = f[11];
+            const float speed    = (float)rd_i16(f + 12u);
+            const size_t stop    = len - 1u;
+            size_t off = 14u;
+            uint32_t t = t32;
+            int16_t axes[6];
+
+            if(count == 0u || count > max) return 0;
+            for(unsigned i = 0; i < 6u; i++) axes[i] = rd_i16(f + off + 2u * i);
+            off += 12u;
+
+            for(n = 0; n < count; n++){
+                stp_sample_t *s = &out[n];
+                if(n != 0u){
+                    if(off + 2u > stop) return 0;
+                    t += rd_u16(f + off);
+                    off += 2u;
+                    for(unsigned i = 0; i < 6u; i++){
+                        if(off + 1u > stop) return 0;
+                        const int8_t d = (int8_t)f[off++];
+                        if(d == STP_DELTA_ESCAPE){
+                            if(off + 2u > stop) return 0;
+                            axes[i] = rd_i16(f + off);
+                            off += 2u;
+                        }
+                        else{
+                            axes[i] = (int16_t)(axes[i] + d);
+                        }
+                    }
+                    memset(s, 0, sizeof(*s));
+                    s->seq  = seq;
+                    s->type = type;
+                }
+                scale_raw(s, axes, ranges);
+                s->speed = speed;
+                s->valid |= STP_S_SPEED;
+                s->t_us  = unwrap(dec, t);
+                dec->started = 1;
+            }
+            break;
+        }
+
+        default:
+            return 0;
+    }
+
+    if(type != TELEM_TYPE_DELTA){
+        out->t_us = unwrap(dec, t32);
+        dec->started = 1;
+    }
+
+    if(dec->decoded != 0u){
+        dec->lost += (uint16_t)(seq - dec->seq_next);
+    }
+    dec->seq_next = (uint16_t)(seq + 1u);
+    dec->decoded++;
+    return n;
+}
+
+size_t stp_decode(stp_splitter_t *sp, stp_decoder_t *dec, const uint8_t *data, size_t len,
+                  stp_sample_t *out, size_t max,
+                  void (*other)(void *ctx, const stp_frame_t *frame), void *ctx){
+    stp_frame_t fr;
+    size_t n = 0;
+
+    if(data != NULL && len != 0u){
+        (void)stp_push(sp, data, len);
+    }
+
+    /* Une trame n'est retirée que si ses échantillons tiennent dans out (lot delta : 255 au plus) */
+    while(n < max){
+        const size_t save = sp->pos;
+        if(!stp_next(sp, &fr)){
+            break;
+        }
+        if(fr.kind == STP_KIND_ENV && fr.data[2] >= TELEM_TYPE_LEGACY && fr.data[2] <= TELEM_TYPE_DELTA){
+            if(fr.data[2] == TELEM_TYPE_DELTA && fr.len > 11u && fr.data[11] > max - n){
+                sp->pos = save;
+                sp->frames--;
+                break;
+            }
+            n += stp_decode_frame(dec, fr.data, fr.len, out + n, max - n);
+        }
+        else if(other != NULL){
+            other(ctx, &fr);
+        }
+    }
+    return n;
+}
+
+/* ---------------------------------------------------------------------------
+ * Commandes
+ * ------------------------------------------------------------------------- */
+
+size_t stp_build_cmd(uint8_t *out, uint8_t hdr, uint16_t value){
+    out[0] = STP_SYNC_CMD;
+    out[1] = hdr;
+    out[2] = (uint8_t)value;
+    out[3] = (uint8_t)(value >> 8);
+    out[4] = stp_crc8(out + 1, 3u);
+    return 5u;
+}
+
+size_t stp_build_burst(uint8_t *out, uint8_t addr, const int16_t *values, uint8_t count){
+    if(count == 0u || count > STP_BURST_MAX_REGS){
+        return 0;
+    }
+
+    out[0] = STP_SYNC_BURST;
+    out[1] = addr & 0x7Fu;
+    out[2] = count;
+    for(unsigned i = 0; i < count; i++){
+        out[3u + 2u * i] = (uint8_t)values[i];
+        out[4u + 2u * i] = (uint8_t)((uint16_t)values[i] >> 8);
+    }
+    out[3u + 2u * count] = stp_crc8(out + 1, 2u + 2u * count);
+    return 4u + 2u * count;
+}
+
+/* ---------------------------------------------------------------------------
+ * Synchronisation d'horloge
+ * ------------------------------------------------------------------------- */
+
+void stp_clock_init(stp_clock_t *clk){
+    memset(clk, 0, sizeof(*clk));
+}
+
+void stp_clock_add(stp_clock_t *clk, int64_t h0_ns, int64_t h3_ns, uint32_t t_rx, uint32_t t_tx){
+    const double fw_ns = (double)(uint32_t)(t_tx - t_rx) * 1000.0;
+    const double link_ns = (double)(h3_ns - h0_ns) - fw_ns;
+
+    if(link_ns < 0.0){
+        return;
+    }
+
+    if(clk->started && t_rx < clk->last_t32 && (clk->last_t32 - t_rx) > 0x80000000u){
+        clk->high += (uint64_t)1 << 32;
+    }
+    clk->last_t32 = t_rx;
+    clk->started = 1;
+
+    const double mid_us = (double)(clk->high + t_rx) + fw_ns / 2000.0;
+    stp_clock_point_t *p = &clk->pts[clk->next];
+    p->mcu_us    = mid_us;
+    p->offset_ns = ((double)h0_ns + (double)h3_ns) / 2.0 - mid_us * 1000.0;
+    p->link_ns   = link_ns;
+
+    clk->next = (clk->next + 1u) % STP_CLOCK_WINDOW;
+    if(clk->count < STP_CLOCK_WINDOW){
+        clk->count++;
+    }
+}
+
+/** @brief Tri par durée de liaison croissante. */
+static int cmp_link(const void *a, const void *b){
+    const double la = ((const stp_clock_point_t *)a)->link_ns;
+    const double lb = ((const stp_clock_point_t *)b)->link_ns;
+    return (la > lb) - (la < lb);
+}
+
+int stp_clock_fit(stp_clock_t *clk){
+    stp_clock_point_t best[STP_CLOCK_WINDOW];
+
+    if(clk->count == 0u){
+        return 0;
+    }
+
+    memcpy(best, clk->pts, clk->count * sizeof(best[0]));
+    qsort(best, clk->count, sizeof(best[0]), cmp_link);
+
+    uint32_t n = clk->count / STP_CLOCK_KEEP_DIV;
+    if(n == 0u) n = 1u;
+
+    if(n < STP_CLOCK_MIN_POINTS){
+        clk->mcu_ref_us = best[0].mcu_us;
+        clk->offset_ns  = best[0].offset_ns;
+        clk->drift      = 0.0;
+        return 1;
+    }
+
+    double mx = 0.0, my = 0.0, sxx = 0.0, sxy = 0.0;
+    for(uint32_t i = 0; i < n; i++){
+        mx += best[i].mcu_us;
+        my += best[i].offset_ns;
+    }
+    mx /= n;
+    my /= n;
+    for(uint32_t i = 0; i < n; i++){
+        const double dx = best[i].mcu_us - mx;
+        sxx += dx * dx;
+        sxy += dx * (best[i].offset_ns - my);
+    }
+
+    clk->drift      = (sxx > 0.0) ? sxy / sxx : 0.0;
+    clk->mcu_ref_us = mx;
+    clk->offset_ns  = my;
+    return 1;
+}
+
+double stp_clock_mcu_to_host_ns(const stp_clock_t *clk, uint32_t t32){
+    const int64_t ref = (int64_t)(clk->high + clk->last_t32);
+    int64_t v = (ref & ~(int64_t)0xFFFFFFFF) | (int64_t)t32;
+
+    if(v - ref > (int64_t)0x80000000){
+        v -= (int64_t)1 << 32;
+    }
+    else if(ref - v > (int64_t)0x80000000){
+        v += (int64_t)1 << 32;
+    }
+
+    return (double)v * 1000.0 + clk->offset_ns + clk->drift * ((double)v - clk->mcu_ref_us);
+}
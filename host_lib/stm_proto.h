@@ -0,0 +1,250 @@
+/**
+ * @file    stm_proto.h
+ * @brief   Bibliothèque hôte native du protocole série (C99, utilisable en C++).
+ * @details Équivalent compilé des décodeurs de python_serial_reg/serial_reg.py, pour
+ * suivre la télémétrie au débit de la liaison sans coût processeur notable :
+ * - CRC-8/ATM par table ;
+ * - découpage des trames d'un flux brut, enveloppé ou COBS (stp_splitter_t) ;
+ * - décodage par lots des trames de télémétrie (types 0x01 à 0x05) vers un tableau
+ *   contigu d'échantillons en unités physiques (stp_sample_t) ;
+ * - construction des trames de commande (simple et groupée) ;
+ * - synchronisation d'horloge hôte <-> firmware par échos (REG_PING, stp_clock_t).
+ *
+ * Les types de trame et dispositions viennent de proto_def.h du firmware : une trame
+ * ajoutée au firmware est connue ici à la recompilation. Aucune allocation :
+ * l'appelant fournit les structures d'état et les tableaux de sortie.
+ * Liaison Python : python_serial_reg/stm_proto.py (ctypes).
+ */
+
+#ifndef STM_PROTO_H_
+#define STM_PROTO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Capacité du tampon de découpage (octets, au moins deux trames de 260 octets). */
+#define STP_RX_BUF_LEN          4096u
+/** @brief Plus longue trame montante (entête 4 + payload 255 + CRC). */
+#define STP_FRAME_MAX_LEN       260u
+/** @brief Registres par trame groupée (PROTO_BURST_MAX_REGS). */
+#define STP_BURST_MAX_REGS      8u
+/** @brief Échanges conservés par la synchronisation d'horloge. */
+#define STP_CLOCK_WINDOW        512u
+
+/**
+ * @brief Nature d'une trame découpée (mêmes valeurs que FRAME_* de serial_reg.py).
+ */
+typedef enum{
+    STP_KIND_ENV = 0,           ///< Trame enveloppée [AA 55 | type | LEN | payload | CRC].
+    STP_KIND_CMD = 1,           ///< Réponse de commande [HDR | D0 | D1 | CRC] (sans SYNC).
+    STP_KIND_BURST = 2          ///< Réponse de lecture groupée [HDR | COUNT | N x int16 | CRC] (sans SYNC).
+} stp_kind_t;
+
+/**
+ * @brief Format du flux montant (capacités du firmware, bits CAPS_LINK_*).
+ */
+typedef enum{
+    STP_MODE_RAW = 0,           ///< Trames enveloppées et réponses de commande mêlées.
+    STP_MODE_ENVELOPE,          ///< Tout enveloppé (CAPS_LINK_ENVELOPE).
+    STP_MODE_COBS               ///< Enveloppes encodées COBS, séparées par 0x00 (CAPS_LINK_COBS).
+} stp_mode_t;
+
+/**
+ * @brief Trame découpée ; data reste valide jusqu'au prochain stp_push().
+ */
+typedef struct{
+    const uint8_t *data;        ///< Octets de la trame.
+    uint16_t len;               ///< Longueur (octets).
+    uint8_t kind;               ///< Nature (stp_kind_t).
+} stp_frame_t;
+
+/**
+ * @brief État du découpage d'un lien.
+ */
+typedef struct{
+    uint8_t buf[STP_RX_BUF_LEN];        ///< Octets reçus non consommés.
+    uint8_t cobs[STP_FRAME_MAX_LEN];    ///< Dernière trame décodée (mode COBS).
+    size_t len;                         ///< Octets valides dans buf.
+    size_t pos;                         ///< Position de découpage.
+    uint8_t mode;                       ///< Format du flux (stp_mode_t).
+    uint64_t frames;                    ///< Trames valides.
+    uint64_t skipped;                   ///< Octets sautés (recalage, CRC faux).
+    uint64_t overflow;                  ///< Octets refusés, tampon plein.
+} stp_splitter_t;
+
+/** @brief Champs valides d'un échantillon. */
+#define STP_S_ACCEL             0x01u
+#define STP_S_GYRO              0x02u
+#define STP_S_SPEED             0x04u
+#define STP_S_ATTITUDE          0x08u
+
+/**
+ * @brief Échantillon de télémétrie en unités physiques (disposition fixe, 64 octets).
+ */
+typedef struct{
+    uint64_t t_us;              ///< Date firmware déroulée sur 64 bits (µs).
+    uint16_t seq;               ///< Numéro de la trame d'origine.
+    uint8_t type;               ///< Type de la trame d'origine (TELEM_TYPE_*).
+    uint8_t valid;              ///< Champs valides (STP_S_*).
+    float accel[3];             ///< Accélération (mm/s²).
+    float gyro[3];              ///< Vitesse angulaire (rad/s).
+    float speed;                ///< Vitesse (mm/s).
+    float quat[4];              ///< Quaternion w, x, y, z (trame 0x03 avec TELEM_F_ATTITUDE).
+    uint32_t reserved[2];       ///< Bourrage (64 octets).
+} stp_sample_t;
+
+/**
+ * @brief État du décodage de télémétrie d'un lien.
+ */
+typedef struct{
+    uint32_t last_t32;          ///< Dernière date firmware 32 bits.
+    uint64_t high;              ///< Poids forts du déroulement.
+    uint8_t started;            ///< Première trame reçue.
+    uint16_t seq_next;          ///< Numéro attendu.
+    uint64_t lost;              ///< Trames perdues (sauts de numéro).
+    uint64_t decoded;           ///< Trames de télémétrie décodées.
+} stp_decoder_t;
+
+/**
+ * @brief Échange d'écho retenu par la synchronisation.
+ */
+typedef struct{
+    double mcu_us;              ///< Milieu du passage firmware (µs déroulées).
+    double offset_ns;           ///< Écart hôte - firmware au milieu (ns).
+    double link_ns;             ///< Durée de liaison (aller-retour moins firmware, ns).
+} stp_clock_point_t;
+
+/**
+ * @brief Synchronisation d'horloge (même méthode que clock_sync.py).
+ */
+typedef struct{
+    stp_clock_point_t pts[STP_CLOCK_WINDOW];   ///< Fenêtre glissante d'échanges.
+    uint32_t count;             ///< Échanges dans la fenêtre.
+    uint32_t next;              ///< Prochaine place.
+    uint32_t last_t32;          ///< Dernière date firmware (déroulement).
+    uint64_t high;              ///< Poids forts du déroulement.
+    uint8_t started;            ///< Premier échange reçu.
+    double mcu_ref_us;          ///< Date firmware de référence de l'ajustement (µs).
+    double offset_ns;           ///< Date hôte de mcu_ref_us (ns).
+    double drift;               ///< ns hôte par µs firmware, moins 1000.
+} stp_clock_t;
+
+/**
+ * @brief  CRC-8/ATM (polynôme 0x07, valeur initiale 0).
+ */
+uint8_t stp_crc8(const uint8_t *data, size_t len);
+
+/**
+ * @brief  Initialise le découpage d'un lien.
+ * @param  sp   État.
+ * @param  mode Format du flux (stp_mode_t).
+ */
+void stp_splitter_init(stp_splitter_t *sp, uint8_t mode);
+
+/**
+ * @brief  Change le format du flux (capacités reçues) ; les octets en attente sont gardés.
+ */
+void stp_splitter_set_mode(stp_splitter_t *sp, uint8_t mode);
+
+/**
+ * @brief  Ajoute des octets reçus ; les trames déjà rendues sont d'abord retirées.
+ * @return Octets acceptés (les autres sont comptés dans overflow).
+ */
+size_t stp_push(stp_splitter_t *sp, const uint8_t *data, size_t len);
+
+/**
+ * @brief  Trame valide suivante.
+ * @param  sp  État.
+ * @param  out Trame (pointeur dans l'état, valide jusqu'au prochain stp_push()).
+ * @return 1 si une trame est rendue, 0 s'il faut plus d'octets.
+ */
+int stp_next(stp_splitter_t *sp, stp_frame_t *out);
+
+/**
+ * @brief  Initialise le décodage de télémétrie.
+ */
+void stp_decoder_init(stp_decoder_t *dec);
+
+/**
+ * @brief  Décode une trame de télémétrie (types 0x01 à 0x05) en échantillons.
+ * @param  dec   État (déroulement des dates, pertes).
+ * @param  frame Trame enveloppée complète.
+ * @param  len   Longueur de la trame.
+ * @param  out   Échantillons (un par trame, jusqu'à 255 pour un lot delta).
+ * @param  max   Places disponibles dans out.
+ * @return Échantillons écrits ; 0 si la trame n'est pas de la télémétrie ou ne tient pas.
+ */
+size_t stp_decode_frame(stp_decoder_t *dec, const uint8_t *frame, size_t len, stp_sample_t *out, size_t max);
+
+/**
+ * @brief  Découpe et décode un bloc reçu en un seul appel.
+ * @details Les trames qui ne sont pas de la télémétrie sont passées à other (si non
+ * NULL) ; le découpage s'arrête quand out est plein, le reste attend l'appel suivant.
+ * @param  sp      Découpage du lien.
+ * @param  dec     Décodage du lien.
+ * @param  data    Octets reçus (NULL / 0 : reprise sur les octets déjà en attente).
+ * @param  len     Longueur.
+ * @param  out     Échantillons.
+ * @param  max     Places disponibles dans out.
+ * @param  other   Appelée pour chaque autre trame (réponses, journal, écho...).
+ * @param  ctx     Contexte de other.
+ * @return Échantillons écrits.
+ */
+size_t stp_decode(stp_splitter_t *sp, stp_decoder_t *dec, const uint8_t *data, size_t len,
+                  stp_sample_t *out, size_t max,
+                  void (*other)(void *ctx, const stp_frame_t *frame), void *ctx);
+
+/**
+ * @brief  Trame de commande [A5 | HDR | D0 | D1 | CRC].
+ * @param  out   Destination (5 octets).
+ * @param  hdr   Entête (bit 7 = lecture, bits 6..0 = adresse).
+ * @param  value Donnée 16 bits (D0 poids faible).
+ * @return Longueur (5).
+ */
+size_t stp_build_cmd(uint8_t *out, uint8_t hdr, uint16_t value);
+
+/**
+ * @brief  Trame d'écriture groupée [A6 | ADDR | COUNT | N x int16 | CRC].
+ * @param  out    Destination (4 + 2 x count octets).
+ * @param  addr   Premier registre.
+ * @param  values Valeurs.
+ * @param  count  Nombre de registres (1..STP_BURST_MAX_REGS).
+ * @return Longueur, 0 si count est hors bornes.
+ */
+size_t stp_build_burst(uint8_t *out, uint8_t addr, const int16_t *values, uint8_t count);
+
+/**
+ * @brief  Initialise la synchronisation d'horloge.
+ */
+void stp_clock_init(stp_clock_t *clk);
+
+/**
+ * @brief  Ajoute un échange d'écho (trame type 0x06).
+ * @param  h0_ns Émission de REG_PING (horloge hôte monotone, ns).
+ * @param  h3_ns Réception de l'écho.
+ * @param  t_rx  Arrivée des octets côté firmware (µs, 32 bits).
+ * @param  t_tx  Remise de la réponse au TX (µs, 32 bits).
+ */
+void stp_clock_add(stp_clock_t *clk, int64_t h0_ns, int64_t h3_ns, uint32_t t_rx, uint32_t t_tx);
+
+/**
+ * @brief  Ajuste décalage et dérive sur le quart des échanges à liaison la plus courte.
+ * @return 1 si une estimation est disponible.
+ */
+int stp_clock_fit(stp_clock_t *clk);
+
+/**
+ * @brief  Convertit une date firmware 32 bits en date hôte (après stp_clock_fit()).
+ * @return Date hôte (ns, base de h0_ns / h3_ns).
+ */
+double stp_clock_mcu_to_host_ns(const stp_clock_t *clk, uint32_t t32);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM_PROTO_H_ */
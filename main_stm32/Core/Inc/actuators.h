@@ -0,0 +1,202 @@
+/**
+ * @file    actuators.h
+ * @brief   Tables des actionneurs (servos, ESC) et application groupée des sorties PWM.
+ * @details Les handles sont déclarés dans des tableaux indexés : le premier servo est
+ * la direction, le premier ESC la propulsion (chaîne de commande complète : profils,
+ * boucle de vitesse, trajectoire, failsafe). Les suivants, présents sur les plateformes
+ * plus grandes, sont commandés par la fenêtre de registres REG_ACT_* (accès indexé,
+ * sans recherche).
+ *
+ * À l'initialisation, les sorties sont regroupées par timer. Le tick moteur parcourt
+ * ensuite les groupes une fois : les registres de comparaison modifiés d'un même timer
+ * sont écrits sous UDIS (événement d'update suspendu), puis pris en compte ensemble à
+ * l'update suivant, sans période où une partie seulement des voies aurait changé.
+ *
+ * Les canaux au-delà de TIM1 CH1 / TIM2 CH1 doivent être activés en PWM dans la
+ * configuration CubeMX (tim.c) de la plateforme.
+ */
+
+#ifndef INC_ACTUATORS_H_
+#define INC_ACTUATORS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driver_servo.h"
+#include "driver_motor.h"
+#include "vehicle_profile.h"
+
+/** @brief Nombre de servomoteurs (1 à ACT_SERVO_MAX ; TIM1 CH1..CH4). */
+#ifndef ACT_SERVO_COUNT
+#define ACT_SERVO_COUNT         1u
+#endif
+/** @brief Nombre d'ESC (1 à ACT_MOTOR_MAX ; TIM2 CH1..CH2). */
+#ifndef ACT_MOTOR_COUNT
+#define ACT_MOTOR_COUNT         1u
+#endif
+/** @brief Nombre maximal de servomoteurs câblés dans la table. */
+#define ACT_SERVO_MAX           4u
+/** @brief Nombre maximal d'ESC câblés dans la table. */
+#define ACT_MOTOR_MAX           2u
+
+/**
+ * @name Base de temps PWM (TIM1 : servos, TIM2 : ESC)
+ * @brief Constantes dérivées de la configuration des timers : consignes, bornes et
+ * pentes des drivers sont en ticks CCR, à la pleine résolution du timer (0,3125 µs).
+ * @details Le prédiviseur est commun aux deux timers et fixe (bornes REG_SERVO_*_TICKS
+ * sauvegardées en ticks) ; seule la période dépend de la cadence choisie. actuators_init()
+ * reprogramme PSC / ARR d'après ces constantes, qui font foi sur la configuration CubeMX.
+ * @{
+ */
+/** @brief Horloge d'entrée de TIM1 / TIM2 (Hz, PCLK non divisée). */
+#define ACT_PWM_TIMER_CLK_HZ    64000000u
+/** @brief Prédiviseur de TIM1 / TIM2 (PSC). */
+#define ACT_PWM_PRESCALER       19u
+/** @brief Fréquence de comptage (Hz) : 3,2 ticks par µs. */
+#define ACT_PWM_TICK_HZ         (ACT_PWM_TIMER_CLK_HZ / (ACT_PWM_PRESCALER + 1u))
+/** @brief Conversion d'une durée d'impulsion (µs) en ticks CCR (constante de compilation). */
+#define ACT_PWM_US_TO_TICKS(us) ((uint32_t)(us) * (ACT_PWM_TICK_HZ / 1000u) / 1000u)
+
+/** @brief Cadence des impulsions servo (Hz). */
+#ifndef ACT_SERVO_PWM_HZ
+#define ACT_SERVO_PWM_HZ        50u
+#endif
+/**
+ * @brief Cadence des impulsions ESC (Hz).
+ * @note  50 Hz : tout ESC. 400 Hz (ESC « multirotor » ou voiture récent) ramène l'attente
+ * de l'impulsion suivante de 20 ms à 2,5 ms, bornes 1-2 ms inchangées.
+ */
+#ifndef ACT_ESC_PWM_HZ
+#define ACT_ESC_PWM_HZ          50u
+#endif
+/**
+ * @brief Protocole de sortie des ESC (Motor_Output_t, driver_esc.h).
+ * @note  DShot : TIM2 CH1 seul, donc ACT_MOTOR_COUNT = 1.
+ */
+#ifndef ACT_ESC_OUTPUT
+#define ACT_ESC_OUTPUT          MOTOR_OUT_PWM
+#endif
+/** @brief Période servo (ticks, ARR + 1). */
+#define ACT_SERVO_PERIOD_TICKS  (ACT_PWM_TICK_HZ / ACT_SERVO_PWM_HZ)
+/** @brief Période ESC en MOTOR_OUT_PWM (ticks, ARR + 1). */
+#define ACT_ESC_PERIOD_TICKS    (ACT_PWM_TICK_HZ / ACT_ESC_PWM_HZ)
+
+/** @brief Impulsion minimale par défaut (µs, profil véhicule). */
+#define ACT_PULSE_MIN_US        VEH_PULSE_MIN_US
+/** @brief Impulsion maximale par défaut (µs, profil véhicule). */
+#define ACT_PULSE_MAX_US        VEH_PULSE_MAX_US
+/** @brief Impulsion minimale par défaut (ticks CCR). */
+#define ACT_PULSE_MIN_TICKS     ACT_PWM_US_TO_TICKS(ACT_PULSE_MIN_US)
+/** @brief Impulsion maximale par défaut (ticks CCR). */
+#define ACT_PULSE_MAX_TICKS     ACT_PWM_US_TO_TICKS(ACT_PULSE_MAX_US)
+/** @} */
+
+/** @brief Index du servo de direction. */
+#define ACT_SERVO_STEER         0u
+/** @brief Index de l'ESC de propulsion. */
+#define ACT_MOTOR_DRIVE         0u
+
+/**
+ * @name Sélection REG_ACT_SEL
+ * @{
+ */
+#define ACT_SEL_MOTOR           0x80u   ///< Bit 7 : ESC (sinon servo).
+#define ACT_SEL_INDEX_MASK      0x7Fu   ///< Bits 0..6 : index dans la table.
+/** @} */
+
+/** @brief Servomoteurs (ACT_SERVO_STEER en tête). */
+extern Servo_Handle_t act_servo[ACT_SERVO_COUNT];
+/** @brief ESC (ACT_MOTOR_DRIVE en tête). */
+extern Motor_Handle_t act_motor[ACT_MOTOR_COUNT];
+
+/**
+ * @brief  Initialise tous les actionneurs et regroupe leurs sorties par timer.
+ * @note   Après la restauration des limites (actuators_limits_restore()).
+ */
+void actuators_init(void);
+
+/**
+ * @brief  Borne une sélection REG_ACT_SEL aux actionneurs présents.
+ * @param  sel Sélection demandée.
+ * @return Sélection valide (index ramené au dernier actionneur du type).
+ */
+uint8_t actuators_sel_clamp(uint8_t sel);
+
+/**
+ * @brief  Fait avancer les rampes des servos, exécute les machines à états des ESC qui
+ * ont du travail, puis applique toutes les sorties modifiées (tick moteur).
+ * @param  now_ms Timestamp actuel en ms.
+ * @return true si une rampe de servo est en cours (nouveau tick nécessaire dans 1 ms).
+ */
+bool actuators_tick(uint32_t now_ms);
+
+/**
+ * @brief  Applique les sorties modifiées depuis le dernier tick, sans faire avancer
+ * rampes ni machines à états (boucle de lacet chaînée à l'IMU).
+ * @note   Même contexte que actuators_tick() : jamais en concurrence avec lui.
+ */
+void actuators_apply(void);
+
+/**
+ * @brief  Indique si une machine à états d'ESC a du travail.
+ * @param  now_ms Timestamp actuel en ms.
+ * @return true si actuators_tick() doit être exécuté.
+ */
+bool actuators_need_process(uint32_t now_ms);
+
+/**
+ * @brief  Plus proche échéance des machines à états des ESC.
+ * @param  deadline_ms Échéance (ms), renseignée si au moins un ESC est temporisé.
+ * @return true si une échéance est armée.
+ */
+bool actuators_next_deadline(uint32_t *deadline_ms);
+
+/**
+ * @brief  Dernière consigne reçue par un actionneur.
+ * @param  sel Sélection (ACT_SEL_*), supposée valide.
+ * @return Angle (c°) pour un servo, vitesse (mm/s) pour un ESC.
+ */
+int16_t actuators_command(uint8_t sel);
+
+/**
+ * @brief  Consigne CCR en cours d'un actionneur.
+ * @param  sel Sélection (ACT_SEL_*), supposée valide.
+ * @return Ticks appliqués au dernier tick.
+ */
+uint16_t actuators_output(uint8_t sel);
+
+/**
+ * @brief  État d'un actionneur.
+ * @param  sel Sélection (ACT_SEL_*), supposée valide.
+ * @return MotorState_t pour un ESC ; 1 si le servo est en rampe, 0 sinon.
+ */
+uint8_t actuators_state(uint8_t sel);
+
+/**
+ * @brief  Commande un actionneur auxiliaire (hors direction et propulsion).
+ * @details Servo : angle en c° (limitation REG_SERVO_SLEW appliquée) ; ESC : vitesse
+ * en mm/s, boucle ouverte, sans profil.
+ * @note   Contexte du tick moteur (section critique en mode APP_MOTOR_TICK_ISR).
+ * @param  sel   Sélection (ACT_SEL_*), supposée valide.
+ * @param  value Consigne.
+ */
+void actuators_set_aux(uint8_t sel, int16_t value);
+
+/**
+ * @brief  Ramène tous les ESC auxiliaires au neutre (failsafe).
+ * @note   Contexte du tick moteur (section critique en mode APP_MOTOR_TICK_ISR).
+ */
+void actuators_stop_aux(void);
+
+/**
+ * @brief  Coupe les impulsions de toutes les sorties (CCR à 0, pris en compte immédiatement).
+ * @details Avant une veille STOP : les timers s'y figent, une sortie arrêtée au milieu
+ * d'une impulsion resterait à l'état haut. Les ESC voient une perte de signal.
+ */
+void actuators_outputs_off(void);
+
+/**
+ * @brief  Rétablit les impulsions des consignes courantes après actuators_outputs_off().
+ */
+void actuators_outputs_restore(void);
+
+#endif /* INC_ACTUATORS_H_ */
@@ -8,6 +8,78 @@
 #ifndef INC_APP_MAIN_H_
 #define INC_APP_MAIN_H_
 
+#include <stdint.h>
+#include "odometry.h"
+#include "speed_pub.h"
+
+/** @brief Délai sans commande avant décélération (ms, défaut de REG_FS_DECEL_MS). */
+#define FAILSAFE_DECEL_MS_DEFAULT     200u
+/** @brief Délai sans commande avant passage au neutre (ms, défaut de REG_FS_NEUTRAL_MS). */
+#define FAILSAFE_NEUTRAL_MS_DEFAULT   500u
+/** @brief Délai sans commande avant désarmement (ms, défaut de REG_FS_DISARM_MS). */
+#define FAILSAFE_DISARM_MS_DEFAULT    2000u
+
+/**
+ * @brief Étapes du failsafe gradué (valeur de REG_FS_STAGE).
+ */
+typedef enum{
+    FAILSAFE_OK = 0,        ///< Liaison active.
+    FAILSAFE_DECEL,         ///< Consigne moteur ramenée linéairement vers 0.
+    FAILSAFE_NEUTRAL,       ///< Moteur au neutre.
+    FAILSAFE_DISARMED       ///< Moteur désarmé : consignes ignorées jusqu'à une consigne nulle.
+} failsafe_stage_t;
+
+/**
+ * @brief  Étape courante du failsafe.
+ * @return Étape (failsafe_stage_t).
+ */
+uint8_t app_failsafe_stage(void);
+
+/**
+ * @brief Étapes datées du démarrage (registres REG_BOOT_STAGE_BASE + étape).
+ */
+typedef enum{
+    BOOT_STAGE_HAL = 0,     ///< Entrée de app_config : HAL, horloge et périphériques CubeMX initialisés.
+    BOOT_STAGE_ACTUATORS,   ///< PWM servo et ESC au neutre.
+    BOOT_STAGE_SERIAL,      ///< Réception DMA UART démarrée.
+    BOOT_STAGE_SCHED,       ///< Ordonnanceur démarré (fin de app_config).
+    BOOT_STAGE_IMU,         ///< IMU configurée (fin du démarrage asynchrone).
+    BOOT_STAGE_TELEMETRY,   ///< Première trame de télémétrie émise.
+    BOOT_STAGE_COUNT
+} boot_stage_t;
+
+/**
+ * @brief  Date d'une étape du démarrage.
+ * @param  stage Étape (boot_stage_t).
+ * @return Microsecondes depuis le reset (résolution 1 ms entre HAL_Init et BOOT_STAGE_HAL),
+ * UINT32_MAX si l'étape n'est pas encore atteinte.
+ */
+uint32_t app_boot_stage_us(uint8_t stage);
+
+/**
+ * @brief  État de la mise en veille de la télémétrie.
+ * @return idle_state_t (REG_IDLE_STATE).
+ */
+uint8_t app_idle_state(void);
+
+/**
+ * @brief  Décimation appliquée par la régulation de débit de la télémétrie.
+ * @return 1 : toutes les trames émises, N : une sur N (REG_TELEM_DECIM).
+ */
+uint8_t app_telem_decimation(void);
+
+/**
+ * @brief  Cadence effective de la télémétrie, mesurée sur la dernière fenêtre.
+ * @return Échantillons émis par seconde (REG_TELEM_EFF_RATE).
+ */
+uint32_t app_telem_effective_hz(void);
+
+/**
+ * @brief  Odométrie embarquée.
+ * @return Pointeur vers l'état de l'odométrie, NULL si elle est absente (APP_ODOMETRY = 0).
+ */
+const Odometry_t *app_odometry(void);
+
 /**
  * @brief  Configure l'ensemble de l'application (Hardware + Drivers).
  */
@@ -18,10 +90,18 @@ void app_config(void);
  */
 void app_loop(void);
 
-/** @brief Variable globale de vitesse (m/s) partagée entre le Speedometer et la Télémétrie. */
-extern float speed_speedo_data;
+/**
+ * @brief  Tick moteur 1 ms, appelé depuis SysTick_Handler (actif si APP_MOTOR_TICK_ISR).
+ */
+void app_motor_tick_isr(void);
+
+/**
+ * @brief  Boucle de lacet chaînée à l'acquisition IMU, appelée depuis PendSV_Handler
+ * (actif si APP_IMU_CHAIN).
+ */
+void app_imu_chain_isr(void);
 
-/** @brief Compteur d'overflow pour l'extension 32-bits du Timer microseconde. */
-extern volatile uint32_t tim3_overflow_cnt;
+/** @brief Vitesse estimée publiée par l'estimateur, lue sans attente par la télémétrie (speed_pub.h). */
+extern speed_pub_t speed_pub;
 
 #endif
@@ -0,0 +1,74 @@
+/**
+ * @file    attitude.h
+ * @brief   Estimateur d'attitude embarqué (filtre complémentaire sur quaternion).
+ * @details Filtre de Mahony à gain proportionnel, entièrement en virgule fixe (Q30) :
+ * le gyroscope intègre le quaternion, l'accéléromètre corrige le roulis et le tangage
+ * lorsque sa norme est proche de 1 g. Le lacet n'est pas observable sans magnétomètre :
+ * il suit l'intégration du gyroscope. Ni trigonométrie, ni racine, ni division par
+ * échantillon : la normalisation du quaternion utilise l'approximation (3 - |q|²) / 2,
+ * valable au voisinage de la norme unité.
+ */
+
+#ifndef INC_ATTITUDE_H_
+#define INC_ATTITUDE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @brief Valeur unité des composantes du quaternion (Q30). */
+#define ATT_ONE_Q30             (1L << 30)
+/** @brief Gain proportionnel de correction par l'accéléromètre au démarrage (1/s x 1000). */
+#define ATT_KP_MILLI_DEFAULT    1000u
+/** @brief Gain proportionnel maximal accepté (1/s x 1000, borne les débordements). */
+#define ATT_KP_MILLI_MAX        10000u
+/** @brief Gain appliqué pendant la convergence initiale (1/s x 1000). */
+#define ATT_KP_START_MILLI      10000u
+/** @brief Durée de la convergence initiale à gain fort (µs de données intégrées). */
+#define ATT_START_US            1000000u
+/** @brief Écart de norme toléré sur l'accélération autour de 1 g (%), au-delà pas de correction. */
+#define ATT_ACC_GATE_PCT        20
+/** @brief Écart maximal entre deux échantillons intégrés (µs) ; au-delà, l'intégration repart. */
+#define ATT_DT_MAX_US           20000u
+
+/**
+ * @brief État de l'estimateur d'attitude.
+ */
+typedef struct{
+    int32_t  q[4];            ///< Quaternion capteur -> repère terrestre (w, x, y, z), Q30.
+    uint16_t kp_milli;        ///< Gain proportionnel de correction (1/s x 1000).
+    bool     primed;          ///< Un premier échantillon daté a été reçu.
+    uint64_t last_us;         ///< Date du dernier échantillon (µs).
+    uint32_t run_us;          ///< Durée intégrée depuis l'initialisation (µs, saturée à ATT_START_US).
+    uint32_t accel_rejected;  ///< Échantillons sans correction (norme hors tolérance).
+} Attitude_Estimator_t;
+
+/**
+ * @brief  Initialise l'estimateur (attitude identité, gain par défaut).
+ * @param  att Pointeur vers l'estimateur.
+ */
+void attitude_init(Attitude_Estimator_t *att);
+
+/**
+ * @brief  Règle le gain proportionnel de correction.
+ * @param  att      Pointeur vers l'estimateur.
+ * @param  kp_milli Gain (1/s x 1000), borné à ATT_KP_MILLI_MAX.
+ */
+void attitude_set_gain(Attitude_Estimator_t *att, uint16_t kp_milli);
+
+/**
+ * @brief  Intègre un échantillon IMU.
+ * @param  att          Pointeur vers l'estimateur.
+ * @param  gyro_urads   Vitesse angulaire [X, Y, Z] (µrad/s).
+ * @param  accel_mms2   Accélération [X, Y, Z] (mm/s²).
+ * @param  timestamp_us Date d'acquisition de l'échantillon (µs).
+ */
+void attitude_update(Attitude_Estimator_t *att, const int32_t gyro_urads[3], const int32_t accel_mms2[3], uint64_t timestamp_us);
+
+/**
+ * @brief  Quaternion courant au format de télémétrie.
+ * @param  att Pointeur vers l'estimateur.
+ * @param  q14 Quaternion (w, x, y, z) de sortie, Q14 (16384 = 1.0).
+ */
+void attitude_get_q14(const Attitude_Estimator_t *att, int16_t q14[4]);
+
+#endif /* INC_ATTITUDE_H_ */
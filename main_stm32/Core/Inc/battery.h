@@ -0,0 +1,83 @@
+/**
+ * @file    battery.h
+ * @brief   Mesure de la tension batterie par ADC1 + DMA, en tâche de fond.
+ * @details L'ADC convertit en continu la broche du pont diviseur (BATT_ADC_CHANNEL) et
+ * VREFINT, suréchantillonnés ×256 par le matériel (résultats 16 bits). Le DMA range les
+ * paires dans un anneau circulaire sans interruption : la lecture moyenne l'anneau à
+ * la demande. Le rapport des deux voies, rapporté à la calibration usine de VREFINT,
+ * donne la tension sans dépendre de VDDA.
+ *
+ * La tension sert à compenser la carte vitesse -> PWM en boucle ouverte : quand la
+ * batterie baisse, l'écart au neutre est agrandi de V_nominale / V_batterie.
+ */
+
+#ifndef INC_BATTERY_H_
+#define INC_BATTERY_H_
+
+#include <stdint.h>
+
+/** @brief Mesure batterie active (1) ou absente (0, tension lue nulle, pas de compensation). */
+#ifndef BATT_ENABLE
+#define BATT_ENABLE             1
+#endif
+
+/** @brief Voie ADC du pont diviseur (PA4 = ADC1_IN4 ; < 13, rangée avant VREFINT). */
+#ifndef BATT_ADC_CHANNEL
+#define BATT_ADC_CHANNEL        4u
+#endif
+
+/** @brief Rapport du pont diviseur ×1000 ((R_haut + R_bas) / R_bas : 100 kΩ / 10 kΩ -> 11000). */
+#ifndef BATT_DIV_X1000
+#define BATT_DIV_X1000          11000u
+#endif
+
+/** @brief Paires (batterie, VREFINT) moyennées (puissance de 2, ~5,5 ms par paire). */
+#ifndef BATT_AVG_LEN
+#define BATT_AVG_LEN            16u
+#endif
+
+/** @brief Bornes du facteur de compensation (Q12 : 0,8 et 1,5). */
+#define BATT_COMP_MIN_Q12       3277u
+#define BATT_COMP_MAX_Q12       6144u
+/** @brief Facteur neutre (Q12). */
+#define BATT_COMP_UNITY_Q12     4096u
+
+#if BATT_ENABLE
+/**
+ * @brief  Configure et calibre ADC1, puis démarre les conversions continues sous DMA.
+ * @note   Bloquant quelques dizaines de µs (régulateur, calibration) ; base de temps
+ * TIM3 démarrée au préalable (Delay_us()).
+ */
+void batt_init(void);
+
+/**
+ * @brief  Tension batterie moyenne sur l'anneau.
+ * @return Tension (mV), 0 avant la première conversion.
+ */
+uint16_t batt_mv(void);
+#else
+static inline void batt_init(void){}
+static inline uint16_t batt_mv(void){ return 0u; }
+#endif
+
+/**
+ * @brief  Facteur de compensation de la carte vitesse -> PWM.
+ * @param  vbat_mv    Tension mesurée (mV).
+ * @param  nominal_mv Tension de référence de la carte (mV), 0 : compensation inactive.
+ * @return nominal_mv / vbat_mv en Q12, borné à [BATT_COMP_MIN_Q12, BATT_COMP_MAX_Q12] ;
+ * BATT_COMP_UNITY_Q12 si la compensation est inactive ou la tension inconnue.
+ */
+static inline uint16_t batt_comp_q12(uint16_t vbat_mv, uint16_t nominal_mv){
+    if(nominal_mv == 0u || vbat_mv == 0u){
+        return BATT_COMP_UNITY_Q12;
+    }
+
+    uint32_t comp = ((uint32_t)nominal_mv << 12) / vbat_mv;
+
+    if(comp < BATT_COMP_MIN_Q12) comp = BATT_COMP_MIN_Q12;
+    if(comp > BATT_COMP_MAX_Q12) comp = BATT_COMP_MAX_Q12;
+
+    return (uint16_t)comp;
+}
+
+#endif /* INC_BATTERY_H_ */
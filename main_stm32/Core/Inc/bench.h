@@ -0,0 +1,80 @@
+/**
+ * @file    bench.h
+ * @brief   Banc de mesure en cycles des routines critiques, exécuté une fois au démarrage.
+ * @details Compilé avec APP_BENCH=1 (configuration de build dédiée, hors Debug) : la
+ * suite s'exécute dès que l'IMU est prête, puis chaque résultat est émis dans une
+ * trame type 0x07 que l'hôte peut archiver d'un commit à l'autre.
+ * Le Cortex-M0+ n'a pas de compteur DWT : les cycles sont comptés sur SysTick
+ * (décompteur 24 bits à HCLK, rechargé chaque ms) prolongé par le tick HAL.
+ * Les interruptions restent actives : le minimum est la valeur de référence, la
+ * moyenne et le maximum incluent les préemptions.
+ *
+ * Trame type 0x07 : [AA 55 07 LEN | ARG u16 | ID u8 | CALLS u16 | MIN u32 | AVG u32 | MAX u32 | CRC]
+ * (cycles HCLK, surcoût de la mesure déduit).
+ *
+ * Contrôle des budgets (bench_budget_check()) : BENCH_BUDGET_DELAY_MS après la suite,
+ * véhicule en fonctionnement, le pire cas mesuré de chaque tâche (ordonnanceur) et de
+ * chaque interruption instrumentée (profileur) est comparé au budget déclaré dans la
+ * table de bench.c, puis la somme des pires cas d'interruption et de la plus longue
+ * tâche à la période de commande (BENCH_SLOT_US) : une option qui ferait déborder le
+ * créneau du tick moteur est signalée dès le banc, avant d'atteindre un véhicule.
+ */
+
+#ifndef INC_BENCH_H_
+#define INC_BENCH_H_
+
+#include <stdint.h>
+#include "driver_motor.h"
+#include "driver_speedometer.h"
+
+/** @brief Période de commande à tenir (µs) : créneau du tick moteur (TASK_MOTOR_US). */
+#ifndef BENCH_SLOT_US
+#define BENCH_SLOT_US           1000u
+#endif
+/** @brief Fonctionnement avant le contrôle des budgets (ms après la suite). */
+#ifndef BENCH_BUDGET_DELAY_MS
+#define BENCH_BUDGET_DELAY_MS   10000u
+#endif
+/** @brief Champ ARG de l'entrée BENCH_BUDGET du créneau complet. */
+#define BENCH_BUDGET_SLOT       0xFFu
+
+/**
+ * @brief Routines mesurées (champ ID de la trame).
+ */
+typedef enum {
+    BENCH_CRC8 = 0,         ///< serial_crc8_atm() ; ARG = longueur (36 octets).
+    BENCH_IMU_READ_ALL,     ///< BMI088_Read_All() : lecture SPI bloquante et conversion flottante.
+    BENCH_CONV_FLOAT,       ///< BMI088_Convert_Accel() + BMI088_Convert_Gyro().
+    BENCH_CONV_FX,          ///< BMI088_Convert_Accel_Fx() + BMI088_Convert_Gyro_Fx().
+    BENCH_MOTOR_TICK,       ///< motor_process_1ms() ; ARG = état de départ (MotorState_t).
+    BENCH_SPEEDO_SOLVE,     ///< speedometer_solve_speed() ; ARG = 1 pour la variante mm/s entière.
+    BENCH_SERIAL_WRITE,     ///< serial_write_all_nb() sur ring TX vide ; ARG = taille (octets).
+    BENCH_IMAGE,            ///< Bilan de l'image (pas une durée) ; ARG = région (mem_region_t), MIN = AVG = MAX = taille (octets).
+    BENCH_BUDGET,           ///< Budget (µs, pas des cycles) ; ARG = entrée de la table des budgets (bench.c), BENCH_BUDGET_SLOT pour le créneau,
+                            ///< CALLS = 1 si mesuré, MIN = budget, AVG = marge signée (négative : dépassement), MAX = pire cas.
+    BENCH_COUNT
+} bench_id_t;
+
+/**
+ * @brief  Exécute la suite et émet un résultat par routine (et par variante).
+ * @details Bloquant (environ 1 s à 115200 bauds, dominé par la vidange du ring TX
+ * entre deux émissions) ; le chien de garde est rafraîchi au fil de la suite. Les
+ * handles sont recopiés avant chaque appel : l'état réel du moteur et du tachymètre
+ * n'est pas modifié.
+ * @param  motor  Moteur de référence (recopié).
+ * @param  speedo Tachymètre de référence (recopié).
+ */
+void bench_run(const Motor_Handle_t *motor, const Speedometer_Handle_t *speedo);
+
+/**
+ * @brief  Compare les pires cas mesurés depuis la suite aux budgets déclarés et émet
+ * une entrée BENCH_BUDGET par tâche ou interruption, puis celle du créneau.
+ * @details À appeler une fois, BENCH_BUDGET_DELAY_MS après bench_run() : les
+ * statistiques de l'ordonnanceur et des sondes contrôlées sont remises à zéro en fin de
+ * suite, la fenêtre ne couvre que le régime établi. Les sources absentes du build
+ * (tâche non compilée, sonde jamais alimentée) sont émises avec CALLS = 0.
+ * @return Nombre de budgets dépassés (créneau compris).
+ */
+uint8_t bench_budget_check(void);
+
+#endif /* INC_BENCH_H_ */
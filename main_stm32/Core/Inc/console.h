@@ -0,0 +1,107 @@
+/**
+ * @file    console.h
+ * @brief   Console texte sur un second UART (USART1 + DMA TX), séparée de la liaison binaire.
+ * @details Avec CONSOLE_ENABLE, la sortie standard (printf() via _write()), la sortie de
+ * debug (dbgout.h) et le journal (dlog.h, en lignes texte si DLOG_CONSOLE) partent sur
+ * l'USART1 : l'USART2 ne porte plus que les trames binaires (commandes, réponses,
+ * télémétrie), à plein débit. La console a priorité sur la voie terminal RTT (rtt.h).
+ *
+ * - Émission : ring logiciel vidé par DMA2_Channel1 (DMAMUX1_Channel7), sans
+ *   interruption : console_poll() relance le transfert suivant à chaque passage de la
+ *   boucle principale. Écritures sans attente (tout contexte), tronquées si le ring
+ *   est plein et comptées (console_tx_dropped()).
+ * - Réception : FIFO matérielle de 8 octets relevée par console_poll(), lignes de
+ *   commande éditées avec écho (effacement par BS/DEL), terminées par CR ou LF :
+ *   - `r <reg> [n]` : lecture de n registres (1 par défaut) ;
+ *   - `w <reg> <valeur>` : écriture d'un registre, par le même chemin qu'une trame reçue
+ *     (hooks, banc de préparation, file de commandes ; réarme le failsafe) ;
+ *   - `h` : aide.
+ *   Nombres en décimal ou en hexadécimal (préfixe 0x).
+ *
+ * Frappe humaine : la FIFO de 8 octets suffit entre deux passages de la boucle
+ * principale ; un collage rapide au-delà de 8 caractères par passage peut en perdre.
+ */
+
+#ifndef INC_CONSOLE_H_
+#define INC_CONSOLE_H_
+
+#include <stdint.h>
+
+/** @brief Console sur second UART active (1) ou absente (0, USART1 et ses broches non configurés). */
+#ifndef CONSOLE_ENABLE
+#define CONSOLE_ENABLE          0
+#endif
+
+/** @brief Débit de la console (bauds). */
+#ifndef CONSOLE_BAUD
+#define CONSOLE_BAUD            115200u
+#endif
+
+/** @brief Taille du ring d'émission de la console (puissance de 2). */
+#ifndef CONSOLE_TX_RING_SIZE
+#define CONSOLE_TX_RING_SIZE    1024u
+#endif
+
+/** @brief Longueur maximale d'une ligne de commande (caractères). */
+#define CONSOLE_LINE_MAX        48u
+
+/** @brief Registres lus au plus par une commande `r`. */
+#define CONSOLE_READ_MAX        16u
+
+/**
+ * @name Broches USART1 (fonctions alternées)
+ * @brief PA9 / PA10 par défaut, libres sur la carte.
+ * @{
+ */
+#ifndef CONSOLE_TX_PORT
+#define CONSOLE_TX_PORT         GPIOA
+#define CONSOLE_TX_PIN          GPIO_PIN_9
+#define CONSOLE_TX_AF           GPIO_AF1_USART1
+#endif
+#ifndef CONSOLE_RX_PORT
+#define CONSOLE_RX_PORT         GPIOA
+#define CONSOLE_RX_PIN          GPIO_PIN_10
+#define CONSOLE_RX_AF           GPIO_AF1_USART1
+#endif
+/** @} */
+
+#if CONSOLE_ENABLE
+/**
+ * @brief  Configure l'USART1, ses broches et le canal DMA d'émission.
+ */
+void console_init(void);
+
+/**
+ * @brief  Écrit dans le ring d'émission, sans attente (tout contexte).
+ * @param  data Données.
+ * @param  len  Longueur (octets).
+ * @return Octets écrits (tronqué à la place libre).
+ */
+uint32_t console_write(const void *data, uint32_t len);
+
+/**
+ * @brief  Place libre dans le ring d'émission (écriture sans troncature d'une ligne).
+ * @return Octets pouvant être écrits.
+ */
+uint32_t console_tx_free(void);
+
+/**
+ * @brief  Service de la console (boucle principale) : relance de l'émission DMA,
+ * lecture et exécution des lignes de commande.
+ */
+void console_poll(void);
+
+/**
+ * @brief  Octets refusés faute de place dans le ring d'émission.
+ * @return Compteur cumulé.
+ */
+uint32_t console_tx_dropped(void);
+#else
+static inline void console_init(void){}
+static inline uint32_t console_write(const void *data, uint32_t len){ (void)data; (void)len; return 0u; }
+static inline uint32_t console_tx_free(void){ return 0u; }
+static inline void console_poll(void){}
+static inline uint32_t console_tx_dropped(void){ return 0u; }
+#endif
+
+#endif /* INC_CONSOLE_H_ */
@@ -0,0 +1,74 @@
+/**
+ * @file    crc8.h
+ * @brief   CRC-8/ATM (polynôme 0x07) table-driven avec API incrémentale.
+ * @details Utilisé par le protocole série pour les trames de commande et de télémétrie.
+ */
+
+#ifndef INC_CRC8_H_
+#define INC_CRC8_H_
+
+#include <stdint.h>
+
+/** @brief Valeur initiale du CRC-8/ATM. */
+#define CRC8_INIT   0x00u
+
+/** @brief Backend logiciel : table de 256 octets. */
+#define CRC8_BACKEND_TABLE  0
+/** @brief Backend matériel : unité CRC du STM32G0 programmée en polynôme 8 bits 0x07. */
+#define CRC8_BACKEND_HW     1
+
+/**
+ * @brief Backend utilisé par crc8_compute().
+ * @note  crc8_update() reste toujours sur la table (un octet, pas d'état matériel).
+ */
+#ifndef CRC8_BACKEND
+#define CRC8_BACKEND        CRC8_BACKEND_HW
+#endif
+
+/** @brief Table CRC-8 polynôme 0x07 (256 entrées, en flash). */
+extern const uint8_t crc8_table[256];
+
+/**
+ * @brief  Intègre un octet dans un CRC en cours.
+ * @param  crc  CRC courant (CRC8_INIT au départ).
+ * @param  byte Octet à ajouter.
+ * @return CRC mis à jour.
+ */
+static inline uint8_t crc8_update(uint8_t crc, uint8_t byte){
+    return crc8_table[crc ^ byte];
+}
+
+/**
+ * @brief  Configure le backend CRC (horloge et registres de l'unité matérielle).
+ * @note   Sans effet avec le backend table.
+ */
+void crc8_init(void);
+
+/**
+ * @brief  Calcule le CRC-8/ATM d'un bloc.
+ * @param  data Pointeur vers les données.
+ * @param  len  Longueur.
+ * @return CRC calculé.
+ */
+uint8_t crc8_compute(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief  Prolonge un CRC-8/ATM en cours sur un bloc.
+ * @details Construction incrémentale d'une trame : crc8_extend(crc8_extend(CRC8_INIT, a, n), b, m)
+ * vaut le CRC de a suivi de b. Backend matériel : l'unité repart du CRC donné (registre INIT).
+ * @param  crc  CRC des octets précédents (CRC8_INIT au départ).
+ * @param  data Pointeur vers les données.
+ * @param  len  Longueur.
+ * @return CRC mis à jour.
+ */
+uint8_t crc8_extend(uint8_t crc, const uint8_t *data, uint16_t len);
+
+/**
+ * @brief  Calcule le CRC-8/ATM d'un bloc par la table (chemin de repli).
+ * @param  data Pointeur vers les données.
+ * @param  len  Longueur.
+ * @return CRC calculé.
+ */
+uint8_t crc8_compute_table(const uint8_t *data, uint16_t len);
+
+#endif /* INC_CRC8_H_ */
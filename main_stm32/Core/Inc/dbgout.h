@@ -0,0 +1,69 @@
+/**
+ * @file    dbgout.h
+ * @brief   Sortie de debug texte minimale, sans stdio ni tas.
+ * @details Remplace printf() sur les chemins de debug restants : chaînes et entiers
+ * (décimal signé ou non, hexadécimal à largeur fixe), formatés sur la pile. Le texte
+ * part sur la console du second UART (console.h) si CONSOLE_ENABLE, sinon sur la voie
+ * terminal RTT (rtt.h), ou dans le ring TX de l'USART2 (sans attente, écriture refusée
+ * si le ring est plein) quand RTT_ENABLE vaut 0.
+ *
+ * Avec DBG_NO_STDIO à 1, aucune fonction de stdio n'est appelée par le firmware et
+ * _sbrk() refuse toute allocation (sysmem.c) : le formatage newlib (et sa variante
+ * flottante, option d'édition de liens -u_printf_float retirée) et malloc() restent
+ * hors de l'image, le tas réservé par les scripts de liens est nul.
+ */
+
+#ifndef INC_DBGOUT_H_
+#define INC_DBGOUT_H_
+
+#include <stdint.h>
+
+/** @brief Image sans stdio ni tas (1) ou _sbrk() newlib d'origine (0). */
+#ifndef DBG_NO_STDIO
+#define DBG_NO_STDIO            1
+#endif
+
+/** @brief Taille d'un entier 32 bits formaté en décimal, signe compris (sans terminateur). */
+#define DBG_U32_DIGITS          11u
+
+/**
+ * @brief  Formate un entier non signé en décimal.
+ * @param  buf Destination (au moins DBG_U32_DIGITS octets, non terminée).
+ * @param  v   Valeur.
+ * @return Nombre de caractères écrits.
+ */
+uint8_t dbg_fmt_u32(char *buf, uint32_t v);
+
+/**
+ * @brief  Formate un entier signé en décimal.
+ * @param  buf Destination (au moins DBG_U32_DIGITS octets, non terminée).
+ * @param  v   Valeur.
+ * @return Nombre de caractères écrits.
+ */
+uint8_t dbg_fmt_i32(char *buf, int32_t v);
+
+/**
+ * @brief  Formate un entier en hexadécimal majuscule, complété de zéros.
+ * @param  buf    Destination (au moins digits octets, non terminée).
+ * @param  v      Valeur.
+ * @param  digits Nombre de chiffres (1..8).
+ * @return Nombre de caractères écrits.
+ */
+uint8_t dbg_fmt_hex(char *buf, uint32_t v, uint8_t digits);
+
+/**
+ * @brief  Émet une chaîne terminée par un zéro.
+ * @param  s Chaîne.
+ */
+void dbg_puts(const char *s);
+
+/** @brief Émet un entier non signé en décimal. */
+void dbg_put_u32(uint32_t v);
+
+/** @brief Émet un entier signé en décimal. */
+void dbg_put_i32(int32_t v);
+
+/** @brief Émet un entier en hexadécimal sur digits chiffres (1..8). */
+void dbg_put_hex(uint32_t v, uint8_t digits);
+
+#endif /* INC_DBGOUT_H_ */
@@ -0,0 +1,130 @@
+/**
+ * @file    dlog.h
+ * @brief   Journal binaire différé (sans printf).
+ * @details Un point de journal dépose un enregistrement compact (identifiant, date µs,
+ * jusqu'à trois arguments entiers) dans un ring dédié, en quelques dizaines de cycles,
+ * y compris en interruption. dlog_flush(), appelée par la tâche de télémétrie, émet
+ * les enregistrements en trames type 0x08 entrelacées avec la télémétrie ; le texte
+ * est reconstitué par l'hôte (python_serial_reg, table LOG_FORMATS indexée par ID).
+ *
+ * Trame type 0x08 : [AA 55 08 LEN | SEQ u16 | T_US u32 | ID u8 | N u8 | ARGS i32 x N | CRC]
+ * SEQ compte tous les enregistrements, y compris ceux perdus ring plein : un saut de
+ * SEQ côté hôte signale une perte.
+ *
+ * Le ring et ses index sont en .noinit (MEM_NOINIT) : les enregistrements pas encore
+ * émis au moment d'un reset à chaud (chien de garde, faute, reset logiciel) sont émis
+ * après le redémarrage, SEQ continuant la numérotation. Les dates T_US de ces
+ * enregistrements restent celles du démarrage précédent.
+ */
+
+#ifndef INC_DLOG_H_
+#define INC_DLOG_H_
+
+#include <stdint.h>
+#include "proto_def.h"
+#include "console.h"
+
+/** @brief Journal actif (1) ou points de journal compilés à vide (0). */
+#ifndef DLOG_ENABLE
+#define DLOG_ENABLE         1
+#endif
+
+/**
+ * @brief Trames émises vers la voie RTT_CH_DLOG de la sonde SWD (1) au lieu de la
+ * liaison série (0). Sans effet si RTT_ENABLE vaut 0.
+ */
+#ifndef DLOG_RTT
+#define DLOG_RTT            0
+#endif
+
+/**
+ * @brief Enregistrements émis en lignes texte sur la console (1, console.h) au lieu de
+ * trames binaires : `D <seq> <t_us> <id> <arguments>`, identifiants et arguments
+ * décodés d'après LOG_FORMATS (serial_reg.py). Actif par défaut avec la console, qui a
+ * alors priorité sur DLOG_RTT : la liaison série ne porte plus de journal.
+ */
+#ifndef DLOG_CONSOLE
+#define DLOG_CONSOLE        CONSOLE_ENABLE
+#endif
+
+/** @brief Nombre d'enregistrements du ring (puissance de 2). */
+#define DLOG_RING_SIZE      32u
+/** @brief Nombre maximal d'arguments par enregistrement. */
+#define DLOG_ARGS_MAX       3u
+/** @brief Nombre maximal de trames émises par appel de dlog_flush(). */
+#define DLOG_FLUSH_MAX      4u
+/** @brief Type de trame du journal. */
+#define DLOG_FRAME_TYPE     TELEM_TYPE_LOG
+
+/**
+ * @brief Identifiants des points de journal.
+ * @note  Ajouter un ID = ajouter une ligne ici et son format dans LOG_FORMATS (serial_reg.py).
+ */
+typedef enum {
+    DLOG_BOOT_STAGE = 0,        ///< Étape de démarrage atteinte : (étape, date µs depuis le reset).
+    DLOG_FAILSAFE,              ///< Changement d'étape du failsafe : (étape, ms depuis la dernière commande).
+    DLOG_IMU_BUS_FAIL,          ///< Récupération du bus IMU armée : (échecs consécutifs, timeouts, erreurs).
+    DLOG_IMU_BUS_RECOVERED,     ///< Bus IMU récupéré : (récupérations).
+    DLOG_SERIAL_RX_OVERRUN,     ///< Overrun UART RX : (overruns).
+    DLOG_SERIAL_BAUD,           ///< Débit série appliqué : (bauds).
+    DLOG_TELEM_DECIM,           ///< Décimation de la télémétrie modifiée : (décimation, place TX libre, trames refusées).
+    DLOG_IMU_HIST_FROZEN,       ///< Historique IMU figé : (source, échantillons, rang du déclenchement).
+    DLOG_PARK_WAKE,             ///< Sortie de veille STOP : (cause lp_wake_t, durée de veille ms, réveil jusqu'à la première trame µs).
+    DLOG_SOAK,                  ///< Bilan du mode endurance (APP_SOAK) : (passages de boucle par seconde, overruns cumulés, pire retard de libération µs).
+    DLOG_IMU_SELFTEST,          ///< Fin de l'auto-test IMU : (état bmi088_st_state_t, capteurs en échec bmi088_st_fail_t).
+    DLOG_TRACTION,              ///< Patinage / blocage confirmé ou levé : (état Motor_Traction_t, consigne mm/s, mesure mm/s).
+    DLOG_IMU_HEALTH,            ///< Défaut IMU détecté : (cause imu_health_cause_t, mesure, action imu_health_action_t).
+    DLOG_ID_COUNT
+} dlog_id_t;
+
+#if DLOG_ENABLE
+
+/**
+ * @brief  Reprend le ring conservé au reset à chaud, ou le vide (mise sous tension).
+ * @note   Avant le premier point de journal.
+ */
+void dlog_init(void);
+
+/**
+ * @brief  Dépose un enregistrement dans le ring (tout contexte, y compris interruption).
+ * @details Enregistrement abandonné si le ring est plein (compté par dlog_dropped()).
+ * @param  id Identifiant (dlog_id_t).
+ * @param  n  Nombre d'arguments utiles (<= DLOG_ARGS_MAX).
+ * @param  a0 Premier argument.
+ * @param  a1 Deuxième argument.
+ * @param  a2 Troisième argument.
+ */
+void dlog_write(uint8_t id, uint8_t n, int32_t a0, int32_t a1, int32_t a2);
+
+/**
+ * @brief  Émet les enregistrements en attente (boucle principale).
+ * @details Au plus DLOG_FLUSH_MAX trames par appel ; un enregistrement qui ne tient pas
+ * dans le ring TX reste en attente jusqu'à l'appel suivant.
+ */
+void dlog_flush(void);
+
+/**
+ * @brief  Nombre d'enregistrements perdus (ring plein) depuis le démarrage.
+ * @return Compteur de pertes.
+ */
+uint32_t dlog_dropped(void);
+
+#define DLOG0(id)           dlog_write((uint8_t)(id), 0u, 0, 0, 0)
+#define DLOG1(id, a)        dlog_write((uint8_t)(id), 1u, (int32_t)(a), 0, 0)
+#define DLOG2(id, a, b)     dlog_write((uint8_t)(id), 2u, (int32_t)(a), (int32_t)(b), 0)
+#define DLOG3(id, a, b, c)  dlog_write((uint8_t)(id), 3u, (int32_t)(a), (int32_t)(b), (int32_t)(c))
+
+#else
+
+static inline void dlog_init(void){}
+static inline void dlog_flush(void){}
+static inline uint32_t dlog_dropped(void){ return 0; }
+
+#define DLOG0(id)           ((void)0)
+#define DLOG1(id, a)        ((void)(a))
+#define DLOG2(id, a, b)     ((void)(a), (void)(b))
+#define DLOG3(id, a, b, c)  ((void)(a), (void)(b), (void)(c))
+
+#endif /* DLOG_ENABLE */
+
+#endif /* INC_DLOG_H_ */
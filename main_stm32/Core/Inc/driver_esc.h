@@ -0,0 +1,78 @@
+/**
+ * @file    driver_esc.h
+ * @brief   Sorties ESC rapides : OneShot125, Multishot et DShot.
+ * @details Alternatives à l'impulsion 1-2 ms à 50 Hz, dont l'attente de la période
+ * suivante (jusqu'à 20 ms) domine la latence commande -> moteur. Le protocole se
+ * choisit par handle (Motor_Handle_t::output, ACT_ESC_OUTPUT pour la propulsion) ;
+ * machine à états frein / neutre et boucle de vitesse sont inchangées.
+ *
+ * - OneShot125 / Multishot : même PWM matérielle, timer sans prédiviseur (64 ticks par
+ *   µs) ; la plage min/max du handle est remplacée par celle du protocole.
+ * - DShot300 / DShot600 : trame de 16 bits (11 bits de consigne, bit de télémétrie,
+ *   CRC de 4 bits) émise en boucle par DMA circulaire sur l'update de TIM2, qui écrit
+ *   le CCR1 bit par bit, suivie de ESC_DSHOT_GAP_BITS bits au niveau bas. Aucune
+ *   charge CPU hors changement de consigne. Réservé à TIM2 CH1 (DMA2_Channel2).
+ *
+ * Le neutre reste au milieu de la plage : l'ESC doit être réglé en mode bidirectionnel
+ * (« 3D ») dans son configurateur. En DShot, neutre -> valeur 0 (arrêt, armement),
+ * marche arrière -> 48..1047, marche avant -> 1049..2047.
+ */
+
+#ifndef INC_DRIVER_ESC_H_
+#define INC_DRIVER_ESC_H_
+
+#include "driver_motor.h"
+#include <stdbool.h>
+
+/** @brief Cadence des impulsions OneShot125 (Hz, impulsion maximale 250 µs). */
+#ifndef ESC_ONESHOT_HZ
+#define ESC_ONESHOT_HZ          2000u
+#endif
+/** @brief Cadence des impulsions Multishot (Hz, impulsion maximale 25 µs). */
+#ifndef ESC_MULTISHOT_HZ
+#define ESC_MULTISHOT_HZ        8000u
+#endif
+/** @brief Bits au niveau bas entre deux trames DShot (séparation des trames). */
+#ifndef ESC_DSHOT_GAP_BITS
+#define ESC_DSHOT_GAP_BITS      16u
+#endif
+
+/**
+ * @brief  Base de temps du timer pour un protocole.
+ * @param  out          Protocole.
+ * @param  psc          Sortie : prédiviseur (PSC).
+ * @param  period_ticks Sortie : période (ticks, ARR + 1).
+ */
+void esc_out_timebase(Motor_Output_t out, uint32_t *psc, uint32_t *period_ticks);
+
+/**
+ * @brief  Prépare la sortie d'un ESC, avant motor_init().
+ * @details Remplace la plage min/max du handle par celle du protocole. Un DShot demandé
+ * ailleurs que sur TIM2 CH1 retombe en MOTOR_OUT_PWM.
+ * @param  hmotor Pointeur vers le handle du moteur.
+ * @return false si le protocole demandé n'est pas disponible sur cette sortie.
+ */
+bool esc_out_init(Motor_Handle_t *hmotor);
+
+/**
+ * @brief  Démarre l'émission DShot (après motor_init()) ; sans effet pour les autres protocoles.
+ * @param  hmotor Pointeur vers le handle du moteur.
+ */
+void esc_out_start(Motor_Handle_t *hmotor);
+
+/**
+ * @brief  Arrête l'émission DShot, ligne au niveau bas (veille) ; sans effet pour les autres protocoles.
+ * @note   Reprise par esc_out_start().
+ * @param  hmotor Pointeur vers le handle du moteur.
+ */
+void esc_out_stop(const Motor_Handle_t *hmotor);
+
+/**
+ * @brief  Recode la trame DShot émise en boucle si la consigne a changé (tick moteur).
+ * @note   Une trame émise pendant la réécriture échoue au CRC et est ignorée par l'ESC ;
+ * la suivante porte la nouvelle consigne.
+ * @param  hmotor Pointeur vers le handle du moteur.
+ */
+void esc_dshot_update(const Motor_Handle_t *hmotor);
+
+#endif /* INC_DRIVER_ESC_H_ */
@@ -22,6 +22,128 @@
 /** @brief Pin GPIO du Chip Select Gyroscope. */
 #define BMI088_CS_GYRO_Pin          GPIO_PIN_14
 
+/** @brief Port GPIO de la ligne INT1 (data-ready accéléromètre). */
+#define BMI088_INT_ACC_GPIO_Port    GPIOB
+/** @brief Pin GPIO de la ligne INT1 (EXTI1). */
+#define BMI088_INT_ACC_Pin          GPIO_PIN_1
+/** @brief Vecteur d'interruption de la ligne INT1. */
+#define BMI088_INT_ACC_IRQn         EXTI0_1_IRQn
+/** @brief Port GPIO de la ligne INT3 (data-ready gyroscope). */
+#define BMI088_INT_GYRO_GPIO_Port   GPIOB
+/** @brief Pin GPIO de la ligne INT3 (EXTI2). */
+#define BMI088_INT_GYRO_Pin         GPIO_PIN_2
+/** @brief Vecteur d'interruption de la ligne INT3. */
+#define BMI088_INT_GYRO_IRQn        EXTI2_3_IRQn
+
+/** @brief Profondeur de la file d'échantillons (puissance de 2). */
+#define BMI088_SAMPLE_QUEUE_LEN     16
+
+/** @brief Code d'erreur : une acquisition DMA est déjà en cours sur le bus SPI. */
+#define BMI088_E_BUSY               INT8_C(-20)
+
+/** @brief Marge ajoutée au temps de transfert théorique pour le timeout SPI (ms, granularité HAL_GetTick). */
+#define BMI088_SPI_TIMEOUT_MARGIN_MS    2u
+/**
+ * @brief Transferts SPI bloquants et Chip Select au niveau registre (1) ou via la HAL (0).
+ * @details Mode 1 : octets échangés directement sur SPI1->DR (FIFO, deux octets en vol),
+ * CS par BSRR/BRR. La HAL reste utilisée pour l'initialisation, le DMA et la récupération.
+ */
+#ifndef BMI088_SPI_LL
+#define BMI088_SPI_LL                   1
+#endif
+/**
+ * @brief Priorité spi_bus des lectures gyroscope ; l'accéléromètre prend le niveau suivant.
+ * @details Les acquisitions DMA sont soumises à l'ordonnanceur du bus SPI1 (spi_bus.h),
+ * partagé avec les autres capteurs ; le gyroscope passe devant pour terminer au plus
+ * vite une séquence commencée.
+ */
+#ifndef BMI088_SPI_BUS_PRIO
+#define BMI088_SPI_BUS_PRIO             0u
+#endif
+/**
+ * @brief Téléversement des fichiers de configuration accéléromètre en tâche de fond (1) ou bloquant (0).
+ * @details Mode 1 : le démarrage et la récupération rendent la main dès l'accéléromètre et le
+ * gyroscope configurés ; les fichiers any-motion et de synchronisation sont ensuite écrits
+ * par rafales de BMI088_FEATURE_BURST_LEN octets, une par appel de BMI088_Bus_Poll(), entre
+ * deux acquisitions. La fonction est active une fois le fichier accepté par le capteur.
+ */
+#ifndef BMI088_FEATURE_LAZY
+#define BMI088_FEATURE_LAZY             1
+#endif
+/** @brief Octets du fichier de configuration écrits par étape (pair, diviseur de BMI08_CONFIG_STREAM_SIZE). */
+#define BMI088_FEATURE_BURST_LEN        64u
+/** @brief Nombre d'échecs SPI consécutifs déclenchant la séquence de récupération du bus. */
+#define BMI088_BUS_FAIL_THRESHOLD       3u
+/** @brief Attente avant une nouvelle tentative après une récupération échouée (µs). */
+#define BMI088_BUS_RETRY_US             100000u
+
+/** @brief Nombre d'échantillons moyennés par une calibration (2^BMI088_CAL_SAMPLES_SHIFT). */
+#define BMI088_CAL_SAMPLES_SHIFT        8
+/** @brief Nombre d'échantillons moyennés par une calibration. */
+#define BMI088_CAL_SAMPLES              (1u << BMI088_CAL_SAMPLES_SHIFT)
+/** @brief Excursion crête à crête maximale du gyroscope pendant une calibration (µrad/s, ~2 °/s). */
+#define BMI088_CAL_GYRO_SPREAD_URADS    35000
+/**
+ * @brief Calibration du gyroscope au démarrage si la flash ne contient aucune calibration (1) ou jamais (0).
+ * @note  Suppose le véhicule immobile à la mise sous tension ; un mouvement fait échouer la calibration.
+ */
+#ifndef BMI088_CAL_AT_BOOT
+#define BMI088_CAL_AT_BOOT              1
+#endif
+
+/**
+ * @brief Auto-test des capteurs lancé en tâche de fond une fois le démarrage terminé (1) ou sur demande seulement (0).
+ * @details Le résultat est lisible dans REG_BMI et journalisé (DLOG_IMU_SELFTEST) ; les
+ * acquisitions sont suspendues pendant les ~160 ms de l'auto-test, sans retarder le démarrage.
+ */
+#ifndef BMI088_SELFTEST_AT_BOOT
+#define BMI088_SELFTEST_AT_BOOT         1
+#endif
+/** @brief Attente après chaque changement d'excitation de l'auto-test accéléromètre (µs, >= 50 ms datasheet). */
+#define BMI088_SELFTEST_SETTLE_US       50000u
+/** @brief Durée maximale de l'auto-test intégré du gyroscope (µs) avant de le déclarer en échec. */
+#define BMI088_SELFTEST_GYRO_TIMEOUT_US 100000u
+/** @brief Écart minimal entre excitations positive et négative, axes X et Y (LSB à ±24 g, 1000 mg). */
+#define BMI088_SELFTEST_MIN_XY_LSB      1366
+/** @brief Écart minimal entre excitations positive et négative, axe Z (LSB à ±24 g, 500 mg). */
+#define BMI088_SELFTEST_MIN_Z_LSB       683
+
+/**
+ * @name Accès direct aux registres des capteurs (écriture de REG_BMI, bit 15 levé)
+ * Lecture : BMI088_REGIO_FLAG | capteur (BMI088_REGIO_GYRO) | (octets - 1) << 8 | adresse.
+ * Écriture : BMI088_REGIO_FLAG | BMI088_REGIO_WRITE | octet, au registre de la dernière lecture.
+ * Les autres valeurs de REG_BMI restent les commandes d'auto-test.
+ * @{
+ */
+#define BMI088_REGIO_FLAG               0x8000u ///< Accès registre (et non auto-test).
+#define BMI088_REGIO_WRITE              0x4000u ///< Écriture de l'octet bas.
+#define BMI088_REGIO_GYRO               0x2000u ///< Gyroscope (lecture), accéléromètre sinon.
+#define BMI088_REGIO_LEN_SHIFT          8u      ///< Position du nombre d'octets lus, moins un.
+#define BMI088_REGIO_LEN_MASK           0x0Fu   ///< Nombre d'octets lus, moins un (4 bits).
+#define BMI088_REGIO_ADDR_MASK          0x7Fu   ///< Adresse du premier registre.
+#define BMI088_REGIO_MAX_LEN            16u     ///< Octets lus au plus par requête.
+/** @} */
+
+/** @brief Requêtes d'accès aux registres en attente au plus (et résultats non retirés). */
+#ifndef BMI088_REGIO_QUEUE_LEN
+#define BMI088_REGIO_QUEUE_LEN          4u
+#endif
+
+/** @brief Pas d'évaluation de la détection any-motion (ms, 50 Hz interne). */
+#define BMI088_MOTION_TICK_MS           20u
+/** @brief Seuil any-motion maximal (mg, seuil 11 bits au format 5.11). */
+#define BMI088_MOTION_THRESH_MAX_MG     999u
+/**
+ * @brief Une acquisition DMA sur N prolonge la lecture accéléromètre jusqu'à la température.
+ * @details Le capteur ne rafraîchit la température que toutes les 1,28 s : inutile de
+ * la relire à chaque échantillon (12 octets de plus par transaction).
+ */
+#define BMI088_TEMP_EVERY               128u
+/** @brief Température pas encore lue (BMI088_Temperature_cdeg). */
+#define BMI088_TEMP_UNKNOWN             INT16_MIN
+/** @brief Période de l'horloge capteur 24 bits (ns par LSB, 39,0625 µs). */
+#define BMI088_SENSORTIME_NS            39062u
+
 /** @brief Facteur d'échelle LSB/g pour la gamme +/- 3g. */
 #define ACCEL_RANGE_3G_LSB 			10922.67f
 /** @brief Facteur d'échelle LSB/g pour la gamme +/- 6g. */
@@ -46,6 +168,44 @@
 /** @brief Constante de conversion degrés vers radians. */
 #define DEG_TO_RAD                  0.017453292519943295f
 
+/** @brief Nombre de bits fractionnaires des facteurs accéléromètre (Q12, mm/s² par LSB). */
+#define ACCEL_Q_SHIFT               12
+/** @brief Nombre de bits fractionnaires des facteurs gyroscope (Q4, µrad/s par LSB). */
+#define GYRO_Q_SHIFT                4
+/** @brief Calcule (à la compilation) un facteur accéléromètre Q12 depuis un LSB/g. */
+#define ACCEL_Q_FACTOR(lsb)         ((int32_t)((G_TO_MM_S2 / (lsb)) * (float)(1 << ACCEL_Q_SHIFT) + 0.5f))
+/** @brief Calcule (à la compilation) un facteur gyroscope Q4 depuis un LSB/dps. */
+#define GYRO_Q_FACTOR(lsb)          ((int32_t)((DEG_TO_RAD * 1000000.0f / (lsb)) * (float)(1 << GYRO_Q_SHIFT) + 0.5f))
+
+/** @brief Facteur Q12 (mm/s² par LSB) pour la gamme +/- 3g. */
+#define ACCEL_RANGE_3G_Q12          ACCEL_Q_FACTOR(ACCEL_RANGE_3G_LSB)
+/** @brief Facteur Q12 (mm/s² par LSB) pour la gamme +/- 6g. */
+#define ACCEL_RANGE_6G_Q12          ACCEL_Q_FACTOR(ACCEL_RANGE_6G_LSB)
+/** @brief Facteur Q12 (mm/s² par LSB) pour la gamme +/- 12g. */
+#define ACCEL_RANGE_12G_Q12         ACCEL_Q_FACTOR(ACCEL_RANGE_12G_LSB)
+/** @brief Facteur Q12 (mm/s² par LSB) pour la gamme +/- 24g. */
+#define ACCEL_RANGE_24G_Q12         ACCEL_Q_FACTOR(ACCEL_RANGE_24G_LSB)
+
+/** @brief Facteur Q4 (µrad/s par LSB) pour la gamme +/- 125 dps. */
+#define GYRO_RANGE_125DPS_Q4        GYRO_Q_FACTOR(GYRO_RANGE_125DPS_LSB)
+/** @brief Facteur Q4 (µrad/s par LSB) pour la gamme +/- 250 dps. */
+#define GYRO_RANGE_250DPS_Q4        GYRO_Q_FACTOR(GYRO_RANGE_250DPS_LSB)
+/** @brief Facteur Q4 (µrad/s par LSB) pour la gamme +/- 500 dps. */
+#define GYRO_RANGE_500DPS_Q4        GYRO_Q_FACTOR(GYRO_RANGE_500DPS_LSB)
+/** @brief Facteur Q4 (µrad/s par LSB) pour la gamme +/- 1000 dps. */
+#define GYRO_RANGE_1000DPS_Q4       GYRO_Q_FACTOR(GYRO_RANGE_1000DPS_LSB)
+/** @brief Facteur Q4 (µrad/s par LSB) pour la gamme +/- 2000 dps. */
+#define GYRO_RANGE_2000DPS_Q4       GYRO_Q_FACTOR(GYRO_RANGE_2000DPS_LSB)
+
+/** @brief Taille de la FIFO accéléromètre (octets). */
+#define BMI088_ACCEL_FIFO_SIZE          1024
+/** @brief Taille d'une trame accéléromètre en mode header (1 header + 6 données). */
+#define BMI088_ACCEL_FIFO_FRAME_SIZE    7
+/** @brief Nombre maximal de trames accéléromètre contenues dans la FIFO. */
+#define BMI088_ACCEL_FIFO_MAX_FRAMES    (BMI088_ACCEL_FIFO_SIZE / BMI088_ACCEL_FIFO_FRAME_SIZE)
+/** @brief Nombre maximal de trames X/Y/Z contenues dans la FIFO gyroscope. */
+#define BMI088_GYRO_FIFO_MAX_FRAMES     100
+
 /**
  * @brief Structure de définition d'un Chip Select SPI.
  */
@@ -54,6 +214,84 @@ typedef struct {
     uint16_t pin;           ///< Numéro de Pin GPIO.
 } bmi088_cs_t;
 
+/**
+ * @brief Configuration de mesure modifiable à chaud (codes de l'API Bosch).
+ */
+typedef struct {
+    uint8_t accel_range;    ///< Gamme accéléromètre (BMI088_ACCEL_RANGE_*).
+    uint8_t accel_odr;      ///< ODR accéléromètre (BMI08_ACCEL_ODR_*).
+    uint8_t accel_bw;       ///< Bande passante accéléromètre (BMI08_ACCEL_BW_*).
+    uint8_t gyro_range;     ///< Gamme gyroscope (BMI08_GYRO_RANGE_*).
+    uint8_t gyro_odr;       ///< ODR/BW gyroscope (BMI08_GYRO_BW_*).
+} bmi088_config_t;
+
+/**
+ * @brief Profils latence / bruit : ODR et bandes passantes prédéfinies (gammes conservées).
+ * @details Bande passante à -3 dB approximative (datasheet) et retard de groupe associé :
+ * plus la bande est large, plus la mesure est fraîche et bruitée.
+ */
+typedef enum{
+    BMI088_PROFILE_CUSTOM=0,    ///< Codes ODR/BW choisis un à un.
+    BMI088_PROFILE_LOW_NOISE,   ///< Accel OSR4 à 400 Hz (~40 Hz), gyro 116 Hz à 1 kHz.
+    BMI088_PROFILE_BALANCED,    ///< Accel OSR2 à 800 Hz (~145 Hz), gyro 230 Hz à 2 kHz.
+    BMI088_PROFILE_LOW_LATENCY, ///< Accel normal à 1600 Hz (~280 Hz), gyro 532 Hz à 2 kHz.
+    BMI088_PROFILE_COUNT
+} bmi088_profile_t;
+
+/**
+ * @brief Données IMU en virgule fixe (aucun calcul flottant côté MCU).
+ */
+typedef struct {
+    int32_t accel_mms2[3];  ///< Accélération [X, Y, Z] (mm/s²).
+    int32_t gyro_urads[3];  ///< Vitesse angulaire [X, Y, Z] (µrad/s).
+    uint64_t timestamp_us;  ///< Date d'acquisition (µs, GetMicros64).
+    uint32_t sensor_time;   ///< Horloge du capteur à l'acquisition (24 bits, BMI088_SENSORTIME_NS).
+} bmi088_data_fx_t;
+
+/**
+ * @brief Observateur appelé pour chaque échantillon retiré de la file (boucle principale).
+ * @param sample Échantillon en virgule fixe.
+ */
+typedef void (*bmi088_sample_hook_t)(const bmi088_data_fx_t *sample);
+
+/**
+ * @brief Échantillon brut compact retourné par la lecture rapide.
+ * @note  12 octets sans padding (alignement naturel sur 16 bits).
+ */
+typedef struct {
+    int16_t accel[3];       ///< Accélération brute [X, Y, Z] (LSB).
+    int16_t gyro[3];        ///< Vitesse angulaire brute [X, Y, Z] (LSB).
+} bmi088_raw_t;
+
+/**
+ * @brief Observateur brut appelé pour chaque échantillon retiré de la file (boucle principale).
+ * @param raw          Échantillon brut (LSB, sans correction de calibration).
+ * @param timestamp_us Date de l'acquisition (µs, GetMicros64).
+ */
+typedef void (*bmi088_raw_hook_t)(const bmi088_raw_t *raw, uint64_t timestamp_us);
+
+/**
+ * @brief Filtre appliqué à chaque échantillon retiré de la file, après les observateurs.
+ * @param raw          Échantillon brut, remplacé par sa valeur filtrée (LSB).
+ * @param timestamp_us Date de l'acquisition (µs, GetMicros64).
+ */
+typedef void (*bmi088_filter_hook_t)(bmi088_raw_t *raw, uint64_t timestamp_us);
+
+/**
+ * @brief Observateur de publication appelé à chaque échantillon acquis par DMA, en
+ * interruption, une fois l'échantillon lisible par BMI088_Get_Latest_Fx().
+ * @note  Doit rester bref (typiquement : demander une interruption logicielle).
+ */
+typedef void (*bmi088_publish_hook_t)(void);
+
+/**
+ * @brief Source de déclenchement des acquisitions en mode data-ready.
+ */
+typedef enum {
+    BMI088_DRDY_ACCEL = 0,  ///< Ligne INT1 (data-ready accéléromètre).
+    BMI088_DRDY_GYRO        ///< Ligne INT3 (data-ready gyroscope).
+} bmi088_drdy_src_t;
+
 /**
  * @brief Structure de données physiques unifiées pour l'application.
  */
@@ -66,9 +304,96 @@ typedef struct {
     float gyro_y_rads;      ///< Vitesse angulaire Y (rad/s).
     float gyro_z_rads;      ///< Vitesse angulaire Z (rad/s).
 
-    uint32_t timestamp_ms;  ///< Date de la mesure (ms depuis le démarrage).
+    uint64_t timestamp_us;  ///< Date d'acquisition (µs, GetMicros64).
 } bmi088_data_t;
 
+/**
+ * @brief Lot d'échantillons bruts extraits des FIFO en une seule rafale.
+ * @note  Les échantillons sont rangés du plus ancien au plus récent ; le
+ * dernier de chaque tableau est daté de `timestamp_us`.
+ */
+typedef struct {
+    struct bmi08_sensor_data accel[BMI088_ACCEL_FIFO_MAX_FRAMES]; ///< Trames accéléromètre brutes.
+    struct bmi08_sensor_data gyro[BMI088_GYRO_FIFO_MAX_FRAMES];   ///< Trames gyroscope brutes.
+    uint16_t accel_count;       ///< Nombre de trames accéléromètre valides.
+    uint16_t gyro_count;        ///< Nombre de trames gyroscope valides.
+    uint32_t accel_period_us;   ///< Période d'échantillonnage accéléromètre (µs).
+    uint32_t gyro_period_us;    ///< Période d'échantillonnage gyroscope (µs).
+    uint64_t timestamp_us;      ///< Date du vidage (µs, GetMicros64).
+} bmi088_fifo_batch_t;
+
+/**
+ * @brief Demandes de calibration (valeur écrite dans REG_IMU_CAL).
+ */
+typedef enum {
+    BMI088_CAL_REQ_GYRO = 1,        ///< Biais gyroscope seul (véhicule immobile).
+    BMI088_CAL_REQ_GYRO_ACCEL = 2,  ///< Biais gyroscope et accéléromètre (véhicule immobile et à plat, Z vers le haut).
+    BMI088_CAL_REQ_CLEAR = 3        ///< Offsets remis à zéro et page de calibration effacée.
+} bmi088_cal_req_t;
+
+/**
+ * @brief État de la dernière calibration.
+ */
+typedef enum {
+    BMI088_CAL_IDLE = 0,        ///< Aucune calibration depuis le démarrage.
+    BMI088_CAL_RUNNING,         ///< Moyennage en cours.
+    BMI088_CAL_DONE,            ///< Offsets appliqués et enregistrés en flash.
+    BMI088_CAL_E_MOTION,        ///< Échec : mouvement détecté pendant le moyennage.
+    BMI088_CAL_E_FLASH,         ///< Offsets appliqués, mais échec de l'enregistrement en flash.
+    BMI088_CAL_E_ABORTED        ///< Interrompue par un changement de gamme.
+} bmi088_cal_state_t;
+
+/**
+ * @brief Accès direct à un registre capteur (REG_BMI, bit 15), requête puis résultat.
+ */
+typedef struct {
+    uint8_t write;                      ///< 0 : lecture, 1 : écriture puis relecture.
+    uint8_t sensor;                     ///< 0 : accéléromètre, 1 : gyroscope.
+    uint8_t addr;                       ///< Adresse du premier registre.
+    uint8_t len;                        ///< Octets lus (1 à BMI088_REGIO_MAX_LEN).
+    int8_t  status;                     ///< BMI08_OK ou code d'erreur (résultat).
+    uint8_t data[BMI088_REGIO_MAX_LEN]; ///< Octet à écrire (data[0]), puis octets lus.
+} bmi088_regio_t;
+
+/**
+ * @brief État de l'auto-test des capteurs (octet bas de REG_BMI).
+ */
+typedef enum {
+    BMI088_ST_IDLE = 0,         ///< Aucun auto-test depuis le démarrage.
+    BMI088_ST_RUNNING,          ///< Auto-test en cours.
+    BMI088_ST_PASS,             ///< Accéléromètre et gyroscope conformes.
+    BMI088_ST_FAIL,             ///< Au moins un capteur hors tolérance (détail : bmi088_st_fail_t).
+    BMI088_ST_E_COM             ///< Interrompu par une erreur SPI ou une récupération du bus.
+} bmi088_st_state_t;
+
+/**
+ * @brief Capteurs en échec lors du dernier auto-test (octet haut de REG_BMI).
+ */
+typedef enum {
+    BMI088_ST_FAIL_ACC_X = 0x01u,   ///< Accéléromètre X : écart inférieur à BMI088_SELFTEST_MIN_XY_LSB.
+    BMI088_ST_FAIL_ACC_Y = 0x02u,   ///< Accéléromètre Y : écart inférieur à BMI088_SELFTEST_MIN_XY_LSB.
+    BMI088_ST_FAIL_ACC_Z = 0x04u,   ///< Accéléromètre Z : écart inférieur à BMI088_SELFTEST_MIN_Z_LSB.
+    BMI088_ST_FAIL_GYRO  = 0x08u    ///< Gyroscope : bist_fail levé, ou bist_rdy absent après BMI088_SELFTEST_GYRO_TIMEOUT_US.
+} bmi088_st_fail_t;
+
+/**
+ * @brief Offsets soustraits à chaque conversion en unités physiques.
+ */
+typedef struct {
+    int32_t gyro_urads[3];  ///< Biais gyroscope [X, Y, Z] (µrad/s).
+    int32_t accel_mms2[3];  ///< Offset accéléromètre [X, Y, Z] (mm/s², gravité exclue).
+} bmi088_offsets_t;
+
+/**
+ * @brief Compteurs d'erreurs du bus SPI capteurs.
+ */
+typedef struct {
+    uint32_t timeouts;      ///< Transferts interrompus par timeout (bloquants ou DMA bloqué).
+    uint32_t errors;        ///< Erreurs HAL (HAL_ERROR, HAL_BUSY, callback d'erreur DMA).
+    uint32_t recoveries;    ///< Séquences de récupération menées à terme.
+    uint8_t  recovering;    ///< 1 tant qu'une séquence de démarrage ou de récupération est en cours.
+} bmi088_bus_stats_t;
+
 /**
  * @brief  Initialise le driver BMI088.
  * @param  hspi Pointeur vers le handle SPI utilisé.
@@ -76,6 +401,19 @@ typedef struct {
  */
 int8_t BMI088_Init(SPI_HandleTypeDef *hspi);
 
+/**
+ * @brief  Lance l'initialisation du driver sans bloquer (déroulée par BMI088_Bus_Poll).
+ * @param  hspi Pointeur vers le handle SPI utilisé.
+ * @return BMI08_OK ou BMI08_E_NULL_PTR.
+ */
+int8_t BMI088_Init_Async(SPI_HandleTypeDef *hspi);
+
+/**
+ * @brief  Indique si les capteurs sont initialisés et le bus opérationnel.
+ * @return 1 si prêt, 0 pendant le démarrage ou une récupération.
+ */
+uint8_t BMI088_Ready(void);
+
 /**
  * @brief  Lit les registres bruts de l'accéléromètre.
  * @param  accel_data Structure de sortie pour les données brutes.
@@ -90,6 +428,13 @@ int8_t BMI088_Read_Accel_Raw(struct bmi08_sensor_data *accel_data);
  */
 int8_t BMI088_Read_Gyro_Raw(struct bmi08_sensor_data *gyro_data);
 
+/**
+ * @brief  Lecture rapide accel + gyro (une transaction par capteur, hors couche Bosch).
+ * @param  raw Structure de sortie pour les données brutes.
+ * @return BMI08_OK ou code d'erreur.
+ */
+int8_t BMI088_Read_Raw_Fast(bmi088_raw_t *raw);
+
 /**
  * @brief  Effectue une lecture complète et convertit les données.
  * @param  data Structure de sortie pour les données physiques.
@@ -111,6 +456,20 @@ void BMI088_Convert_Accel(struct bmi08_sensor_data *accel_raw, float *accel_mms2
  */
 void BMI088_Convert_Gyro(struct bmi08_sensor_data *gyro_raw, float *gyro_rads);
 
+/**
+ * @brief  Convertit un jeu de données brutes accéléromètre en mm/s² (entiers, Q12).
+ * @param  accel_raw Données d'entrée brutes.
+ * @param  accel_mms2 Tableau de sortie [X, Y, Z].
+ */
+void BMI088_Convert_Accel_Fx(const struct bmi08_sensor_data *accel_raw, int32_t *accel_mms2);
+
+/**
+ * @brief  Convertit un jeu de données brutes gyroscope en µrad/s (entiers, Q4).
+ * @param  gyro_raw Données d'entrée brutes.
+ * @param  gyro_urads Tableau de sortie [X, Y, Z].
+ */
+void BMI088_Convert_Gyro_Fx(const struct bmi08_sensor_data *gyro_raw, int32_t *gyro_urads);
+
 /**
  * @brief  Vérifie la présence des capteurs sur le bus SPI.
  * @param  print_result Active l'affichage debug via printf.
@@ -124,4 +483,325 @@ uint8_t BMI088_Test_Communication(uint8_t print_result);
  */
 int8_t BMI088_Soft_Reset(void);
 
+/**
+ * @brief  Lance une acquisition non bloquante (SPI DMA) Accel + Gyro.
+ * @return BMI08_OK, BMI088_E_BUSY si une acquisition est en cours, ou code d'erreur.
+ */
+int8_t BMI088_Start_Read_DMA(void);
+
+/**
+ * @brief  Récupère le dernier échantillon acquis par DMA, converti en unités physiques.
+ * @param  data Structure de sortie pour les données physiques.
+ * @return 1 si un nouvel échantillon est disponible, 0 sinon.
+ */
+uint8_t BMI088_Get_Sample(bmi088_data_t *data);
+
+/**
+ * @brief  Lit le dernier échantillon acquis, converti en virgule fixe, sans le consommer.
+ * @param  data Structure de sortie (mm/s², µrad/s).
+ * @return Numéro de l'échantillon (croissant), 0 si aucun échantillon n'a été acquis.
+ */
+uint32_t BMI088_Get_Latest_Fx(bmi088_data_fx_t *data);
+
+/**
+ * @brief  Dernière température lue par les acquisitions DMA.
+ * @return Température (centièmes de °C), BMI088_TEMP_UNKNOWN avant la première lecture.
+ */
+int16_t BMI088_Temperature_cdeg(void);
+
+/**
+ * @brief  Retire le plus ancien échantillon de la file d'acquisition.
+ * @param  data Structure de sortie pour les données physiques.
+ * @return 1 si un échantillon a été retiré, 0 si la file est vide.
+ */
+uint8_t BMI088_Queue_Pop(bmi088_data_t *data);
+
+/**
+ * @brief  Retire le plus ancien échantillon de la file, converti en virgule fixe.
+ * @param  data Structure de sortie (mm/s², µrad/s).
+ * @return 1 si un échantillon a été retiré, 0 si la file est vide.
+ */
+uint8_t BMI088_Queue_Pop_Fx(bmi088_data_fx_t *data);
+
+/**
+ * @brief  Retire le plus ancien échantillon de la file, sans conversion.
+ * @param  raw          Échantillon brut de sortie (LSB).
+ * @param  timestamp_us Date de l'acquisition (µs).
+ * @return 1 si un échantillon a été retiré, 0 si la file est vide.
+ */
+uint8_t BMI088_Queue_Pop_Raw(bmi088_raw_t *raw, uint64_t *timestamp_us);
+
+/**
+ * @brief  Nombre d'échantillons perdus (file pleine ou bus occupé).
+ * @return Compteur de pertes depuis le démarrage.
+ */
+uint32_t BMI088_Queue_Dropped(void);
+
+/**
+ * @brief  Nombre d'échantillons en attente dans la file.
+ * @return Échantillons publiés et non encore retirés.
+ */
+uint8_t BMI088_Queue_Pending(void);
+
+/**
+ * @brief  Suspend (ou reprend) les acquisitions pour alimenter la file par BMI088_Inject().
+ * @details Mode rejeu : ni la tâche IMU ni la ligne data-ready ne lancent de lecture,
+ * la file n'a plus qu'un producteur, la boucle principale.
+ * @param  on 1 pour suspendre les acquisitions, 0 pour les reprendre.
+ */
+void BMI088_Inject_Mode(uint8_t on);
+
+/**
+ * @brief  Publie un échantillon enregistré dans la file d'acquisition.
+ * @details L'échantillon suit ensuite le chemin d'un échantillon lu (calibration,
+ * observateurs, filtre, conversion) ; l'horloge capteur est déduite de la date.
+ * @param  raw          Échantillon brut (LSB, gammes courantes).
+ * @param  timestamp_us Date attribuée à l'échantillon (µs).
+ * @return 1 si publié, 0 si la file est pleine (perte comptée dans BMI088_Queue_Dropped()).
+ */
+uint8_t BMI088_Inject(const bmi088_raw_t *raw, uint64_t timestamp_us);
+
+/**
+ * @brief  Installe l'observateur des échantillons de la file (estimateurs embarqués).
+ * @param  hook Fonction appelée pour chaque échantillon retiré, quel que soit le
+ * format de télémétrie ; NULL pour le retirer.
+ */
+void BMI088_Set_Sample_Hook(bmi088_sample_hook_t hook);
+
+/**
+ * @brief  Installe l'observateur brut des échantillons de la file (historique).
+ * @param  hook Fonction appelée pour chaque échantillon retiré, avant l'observateur en
+ * virgule fixe ; NULL pour le retirer.
+ */
+void BMI088_Set_Raw_Hook(bmi088_raw_hook_t hook);
+
+/**
+ * @brief  Installe le filtre des échantillons retournés par les fonctions de retrait.
+ * @details Les observateurs reçoivent toujours l'échantillon non filtré.
+ * @param  hook Fonction appelée pour chaque échantillon retiré ; NULL pour le retirer.
+ */
+void BMI088_Set_Filter_Hook(bmi088_filter_hook_t hook);
+
+/**
+ * @brief  Installe l'observateur de publication des acquisitions DMA (contexte interruption).
+ * @details Appelé en fin d'interruption de fin de DMA, après la publication de
+ * l'échantillon et hors sonde PROF_PROBE_IMU_SPI_ISR ; jamais pour les échantillons
+ * injectés (rejeu).
+ * @param  hook Fonction appelée à chaque publication ; NULL pour le retirer.
+ */
+void BMI088_Set_Publish_Hook(bmi088_publish_hook_t hook);
+
+/**
+ * @brief  Cadence les acquisitions DMA sur la ligne data-ready d'un capteur.
+ * @param  source Capteur source (INT1 accéléromètre ou INT3 gyroscope).
+ * @return BMI08_OK ou code d'erreur.
+ */
+int8_t BMI088_DataReady_Init(bmi088_drdy_src_t source);
+
+/**
+ * @brief  Active la synchronisation Accel/Gyro (lecture combinée, jusqu'à 2 kHz).
+ * @param  mode BMI08_ACCEL_DATA_SYNC_MODE_400HZ, _1000HZ ou _2000HZ.
+ * @return BMI08_OK ou code d'erreur.
+ */
+int8_t BMI088_DataSync_Init(uint8_t mode);
+
+/**
+ * @brief  Indique si le mode data-ready est actif.
+ * @return 1 si actif, 0 sinon.
+ */
+uint8_t BMI088_DataReady_Active(void);
+
+/**
+ * @brief  Active (ou désactive) la détection de mouvement any-motion de l'accéléromètre.
+ * @details Le premier appel téléverse le fichier de configuration any-motion (en tâche de
+ * fond avec BMI088_FEATURE_LAZY, bloquant ~160 ms sinon) ; les détections sont signalées
+ * sur INT1 et comptées par BMI088_Motion_Events().
+ * Incompatible avec la synchronisation Accel/Gyro et le data-ready accéléromètre (INT1).
+ * @param  threshold_mg Seuil de variation d'accélération (mg, 1..BMI088_MOTION_THRESH_MAX_MG), 0 pour désactiver.
+ * @param  duration_ms  Durée de dépassement avant détection (ms, multiple de BMI088_MOTION_TICK_MS).
+ * @return BMI08_OK (ou demande mémorisée pendant le démarrage), BMI08_E_INVALID_CONFIG si
+ * INT1 est déjà utilisée, BMI088_E_BUSY ou code d'erreur.
+ */
+int8_t BMI088_Motion_Config(uint16_t threshold_mg, uint16_t duration_ms);
+
+/**
+ * @brief  Nombre de détections de mouvement signalées depuis le démarrage.
+ * @return Compteur (reboucle), constant tant que la détection est inactive.
+ */
+uint32_t BMI088_Motion_Events(void);
+
+/**
+ * @brief  Met les capteurs en veille (véhicule garé) ou les réveille.
+ * @details Veille : gyroscope en suspend ; accéléromètre en suspend aussi, sauf si la
+ * détection any-motion est armée (elle échantillonne l'accéléromètre). Réveil bloquant :
+ * 30 ms gyroscope, 5 ms accéléromètre (délais Bosch), configuration conservée.
+ * @param  enable 1 : veille, 0 : réveil.
+ * @return BMI08_OK, BMI088_E_BUSY (démarrage, bus occupé) ou code d'erreur.
+ */
+int8_t BMI088_Low_Power(uint8_t enable);
+
+/**
+ * @brief  Active le mode FIFO avec les ODR et le seuil (watermark) demandés.
+ * @param  accel_odr ODR accéléromètre (BMI08_ACCEL_ODR_*).
+ * @param  gyro_odr  ODR/BW gyroscope (BMI08_GYRO_BW_*).
+ * @param  wm_frames Seuil en nombre de trames.
+ * @return BMI08_OK ou code d'erreur.
+ */
+int8_t BMI088_FIFO_Init(uint8_t accel_odr, uint8_t gyro_odr, uint16_t wm_frames);
+
+/**
+ * @brief  Vide les FIFO accéléromètre et gyroscope dans un lot d'échantillons.
+ * @param  batch Lot de sortie.
+ * @return BMI08_OK, BMI08_W_FIFO_EMPTY ou code d'erreur.
+ */
+int8_t BMI088_FIFO_Read_Batch(bmi088_fifo_batch_t *batch);
+
+/**
+ * @brief  Âge d'un échantillon du lot par rapport à la date de vidage.
+ * @param  index  Index de l'échantillon dans le tableau.
+ * @param  count  Nombre d'échantillons du tableau.
+ * @param  period_us Période d'échantillonnage du capteur (µs).
+ * @return Ancienneté de l'échantillon en microsecondes.
+ */
+static inline uint32_t BMI088_FIFO_Sample_Age_us(uint16_t index, uint16_t count, uint32_t period_us){
+    return (uint32_t)(count - 1u - index) * period_us;
+}
+
+/**
+ * @brief  Reconfigure gammes/ODR/bande passante et les facteurs de conversion associés.
+ * @param  cfg Nouvelle configuration.
+ * @return BMI08_OK, BMI08_E_INVALID_INPUT, BMI088_E_BUSY ou code d'erreur.
+ */
+int8_t BMI088_Configure(const bmi088_config_t *cfg);
+
+/**
+ * @brief  Lit la configuration de mesure active.
+ * @param  cfg Structure de sortie.
+ */
+void BMI088_Get_Config(bmi088_config_t *cfg);
+
+/**
+ * @brief  Remplace les codes ODR/BW d'une configuration par ceux d'un profil.
+ * @param  profile Profil (bmi088_profile_t) ; BMI088_PROFILE_CUSTOM ou inconnu : sans effet.
+ * @param  cfg     Configuration à compléter (gammes conservées).
+ */
+void BMI088_Profile_Apply(uint8_t profile, bmi088_config_t *cfg);
+
+/**
+ * @brief  Profil correspondant aux codes ODR/BW d'une configuration.
+ * @param  cfg Configuration.
+ * @return bmi088_profile_t, BMI088_PROFILE_CUSTOM si aucun profil ne correspond.
+ */
+uint8_t BMI088_Profile_Of(const bmi088_config_t *cfg);
+
+/**
+ * @brief  Période de données du capteur le plus rapide (configuration active).
+ * @details Relire plus souvent ne fait que redemander le même échantillon.
+ * @return Période (µs).
+ */
+uint32_t BMI088_Sample_Period_us(void);
+
+/**
+ * @brief  Chronomètre des lectures bloquantes accel + gyro (validation de la vitesse SPI).
+ * @param  count  Nombre de lectures.
+ * @param  avg_ns Sortie : durée moyenne par lecture (ns).
+ * @return BMI08_OK ou code d'erreur.
+ */
+int8_t BMI088_Benchmark_Read(uint16_t count, uint32_t *avg_ns);
+
+/**
+ * @brief  Suspend l'acquisition data-ready pour des lectures bloquantes hors driver (banc de mesure).
+ * @return 1 si le bus est libre, 0 sinon.
+ * @note   Doit toujours être suivie de BMI088_Bus_Resume().
+ */
+uint8_t BMI088_Bus_Suspend(void);
+
+/**
+ * @brief  Réactive l'acquisition suspendue par BMI088_Bus_Suspend().
+ */
+void BMI088_Bus_Resume(void);
+
+/**
+ * @brief  Surveille le bus SPI et fait avancer la séquence de démarrage ou de récupération.
+ * @details À appeler périodiquement depuis la boucle principale : interrompt une
+ * séquence DMA bloquée et exécute au plus une étape par appel.
+ * @param  now_us Timestamp actuel en microsecondes.
+ * @return Date de l'étape suivante (µs), UINT64_MAX si aucune séquence n'est en cours.
+ */
+uint64_t BMI088_Bus_Poll(uint64_t now_us);
+
+/**
+ * @brief  Demande la séquence de récupération du bus hors échec SPI (capteur figé, muet).
+ * @return BMI08_OK si armée, BMI088_E_BUSY si un démarrage ou une récupération est en cours.
+ */
+int8_t BMI088_Recover(void);
+
+/**
+ * @brief  Copie les compteurs d'erreurs du bus SPI.
+ * @param  stats Structure de sortie.
+ */
+void BMI088_Get_Bus_Stats(bmi088_bus_stats_t *stats);
+
+/**
+ * @brief  Lance une calibration par moyennage, ou efface la calibration enregistrée.
+ * @details Les BMI088_CAL_SAMPLES échantillons suivants de la file sont moyennés
+ * au fil de leur retrait ; les offsets sont ensuite appliqués et enregistrés en flash.
+ * @param  req Demande (bmi088_cal_req_t).
+ * @return BMI08_OK, BMI08_E_INVALID_INPUT si la demande est inconnue, BMI08_E_COM_FAIL
+ * si l'effacement de la flash échoue.
+ */
+int8_t BMI088_Calibrate(uint8_t req);
+
+/**
+ * @brief  État de la dernière calibration.
+ * @return bmi088_cal_state_t.
+ */
+uint8_t BMI088_Cal_State(void);
+
+/**
+ * @brief  Indique si les offsets actifs proviennent d'un enregistrement en flash.
+ * @return 1 si un enregistrement valide existe, 0 sinon.
+ */
+uint8_t BMI088_Cal_Stored(void);
+
+/**
+ * @brief  Copie les offsets actifs.
+ * @param  ofs Structure de sortie.
+ */
+void BMI088_Get_Offsets(bmi088_offsets_t *ofs);
+
+/**
+ * @brief  Lance l'auto-test des capteurs en tâche de fond.
+ * @details Déroulé par BMI088_Bus_Poll() une fois le bus opérationnel et tout
+ * téléversement terminé ; les acquisitions renvoient BMI088_E_BUSY jusqu'à la fin.
+ * Sans effet si un auto-test est déjà en cours.
+ */
+void BMI088_SelfTest_Start(void);
+
+/**
+ * @brief  Résultat du dernier auto-test.
+ * @return bmi088_st_state_t | (bmi088_st_fail_t << 8).
+ */
+uint16_t BMI088_SelfTest_Status(void);
+
+/**
+ * @brief  Met en file un accès direct aux registres des capteurs (REG_BMI, bit 15).
+ * @details Lecture (BMI088_REGIO_WRITE à 0) : sélectionne le capteur et l'adresse, puis
+ * lit 1 à BMI088_REGIO_MAX_LEN octets. Écriture : octet bas écrit au registre sélectionné
+ * par la dernière lecture mise en file, puis relu. Exécuté par BMI088_Bus_Poll() entre
+ * deux acquisitions (bmi08a_get_set_regs(), bmi08g_get_regs(), bmi08g_set_regs()).
+ * @note   Une écriture contourne la configuration du pilote (gammes, ODR : échelles non
+ * recalculées) ; REG_IMU_CONFIG la réécrit.
+ * @param  cmd Valeur écrite dans REG_BMI.
+ * @return BMI08_OK, BMI08_E_INVALID_INPUT (aucune adresse sélectionnée), ou BMI088_E_BUSY (file pleine).
+ */
+int8_t BMI088_RegIO_Request(uint16_t cmd);
+
+/**
+ * @brief  Retire un accès aux registres terminé.
+ * @param  io Sortie.
+ * @return 1 si un résultat a été retiré, 0 si aucun n'est disponible.
+ */
+uint8_t BMI088_RegIO_Pop(bmi088_regio_t *io);
+
 #endif /* BMI088_DRIVER_H */
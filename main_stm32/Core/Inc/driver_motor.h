@@ -27,16 +27,133 @@ typedef enum{
     MOTOR_STATE_NEUTRAL_TO_REVERSE_GAP      ///< Pause avant d'enclencher la marche arrière.
 } MotorState_t;
 
+/**
+ * @brief Protocole de sortie vers l'ESC (cf. driver_esc.h).
+ * @details La machine à états et la boucle de vitesse produisent toujours une consigne
+ * en ticks entre min_pulse_ticks et max_pulse_ticks, neutre au milieu ; seul le
+ * codage de la sortie change. Les ESC sur un même timer partagent le même protocole.
+ */
+typedef enum{
+    MOTOR_OUT_PWM = 0,                      ///< Impulsion 1-2 ms à ACT_ESC_PWM_HZ (tout ESC).
+    MOTOR_OUT_ONESHOT125,                   ///< Impulsion 125-250 µs à ESC_ONESHOT_HZ.
+    MOTOR_OUT_MULTISHOT,                    ///< Impulsion 5-25 µs à ESC_MULTISHOT_HZ.
+    MOTOR_OUT_DSHOT300,                     ///< Trames numériques DShot300 (TIM2 CH1 + DMA, mode 3D).
+    MOTOR_OUT_DSHOT600                      ///< Trames numériques DShot600 (TIM2 CH1 + DMA, mode 3D).
+} Motor_Output_t;
+
+/** @brief Sortie numérique DShot (consigne codée en trames, pas en largeur d'impulsion). */
+#define MOTOR_OUT_IS_DSHOT(out)   ((out) >= MOTOR_OUT_DSHOT300)
+
 /**
  * @brief Structure de contexte interne pour la gestion des transitions.
  */
 typedef struct{
     int16_t  target_speed_mms;     ///< Vitesse cible demandée en mm/s.
-    uint8_t  target_pwm;           ///< Pourcentage PWM cible calculé (0-100).
+    uint16_t target_ticks;         ///< Consigne CCR de marche (feed-forward + boucle de vitesse).
     bool     target_forward;       ///< Direction cible (true=avant, false=arrière).
     uint32_t deadline_ms;          ///< Echéance temporelle pour les états temporisés.
 } Motor_Context_t;
 
+/** @brief Durée par défaut du coup de frein avant inversion (ms). */
+#define MOTOR_ESC_BRAKE_MS_DEFAULT      120u
+/** @brief Durée par défaut de la pause au neutre après le coup de frein (ms). */
+#define MOTOR_ESC_GAP_MS_DEFAULT        120u
+/** @brief Écart au neutre par défaut du coup de frein (% PWM : 40 % / 60 %). */
+#define MOTOR_ESC_BRAKE_DEPTH_DEFAULT   10u
+
+/**
+ * @brief Profil de temporisation de l'ESC (réglable à l'exécution).
+ * @details Durées nulles : états correspondants traversés sans attente. Un ESC
+ * bidirectionnel (sans séquence frein / neutre pour inverser) se règle à 0 / 0.
+ */
+typedef struct{
+    uint16_t brake_ms;             ///< Durée du coup de frein (ms).
+    uint16_t neutral_gap_ms;       ///< Durée de la pause au neutre (ms).
+    uint8_t  brake_depth;          ///< Écart au neutre de l'impulsion de frein (% PWM, <= 50).
+} Motor_Esc_Profile_t;
+
+/** @brief Nombre de bits fractionnaires des gains et de l'intégrale de la boucle de vitesse. */
+#define MOTOR_LOOP_Q            12
+
+/**
+ * @brief État de la boucle de vitesse PI(D) en virgule fixe.
+ * @details Sortie en ticks CCR : feed-forward (carte vitesse -> ticks) + correction.
+ * Gains en Q12 (% PWM par mm/s) ; boucle inactive (boucle ouverte) si tous sont nuls.
+ */
+typedef struct{
+    int16_t kp_q12;                ///< Gain proportionnel (Q12).
+    int16_t ki_q12;                ///< Gain intégral par échantillon (Q12).
+    int16_t kd_q12;                ///< Gain dérivé par échantillon (Q12).
+    uint16_t ff_ticks;             ///< Feed-forward issu de motor_speed_mms_to_ticks() (CCR).
+    int32_t integ_q12;             ///< Terme intégral (Q12, % PWM), borné (anti-windup).
+    int16_t prev_err_mms;          ///< Erreur de l'échantillon précédent (terme dérivé).
+    int16_t measured_mms;          ///< Dernière vitesse mesurée (signée, estimateur de vitesse).
+} Motor_Speed_Loop_t;
+
+/** @brief Détection de patinage / blocage de la roue motrice (1) ou absente (0). */
+#ifndef MOTOR_TRAC_ENABLE
+#define MOTOR_TRAC_ENABLE       1
+#endif
+
+/** @brief Gaz limités pendant un patinage / blocage détecté (1) ou simple signalement (0). */
+#ifndef MOTOR_TRAC_LIMIT
+#define MOTOR_TRAC_LIMIT        1
+#endif
+
+/**
+ * @name Seuils de la détection de patinage / blocage
+ * @details Évalués à chaque mesure de vitesse (motor_speed_feedback(), TASK_SPEED_US :
+ * 20 ms), en marche stable et pour une consigne d'au moins MOTOR_TRAC_MIN_CMD_MMS.
+ * @{
+ */
+#define MOTOR_TRAC_MIN_CMD_MMS      150     ///< Consigne minimale surveillée (mm/s, valeur absolue).
+#define MOTOR_TRAC_STALL_MMS        40      ///< Vitesse mesurée sous laquelle la roue est bloquée (mm/s).
+#define MOTOR_TRAC_STALL_PCT        8u      ///< Écart au neutre minimal de la sortie pour un blocage (% PWM).
+#define MOTOR_TRAC_STALL_SAMPLES    15u     ///< Mesures consécutives confirmant un blocage (300 ms).
+#define MOTOR_TRAC_SLIP_MMS         600     ///< Survitesse mesurée sur la consigne signalant un patinage (mm/s).
+#define MOTOR_TRAC_SLIP_DV_MMS      250     ///< Accélération maximale plausible par mesure (mm/s, 12,5 m/s² à 20 ms).
+#define MOTOR_TRAC_SLIP_SAMPLES     3u      ///< Mesures consécutives confirmant un patinage.
+#define MOTOR_TRAC_CLEAR_SAMPLES    25u     ///< Mesures consécutives sans anomalie avant la levée (500 ms).
+#define MOTOR_TRAC_LIMIT_PCT        12u     ///< Écart au neutre maximal de la sortie pendant la limitation (% PWM).
+/** @} */
+
+/**
+ * @brief Anomalie d'adhérence de la roue motrice.
+ */
+typedef enum{
+    MOTOR_TRAC_OK = 0,             ///< Adhérence normale (ou anomalie levée).
+    MOTOR_TRAC_SLIP,               ///< Patinage : vitesse ou accélération mesurée hors de portée de la consigne.
+    MOTOR_TRAC_STALL               ///< Blocage : gaz appliqués, roue immobile.
+} Motor_Traction_t;
+
+/**
+ * @brief État du détecteur de patinage / blocage.
+ */
+typedef struct{
+    uint8_t  state;                ///< Anomalie confirmée (Motor_Traction_t).
+    uint8_t  cand;                 ///< Anomalie candidate de la dernière mesure.
+    uint8_t  count;                ///< Mesures consécutives de l'anomalie candidate.
+    uint8_t  clear;                ///< Mesures consécutives sans anomalie (levée).
+    int16_t  prev_mms;             ///< Mesure précédente (accélération).
+    uint16_t events;               ///< Anomalies confirmées depuis l'initialisation.
+} Motor_Traction_Det_t;
+
+/**
+ * @brief Conversions précalculées vitesse / pourcentage -> ticks CCR.
+ * @details Calculées à l'initialisation (et au changement de profil pour le frein) :
+ * la conversion d'une consigne ne coûte plus qu'une multiplication et un décalage,
+ * sans division logicielle, avec la pleine résolution du timer.
+ */
+typedef struct{
+    uint16_t neutral_ticks;        ///< CCR du point mort.
+    uint32_t fwd_slope_q16;        ///< Ticks par mm/s en marche avant (Q16).
+    uint32_t rev_slope_q16;        ///< Ticks par mm/s en marche arrière (Q16).
+    uint32_t ticks_per_pct_q16;    ///< Ticks par % PWM (Q16), correction de la boucle de vitesse.
+    uint16_t brake_fwd_ticks;      ///< CCR du frein depuis l'arrière (au-dessus du neutre).
+    uint16_t brake_rev_ticks;      ///< CCR du frein depuis l'avant et de l'amorce arrière (sous le neutre).
+    uint16_t supply_comp_q12;      ///< Facteur appliqué à l'écart au neutre (Q12, 4096 : aucun ; tension batterie).
+} Motor_Pwm_Map_t;
+
 /**
  * @brief Handle principal de l'objet Moteur.
  * @details Contient la configuration matérielle, les limites physiques et l'état courant.
@@ -46,6 +163,7 @@ typedef struct{
     uint32_t channel;              ///< Canal du Timer utilisé (ex: TIM_CHANNEL_1).
     uint16_t min_pulse_ticks;      ///< Valeur du registre CCR pour 0% de PWM.
     uint16_t max_pulse_ticks;      ///< Valeur du registre CCR pour 100% de PWM.
+    Motor_Output_t output;         ///< Protocole de sortie (MOTOR_OUT_PWM par défaut).
 
     int16_t  max_speed_pos_mms;    ///< Vitesse physique maximale en marche avant (mm/s).
     int16_t  max_speed_neg_mms;    ///< Vitesse physique maximale en marche arrière (mm/s, valeur négative).
@@ -53,6 +171,12 @@ typedef struct{
     MotorState_t    state;         ///< État actuel de la machine à états.
     bool            go_forward;    ///< Direction actuelle appliquée.
     Motor_Context_t ctx;           ///< Contexte de transition (cible).
+    uint16_t        pulse_ticks;   ///< Consigne CCR en attente d'application (motor_apply()).
+    Motor_Speed_Loop_t loop;       ///< Boucle de vitesse sur retour tachymètre.
+    Motor_Esc_Profile_t esc;       ///< Temporisations des séquences frein / neutre.
+    bool            pending;       ///< Consigne, gains ou profil modifiés depuis le dernier traitement.
+    Motor_Pwm_Map_t map;           ///< Conversions précalculées (motor_init()).
+    Motor_Traction_Det_t trac;     ///< Détection de patinage / blocage (motor_speed_feedback()).
 } Motor_Handle_t;
 
 /**
@@ -61,6 +185,13 @@ typedef struct{
  */
 void motor_init(Motor_Handle_t *hmotor);
 
+/**
+ * @brief  Applique directement une consigne CCR (Bypass FSM, pleine résolution).
+ * @param  hmotor Pointeur vers le handle moteur.
+ * @param  ticks  Consigne en ticks Timer (bornée à la plage min/max).
+ */
+void motor_pwm_ticks(Motor_Handle_t *hmotor, uint16_t ticks);
+
 /**
  * @brief  Applique directement un pourcentage de PWM (Bypass FSM).
  * @param  hmotor  Pointeur vers le handle moteur.
@@ -82,6 +213,63 @@ void motor_set_speed_mms(Motor_Handle_t *hmotor, int16_t speed_mms);
  */
 void motor_process_1ms(Motor_Handle_t *hmotor, uint32_t now_ms);
 
+/**
+ * @brief  Indique si motor_process_1ms() a du travail (événement ou échéance).
+ * @param  hmotor Pointeur vers le handle du moteur.
+ * @param  now_ms Timestamp actuel en ms.
+ * @return true si la machine à états doit être exécutée.
+ */
+bool motor_needs_process(const Motor_Handle_t *hmotor, uint32_t now_ms);
+
+/**
+ * @brief  Prochaine échéance de la machine à états.
+ * @param  hmotor      Pointeur vers le handle du moteur.
+ * @param  deadline_ms Échéance (ms), renseignée si l'état courant est temporisé.
+ * @return true si une échéance est armée, false si l'état n'évolue que sur événement.
+ */
+bool motor_next_deadline(const Motor_Handle_t *hmotor, uint32_t *deadline_ms);
+
+/**
+ * @brief  Applique la consigne PWM en attente au registre de comparaison.
+ * @note   Aucune écriture si la valeur est inchangée ; prise en compte à
+ * l'événement d'update suivant (préchargement CCR).
+ * @param  hmotor Pointeur vers le handle du moteur.
+ */
+void motor_apply(Motor_Handle_t *hmotor);
+
+/**
+ * @brief  Règle les gains de la boucle de vitesse (remet l'intégrale à zéro).
+ * @param  hmotor Pointeur vers le handle du moteur.
+ * @param  kp_q12 Gain proportionnel (Q12, % PWM par mm/s).
+ * @param  ki_q12 Gain intégral par échantillon (Q12).
+ * @param  kd_q12 Gain dérivé par échantillon (Q12).
+ */
+void motor_set_speed_gains(Motor_Handle_t *hmotor, int16_t kp_q12, int16_t ki_q12, int16_t kd_q12);
+
+/**
+ * @brief  Règle le profil de temporisation de l'ESC.
+ * @param  hmotor  Pointeur vers le handle du moteur.
+ * @param  profile Profil à appliquer (copié).
+ */
+void motor_set_esc_profile(Motor_Handle_t *hmotor, const Motor_Esc_Profile_t *profile);
+
+/**
+ * @brief  Exécute un pas de la boucle de vitesse sur une nouvelle mesure.
+ * @details Évalue aussi la détection de patinage / blocage (MOTOR_TRAC_ENABLE) :
+ * événement DLOG_TRACTION à la confirmation et à la levée, gaz limités à
+ * MOTOR_TRAC_LIMIT_PCT entre les deux (MOTOR_TRAC_LIMIT).
+ * @param  hmotor      Pointeur vers le handle du moteur.
+ * @param  speed_mms   Vitesse estimée (mm/s, signée : positive en marche avant).
+ */
+void motor_speed_feedback(Motor_Handle_t *hmotor, int16_t speed_mms);
+
+/**
+ * @brief  Règle la compensation de tension d'alimentation de la carte vitesse -> PWM.
+ * @param  hmotor   Pointeur vers le handle du moteur.
+ * @param  comp_q12 Facteur appliqué à l'écart au neutre (Q12, 4096 : aucun).
+ */
+void motor_set_supply_comp(Motor_Handle_t *hmotor, uint16_t comp_q12);
+
 /**
  * @brief  Configuration globale de l'application (Callback ou Init).
  */
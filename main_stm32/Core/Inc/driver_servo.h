@@ -2,13 +2,20 @@
  * @file    driver_servo.h
  * @brief   Fichier d'en-tête pour le pilote du servomoteur.
  * @details Définit la structure de configuration (Handle) et les prototypes
- * des fonctions de pilotage (Angle, Pourcentage, Valeur absolue).
+ * des fonctions de pilotage (Angle, Ticks, Pourcentage, Valeur absolue).
  */
 
 #ifndef INC_DRIVER_SERVO_H_
 #define INC_DRIVER_SERVO_H_
 
 #include "tim.h"
+#include "vehicle_profile.h"
+#include <stdbool.h>
+
+/** @brief Angle minimum autorisé en centi-degrés (Borne mécanique logicielle, profil véhicule). */
+#define SERVO_CLAMP_MIN_CDEG  (-(VEH_SERVO_CLAMP_CDEG))
+/** @brief Angle maximum autorisé en centi-degrés (Borne mécanique logicielle, profil véhicule). */
+#define SERVO_CLAMP_MAX_CDEG  (VEH_SERVO_CLAMP_CDEG)
 
 /**
  * @brief Structure de configuration et de gestion du Servo.
@@ -18,8 +25,15 @@
 typedef struct {
     TIM_HandleTypeDef *htim;   ///< Pointeur vers le handle du Timer (HAL).
     uint32_t channel;          ///< Canal du Timer (ex: TIM_CHANNEL_1).
-    uint16_t min_pulse_ticks;  ///< Valeur registre CCR pour la position min (ex: 3200).
-    uint16_t max_pulse_ticks;  ///< Valeur registre CCR pour la position max (ex: 6400).
+    uint16_t min_pulse_ticks;  ///< Valeur registre CCR pour la position min (ACT_PULSE_MIN_TICKS : 1 ms).
+    uint16_t max_pulse_ticks;  ///< Valeur registre CCR pour la position max (ACT_PULSE_MAX_TICKS : 2 ms).
+    uint16_t pulse_ticks;      ///< Consigne CCR en attente d'application (servo_apply()).
+
+    uint16_t center_ticks;     ///< CCR à 0° (trim inclus), précalculé à l'initialisation.
+    uint32_t ticks_per_cdeg_q16; ///< Ticks par centi-degré (Q16), précalculé à l'initialisation.
+    uint16_t target_ticks;     ///< Consigne CCR visée (atteinte en rampe si la limitation est active).
+    uint32_t pos_q16;          ///< Position courante de la rampe (ticks, Q16).
+    uint32_t slew_q16;         ///< Pas maximal par tick de 1 ms (ticks, Q16), 0 = sans limitation.
 } Servo_Handle_t;
 
 /**
@@ -28,6 +42,13 @@ typedef struct {
  */
 void servo_initialisation(Servo_Handle_t *hservo);
 
+/**
+ * @brief  Commande le servo par une consigne CCR directe (sans rampe).
+ * @param  hservo Pointeur vers le handle du servo.
+ * @param  ticks  Consigne en ticks Timer (bornée à la plage min/max).
+ */
+void servo_pwm_ticks(Servo_Handle_t *hservo, uint16_t ticks);
+
 /**
  * @brief  Commande le servo en pourcentage (0-100%).
  * @param  hservo  Pointeur vers le handle du servo.
@@ -42,6 +63,27 @@ void servo_pwm_percent(Servo_Handle_t *hservo, uint8_t percent);
  */
 void servo_pwm_angle_degree(Servo_Handle_t *hservo, int8_t angle);
 
+/**
+ * @brief  Commande le servo en centi-degrés (bornée à SERVO_CLAMP_*_CDEG).
+ * @param  hservo Pointeur vers le handle du servo.
+ * @param  cdeg   Angle cible en centi-degrés.
+ */
+void servo_set_centideg(Servo_Handle_t *hservo, int16_t cdeg);
+
+/**
+ * @brief  Règle la limitation de vitesse de braquage.
+ * @param  hservo Pointeur vers le handle du servo.
+ * @param  dps    Vitesse maximale (degrés par seconde), 0 = sans limitation.
+ */
+void servo_set_slew_dps(Servo_Handle_t *hservo, uint16_t dps);
+
+/**
+ * @brief  Fait avancer la rampe de braquage d'un pas (tick de 1 ms).
+ * @param  hservo Pointeur vers le handle du servo.
+ * @return true si la consigne visée n'est pas encore atteinte.
+ */
+bool servo_slew_tick(Servo_Handle_t *hservo);
+
 /**
  * @brief  Commande le servo via une valeur absolue (Haute résolution).
  * @param  hservo    Pointeur vers le handle du servo.
@@ -49,6 +91,14 @@ void servo_pwm_angle_degree(Servo_Handle_t *hservo, int8_t angle);
  */
 void servo_pwm_angle_abs_value(Servo_Handle_t *hservo, uint16_t abs_value);
 
+/**
+ * @brief  Applique la consigne en attente au registre de comparaison.
+ * @note   Aucune écriture si la valeur est inchangée ; prise en compte à
+ * l'événement d'update suivant (préchargement CCR).
+ * @param  hservo Pointeur vers le handle du servo.
+ */
+void servo_apply(Servo_Handle_t *hservo);
+
 /**
  * @brief  Configure l'application de test (Fonction Debug).
  */
@@ -10,33 +10,55 @@
 #define DRIVER_SPEEDOMETER_H
 
 #include "main.h"
+#include "seqlock.h"
+#include "vehicle_profile.h"
 #include <math.h>
 
-/** @brief Diamètre de la roue du véhicule en millimètres. */
-#define WHEEL_DIAMETER_MM	68.0f
+/**
+ * @brief Distance parcourue par tick capteur (µm), arrondie.
+ * @details Déduite du diamètre de roue et de l'étalonnage du profil véhicule
+ * (VEH_UM_PER_TICK) : tous les calculs de vitesse sont entiers (pas de FPU sur le
+ * Cortex-M0+).
+ */
+#define SPEEDO_UM_PER_TICK      VEH_UM_PER_TICK
 
-/** @brief Nombre de tours de roue effectués lors de la calibration. */
-#define NB_TOURS_TEST		10.0f
+/**
+ * @brief Mesure par datation des fronts (1) ou par comptage sur la période d'appel (0).
+ * @details Mode 1 : chaque front du capteur est daté en µs (interruption trigger de TIM4).
+ * La vitesse est la distance des n derniers fronts divisée par leur durée exacte :
+ * n = 1 à basse vitesse (mesure de période), jusqu'à SPEEDO_EDGE_HIST - 1 fronts
+ * compris dans SPEEDO_WINDOW_US à haute vitesse (équivalent d'un comptage).
+ */
+#ifndef SPEEDO_EDGE_TIMING
+#define SPEEDO_EDGE_TIMING      1
+#endif
 
-/** @brief Nombre de ticks capteur relevés pour le nombre de tours de test. */
-#define VALEUR_COMPTEUR_LUE	52.0f
+/** @brief Profondeur de l'historique des dates de fronts (puissance de 2). */
+#define SPEEDO_EDGE_HIST        8u
 
-/** @brief Nombre de ticks capteur correspondant à un tour complet de roue. */
-#define TICKS_PER_WHEEL_TURN	(VALEUR_COMPTEUR_LUE / NB_TOURS_TEST)
+/** @brief Fenêtre de moyennage des fronts à haute vitesse (µs). */
+#define SPEEDO_WINDOW_US        100000u
 
-/** @brief Périmètre de la roue en mètres (Distance pour un tour). */
-#define PERIMETER_M             ((WHEEL_DIAMETER_MM * 3.14159f) / 1000.0f)
+/** @brief Vitesse considérée nulle sans front depuis ce délai (µs). */
+#define SPEEDO_STOP_TIMEOUT_US  500000u
 
 /**
  * @brief Structure de gestion du tachymètre.
  * @details Stocke l'état précédent du compteur et du temps pour calculer
- * la vitesse différentielle.
+ * la vitesse différentielle. Le compteur matériel 16 bits de TIM4 est étendu à
+ * 32 bits par son interruption de débordement (vecteur partagé avec TIM3).
  */
 typedef struct{
     TIM_HandleTypeDef *htim;        ///< Pointeur vers le Timer utilisé en mode compteur.
-    uint16_t last_counter_val;      ///< Valeur du compteur lors de la dernière lecture.
+    volatile uint32_t overflow_cnt; ///< Débordements du compteur 16 bits (bits 16 à 31 du cumul, interruption).
+    uint32_t last_counter_val;      ///< Cumul de fronts lors de la dernière lecture.
     uint32_t last_process_time;     ///< Timestamp (ms) de la dernière lecture.
-    float current_speed_ms;         ///< Vitesse actuelle calculée en m/s.
+    int32_t current_speed_mms;      ///< Vitesse actuelle calculée en mm/s.
+#if SPEEDO_EDGE_TIMING
+    volatile uint64_t edge_us[SPEEDO_EDGE_HIST];   ///< Dates des derniers fronts (µs, interruption).
+    volatile uint32_t edge_count;                  ///< Nombre de fronts datés depuis l'initialisation.
+    seqlock_t edge_lock;                           ///< Verrou de séquence de edge_us / edge_count.
+#endif
 } Speedometer_Handle_t;
 
 /**
@@ -53,4 +75,21 @@ void speedometer_init(Speedometer_Handle_t *hSpeedo, TIM_HandleTypeDef *htim);
  */
 float speedometer_solve_speed(Speedometer_Handle_t *hSpeedo);
 
+/**
+ * @brief  Calcule la vitesse actuelle en mm/s, en arithmétique entière.
+ * @param  hSpeedo Pointeur vers la structure du tachymètre.
+ * @return Vitesse en mm/s.
+ */
+int32_t speedometer_solve_speed_mms(Speedometer_Handle_t *hSpeedo);
+
+/**
+ * @brief  Nombre de fronts du capteur depuis l'initialisation.
+ * @details Compteur matériel étendu à 32 bits : utilisable à toute cadence et dans tout
+ * contexte (sans effet sur la mesure de vitesse), la différence de deux lectures reste
+ * juste tant qu'elles sont séparées de moins de 2^32 fronts (~176 000 km).
+ * @param  hSpeedo Pointeur vers la structure du tachymètre.
+ * @return Compteur de fronts (modulo 2^32).
+ */
+uint32_t speedometer_ticks(const Speedometer_Handle_t *hSpeedo);
+
 #endif
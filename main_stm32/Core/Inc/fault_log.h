@@ -0,0 +1,137 @@
+/**
+ * @file    fault_log.h
+ * @brief   Relevé de faute persistant en RAM .noinit (HardFault, chien de garde).
+ * @details Le relevé survit au reset à chaud qui suit la faute et part sur la liaison
+ * après le redémarrage (trame type 0x11, une fois la télémétrie établie), sans débogueur.
+ *
+ * - HardFault : HardFault_Handler (défini ici, génération CubeMX désactivée dans le .ioc)
+ *   relève les registres empilés (r0-r3, r12, lr, pc, xpsr) et le pointeur de pile,
+ *   puis redémarre (FAULT_LOG_RESET).
+ * - Chien de garde : aucun code ne s'exécute au reset IWDG ; le relevé est reconstitué
+ *   au démarrage suivant à partir des traces tenues en continu dans .noinit : tâche de
+ *   l'ordonnanceur en cours, passages de boucle principale, et compteurs de liaison
+ *   recopiés à chaque rafraîchissement du chien de garde.
+ *
+ * REG_FAULT (alias en écriture de REG_STAT_RESET_CAUSE) : FAULT_CMD_REPORT renvoie le
+ * relevé, FAULT_CMD_CLEAR l'efface. REG_STAT_RESET_CAUSE lit la cause du démarrage
+ * courant (fault_cause_t).
+ */
+
+#ifndef INC_FAULT_LOG_H_
+#define INC_FAULT_LOG_H_
+
+#include <stdint.h>
+#include "watchdog.h"
+
+/** @brief Relevé de faute actif (1) ou HardFault_Handler en boucle infinie (0). */
+#ifndef FAULT_LOG_ENABLE
+#define FAULT_LOG_ENABLE        1
+#endif
+
+/**
+ * @brief Après relevé d'un HardFault : redémarrage (1) ou boucle infinie pour le
+ * débogueur (0, le chien de garde finit par redémarrer).
+ */
+#ifndef FAULT_LOG_RESET
+#define FAULT_LOG_RESET         1
+#endif
+
+/** @brief Tâche en cours hors ordonnanceur (boucle principale, interruption). */
+#define FAULT_TASK_NONE         0xFFu
+
+/**
+ * @name Commandes de REG_FAULT
+ * @{
+ */
+#define FAULT_CMD_REPORT        1u      ///< Renvoie le relevé (trame type 0x11).
+#define FAULT_CMD_CLEAR         2u      ///< Efface le relevé.
+/** @} */
+
+/**
+ * @brief Cause d'un relevé (et du démarrage courant, REG_STAT_RESET_CAUSE).
+ */
+typedef enum {
+    FAULT_CAUSE_NONE = 0,       ///< Aucune faute.
+    FAULT_CAUSE_WATCHDOG,       ///< Reset du chien de garde (IWDG).
+    FAULT_CAUSE_HARDFAULT       ///< HardFault.
+} fault_cause_t;
+
+/**
+ * @brief Relevé de faute.
+ */
+typedef struct {
+    uint8_t  cause;             ///< fault_cause_t.
+    uint8_t  task;              ///< Tâche de l'ordonnanceur en cours (FAULT_TASK_NONE : hors tâche).
+    uint16_t count;             ///< Fautes relevées depuis la mise sous tension.
+    uint32_t uptime_ms;         ///< Date de la faute (ms depuis HAL_Init).
+    uint32_t loops;             ///< Passages de boucle principale depuis le démarrage.
+    uint32_t regs[8];           ///< r0, r1, r2, r3, r12, lr, pc, xpsr empilés (HardFault).
+    uint32_t sp;                ///< Pointeur de pile avant l'exception (HardFault).
+    uint32_t rx_drop;           ///< Octets RX perdus (dernier rafraîchissement du chien de garde).
+    uint32_t tx_drop;           ///< Trames TX refusées.
+    uint32_t rx_overrun;        ///< Overruns UART RX.
+    uint16_t telem_seq;         ///< Numéro de la dernière trame de télémétrie.
+} fault_record_t;
+
+/**
+ * @brief Traces tenues en continu pour un reset du chien de garde (.noinit).
+ */
+typedef struct {
+    uint32_t loops;             ///< Passages de boucle principale.
+    uint8_t  task;              ///< Tâche en cours.
+} fault_live_t;
+
+#if FAULT_LOG_ENABLE
+/** @brief Traces courantes (fault_log.c). */
+extern fault_live_t fault_live;
+
+/**
+ * @brief  Relève la cause du démarrage : HardFault relevé avant le reset, reset IWDG
+ * (reconstitué depuis les traces), ou relevé précédent conservé.
+ * @note   Avant watchdog_start(), qui efface les drapeaux de reset.
+ */
+void fault_log_init(void);
+
+/**
+ * @brief  Recopie les compteurs de liaison dans les traces (rafraîchissement du chien de garde).
+ */
+void fault_log_heartbeat(void);
+
+/**
+ * @brief  Émet le relevé du démarrage courant une fois (après la première trame de télémétrie).
+ */
+void fault_log_report_pending(void);
+
+/**
+ * @brief  Commande écrite dans REG_FAULT.
+ * @param  cmd FAULT_CMD_*.
+ */
+void fault_log_command(uint16_t cmd);
+
+/**
+ * @brief  Cause du démarrage courant.
+ * @return fault_cause_t.
+ */
+uint8_t fault_log_boot_cause(void);
+
+/**
+ * @brief  Note la tâche de l'ordonnanceur qui s'exécute.
+ * @param  id Index de la tâche, FAULT_TASK_NONE à la sortie.
+ */
+static inline void fault_log_task(uint8_t id){ fault_live.task = id; }
+
+/**
+ * @brief  Compte un passage de boucle principale.
+ */
+static inline void fault_log_loop(void){ fault_live.loops++; }
+#else
+static inline void fault_log_init(void){}
+static inline void fault_log_heartbeat(void){}
+static inline void fault_log_report_pending(void){}
+static inline void fault_log_command(uint16_t cmd){ (void)cmd; }
+static inline uint8_t fault_log_boot_cause(void){ return watchdog_caused_reset() ? FAULT_CAUSE_WATCHDOG : FAULT_CAUSE_NONE; }
+static inline void fault_log_task(uint8_t id){ (void)id; }
+static inline void fault_log_loop(void){}
+#endif
+
+#endif /* INC_FAULT_LOG_H_ */
@@ -0,0 +1,100 @@
+/**
+ * @file    fw_update.h
+ * @brief   Mise à jour du firmware par la liaison série, page par page (delta compressé).
+ * @details Remplace le flashage par ST-Link : l'hôte (fw_flash.py) compare le CRC-32 de
+ * chaque page de l'application à sa nouvelle image et n'envoie que les pages modifiées.
+ * Chaque page part compressée, éventuellement en delta de la page en place. L'application
+ * occupe la banque 1 ; les pages reçues sont préparées dans la banque 2 (zone
+ * _sfwstage.._efwstage des scripts de liens), vérifiées par CRC, puis recopiées en une
+ * fois à la validation par une routine exécutée depuis la RAM, suivie d'un reset.
+ * Seules les pages modifiées sont effacées.
+ *
+ * Protocole, sur REG_FW_UPDATE (écriture : opcode << 12 | argument, cf. FW_OP_*) ;
+ * chaque commande est acquittée par une trame type 0x10 (SerialFwFrame_t) :
+ * - FW_OP_BEGIN : ouvre une session (véhicule à l'arrêt), oublie les pages préparées ;
+ *   l'acquittement porte le nombre de pages de l'application (arg) ;
+ * - FW_OP_QUERY page : CRC-32 de la page en place (crc) ;
+ * - FW_OP_PAGE page : annonce une page ; suivent des trames groupées adressées à
+ *   REG_FW_UPDATE portant le flux de la page (FW_STREAM_HDR_LEN octets d'en-tête :
+ *   drapeaux FW_PAGE_F_*, réservé, CRC-32 de la page finale ; puis PackBits). Page
+ *   complète : préparée en flash puis acquittée (status, crc) ;
+ * - FW_OP_COMMIT n : recopie les n pages préparées puis redémarre ;
+ * - FW_OP_ABORT : ferme la session sans rien recopier.
+ *
+ * PackBits : octet de contrôle c < 0x80 -> c + 1 octets littéraux suivent ; c >= 0x80
+ * -> octet suivant répété (c & 0x7F) + FW_RUN_MIN fois. CRC-32 IEEE (zlib.crc32),
+ * calculé par l'unité CRC matérielle.
+ *
+ * Une coupure d'alimentation pendant la recopie (quelques dizaines de ms par page)
+ * laisse une image incomplète : reprise par le bootloader système (BOOT0) ou le ST-Link.
+ */
+
+#ifndef INC_FW_UPDATE_H_
+#define INC_FW_UPDATE_H_
+
+#include <stdint.h>
+
+/** @brief Mise à jour par la liaison disponible (1) ou absente du build (0). */
+#ifndef FW_UPDATE_ENABLE
+#define FW_UPDATE_ENABLE        1
+#endif
+
+/**
+ * @name Opcodes de REG_FW_UPDATE (bits 12..15)
+ * @{
+ */
+#define FW_OP_ABORT             0u      ///< Ferme la session.
+#define FW_OP_BEGIN             1u      ///< Ouvre une session.
+#define FW_OP_QUERY             2u      ///< CRC-32 d'une page en place.
+#define FW_OP_PAGE              3u      ///< Annonce le flux d'une page.
+#define FW_OP_COMMIT            4u      ///< Recopie les pages préparées et redémarre.
+#define FW_OP_SHIFT             12u     ///< Position de l'opcode.
+#define FW_ARG_MASK             0x0FFFu ///< Argument (page, nombre de pages).
+/** @} */
+
+/**
+ * @name Statut de la trame d'acquittement
+ * @{
+ */
+#define FW_ST_OK                0u      ///< Commande exécutée (page préparée).
+#define FW_ST_BUSY              1u      ///< Véhicule en mouvement ou page précédente non terminée.
+#define FW_ST_STATE             2u      ///< Pas de session, ou commande hors séquence.
+#define FW_ST_RANGE             3u      ///< Page hors de l'application ou zone de préparation pleine.
+#define FW_ST_FORMAT            4u      ///< Flux de page mal formé (débordement de page).
+#define FW_ST_CRC               5u      ///< CRC-32 de la page décodée incorrect.
+#define FW_ST_FLASH             6u      ///< Échec d'effacement ou de programmation.
+/** @} */
+
+/** @brief Drapeau de page : octets décodés à combiner (XOR) avec la page en place. */
+#define FW_PAGE_F_XOR           0x01u
+/** @brief En-tête du flux d'une page : drapeaux, réservé, CRC-32 (little-endian). */
+#define FW_STREAM_HDR_LEN       6u
+/** @brief Plus courte répétition codée par PackBits. */
+#define FW_RUN_MIN              3u
+
+#if FW_UPDATE_ENABLE
+/**
+ * @brief  Commande écrite dans REG_FW_UPDATE (décodage), exécutée par fw_update_poll().
+ * @param  value opcode << FW_OP_SHIFT | argument.
+ */
+void fw_update_command(uint16_t value);
+
+/**
+ * @brief  Bloc du flux de la page annoncée (trame groupée adressée à REG_FW_UPDATE).
+ * @param  data  Octets reçus.
+ * @param  count Nombre de registres (2 octets chacun).
+ */
+void fw_update_data(const uint8_t *data, uint8_t count);
+
+/**
+ * @brief  Service de la boucle principale : commandes, préparation des pages, acquittements.
+ * @note   Bloque le temps d'effacer et programmer une page de la banque 2 (~45 ms).
+ */
+void fw_update_poll(void);
+#else
+static inline void fw_update_command(uint16_t value){ (void)value; }
+static inline void fw_update_data(const uint8_t *data, uint8_t count){ (void)data; (void)count; }
+static inline void fw_update_poll(void){}
+#endif
+
+#endif /* INC_FW_UPDATE_H_ */
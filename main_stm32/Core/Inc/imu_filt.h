@@ -0,0 +1,83 @@
+/**
+ * @file    imu_filt.h
+ * @brief   Filtre anti-repliement des échantillons IMU avant décimation de la télémétrie.
+ * @details Quand les acquisitions (REG_IMU_RATE, data-ready) sont plus rapides que la
+ * télémétrie, un échantillon sur D seulement est émis : sans filtrage, les vibrations
+ * au-delà de la demi-cadence de télémétrie se replient dans la bande transmise.
+ * Chaque échantillon retiré de la file du driver traverse donc une cascade de
+ * biquads passe-bas de Butterworth (entiers, coefficients Q30, états Q8) avant la
+ * décimation existante.
+ *
+ * La coupure est placée au quart de la cadence de sortie. D est déduit de la période
+ * d'acquisition mesurée sur les dates des échantillons et de la période d'émission
+ * fixée par l'application (cadence et régulation de débit) ; les coefficients sont
+ * précalculés pour D = 2..IMU_FILT_DECIM_MAX. Sans décimation (D < 2), l'échantillon
+ * passe inchangé.
+ *
+ * Seuls les échantillons retournés à la télémétrie sont filtrés : estimateurs embarqués,
+ * historique et calibration reçoivent la pleine bande.
+ */
+
+#ifndef INC_IMU_FILT_H_
+#define INC_IMU_FILT_H_
+
+#include <stdint.h>
+#include "driver_ins.h"
+
+/** @brief Filtre actif (1) ou absent (0). */
+#ifndef IMU_FILT_ENABLE
+#define IMU_FILT_ENABLE         1
+#endif
+
+/** @brief Nombre maximal de biquads en cascade (ordre 4). */
+#define IMU_FILT_SECTIONS_MAX   2u
+/** @brief Rapport de décimation maximal couvert par les coefficients (au-delà : coupure de ce rapport). */
+#define IMU_FILT_DECIM_MAX      32u
+/** @brief Écart entre échantillons au-delà duquel la période d'acquisition n'est pas mise à jour (µs). */
+#define IMU_FILT_GAP_US         100000u
+
+/**
+ * @brief Ordre du filtre (REG_IMU_FILT).
+ */
+typedef enum {
+    IMU_FILT_OFF    = 0,    ///< Décimation seule (échantillonnage ponctuel).
+    IMU_FILT_ORDER2 = 1,    ///< Un biquad (Butterworth ordre 2, -40 dB/décade).
+    IMU_FILT_ORDER4 = 2     ///< Deux biquads (Butterworth ordre 4, -80 dB/décade).
+} imu_filt_order_t;
+
+#if IMU_FILT_ENABLE
+
+/**
+ * @brief  Règle l'ordre du filtre (repart de l'échantillon suivant, sans transitoire).
+ * @param  order Ordre (imu_filt_order_t), borné à IMU_FILT_ORDER4.
+ */
+void imu_filt_configure(uint8_t order);
+
+/**
+ * @brief  Fixe la période d'émission de la télémétrie (boucle principale).
+ * @param  period_us Période entre deux échantillons émis (µs).
+ */
+void imu_filt_set_output_us(uint32_t period_us);
+
+/**
+ * @brief  Filtre un échantillon (filtre du driver, boucle principale).
+ * @param  raw          Échantillon brut, remplacé par sa valeur filtrée.
+ * @param  timestamp_us Date de l'acquisition (µs).
+ */
+void imu_filt_apply(bmi088_raw_t *raw, uint64_t timestamp_us);
+
+/**
+ * @brief  Rapport de décimation appliqué.
+ * @return D, 0 si le filtre est inactif (désactivé ou sans décimation).
+ */
+uint8_t imu_filt_decim(void);
+
+#else
+
+static inline void imu_filt_configure(uint8_t order){ (void)order; }
+static inline void imu_filt_set_output_us(uint32_t period_us){ (void)period_us; }
+static inline uint8_t imu_filt_decim(void){ return 0; }
+
+#endif /* IMU_FILT_ENABLE */
+
+#endif /* INC_IMU_FILT_H_ */
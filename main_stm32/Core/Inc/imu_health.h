@@ -0,0 +1,114 @@
+/**
+ * @file    imu_health.h
+ * @brief   Surveillance de la santé de l'IMU : capteur figé, saturation, erreurs de bus, silence.
+ * @details Chaque échantillon retiré de la file du driver (observateur brut, boucle
+ * principale) est contrôlé en quelques comparaisons :
+ * - valeur figée : les trois axes d'un capteur identiques au bit près sur
+ *   IMU_HEALTH_STUCK_SAMPLES échantillons consécutifs (le bruit d'un capteur vivant
+ *   change toujours au moins un LSB) ;
+ * - saturation : échantillons d'une fenêtre de IMU_HEALTH_WINDOW dont un axe atteint
+ *   IMU_HEALTH_SAT_LSB en valeur absolue.
+ *
+ * La tâche IMU (imu_health_check(), bus opérationnel) ajoute le taux d'erreurs SPI par
+ * fenêtre (transferts DMA et BMI088_Read_All()) et le silence du capteur (aucun
+ * échantillon pendant IMU_HEALTH_SILENCE_PERIODS périodes d'acquisition), puis agit avant
+ * que des données fausses ne gâchent un essai :
+ * - saturation : gamme du capteur élargie d'un cran (IMU_HEALTH_AUTO_RANGE), jusqu'à
+ *   ±24 g / ±2000 °/s ; le retour à une gamme plus fine reste une décision de l'hôte ;
+ * - valeur figée, silence, erreurs de bus : séquence de récupération du driver
+ *   (BMI088_Recover(), IMU_HEALTH_AUTO_RECOVER).
+ * Chaque détection est journalisée (DLOG_IMU_HEALTH : cause, mesure, action).
+ */
+
+#ifndef INC_IMU_HEALTH_H_
+#define INC_IMU_HEALTH_H_
+
+#include <stdint.h>
+#include "driver_ins.h"
+
+/** @brief Surveillance active (1) ou absente (0). */
+#ifndef IMU_HEALTH_ENABLE
+#define IMU_HEALTH_ENABLE           1
+#endif
+
+/** @brief Élargissement automatique de la gamme sur saturation (1) ou simple signalement (0). */
+#ifndef IMU_HEALTH_AUTO_RANGE
+#define IMU_HEALTH_AUTO_RANGE       1
+#endif
+
+/** @brief Récupération automatique sur capteur figé, muet ou bus en erreur (1) ou signalement (0). */
+#ifndef IMU_HEALTH_AUTO_RECOVER
+#define IMU_HEALTH_AUTO_RECOVER     1
+#endif
+
+/** @brief Échantillons consécutifs identiques signalant un capteur figé. */
+#define IMU_HEALTH_STUCK_SAMPLES    64u
+/** @brief Valeur brute absolue considérée saturée (LSB, pleine échelle 32767). */
+#define IMU_HEALTH_SAT_LSB          32000
+/** @brief Échantillons par fenêtre de comptage (saturation, erreurs de bus). */
+#define IMU_HEALTH_WINDOW           256u
+/** @brief Échantillons saturés par fenêtre déclenchant l'élargissement de la gamme. */
+#define IMU_HEALTH_SAT_MAX          8u
+/** @brief Erreurs SPI par fenêtre déclenchant la récupération. */
+#define IMU_HEALTH_ERR_MAX          4u
+/** @brief Périodes d'acquisition sans échantillon signalant un capteur muet. */
+#define IMU_HEALTH_SILENCE_PERIODS  8u
+/** @brief Silence minimal signalé (µs), quelle que soit la cadence. */
+#define IMU_HEALTH_SILENCE_MIN_US   50000u
+
+/**
+ * @brief Cause d'une détection (premier argument de DLOG_IMU_HEALTH).
+ */
+typedef enum {
+    IMU_HEALTH_ACC_STUCK = 1,   ///< Accéléromètre figé : (échantillons identiques).
+    IMU_HEALTH_GYR_STUCK,       ///< Gyroscope figé : (échantillons identiques).
+    IMU_HEALTH_ACC_SAT,         ///< Accéléromètre saturé : (échantillons saturés dans la fenêtre).
+    IMU_HEALTH_GYR_SAT,         ///< Gyroscope saturé : (échantillons saturés dans la fenêtre).
+    IMU_HEALTH_BUS_ERRORS,      ///< Erreurs SPI : (erreurs dans la fenêtre).
+    IMU_HEALTH_SILENT           ///< Capteur muet : (ms sans échantillon).
+} imu_health_cause_t;
+
+/**
+ * @brief Action entreprise (troisième argument de DLOG_IMU_HEALTH).
+ */
+typedef enum {
+    IMU_HEALTH_ACT_NONE = 0,    ///< Signalement seul (action désactivée, gamme déjà maximale, bus occupé).
+    IMU_HEALTH_ACT_RANGE,       ///< Gamme élargie d'un cran.
+    IMU_HEALTH_ACT_RECOVER      ///< Séquence de récupération armée.
+} imu_health_action_t;
+
+#if IMU_HEALTH_ENABLE
+/**
+ * @brief  Remet la surveillance à zéro.
+ */
+void imu_health_init(void);
+
+/**
+ * @brief  Contrôle un échantillon retiré de la file (observateur brut).
+ * @param  raw Échantillon brut (LSB).
+ */
+void imu_health_record(const bmi088_raw_t *raw);
+
+/**
+ * @brief  Évalue les détections en attente et agit (tâche IMU, bus opérationnel).
+ * @param  now_us    Date courante (µs).
+ * @param  period_us Période d'acquisition attendue (µs) ; 0 si aucun échantillon n'est
+ * attendu (rejeu, auto-test) : la surveillance est réarmée sans rien signaler.
+ * @return Dernière action entreprise (imu_health_action_t) : IMU_HEALTH_ACT_RANGE
+ * demande de recalculer les seuils exprimés en LSB.
+ */
+uint8_t imu_health_check(uint64_t now_us, uint32_t period_us);
+
+/**
+ * @brief  Détections depuis le démarrage.
+ * @return Nombre de détections journalisées.
+ */
+uint32_t imu_health_events(void);
+#else
+static inline void imu_health_init(void){}
+static inline void imu_health_record(const bmi088_raw_t *raw){ (void)raw; }
+static inline uint8_t imu_health_check(uint64_t now_us, uint32_t period_us){ (void)now_us; (void)period_us; return IMU_HEALTH_ACT_NONE; }
+static inline uint32_t imu_health_events(void){ return 0u; }
+#endif
+
+#endif /* INC_IMU_HEALTH_H_ */
@@ -0,0 +1,173 @@
+/**
+ * @file    imu_hist.h
+ * @brief   Historique circulaire des échantillons IMU bruts, figé sur événement.
+ * @details Chaque échantillon retiré de la file du driver (donc à la cadence
+ * d'acquisition REG_IMU_RATE, indépendamment de la télémétrie) est recopié en RAM,
+ * brut (6 x int16) et daté. Un déclenchement (failsafe, seuil d'accélération,
+ * commande hôte) laisse passer encore REG_HIST_POST échantillons puis fige
+ * l'historique : l'hôte le télécharge ensuite par blocs à la demande
+ * (REG_HIST_CHUNK), sans coût pour le lien en exploitation normale.
+ *
+ * Trame type 0x09 : [AA 55 09 LEN | INDEX u16 | TOTAL u16 | TRIG u16 | RANGES u8 | COUNT u8 |
+ *                    { T_US u32 | AX AY AZ GX GY GZ i16 } x COUNT | CRC]
+ * INDEX : numéro du bloc ; TOTAL : échantillons figés (0 : historique non figé) ;
+ * TRIG : rang de l'échantillon de déclenchement ; échantillons du plus ancien au
+ * plus récent, T_US sur 32 bits (GetMicros64 tronqué).
+ *
+ * Trame type 0x0D (IMU_HIST_PACK, demandée avec IMU_HIST_CHUNK_PACKED) :
+ * [AA 55 0D LEN | FIRST u16 | TOTAL u16 | TRIG u16 | RANGES u8 | COUNT u8 | K u8 x 7 |
+ *  T_US u32 | AX AY AZ GX GY GZ i16 | flux Rice | CRC]
+ * FIRST : rang du premier échantillon ; le premier échantillon est en clair, les
+ * COUNT - 1 suivants en résidus codés Rice (rice.h), échantillon par échantillon :
+ * date en différence seconde (écart à l'intervalle précédent, 0 avant le premier),
+ * puis les six axes en différence simple ; K : paramètre de chaque canal (date, axes).
+ * La trame prend autant d'échantillons que le flux en loge (au plus
+ * IMU_HIST_PACK_MAX) : l'hôte demande la suite à partir de FIRST + COUNT.
+ */
+
+#ifndef INC_IMU_HIST_H_
+#define INC_IMU_HIST_H_
+
+#include <stdint.h>
+#include "proto_def.h"
+#include "driver_ins.h"
+
+/** @brief Historique actif (1) ou absent (0, aucune RAM réservée). */
+#ifndef IMU_HIST_ENABLE
+#define IMU_HIST_ENABLE         1
+#endif
+
+/**
+ * @brief Capacité de l'historique (échantillons, puissance de 2).
+ * @details 16 octets par échantillon : 4096 échantillons = 64 Ko sur les 144 Ko de
+ * SRAM, soit 4 s à 1 kHz ou 41 s à 100 Hz.
+ */
+#ifndef IMU_HIST_LEN
+#define IMU_HIST_LEN            4096u
+#endif
+/** @brief Échantillons par bloc téléchargé (trame de 205 octets). */
+#define IMU_HIST_CHUNK          12u
+/** @brief Échantillons enregistrés après le déclenchement, par défaut. */
+#define IMU_HIST_POST_DEFAULT   (IMU_HIST_LEN / 4u)
+/** @brief Type de trame d'un bloc d'historique. */
+#define IMU_HIST_FRAME_TYPE     TELEM_TYPE_HIST
+
+/**
+ * @brief Téléchargement compressé (1) : REG_HIST_CHUNK avec IMU_HIST_CHUNK_PACKED rend une
+ * trame type 0x0D (environ 5 octets par échantillon au lieu de 16 à bruit IMU courant).
+ */
+#ifndef IMU_HIST_PACK
+#define IMU_HIST_PACK           1
+#endif
+/** @brief Bit de REG_HIST_CHUNK : bits 0..14 = rang du premier échantillon, trame compressée. */
+#define IMU_HIST_CHUNK_PACKED   0x8000u
+/** @brief Échantillons au plus par trame compressée (fenêtre de choix des paramètres k). */
+#define IMU_HIST_PACK_MAX       64u
+/** @brief Type de trame d'un bloc compressé. */
+#define IMU_HIST_PACK_TYPE      TELEM_TYPE_HIST_PACKED
+
+/**
+ * @brief Commandes écrites dans REG_HIST_CMD.
+ */
+typedef enum {
+    IMU_HIST_CMD_TRIGGER = 1,   ///< Déclenchement manuel.
+    IMU_HIST_CMD_REARM   = 2    ///< Efface l'historique et reprend l'enregistrement.
+} imu_hist_cmd_t;
+
+/**
+ * @brief État de l'historique (bits 0..3 de REG_HIST_CMD en lecture).
+ */
+typedef enum {
+    IMU_HIST_RECORDING = 0,     ///< Enregistrement continu, en attente de déclenchement.
+    IMU_HIST_POST_TRIGGER,      ///< Déclenché : enregistrement des échantillons postérieurs.
+    IMU_HIST_FROZEN             ///< Figé : téléchargement possible, enregistrement suspendu.
+} imu_hist_state_t;
+
+/**
+ * @brief Source du déclenchement (bits 4..7 de REG_HIST_CMD en lecture).
+ */
+typedef enum {
+    IMU_HIST_TRIG_NONE = 0,     ///< Pas encore déclenché.
+    IMU_HIST_TRIG_HOST,         ///< Commande hôte (IMU_HIST_CMD_TRIGGER).
+    IMU_HIST_TRIG_FAILSAFE,     ///< Sortie de FAILSAFE_OK.
+    IMU_HIST_TRIG_THRESHOLD     ///< Accélération au-delà de REG_HIST_THR_MG sur un axe.
+} imu_hist_trig_t;
+
+#if IMU_HIST_ENABLE
+
+/**
+ * @brief  Règle le déclenchement sur seuil et la profondeur post-déclenchement.
+ * @param  thr_mg Seuil d'accélération par axe (mg), 0 : déclenchement sur seuil inactif.
+ * @param  post   Échantillons enregistrés après le déclenchement (borné à IMU_HIST_LEN - 1).
+ * @param  ranges Gammes IMU courantes (IMU_CFG_PACK, bits 0-1 accéléromètre).
+ */
+void imu_hist_configure(uint16_t thr_mg, uint16_t post, uint8_t ranges);
+
+/**
+ * @brief  Enregistre un échantillon (observateur brut du driver, boucle principale).
+ * @param  raw          Échantillon brut.
+ * @param  timestamp_us Date de l'acquisition (µs).
+ */
+void imu_hist_record(const bmi088_raw_t *raw, uint64_t timestamp_us);
+
+/**
+ * @brief  Déclenche la capture ; sans effet si elle l'est déjà.
+ * @param  source Source du déclenchement (imu_hist_trig_t).
+ */
+void imu_hist_trigger(uint8_t source);
+
+/**
+ * @brief  Exécute une commande de REG_HIST_CMD.
+ * @param  cmd Commande (imu_hist_cmd_t), valeurs inconnues ignorées.
+ */
+void imu_hist_command(uint8_t cmd);
+
+/**
+ * @brief  État et source du déclenchement.
+ * @return imu_hist_state_t | (imu_hist_trig_t << 4).
+ */
+uint8_t imu_hist_status(void);
+
+/**
+ * @brief  Nombre d'échantillons enregistrés.
+ * @return Échantillons disponibles (au plus IMU_HIST_LEN).
+ */
+uint16_t imu_hist_count(void);
+
+/**
+ * @brief  Rang de l'échantillon de déclenchement dans l'historique figé.
+ * @return Rang depuis le plus ancien échantillon, 0 si non déclenché.
+ */
+uint16_t imu_hist_trigger_index(void);
+
+/**
+ * @brief  Émet un bloc de l'historique figé (trame type 0x09, ring prioritaire).
+ * @details Un bloc au-delà de la fin ou un historique non figé sont signalés par une
+ * trame sans échantillon.
+ * @param  index Numéro du bloc (IMU_HIST_CHUNK échantillons par bloc).
+ * @return Octets mis en file ou -EWOULDBLOCK (l'hôte redemande le bloc).
+ */
+int imu_hist_send_chunk(uint16_t index);
+
+/**
+ * @brief  Émet des échantillons de l'historique figé sous forme compressée (trame type 0x0D).
+ * @details Sans IMU_HIST_PACK, émet le bloc brut qui contient `first`.
+ * @param  first Rang du premier échantillon.
+ * @return Octets mis en file ou -EWOULDBLOCK (l'hôte redemande).
+ */
+int imu_hist_send_packed(uint16_t first);
+
+#else
+
+static inline void imu_hist_configure(uint16_t thr_mg, uint16_t post, uint8_t ranges){ (void)thr_mg; (void)post; (void)ranges; }
+static inline void imu_hist_trigger(uint8_t source){ (void)source; }
+static inline void imu_hist_command(uint8_t cmd){ (void)cmd; }
+static inline uint8_t imu_hist_status(void){ return 0; }
+static inline uint16_t imu_hist_count(void){ return 0; }
+static inline uint16_t imu_hist_trigger_index(void){ return 0; }
+static inline int imu_hist_send_chunk(uint16_t index){ (void)index; return 0; }
+static inline int imu_hist_send_packed(uint16_t first){ (void)first; return 0; }
+
+#endif /* IMU_HIST_ENABLE */
+
+#endif /* INC_IMU_HIST_H_ */
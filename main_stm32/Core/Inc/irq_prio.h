@@ -0,0 +1,55 @@
+/**
+ * @file    irq_prio.h
+ * @brief   Carte des priorités NVIC de l'application.
+ * @details Le Cortex-M0+ n'offre que 4 niveaux (0 = le plus prioritaire). CubeMX
+ * place toutes les interruptions au niveau 0 ; irq_prio_apply() réécrit la carte
+ * ci-dessous après les MX_xxx_Init(), sans toucher au code généré.
+ *
+ * | Niveau | Sources                                  | Budget d'exécution visé |
+ * |--------|------------------------------------------|-------------------------|
+ * | 0      | TIM3 (base de temps) + TIM4 (vitesse)    | < 5 µs                  |
+ * | 1      | SysTick (tick HAL : moteur, failsafe)    | < 5 µs                  |
+ * |        | PendSV (boucle chaînée à l'IMU)          | < 20 µs                 |
+ * | 2      | IMU : EXTI data-ready, SPI1 et ses DMA   | < 20 µs                 |
+ * | 3      | UART : USART2 (IDLE/erreurs), DMA RX     | < 20 µs                 |
+ *
+ * PendSV partage le niveau du tick moteur : les deux contextes qui écrivent les
+ * actionneurs ne se préemptent jamais l'un l'autre. Demandé par l'interruption de fin
+ * d'acquisition IMU (niveau 2), il s'exécute dès que celle-ci le déclenche.
+ *
+ * Le canal DMA1_Channel2_3 est partagé entre l'UART TX et le SPI RX : il prend le
+ * niveau IMU. Les budgets se vérifient avec le profileur (profiler.h) et la sonde
+ * de latence TIM3 (jitter.h). Les sections __disable_irq() restent globales (pas de
+ * BASEPRI sur M0+) et doivent rester courtes.
+ */
+
+#ifndef INC_IRQ_PRIO_H_
+#define INC_IRQ_PRIO_H_
+
+/** @brief Base de temps TIM3 et capture vitesse TIM4 (vecteur partagé). */
+#ifndef IRQ_PRIO_TIMEBASE
+#define IRQ_PRIO_TIMEBASE   0u
+#endif
+
+/** @brief Tick HAL (SysTick) cadençant moteur et failsafe. */
+#ifndef IRQ_PRIO_MOTOR
+#define IRQ_PRIO_MOTOR      1u
+#endif
+
+/** @brief Acquisition IMU : EXTI data-ready, SPI1, DMA SPI. */
+#ifndef IRQ_PRIO_IMU
+#define IRQ_PRIO_IMU        2u
+#endif
+
+/** @brief Liaison série : USART2 et DMA RX. */
+#ifndef IRQ_PRIO_UART
+#define IRQ_PRIO_UART       3u
+#endif
+
+/**
+ * @brief  Applique la carte des priorités NVIC.
+ * @note   À appeler après les MX_xxx_Init(), avant de démarrer les périphériques.
+ */
+void irq_prio_apply(void);
+
+#endif /* INC_IRQ_PRIO_H_ */
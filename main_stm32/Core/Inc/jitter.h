@@ -0,0 +1,49 @@
+/**
+ * @file    jitter.h
+ * @brief   Banc de mesure de latence d'interruption et de gigue.
+ * @details Sonde de latence : le compare CH2 de TIM3 lève une interruption à date
+ * connue ; l'écart entre le compteur à l'entrée du handler et la valeur de compare
+ * donne la latence d'entrée réelle (même priorité NVIC que les DMA UART/SPI, donc
+ * retardée par leurs handlers et par les sections __disable_irq()).
+ * La gigue de libération des tâches est mesurée par l'ordonnanceur (profil de retard).
+ */
+
+#ifndef INC_JITTER_H_
+#define INC_JITTER_H_
+
+#include <stdint.h>
+
+/** @brief Mode : sonde de latence d'interruption TIM3 CH2 active. */
+#define JITTER_MODE_ISR_PROBE   0x01u
+/** @brief Mode : charge UART TX à plein débit (remplissage continu du ring d'émission). */
+#define JITTER_MODE_TX_STRESS   0x02u
+/** @brief Masque des modes valides. */
+#define JITTER_MODE_MASK        (JITTER_MODE_ISR_PROBE | JITTER_MODE_TX_STRESS)
+
+/** @brief Période de la sonde de latence (ticks TIM3). Première avec 1000 pour ne pas se caler sur la tâche moteur. */
+#define JITTER_PROBE_PERIOD     997u
+
+/**
+ * @brief  Active ou désactive les modes du banc de mesure.
+ * @param  mode Combinaison de JITTER_MODE_*.
+ * @note   Activer la sonde remet à zéro son profil (PROF_PROBE_TIM3_LATENCY).
+ */
+void jitter_set_mode(uint8_t mode);
+
+/**
+ * @brief  Modes actifs.
+ * @return Combinaison de JITTER_MODE_*.
+ */
+uint8_t jitter_get_mode(void);
+
+/**
+ * @brief  Traitement du compare CH2 de TIM3, appelé depuis TIM3_TIM4_IRQHandler.
+ */
+void jitter_tim3_irq(void);
+
+/**
+ * @brief  Traitement de fond (boucle principale) : charge TX si demandée.
+ */
+void jitter_poll(void);
+
+#endif /* INC_JITTER_H_ */
@@ -0,0 +1,112 @@
+/**
+ * @file    kin.h
+ * @brief   Commande cinématique : vitesse linéaire + courbure converties en braquage et vitesse.
+ * @details L'hôte envoie en une trame groupée la vitesse (mm/s) et la courbure de la
+ * trajectoire (km⁻¹, positive à gauche) ; le firmware en déduit l'angle de braquage du
+ * modèle bicyclette, δ = atan(L·κ), et transmet la vitesse à la boucle de propulsion.
+ * La courbure, contrairement à la vitesse de lacet, reste définie à l'arrêt : le
+ * braquage est posé avant le départ. Une consigne de lacet r se ramène à κ = r / v.
+ *
+ * Boucle de lacet optionnelle (KIN_YAW_KP / KIN_YAW_KI non nuls) : sur chaque
+ * échantillon IMU, la vitesse de lacet attendue v·κ (vitesse mesurée) est comparée au
+ * gyroscope Z et corrige le braquage d'un terme PI borné (glissement, dissymétrie de
+ * la direction). Sous KIN_YAW_MIN_SPEED_MMS, la correction proportionnelle est coupée
+ * et l'intégrale figée : le lacet n'y est plus significatif.
+ *
+ * Entièrement en virgule fixe ; l'arc tangente est approché par
+ * atan(x) ≈ x·π/4 + 0,273·x·(1 - |x|) sur [-1, 1] (écart inférieur à 0,25°).
+ */
+
+#ifndef INC_KIN_H_
+#define INC_KIN_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "vehicle_profile.h"
+
+/** @brief Empattement du véhicule (mm, profil véhicule). */
+#ifndef KIN_WHEELBASE_MM
+#define KIN_WHEELBASE_MM        VEH_WHEELBASE_MM
+#endif
+/** @brief Signe du braquage servo pour une courbure positive (virage à gauche) : +1 ou -1 (profil véhicule). */
+#ifndef KIN_STEER_SIGN
+#define KIN_STEER_SIGN          VEH_STEER_SIGN
+#endif
+/** @brief Signe du gyroscope Z pour un virage à gauche : +1 (Z capteur vers le haut) ou -1. */
+#ifndef KIN_YAW_SIGN
+#define KIN_YAW_SIGN            1
+#endif
+/** @brief Gain proportionnel de la boucle de lacet (c° par rad/s d'écart), 0 : boucle ouverte. */
+#ifndef KIN_YAW_KP
+#define KIN_YAW_KP              0
+#endif
+/** @brief Gain intégral de la boucle de lacet (c° par rad d'écart de cap cumulé), 0 : sans intégrale. */
+#ifndef KIN_YAW_KI
+#define KIN_YAW_KI              0
+#endif
+/** @brief Boucle de lacet compilée (au moins un gain non nul). */
+#define KIN_YAW_LOOP            ((KIN_YAW_KP != 0) || (KIN_YAW_KI != 0))
+/** @brief Correction de braquage maximale de la boucle de lacet (c°). */
+#ifndef KIN_YAW_TRIM_MAX_CDEG
+#define KIN_YAW_TRIM_MAX_CDEG   500
+#endif
+/** @brief Vitesse mesurée sous laquelle la boucle de lacet est suspendue (mm/s). */
+#ifndef KIN_YAW_MIN_SPEED_MMS
+#define KIN_YAW_MIN_SPEED_MMS   300
+#endif
+/** @brief Écart maximal entre deux échantillons intégrés (µs) ; au-delà, l'intégrale n'avance pas. */
+#define KIN_DT_MAX_US           50000u
+
+/**
+ * @brief État de la commande cinématique.
+ */
+typedef struct{
+    bool     active;          ///< Dernière consigne de braquage issue d'une commande cinématique.
+    int16_t  curv_pkm;        ///< Courbure commandée (km⁻¹).
+    int32_t  ff_cdeg;         ///< Braquage du modèle bicyclette (c°, repère courbure).
+    int32_t  integ_urad;      ///< Écart de cap cumulé (µrad), borné par KIN_YAW_TRIM_MAX_CDEG.
+    int32_t  out_cdeg;        ///< Dernier braquage rendu (c°, repère servo).
+    uint64_t last_us;         ///< Date du dernier échantillon intégré (0 : aucun).
+} Kin_t;
+
+/**
+ * @brief  Initialise la commande cinématique (inactive).
+ * @param  kin Pointeur vers l'état.
+ */
+void kin_init(Kin_t *kin);
+
+/**
+ * @brief  Angle de braquage du modèle bicyclette pour une courbure.
+ * @param  curv_pkm Courbure (km⁻¹, positive à gauche).
+ * @return Angle (c°, positif à gauche), |L·κ| borné à 1 (45°).
+ */
+int32_t kin_curv_to_cdeg(int32_t curv_pkm);
+
+/**
+ * @brief  Nouvelle consigne cinématique : active le mode et rend le braquage à appliquer.
+ * @details L'intégrale de lacet est conservée d'une consigne à la suivante (pas d'à-coup
+ * sur une commande répétée à chaque pas de contrôle).
+ * @param  kin      Pointeur vers l'état.
+ * @param  curv_pkm Courbure (km⁻¹, positive à gauche).
+ * @return Braquage servo (c°).
+ */
+int32_t kin_command(Kin_t *kin, int16_t curv_pkm);
+
+/**
+ * @brief  Quitte le mode cinématique (autre consigne de braquage, trajectoire, failsafe).
+ * @param  kin Pointeur vers l'état.
+ */
+void kin_stop(Kin_t *kin);
+
+/**
+ * @brief  Boucle de lacet sur un échantillon IMU.
+ * @param  kin          Pointeur vers l'état.
+ * @param  gyro_z_urads Vitesse angulaire autour de Z capteur (µrad/s).
+ * @param  speed_mms    Vitesse mesurée signée (mm/s).
+ * @param  timestamp_us Date de l'échantillon (µs).
+ * @param  cdeg         Sortie : braquage servo corrigé (c°).
+ * @return true si le braquage a changé et doit être appliqué.
+ */
+bool kin_update(Kin_t *kin, int32_t gyro_z_urads, int32_t speed_mms, uint64_t timestamp_us, int32_t *cdeg);
+
+#endif /* INC_KIN_H_ */
@@ -0,0 +1,63 @@
+/**
+ * @file    kv_store.h
+ * @brief   Magasin clé-valeur persistant à répartition d'usure (deux pages de flash).
+ * @details Chaque écriture ajoute un enregistrement de 8 octets (clé, valeur 16 bits,
+ * CRC-8) à la suite de la page active ; la dernière valeur d'une clé l'emporte. Page
+ * pleine, les valeurs courantes sont recopiées dans l'autre page, effacée au préalable,
+ * dont l'entête (génération incrémentée) n'est programmé qu'en dernier : une coupure
+ * pendant la recopie laisse l'ancienne page active. Les deux pages s'usent donc à tour
+ * de rôle, une fois toutes les ~250 écritures de valeurs modifiées.
+ * Les valeurs courantes sont tenues en RAM : la lecture ne parcourt pas la flash.
+ */
+
+#ifndef INC_KV_STORE_H_
+#define INC_KV_STORE_H_
+
+#include <stdint.h>
+
+/** @brief Nombre de clés adressables (une par registre virtuel). */
+#define KV_KEY_COUNT            128u
+
+/**
+ * @brief  Charge la page active et les dernières valeurs de chaque clé.
+ * @note   À appeler une fois au démarrage, avant kv_get().
+ */
+void kv_init(void);
+
+/**
+ * @brief  Lit la dernière valeur enregistrée d'une clé.
+ * @param  key   Clé (< KV_KEY_COUNT).
+ * @param  value Valeur de sortie.
+ * @return 1 si la clé est présente, 0 sinon.
+ */
+uint8_t kv_get(uint8_t key, int16_t *value);
+
+/**
+ * @brief  Enregistre une valeur (sans écriture flash si elle est inchangée).
+ * @details Peut déclencher une recopie dans l'autre page, donc un effacement
+ * bloquant (40 ms au plus).
+ * @param  key   Clé (< KV_KEY_COUNT).
+ * @param  value Valeur à enregistrer.
+ * @return 0 si succès, -EINVAL si la clé est hors plage, -EIO en cas d'échec flash.
+ */
+int8_t kv_set(uint8_t key, int16_t value);
+
+/**
+ * @brief  Efface les deux pages : toutes les clés disparaissent.
+ * @return 0 si succès, -EIO en cas d'échec flash.
+ */
+int8_t kv_clear(void);
+
+/**
+ * @brief  Nombre de clés présentes.
+ * @return Nombre de clés ayant une valeur enregistrée.
+ */
+uint8_t kv_count(void);
+
+/**
+ * @brief  Génération de la page active (nombre de recopies depuis le premier effacement).
+ * @return Génération, 0 si le magasin est vide.
+ */
+uint16_t kv_generation(void);
+
+#endif /* INC_KV_STORE_H_ */
@@ -0,0 +1,46 @@
+/**
+ * @file    lowpower.h
+ * @brief   Mise en veille profonde (STOP1) du véhicule à l'arrêt.
+ * @details En STOP1, horloges HSI/PLL et timers sont coupés : la base de temps TIM3,
+ * le tick HAL et les PWM s'arrêtent. LPTIM1, cadencé par le LSI, reste actif : il
+ * réveille le cœur avant l'échéance de l'IWDG (qui continue de compter en STOP) et
+ * mesure la durée de la veille, reportée ensuite sur TIM3 et le tick HAL : le temps
+ * reste monotone et les délais en cours (failsafe, idle) voient la durée réelle.
+ *
+ * Sources de réveil :
+ * - activité UART : front descendant sur RX (EXTI ligne USART2_RX_Pin), le premier
+ *   octet reçu pendant le redémarrage des horloges est perdu ;
+ * - mouvement : INT1 any-motion du BMI088 (EXTI déjà armée par BMI088_Motion_Config()).
+ */
+
+#ifndef INC_LOWPOWER_H_
+#define INC_LOWPOWER_H_
+
+#include <stdint.h>
+
+/** @brief Période de réveil pour rafraîchir l'IWDG pendant la veille (ms, < WATCHDOG_TIMEOUT_MS). */
+#ifndef LP_FEED_MS
+#define LP_FEED_MS          200u
+#endif
+
+/**
+ * @brief Cause de sortie de veille.
+ */
+typedef enum{
+    LP_WAKE_UART = 1,       ///< Front sur la ligne RX.
+    LP_WAKE_MOTION          ///< Détection any-motion (INT1).
+} lp_wake_t;
+
+/**
+ * @brief  Dort en STOP1 jusqu'à une activité UART ou un mouvement.
+ * @details Bloquant, interruptions masquées pendant la veille : les interruptions
+ * survenues (INT1 notamment) sont servies au retour. Au retour, horloge système
+ * reconfigurée, base de temps et tick HAL avancés de la durée de la veille.
+ * @note   L'appelant coupe auparavant ce qui ne doit pas rester figé (PWM, capteur)
+ * et s'assure que l'émission UART est terminée.
+ * @param  slept_ms Sortie : durée de la veille (ms), NULL si inutile.
+ * @return Cause du réveil (lp_wake_t).
+ */
+uint8_t lp_stop(uint32_t *slept_ms);
+
+#endif /* INC_LOWPOWER_H_ */
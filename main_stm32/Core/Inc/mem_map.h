@@ -0,0 +1,125 @@
+/**
+ * @file    mem_map.h
+ * @brief   Placement mémoire des buffers et bilan RAM (sections, pile).
+ * @details Les buffers DMA et l'état chaud partagé avec les interruptions sont
+ * regroupés dans des sections nommées du .bss (voir les scripts de liens), ce qui
+ * les rend visibles et mesurables dans le fichier .map. La pile est peinte au
+ * démarrage sur une fenêtre de MEM_STACK_PAINT_BYTES sous _estack ; sa
+ * profondeur maximale atteinte se relit ensuite à tout moment.
+ * Les fonctions chaudes marquées MEM_RAMFUNC sont placées dans .RamFunc, recopiée
+ * en SRAM par le code de démarrage avec .data : elles s'exécutent sans les états
+ * d'attente de la flash à 64 MHz.
+ * Comparaison : construire avec MEM_RAMFUNC_ENABLE à 1 puis à 0 et relever les
+ * sondes du profileur (REG_PROF_*, ISR UART/SPI/moteur, tâches), la gigue TIM3
+ * et REG_STAT_IDLE_PCT sous la même charge ; REG_STAT_RAM_FUNC indique la
+ * variante en cours (0 : tout en flash).
+ *
+ * Démarrage : Reset_Handler recopie .data et met .bss à zéro par blocs de 16 octets
+ * (ldm/stm). Les grands buffers dont le module réinitialise lui-même l'état (historique
+ * IMU, journal) sont marqués MEM_NOINIT : placés dans .noinit, ni recopiés ni mis à
+ * zéro, leur contenu survit à un reset à chaud. SysTick compte depuis le reset jusqu'à
+ * HAL_Init() : mem_boot_stamp() date l'entrée de main() (sonde PROF_PROBE_STARTUP).
+ */
+
+#ifndef INC_MEM_MAP_H_
+#define INC_MEM_MAP_H_
+
+#include <stdint.h>
+
+/** @brief Place une variable non initialisée dans la section des buffers DMA. */
+#define MEM_DMA_BSS     __attribute__((section(".bss.dma_buffer"), aligned(4)))
+/** @brief Place une variable non initialisée dans la section d'état chaud. */
+#define MEM_HOT_BSS     __attribute__((section(".bss.hot_state")))
+/**
+ * @brief Place une variable dans .noinit : ni mise à zéro au démarrage, ni recopiée.
+ * @note  Contenu aléatoire à la mise sous tension, conservé au reset à chaud.
+ */
+#define MEM_NOINIT      __attribute__((section(".noinit"), aligned(4)))
+
+/**
+ * @brief Exécution des fonctions MEM_RAMFUNC depuis la SRAM (1) ou depuis la flash (0).
+ */
+#ifndef MEM_RAMFUNC_ENABLE
+#define MEM_RAMFUNC_ENABLE      1
+#endif
+
+/**
+ * @brief Place une fonction dans .RamFunc (exécution en SRAM).
+ * @note  Les appels flash <-> RAM sortent de la portée de BL : l'éditeur de liens
+ * insère les veneers. noinline garde la fonction entière en RAM.
+ */
+#if MEM_RAMFUNC_ENABLE
+#define MEM_RAMFUNC     __attribute__((section(".RamFunc"), noinline))
+#else
+#define MEM_RAMFUNC
+#endif
+
+/** @brief Taille de la fenêtre de pile peinte et surveillée (octets). */
+#define MEM_STACK_PAINT_BYTES   8192u
+/** @brief Motif de peinture de la pile. */
+#define MEM_STACK_PAINT_WORD    0xC5C5C5C5u
+
+/**
+ * @brief Régions mémoire rapportées par mem_region_size().
+ */
+typedef enum {
+    MEM_REGION_DMA = 0,         ///< Section .bss.dma_buffer.
+    MEM_REGION_HOT,             ///< Section .bss.hot_state.
+    MEM_REGION_STATIC,          ///< .data + .bss + .noinit (toute la RAM statique).
+    MEM_REGION_RAMFUNC,         ///< Code exécuté depuis la RAM (.RamFunc).
+    MEM_REGION_HEAP_RESERVED,   ///< Tas réservé par le script de liens (_Min_Heap_Size).
+    MEM_REGION_STACK_RESERVED,  ///< Pile réservée par le script de liens (_Min_Stack_Size).
+    MEM_REGION_FLASH_IMAGE,     ///< Image en flash : code, constantes et valeurs initiales de .data.
+    MEM_REGION_DATA,            ///< .data (recopiée depuis la flash au démarrage, .RamFunc comprise).
+    MEM_REGION_BSS,             ///< .bss (mise à zéro au démarrage).
+    MEM_REGION_NOINIT           ///< .noinit (ni recopiée ni mise à zéro).
+} mem_region_t;
+
+/** @brief Horloge de SysTick entre le reset et HAL_Init() (HSI16, sans PLL). */
+#define MEM_BOOT_CLK_HZ         16000000u
+
+/**
+ * @brief Instants datés avant HAL_Init() (mem_boot_stamp()).
+ */
+typedef enum {
+    MEM_BOOT_MAIN = 0,          ///< Entrée de main() : fin de Reset_Handler.
+    MEM_BOOT_HAL,               ///< Juste avant HAL_Init() (peinture de pile comprise).
+    MEM_BOOT_COUNT
+} mem_boot_point_t;
+
+/**
+ * @brief  Peint la fenêtre de pile libre avec MEM_STACK_PAINT_WORD.
+ * @details À appeler au tout début de main(), avant toute initialisation : seule
+ * la zone située sous le pointeur de pile courant est écrite.
+ */
+void mem_stack_paint(void);
+
+/**
+ * @brief  Profondeur maximale de pile atteinte depuis mem_stack_paint().
+ * @return Octets utilisés sous _estack ; MEM_STACK_PAINT_BYTES (ou la fenêtre
+ * effectivement peinte) si la pile a débordé de la fenêtre surveillée.
+ */
+uint32_t mem_stack_peak(void);
+
+/**
+ * @brief  Taille d'une région mémoire.
+ * @param  region Région demandée.
+ * @return Taille en octets.
+ */
+uint32_t mem_region_size(mem_region_t region);
+
+/**
+ * @brief  Date un instant du démarrage d'après SysTick, lancé au reset par Reset_Handler.
+ * @note   Uniquement avant HAL_Init(), qui reprogramme SysTick.
+ * @param  point Instant.
+ */
+void mem_boot_stamp(mem_boot_point_t point);
+
+/**
+ * @brief  Date d'un instant du démarrage.
+ * @param  point Instant.
+ * @return Microsecondes depuis le reset, 0 si l'instant n'a pas été daté.
+ */
+uint32_t mem_boot_us(mem_boot_point_t point);
+
+#endif /* INC_MEM_MAP_H_ */
@@ -0,0 +1,62 @@
+/**
+ * @file    nv_flash.h
+ * @brief   Accès bas niveau aux pages de flash réservées aux données persistantes.
+ * @details Les zones réservées sont déclarées dans les scripts de liens, en fin de
+ * banque 2 : le code s'exécutant depuis la banque 1, effacement et programmation
+ * ne bloquent pas la lecture des instructions (lecture pendant écriture du G0B1).
+ * La programmation se fait par double mot (8 octets) sur une zone effacée ; une
+ * page effacée se lit à 0xFF.
+ */
+
+#ifndef INC_NV_FLASH_H_
+#define INC_NV_FLASH_H_
+
+#include <stdint.h>
+
+/** @brief Granularité de programmation (octets). */
+#define NV_FLASH_WORD_SIZE      8u
+
+/** @brief Début de la page des enregistrements de calibration IMU (symbole du script de liens). */
+#define NV_FLASH_CALIB_START    ((uint32_t)&_scalib)
+/** @brief Fin (exclue) de la page des enregistrements de calibration IMU. */
+#define NV_FLASH_CALIB_END      ((uint32_t)&_ecalib)
+
+/** @brief Début des pages du magasin de configuration (symbole du script de liens). */
+#define NV_FLASH_KV_START       ((uint32_t)&_skv)
+/** @brief Fin (exclue) des pages du magasin de configuration. */
+#define NV_FLASH_KV_END         ((uint32_t)&_ekv)
+
+/** @brief Début de la zone de préparation des mises à jour du firmware (symbole du script de liens). */
+#define NV_FLASH_STAGE_START    ((uint32_t)&_sfwstage)
+/** @brief Fin (exclue) de la zone de préparation des mises à jour du firmware. */
+#define NV_FLASH_STAGE_END      ((uint32_t)&_efwstage)
+
+extern uint8_t _scalib, _ecalib;
+extern uint8_t _skv, _ekv;
+extern uint8_t _sfwstage, _efwstage;
+
+/**
+ * @brief  Efface une page de flash (bloquant, 22 ms typique, 40 ms au plus).
+ * @param  addr Adresse de début de page (alignée sur FLASH_PAGE_SIZE).
+ * @return 0 si succès, -EINVAL si l'adresse n'est pas un début de page, -EIO sinon.
+ */
+int8_t nv_flash_erase_page(uint32_t addr);
+
+/**
+ * @brief  Programme une zone effacée, par double mot.
+ * @param  addr Adresse de destination (alignée sur NV_FLASH_WORD_SIZE).
+ * @param  src  Données à écrire.
+ * @param  len  Nombre d'octets (multiple de NV_FLASH_WORD_SIZE).
+ * @return 0 si succès, -EINVAL si l'alignement est incorrect, -EIO sinon.
+ */
+int8_t nv_flash_program(uint32_t addr, const void *src, uint32_t len);
+
+/**
+ * @brief  Indique si une zone est effacée (tous les octets à 0xFF).
+ * @param  addr Adresse de début.
+ * @param  len  Nombre d'octets.
+ * @return 1 si la zone est vierge, 0 sinon.
+ */
+uint8_t nv_flash_is_blank(uint32_t addr, uint32_t len);
+
+#endif /* INC_NV_FLASH_H_ */
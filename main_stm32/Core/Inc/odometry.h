@@ -0,0 +1,103 @@
+/**
+ * @file    odometry.h
+ * @brief   Odométrie embarquée (navigation à l'estime dans le plan).
+ * @details Intégrée sur chaque échantillon IMU retiré de la file : le cap suit le
+ * gyroscope Z, la distance suit les fronts du tachymètre (distance exacte, signée par
+ * le sens estimé), projetée sur le cap courant. Entièrement en virgule fixe : le cap
+ * est porté par un vecteur unitaire (cos, sin) Q30 tourné d'un petit angle à chaque
+ * échantillon et renormalisé par (3 - |v|²) / 2, comme le quaternion d'attitude ;
+ * ni trigonométrie ni division par échantillon.
+ *
+ * Le cap est figé à l'arrêt (aucun front depuis ODOM_STILL_US) : une voiture immobile
+ * ne tourne pas, le biais résiduel du gyroscope ne dérive pas le cap pendant les pauses.
+ */
+
+#ifndef INC_ODOMETRY_H_
+#define INC_ODOMETRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @brief Valeur unité des composantes du vecteur cap (Q30). */
+#define ODOM_ONE_Q30            (1L << 30)
+/** @brief Écart maximal entre deux échantillons intégrés (µs) ; au-delà, le cap n'est pas intégré. */
+#define ODOM_DT_MAX_US          20000u
+/** @brief Délai sans front du tachymètre au-delà duquel le véhicule est à l'arrêt (µs). */
+#define ODOM_STILL_US           500000u
+
+/**
+ * @brief Commandes du registre REG_ODOM_CMD.
+ */
+typedef enum{
+    ODOM_CMD_RESET_POSE = 1,    ///< Position et cap remis à zéro (distance cumulée conservée).
+    ODOM_CMD_RESET_ALL  = 2     ///< Position, cap et distance cumulée remis à zéro.
+} odom_cmd_t;
+
+/**
+ * @brief État de l'odométrie.
+ */
+typedef struct{
+    int64_t  x_um;            ///< Position X dans le repère de départ (µm, axe du cap initial).
+    int64_t  y_um;            ///< Position Y dans le repère de départ (µm, X tourné de +90° autour de Z capteur).
+    int64_t  heading_q30;     ///< Cap (rad Q30, ramené dans ]-pi, pi]).
+    int32_t  cs_q30[2];       ///< Vecteur cap (cos, sin), Q30.
+    uint32_t dist_mm;         ///< Distance parcourue cumulée, en valeur absolue (mm, modulo 2^32).
+    uint32_t dist_frac_um;    ///< Reste de la distance cumulée, inférieur au mm (µm).
+    uint32_t last_ticks;      ///< Compteur tachymètre au dernier échantillon.
+    bool     primed;          ///< Un premier échantillon daté a été reçu.
+    uint64_t last_us;         ///< Date du dernier échantillon (µs).
+    uint64_t last_tick_us;    ///< Date du dernier échantillon avec au moins un front (µs).
+} Odometry_t;
+
+/**
+ * @brief  Initialise l'odométrie (origine, cap nul, distance nulle).
+ * @param  odo Pointeur vers l'odométrie.
+ */
+void odom_init(Odometry_t *odo);
+
+/**
+ * @brief  Exécute une commande de REG_ODOM_CMD.
+ * @param  odo Pointeur vers l'odométrie.
+ * @param  cmd Commande (odom_cmd_t), valeurs inconnues ignorées.
+ */
+void odom_command(Odometry_t *odo, uint8_t cmd);
+
+/**
+ * @brief  Intègre un échantillon IMU et les fronts du tachymètre reçus depuis le précédent.
+ * @param  odo          Pointeur vers l'odométrie.
+ * @param  gyro_z_urads Vitesse angulaire autour de Z capteur (µrad/s), axe vertical du véhicule.
+ * @param  ticks        Compteur de fronts du tachymètre (modulo 2^32).
+ * @param  forward      Sens de déplacement estimé (true = avant).
+ * @param  timestamp_us Date d'acquisition de l'échantillon (µs).
+ */
+void odom_update(Odometry_t *odo, int32_t gyro_z_urads, uint32_t ticks, bool forward, uint64_t timestamp_us);
+
+/**
+ * @brief  Position X.
+ * @param  odo Pointeur vers l'odométrie.
+ * @return Position (mm).
+ */
+int32_t odom_x_mm(const Odometry_t *odo);
+
+/**
+ * @brief  Position Y.
+ * @param  odo Pointeur vers l'odométrie.
+ * @return Position (mm).
+ */
+int32_t odom_y_mm(const Odometry_t *odo);
+
+/**
+ * @brief  Cap.
+ * @param  odo Pointeur vers l'odométrie.
+ * @return Cap (centièmes de degré, -18000..18000).
+ */
+int16_t odom_heading_cdeg(const Odometry_t *odo);
+
+/**
+ * @brief  Distance parcourue cumulée.
+ * @param  odo Pointeur vers l'odométrie.
+ * @return Distance (mm, modulo 2^32).
+ */
+uint32_t odom_distance_mm(const Odometry_t *odo);
+
+#endif /* INC_ODOMETRY_H_ */
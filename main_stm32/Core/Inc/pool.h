@@ -0,0 +1,75 @@
+/**
+ * @file    pool.h
+ * @brief   Allocateur de blocs de taille fixe (trames, lots d'échantillons).
+ * @details Chaque pool est une zone statique de N blocs, déclarée par POOL_DEFINE().
+ * Allocation et libération en O(1) : les blocs libérés sont chaînés par leur premier
+ * mot, les blocs jamais servis sont pris en tête de zone. Les deux opérations masquent
+ * les interruptions quelques cycles : un bloc peut être alloué dans une interruption
+ * et libéré dans la boucle principale, ou l'inverse. Un bloc passe d'un étage à
+ * l'autre (construction, émission, liaison) par son pointeur, sans recopie.
+ */
+
+#ifndef INC_POOL_H_
+#define INC_POOL_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Pool de blocs (champs internes, à déclarer par POOL_DEFINE).
+ */
+typedef struct{
+    uint8_t *storage;           ///< Zone des blocs.
+    uint16_t block_size;        ///< Taille d'un bloc (octets, multiple de 4).
+    uint8_t count;              ///< Nombre de blocs.
+    uint8_t fresh;              ///< Blocs jamais servis, pris à partir de cet index.
+    void *free_list;            ///< Blocs libérés (chaînés par leur premier mot).
+    uint8_t available;          ///< Blocs disponibles.
+    uint8_t low_water;          ///< Minimum de blocs disponibles observé.
+    uint32_t failures;          ///< Allocations refusées (pool vide).
+} pool_t;
+
+/**
+ * @brief  Déclare un pool et sa zone statique.
+ * @param  name       Nom de la variable pool_t.
+ * @param  block_size Taille d'un bloc (octets, multiple de 4).
+ * @param  count      Nombre de blocs (1 à 255).
+ */
+#define POOL_DEFINE(name, block_size, count)                                                    \
+    _Static_assert(((block_size) % 4u) == 0u && (block_size) >= 4u, #name ": bad block size"); \
+    _Static_assert((count) >= 1u && (count) <= 255u, #name ": bad block count");               \
+    static uint32_t name##_storage[(count) * ((block_size) / 4u)];                              \
+    pool_t name = { (uint8_t *)name##_storage, (block_size), (count), 0u, 0, (count), (count), 0u }
+
+/**
+ * @brief  Alloue un bloc.
+ * @param  pool Pool.
+ * @return Bloc (contenu indéterminé), NULL si le pool est vide.
+ */
+void *pool_alloc(pool_t *pool);
+
+/**
+ * @brief  Rend un bloc au pool.
+ * @param  pool  Pool d'origine.
+ * @param  block Bloc rendu par pool_alloc(), ou NULL (sans effet).
+ */
+void pool_free(pool_t *pool, void *block);
+
+/**
+ * @brief  Blocs disponibles.
+ * @param  pool Pool.
+ * @return Nombre de blocs libres.
+ */
+static inline uint8_t pool_available(const pool_t *pool){
+    return pool->available;
+}
+
+/**
+ * @brief  Minimum de blocs disponibles depuis le démarrage (dimensionnement).
+ * @param  pool Pool.
+ * @return Nombre de blocs.
+ */
+static inline uint8_t pool_low_water(const pool_t *pool){
+    return pool->low_water;
+}
+
+#endif /* INC_POOL_H_ */
@@ -0,0 +1,111 @@
+/**
+ * @file    profiler.h
+ * @brief   Mesure légère des temps d'exécution (tâches et interruptions).
+ * @details Chaque sonde cumule nombre d'exécutions, min/moyenne/max et, en option,
+ * un histogramme logarithmique. Horodatage par la base de temps TIM3 (1 µs) :
+ * le Cortex-M0+ ne dispose pas du compteur de cycles DWT.
+ */
+
+#ifndef INC_PROFILER_H_
+#define INC_PROFILER_H_
+
+#include <stdint.h>
+
+/** @brief Histogramme des durées (1) ou seulement min/moyenne/max (0). */
+#ifndef PROF_HISTOGRAM
+#define PROF_HISTOGRAM      1
+#endif
+
+/**
+ * @brief Nombre de classes de l'histogramme.
+ * @note  Classe k : durée < 4^(k+1) µs (4, 16, 64, 256 µs, 1, 4, 16 ms), dernière classe au-delà.
+ */
+#define PROF_HIST_BINS      8u
+
+/**
+ * @brief Sondes hors ordonnanceur (boucle principale et interruptions).
+ */
+typedef enum {
+    PROF_PROBE_SERIAL_RX = 0,   ///< serial_cmd_reader() : lecture et décodage série.
+    PROF_PROBE_CMD,             ///< process_incoming_commands() : application des commandes.
+    PROF_PROBE_IMU_SPI_ISR,     ///< HAL_SPI_TxRxCpltCallback() : fin de DMA SPI IMU.
+    PROF_PROBE_IMU_DRDY_ISR,    ///< HAL_GPIO_EXTI_Rising_Callback() : data-ready IMU.
+    PROF_PROBE_TIM3_LATENCY,    ///< Latence d'entrée d'interruption TIM3 (banc jitter.h).
+    PROF_PROBE_MOTOR_ISR,       ///< app_motor_tick_isr() : tick moteur en SysTick.
+    PROF_PROBE_CMD_RX,          ///< Commande : arrivée des octets (fin de trame DMA) -> décodage.
+    PROF_PROBE_CMD_QUEUE,       ///< Commande : décodage -> application (file, boucle principale).
+    PROF_PROBE_CMD_ACT,         ///< Commande d'actionneur : application -> écriture CCR (tick moteur).
+    PROF_PROBE_CMD_E2E,         ///< Commande d'actionneur : arrivée des octets -> écriture CCR.
+    PROF_PROBE_STARTUP,         ///< Reset -> main() : recopie de .data, mise à zéro de .bss (une mesure par démarrage).
+    PROF_PROBE_IMU_CHAIN,       ///< app_imu_chain_isr() : boucle de lacet chaînée à l'IMU (PendSV, APP_IMU_CHAIN).
+    PROF_PROBE_IMU_E2E,         ///< Boucle chaînée : date de l'échantillon IMU -> écriture CCR.
+    PROF_PROBE_COUNT
+} prof_probe_id_t;
+
+/**
+ * @brief Statistiques d'une sonde.
+ */
+typedef struct {
+    uint32_t count;     ///< Nombre de mesures.
+    uint32_t min_us;    ///< Durée minimale (µs), UINT32_MAX tant qu'aucune mesure.
+    uint32_t max_us;    ///< Durée maximale (µs).
+    uint64_t sum_us;    ///< Somme des durées (µs), pour la moyenne.
+#if PROF_HISTOGRAM
+    uint32_t hist[PROF_HIST_BINS];  ///< Répartition des durées.
+#endif
+} prof_stat_t;
+
+/**
+ * @brief  Comptabilise une mesure.
+ * @param  s     Statistiques de la sonde.
+ * @param  dt_us Durée mesurée (µs).
+ * @note   Une sonde ne doit être alimentée que depuis un seul contexte.
+ */
+void prof_record(prof_stat_t *s, uint32_t dt_us);
+
+/**
+ * @brief  Remet à zéro les statistiques d'une sonde.
+ * @param  s Statistiques de la sonde.
+ */
+void prof_reset(prof_stat_t *s);
+
+/**
+ * @brief  Copie cohérente des statistiques (sonde éventuellement alimentée en interruption).
+ * @param  s   Statistiques de la sonde.
+ * @param  out Copie de sortie.
+ */
+void prof_snapshot(const prof_stat_t *s, prof_stat_t *out);
+
+/**
+ * @brief  Durée moyenne d'une sonde.
+ * @param  s Statistiques de la sonde.
+ * @return Moyenne (µs), 0 si aucune mesure.
+ */
+uint32_t prof_avg_us(const prof_stat_t *s);
+
+/**
+ * @brief  Démarre la mesure d'une sonde.
+ * @return Date de début (µs, 32 bits de poids faible).
+ */
+uint32_t prof_begin(void);
+
+/**
+ * @brief  Termine la mesure d'une sonde hors ordonnanceur.
+ * @param  id       Sonde.
+ * @param  start_us Date renvoyée par prof_begin().
+ */
+void prof_end(prof_probe_id_t id, uint32_t start_us);
+
+/**
+ * @brief  Accès aux statistiques d'une sonde hors ordonnanceur.
+ * @param  id Sonde.
+ * @return Statistiques, NULL si l'index est invalide.
+ */
+prof_stat_t *prof_probe(uint8_t id);
+
+/**
+ * @brief  Remet à zéro toutes les sondes hors ordonnanceur.
+ */
+void prof_reset_probes(void);
+
+#endif /* INC_PROFILER_H_ */
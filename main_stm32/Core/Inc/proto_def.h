@@ -0,0 +1,283 @@
+/**
+ * @file    proto_def.h
+ * @brief   Description unique des trames du protocole (types, champs, dispositions).
+ * @details Listes X-macro dont sont tirés, côté firmware, les types de trame, les bits
+ * de la trame à contenu choisi, les structures packed des trames fixes et leurs
+ * contrôles de taille à la compilation ; côté hôte, python_serial_reg/gen_proto.py
+ * lit ce fichier et les adresses REG_* de serial_cmd.h pour produire proto_defs.py
+ * (constantes et formats struct). Ajouter un champ ou une trame ici, puis relancer
+ * le générateur : aucune recopie manuelle à tenir à jour.
+ *
+ * Règles de syntaxe pour le générateur : une entrée par ligne, arguments littéraux,
+ * types entiers de <stdint.h> ou float.
+ */
+
+#ifndef INC_PROTO_DEF_H_
+#define INC_PROTO_DEF_H_
+
+#include <stdint.h>
+
+/**
+ * @name Version du protocole (REG_CAPS, trame de capacités)
+ * Majeure : changement incompatible des trames ou registres existants ; mineure :
+ * ajout compatible (registre, champ, type de trame).
+ * @{
+ */
+#define PROTO_VERSION_MAJOR     1u
+#define PROTO_VERSION_MINOR     11u
+#define PROTO_VERSION           ((PROTO_VERSION_MAJOR << 8) | PROTO_VERSION_MINOR)
+/** @} */
+
+/**
+ * @name Bits du champ link de la trame de capacités
+ * @{
+ */
+#define CAPS_LINK_FRAMED        0x01u   ///< Commandes avec octet de synchronisation et CRC (SERIAL_CMD_FRAMED).
+#define CAPS_LINK_SPI           0x02u   ///< Liaison SPI esclave vers l'hôte (SPI_LINK_ENABLE).
+#define CAPS_LINK_ENVELOPE      0x04u   ///< Réponses de registres enveloppées (type 0x0C, SERIAL_TX_ENVELOPE).
+#define CAPS_LINK_COBS          0x08u   ///< Flux montant encodé COBS, trames terminées par 0x00 (SERIAL_TX_COBS).
+#define CAPS_LINK_FW_UPDATE     0x10u   ///< Mise à jour du firmware par la liaison (REG_FW_UPDATE, FW_UPDATE_ENABLE).
+/** @} */
+
+/**
+ * @brief Types de trame émises par le firmware (octet 2 de l'entête).
+ * @details X(nom, code) : donne TELEM_TYPE_<nom>.
+ */
+#define PROTO_FRAME_TYPES(X)                                                    \
+    X(LEGACY,   0x01)   /* Télémétrie flottante (SerialImuFrame_t). */          \
+    X(FX,       0x02)   /* Télémétrie virgule fixe (SerialImuFrameFx_t). */     \
+    X(FIELDS,   0x03)   /* Télémétrie à contenu choisi (TELEM_F_*). */          \
+    X(COMPACT,  0x04)   /* Télémétrie compacte brute (SerialImuFrameCompact_t). */ \
+    X(DELTA,    0x05)   /* Lot d'échantillons en delta. */                      \
+    X(ECHO,     0x06)   /* Écho de REG_PING (SerialEchoFrame_t). */             \
+    X(BENCH,    0x07)   /* Résultat du banc de mesure (bench.h). */             \
+    X(LOG,      0x08)   /* Journal binaire différé (dlog.h). */                 \
+    X(HIST,     0x09)   /* Bloc de l'historique IMU (imu_hist.h). */            \
+    X(VIB,      0x0A)   /* Rapport vibratoire (vib.h). */                       \
+    X(CAPS,     0x0B)   /* Capacités du firmware (SerialCapsFrame_t). */        \
+    X(REG,      0x0C)   /* Réponse de lecture de registres (serial.h). */       \
+    X(HIST_PACKED, 0x0D) /* Bloc compressé de l'historique IMU (imu_hist.h). */ \
+    X(SNAP,     0x0E)   /* État instantané du véhicule (SerialSnapFrame_t). */  \
+    X(STATUS,   0x0F)   /* Flux d'état lent (disposition du type 0x03). */    \
+    X(FW,       0x10)   /* Acquittement de mise à jour (SerialFwFrame_t). */    \
+    X(FAULT,    0x11)   /* Relevé de faute persistant (SerialFaultFrame_t). */  \
+    X(BMIREG,   0x12)   /* Accès aux registres IMU (SerialBmiRegFrame_t). */
+
+/**
+ * @brief Champs de la trame à contenu choisi (type 0x03), dans l'ordre d'émission.
+ * @details X(nom, bit, longueur, format) : bit du masque TELEM_F_<nom>, longueur
+ * émise (octets) et format struct Python (little-endian) du champ.
+ */
+#define PROTO_TELEM_FIELDS(X)                                                   \
+    X(ACCEL,    0x01, 12, "3i")     /* Accélération X, Y, Z (mm/s²). */         \
+    X(GYRO,     0x02, 12, "3i")     /* Vitesse angulaire X, Y, Z (µrad/s). */   \
+    X(SPEED,    0x04,  2, "h")      /* Vitesse signée (mm/s). */                \
+    X(MOTOR,    0x08,  3, "hB")     /* Consigne moteur (mm/s) + MotorState_t. */ \
+    X(SERVO,    0x10,  1, "b")      /* Consigne servo (°). */                   \
+    X(TIMING,   0x20,  8, "II")     /* Latence commande max (µs) + IMU perdus. */ \
+    X(ATTITUDE, 0x40,  8, "4h")     /* Quaternion w, x, y, z (Q14). */          \
+    X(SENSOR,   0x80,  6, "Ih")     /* Horloge capteur (39,0625 µs/LSB) + température (c°C). */
+
+/**
+ * @name Dispositions des trames fixes
+ * F(type, nom) : champ scalaire ; A(type, nom, n) : tableau de n éléments.
+ * @{
+ */
+/** @brief Entête commune : synchronisation 0xAA 0x55, type, longueur du payload. */
+#define PROTO_HEADER(F, A)                                                      \
+    F(uint8_t,  head1)                                                          \
+    F(uint8_t,  head2)                                                          \
+    F(uint8_t,  type)                                                           \
+    F(uint8_t,  len)
+
+/** @brief Télémétrie flottante (type 0x01) : accélération mm/s², gyroscope rad/s, vitesse m/s. */
+#define PROTO_LAYOUT_LEGACY(F, A)                                               \
+    PROTO_HEADER(F, A)                                                          \
+    F(uint16_t, seq)                                                            \
+    F(uint32_t, timestamp)                                                      \
+    A(float,    accel, 3)                                                       \
+    A(float,    gyro, 3)                                                        \
+    F(float,    speed)                                                          \
+    F(uint8_t,  crc)
+
+/** @brief Télémétrie virgule fixe (type 0x02) : mm/s², µrad/s, mm/s. */
+#define PROTO_LAYOUT_FX(F, A)                                                   \
+    PROTO_HEADER(F, A)                                                          \
+    F(uint16_t, seq)                                                            \
+    F(uint32_t, timestamp)                                                      \
+    A(int32_t,  accel, 3)                                                       \
+    A(int32_t,  gyro, 3)                                                        \
+    F(int16_t,  speed)                                                          \
+    F(uint8_t,  crc)
+
+/** @brief Télémétrie compacte (type 0x04) : gammes BMI088 puis axes bruts (LSB), vitesse mm/s. */
+#define PROTO_LAYOUT_COMPACT(F, A)                                              \
+    PROTO_HEADER(F, A)                                                          \
+    F(uint16_t, seq)                                                            \
+    F(uint32_t, timestamp)                                                      \
+    F(uint8_t,  ranges)                                                         \
+    A(int16_t,  accel, 3)                                                       \
+    A(int16_t,  gyro, 3)                                                        \
+    F(int16_t,  speed)                                                          \
+    F(uint8_t,  crc)
+
+/** @brief Écho de REG_PING (type 0x06) : jeton puis dates µs de réception, validation, traitement, émission. */
+#define PROTO_LAYOUT_ECHO(F, A)                                                 \
+    PROTO_HEADER(F, A)                                                          \
+    F(uint16_t, token)                                                          \
+    F(uint32_t, t_rx)                                                           \
+    F(uint32_t, t_parse)                                                        \
+    F(uint32_t, t_app)                                                          \
+    F(uint32_t, t_tx)                                                           \
+    F(uint8_t,  crc)
+
+/**
+ * @brief Capacités du firmware (type 0x0B), réponse à une écriture de REG_CAPS.
+ * @details version : PROTO_VERSION ; types : bit n pour le type de trame n émis par ce
+ * build ; fields : masque TELEM_F_* disponible ; formats : bit n pour TELEM_FMT n ;
+ * cadences de télémétrie min/max (Hz) ; bauds : bit n pour SERIAL_BAUD_CODE n ;
+ * link : CAPS_LINK_* ; registres par trame groupée ; profondeur de la file de commandes ;
+ * tailles des rings RX/TX (octets) ; échantillons par lot delta.
+ */
+#define PROTO_LAYOUT_CAPS(F, A)                                                 \
+    PROTO_HEADER(F, A)                                                          \
+    F(uint16_t, version)                                                        \
+    F(uint16_t, types)                                                          \
+    F(uint8_t,  fields)                                                         \
+    F(uint8_t,  formats)                                                        \
+    F(uint16_t, rate_min_hz)                                                    \
+    F(uint16_t, rate_max_hz)                                                    \
+    F(uint8_t,  bauds)                                                          \
+    F(uint8_t,  link)                                                           \
+    F(uint8_t,  burst_max_regs)                                                 \
+    F(uint8_t,  cmd_queue_len)                                                  \
+    F(uint16_t, rx_ring)                                                        \
+    F(uint16_t, tx_ring)                                                        \
+    F(uint8_t,  batch_max)                                                      \
+    F(uint8_t,  crc)
+
+/**
+ * @brief État instantané du véhicule (type 0x0E), réponse à une écriture de REG_SNAPSHOT.
+ * @details jeton écrit ; date du relevé (µs) ; consigne servo (°) ; consigne moteur (mm/s) ;
+ * MotorState_t, sens appliqué (1 : avant) et consigne CCR de marche de l'ESC ; étape du
+ * failsafe ; vitesse mesurée (mm/s) ; numéro, date (µs), accélération (mm/s²) et
+ * gyroscope (µrad/s) du dernier échantillon IMU publié (numéro 0 : aucun).
+ */
+#define PROTO_LAYOUT_SNAP(F, A)                                                 \
+    PROTO_HEADER(F, A)                                                          \
+    F(uint16_t, token)                                                          \
+    F(uint32_t, t_us)                                                           \
+    F(int8_t,   servo_cmd)                                                      \
+    F(int16_t,  motor_cmd_mms)                                                  \
+    F(uint8_t,  motor_state)                                                    \
+    F(uint8_t,  go_forward)                                                     \
+    F(uint16_t, target_ticks)                                                   \
+    F(uint8_t,  fs_stage)                                                       \
+    F(int16_t,  speed_mms)                                                      \
+    F(uint32_t, imu_seq)                                                        \
+    F(uint32_t, imu_t_us)                                                       \
+    A(int32_t,  accel, 3)                                                       \
+    A(int32_t,  gyro, 3)                                                        \
+    F(uint8_t,  crc)
+
+/**
+ * @brief Acquittement de mise à jour du firmware (type 0x10), réponse à une écriture de REG_FW_UPDATE.
+ * @details opcode et argument de la commande (FW_OP_*, fw_update.h) ; statut FW_ST_* ;
+ * pages préparées ; CRC-32 de la page interrogée ou préparée.
+ */
+#define PROTO_LAYOUT_FW(F, A)                                                   \
+    PROTO_HEADER(F, A)                                                          \
+    F(uint8_t,  op)                                                             \
+    F(uint8_t,  status)                                                         \
+    F(uint16_t, arg)                                                            \
+    F(uint8_t,  staged)                                                         \
+    F(uint32_t, page_crc)                                                       \
+    F(uint8_t,  crc)
+
+/**
+ * @brief Relevé de faute persistant (type 0x11, fault_log.h), émis une fois après un
+ * redémarrage sur faute et à la demande (REG_FAULT).
+ * @details cause fault_cause_t ; tâche en cours (0xFF : hors tâche) ; fautes depuis la
+ * mise sous tension ; date (ms) ; passages de boucle ; r0-r3, r12, lr, pc, xpsr et pile
+ * (HardFault) ; compteurs de liaison (modulo 65536) au dernier rafraîchissement du chien de garde.
+ */
+#define PROTO_LAYOUT_FAULT(F, A)                                                \
+    PROTO_HEADER(F, A)                                                          \
+    F(uint8_t,  cause)                                                          \
+    F(uint8_t,  task)                                                           \
+    F(uint16_t, count)                                                          \
+    F(uint32_t, uptime_ms)                                                      \
+    F(uint32_t, loops)                                                          \
+    A(uint32_t, regs, 8)                                                        \
+    F(uint32_t, sp)                                                             \
+    F(uint16_t, rx_drop)                                                        \
+    F(uint16_t, tx_drop)                                                        \
+    F(uint16_t, rx_overrun)                                                     \
+    F(uint16_t, telem_seq)                                                      \
+    F(uint8_t,  crc)
+
+/**
+ * @brief Résultat d'un accès direct aux registres IMU (type 0x12), réponse à une écriture
+ * de REG_BMI bit 15 levé (driver_ins.h).
+ * @details Écriture (1) ou lecture (0) ; capteur (0 accéléromètre, 1 gyroscope) ;
+ * adresse ; octets lus ; code BMI08 (0 : succès) ; octets lus (relecture après écriture).
+ */
+#define PROTO_LAYOUT_BMIREG(F, A)                                               \
+    PROTO_HEADER(F, A)                                                          \
+    F(uint8_t,  write)                                                          \
+    F(uint8_t,  sensor)                                                         \
+    F(uint8_t,  addr)                                                           \
+    F(uint8_t,  count)                                                          \
+    F(int8_t,   status)                                                         \
+    A(uint8_t,  data, 16)                                                       \
+    F(uint8_t,  crc)
+/** @} */
+
+/**
+ * @brief Trames fixes : X(structure C, disposition, taille totale en octets).
+ * @details La disposition PROTO_LAYOUT_<nom> décrit la trame de type TELEM_TYPE_<nom>.
+ */
+#define PROTO_FIXED_FRAMES(X)                                                   \
+    X(SerialImuFrame_t,        LEGACY,  39)                                     \
+    X(SerialImuFrameFx_t,      FX,      37)                                     \
+    X(SerialImuFrameCompact_t, COMPACT, 26)                                     \
+    X(SerialEchoFrame_t,       ECHO,    23)                                     \
+    X(SerialCapsFrame_t,       CAPS,    24)                                     \
+    X(SerialSnapFrame_t,       SNAP,    53)                                     \
+    X(SerialFwFrame_t,         FW,      14)                                     \
+    X(SerialFaultFrame_t,      FAULT,   61)                                     \
+    X(SerialBmiRegFrame_t,     BMIREG,  26)
+
+/* ---------------------------------------------------------------------------
+ * Définitions tirées des listes
+ * ------------------------------------------------------------------------- */
+
+#define PROTO_X_TYPE_ENUM(name, code)           TELEM_TYPE_##name = (code),
+/** @brief Types de trame (TELEM_TYPE_*). */
+typedef enum{
+    PROTO_FRAME_TYPES(PROTO_X_TYPE_ENUM)
+} telem_type_t;
+
+#define PROTO_X_FIELD_ENUM(name, bit, len, fmt) TELEM_F_##name = (bit),
+/** @brief Bits du masque de la trame à contenu choisi (TELEM_F_*). */
+typedef enum{
+    PROTO_TELEM_FIELDS(PROTO_X_FIELD_ENUM)
+    TELEM_F_ALL = 0xFF                  ///< Tous les champs.
+} telem_field_t;
+
+#define PROTO_X_FIELD_LEN(name, bit, len, fmt)  + (len##u)
+/** @brief Longueur cumulée des champs TELEM_F_* (tous présents). */
+#define PROTO_TELEM_FIELDS_LEN  (0u PROTO_TELEM_FIELDS(PROTO_X_FIELD_LEN))
+
+#define PROTO_C_FIELD(type, name)               type name;
+#define PROTO_C_ARRAY(type, name, n)            type name[n];
+/** @brief Déclare la structure packed d'une disposition PROTO_LAYOUT_<layout>. */
+#define PROTO_STRUCT(layout)                                                    \
+    struct __attribute__((packed)) { PROTO_LAYOUT_##layout(PROTO_C_FIELD, PROTO_C_ARRAY) }
+
+#define PROTO_X_FIXED_ASSERT(st, layout, size)                                  \
+    _Static_assert(sizeof(st) == (size), #st " does not match PROTO_FIXED_FRAMES");
+/** @brief Vérifie à la compilation la taille de chaque trame fixe (après les typedef). */
+#define PROTO_ASSERT_FIXED_FRAMES()     PROTO_FIXED_FRAMES(PROTO_X_FIXED_ASSERT)
+
+#endif /* INC_PROTO_DEF_H_ */
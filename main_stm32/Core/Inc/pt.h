@@ -0,0 +1,118 @@
+/**
+ * @file    pt.h
+ * @brief   Protothreads : séquences multi-étapes sans pile, déroulées par la boucle principale.
+ * @details Une protothread est une fonction réentrante dont le point de reprise est
+ * mémorisé dans un pt_t (numéro de ligne, switch de Duff). Chaque appel reprend
+ * l'exécution après la dernière attente et rend la main à la suivante : une séquence
+ * SPI avec délais capteurs s'écrit comme du code linéaire au lieu d'une énumération
+ * d'états et d'une échéance tenues à la main. Les attentes datées posent wake_us,
+ * que l'appelant confie à l'ordonnanceur (sched_set_release()) :
+ *
+ * @code
+ * static int seq_thread(pt_t *pt, uint64_t now_us){
+ *     PT_BEGIN(pt);
+ *     reset_sensor();
+ *     PT_SLEEP_US(pt, now_us, 1000u);      // reprise 1 ms plus tard
+ *     configure_sensor();
+ *     PT_WAIT_UNTIL(pt, sensor_ready());   // reprise à chaque appel jusqu'à vrai
+ *     PT_END(pt);
+ * }
+ *
+ * if(now_us >= pt.wake_us && seq_thread(&pt, now_us) == PT_ENDED){ ... }
+ * @endcode
+ *
+ * Restrictions : les variables locales ne survivent pas à une attente (les garder
+ * en static ou dans une structure de contexte) ; pas de switch dans le corps d'une
+ * protothread ; une seule attente par ligne.
+ */
+
+#ifndef INC_PT_H_
+#define INC_PT_H_
+
+#include <stdint.h>
+
+/**
+ * @brief État d'une protothread.
+ */
+typedef struct{
+    uint16_t lc;                ///< Point de reprise (numéro de ligne, 0 : début).
+    uint64_t wake_us;           ///< Date de reprise demandée par la dernière attente datée (µs).
+} pt_t;
+
+/**
+ * @brief Valeurs rendues par une protothread.
+ */
+typedef enum{
+    PT_WAITING = 0,             ///< Bloquée sur une condition ou une échéance.
+    PT_YIELDED,                 ///< A rendu la main, à reprendre au prochain passage.
+    PT_ENDED                    ///< Terminée (repart du début au prochain appel).
+} pt_status_t;
+
+/** @brief Initialisation statique. */
+#define PT_STATIC_INIT          { 0u, 0u }
+
+/** @brief (Re)place une protothread à son début, sans échéance. */
+#define PT_INIT(pt)             do{ (pt)->lc = 0u; (pt)->wake_us = 0u; }while(0)
+
+/** @brief Ouvre le corps d'une protothread. */
+#define PT_BEGIN(pt)            switch((pt)->lc){ case 0u:
+
+/** @brief Ferme le corps : la protothread est terminée et réinitialisée. */
+#define PT_END(pt)              } PT_INIT(pt); return PT_ENDED
+
+/** @brief Attend qu'une condition soit vraie (réévaluée à chaque appel). */
+#define PT_WAIT_UNTIL(pt, cond)                                                 \
+    do{                                                                         \
+        (pt)->lc = (uint16_t)__LINE__;                                          \
+        case __LINE__:                                                          \
+        if(!(cond)){                                                            \
+            return PT_WAITING;                                                  \
+        }                                                                       \
+    }while(0)
+
+/** @brief Rend la main une fois ; l'exécution reprend à l'appel suivant. */
+#define PT_YIELD(pt)                                                            \
+    do{                                                                         \
+        (pt)->lc = (uint16_t)__LINE__;                                          \
+        return PT_YIELDED;                                                      \
+        case __LINE__:;                                                         \
+    }while(0)
+
+/**
+ * @brief  Attend une date absolue.
+ * @param  pt     Protothread.
+ * @param  now_us Paramètre « date courante » de la protothread (réévalué à chaque appel).
+ * @param  t_us   Date de reprise (µs).
+ */
+#define PT_SLEEP_UNTIL(pt, now_us, t_us)                                        \
+    do{                                                                         \
+        (pt)->wake_us = (t_us);                                                 \
+        PT_WAIT_UNTIL(pt, (now_us) >= (pt)->wake_us);                           \
+    }while(0)
+
+/** @brief Attend `us` microsecondes à partir de la date courante. */
+#define PT_SLEEP_US(pt, now_us, us)     PT_SLEEP_UNTIL(pt, now_us, (now_us) + (us))
+
+/**
+ * @brief  Abandonne l'exécution et repart du début à une date donnée.
+ * @param  pt   Protothread.
+ * @param  t_us Date de reprise (µs) : l'appelant ne doit pas rappeler la protothread avant.
+ */
+#define PT_RESTART_AT(pt, t_us)                                                 \
+    do{                                                                         \
+        (pt)->lc = 0u;                                                          \
+        (pt)->wake_us = (t_us);                                                 \
+        return PT_WAITING;                                                      \
+    }while(0)
+
+/**
+ * @brief  Date à laquelle rappeler une protothread qui n'est pas terminée.
+ * @param  pt     Protothread.
+ * @param  now_us Date courante (µs).
+ * @return wake_us si l'attente datée court encore, now_us sinon (prochain passage).
+ */
+static inline uint64_t pt_next_us(const pt_t *pt, uint64_t now_us){
+    return (pt->wake_us > now_us) ? pt->wake_us : now_us;
+}
+
+#endif /* INC_PT_H_ */
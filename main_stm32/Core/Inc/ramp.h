@@ -0,0 +1,82 @@
+/**
+ * @file    ramp.h
+ * @brief   Générateur de profil de consigne à variation et dérivée de variation bornées.
+ * @details Une instance par actionneur, avancée d'un pas par tick moteur de 1 ms : la
+ * sortie rejoint la consigne visée avec une variation par tick bornée (vitesse de
+ * braquage, accélération) et une évolution de cette variation bornée (accélération
+ * angulaire, jerk). Le profil freine à temps pour atteindre la consigne sans la
+ * dépasser : l'hôte peut n'envoyer que des consignes espacées, le firmware interpole.
+ *
+ * Calcul en virgule fixe Q16 (unités de la consigne : mm/s, centi-degrés). Limites
+ * nulles : la borne correspondante est inactive ; les deux nulles, la sortie saute
+ * sur la consigne au tick suivant.
+ */
+
+#ifndef INC_RAMP_H_
+#define INC_RAMP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief État d'un profil de consigne.
+ */
+typedef struct{
+    int32_t  pos_q16;       ///< Sortie courante (unités, Q16).
+    int32_t  rate_q16;      ///< Variation appliquée au dernier tick (unités par tick, Q16).
+    volatile int32_t target_q16; ///< Consigne visée (unités, Q16).
+    uint32_t rate_max_q16;  ///< Variation maximale par tick (Q16), 0 = sans borne.
+    uint32_t acc_max_q16;   ///< Évolution maximale de la variation par tick (Q16), 0 = sans borne.
+} ramp_t;
+
+/**
+ * @brief  Règle les bornes du profil (la sortie courante est conservée).
+ * @param  ramp         Profil.
+ * @param  rate_max_q16 Variation maximale par tick (Q16), 0 = sans borne.
+ * @param  acc_max_q16  Évolution maximale de la variation par tick (Q16), 0 = sans borne.
+ */
+void ramp_set_limits(ramp_t *ramp, uint32_t rate_max_q16, uint32_t acc_max_q16);
+
+/**
+ * @brief  Change la consigne visée, rejointe par ramp_tick().
+ * @param  ramp   Profil.
+ * @param  target Consigne (unités).
+ */
+void ramp_set_target(ramp_t *ramp, int16_t target);
+
+/**
+ * @brief  Place la sortie sur une valeur, à l'arrêt (consigne comprise).
+ * @param  ramp  Profil.
+ * @param  value Valeur (unités).
+ */
+void ramp_jump(ramp_t *ramp, int16_t value);
+
+/**
+ * @brief  Fait avancer le profil d'un pas (tick de 1 ms).
+ * @param  ramp Profil.
+ * @return true si la consigne visée n'est pas encore atteinte.
+ */
+bool ramp_tick(ramp_t *ramp);
+
+/**
+ * @brief  Indique si la sortie est en mouvement ou distincte de la consigne.
+ * @param  ramp Profil.
+ * @return true si ramp_tick() a du travail.
+ */
+bool ramp_busy(const ramp_t *ramp);
+
+/**
+ * @brief  Indique si au moins une borne est active.
+ * @param  ramp Profil.
+ * @return false si la sortie suit la consigne sans profil.
+ */
+bool ramp_limited(const ramp_t *ramp);
+
+/**
+ * @brief  Sortie courante arrondie.
+ * @param  ramp Profil.
+ * @return Sortie (unités).
+ */
+int16_t ramp_output(const ramp_t *ramp);
+
+#endif /* INC_RAMP_H_ */
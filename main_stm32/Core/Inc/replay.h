@@ -0,0 +1,110 @@
+/**
+ * @file    replay.h
+ * @brief   Rejeu de mesures enregistrées : banc de mesure déterministe sur cible.
+ * @details En mode rejeu, les acquisitions IMU sont suspendues et la vitesse
+ * tachymètre ignorée : l'hôte renvoie un enregistrement (trames compactes ou delta)
+ * sous forme de trames groupées vers REG_REPLAY, injectées dans la file IMU et à la
+ * place de la vitesse mesurée. Estimateurs, filtres et boucle de vitesse voient ainsi
+ * exactement les mêmes entrées d'une mesure à l'autre : débits et latences (REG_PROF_*)
+ * deviennent comparables.
+ *
+ * Enregistrement (trame groupée de REPLAY_REC_REGS registres à partir de REG_REPLAY) :
+ * [DT_US | AX | AY | AZ | GX | GY | GZ | SPEED_MMS] ; DT_US : écart avec l'échantillon
+ * précédent (µs), axes en LSB (gammes configurées identiques à celles de
+ * l'enregistrement), vitesse en mm/s. La date du premier échantillon est celle du
+ * démarrage du rejeu.
+ *
+ * Source synthétique (REPLAY_CMD_SYNTH, banc de débit de la liaison) : la tâche IMU
+ * injecte à chaque libération, à sa cadence (REG_IMU_RATE), un échantillon déterministe
+ * au lieu de lancer une acquisition. Le n-ième est daté t0 + n x période (grille exacte :
+ * l'hôte compte les pertes sur les dates, quel que soit le format) ; AX = n (16 bits
+ * bas), AY = n >> 16, AZ = REPLAY_SYNTH_AZ, gyroscope en dents de scie lentes (format
+ * delta représentatif). Format, lots, débit et cadence d'émission restent ceux des
+ * registres de télémétrie : le flux emprunte exactement le chemin des mesures réelles.
+ */
+
+#ifndef INC_REPLAY_H_
+#define INC_REPLAY_H_
+
+#include <stdint.h>
+
+/** @brief Rejeu disponible (1) ou absent (0, REG_REPLAY sans effet). */
+#ifndef REPLAY_ENABLE
+#define REPLAY_ENABLE           1
+#endif
+
+/** @brief Registres par enregistrement injecté (une trame groupée pleine). */
+#define REPLAY_REC_REGS         8u
+
+/**
+ * @brief Commandes écrites dans REG_REPLAY.
+ */
+typedef enum{
+    REPLAY_CMD_STOP = 0,    ///< Quitte le rejeu, acquisitions et tachymètre repris.
+    REPLAY_CMD_START,       ///< Entre en rejeu (compteur d'injection remis à zéro).
+    REPLAY_CMD_SYNTH        ///< Source synthétique à la cadence de la tâche IMU.
+} replay_cmd_t;
+
+/** @brief Accélération Z des échantillons synthétiques (LSB, ~1 g à ±6 g). */
+#define REPLAY_SYNTH_AZ         5461
+/** @brief Période des dents de scie du gyroscope synthétique (échantillons, puissance de 2). */
+#define REPLAY_SYNTH_SAW        256u
+
+#if REPLAY_ENABLE
+/**
+ * @brief  Applique une commande du rejeu.
+ * @param  cmd Commande (replay_cmd_t).
+ */
+void replay_command(uint8_t cmd);
+
+/**
+ * @brief  Injecte un enregistrement reçu (boucle principale, parseur).
+ * @details Ignoré hors rejeu ou si la longueur n'est pas REPLAY_REC_REGS.
+ * @param  data  Valeurs little-endian (2 octets par registre).
+ * @param  count Nombre de registres.
+ */
+void replay_push(const uint8_t *data, uint8_t count);
+
+/**
+ * @brief  Indique si le rejeu est actif.
+ * @return 1 en rejeu, 0 sinon.
+ */
+uint8_t replay_active(void);
+
+/**
+ * @brief  Vitesse du dernier enregistrement injecté.
+ * @return Vitesse (mm/s, signée).
+ */
+int16_t replay_speed_mms(void);
+
+/**
+ * @brief  Échantillons publiés dans la file depuis REPLAY_CMD_START ou REPLAY_CMD_SYNTH.
+ * @return Compteur d'injection.
+ */
+uint32_t replay_count(void);
+
+/**
+ * @brief  Indique si la source synthétique est active.
+ * @return 1 si REPLAY_CMD_SYNTH, 0 sinon.
+ */
+uint8_t replay_synth_active(void);
+
+/**
+ * @brief  Injecte l'échantillon synthétique suivant (tâche IMU, à chaque libération).
+ * @details Une période différente de la précédente (REG_IMU_RATE modifié) recommence
+ * la grille de dates à now_us.
+ * @param  now_us    Date de la libération (µs).
+ * @param  period_us Période de la tâche IMU (µs).
+ */
+void replay_synth_tick(uint64_t now_us, uint32_t period_us);
+#else
+static inline void replay_command(uint8_t cmd){ (void)cmd; }
+static inline void replay_push(const uint8_t *data, uint8_t count){ (void)data; (void)count; }
+static inline uint8_t replay_active(void){ return 0u; }
+static inline int16_t replay_speed_mms(void){ return 0; }
+static inline uint32_t replay_count(void){ return 0u; }
+static inline uint8_t replay_synth_active(void){ return 0u; }
+static inline void replay_synth_tick(uint64_t now_us, uint32_t period_us){ (void)now_us; (void)period_us; }
+#endif
+
+#endif /* INC_REPLAY_H_ */
@@ -0,0 +1,100 @@
+/**
+ * @file    rice.h
+ * @brief   Codage de Rice des résidus signés (blocs d'échantillons, sans perte).
+ * @details Le résidu (différence avec l'échantillon précédent) est replié en entier
+ * non signé par zig-zag (0, -1, 1, -2... -> 0, 1, 2, 3...), puis codé en Rice de
+ * paramètre k : quotient v >> k en unaire (q bits à 1, un 0), reste sur k bits. Un
+ * quotient supérieur ou égal à RICE_ESCAPE est remplacé par RICE_ESCAPE bits à 1
+ * suivis de la valeur brute sur 32 bits. Bits rangés poids faible d'abord dans chaque
+ * octet. Uniquement décalages et masques : rien à multiplier ni à diviser sur le M0+.
+ */
+
+#ifndef INC_RICE_H_
+#define INC_RICE_H_
+
+#include <stdint.h>
+
+/** @brief Quotient à partir duquel la valeur est émise brute. */
+#define RICE_ESCAPE             15u
+/** @brief Paramètre k maximal. */
+#define RICE_K_MAX              16u
+/** @brief Taille maximale d'une valeur codée (bits, échappement). */
+#define RICE_MAX_BITS           (RICE_ESCAPE + 32u)
+
+/**
+ * @brief Écriture d'un flux de bits dans un tampon.
+ */
+typedef struct{
+    uint8_t *buf;               ///< Tampon de sortie.
+    uint16_t pos;               ///< Octets complets écrits.
+    uint8_t nacc;               ///< Bits en attente dans acc (0..7 entre deux appels).
+    uint32_t acc;               ///< Bits en attente, poids faible d'abord.
+} rice_writer_t;
+
+/**
+ * @brief  Repli zig-zag d'un résidu signé.
+ * @param  d Résidu.
+ * @return 2d si d >= 0, -2d - 1 sinon.
+ */
+static inline uint32_t rice_zigzag(int32_t d){
+    return ((uint32_t)d << 1) ^ (uint32_t)(d >> 31);
+}
+
+/**
+ * @brief  Paramètre k adapté à une somme de valeurs repliées.
+ * @param  sum Somme des valeurs.
+ * @param  n   Nombre de valeurs.
+ * @return Plus petit k tel que n << k >= sum (moyenne au plus 2^k), borné à RICE_K_MAX.
+ */
+static inline uint8_t rice_choose_k(uint32_t sum, uint32_t n){
+    uint8_t k = 0;
+    while(k < RICE_K_MAX && (n << k) < sum){
+        k++;
+    }
+    return k;
+}
+
+/**
+ * @brief  Démarre un flux.
+ * @param  w   Flux.
+ * @param  buf Tampon de sortie.
+ */
+static inline void rice_begin(rice_writer_t *w, uint8_t *buf){
+    w->buf  = buf;
+    w->pos  = 0;
+    w->nacc = 0;
+    w->acc  = 0;
+}
+
+/**
+ * @brief  Ajoute une valeur codée en Rice.
+ * @param  w Flux.
+ * @param  v Valeur repliée (rice_zigzag).
+ * @param  k Paramètre (0..RICE_K_MAX).
+ */
+void rice_put(rice_writer_t *w, uint32_t v, uint8_t k);
+
+/**
+ * @brief  Position courante du flux, pour annuler les dernières valeurs.
+ * @param  w Flux.
+ * @return Nombre de bits écrits.
+ */
+static inline uint32_t rice_bits(const rice_writer_t *w){
+    return ((uint32_t)w->pos << 3) + w->nacc;
+}
+
+/**
+ * @brief  Ramène le flux à une position relevée par rice_bits().
+ * @param  w    Flux.
+ * @param  bits Position.
+ */
+void rice_rewind(rice_writer_t *w, uint32_t bits);
+
+/**
+ * @brief  Termine le flux (dernier octet complété de zéros).
+ * @param  w Flux.
+ * @return Longueur du flux (octets).
+ */
+uint16_t rice_end(rice_writer_t *w);
+
+#endif /* INC_RICE_H_ */
@@ -0,0 +1,86 @@
+/**
+ * @file    rtt.h
+ * @brief   Journal en RAM lu par la sonde SWD pendant l'exécution (format SEGGER RTT).
+ * @details Un bloc de contrôle placé en tête de la section .rtt (voir les scripts de
+ * liens, symbole _srtt) décrit des anneaux montants (cible -> sonde) et descendants
+ * (sonde -> cible). La sonde le retrouve par son identifiant "SEGGER RTT" et lit ou
+ * écrit les anneaux en accès mémoire, cœur en marche : J-Link RTT Viewer, OpenOCD
+ * (rtt setup / rtt server), probe-rs.
+ *
+ * - Voie montante RTT_CH_TERMINAL : sortie standard (printf() via _write()), qui ne
+ *   passe plus par l'USART2 ni ne retarde la télémétrie.
+ * - Voie montante RTT_CH_DLOG : trames type 0x08 du journal binaire quand DLOG_RTT
+ *   vaut 1 (dlog.h), au même format que sur la liaison série (LOG_FORMATS de
+ *   serial_reg.py).
+ * - Voie descendante RTT_CH_TERMINAL : octets envoyés depuis la sonde (rtt_read()).
+ *
+ * Écritures non bloquantes : sans sonde connectée, un anneau plein tronque (terminal)
+ * ou rejette (journal) les données au lieu d'attendre.
+ */
+
+#ifndef INC_RTT_H_
+#define INC_RTT_H_
+
+#include <stdint.h>
+
+/** @brief Bloc RTT présent (1) ou absent (0, sortie standard sur l'USART2). */
+#ifndef RTT_ENABLE
+#define RTT_ENABLE              1
+#endif
+
+/** @brief Taille de l'anneau montant du terminal (octets). */
+#ifndef RTT_TERMINAL_UP_SIZE
+#define RTT_TERMINAL_UP_SIZE    1024u
+#endif
+
+/** @brief Taille de l'anneau montant du journal binaire (octets). */
+#ifndef RTT_DLOG_UP_SIZE
+#define RTT_DLOG_UP_SIZE        1024u
+#endif
+
+/** @brief Taille de l'anneau descendant du terminal (octets). */
+#ifndef RTT_TERMINAL_DOWN_SIZE
+#define RTT_TERMINAL_DOWN_SIZE  16u
+#endif
+
+/**
+ * @brief Voies montantes.
+ */
+typedef enum{
+    RTT_CH_TERMINAL = 0,    ///< Texte (sortie standard).
+    RTT_CH_DLOG,            ///< Trames binaires du journal.
+    RTT_CH_COUNT
+} rtt_channel_t;
+
+#if RTT_ENABLE
+/**
+ * @brief  Initialise le bloc de contrôle ; l'identifiant est écrit en dernier.
+ * @note   À appeler avant toute écriture (sortie standard comprise).
+ */
+void rtt_init(void);
+
+/**
+ * @brief  Écrit dans une voie montante, sans attente (tout contexte).
+ * @details RTT_CH_TERMINAL tronque à la place libre ; RTT_CH_DLOG n'écrit que si tout
+ * tient, une trame n'étant jamais coupée.
+ * @param  ch   Voie (rtt_channel_t).
+ * @param  data Données.
+ * @param  len  Longueur (octets).
+ * @return Octets écrits.
+ */
+uint32_t rtt_write(uint8_t ch, const void *data, uint32_t len);
+
+/**
+ * @brief  Lit les octets envoyés par la sonde sur la voie descendante.
+ * @param  data Destination.
+ * @param  len  Taille de la destination (octets).
+ * @return Octets lus (0 si rien en attente).
+ */
+uint32_t rtt_read(void *data, uint32_t len);
+#else
+static inline void rtt_init(void){}
+static inline uint32_t rtt_write(uint8_t ch, const void *data, uint32_t len){ (void)ch; (void)data; (void)len; return 0u; }
+static inline uint32_t rtt_read(void *data, uint32_t len){ (void)data; (void)len; return 0u; }
+#endif
+
+#endif /* INC_RTT_H_ */
@@ -0,0 +1,183 @@
+/**
+ * @file    scheduler.h
+ * @brief   Ordonnanceur coopératif à échéances absolues.
+ * @details Les tâches sont décrites par une table (période, phase, priorité, callback).
+ * Chaque libération est calée sur l'échéance théorique précédente et non sur la date
+ * d'exécution réelle : la phase ne dérive pas quand la boucle principale prend du retard.
+ * Une tâche événementielle fixe elle-même sa prochaine libération (sched_set_release()),
+ * et peut être réveillée par un événement avant cette échéance.
+ *
+ * Build SCHED_RTOS=1 : la même table est exécutée par FreeRTOS, une tâche noyau par
+ * entrée (priorité noyau déduite du champ priority), plus une tâche de scrutation de
+ * plus basse priorité pour le travail hors table (commandes, failsafe). Les tâches
+ * dorment jusqu'à leur échéance ou jusqu'à une notification (sched_set_release(),
+ * sched_wake_from_isr()) ; l'API et les statistiques (retard, durée, overruns) sont
+ * identiques, ce qui permet de comparer les latences des deux builds.
+ */
+
+#ifndef INC_SCHEDULER_H_
+#define INC_SCHEDULER_H_
+
+#include <stdint.h>
+#include "profiler.h"
+
+/** @brief Nombre maximal de tâches dans une table (masque d'exécution 32 bits). */
+#define SCHED_MAX_TASKS     32u
+
+/**
+ * @brief Exécution de la table par FreeRTOS (1) ou par la boucle coopérative (0).
+ * @details Mode 1 : nécessite le middleware FreeRTOS de CubeMX (allocation statique,
+ * base de temps HAL sur un timer, SysTick laissé au noyau). Un verrou global à
+ * héritage de priorité sérialise les exécutions : le code applicatif garde les
+ * hypothèses du mode coopératif, seul l'ordre de passage et le réveil changent.
+ */
+#ifndef SCHED_RTOS
+#define SCHED_RTOS          0
+#endif
+
+#if SCHED_RTOS
+/** @brief Nombre maximal de tâches noyau créées pour la table. */
+#ifndef SCHED_RTOS_MAX_TASKS
+#define SCHED_RTOS_MAX_TASKS    8u
+#endif
+/** @brief Pile de chaque tâche noyau (mots de 32 bits). */
+#ifndef SCHED_RTOS_STACK_WORDS
+#define SCHED_RTOS_STACK_WORDS  256u
+#endif
+/** @brief Attente maximale des tâches de fond et de scrutation sans notification (ms). */
+#ifndef SCHED_RTOS_POLL_MS
+#define SCHED_RTOS_POLL_MS      5u
+#endif
+#endif
+
+/**
+ * @brief  Callback d'une tâche ordonnancée.
+ * @param  now_us Date de début d'exécution (µs, GetMicros64).
+ */
+typedef void (*sched_fn_t)(uint64_t now_us);
+
+/**
+ * @brief Descripteur et état d'une tâche ordonnancée.
+ * @note  Les champs de configuration sont renseignés dans la table de l'application ;
+ * les champs d'état sont gérés par l'ordonnanceur.
+ */
+typedef struct {
+    /* Configuration */
+    const char *name;           ///< Nom de la tâche (diagnostic).
+    uint32_t    period_us;      ///< Période (µs), 0 = exécutée à chaque passage.
+    uint32_t    phase_us;       ///< Décalage de la première libération (µs).
+    uint8_t     priority;       ///< Priorité (0 = la plus haute) entre tâches échues.
+    sched_fn_t  fn;             ///< Callback de la tâche.
+
+    /* État */
+    uint64_t next_release_us;   ///< Échéance de la prochaine libération (µs).
+    uint8_t  rescheduled;       ///< Libération fixée par sched_set_release() pendant l'exécution.
+    uint32_t runs;              ///< Nombre d'exécutions.
+    uint32_t overruns;          ///< Libérations manquées (tâche non exécutée avant la suivante).
+    prof_stat_t late;           ///< Profil du retard entre libération et exécution (gigue, µs).
+    uint32_t exec_last_us;      ///< Durée de la dernière exécution (µs).
+    prof_stat_t exec;           ///< Profil des durées d'exécution (min/moyenne/max, histogramme).
+} sched_task_t;
+
+/**
+ * @brief  Initialise l'ordonnanceur avec la table de tâches de l'application.
+ * @param  tasks  Table de tâches (doit rester valide).
+ * @param  count  Nombre de tâches.
+ * @param  now_us Date de référence des phases (µs).
+ */
+void sched_init(sched_task_t *tasks, uint8_t count, uint64_t now_us);
+
+/**
+ * @brief  Exécute les tâches échues, par ordre de priorité.
+ * @param  now_us Date courante (µs).
+ */
+void sched_run(uint64_t now_us);
+
+/**
+ * @brief  Modifie la période d'une tâche.
+ * @note   La prochaine échéance est conservée ; la nouvelle période s'applique ensuite.
+ * @param  id        Index de la tâche dans la table.
+ * @param  period_us Nouvelle période (µs).
+ */
+void sched_set_period(uint8_t id, uint32_t period_us);
+
+/**
+ * @brief  Fixe la prochaine libération d'une tâche.
+ * @details Appelée par la tâche elle-même, remplace le calcul périodique de l'échéance
+ * suivante (UINT64_MAX : tâche en sommeil jusqu'au prochain réveil). Appelée ailleurs
+ * (événement), avance ou repousse la libération en attente.
+ * @param  id         Index de la tâche dans la table.
+ * @param  release_us Date de libération absolue (µs).
+ */
+void sched_set_release(uint8_t id, uint64_t release_us);
+
+/**
+ * @brief  Donne accès à l'état d'une tâche (statistiques).
+ * @param  id Index de la tâche dans la table.
+ * @return Pointeur vers la tâche, NULL si l'index est invalide.
+ */
+const sched_task_t *sched_get_task(uint8_t id);
+
+/**
+ * @brief  Nombre de tâches de la table.
+ * @return Nombre de tâches ordonnancées.
+ */
+uint8_t sched_task_count(void);
+
+/**
+ * @brief  Remet à zéro les statistiques de toutes les tâches.
+ */
+void sched_reset_stats(void);
+
+/** @brief Fenêtre de mesure du taux d'inactivité (µs). */
+#define SCHED_IDLE_WINDOW_US    1000000u
+
+/**
+ * @brief  Prochaine échéance parmi les tâches périodiques.
+ * @note   Les tâches de fond (période nulle) sont ignorées : c'est à l'appelant de
+ * vérifier qu'elles n'ont rien à traiter avant de dormir.
+ * @return Échéance absolue (µs), UINT64_MAX si aucune tâche périodique.
+ */
+uint64_t sched_next_deadline(void);
+
+/**
+ * @brief  Recale les libérations échues après une période hors ordonnanceur (veille STOP).
+ * @details Chaque tâche en retard repart à now_us plus sa phase, sans que les
+ * libérations sautées soient comptées en overrun. Les tâches en sommeil (UINT64_MAX)
+ * ou à échéance future sont laissées telles quelles.
+ * @param  now_us Date courante (µs).
+ */
+void sched_resume(uint64_t now_us);
+
+/**
+ * @brief  Comptabilise une période d'inactivité (veille).
+ * @param  idle_us Durée passée en veille (µs).
+ */
+void sched_account_idle(uint32_t idle_us);
+
+/**
+ * @brief  Taux d'inactivité mesuré sur la dernière fenêtre complète.
+ * @return Part du temps passée en veille (%, 0..100) : marge CPU disponible.
+ */
+uint8_t sched_idle_percent(void);
+
+#if SCHED_RTOS
+/**
+ * @brief  Crée une tâche noyau par entrée de la table et démarre FreeRTOS (sans retour).
+ * @param  poll_fn Travail hors table, exécuté par la tâche de plus basse priorité à
+ * chaque réveil (notification ou SCHED_RTOS_POLL_MS).
+ */
+void sched_rtos_start(sched_fn_t poll_fn);
+
+/**
+ * @brief  Réveille la tâche de scrutation et les tâches de fond (contexte interruption).
+ * @note   À appeler en fin d'interruption produisant du travail (trame reçue,
+ * échantillon publié).
+ */
+void sched_wake_from_isr(void);
+#else
+/** @brief Sans effet en mode coopératif : l'interruption sort déjà la boucle de WFI. */
+static inline void sched_wake_from_isr(void){}
+#endif
+
+#endif /* INC_SCHEDULER_H_ */
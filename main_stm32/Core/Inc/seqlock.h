@@ -0,0 +1,96 @@
+/**
+ * @file    seqlock.h
+ * @brief   Verrou de séquence : publication d'un état multi-mots sans masquer les interruptions.
+ * @details L'écrivain incrémente le compteur avant et après sa mise à jour : impair
+ * pendant l'écriture, pair sinon. Le lecteur copie l'état entre deux lectures du
+ * compteur et recommence si celui-ci était impair ou a changé. Le lecteur n'écrit
+ * rien : plusieurs lecteurs peuvent coexister, sans section critique.
+ *
+ * Utilisation :
+ * @code
+ * seqlock_write_begin(&lock);          // producteur (interruption)
+ * state = new_state;
+ * seqlock_write_end(&lock);
+ *
+ * uint32_t s;                          // consommateur (boucle principale)
+ * do{
+ *     s = seqlock_read_begin(&lock);
+ *     copy = state;
+ * }
+ * while(seqlock_read_retry(&lock, s));
+ * @endcode
+ *
+ * L'écrivain doit être unique et ne jamais être interrompu par un lecteur (sinon le
+ * lecteur boucle sur un compteur impair) : production en interruption, lecture dans
+ * la boucle principale ou une interruption moins prioritaire. Dans l'autre sens
+ * (boucle principale vers interruption), garder une boîte aux lettres d'un mot ou une
+ * section critique courte.
+ */
+
+#ifndef INC_SEQLOCK_H_
+#define INC_SEQLOCK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stm32g0xx.h"
+
+/**
+ * @brief Compteur de séquence (pair : état stable).
+ */
+typedef struct{
+    volatile uint32_t seq;      ///< Deux incréments par publication.
+} seqlock_t;
+
+/** @brief Initialisation statique. */
+#define SEQLOCK_INIT            { 0u }
+
+/**
+ * @brief  Ouvre une mise à jour (compteur impair).
+ * @param  lock Verrou.
+ */
+static inline void seqlock_write_begin(seqlock_t *lock){
+    lock->seq = lock->seq + 1u;
+    __DMB();
+}
+
+/**
+ * @brief  Ferme une mise à jour (compteur pair).
+ * @param  lock Verrou.
+ */
+static inline void seqlock_write_end(seqlock_t *lock){
+    __DMB();
+    lock->seq = lock->seq + 1u;
+}
+
+/**
+ * @brief  Relève le compteur avant la copie.
+ * @param  lock Verrou.
+ * @return Compteur à passer à seqlock_read_retry().
+ */
+static inline uint32_t seqlock_read_begin(const seqlock_t *lock){
+    const uint32_t s = lock->seq;
+    __DMB();
+    return s;
+}
+
+/**
+ * @brief  Indique si la copie doit être recommencée.
+ * @param  lock Verrou.
+ * @param  s    Compteur rendu par seqlock_read_begin().
+ * @return true si une mise à jour était en cours ou a eu lieu pendant la copie.
+ */
+static inline bool seqlock_read_retry(const seqlock_t *lock, uint32_t s){
+    __DMB();
+    return ((s & 1u) != 0u) || (lock->seq != s);
+}
+
+/**
+ * @brief  Nombre de publications correspondant à un compteur relevé.
+ * @param  s Compteur rendu par seqlock_read_begin() (copie validée).
+ * @return Publications depuis l'initialisation.
+ */
+static inline uint32_t seqlock_count(uint32_t s){
+    return s >> 1;
+}
+
+#endif /* INC_SEQLOCK_H_ */
@@ -15,21 +15,214 @@
 
 /* ---------- CONFIGURATION HARDWARE & BUFFERS ---------- */
 
-/** @brief Taille du buffer circulaire logiciel de réception (Doit être une puissance de 2). */
+/**
+ * @brief Taille du buffer circulaire logiciel de réception (Doit être une puissance de 2).
+ * @note  Surchargeable par profil de build (-DSERIAL_RX_RING_SIZE=...), à dimensionner
+ * d'après REG_STAT_RX_HWM pour les débits élevés.
+ */
+#ifndef SERIAL_RX_RING_SIZE
 #define SERIAL_RX_RING_SIZE   1024u
+#endif
+
+/**
+ * @brief Taille du buffer circulaire d'émission (Doit être une puissance de 2).
+ * @note  Surchargeable par profil de build, à dimensionner d'après REG_STAT_TX_HWM.
+ */
+#ifndef SERIAL_TX_RING_SIZE
+#define SERIAL_TX_RING_SIZE   1024u
+#endif
+
+/**
+ * @brief Réception "zero-copy" (1) : le DMA circulaire écrit directement dans le ring RX
+ * et l'index producteur est déduit du compteur NDTR. (0) : copie octet par octet en interruption.
+ */
+#ifndef SERIAL_RX_ZERO_COPY
+#define SERIAL_RX_ZERO_COPY   1
+#endif
 
-/** @brief Taille du buffer linéaire DMA pour la réception (Double buffer partiel). */
+/**
+ * @brief Taille du buffer DMA circulaire de réception hors zero-copy (octets, pair, au plus 0xFFFF).
+ * @note  Surchargeable par profil de build. Avec SERIAL_RX_HALF_XFER, la moitié de ce
+ * buffer borne la latence de réception sous trafic continu : 128 octets à 1 Mbit/s, 1,3 ms.
+ */
+#ifndef SERIAL_RX_CHUNK_SIZE
 #define SERIAL_RX_CHUNK_SIZE  256u
+#endif
+
+/**
+ * @brief Événements DMA de réception : (1) demi-transfert et fin de transfert, en plus de
+ * la ligne au repos (IDLE, ou RTO / détection de PROTO_SYNC en zero-copy) ; (0) ligne au
+ * repos et rebouclage seuls.
+ * @details Sous trafic continu, la ligne n'est jamais au repos : sans événement de
+ * demi-transfert, le consommateur endormi (tâche de scrutation SCHED_RTOS, veille) n'est
+ * réveillé qu'au rebouclage du buffer. Mode 1 : latence de réception bornée par la durée
+ * d'un demi-buffer (SERIAL_RX_CHUNK_SIZE / 2, ou SERIAL_RX_RING_SIZE / 2 en zero-copy),
+ * indépendamment des silences de ligne ; deux interruptions DMA par tour de buffer.
+ */
+#ifndef SERIAL_RX_HALF_XFER
+#define SERIAL_RX_HALF_XFER   1
+#endif
 
-/** @brief Taille maximale d'un transfert DMA unique en émission. */
-#define SERIAL_TX_CHUNK_MAX   255u
+/** @brief Taille maximale d'un transfert DMA unique en émission (limite du compteur NDTR). */
+#define SERIAL_TX_CHUNK_MAX   0xFFFFu
+
+/**
+ * @brief Enchaînement TX bas niveau : (1) la suite du ring est relancée directement
+ * sur le canal DMA dans l'interruption de fin de transfert, sans repasser par
+ * HAL_UART_Transmit_DMA(). (0) relance via la HAL.
+ */
+#ifndef SERIAL_TX_LL_CHAIN
+#define SERIAL_TX_LL_CHAIN    1
+#endif
+
+/**
+ * @brief Démarrage TX bas niveau : (1) serial_kick_tx() programme directement le canal
+ * DMA dès que la HAL l'a configuré (premier transfert, ou après changement de débit).
+ * (0) chaque démarrage passe par HAL_UART_Transmit_DMA().
+ */
+#ifndef SERIAL_TX_LL_KICK
+#define SERIAL_TX_LL_KICK     1
+#endif
+
+/**
+ * @brief Émission à deux niveaux de priorité (1) ou FIFO unique (0).
+ * @details Mode 1 : les réponses de commande et les échos passent par une file dédiée,
+ * servie dès que le ring principal (télémétrie, journal, printf) est à une frontière
+ * de trame ; les transferts du ring principal sont coupés à la dernière frontière
+ * tenant dans SERIAL_TX_BULK_CHUNK. Une réponse attend donc au plus un bloc
+ * (ou une trame, si elle est plus longue).
+ */
+#ifndef SERIAL_TX_PRIORITY
+#define SERIAL_TX_PRIORITY    1
+#endif
+
+/** @brief Taille de la file d'émission prioritaire (puissance de 2, une réponse burst complète au moins). */
+#define SERIAL_TX_CTRL_SIZE   512u
+/** @brief Taille visée d'un transfert DMA du ring principal en mode prioritaire (octets). */
+#define SERIAL_TX_BULK_CHUNK  128u
+/** @brief Nombre de frontières de trame suivies dans le ring principal (puissance de 2). */
+#define SERIAL_TX_BOUNDS      32u
 
 /** @brief Instance UART HAL utilisée (liaison avec usart.h). */
 #define SERIAL_UART           huart2
 
+/**
+ * @brief FIFO matérielles 8 octets de l'USART actives (1) ou désactivées comme configuré
+ * par CubeMX (0).
+ * @details Les requêtes DMA restent émises octet par octet (FIFO RX non vide, FIFO TX
+ * non pleine) : la FIFO RX donne huit octets de marge face à la latence du DMA
+ * (arbitrage avec le SPI IMU, relance de la réception) avant un overrun, au lieu d'un
+ * seul. Configuration réappliquée par serial_init() et après chaque changement de débit
+ * (HAL_UART_Init la remet à zéro).
+ */
+#ifndef SERIAL_UART_FIFO
+#define SERIAL_UART_FIFO      1
+#endif
+/**
+ * @brief Seuils des FIFO (UART_RXFIFO_THRESHOLD_x, UART_TXFIFO_THRESHOLD_x).
+ * @note  Ils ne conditionnent que les interruptions de seuil (RXFTIE/TXFTIE), inutilisées
+ * par les chemins DMA : RX à 1/2 pour qu'une interruption de seuil éventuelle reste
+ * antérieure au débordement, TX à 1/8 (remplissage relancé tôt).
+ */
+#define SERIAL_UART_RXFT      UART_RXFIFO_THRESHOLD_1_2
+#define SERIAL_UART_TXFT      UART_TXFIFO_THRESHOLD_1_8
+
+/**
+ * @brief Frontières de trames RX signalées par l'USART (1) ou analyse de chaque octet reçu (0).
+ * @details Mode 1 (réception zero-copy uniquement) : le receiver timeout (ligne silencieuse
+ * pendant SERIAL_RX_RTO_BITS bits) et la détection de caractère (PROTO_SYNC, début de la
+ * trame suivante) relèvent en interruption la position DMA jusqu'à laquelle le ring ne
+ * contient que des trames terminées. Le parseur ne lit que jusque-là (serial_rx_peek_frames()),
+ * et la boucle en veille est réveillée à chaque frontière au lieu du tick suivant. Plus de
+ * SERIAL_RX_FRAME_MAX octets sans frontière (rafales PROTO_SYNC_BURST enchaînées) sont
+ * lus quand même.
+ */
+#ifndef SERIAL_RX_HW_FRAMING
+#define SERIAL_RX_HW_FRAMING  1
+#endif
+/** @brief Silence de ligne marquant la fin d'une rafale de trames (bits, registre RTOR). */
+#define SERIAL_RX_RTO_BITS    20u
+
 /* ---------- DÉFINITIONS DU PROTOCOLE (4 OCTETS) ---------- */
-/* Format trame : [HDR | D0 | D1 | CRC8] */
+/* Format trame : [SYNC | HDR | D0 | D1 | CRC8] (SYNC absent si SERIAL_CMD_FRAMED = 0) */
 /* HDR : bit7 = R(1)/W(0), bits6..0 = Adresse registre (0..127) */
+/* CRC8 calculé sur HDR, D0, D1 */
+
+/**
+ * @brief Trames de commande précédées d'un octet de synchronisation (1),
+ * permettant au parseur de se recaler en une trame après un octet perdu ou parasite.
+ * (0) : format historique 4 octets sans synchronisation.
+ */
+#ifndef SERIAL_CMD_FRAMED
+#define SERIAL_CMD_FRAMED     1
+#endif
+
+/** @brief Octet de synchronisation des trames de commande. */
+#define PROTO_SYNC            0xA5u
+
+/** @brief Longueur d'une trame de commande, synchronisation comprise. */
+#define PROTO_FRAME_LEN       (SERIAL_CMD_FRAMED ? 5u : 4u)
+
+/* Trame d'écriture groupée : [SYNC_BURST | ADDR | COUNT | COUNT x (LO | HI) | CRC8] */
+/* CRC8 calculé sur ADDR, COUNT et les données. Disponible en mode SERIAL_CMD_FRAMED uniquement. */
+
+/** @brief Octet de synchronisation des trames d'écriture groupée. */
+#define PROTO_SYNC_BURST      0xA6u
+
+/** @brief Nombre maximal de registres par trame d'écriture groupée. */
+#define PROTO_BURST_MAX_REGS  8u
+
+/** @brief Longueur d'une trame d'écriture groupée de `n` registres. */
+#define PROTO_BURST_LEN(n)    (4u + 2u * (n))
+
+/** @brief Plus longue trame de commande (octets) : au-delà, une frontière manquante est ignorée. */
+#define SERIAL_RX_FRAME_MAX   PROTO_BURST_LEN(PROTO_BURST_MAX_REGS)
+
+/* Réponse de lecture groupée : [SYNC_BURST | HDR(1,addr) | COUNT | COUNT x (LO | HI) | CRC8] */
+/* Même format que l'écriture groupée, bit R/W à 1 : une seule trame et un seul CRC par requête. */
+
+/** @brief Nombre maximal de registres par réponse de lecture groupée (tout l'espace d'adresses). */
+#define PROTO_BURST_RESP_MAX_REGS  (PROTO_HDR_ADDR_MASK + 1u)
+
+/**
+ * @brief Réponses de registres dans l'enveloppe des trames de télémétrie (1) :
+ * [0xAA | 0x55 | TELEM_TYPE_REG | LEN | HDR(1,addr) | COUNT | COUNT x (LO | HI) | CRC8],
+ * CRC8 sur tout ce qui précède, comme les autres trames montantes.
+ * @details Tout le flux vers l'hôte partage alors un seul format (synchronisation,
+ * type, longueur, CRC) : l'hôte saute une trame entière d'après LEN et se recale en
+ * cherchant 0xAA 0x55. (0) : réponses 0xA5 / 0xA6 historiques.
+ */
+#ifndef SERIAL_TX_ENVELOPE
+#define SERIAL_TX_ENVELOPE    1
+#endif
+
+/** @brief Registres par trame de réponse enveloppée (payload limité à 255 octets). */
+#define PROTO_ENV_MAX_REGS    126u
+
+/** @brief Longueur d'une trame de réponse enveloppée de `n` registres. */
+#define PROTO_ENV_LEN(n)      (4u + 2u + 2u * (n) + 1u)
+
+/**
+ * @brief Flux montant encodé COBS, chaque trame suivie d'un délimiteur 0x00 (1).
+ * @details Chaque écriture (serial_write_all_nb, serial_write_ctrl_nb, zone
+ * réservée/publiée) devient une trame COBS : aucun 0x00 dans la trame encodée, le
+ * 0x00 final la termine. L'hôte découpe le flux sur 0x00 (bytes.split) et se recale
+ * à la trame suivante après une perte, sans chercher de synchronisation octet par
+ * octet ; le contenu décodé reste l'enveloppe 0xAA 0x55 habituelle (type, LEN, CRC).
+ * Surcoût : 2 octets par trame (+1 par 254 octets). L'encodage se fait sur place dans
+ * les rings TX, à la publication. serial_write_nb() devient tout ou rien. (0) : flux
+ * brut.
+ */
+#ifndef SERIAL_TX_COBS
+#define SERIAL_TX_COBS        0
+#endif
+
+#if SERIAL_TX_COBS && !SERIAL_TX_ENVELOPE
+#error "SERIAL_TX_COBS requires SERIAL_TX_ENVELOPE (every frame in the 0xAA 0x55 envelope)"
+#endif
+
+/** @brief Octets ajoutés par l'encodage COBS d'une trame de `len` octets (codes + délimiteur). */
+#define SERIAL_COBS_OVERHEAD(len)  ((uint32_t)(len) / 254u + 2u)
 
 /** @brief Masque pour extraire le bit R/W de l'entête. */
 #define PROTO_HDR_RW_MASK     0x80u
@@ -48,16 +241,56 @@
 
 /* ---------- FONCTIONS BAS NIVEAU (LINK LAYER) ---------- */
 
+/**
+ * @brief Zone réservée dans le buffer d'émission (éventuellement coupée en deux au rebouclage).
+ */
+typedef struct {
+    uint8_t  *p1;       ///< Début de la zone réservée.
+    uint16_t  len1;     ///< Longueur contiguë à partir de p1.
+    uint8_t  *p2;       ///< Suite rebouclée en début de ring (NULL si aucune).
+    uint16_t  len2;     ///< Longueur de la suite (0 si la zone est contiguë).
+} serial_tx_span_t;
+
+/**
+ * @brief Octets reçus lus en place dans le buffer RX (éventuellement coupés en deux au rebouclage).
+ */
+typedef struct {
+    const uint8_t *p1;  ///< Premier octet non lu.
+    uint16_t       len1;///< Longueur contiguë à partir de p1.
+    const uint8_t *p2;  ///< Suite rebouclée en début de ring (NULL si aucune).
+    uint16_t       len2;///< Longueur de la suite (0 si le bloc est contigu).
+} serial_rx_span_t;
+
 /**
  * @brief  Initialise la couche série (DMA + Buffers).
  */
 void     serial_init(void);
 
+/**
+ * @brief  Indique si l'émission est entièrement terminée.
+ * @return 1 si la ligne TX est au repos, 0 sinon.
+ */
+uint8_t  serial_tx_idle(void);
+
+/**
+ * @brief  Change le débit de la liaison (TX au repos requis).
+ * @param  baud Nouveau débit (bauds).
+ * @return 0 si succès, -1 sinon.
+ */
+int      serial_set_baud(uint32_t baud);
+
+/**
+ * @brief  Retourne le débit courant de la liaison.
+ * @return Débit en bauds.
+ */
+uint32_t serial_get_baud(void);
+
 /**
  * @brief  Écriture non-bloquante partielle.
  * @param  data Pointeur vers les données.
  * @param  len  Nombre d'octets souhaités.
  * @return Nombre d'octets écrits (peut être inférieur à len).
+ * @note   Tout ou rien si SERIAL_TX_COBS (une trame ne se coupe pas).
  */
 int      serial_write_nb(const uint8_t *data, uint16_t len);
 
@@ -69,6 +302,37 @@ int      serial_write_nb(const uint8_t *data, uint16_t len);
  */
 int      serial_write_all_nb(const uint8_t *data, uint16_t len);
 
+/**
+ * @brief  Écriture non-bloquante atomique dans la file prioritaire (réponses de commande).
+ * @param  data Pointeur vers la trame.
+ * @param  len  Nombre d'octets.
+ * @return len si succès, code erreur négatif si la file est pleine.
+ * @note   Équivaut à serial_write_all_nb() si SERIAL_TX_PRIORITY vaut 0.
+ */
+int      serial_write_ctrl_nb(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief  Réserve une zone d'écriture directement dans le buffer d'émission DMA.
+ * @details Avec SERIAL_TX_COBS, la zone rendue est celle de la trame brute : la place des
+ * codes COBS est réservée en plus et l'encodage a lieu dans serial_tx_commit().
+ * @param  len  Nombre d'octets.
+ * @param  span Sortie : zone(s) réservée(s).
+ * @return 0 si succès, code erreur négatif si buffer plein.
+ */
+int      serial_tx_reserve(uint16_t len, serial_tx_span_t *span);
+
+/**
+ * @brief  Copie un bloc dans une zone réservée, en gérant le rebouclage.
+ * @param  span Zone réservée.
+ * @param  data Données (len1 + len2 octets).
+ */
+void     serial_tx_span_copy(const serial_tx_span_t *span, const void *data);
+
+/**
+ * @brief  Publie la zone réservée et lance l'émission.
+ */
+void     serial_tx_commit(void);
+
 /**
  * @brief  Écriture bloquante (Wrapper).
  * @param  data Pointeur vers les données.
@@ -99,6 +363,101 @@ size_t   serial_read(uint8_t *dst, size_t max_len);
  */
 size_t   serial_read_until(uint8_t *dst, size_t max_len, uint8_t delim);
 
+/**
+ * @brief  Donne accès en place au plus long bloc contigu d'octets reçus.
+ * @param  span Sortie : pointeur vers le premier octet non lu (dans le buffer RX).
+ * @return Nombre d'octets contigus disponibles (0 si vide).
+ */
+size_t   serial_rx_peek(const uint8_t **span);
+
+/**
+ * @brief  Donne accès en place à tous les octets reçus, rebouclage compris.
+ * @param  span Sortie : bloc(s) non lus.
+ * @return Nombre d'octets disponibles (len1 + len2), à libérer par serial_rx_consume().
+ */
+size_t   serial_rx_peek_span(serial_rx_span_t *span);
+
+/**
+ * @brief  Donne accès en place aux octets reçus jusqu'au délimiteur inclus, sans copie.
+ * @details Reprend le parcours là où l'appel précédent s'était arrêté : temps linéaire
+ * sur un message reçu par morceaux.
+ * @param  delim Délimiteur (ex: '\\n').
+ * @param  span  Sortie : bloc(s) du message.
+ * @return Longueur du message délimiteur compris (0 si incomplet), à libérer par
+ * serial_rx_consume().
+ */
+size_t   serial_rx_peek_until(uint8_t delim, serial_rx_span_t *span);
+
+/**
+ * @brief  Libère des octets lus en place via serial_rx_peek() et variantes.
+ * @param  len Nombre d'octets consommés.
+ */
+void     serial_rx_consume(size_t len);
+
+/**
+ * @brief  Comme serial_rx_peek(), limité aux octets précédant la dernière frontière de trame.
+ * @note   Équivaut à serial_rx_peek() si SERIAL_RX_HW_FRAMING est inactif.
+ * @param  span Sortie : pointeur vers le premier octet non lu (dans le buffer RX).
+ * @return Nombre d'octets contigus de trames terminées (0 si aucune).
+ */
+size_t   serial_rx_peek_frames(const uint8_t **span);
+
+/**
+ * @brief  Nombre d'octets de trames terminées en attente de lecture.
+ * @note   Équivaut à serial_available() si SERIAL_RX_HW_FRAMING est inactif.
+ * @return Nombre d'octets.
+ */
+size_t   serial_rx_frames_available(void);
+
+/**
+ * @brief  Relève les frontières de trames (RTO, détection de caractère) dans le vecteur USART.
+ * @details À appeler avant HAL_UART_IRQHandler : la HAL traiterait RTOF comme une erreur
+ * bloquante et abandonnerait la réception DMA.
+ */
+void     serial_uart_irq(void);
+
+/**
+ * @brief  Retourne le nombre d'octets reçus perdus (buffer RX plein).
+ * @return Compteur cumulé.
+ */
+uint32_t serial_rx_dropped(void);
+
+/**
+ * @brief  Retourne le nombre de trames non émises (buffer TX plein).
+ * @return Compteur cumulé.
+ */
+uint32_t serial_tx_dropped(void);
+
+/**
+ * @brief  Remplissage maximal observé du buffer RX.
+ * @return Octets en attente de lecture au pire moment observé.
+ */
+uint32_t serial_rx_high_water(void);
+
+/**
+ * @brief  Remplissage maximal observé du buffer TX.
+ * @return Octets en attente d'émission au pire moment observé.
+ */
+uint32_t serial_tx_high_water(void);
+
+/**
+ * @brief  Place libre dans le buffer TX (télémétrie).
+ * @return Octets pouvant encore être déposés sans refus.
+ */
+uint32_t serial_tx_free(void);
+
+/**
+ * @brief  Retourne le nombre de débordements matériels de l'UART (overrun).
+ * @return Compteur cumulé.
+ */
+uint32_t serial_rx_overruns(void);
+
+/**
+ * @brief  Retourne la date de la dernière arrivée d'octets (mesure de latence).
+ * @return Date en µs (GetMicrosTotal).
+ */
+uint32_t serial_rx_last_us(void);
+
 /* ---------- UTILITAIRES ---------- */
 
 /**
@@ -130,6 +489,18 @@ int      proto_send_write16(uint8_t addr, int16_t value);
  */
 int      proto_send_read_burst(uint8_t addr, uint8_t count, uint8_t flags);
 
+/**
+ * @brief  Envoie la réponse groupée à une lecture de plusieurs registres.
+ * @details Trame : [SYNC_BURST | HDR(1,addr) | COUNT | COUNT x (LO | HI) | CRC], ou
+ * trame(s) enveloppée(s) type TELEM_TYPE_REG si SERIAL_TX_ENVELOPE (coupée par
+ * PROTO_ENV_MAX_REGS registres).
+ * @param  addr   Adresse du premier registre.
+ * @param  values Valeurs des registres.
+ * @param  count  Nombre de registres (1 à PROTO_BURST_RESP_MAX_REGS).
+ * @return Résultat de l'envoi série.
+ */
+int      proto_send_data_burst(uint8_t addr, const int16_t *values, uint8_t count);
+
 /**
  * @brief  Envoie une donnée de télémétrie (Alias de Write).
  * @note   Utilisé par le STM32 pour répondre à une requête ou streamer des données.
@@ -138,7 +509,11 @@ int      proto_send_read_burst(uint8_t addr, uint8_t count, uint8_t flags);
  * @return Résultat de l'envoi série.
  */
 static inline int proto_send_data16(uint8_t addr, int16_t value){
+#if SERIAL_TX_ENVELOPE
+    return proto_send_data_burst(addr, &value, 1u);
+#else
     return proto_send_write16(addr, value);
+#endif
 }
 
 #endif
@@ -11,30 +11,629 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include "driver_ins.h"
+#include "pool.h"
+#include "proto_def.h"
+#include "fault_log.h"
 
 /** @brief Adresse du registre virtuel pour la commande Servo (0-100%). */
 #define REG_SERVO_CMD 0x00
 /** @brief Adresse du registre virtuel pour la commande Moteur (mm/s). */
 #define REG_MOTOR_CMD 0x01
-/** @brief Adresse du registre virtuel pour les commandes BMI088 (réservé). */
+/**
+ * @brief Auto-test IMU : écriture de BMI088_ST_CMD_RUN pour le relancer ; lecture : état
+ * bmi088_st_state_t, capteurs en échec bmi088_st_fail_t dans l'octet haut.
+ * Écriture bit 15 levé : accès direct aux registres des capteurs (BMI088_REGIO_*,
+ * driver_ins.h), résultat dans une trame type 0x12.
+ */
 #define REG_BMI       0x02
+/** @brief Valeur écrite dans REG_BMI pour relancer l'auto-test IMU. */
+#define BMI088_ST_CMD_RUN   1
+/** @brief Adresse du registre virtuel de configuration IMU (gammes/ODR/bande passante). */
+#define REG_IMU_CONFIG 0x03
+/** @brief Adresse du registre virtuel du prédiviseur SPI1 (code BR 0..7, SCK = PCLK / 2^(code+1)). */
+#define REG_SPI_PRESC  0x04
+/** @brief Adresse du registre virtuel du benchmark SPI (écriture : N lectures, réponse : 0.1 µs/lecture). */
+#define REG_SPI_BENCH  0x05
+/** @brief Adresse du registre virtuel de négociation du débit série (code SERIAL_BAUD_CODE_*). */
+#define REG_BAUD       0x06
+/** @brief Adresse du registre virtuel de cadence de télémétrie (Hz, TELEM_RATE_MIN_HZ..TELEM_RATE_MAX_HZ). */
+#define REG_TELEM_RATE   0x07
+/**
+ * @brief Adresse du registre virtuel de contenu de télémétrie.
+ * @note  Bits 0-7 : flux rapide, masque TELEM_F_* (0 = trame complète historique) ;
+ * bits 8-15 : flux d'état lent (type 0x0F), masque TELEM_F_*.
+ */
+#define REG_TELEM_FIELDS 0x08
+/**
+ * @brief Adresse du registre virtuel de format de télémétrie.
+ * @note  Bits 0-7 : format du flux rapide (TELEM_FMT_*) ; bits 8-15 : cadence du flux
+ * d'état lent (Hz, 0 = coupé, au plus TELEM_STATUS_RATE_MAX_HZ).
+ */
+#define REG_TELEM_FORMAT 0x09
+
+/**
+ * @brief Adresse du registre virtuel de regroupement de la télémétrie compacte.
+ * @note  Bits 0-7 : taille de lot N (1..TELEM_DELTA_MAX_SAMPLES), bits 8-15 : latence
+ * maximale d'attente du lot en ms (0 = émission immédiate de ce qui est disponible).
+ */
+#define REG_TELEM_BATCH  0x0A
+/** @brief Statistique (lecture seule) : prochain numéro de séquence de télémétrie. */
+#define REG_STAT_TELEM_SEQ  0x0B
+/**
+ * @brief État instantané (même adresse que REG_STAT_TELEM_SEQ) : une écriture demande la
+ * trame type 0x0E (SerialSnapFrame_t), qui renvoie le jeton écrit avec consignes, état
+ * ESC, vitesse et dernier échantillon IMU relevés d'un bloc. La lecture reste le numéro de séquence.
+ */
+#define REG_SNAPSHOT        0x0B
+/** @brief Statistique (lecture seule) : trames refusées faute de place en TX (modulo 65536). */
+#define REG_STAT_TX_DROP    0x0C
+/** @brief Statistique (lecture seule) : octets reçus perdus, buffer RX plein (modulo 65536). */
+#define REG_STAT_RX_DROP    0x0D
+/**
+ * @brief Commande cinématique (kin.h, mêmes adresses que REG_STAT_TX_DROP / REG_STAT_RX_DROP) :
+ * vitesse linéaire (mm/s) puis courbure (km⁻¹, positive à gauche), en une trame groupée.
+ * L'écriture de la courbure applique la paire (braquage déduit, vitesse comme
+ * REG_MOTOR_CMD) ; la lecture reste les statistiques.
+ */
+#define REG_KIN_SPEED       0x0C
+#define REG_KIN_CURV        0x0D
+/** @brief Statistique (lecture seule) : échantillons IMU perdus (modulo 65536). */
+#define REG_STAT_IMU_DROP   0x0E
+/** @brief Statistique (lecture seule) : part du temps CPU passée en veille sur la dernière seconde (%). */
+#define REG_STAT_IDLE_PCT   0x0F
+
+/**
+ * @brief Sélection de la sonde du profileur lue en 0x11..0x1E.
+ * @details Bits 0..5 : 0x00..0x0F tâche de l'ordonnanceur, PROF_SEL_PROBE + k sonde
+ * hors ordonnanceur k (prof_probe_id_t). Bit 6 (tâche) : profil du retard de libération
+ * au lieu de la durée d'exécution. Bit 7 à 1 : remise à zéro de tous les profils.
+ */
+#define REG_PROF_SEL        0x10
+/** @brief Profileur (lecture seule) : nombre d'exécutions (modulo 65536). */
+#define REG_PROF_COUNT      0x11
+/** @brief Profileur (lecture seule) : durée minimale (µs, saturée à 32767). */
+#define REG_PROF_MIN        0x12
+/** @brief Profileur (lecture seule) : durée moyenne (µs, saturée à 32767). */
+#define REG_PROF_AVG        0x13
+/** @brief Profileur (lecture seule) : durée maximale (µs, saturée à 32767). */
+#define REG_PROF_MAX        0x14
+/** @brief Profileur (lecture seule) : première classe d'histogramme (PROF_HIST_BINS registres, modulo 65536). */
+#define REG_PROF_HIST0      0x15
+/** @brief Profileur (lecture seule) : libérations manquées de la tâche (modulo 65536). */
+#define REG_PROF_OVERRUNS   0x1D
+/** @brief Profileur (lecture seule) : retard de libération maximal de la tâche (µs, saturé à 32767). */
+#define REG_PROF_LATE_MAX   0x1E
+/** @brief Banc de gigue : modes actifs (JITTER_MODE_*, sonde de latence TIM3 et charge TX). */
+#define REG_JITTER_MODE     0x1F
+/**
+ * @brief Gain proportionnel de la boucle de vitesse (Q12, % PWM par mm/s, >= 0).
+ * @note  Boucle ouverte (carte vitesse -> PWM seule) tant que les trois gains sont nuls.
+ */
+#define REG_SPEED_KP        0x20
+/** @brief Gain intégral par échantillon tachymètre (TASK_SPEED_US : 20 ms) de la boucle de vitesse (Q12, >= 0). */
+#define REG_SPEED_KI        0x21
+/** @brief Gain dérivé par échantillon tachymètre de la boucle de vitesse (Q12, >= 0). */
+#define REG_SPEED_KD        0x22
+/** @brief Durée du coup de frein avant inversion de sens de l'ESC (ms, >= 0 ; 0 = sans frein). */
+#define REG_ESC_BRAKE_MS    0x23
+/** @brief Durée de la pause au neutre après le coup de frein (ms, >= 0). */
+#define REG_ESC_GAP_MS      0x24
+/** @brief Écart au neutre de l'impulsion de frein (% PWM, 0..50). */
+#define REG_ESC_BRAKE_DEPTH 0x25
+/** @brief Consigne servo en centi-degrés (bornée à ±20°), alternative fine à REG_SERVO_CMD. */
+#define REG_SERVO_CDEG      0x26
+/** @brief Vitesse de braquage maximale du servo (°/s, >= 0 ; 0 = sans limitation). */
+#define REG_SERVO_SLEW      0x27
+/** @brief Failsafe : délai sans commande avant décélération (ms, >= 0). */
+#define REG_FS_DECEL_MS     0x28
+/** @brief Failsafe : délai sans commande avant neutre (ms, >= 0). */
+#define REG_FS_NEUTRAL_MS   0x29
+/** @brief Failsafe : délai sans commande avant désarmement (ms, >= 0). */
+#define REG_FS_DISARM_MS    0x2A
+/** @brief Étape courante du failsafe (failsafe_stage_t, lecture seule). */
+#define REG_FS_STAGE        0x2B
+/**
+ * @brief Entretien de liaison (même adresse que REG_FS_STAGE) : une écriture ne modifie
+ * aucune consigne et réarme seulement le délai du failsafe. Trame de commande minimale
+ * émise entre deux consignes par l'ordonnanceur de l'hôte, sans réappliquer la dernière
+ * consigne (abandon de trajectoire, réveil des actionneurs).
+ */
+#define REG_HEARTBEAT       0x2B
+/** @brief Trames reçues rejetées : CRC ou format invalide (modulo 65536, lecture seule). */
+#define REG_STAT_RX_REJECT  0x2C
+/** @brief Trames valides reçues par seconde (dernière fenêtre de 1 s, lecture seule). */
+#define REG_STAT_RX_RATE    0x2D
+/** @brief Cause du démarrage courant (fault_cause_t : 1 = chien de garde, 2 = HardFault). */
+#define REG_STAT_RESET_CAUSE 0x2E
+/**
+ * @brief Relevé de faute (fault_log.h, même adresse que REG_STAT_RESET_CAUSE) : écriture
+ * FAULT_CMD_REPORT (renvoi, trame type 0x11) ou FAULT_CMD_CLEAR (effacement).
+ * La lecture reste la cause du démarrage.
+ */
+#define REG_FAULT            0x2E
+/** @brief Erreurs du bus SPI IMU : timeouts + erreurs HAL (modulo 65536, lecture seule). */
+#define REG_STAT_IMU_BUS_ERR 0x2F
+/** @brief Récupérations du bus SPI IMU menées à terme, bit 15 = récupération en cours (lecture seule). */
+#define REG_STAT_IMU_RECOVER 0x30
+/** @brief Profondeur maximale de pile atteinte (octets, lecture seule). */
+#define REG_STAT_STACK_PEAK  0x31
+/** @brief Pile réservée par le script de liens (octets, lecture seule). */
+#define REG_STAT_STACK_SIZE  0x32
+/** @brief Taille de la section des buffers DMA (octets, lecture seule). */
+#define REG_STAT_RAM_DMA     0x33
+/** @brief Taille de la section d'état chaud (octets, lecture seule). */
+#define REG_STAT_RAM_HOT     0x34
+/** @brief RAM statique .data + .bss (octets, saturé à 32767, lecture seule). */
+#define REG_STAT_RAM_STATIC  0x35
+/** @brief Remplissage maximal observé du buffer RX (octets, lecture seule). */
+#define REG_STAT_RX_HWM      0x36
+/** @brief Remplissage maximal observé du buffer TX (octets, lecture seule). */
+#define REG_STAT_TX_HWM      0x37
+/** @brief Débordements matériels UART (overrun, modulo 65536, lecture seule). */
+#define REG_STAT_RX_OVERRUN  0x38
+/** @brief Taille du code exécuté en RAM (octets, 0 si MEM_RAMFUNC_ENABLE = 0, lecture seule). */
+#define REG_STAT_RAM_FUNC    0x39
+/**
+ * @brief Mise à jour du firmware (fw_update.h, même adresse que REG_STAT_RAM_FUNC) :
+ * écriture opcode << 12 | argument, acquittée par la trame type 0x10 ; une trame groupée
+ * adressée à ce registre porte un bloc du flux de page (registres suivants non écrits).
+ * La lecture reste la statistique.
+ */
+#define REG_FW_UPDATE        0x39
+/**
+ * @brief Base des dates d'étapes du démarrage (REG_BOOT_STAGE_BASE + boot_stage_t, lecture seule).
+ * @details Unité 100 µs depuis le reset (recopie .data / mise à zéro .bss comprises, durée
+ * seule : sonde PROF_PROBE_STARTUP), saturée à 32767 ; -1 si l'étape n'est pas atteinte.
+ */
+#define REG_BOOT_STAGE_BASE  0x3A
+/** @brief Unité des registres d'étapes du démarrage (µs). */
+#define REG_BOOT_STAGE_UNIT_US 100u
+/** @brief Gain de correction de l'estimateur d'attitude par l'accéléromètre (1/s x 1000, >= 0). */
+#define REG_ATT_KP           0x40
+/**
+ * @brief Calibration IMU : écriture d'une demande bmi088_cal_req_t (1 gyroscope, 2 gyroscope
+ * et accéléromètre à plat, 3 effacement) ; lecture : état bmi088_cal_state_t, bit 8 = offsets enregistrés en flash.
+ */
+#define REG_IMU_CAL          0x41
+/**
+ * @brief Base des offsets IMU actifs (lecture seule) : +0..+2 biais gyroscope X/Y/Z (µrad/s),
+ * +3..+5 offsets accéléromètre X/Y/Z (mm/s²), saturés sur 16 bits.
+ * @note  Déjà soustraits des trames en unités physiques ; à retrancher par l'hôte aux formats bruts (0x04/0x05).
+ */
+#define REG_IMU_OFS_BASE     0x42
+/** @brief Nombre de registres d'offsets IMU. */
+#define REG_IMU_OFS_COUNT    6u
+/** @brief Vitesse maximale en marche avant (mm/s, >= 0), prise en compte au démarrage suivant. */
+#define REG_MOTOR_MAX_FWD    0x48
+/** @brief Vitesse maximale en marche arrière (mm/s, valeur absolue), prise en compte au démarrage suivant. */
+#define REG_MOTOR_MAX_REV    0x49
+/** @brief Impulsion servo minimale (ticks TIM1), prise en compte au démarrage suivant. */
+#define REG_SERVO_MIN_TICKS  0x4A
+/** @brief Impulsion servo maximale (ticks TIM1), prise en compte au démarrage suivant. */
+#define REG_SERVO_MAX_TICKS  0x4B
+/**
+ * @brief Configuration persistante : écriture d'une demande NV_CMD_* ; lecture : résultat
+ * de la dernière opération (nv_status_t).
+ * @note  La sauvegarde porte sur les registres marqués REG_F_NV, relus à leur valeur effective.
+ * Entre NV_CMD_STAGE et NV_CMD_COMMIT, les écritures de ces registres sont mises de côté
+ * (banc de préparation) et appliquées ensemble à la validation.
+ */
+#define REG_NV_CMD           0x4C
+/** @brief Nombre de registres enregistrés en flash (lecture seule). */
+#define REG_NV_KEYS          0x4D
+/** @brief Génération de la page active du magasin, soit le nombre de recopies (lecture seule). */
+#define REG_NV_GEN           0x4E
+
+/**
+ * @brief Cadence de télémétrie au repos (Hz, 1..TELEM_RATE_MAX_HZ), 0 : mise en veille inactive.
+ * @details Sans mouvement détecté par l'accéléromètre (any-motion) ni consigne moteur
+ * pendant REG_IDLE_HOLD_MS, les acquisitions et la télémétrie passent à cette cadence ;
+ * la première détection rétablit REG_TELEM_RATE immédiatement.
+ */
+#define REG_IDLE_RATE        0x4F
+/** @brief Délai sans mouvement avant la cadence de repos (ms, >= 0). */
+#define REG_IDLE_HOLD_MS     0x50
+/** @brief Seuil de détection de mouvement (mg, 1..BMI088_MOTION_THRESH_MAX_MG). */
+#define REG_MOTION_MG        0x51
+/** @brief État de la mise en veille de la télémétrie (idle_state_t, lecture seule). */
+#define REG_IDLE_STATE       0x52
+/**
+ * @brief Écho de mesure de latence : la valeur écrite (jeton) est renvoyée dans une
+ * trame type 0x06 (SerialEchoFrame_t) datée à chaque étape du traitement.
+ */
+#define REG_PING             0x53
+/**
+ * @brief Décimation maximale de la régulation de débit (1..TELEM_ADAPT_DECIM_MAX), 0 ou 1 : inactive.
+ * @details Quand le buffer TX sature (trames refusées ou place libre sous
+ * TELEM_ADAPT_LOW_PCT %), la télémétrie n'émet plus qu'un échantillon sur N, N doublé
+ * à chaque fenêtre saturée jusqu'à cette borne, puis divisé par deux après
+ * TELEM_ADAPT_CALM_WINDOWS fenêtres dégagées. Les acquisitions et l'attitude
+ * gardent leur cadence (REG_IMU_RATE).
+ */
+#define REG_TELEM_ADAPT      0x54
+/** @brief Décimation appliquée par la régulation de débit (1 = toutes les trames, lecture seule). */
+#define REG_TELEM_DECIM      0x55
+/** @brief Cadence effective de la télémétrie (échantillons émis par seconde, lecture seule). */
+#define REG_TELEM_EFF_RATE   0x56
+/**
+ * @brief Cadence des acquisitions IMU (Hz, TELEM_RATE_MIN_HZ..TELEM_RATE_MAX_HZ), 0 : REG_TELEM_RATE.
+ * @details Indépendante de la télémétrie : l'attitude voit chaque acquisition, la
+ * télémétrie est décimée à REG_TELEM_RATE sur les dates d'échantillon. Au repos
+ * (REG_IDLE_RATE), les acquisitions suivent la cadence de veille si elle est plus lente.
+ * Bornée à l'ODR du capteur le plus rapide (REG_IMU_CONFIG).
+ */
+#define REG_IMU_RATE         0x57
+/**
+ * @brief Historique IMU (imu_hist.h) : commande IMU_HIST_CMD_* en écriture ; en lecture,
+ * état (bits 0..3, imu_hist_state_t) et source du déclenchement (bits 4..7, imu_hist_trig_t).
+ */
+#define REG_HIST_CMD         0x58
+/** @brief Seuil de déclenchement de l'historique par axe accéléromètre (mg), 0 : inactif. */
+#define REG_HIST_THR_MG      0x59
+/** @brief Échantillons enregistrés après le déclenchement (0..IMU_HIST_LEN - 1). */
+#define REG_HIST_POST        0x5A
+/** @brief Échantillons présents dans l'historique (lecture seule). */
+#define REG_HIST_COUNT       0x5B
+/** @brief Rang de l'échantillon de déclenchement dans l'historique (lecture seule). */
+#define REG_HIST_TRIG        0x5C
+/**
+ * @brief Demande d'un bloc de l'historique figé : le numéro écrit revient en trame type 0x09 ;
+ * avec le bit 15 (IMU_HIST_CHUNK_PACKED), bits 0..14 = rang du premier échantillon, trame
+ * compressée type 0x0D.
+ */
+#define REG_HIST_CHUNK       0x5D
+/** @brief Odométrie (odometry.h) : commande odom_cmd_t en écriture (remise à zéro), lecture 0. */
+#define REG_ODOM_CMD         0x5E
+/**
+ * @brief Base de la pose estimée par l'odométrie (lecture seule) : +0 X (cm), +1 Y (cm),
+ * +2 cap (c°, -18000..18000), +3/+4 distance cumulée (mm, 16 bits de poids faible puis fort).
+ * @note  Lire les REG_ODOM_COUNT registres en une seule trame : la lecture est alors
+ * cohérente (aucune intégration entre deux registres). X et Y saturés sur 16 bits.
+ */
+#define REG_ODOM_BASE        0x5F
+/** @brief Nombre de registres de pose de l'odométrie. */
+#define REG_ODOM_COUNT       5u
+/** @brief Tampon de trajectoire (traj.h) : commande traj_cmd_t en écriture, état traj_state_t en lecture. */
+#define REG_TRAJ_CMD         0x64
+/** @brief Points de trajectoire en attente (lecture seule). */
+#define REG_TRAJ_COUNT       0x65
+/**
+ * @brief Base des emplacements de téléversement des points de trajectoire :
+ * +0 date relative (µs, 16 bits de poids faible), +1 date (16 bits de poids fort),
+ * +2 braquage (c°, borné comme REG_SERVO_CDEG), +3 vitesse (mm/s, ajoute le point).
+ * @note  REG_TRAJ_PT_SLOTS emplacements consécutifs : une trame groupée de
+ * PROTO_BURST_MAX_REGS registres à partir de la base ajoute deux points.
+ */
+#define REG_TRAJ_PT_BASE     0x66
+/** @brief Registres par emplacement de point de trajectoire. */
+#define REG_TRAJ_PT_LEN      4u
+/** @brief Nombre d'emplacements de point de trajectoire. */
+#define REG_TRAJ_PT_SLOTS    2u
+/** @brief Accélération maximale de la consigne moteur (mm/s², >= 0 ; 0 = consigne appliquée d'un bloc). */
+#define REG_MOTOR_ACCEL      0x6E
+/** @brief Jerk maximal de la consigne moteur (mm/s² par ms, >= 0 ; 0 = accélération établie d'un bloc). */
+#define REG_MOTOR_JERK       0x6F
+/**
+ * @brief Accélération angulaire maximale du braquage (°/s², >= 0 ; 0 = sans profil).
+ * @note  Non nulle, le profil de braquage est calculé en centi-degrés par le tick moteur,
+ * REG_SERVO_SLEW en bornant la vitesse.
+ */
+#define REG_SERVO_ACCEL      0x70
+/**
+ * @brief Filtre anti-repliement de la télémétrie (imu_filt.h) : ordre imu_filt_order_t
+ * (0 = décimation seule, 1 = ordre 2, 2 = ordre 4), coupure au quart de la cadence émise.
+ */
+#define REG_IMU_FILT         0x71
+/** @brief Rapport de décimation du filtre anti-repliement en service (lecture seule, 0 = inactif). */
+#define REG_IMU_FILT_DECIM   0x72
+/**
+ * @brief Analyse vibratoire (vib.h) : axe vib_cmd_t (0 = arrêt, 1 X, 2 Y, 3 Z).
+ * @note  Chaque rapport (trame type 0x0A) résume REG_VIB_AVG spectres de VIB_FFT_N points.
+ */
+#define REG_VIB_CMD          0x73
+/** @brief Spectres moyennés par rapport vibratoire (1..64). */
+#define REG_VIB_AVG          0x74
+/** @brief Fréquence de la raie dominante du dernier rapport vibratoire (0,1 Hz, lecture seule). */
+#define REG_VIB_PEAK_DHZ     0x75
+/** @brief Amplitude crête de la raie dominante du dernier rapport vibratoire (mg, lecture seule). */
+#define REG_VIB_PEAK_MG      0x76
+/**
+ * @brief Actionneur exposé par la fenêtre REG_ACT_CMD..REG_ACT_STATE (actuators.h) :
+ * bit 7 ESC (sinon servo), bits 0..6 index, borné aux actionneurs présents.
+ * @note  L'index 0 de chaque type (direction, propulsion) suit la chaîne de
+ * REG_SERVO_CDEG / REG_MOTOR_CMD ; les suivants sont commandés directement.
+ */
+#define REG_ACT_SEL          0x77
+/** @brief Consigne de l'actionneur sélectionné (servo : c°, ESC : mm/s). */
+#define REG_ACT_CMD          0x78
+/** @brief Consigne CCR appliquée à l'actionneur sélectionné (ticks, lecture seule). */
+#define REG_ACT_OUT          0x79
+/** @brief État de l'actionneur sélectionné (ESC : MotorState_t, servo : 1 en rampe ; lecture seule). */
+#define REG_ACT_STATE        0x7A
+/**
+ * @brief Capacités du firmware : lecture PROTO_VERSION (majeure << 8 | mineure) ; une
+ * écriture (valeur quelconque) fait répondre une trame de capacités type 0x0B.
+ * @note  À lire une fois à la connexion : l'hôte y trouve types de trame, formats,
+ * cadences, débits série et tailles de buffers au lieu de les sonder.
+ */
+#define REG_CAPS             0x7B
+/**
+ * @brief Délai de mise en veille du véhicule garé (ms, >= 0), 0 : veille inactive (APP_PARK).
+ * @details Désarmé par le failsafe depuis ce délai, le véhicule passe en STOP1 (capteurs
+ * en veille, PWM coupées) ; le réveil se fait sur activité UART (le premier octet est
+ * perdu : l'hôte répète sa première trame) ou sur mouvement si REG_IDLE_RATE est actif.
+ */
+#define REG_PARK_MS          0x7C
+/** @brief Tension batterie moyennée (mV, lecture seule, 0 : mesure absente ; BATT_ENABLE). */
+#define REG_BATT_MV          0x7D
+/**
+ * @brief Tension nominale de la batterie (mV, >= 0), 0 : compensation inactive.
+ * @details Tension à laquelle la carte vitesse -> PWM a été relevée : l'écart au neutre
+ * des ESC est multiplié par REG_BATT_NOM_MV / REG_BATT_MV (borné à 0,8..1,5).
+ */
+#define REG_BATT_NOM_MV      0x7E
+/**
+ * @brief Rejeu de mesures (replay.h) : écriture replay_cmd_t (REPLAY_CMD_SYNTH : source
+ * synthétique du banc de débit), lecture du nombre d'échantillons injectés. Une trame groupée adressée à ce registre transporte un
+ * enregistrement de REPLAY_REC_REGS valeurs (registres suivants non écrits).
+ */
+#define REG_REPLAY           0x7F
+
+/**
+ * @brief État de la mise en veille de la télémétrie (REG_IDLE_STATE).
+ */
+typedef enum{
+    IDLE_ST_OFF=0,      ///< Mise en veille inactive (REG_IDLE_RATE = 0).
+    IDLE_ST_ACTIVE,     ///< Mouvement récent : cadence REG_TELEM_RATE.
+    IDLE_ST_IDLE,       ///< Au repos : cadence REG_IDLE_RATE.
+    IDLE_ST_ERROR       ///< Détection de mouvement indisponible (INT1 occupée, capteur).
+} idle_state_t;
+
+/** @brief Demande REG_NV_CMD : enregistre les registres persistants modifiés. */
+#define NV_CMD_SAVE          1u
+/** @brief Demande REG_NV_CMD : efface la configuration enregistrée (défauts au démarrage suivant). */
+#define NV_CMD_CLEAR         2u
+/**
+ * @brief Demande REG_NV_CMD : ouvre le banc de préparation (l'éventuel banc ouvert est abandonné).
+ * @details Les écritures des registres REG_F_NV y sont retenues sans effet ; leur
+ * relecture rend la valeur en service jusqu'à la validation.
+ */
+#define NV_CMD_STAGE         3u
+/** @brief Demande REG_NV_CMD : applique d'un bloc les registres préparés, par adresse croissante. */
+#define NV_CMD_COMMIT        4u
+/** @brief Demande REG_NV_CMD : abandonne les registres préparés. */
+#define NV_CMD_DISCARD       5u
+
+/**
+ * @brief Résultat de la dernière opération sur la configuration persistante (REG_NV_CMD).
+ */
+typedef enum{
+    NV_ST_DEFAULTS=0,   ///< Aucune configuration enregistrée : valeurs compilées.
+    NV_ST_LOADED,       ///< Configuration enregistrée appliquée au démarrage.
+    NV_ST_SAVED,        ///< Sauvegarde réussie.
+    NV_ST_CLEARED,      ///< Configuration effacée.
+    NV_ST_E_FLASH,      ///< Échec d'effacement ou de programmation de la flash.
+    NV_ST_E_BUSY,       ///< Demande refusée : moteur en mouvement (validation : file pleine, à renvoyer).
+    NV_ST_E_INVALID,    ///< Demande inconnue (ou validation sans banc de préparation).
+    NV_ST_STAGING,      ///< Banc de préparation ouvert.
+    NV_ST_COMMITTED,    ///< Registres préparés appliqués.
+    NV_ST_DISCARDED     ///< Registres préparés abandonnés.
+} nv_status_t;
+
+/** @brief Base des sondes hors ordonnanceur dans REG_PROF_SEL. */
+#define PROF_SEL_PROBE      0x10u
+/** @brief Bit de REG_PROF_SEL choisissant le profil de retard de libération d'une tâche. */
+#define PROF_SEL_LATENESS   0x40u
+/** @brief Bit de remise à zéro des profils dans REG_PROF_SEL. */
+#define PROF_SEL_RESET      0x80u
+
+/** @brief Taille de lot du registre REG_TELEM_BATCH. */
+#define TELEM_BATCH_SIZE(v)         ((uint8_t)((uint16_t)(v) & 0xFFu))
+/** @brief Latence maximale (ms) du registre REG_TELEM_BATCH. */
+#define TELEM_BATCH_LATENCY_MS(v)   ((uint8_t)((uint16_t)(v) >> 8))
+/** @brief Valeur de REG_TELEM_BATCH au démarrage : lots de taille maximale, sans attente. */
+#define TELEM_BATCH_DEFAULT         TELEM_DELTA_MAX_SAMPLES
+
+/** @brief Masque du flux rapide du registre REG_TELEM_FIELDS. */
+#define TELEM_FIELDS_FAST(v)        ((uint8_t)((uint16_t)(v) & 0xFFu))
+/** @brief Masque du flux d'état lent du registre REG_TELEM_FIELDS. */
+#define TELEM_FIELDS_STATUS(v)      ((uint8_t)((uint16_t)(v) >> 8))
+/** @brief Format du flux rapide du registre REG_TELEM_FORMAT. */
+#define TELEM_FORMAT_MODE(v)        ((uint8_t)((uint16_t)(v) & 0xFFu))
+/** @brief Cadence du flux d'état lent (Hz) du registre REG_TELEM_FORMAT. */
+#define TELEM_STATUS_RATE_HZ(v)     ((uint8_t)((uint16_t)(v) >> 8))
+/** @brief Cadence maximale du flux d'état lent (Hz). */
+#define TELEM_STATUS_RATE_MAX_HZ    50u
+
+/** @brief Format historique : trame complète (0x01/0x02) ou à contenu choisi (0x03) selon REG_TELEM_FIELDS. */
+#define TELEM_FMT_LEGACY        0u
+/** @brief Format compact : axes int16 bruts (0x04), rafales regroupées en lot delta (0x05). */
+#define TELEM_FMT_COMPACT       1u
+
+/** @brief Cadence de télémétrie minimale (Hz). */
+#define TELEM_RATE_MIN_HZ       10u
+/** @brief Cadence de télémétrie maximale (Hz). */
+#define TELEM_RATE_MAX_HZ       1000u
+/** @brief Cadence de télémétrie au démarrage (Hz). */
+#define TELEM_RATE_DEFAULT_HZ   100u
+/** @brief Délai sans mouvement avant passage à la cadence de veille (ms). */
+#define TELEM_IDLE_HOLD_MS_DEFAULT  5000u
+/** @brief Seuil de détection de mouvement par défaut (mg). */
+#define TELEM_MOTION_MG_DEFAULT     80u
+/** @brief Durée de dépassement du seuil avant détection de mouvement (ms). */
+#define TELEM_MOTION_DURATION_MS    100u
+/** @brief Décimation maximale de la régulation de débit (REG_TELEM_ADAPT). */
+#define TELEM_ADAPT_DECIM_MAX       16u
+/** @brief Décimation maximale par défaut. */
+#define TELEM_ADAPT_DEFAULT         8u
+/** @brief Fenêtre d'évaluation de la régulation de débit (ms). */
+#define TELEM_ADAPT_WINDOW_MS       100u
+/** @brief Place libre TX (% du buffer) sous laquelle la fenêtre est saturée. */
+#define TELEM_ADAPT_LOW_PCT         25u
+/** @brief Place libre TX (% du buffer) au-dessus de laquelle la fenêtre est dégagée. */
+#define TELEM_ADAPT_HIGH_PCT        75u
+/** @brief Fenêtres dégagées consécutives avant de diviser la décimation par deux. */
+#define TELEM_ADAPT_CALM_WINDOWS    10u
+
+/** @brief Longueur maximale d'une trame de télémétrie type 0x03 (tous champs PROTO_TELEM_FIELDS). */
+#define TELEM_FRAME_MAX_LEN     (4u + 2u + 4u + 1u + PROTO_TELEM_FIELDS_LEN + 1u)
+
+/** @brief Taille d'un bloc du pool de trames (trame type 0x03 la plus longue, transaction SPI_LINK). */
+#define FRAME_POOL_BLOCK_LEN    64u
+/** @brief Blocs du pool de trames (un en construction, deux tenus par la liaison SPI, une marge). */
+#ifndef FRAME_POOL_BLOCKS
+#define FRAME_POOL_BLOCKS       4u
+#endif
+/** @brief Pool des trames construites dans la boucle principale et confiées à un étage d'émission. */
+extern pool_t frame_pool;
+
+/** @brief Code débit 115200 bauds (débit de démarrage et de repli). */
+#define SERIAL_BAUD_CODE_115200   0
+/** @brief Code débit 460800 bauds. */
+#define SERIAL_BAUD_CODE_460800   1
+/** @brief Code débit 921600 bauds. */
+#define SERIAL_BAUD_CODE_921600   2
+/** @brief Code débit 2 Mbauds. */
+#define SERIAL_BAUD_CODE_2M       3
+
+/**
+ * @brief Délai accordé à l'hôte pour confirmer le nouveau débit (ms).
+ * @note  Sans trame valide reçue au nouveau débit dans ce délai, retour à 115200 bauds.
+ */
+#define SERIAL_BAUD_CONFIRM_MS    1000u
+
+/**
+ * @name Champs du registre REG_IMU_CONFIG
+ * Bits 0-1 : gamme accéléromètre, bits 2-4 : gamme gyroscope,
+ * bits 5-8 : ODR accéléromètre, bits 9-11 : ODR/BW gyroscope,
+ * bits 12-13 : bande passante accéléromètre (0 = OSR4, 2 = normale),
+ * bits 14-15 : profil latence / bruit (bmi088_profile_t). Un profil non nul remplace
+ * les champs ODR et bande passante ; en lecture, il est déduit de la configuration active.
+ * @{
+ */
+#define IMU_CFG_ACC_RANGE(v)    ((uint8_t)((v) & 0x03u))
+#define IMU_CFG_GYR_RANGE(v)    ((uint8_t)(((v) >> 2) & 0x07u))
+#define IMU_CFG_ACC_ODR(v)      ((uint8_t)(((v) >> 5) & 0x0Fu))
+#define IMU_CFG_GYR_ODR(v)      ((uint8_t)(((v) >> 9) & 0x07u))
+#define IMU_CFG_ACC_BW(v)       ((uint8_t)(BMI08_ACCEL_BW_OSR4 + (((v) >> 12) & 0x03u)))
+#define IMU_CFG_PROFILE(v)      ((uint8_t)(((v) >> 14) & 0x03u))
+#define IMU_CFG_PROFILE_SHIFT   14
+#define IMU_CFG_PACK(c)         ((uint16_t)(((c)->accel_range & 0x03u) | \
+                                            (((c)->gyro_range & 0x07u) << 2) | \
+                                            (((c)->accel_odr & 0x0Fu) << 5) | \
+                                            (((c)->gyro_odr & 0x07u) << 9) | \
+                                            ((((c)->accel_bw - BMI08_ACCEL_BW_OSR4) & 0x03u) << 12)))
+/** @} */
 
 /**
  * @brief Structure de la trame de télémétrie envoyée vers la Pi5.
  * @note  Structure "packed" pour éviter le padding et garantir l'alignement binaire.
- * Format total : 4 (Header/Meta) + 4 (Time) + 12 (Accel) + 12 (Gyro) + 4 (Speed) + 1 (CRC) = 37 octets.
+ * Format total : 4 (Header/Meta) + 2 (Seq) + 4 (Time) + 12 (Accel) + 12 (Gyro) + 4 (Speed) + 1 (CRC) = 39 octets.
+ * Champs : PROTO_LAYOUT_LEGACY (proto_def.h).
+ */
+typedef PROTO_STRUCT(LEGACY) SerialImuFrame_t;
+
+/** @brief Format de télémétrie : 0 = flottants (SerialImuFrame_t), 1 = virgule fixe (SerialImuFrameFx_t). */
+#define TELEMETRY_FIXED_POINT 0
+
+/**
+ * @brief Variante virgule fixe de la trame de télémétrie (type 0x02).
+ * @note  Aucune conversion flottante côté MCU : l'hôte divise par 1000 (accélération
+ * en mm/s² -> m/s²), 1e6 (gyroscope en µrad/s -> rad/s) et 1000 (vitesse en mm/s -> m/s).
+ * Format total : 4 (Header/Meta) + 2 (Seq) + 4 (Time) + 12 (Accel) + 12 (Gyro) + 2 (Speed) + 1 (CRC) = 37 octets.
+ * Champs : PROTO_LAYOUT_FX (proto_def.h).
+ */
+typedef PROTO_STRUCT(FX) SerialImuFrameFx_t;
+
+/**
+ * @brief Trame de télémétrie compacte (type 0x04), axes bruts du capteur.
+ * @note  L'hôte applique les facteurs d'échelle donnés par `ranges` (gammes BMI088).
+ * Format total : 4 (Header/Meta) + 2 (Seq) + 4 (Time) + 1 (Ranges) + 12 (Accel/Gyro) + 2 (Speed) + 1 (CRC) = 26 octets.
+ * Champs : PROTO_LAYOUT_COMPACT (proto_def.h).
+ */
+typedef PROTO_STRUCT(COMPACT) SerialImuFrameCompact_t;
+
+/**
+ * @brief Réponse à une écriture de REG_PING (type 0x06), dates en µs (GetMicrosTotal).
+ * @note  Le jeton occupe la place du numéro de séquence des trames de télémétrie, sans
+ * le faire avancer. Format total : 4 (Header/Meta) + 2 (Jeton) + 4 x 4 (Dates) + 1 (CRC) = 23 octets.
+ * Champs : PROTO_LAYOUT_ECHO (proto_def.h).
  */
-typedef struct __attribute__((packed)) {
-    uint8_t head1;      ///< Octet de synchronisation 1 (0xAA).
-    uint8_t head2;      ///< Octet de synchronisation 2 (0x55).
-    uint8_t type;       ///< Type de packet (0x01 pour Télémétrie).
-    uint8_t len;        ///< Longueur du payload (32 octets).
-    uint32_t timestamp; ///< Timestamp système (HAL_GetTick).
-    float accel[3];     ///< Données Accéléromètre [X, Y, Z] en mm/s².
-    float gyro[3];      ///< Données Gyroscope [X, Y, Z] en rad/s.
-    float speed;		///< Vitesse linéaire du véhicule en m/s.
-    uint8_t crc;        ///< Checksum CRC-8 pour validation de l'intégrité.
-} SerialImuFrame_t;
+typedef PROTO_STRUCT(ECHO) SerialEchoFrame_t;
+
+/**
+ * @brief Capacités du firmware (type 0x0B), réponse à une écriture de REG_CAPS.
+ * @note  Format total : 4 (Header/Meta) + 19 (Payload) + 1 (CRC) = 24 octets.
+ * Champs : PROTO_LAYOUT_CAPS (proto_def.h).
+ */
+typedef PROTO_STRUCT(CAPS) SerialCapsFrame_t;
+
+/**
+ * @brief État instantané du véhicule (type 0x0E), réponse à une écriture de REG_SNAPSHOT.
+ * @note  Format total : 4 (Header/Meta) + 48 (Payload) + 1 (CRC) = 53 octets.
+ * Champs : PROTO_LAYOUT_SNAP (proto_def.h).
+ */
+typedef PROTO_STRUCT(SNAP) SerialSnapFrame_t;
+
+/**
+ * @brief Acquittement de mise à jour du firmware (type 0x10), réponse à une écriture de REG_FW_UPDATE.
+ * @note  Format total : 4 (Header/Meta) + 9 (Payload) + 1 (CRC) = 14 octets.
+ * Champs : PROTO_LAYOUT_FW (proto_def.h).
+ */
+typedef PROTO_STRUCT(FW) SerialFwFrame_t;
+
+/**
+ * @brief Relevé de faute persistant (type 0x11), émis après un redémarrage sur faute.
+ * @note  Format total : 4 (Header/Meta) + 56 (Payload) + 1 (CRC) = 61 octets.
+ * Champs : PROTO_LAYOUT_FAULT (proto_def.h).
+ */
+typedef PROTO_STRUCT(FAULT) SerialFaultFrame_t;
+
+/**
+ * @brief Résultat d'un accès direct aux registres IMU (type 0x12).
+ * @note  Format total : 4 (Header/Meta) + 21 (Payload) + 1 (CRC) = 26 octets.
+ * Champs : PROTO_LAYOUT_BMIREG (proto_def.h).
+ */
+typedef PROTO_STRUCT(BMIREG) SerialBmiRegFrame_t;
+
+PROTO_ASSERT_FIXED_FRAMES()
+
+/**
+ * @name Lot delta (type 0x05)
+ * Payload : SEQ (uint16) | TIME32 (µs) | RANGES | COUNT | SPEED (int16 mm/s) | 1er échantillon (6 x int16),
+ * puis pour chaque échantillon suivant : DT (uint16, µs depuis le précédent, saturé)
+ * et 6 deltas int8 par rapport au précédent. Un delta hors [-127, 127] est remplacé
+ * par TELEM_DELTA_ESCAPE suivi de la valeur absolue int16 de l'axe.
+ * @{
+ */
+#define TELEM_DELTA_MAX_SAMPLES 12u
+#define TELEM_DELTA_ESCAPE      ((int8_t)-128)
+/** @brief Longueur maximale d'une trame lot delta (tous les deltas échappés). */
+#define TELEM_DELTA_MAX_LEN     (4u + 2u + 20u + (TELEM_DELTA_MAX_SAMPLES - 1u) * 20u + 1u)
+/** @} */
+
+/**
+ * @brief Échantillon brut daté, entrée du lot delta.
+ */
+typedef struct {
+    bmi088_raw_t raw;       ///< Axes bruts (LSB).
+    uint64_t timestamp_us;  ///< Date d'acquisition (µs, GetMicros64).
+} telem_raw_sample_t;
+
+/**
+ * @brief Données hors IMU de la trame de télémétrie à contenu choisi.
+ */
+typedef struct {
+    int16_t  speed_mms;          ///< Vitesse signée du véhicule (mm/s).
+    int16_t  motor_cmd_mms;      ///< Consigne moteur courante (mm/s).
+    uint8_t  motor_state;        ///< État de la machine à états moteur (MotorState_t).
+    int8_t   servo_cmd;          ///< Consigne servo courante (°).
+    uint32_t cmd_latency_max_us; ///< Latence réception -> application maximale (µs).
+    uint32_t imu_dropped;        ///< Échantillons IMU perdus depuis le démarrage.
+    int16_t  attitude_q14[4];    ///< Attitude estimée à la date de l'échantillon (quaternion Q14).
+    int16_t  imu_temp_cdeg;      ///< Température IMU (c°C, BMI088_TEMP_UNKNOWN avant la première lecture).
+} telem_status_t;
 
 /**
  * @brief Indicateur de résultat du parsing pour la boucle principale.
@@ -44,17 +643,133 @@ typedef enum{
     PARSER_SERVO_CMD,   ///< Une commande Servo a été reçue et validée.
     PARSER_MOTOR_CMD,   ///< Une commande Moteur a été reçue et validée.
     PARSER_BMI_CMD,     ///< Une commande BMI a été reçue.
+    PARSER_IMU_CFG,     ///< Une nouvelle configuration IMU a été reçue.
+    PARSER_SPI_PRESC,   ///< Un nouveau prédiviseur SPI1 a été reçu.
+    PARSER_SPI_BENCH,   ///< Une demande de benchmark SPI a été reçue.
+    PARSER_SPEED_GAINS, ///< Un gain de la boucle de vitesse a été modifié.
+    PARSER_ESC_PROFILE, ///< Une temporisation de l'ESC a été modifiée.
+    PARSER_SERVO_CDEG,  ///< Une commande Servo en centi-degrés a été reçue.
+    PARSER_SERVO_SLEW,  ///< La limitation de vitesse du servo a été modifiée.
+    PARSER_ATT_GAIN,    ///< Le gain de l'estimateur d'attitude a été modifié.
+    PARSER_IMU_CAL,     ///< Une demande de calibration IMU a été reçue.
+    PARSER_NV_CMD,      ///< Une demande sur la configuration persistante a été reçue.
+    PARSER_MOTION_CFG,  ///< La mise en veille de la télémétrie a été reconfigurée.
+    PARSER_PING,        ///< Un écho de mesure de latence a été demandé.
+    PARSER_HIST,        ///< Commande, réglage ou téléchargement de l'historique IMU.
+    PARSER_ODOM,        ///< Une commande de l'odométrie a été reçue.
+    PARSER_TRAJ,        ///< Une commande du tampon de trajectoire a été reçue.
+    PARSER_RAMP,        ///< Une borne des profils de consigne a été modifiée.
+    PARSER_IMU_FILT,    ///< L'ordre du filtre anti-repliement a été modifié.
+    PARSER_VIB,         ///< L'analyse vibratoire a été reconfigurée.
+    PARSER_ACT,         ///< Sélection ou consigne de la fenêtre d'actionneurs.
+    PARSER_CAPS,        ///< La trame de capacités a été demandée.
+    PARSER_SNAPSHOT,    ///< La trame d'état instantané a été demandée.
+    PARSER_KIN,         ///< Une commande cinématique (vitesse ou courbure) a été reçue.
     PARSER_OTHERS       ///< Une autre commande a été reçue.
 } ParserSwitch;
 
-/** @brief État global du parseur, lu par le main pour appliquer les consignes. */
-extern ParserSwitch parser_state;
+/**
+ * @brief Profondeur de la file de commandes (puissance de 2).
+ * @note  Doit rester supérieure à PROTO_BURST_MAX_REGS : une trame groupée est toujours
+ * mise en file en entier.
+ */
+#define SERIAL_CMD_QUEUE_LEN    32u
+
+/**
+ * @brief Commande décodée en attente d'application par la boucle principale.
+ */
+typedef struct {
+    uint8_t  type;      ///< Type de commande (ParserSwitch).
+    uint8_t  addr;      ///< Adresse du registre écrit.
+    int16_t  value;     ///< Valeur écrite.
+    uint32_t t_us;      ///< Date de décodage et de mise en file (GetMicrosTotal), pour la mesure de latence.
+    uint32_t t_rx_us;   ///< Date d'arrivée des octets (serial_rx_last_us()), en amont du ring RX.
+} serial_cmd_t;
+
+/**
+ * @brief  Retire la plus ancienne commande de la file.
+ * @param  cmd Commande extraite.
+ * @return 1 si une commande a été extraite, 0 si la file est vide.
+ */
+uint8_t serial_cmd_pop(serial_cmd_t *cmd);
+
+/**
+ * @brief  Nombre de commandes en attente dans la file.
+ * @return Nombre d'entrées occupées.
+ */
+uint32_t serial_cmd_pending(void);
+
+/**
+ * @brief  Numéro de séquence de la prochaine trame de télémétrie.
+ * @return Nombre de trames émises (modulo 65536).
+ */
+uint16_t serial_telem_seq(void);
+
+/**
+ * @brief  Restaure au démarrage les registres persistants enregistrés en flash.
+ * @details Chaque valeur suit le chemin d'une écriture série (validation, reg_file,
+ * file de commandes) : la boucle principale l'applique comme une commande reçue.
+ * @note   À appeler avant l'initialisation des actionneurs, qui lisent leurs limites
+ * dans reg_file. Les registres REG_F_NV doivent tenir dans SERIAL_CMD_QUEUE_LEN.
+ */
+void serial_cmd_nv_restore(void);
+
+/**
+ * @brief  Exécute une demande REG_NV_CMD (bloquant : effacement flash de 40 ms au plus).
+ * @param  request Demande NV_CMD_*.
+ * @param  allowed 0 si l'application refuse l'arrêt de la boucle principale (moteur en mouvement).
+ * @return Résultat, également lu dans REG_NV_CMD.
+ */
+nv_status_t serial_cmd_nv_exec(uint8_t request, uint8_t allowed);
+
+/** @brief Nombre d'adresses de registres virtuels (adresse 7 bits du protocole). */
+#define REG_COUNT       128u
+
+/** @brief Registre lisible. */
+#define REG_F_R         0x01u
+/** @brief Registre inscriptible (valeur mémorisée dans reg_file). */
+#define REG_F_W         0x02u
+/** @brief Registre lisible et inscriptible. */
+#define REG_F_RW        (REG_F_R | REG_F_W)
+/** @brief Registre de configuration enregistré par NV_CMD_SAVE et restauré au démarrage. */
+#define REG_F_NV        0x04u
+
+/**
+ * @brief  Lecture d'un registre calculé (non mémorisé dans reg_file).
+ * @param  addr Adresse du registre.
+ * @return Valeur courante du registre.
+ */
+typedef int16_t (*reg_read_hook_t)(uint8_t addr);
+
+/**
+ * @brief  Traitement d'une écriture de registre, avant mémorisation.
+ * @param  addr  Adresse du registre.
+ * @param  value Valeur reçue.
+ * @return Valeur effectivement retenue (bornée, masquée...).
+ */
+typedef int16_t (*reg_write_hook_t)(uint8_t addr, int16_t value);
 
-/** @brief Dernière consigne reçue pour le servo (Shadow Register). */
-extern int8_t shadow_servo_cmd;
+/**
+ * @brief Descripteur d'un registre virtuel.
+ * @note  Tous les registres font 16 bits et sont stockés dans `reg_file[addr]` :
+ * une plage de registres lisibles sans read hook est lue d'un seul memcpy.
+ */
+typedef struct {
+    uint8_t          flags;     ///< Droits d'accès (REG_F_*).
+    uint8_t          cmd;       ///< Commande (ParserSwitch) mise en file à l'écriture.
+    reg_read_hook_t  read;      ///< Lecture calculée (NULL : valeur de reg_file).
+    reg_write_hook_t write;     ///< Traitement de l'écriture (NULL : valeur brute).
+} reg_desc_t;
 
-/** @brief Dernière consigne reçue pour le moteur (Shadow Register). */
-extern int16_t shadow_motor_cmd;
+/**
+ * @brief Banc de registres virtuels indexé par adresse (Shadow Registers).
+ * @note  Contient la dernière valeur écrite de chaque registre inscriptible
+ * (consignes servo et moteur, configuration IMU, prédiviseur SPI...).
+ */
+extern int16_t reg_file[REG_COUNT];
+
+/** @brief Dernier résultat du benchmark SPI en 0.1 µs par lecture (-1 si échec). */
+extern int16_t shadow_spi_bench_res;
 
 /**
  * @brief  Fonction de lecture périodique des commandes entrantes.
@@ -63,10 +778,125 @@ extern int16_t shadow_motor_cmd;
 void serial_cmd_reader(void);
 
 /**
- * @brief  Capture les capteurs et envoie la trame de télémétrie.
- * @details Lit l'IMU et le compteur de vitesse, remplit SerialImuFrame_t,
- * calcule le CRC et transmet via DMA.
+ * @brief  Décode un bloc de trames de commande complètes, hors flux série.
+ * @details Utilisé par les transports à trames fixes (spi_link.h). Disponible si
+ * SERIAL_CMD_FRAMED vaut 1 (les trames doivent commencer par un octet de synchronisation).
+ * @param  data Bloc reçu (trames complètes, bourrage quelconque).
+ * @param  len  Longueur du bloc.
+ */
+void serial_cmd_feed_block(const uint8_t *data, size_t len);
+
+/**
+ * @brief  Lit des registres hors liaison (console texte).
+ * @param  addr  Premier registre.
+ * @param  count Nombre de registres.
+ * @param  out   Valeurs lues.
+ */
+void serial_cmd_reg_read(uint8_t addr, uint8_t count, int16_t *out);
+
+/**
+ * @brief  Écrit un registre hors liaison, comme une trame de commande reçue.
+ * @param  addr  Registre.
+ * @param  value Valeur.
+ * @return 0 si succès, -1 si la file de commandes est pleine.
+ */
+int serial_cmd_reg_write(uint8_t addr, int16_t value);
+
+/**
+ * @brief  Envoie la trame de télémétrie pour un échantillon IMU.
+ * @details Associe l'échantillon IMU à la vitesse estimée, remplit SerialImuFrame_t
+ * champ par champ avec le CRC à la suite (en-tête précalculé), puis recopie la trame
+ * dans le ring TX.
+ * @param  imu_data Échantillon IMU en unités physiques.
+ */
+void serial_send_data_frame(const bmi088_data_t *imu_data);
+
+/**
+ * @brief  Envoie la trame de télémétrie virgule fixe pour un échantillon IMU.
+ * @param  imu_data Échantillon IMU en virgule fixe (mm/s², µrad/s).
+ */
+void serial_send_data_frame_fx(const bmi088_data_fx_t *imu_data);
+
+/**
+ * @brief  Envoie la trame de télémétrie à contenu choisi (type 0x03).
+ * @details Trame : [0xAA | 0x55 | 0x03 | LEN | SEQ | TIMESTAMP | FIELDS | champs TELEM_F_* | CRC]
+ * @param  fields   Masque des champs à émettre (TELEM_F_*).
+ * @param  imu_data Échantillon IMU en virgule fixe.
+ * @param  status   Données d'état (vitesse, moteur, servo, statistiques).
+ */
+void serial_send_telemetry(uint8_t fields, const bmi088_data_fx_t *imu_data, const telem_status_t *status);
+
+/**
+ * @brief  Construit et envoie une trame du flux d'état lent (type 0x0F).
+ * @details Même disposition que la trame à contenu choisi, datée de l'émission, avec
+ * son propre numéro de séquence : le comptage des pertes du flux rapide n'en dépend pas.
+ * Non publiée sur la liaison SPI.
+ * @param  fields   Masque des champs à émettre (TELEM_F_*).
+ * @param  imu_data Dernier échantillon IMU en virgule fixe.
+ * @param  status   Données d'état hors IMU.
+ */
+void serial_send_status(uint8_t fields, const bmi088_data_fx_t *imu_data, const telem_status_t *status);
+
+/**
+ * @brief  Envoie la trame de télémétrie compacte (type 0x04).
+ * @param  sample    Échantillon brut daté.
+ * @param  ranges    Gammes capteur (bits 0-1 accéléromètre, 2-4 gyroscope).
+ * @param  speed_mms Vitesse signée du véhicule (mm/s).
+ */
+void serial_send_compact_frame(const telem_raw_sample_t *sample, uint8_t ranges, int16_t speed_mms);
+
+/**
+ * @brief  Envoie un lot d'échantillons bruts encodés en delta (type 0x05).
+ * @param  samples   Échantillons, du plus ancien au plus récent.
+ * @param  count     Nombre d'échantillons (1 à TELEM_DELTA_MAX_SAMPLES).
+ * @param  ranges    Gammes capteur (bits 0-1 accéléromètre, 2-4 gyroscope).
+ * @param  speed_mms Vitesse signée du véhicule (mm/s).
+ */
+void serial_send_delta_batch(const telem_raw_sample_t *samples, uint8_t count, uint8_t ranges, int16_t speed_mms);
+
+/**
+ * @brief  Répond à une écriture de REG_PING par une trame d'écho (type 0x06).
+ * @param  token      Valeur écrite dans REG_PING.
+ * @param  t_parse_us Date de mise en file de la commande (serial_cmd_t::t_us).
+ * @param  t_app_us   Date de son traitement par la boucle principale.
+ */
+void serial_send_echo(uint16_t token, uint32_t t_parse_us, uint32_t t_app_us);
+
+/**
+ * @brief  Répond à une écriture de REG_CAPS par la trame de capacités (type 0x0B).
+ * @param  app_types Types de trame émis par l'application en plus de ceux des modules
+ *                   série (bit n pour le type n, ex. TELEM_TYPE_BENCH).
+ */
+void serial_send_caps(uint16_t app_types);
+
+/**
+ * @brief  Répond à une écriture de REG_SNAPSHOT par la trame d'état instantané (type 0x0E).
+ * @param  frame Trame dont le payload (après le jeton) est renseigné par l'appelant ;
+ *               entête, jeton et CRC sont complétés ici.
+ * @param  token Valeur écrite dans REG_SNAPSHOT.
+ */
+void serial_send_snapshot(SerialSnapFrame_t *frame, uint16_t token);
+
+/**
+ * @brief  Acquitte une commande de mise à jour du firmware (type 0x10).
+ * @param  op       Opcode de la commande (FW_OP_*).
+ * @param  status   Statut (FW_ST_*).
+ * @param  arg      Argument de la commande.
+ * @param  staged   Pages préparées.
+ * @param  page_crc CRC-32 de la page interrogée ou préparée.
+ */
+void serial_send_fw(uint8_t op, uint8_t status, uint16_t arg, uint8_t staged, uint32_t page_crc);
+
+/**
+ * @brief  Émet un relevé de faute (type 0x11).
+ * @param  rec Relevé (fault_log.h).
+ */
+void serial_send_fault(const fault_record_t *rec);
+
+/**
+ * @brief  Émet le résultat d'un accès direct aux registres IMU (type 0x12).
+ * @param  io Accès terminé (ou refusé : status).
  */
-void serial_send_data_frame(void);
+void serial_send_bmireg(const bmi088_regio_t *io);
 
 #endif
@@ -0,0 +1,60 @@
+/**
+ * @file    speed_est.h
+ * @brief   Estimateur de vitesse signée et filtrée.
+ * @details Filtre alpha-bêta en virgule fixe sur la vitesse mesurée par le tachymètre
+ * (capteur à effet Hall, sans information de sens), O(1) par mise à jour. Le sens est
+ * repris de la machine à états moteur, mais ne bascule qu'à vitesse quasi nulle :
+ * la roue ne peut pas changer de sens sans passer par l'arrêt (freinage, roue libre).
+ */
+
+#ifndef INC_SPEED_EST_H_
+#define INC_SPEED_EST_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @brief Nombre de bits fractionnaires de l'état du filtre (mm/s). */
+#define SPEED_EST_Q             4
+/** @brief Gain alpha du filtre (Q8, 0.375). */
+#define SPEED_EST_ALPHA_Q8      96
+/** @brief Gain bêta du filtre (Q8, ~0.086, amortissement critique pour alpha). */
+#define SPEED_EST_BETA_Q8       22
+/** @brief Vitesse (mm/s) en dessous de laquelle le sens peut basculer. */
+#define SPEED_EST_ZERO_MMS      30
+/** @brief Borne des mesures prises en compte (mm/s, évite les débordements). */
+#define SPEED_EST_RAW_MAX_MMS   20000
+
+/**
+ * @brief État de l'estimateur de vitesse.
+ */
+typedef struct{
+    int32_t speed_q;       ///< Vitesse filtrée, en valeur absolue (mm/s, Q SPEED_EST_Q).
+    int32_t rate_q;        ///< Variation estimée par échantillon (mm/s, Q SPEED_EST_Q).
+    bool    forward;       ///< Sens de déplacement estimé (true = avant).
+    bool    primed;        ///< Premier échantillon reçu.
+    int32_t speed_mms;     ///< Dernière vitesse estimée, signée (mm/s).
+} Speed_Estimator_t;
+
+/**
+ * @brief  Initialise l'estimateur (vitesse nulle, marche avant).
+ * @param  est Pointeur vers l'estimateur.
+ */
+void speed_est_init(Speed_Estimator_t *est);
+
+/**
+ * @brief  Intègre une nouvelle mesure (appel à période fixe).
+ * @param  est           Pointeur vers l'estimateur.
+ * @param  raw_mms       Vitesse mesurée par le tachymètre (mm/s, valeur absolue).
+ * @param  motor_forward Sens appliqué par la machine à états moteur.
+ * @return Vitesse estimée, signée (mm/s).
+ */
+int32_t speed_est_update(Speed_Estimator_t *est, int32_t raw_mms, bool motor_forward);
+
+/**
+ * @brief  Dernière vitesse estimée.
+ * @param  est Pointeur vers l'estimateur.
+ * @return Vitesse signée (mm/s, positive en marche avant).
+ */
+int32_t speed_est_get(const Speed_Estimator_t *est);
+
+#endif /* INC_SPEED_EST_H_ */
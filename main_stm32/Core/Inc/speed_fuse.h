@@ -0,0 +1,79 @@
+/**
+ * @file    speed_fuse.h
+ * @brief   Vitesse longitudinale fusionnée : accéléromètre (prédiction) et tachymètre (recalage).
+ * @details Filtre complémentaire en virgule fixe. Entre deux mesures du tachymètre
+ * (~5 fronts par tour de roue : vitesse grossière et en retard à basse vitesse), la
+ * vitesse est intégrée à chaque échantillon IMU à partir de l'accélération
+ * longitudinale, biais déduit. Chaque mesure du tachymètre ramène l'estimation vers
+ * la vitesse mesurée (gain SPEED_FUSE_KV_Q8) et corrige le biais (SPEED_FUSE_KB_Q8) :
+ * la pente du terrain et le décalage du capteur s'absorbent dans le biais. À l'arrêt
+ * (aucun front), la vitesse est forcée à zéro et le biais suit l'accélération mesurée.
+ *
+ * Prédiction et recalage s'exécutent dans la boucle principale (observateur IMU et
+ * tâche vitesse) : pas de concurrence sur l'état.
+ */
+
+#ifndef INC_SPEED_FUSE_H_
+#define INC_SPEED_FUSE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @brief Axe de l'accéléromètre orienté vers l'avant du véhicule (0 X, 1 Y, 2 Z). */
+#ifndef SPEED_FUSE_AXIS
+#define SPEED_FUSE_AXIS         0
+#endif
+/** @brief Signe de cet axe pour une accélération vers l'avant : +1 ou -1. */
+#ifndef SPEED_FUSE_SIGN
+#define SPEED_FUSE_SIGN         1
+#endif
+/** @brief Bits fractionnaires de la vitesse et du biais. */
+#define SPEED_FUSE_Q            8
+/** @brief Gain de recalage de la vitesse par mesure du tachymètre (Q8, 0.25). */
+#define SPEED_FUSE_KV_Q8        64
+/** @brief Gain de recalage du biais par mesure (mm/s² par mm/s d'écart, Q8, ~0.5). */
+#define SPEED_FUSE_KB_Q8        128
+/** @brief Gain de suivi du biais à l'arrêt, par échantillon IMU (décalage de bits). */
+#define SPEED_FUSE_STILL_SHIFT  6
+/** @brief Borne du biais estimé (mm/s², ~0.3 g : pente forte ou capteur mal monté). */
+#define SPEED_FUSE_BIAS_MAX     3000
+/** @brief Intervalle d'intégration maximal (µs) : au-delà (reprise, perte IMU), pas ignoré. */
+#define SPEED_FUSE_DT_MAX_US    20000u
+/** @brief 2^24 / 10^6 arrondi : mm/s² x µs -> mm/s en Q8 par multiplication et décalage de 24 bits. */
+#define SPEED_FUSE_US_RECIP     4295
+
+/**
+ * @brief État du filtre.
+ */
+typedef struct{
+    int32_t  v_q;           ///< Vitesse signée (mm/s, Q SPEED_FUSE_Q).
+    int32_t  bias_q;        ///< Biais de l'accélération longitudinale (mm/s², Q SPEED_FUSE_Q).
+    uint64_t last_us;       ///< Date du dernier échantillon IMU intégré (0 : aucun).
+    bool     still;         ///< Dernière mesure du tachymètre nulle (véhicule à l'arrêt).
+    int32_t  speed_mms;     ///< Dernière vitesse estimée, signée (mm/s).
+} speed_fuse_t;
+
+/**
+ * @brief  Initialise le filtre (arrêt, biais nul).
+ * @param  f Filtre.
+ */
+void speed_fuse_init(speed_fuse_t *f);
+
+/**
+ * @brief  Intègre un échantillon IMU (cadence d'acquisition).
+ * @param  f          Filtre.
+ * @param  accel_mms2 Accélération des trois axes (mm/s², bmi088_data_fx_t).
+ * @param  t_us       Date de l'échantillon (µs).
+ * @return Vitesse estimée, signée (mm/s).
+ */
+int32_t speed_fuse_predict(speed_fuse_t *f, const int32_t accel_mms2[3], uint64_t t_us);
+
+/**
+ * @brief  Recale sur une mesure du tachymètre (tâche vitesse).
+ * @param  f       Filtre.
+ * @param  enc_mms Vitesse mesurée, signée par le sens estimé (mm/s), 0 à l'arrêt.
+ * @return Vitesse estimée, signée (mm/s).
+ */
+int32_t speed_fuse_correct(speed_fuse_t *f, int32_t enc_mms);
+
+#endif /* INC_SPEED_FUSE_H_ */
@@ -0,0 +1,92 @@
+/**
+ * @file    speed_pub.h
+ * @brief   Publication sans attente de la vitesse estimée (un écrivain, lecteurs multiples).
+ * @details L'estimateur (tâche vitesse, ou interruption de capture du tachymètre) écrit
+ * chaque estimation dans l'emplacement suivant d'un petit anneau, puis publie son rang.
+ * Le lecteur copie l'emplacement du dernier rang publié, sans masquer les interruptions
+ * ni attendre l'écrivain : contrairement au verrou de séquence (seqlock.h), une
+ * publication pendant la copie ne l'invalide pas, l'emplacement lu n'étant réécrit
+ * qu'après SPEED_PUB_SLOTS - 1 nouvelles publications. Ce cas (lecteur suspendu pendant
+ * plusieurs périodes de l'estimateur) est détecté au rang et la copie recommencée.
+ *
+ * Utilisation :
+ * @code
+ * speed_pub_write(&pub, &sample);      // estimateur (écrivain unique)
+ *
+ * speed_sample_t s;                    // télémétrie, boucle de vitesse, odométrie
+ * const uint32_t n = speed_pub_read(&pub, &s);
+ * @endcode
+ */
+
+#ifndef INC_SPEED_PUB_H_
+#define INC_SPEED_PUB_H_
+
+#include <stdint.h>
+#include "stm32g0xx.h"
+
+/** @brief Emplacements de l'anneau (puissance de 2, >= 3). */
+#define SPEED_PUB_SLOTS         4u
+
+/**
+ * @brief Estimation publiée.
+ */
+typedef struct{
+    uint64_t t_us;          ///< Date de l'estimation (µs, GetMicros64()).
+    int32_t  speed_mms;     ///< Vitesse signée et filtrée (mm/s, positive en marche avant).
+    uint32_t ticks;         ///< Cumul des fronts du tachymètre à la date de l'estimation (modulo 2^32).
+    uint8_t  forward;       ///< Sens estimé (1 = avant), conservé à l'arrêt.
+} speed_sample_t;
+
+/**
+ * @brief Anneau de publication.
+ */
+typedef struct{
+    speed_sample_t   slot[SPEED_PUB_SLOTS];     ///< Estimations, rang n dans slot[n % SPEED_PUB_SLOTS].
+    volatile uint32_t count;                    ///< Rang de la dernière publication (0 : aucune).
+} speed_pub_t;
+
+/**
+ * @brief  Publie une estimation (écrivain unique).
+ * @param  pub    Anneau.
+ * @param  sample Estimation.
+ */
+static inline void speed_pub_write(speed_pub_t *pub, const speed_sample_t *sample){
+    const uint32_t n = pub->count + 1u;
+
+    pub->slot[n & (SPEED_PUB_SLOTS - 1u)] = *sample;
+    __DMB();
+    pub->count = n;
+}
+
+/**
+ * @brief  Copie la dernière estimation publiée, sans attendre l'écrivain.
+ * @param  pub Anneau.
+ * @param  out Copie de sortie (nulle avant la première publication).
+ * @return Rang de l'estimation copiée (publications depuis l'initialisation).
+ */
+static inline uint32_t speed_pub_read(const speed_pub_t *pub, speed_sample_t *out){
+    uint32_t n;
+
+    do{
+        n = pub->count;
+        __DMB();
+        *out = pub->slot[n & (SPEED_PUB_SLOTS - 1u)];
+        __DMB();
+    }
+    while((uint32_t)(pub->count - n) >= SPEED_PUB_SLOTS - 1u);
+    return n;
+}
+
+/**
+ * @brief  Dernière vitesse publiée.
+ * @param  pub Anneau.
+ * @return Vitesse signée (mm/s).
+ */
+static inline int32_t speed_pub_mms(const speed_pub_t *pub){
+    speed_sample_t s;
+
+    (void)speed_pub_read(pub, &s);
+    return s.speed_mms;
+}
+
+#endif /* INC_SPEED_PUB_H_ */
@@ -0,0 +1,148 @@
+/**
+ * @file    spi_bus.h
+ * @brief   Ordonnanceur de transactions DMA sur le bus SPI1 partagé entre capteurs.
+ * @details Chaque capteur est enregistré comme un périphérique (Chip Select, priorité)
+ * doté d'une file de SPI_BUS_QUEUE_LEN transactions (buffers, longueur, callback).
+ * Une seule transaction occupe le bus : à sa fin (interruption DMA RX), le CS est
+ * relâché, le callback du périphérique est appelé puis la transaction suivante est
+ * choisie dans la file non vide de plus haute priorité, à tour de rôle entre
+ * périphériques de même priorité. Chaque capteur est ainsi lu à sa propre cadence
+ * sans attendre les autres ni bloquer la boucle principale.
+ *
+ * Les transferts bloquants (configuration, récupération) prennent le bus par
+ * spi_bus_lock() : les transactions soumises entre-temps restent en file et partent à
+ * spi_bus_unlock().
+ *
+ * Statistiques par périphérique : transactions, octets, erreurs, refus (file pleine)
+ * et attente maximale entre soumission et début de transfert.
+ */
+
+#ifndef INC_SPI_BUS_H_
+#define INC_SPI_BUS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stm32g0xx_hal.h"
+
+/**
+ * @brief Transactions DMA programmées au niveau registre (1) ou via HAL_SPI_TransmitReceive_DMA (0).
+ * @details Mode 1 : les canaux DMA du SPI1 sont réarmés par CNDTR/CMAR/EN, seule la fin
+ * de réception lève une interruption, servie par spi_bus_dma_rx_irq() avant le handler
+ * HAL ; l'enchaînement des transactions se fait sans la machine à états HAL SPI.
+ */
+#ifndef SPI_BUS_DMA_LL
+#define SPI_BUS_DMA_LL          1
+#endif
+
+/** @brief Nombre maximal de périphériques sur le bus. */
+#ifndef SPI_BUS_DEV_MAX
+#define SPI_BUS_DEV_MAX         4u
+#endif
+/** @brief Transactions en attente par périphérique (puissance de 2). */
+#ifndef SPI_BUS_QUEUE_LEN
+#define SPI_BUS_QUEUE_LEN       4u
+#endif
+
+/** @brief Identifiant invalide rendu par spi_bus_add_device(). */
+#define SPI_BUS_DEV_NONE        0xFFu
+
+/** @brief Transaction terminée. */
+#define SPI_BUS_OK              INT8_C(0)
+/** @brief Erreur de transfert DMA. */
+#define SPI_BUS_E_XFER          INT8_C(-1)
+/** @brief Démarrage refusé par le périphérique SPI. */
+#define SPI_BUS_E_START         INT8_C(-2)
+
+/**
+ * @brief  Fin de transaction (contexte interruption, CS déjà relâché).
+ * @details Peut soumettre une nouvelle transaction (enchaînement de lectures).
+ * @param  ctx    Contexte de la transaction.
+ * @param  status SPI_BUS_OK ou code d'erreur SPI_BUS_E_*.
+ */
+typedef void (*spi_bus_cb_t)(void *ctx, int8_t status);
+
+/**
+ * @brief Transaction full-duplex.
+ */
+typedef struct{
+    const uint8_t *tx;      ///< Octets émis (RAM accessible au DMA).
+    uint8_t *rx;            ///< Octets reçus (RAM accessible au DMA).
+    uint16_t len;           ///< Longueur (octets).
+    spi_bus_cb_t done;      ///< Callback de fin, ou NULL.
+    void *ctx;              ///< Contexte du callback.
+} spi_bus_xfer_t;
+
+/**
+ * @brief Statistiques d'un périphérique.
+ */
+typedef struct{
+    uint32_t xfers;         ///< Transactions terminées.
+    uint32_t bytes;         ///< Octets transférés.
+    uint32_t errors;        ///< Transactions en erreur ou abandonnées.
+    uint32_t rejected;      ///< Soumissions refusées (file pleine).
+    uint32_t wait_max_us;   ///< Attente maximale avant transfert (µs).
+} spi_bus_stats_t;
+
+/**
+ * @brief  Relie l'ordonnanceur au handle SPI et oublie les périphériques enregistrés.
+ * @param  hspi Handle SPI initialisé (canaux DMA TX/RX liés).
+ */
+void spi_bus_init(SPI_HandleTypeDef *hspi);
+
+/**
+ * @brief  Enregistre un périphérique et relâche son Chip Select.
+ * @param  port     Port GPIO du CS (actif bas).
+ * @param  pin      Broche du CS.
+ * @param  priority Priorité (0 = la plus haute).
+ * @return Identifiant, SPI_BUS_DEV_NONE si la table est pleine.
+ */
+uint8_t spi_bus_add_device(GPIO_TypeDef *port, uint16_t pin, uint8_t priority);
+
+/**
+ * @brief  Met une transaction en file ; la lance si le bus est libre.
+ * @note   Utilisable en interruption ; la transaction est copiée.
+ * @param  dev  Identifiant du périphérique.
+ * @param  xfer Transaction.
+ * @return true si la transaction est acceptée, false si la file est pleine.
+ */
+bool spi_bus_submit(uint8_t dev, const spi_bus_xfer_t *xfer);
+
+/**
+ * @brief  Réserve le bus pour des transferts bloquants.
+ * @return true si le bus est libre et réservé, false si une transaction est en cours.
+ */
+bool spi_bus_lock(void);
+
+/**
+ * @brief  Libère le bus réservé et lance la première transaction en attente.
+ */
+void spi_bus_unlock(void);
+
+/**
+ * @brief  Indique si une transaction est en cours ou en attente.
+ * @return true si le bus a du travail.
+ */
+bool spi_bus_busy(void);
+
+/**
+ * @brief  Interrompt la transaction en cours, relâche tous les CS et vide les files.
+ * @details Les callbacks des transactions abandonnées ne sont pas appelés ; chaque
+ * transaction perdue est comptée en erreur.
+ */
+void spi_bus_abort(void);
+
+/**
+ * @brief  Sert la fin de réception DMA d'une transaction (SPI_BUS_DMA_LL).
+ * @details À appeler depuis le vecteur du canal DMA SPI1 RX, avant HAL_DMA_IRQHandler.
+ * @return 1 si l'interruption concernait une transaction au niveau registre, 0 sinon.
+ */
+uint8_t spi_bus_dma_rx_irq(void);
+
+/**
+ * @brief  Statistiques d'un périphérique.
+ * @param  dev   Identifiant.
+ * @param  stats Copie de sortie (mise à zéro si l'identifiant est inconnu).
+ */
+void spi_bus_get_stats(uint8_t dev, spi_bus_stats_t *stats);
+
+#endif /* INC_SPI_BUS_H_ */
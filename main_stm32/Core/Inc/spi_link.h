@@ -0,0 +1,120 @@
+/**
+ * @file    spi_link.h
+ * @brief   Liaison SPI esclave rapide vers le calculateur de bord (SPI2 + DMA).
+ * @details Transactions de taille fixe SPI_LINK_FRAME_LEN, cadencées par l'hôte
+ * (maître) : dans le même transfert, l'hôte émet ses trames de commande et reçoit la
+ * dernière trame de télémétrie publiée.
+ *
+ * - MOSI (hôte -> MCU) : trames de commande du protocole série (PROTO_SYNC /
+ *   PROTO_SYNC_BURST, registres de serial_cmd.h) mises bout à bout, bourrage à 0x00.
+ *   Les réponses aux lectures partent sur le port série.
+ * - MISO (MCU -> hôte) : dernière trame de télémétrie type 0x03 (même format que sur
+ *   l'UART, REG_TELEM_FIELDS), complétée par des 0x00 ; premier octet nul tant
+ *   qu'aucune trame n'a été publiée.
+ *
+ * En émission, la télémétrie arrive dans un bloc de frame_pool (serial_cmd.h) remis par
+ * pointeur : il attend en arrière-plan et devient la trame émise au réarmement suivant,
+ * l'ancien bloc retournant au pool. Les buffers de réception sont doublés : la
+ * réception est décodée par la boucle principale pendant que la transaction suivante
+ * arrive dans l'autre buffer.
+ * L'hôte laisse au moins SPI_LINK_GAP_US entre la fin d'une transaction (NSS haut) et
+ * le début de la suivante, le temps du réarmement en interruption.
+ */
+
+#ifndef INC_SPI_LINK_H_
+#define INC_SPI_LINK_H_
+
+#include <stdint.h>
+
+/** @brief Liaison SPI esclave active (1) ou absente (0, SPI2 et ses broches non configurés). */
+#ifndef SPI_LINK_ENABLE
+#define SPI_LINK_ENABLE     0
+#endif
+
+/** @brief Taille d'une transaction (octets), égale à la plus longue trame de télémétrie. */
+#define SPI_LINK_FRAME_LEN  64u
+/** @brief Intervalle minimal entre deux transactions demandé à l'hôte (µs). */
+#define SPI_LINK_GAP_US     10u
+/** @brief Transaction entamée puis abandonnée par l'hôte au-delà de ce délai, NSS haut (ms). */
+#define SPI_LINK_STALL_MS   5u
+
+/**
+ * @name Broches SPI2 (fonctions alternées)
+ * @brief PB13/PB14 étant les CS de l'IMU, SCK et MISO sont pris hors des broches SPI2 par défaut.
+ * @{
+ */
+#ifndef SPI_LINK_NSS_PORT
+#define SPI_LINK_NSS_PORT   GPIOB
+#define SPI_LINK_NSS_PIN    GPIO_PIN_12
+#define SPI_LINK_NSS_AF     GPIO_AF0_SPI2
+#endif
+#ifndef SPI_LINK_SCK_PORT
+#define SPI_LINK_SCK_PORT   GPIOB
+#define SPI_LINK_SCK_PIN    GPIO_PIN_10
+#define SPI_LINK_SCK_AF     GPIO_AF5_SPI2
+#endif
+#ifndef SPI_LINK_MISO_PORT
+#define SPI_LINK_MISO_PORT  GPIOC
+#define SPI_LINK_MISO_PIN   GPIO_PIN_2
+#define SPI_LINK_MISO_AF    GPIO_AF1_SPI2
+#endif
+#ifndef SPI_LINK_MOSI_PORT
+#define SPI_LINK_MOSI_PORT  GPIOC
+#define SPI_LINK_MOSI_PIN   GPIO_PIN_3
+#define SPI_LINK_MOSI_AF    GPIO_AF1_SPI2
+#endif
+/** @} */
+
+#if SPI_LINK_ENABLE
+
+/**
+ * @brief  Configure SPI2 en esclave, ses broches et ses canaux DMA, puis arme la première transaction.
+ */
+void spi_link_init(void);
+
+/**
+ * @brief  Décode la dernière transaction reçue (boucle principale).
+ * @details Les trames de commande valides sont mises dans la file de serial_cmd.h,
+ * comme celles reçues sur l'UART. Réarme aussi une transaction abandonnée par l'hôte.
+ */
+void spi_link_poll(void);
+
+/**
+ * @brief  Publie une trame de télémétrie pour les transactions suivantes.
+ * @details Le bloc est émis tel quel à partir de la fin de la transaction en cours ; un
+ * bloc publié plus tôt et jamais émis est rendu au pool.
+ * @param  block Bloc de frame_pool (SPI_LINK_FRAME_LEN octets, trame complétée de 0x00),
+ * dont la liaison prend la propriété.
+ */
+void spi_link_publish_block(uint8_t *block);
+
+/**
+ * @brief  Indique si une transaction reçue attend d'être décodée.
+ * @return 1 si spi_link_poll() a du travail, 0 sinon.
+ */
+uint8_t spi_link_pending(void);
+
+/** @brief Transactions complètes reçues depuis le démarrage. */
+uint32_t spi_link_frames(void);
+
+/** @brief Transactions perdues (non décodées à temps) ou abandonnées par l'hôte. */
+uint32_t spi_link_errors(void);
+
+/**
+ * @brief  Traitement des interruptions DMA de la liaison (vecteur DMA1_Ch4_7 partagé).
+ */
+void spi_link_dma_irq(void);
+
+#else
+
+static inline void spi_link_init(void){}
+static inline void spi_link_poll(void){}
+static inline void spi_link_publish_block(uint8_t *block){ (void)block; }
+static inline uint8_t spi_link_pending(void){ return 0; }
+static inline uint32_t spi_link_frames(void){ return 0; }
+static inline uint32_t spi_link_errors(void){ return 0; }
+static inline void spi_link_dma_irq(void){}
+
+#endif /* SPI_LINK_ENABLE */
+
+#endif /* INC_SPI_LINK_H_ */
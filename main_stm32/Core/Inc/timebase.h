@@ -0,0 +1,71 @@
+/**
+ * @file    timebase.h
+ * @brief   Base de temps microseconde du système.
+ * @details Expose le compteur 64 bits construit sur le Timer 3 (tick 1 µs)
+ * et son compteur d'overflow incrémenté par l'interruption TIM3.
+ */
+
+#ifndef INC_TIMEBASE_H_
+#define INC_TIMEBASE_H_
+
+#include <stdint.h>
+
+/** @brief Fréquence du compteur de la base de temps (TIM3, tick 1 µs). */
+#define TIMEBASE_TICK_HZ    1000000u
+
+/** @brief Compteur d'overflow pour l'extension du Timer microseconde (bits 16 à 47). */
+extern volatile uint32_t tim3_overflow_cnt;
+
+/**
+ * @brief  Récupère le nombre de ticks TIM3 écoulés depuis le démarrage.
+ * @return Ticks (TIMEBASE_TICK_HZ) sur 48 bits utiles, monotone (rebouclage après ~8,9 ans).
+ * @note   Appelable en interruption ou interruptions masquées.
+ */
+uint64_t GetTicks64(void);
+
+/**
+ * @brief  Récupère le temps écoulé depuis le démarrage en microsecondes.
+ * @return Temps monotone en microsecondes (64 bits).
+ */
+uint64_t GetMicros64(void);
+
+/**
+ * @brief  Récupère un temps système précis en microsecondes.
+ * @return 32 bits de poids faible de GetMicros64() (rebouclage après ~71 minutes),
+ * réservé aux calculs de durée par différence.
+ */
+uint32_t GetMicrosTotal(void);
+
+/**
+ * @brief  Attente active précise à la microseconde.
+ * @param  us Durée de l'attente en microsecondes.
+ * @note   Utilisable interruptions masquées (ne dépend pas du compteur d'overflow).
+ */
+void Delay_us(uint32_t us);
+
+/**
+ * @brief  Avance la base de temps d'une durée passée horloges arrêtées (veille STOP).
+ * @details Le compteur TIM3 et son compteur d'overflow sont réécrits ensemble,
+ * interruptions masquées : GetMicros64() reste monotone et inclut la veille.
+ * @param  us Durée à ajouter (µs).
+ */
+void Timebase_Advance(uint64_t us);
+
+/** @brief Marge minimale (µs) pour armer un réveil : en deçà, le compare risque d'être manqué. */
+#define TIMEBASE_WAKEUP_MIN_US  20u
+
+/**
+ * @brief  Arme le réveil de la veille sur une échéance (compare CH1 de TIM3).
+ * @param  deadline_us Échéance absolue (µs, GetMicros64).
+ * @return 1 si le processeur peut dormir jusqu'à l'échéance, 0 si elle est trop proche.
+ * @note   Au-delà de 65 ms, aucun compare n'est armé : l'overflow de TIM3 (et la
+ * SysTick) réveillent le processeur plus tôt.
+ */
+uint8_t Timebase_Arm_Wakeup(uint64_t deadline_us);
+
+/**
+ * @brief  Désarme le réveil de la veille (interruption CC1 de TIM3).
+ */
+void Timebase_Disarm_Wakeup(void);
+
+#endif /* INC_TIMEBASE_H_ */
@@ -0,0 +1,72 @@
+/**
+ * @file    trace.h
+ * @brief   Marqueurs de timing sur broches libres, pour oscilloscope ou analyseur logique.
+ * @details Le Cortex-M0+ n'a ni ITM ni SWO : les durées d'exécution se mesurent en
+ * basculant des sorties GPIO en entrée et en sortie des zones instrumentées. Chaque
+ * marqueur est une seule écriture BSRR / BRR, sans lecture-modification-écriture : sûr
+ * depuis n'importe quelle priorité d'interruption, quelques cycles même en -O0.
+ *
+ * Voies (broche haute pendant la zone) :
+ * | Voie | Broche | Zone                                                    |
+ * |------|--------|---------------------------------------------------------|
+ * | TICK | PC6    | SysTick_Handler (1 kHz, boucle moteur incluse)          |
+ * | SPI  | PC7    | transaction SPI1 sur le bus, CS bas -> fin de transfert |
+ * | DMA  | PC8    | interruptions DMA1 canal 1 et canaux 2-3 (UART, SPI1)   |
+ * | TASK | PC9    | tâche de l'ordonnanceur en cours d'exécution            |
+ *
+ * Hors TRACE_ENABLE, les marqueurs disparaissent et les broches restent analogiques.
+ */
+
+#ifndef INC_TRACE_H_
+#define INC_TRACE_H_
+
+#include "main.h"
+
+/** @brief Marqueurs actifs (1) ou compilés à vide (0). */
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE        0
+#endif
+
+/**
+ * @name Broches des voies (ports GPIOA..GPIOD, sorties push-pull)
+ * @{
+ */
+#ifndef TRACE_TICK_PORT
+#define TRACE_TICK_PORT     GPIOC
+#define TRACE_TICK_PIN      GPIO_PIN_6
+#endif
+
+#ifndef TRACE_SPI_PORT
+#define TRACE_SPI_PORT      GPIOC
+#define TRACE_SPI_PIN       GPIO_PIN_7
+#endif
+
+#ifndef TRACE_DMA_PORT
+#define TRACE_DMA_PORT      GPIOC
+#define TRACE_DMA_PIN       GPIO_PIN_8
+#endif
+
+#ifndef TRACE_TASK_PORT
+#define TRACE_TASK_PORT     GPIOC
+#define TRACE_TASK_PIN      GPIO_PIN_9
+#endif
+/** @} */
+
+#if TRACE_ENABLE
+/** @brief Passe la voie ch (TICK, SPI, DMA, TASK) à l'état haut. */
+#define TRACE_HI(ch)        ((TRACE_##ch##_PORT)->BSRR = TRACE_##ch##_PIN)
+/** @brief Passe la voie ch à l'état bas. */
+#define TRACE_LO(ch)        ((TRACE_##ch##_PORT)->BRR = TRACE_##ch##_PIN)
+
+/**
+ * @brief  Configure les broches des voies en sorties rapides, à l'état bas.
+ */
+void trace_init(void);
+#else
+#define TRACE_HI(ch)        ((void)0)
+#define TRACE_LO(ch)        ((void)0)
+
+static inline void trace_init(void){}
+#endif
+
+#endif /* INC_TRACE_H_ */
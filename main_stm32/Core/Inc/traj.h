@@ -0,0 +1,100 @@
+/**
+ * @file    traj.h
+ * @brief   Tampon de trajectoire : consignes servo/vitesse datées, jouées par le tick moteur.
+ * @details L'hôte téléverse d'avance une liste de points (date relative au départ en µs,
+ * braquage en centi-degrés, vitesse en mm/s) par trames groupées, puis lance la lecture
+ * (REG_TRAJ_CMD). Chaque point est appliqué par le tick moteur dès sa date atteinte :
+ * l'exécution ne dépend plus de la gigue de la liaison ni du passage de la boucle
+ * principale, seulement de la résolution du tick (1 ms en interruption SysTick, date
+ * exacte de libération en mode ordonnancé).
+ *
+ * Téléversement : deux emplacements de REG_TRAJ_PT_LEN registres à partir de
+ * REG_TRAJ_PT_BASE ([T_LO | T_HI | SERVO_CDEG | SPEED_MMS]) ; l'écriture du registre
+ * de vitesse d'un emplacement ajoute le point. Une trame groupée de 8 registres
+ * transporte ainsi deux points. Les dates doivent être croissantes ; des points peuvent
+ * être ajoutés pendant la lecture tant que le tampon n'est pas plein.
+ *
+ * Producteur (parseur, boucle principale) et consommateur (tick moteur, éventuellement
+ * en interruption) partagent un anneau à index libres : aucune section critique.
+ */
+
+#ifndef INC_TRAJ_H_
+#define INC_TRAJ_H_
+
+#include <stdint.h>
+
+/** @brief Capacité du tampon de trajectoire (points, puissance de 2, 8 octets par point). */
+#ifndef TRAJ_LEN
+#define TRAJ_LEN                64u
+#endif
+
+/**
+ * @brief Commandes écrites dans REG_TRAJ_CMD.
+ */
+typedef enum{
+    TRAJ_CMD_CLEAR = 1,     ///< Arrête la lecture et vide le tampon.
+    TRAJ_CMD_START = 2,     ///< Lance la lecture, date 0 à la réception de la commande.
+    TRAJ_CMD_STOP  = 3      ///< Arrête la lecture (points restants conservés, dernière consigne maintenue).
+} traj_cmd_t;
+
+/**
+ * @brief État du lecteur (REG_TRAJ_CMD en lecture).
+ */
+typedef enum{
+    TRAJ_ST_IDLE = 0,       ///< Pas de lecture en cours.
+    TRAJ_ST_RUNNING,        ///< Lecture en cours, points en attente.
+    TRAJ_ST_DONE,           ///< Tampon épuisé pendant la lecture (dernière consigne maintenue).
+    TRAJ_ST_REJECTED        ///< Point refusé (date décroissante ou tampon plein) depuis le dernier CLEAR.
+} traj_state_t;
+
+/**
+ * @brief Point de trajectoire.
+ */
+typedef struct{
+    uint32_t t_us;          ///< Date relative au départ (µs).
+    int16_t  servo_cdeg;    ///< Braquage (centi-degrés).
+    int16_t  speed_mms;     ///< Consigne de vitesse (mm/s).
+} traj_point_t;
+
+/**
+ * @brief  Ajoute un point en fin de tampon.
+ * @param  pt Point (date non inférieure à celle du point précédent).
+ * @return 1 si ajouté, 0 si refusé (tampon plein ou date décroissante).
+ */
+uint8_t traj_push(const traj_point_t *pt);
+
+/**
+ * @brief  Exécute une commande de REG_TRAJ_CMD.
+ * @param  cmd  Commande (traj_cmd_t), valeurs inconnues ignorées.
+ * @param  t_us Date de départ pour TRAJ_CMD_START (µs, GetMicros64).
+ */
+void traj_command(uint8_t cmd, uint64_t t_us);
+
+/**
+ * @brief  Retire le prochain point si sa date est atteinte (tick moteur).
+ * @param  now_us Date courante (µs, GetMicros64).
+ * @param  pt     Point à appliquer.
+ * @return 1 si un point est dû, 0 sinon. Appeler jusqu'à 0 : seul le dernier point dû compte.
+ */
+uint8_t traj_poll(uint64_t now_us, traj_point_t *pt);
+
+/**
+ * @brief  Date du prochain point.
+ * @return Date absolue (µs, GetMicros64), 0 si le tampon s'est vidé pendant la lecture
+ * (fin constatée au tick suivant), UINT64_MAX hors lecture.
+ */
+uint64_t traj_next_us(void);
+
+/**
+ * @brief  Indique si une lecture est en cours.
+ * @return 1 si les actionneurs suivent la trajectoire, 0 sinon.
+ */
+uint8_t traj_running(void);
+
+/** @brief État du lecteur (traj_state_t). */
+uint8_t traj_state(void);
+
+/** @brief Nombre de points en attente dans le tampon. */
+uint16_t traj_count(void);
+
+#endif /* INC_TRAJ_H_ */
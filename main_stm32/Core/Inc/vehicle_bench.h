@@ -0,0 +1,27 @@
+/**
+ * @file    vehicle_bench.h
+ * @brief   Profil banc : châssis de référence roues levées, vitesses et braquage réduits.
+ * @note    Inclus par vehicle_profile.h (VEHICLE_PROFILE_BENCH) uniquement.
+ */
+
+#ifndef INC_VEHICLE_BENCH_H_
+#define INC_VEHICLE_BENCH_H_
+
+#define VEH_WHEEL_DIAMETER_UM   68000UL     ///< Diamètre de la roue instrumentée (µm).
+#define VEH_SPEEDO_CAL_TURNS    10UL        ///< Étalonnage : tours de roue.
+#define VEH_SPEEDO_CAL_TICKS    52UL        ///< Étalonnage : fronts relevés.
+
+#define VEH_PULSE_MIN_US        1000u       ///< Impulsion minimale (µs).
+#define VEH_PULSE_MAX_US        2000u       ///< Impulsion maximale (µs).
+
+#define VEH_MOTOR_MAX_FWD_MMS   300         ///< Vitesse maximale avant (mm/s) : roue libre sur le banc.
+#define VEH_MOTOR_MAX_REV_MMS   200         ///< Vitesse maximale arrière (mm/s).
+
+#define VEH_SERVO_TRIM_PCT      5u          ///< Trim du servo (%).
+#define VEH_SERVO_HALF_SPAN_CDEG 3500u      ///< Demi-course couverte par la plage d'impulsion (c°).
+#define VEH_SERVO_CLAMP_CDEG    1500        ///< Butée logicielle réduite (c°) : câblage du banc.
+#define VEH_STEER_SIGN          1           ///< Signe du braquage pour un virage à gauche.
+
+#define VEH_WHEELBASE_MM        260         ///< Empattement (mm).
+
+#endif /* INC_VEHICLE_BENCH_H_ */
@@ -0,0 +1,39 @@
+/**
+ * @file    vehicle_default.h
+ * @brief   Profil véhicule par défaut : châssis de référence.
+ * @note    Inclus par vehicle_profile.h (VEHICLE_PROFILE_DEFAULT) uniquement.
+ */
+
+#ifndef INC_VEHICLE_DEFAULT_H_
+#define INC_VEHICLE_DEFAULT_H_
+
+/** @brief Diamètre de la roue instrumentée (µm). */
+#define VEH_WHEEL_DIAMETER_UM   68000UL
+/** @brief Étalonnage du tachymètre : tours de roue effectués. */
+#define VEH_SPEEDO_CAL_TURNS    10UL
+/** @brief Étalonnage du tachymètre : fronts relevés pendant ces tours. */
+#define VEH_SPEEDO_CAL_TICKS    52UL
+
+/** @brief Impulsion minimale du servo et de l'ESC (µs). */
+#define VEH_PULSE_MIN_US        1000u
+/** @brief Impulsion maximale du servo et de l'ESC (µs). */
+#define VEH_PULSE_MAX_US        2000u
+
+/** @brief Vitesse maximale en marche avant (mm/s), à pleine impulsion. */
+#define VEH_MOTOR_MAX_FWD_MMS   1000
+/** @brief Vitesse maximale en marche arrière (mm/s, valeur positive). */
+#define VEH_MOTOR_MAX_REV_MMS   500
+
+/** @brief Trim du servo (% de la plage d'impulsion ajouté au centre). */
+#define VEH_SERVO_TRIM_PCT      5u
+/** @brief Demi-course du servo couverte par la plage d'impulsion (centi-degrés). */
+#define VEH_SERVO_HALF_SPAN_CDEG 3500u
+/** @brief Butée logicielle du braquage (centi-degrés, symétrique). */
+#define VEH_SERVO_CLAMP_CDEG    2000
+/** @brief Signe du braquage servo pour un virage à gauche : +1 ou -1. */
+#define VEH_STEER_SIGN          1
+
+/** @brief Empattement (mm). */
+#define VEH_WHEELBASE_MM        260
+
+#endif /* INC_VEHICLE_DEFAULT_H_ */
@@ -0,0 +1,62 @@
+/**
+ * @file    vehicle_profile.h
+ * @brief   Sélection du profil véhicule à la compilation.
+ * @details Les paramètres physiques d'une variante (roue et étalonnage du tachymètre,
+ * bornes d'impulsion, vitesses maximales, trim et bornes du servo, empattement) sont
+ * réunis dans un en-tête vehicle_<nom>.h. VEHICLE_PROFILE en choisit un au build
+ * (-DVEHICLE_PROFILE=VEHICLE_PROFILE_BENCH), et chaque variante a son image.
+ *
+ * Les constantes dérivées (distance par front, bornes en ticks, pentes du servo) sont
+ * calculées par le préprocesseur, sans flottant ni division à l'exécution. Les limites
+ * réglables par registre et enregistrées en flash (REG_MOTOR_MAX_*, REG_SERVO_*_TICKS)
+ * prennent le profil pour valeur par défaut.
+ *
+ * Ajouter une variante : copier vehicle_default.h, lui attribuer un numéro
+ * VEHICLE_PROFILE_* ci-dessous et l'ajouter à la sélection.
+ */
+
+#ifndef INC_VEHICLE_PROFILE_H_
+#define INC_VEHICLE_PROFILE_H_
+
+/**
+ * @name Profils disponibles
+ * @{
+ */
+#define VEHICLE_PROFILE_DEFAULT 0   ///< Châssis de référence (vehicle_default.h).
+#define VEHICLE_PROFILE_BENCH   1   ///< Même châssis sur banc, roues levées (vehicle_bench.h).
+/** @} */
+
+/** @brief Profil compilé. */
+#ifndef VEHICLE_PROFILE
+#define VEHICLE_PROFILE         VEHICLE_PROFILE_DEFAULT
+#endif
+
+#if VEHICLE_PROFILE == VEHICLE_PROFILE_DEFAULT
+#include "vehicle_default.h"
+#elif VEHICLE_PROFILE == VEHICLE_PROFILE_BENCH
+#include "vehicle_bench.h"
+#else
+#error "Unknown VEHICLE_PROFILE"
+#endif
+
+#if VEH_PULSE_MIN_US >= VEH_PULSE_MAX_US
+#error "VEH_PULSE_MIN_US must be below VEH_PULSE_MAX_US"
+#endif
+#if VEH_MOTOR_MAX_FWD_MMS <= 0 || VEH_MOTOR_MAX_REV_MMS <= 0 || VEH_MOTOR_MAX_FWD_MMS > 32767 || VEH_MOTOR_MAX_REV_MMS > 32767
+#error "VEH_MOTOR_MAX_*_MMS out of range"
+#endif
+#if VEH_SERVO_CLAMP_CDEG <= 0 || VEH_SERVO_CLAMP_CDEG > VEH_SERVO_HALF_SPAN_CDEG
+#error "VEH_SERVO_CLAMP_CDEG exceeds the servo half span"
+#endif
+#if VEH_SPEEDO_CAL_TICKS == 0 || VEH_SPEEDO_CAL_TURNS == 0
+#error "Null tachometer calibration"
+#endif
+
+/**
+ * @brief Distance parcourue par front du tachymètre (µm), arrondie.
+ * @details π·D·tours / fronts relevés, avec π ≈ 355/113 (écart 8.5e-8).
+ */
+#define VEH_UM_PER_TICK         ((VEH_WHEEL_DIAMETER_UM * 355UL * VEH_SPEEDO_CAL_TURNS + 113UL * VEH_SPEEDO_CAL_TICKS / 2UL) \
+                                 / (113UL * VEH_SPEEDO_CAL_TICKS))
+
+#endif /* INC_VEHICLE_PROFILE_H_ */
@@ -0,0 +1,100 @@
+/**
+ * @file    vib.h
+ * @brief   Analyse vibratoire embarquée : spectre FFT d'un axe accéléromètre.
+ * @details Chaque échantillon retiré de la file du driver (cadence d'acquisition
+ * REG_IMU_RATE ou data-ready, indépendamment de la télémétrie) alimente un bloc de
+ * VIB_FFT_N points sur l'axe choisi. Bloc plein : moyenne retirée, fenêtre de Hann,
+ * FFT radix-2 en virgule fixe (Q15, mise à l'échelle par étage, entrée recadrée
+ * par décalage à chaque bloc). Les puissances de REG_VIB_AVG blocs sont moyennées,
+ * puis un rapport est émis : raie dominante (fréquence interpolée, amplitude) et
+ * valeur efficace de VIB_BANDS bandes de largeur égale entre 0 et fs/2. Le lien ne
+ * transporte plus que quelques trames par seconde au lieu du flux brut.
+ *
+ * Trame type 0x0A : [AA 55 0A LEN | T_US u32 | FS_HZ u16 | PEAK_DHZ u16 | PEAK_MG u16 |
+ *                    BAND_MG u16 x VIB_BANDS | AXIS u8 | BLOCKS u8 | CRC]
+ * T_US : date du dernier échantillon analysé (GetMicros64 tronqué) ; FS_HZ : cadence
+ * mesurée ; PEAK_DHZ : raie dominante (0,1 Hz) ; PEAK_MG : son amplitude (mg crête) ;
+ * BAND_MG : valeur efficace par bande (mg) ; AXIS : 0 X, 1 Y, 2 Z ; BLOCKS : spectres
+ * moyennés.
+ *
+ * Coût : une FFT de 128 points par bloc (~0,5 ms sur le M0+ à 64 MHz), soit moins
+ * de 1 % du temps processeur à 1,6 kHz.
+ */
+
+#ifndef INC_VIB_H_
+#define INC_VIB_H_
+
+#include <stdint.h>
+#include "proto_def.h"
+#include "driver_ins.h"
+
+/** @brief Analyse vibratoire active (1) ou absente (0, aucune RAM réservée). */
+#ifndef VIB_ENABLE
+#define VIB_ENABLE              1
+#endif
+
+/** @brief Nombre de points de la FFT (64 ou 128). */
+#ifndef VIB_FFT_N
+#define VIB_FFT_N               128u
+#endif
+/** @brief Nombre de bandes rapportées (diviseur de VIB_FFT_N / 2). */
+#define VIB_BANDS               4u
+/** @brief Spectres moyennés par rapport, par défaut. */
+#define VIB_AVG_DEFAULT         8u
+/** @brief Spectres moyennés par rapport, au plus. */
+#define VIB_AVG_MAX             64u
+/** @brief Type de trame du rapport vibratoire. */
+#define VIB_FRAME_TYPE          TELEM_TYPE_VIB
+/** @brief Longueur de la trame du rapport (entête 4 + champs + CRC). */
+#define VIB_FRAME_LEN           (4u + 4u + 2u + 2u + 2u + 2u * VIB_BANDS + 1u + 1u + 1u)
+
+/**
+ * @brief Commande de REG_VIB_CMD : axe analysé.
+ */
+typedef enum {
+    VIB_OFF    = 0,     ///< Analyse arrêtée.
+    VIB_AXIS_X = 1,     ///< Axe X de l'accéléromètre.
+    VIB_AXIS_Y = 2,     ///< Axe Y.
+    VIB_AXIS_Z = 3      ///< Axe Z.
+} vib_cmd_t;
+
+#if VIB_ENABLE
+
+/**
+ * @brief  Règle l'analyse ; repart d'un bloc vide.
+ * @param  cmd    Axe analysé (vib_cmd_t), VIB_OFF pour arrêter.
+ * @param  avg    Spectres moyennés par rapport (borné à 1..VIB_AVG_MAX).
+ * @param  ranges Gammes IMU courantes (IMU_CFG_PACK, bits 0-1 accéléromètre).
+ */
+void vib_configure(uint8_t cmd, uint8_t avg, uint8_t ranges);
+
+/**
+ * @brief  Enregistre un échantillon (observateur brut du driver, boucle principale).
+ * @details Le bloc complété est analysé sur place ; le dernier spectre de la moyenne
+ * déclenche l'émission du rapport.
+ * @param  raw          Échantillon brut.
+ * @param  timestamp_us Date de l'acquisition (µs).
+ */
+void vib_record(const bmi088_raw_t *raw, uint64_t timestamp_us);
+
+/**
+ * @brief  Fréquence de la raie dominante du dernier rapport.
+ * @return Fréquence (0,1 Hz), 0 avant le premier rapport.
+ */
+uint16_t vib_peak_dhz(void);
+
+/**
+ * @brief  Amplitude de la raie dominante du dernier rapport.
+ * @return Amplitude crête (mg).
+ */
+uint16_t vib_peak_mg(void);
+
+#else
+
+static inline void vib_configure(uint8_t cmd, uint8_t avg, uint8_t ranges){ (void)cmd; (void)avg; (void)ranges; }
+static inline uint16_t vib_peak_dhz(void){ return 0; }
+static inline uint16_t vib_peak_mg(void){ return 0; }
+
+#endif /* VIB_ENABLE */
+
+#endif /* INC_VIB_H_ */
@@ -0,0 +1,36 @@
+/**
+ * @file    watchdog.h
+ * @brief   Chien de garde matériel indépendant (IWDG).
+ * @details Horloge LSI (32 kHz) divisée par 32 : 1 tick par ms, délai de 1 à 4095 ms.
+ * Une fois démarré, l'IWDG ne peut plus être arrêté ; il est gelé quand le cœur est
+ * arrêté par le débogueur. Rafraîchi par une tâche de l'ordonnanceur : une boucle
+ * principale bloquée (attente SPI sans fin, boucle infinie) provoque un reset.
+ */
+
+#ifndef INC_WATCHDOG_H_
+#define INC_WATCHDOG_H_
+
+#include <stdint.h>
+
+/** @brief Délai du chien de garde (ms). */
+#define WATCHDOG_TIMEOUT_MS     250u
+
+/**
+ * @brief  Démarre le chien de garde.
+ * @details Relève au passage la cause du dernier reset (cf. watchdog_caused_reset()).
+ * @param  timeout_ms Délai avant reset sans rafraîchissement (ms, borné à 1..4095).
+ */
+void watchdog_start(uint16_t timeout_ms);
+
+/**
+ * @brief  Rafraîchit le chien de garde.
+ */
+void watchdog_feed(void);
+
+/**
+ * @brief  Indique si le dernier reset a été provoqué par le chien de garde.
+ * @return 1 si reset IWDG, 0 sinon.
+ */
+uint8_t watchdog_caused_reset(void);
+
+#endif /* INC_WATCHDOG_H_ */
@@ -0,0 +1,323 @@
+/**
+ * @file    actuators.c
+ * @brief   Implémentation des tables d'actionneurs (cf. actuators.h).
+ * @details Les sorties sont rangées par timer dans act_out_ccr / act_out_pulse : le
+ * passage d'application ne lit que des pointeurs précalculés (adresse du CCR, consigne
+ * du handle), sans décodage du canal ni appel par actionneur.
+ */
+
+#include "actuators.h"
+#include "driver_esc.h"
+#include "tim.h"
+#include "mem_map.h"
+
+_Static_assert(ACT_SERVO_COUNT >= 1u && ACT_SERVO_COUNT <= ACT_SERVO_MAX, "ACT_SERVO_COUNT out of range");
+_Static_assert(ACT_MOTOR_COUNT >= 1u && ACT_MOTOR_COUNT <= ACT_MOTOR_MAX, "ACT_MOTOR_COUNT out of range");
+
+_Static_assert(ACT_PWM_TICK_HZ % 1000u == 0u, "PWM tick rate must be a whole number of ticks per ms");
+_Static_assert(ACT_SERVO_PERIOD_TICKS <= 65536u && ACT_ESC_PERIOD_TICKS <= 65536u, "PWM period exceeds the 16-bit TIM1 counter");
+_Static_assert(ACT_SERVO_PERIOD_TICKS > ACT_PULSE_MAX_TICKS, "ACT_SERVO_PWM_HZ too high for a 2 ms pulse");
+_Static_assert(ACT_ESC_PERIOD_TICKS > ACT_PULSE_MAX_TICKS, "ACT_ESC_PWM_HZ too high for a 2 ms pulse");
+_Static_assert(!MOTOR_OUT_IS_DSHOT(ACT_ESC_OUTPUT) || ACT_MOTOR_COUNT == 1u, "DShot drives TIM2 CH1 only");
+
+/** @brief Nombre total de sorties PWM. */
+#define ACT_OUT_COUNT   (ACT_SERVO_COUNT + ACT_MOTOR_COUNT)
+
+Servo_Handle_t act_servo[ACT_SERVO_COUNT] = {
+    [ACT_SERVO_STEER] = {
+        .htim = &htim1,           		   // Instance du Timer
+        .channel = TIM_CHANNEL_1, 	       // Canal PWM
+        .min_pulse_ticks = ACT_PULSE_MIN_TICKS,  // Ticks pour 0% (1 ms)
+        .max_pulse_ticks = ACT_PULSE_MAX_TICKS   // Ticks pour 100% (2 ms)
+    },
+#if ACT_SERVO_COUNT > 1
+    [1] = { .htim = &htim1, .channel = TIM_CHANNEL_2, .min_pulse_ticks = ACT_PULSE_MIN_TICKS, .max_pulse_ticks = ACT_PULSE_MAX_TICKS },
+#endif
+#if ACT_SERVO_COUNT > 2
+    [2] = { .htim = &htim1, .channel = TIM_CHANNEL_3, .min_pulse_ticks = ACT_PULSE_MIN_TICKS, .max_pulse_ticks = ACT_PULSE_MAX_TICKS },
+#endif
+#if ACT_SERVO_COUNT > 3
+    [3] = { .htim = &htim1, .channel = TIM_CHANNEL_4, .min_pulse_ticks = ACT_PULSE_MIN_TICKS, .max_pulse_ticks = ACT_PULSE_MAX_TICKS },
+#endif
+};
+
+Motor_Handle_t act_motor[ACT_MOTOR_COUNT] = {
+    [ACT_MOTOR_DRIVE] = {
+        .htim = &htim2,					   // Instance du Timer
+        .channel = TIM_CHANNEL_1,		   // Canal PWM
+        .min_pulse_ticks = ACT_PULSE_MIN_TICKS,  // Arrière toute (1 ms)
+        .max_pulse_ticks = ACT_PULSE_MAX_TICKS,  // Avant toute (2 ms)
+        .max_speed_pos_mms = VEH_MOTOR_MAX_FWD_MMS,     // Limite avant (profil véhicule)
+        .max_speed_neg_mms = -VEH_MOTOR_MAX_REV_MMS,    // Limite arrière
+        .output = ACT_ESC_OUTPUT           // Protocole de sortie
+    },
+#if ACT_MOTOR_COUNT > 1
+    [1] = { .htim = &htim2, .channel = TIM_CHANNEL_2, .min_pulse_ticks = ACT_PULSE_MIN_TICKS, .max_pulse_ticks = ACT_PULSE_MAX_TICKS,
+            .max_speed_pos_mms = VEH_MOTOR_MAX_FWD_MMS, .max_speed_neg_mms = -VEH_MOTOR_MAX_REV_MMS, .output = ACT_ESC_OUTPUT },
+#endif
+};
+
+/**
+ * @brief Groupe des sorties d'un même timer.
+ */
+typedef struct{
+    TIM_TypeDef *tim;       ///< Registres du timer.
+    uint8_t first;          ///< Première sortie du groupe (act_out_*).
+    uint8_t count;          ///< Sorties du groupe.
+} act_timer_t;
+
+/** @brief Registre de comparaison de chaque sortie, rangées par timer. */
+static volatile uint32_t *act_out_ccr[ACT_OUT_COUNT];
+/** @brief Consigne en attente de chaque sortie (pulse_ticks du handle). */
+static const uint16_t *act_out_pulse[ACT_OUT_COUNT];
+/** @brief Groupes de sorties par timer. */
+static act_timer_t act_timers[ACT_OUT_COUNT];
+/** @brief Nombre de groupes. */
+static uint8_t act_timer_count = 0;
+
+/**
+ * @brief Source d'une sortie avant regroupement.
+ */
+typedef struct{
+    TIM_HandleTypeDef *htim;    ///< Timer (HAL).
+    uint32_t channel;           ///< Canal (TIM_CHANNEL_1..4).
+    const uint16_t *pulse;      ///< Consigne du handle.
+} act_src_t;
+
+/**
+ * @brief  Range les sorties par timer et précalcule l'adresse de leur CCR.
+ * @details CCR1..CCR4 sont contigus et TIM_CHANNEL_n vaut 4 x (n - 1) : l'adresse se
+ * déduit du canal sans la cascade de comparaisons de __HAL_TIM_SET_COMPARE.
+ */
+static void act_out_build(void){
+    act_src_t src[ACT_OUT_COUNT];
+    uint8_t n = 0;
+    uint8_t out = 0;
+
+    for(uint8_t i = 0; i < ACT_SERVO_COUNT; i++){
+        src[n++] = (act_src_t){ act_servo[i].htim, act_servo[i].channel, &act_servo[i].pulse_ticks };
+    }
+    for(uint8_t i = 0; i < ACT_MOTOR_COUNT; i++){
+        if(!MOTOR_OUT_IS_DSHOT(act_motor[i].output)){   // CCR écrit par le DMA DShot
+            src[n++] = (act_src_t){ act_motor[i].htim, act_motor[i].channel, &act_motor[i].pulse_ticks };
+        }
+    }
+
+    act_timer_count = 0;
+    for(uint8_t i = 0; i < n; i++){
+        bool grouped = false;
+
+        if(src[i].htim == NULL || src[i].channel > TIM_CHANNEL_4){
+            continue;
+        }
+        for(uint8_t t = 0; t < act_timer_count; t++){
+            grouped = grouped || (act_timers[t].tim == src[i].htim->Instance);
+        }
+        if(grouped){
+            continue;
+        }
+
+        act_timer_t *g = &act_timers[act_timer_count++];
+        g->tim = src[i].htim->Instance;
+        g->first = out;
+        g->count = 0;
+        for(uint8_t j = i; j < n; j++){
+            if(src[j].htim != NULL && src[j].channel <= TIM_CHANNEL_4 && src[j].htim->Instance == g->tim){
+                act_out_ccr[out] = &g->tim->CCR1 + (src[j].channel >> 2);
+                act_out_pulse[out] = src[j].pulse;
+                out++;
+                g->count++;
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Applique les consignes modifiées, un timer à la fois.
+ * @details Le premier CCR modifié d'un timer suspend ses événements d'update (UDIS) ;
+ * ils sont rétablis après la dernière écriture du groupe. Un update tombant pendant
+ * ces quelques cycles est simplement reporté à la période suivante.
+ */
+MEM_RAMFUNC static void act_out_apply(void){
+    for(uint8_t t = 0; t < act_timer_count; t++){
+        const act_timer_t *g = &act_timers[t];
+        bool held = false;
+
+        for(uint8_t i = g->first; i < g->first + g->count; i++){
+            const uint32_t v = *act_out_pulse[i];
+
+            if(*act_out_ccr[i] != v){
+                if(!held){
+                    g->tim->CR1 |= TIM_CR1_UDIS;
+                    held = true;
+                }
+                *act_out_ccr[i] = v;
+            }
+        }
+        if(held){
+            g->tim->CR1 &= ~TIM_CR1_UDIS;
+        }
+    }
+}
+
+/**
+ * @brief  Programme la base de temps d'un timer PWM.
+ * @details Chargement immédiat par UG, avant le démarrage des canaux ; la structure
+ * d'initialisation HAL est tenue à jour pour les reconfigurations éventuelles.
+ * @param  htim         Timer (HAL).
+ * @param  psc          Prédiviseur (PSC).
+ * @param  period_ticks Période (ticks, ARR + 1).
+ */
+static void act_timer_setup(TIM_HandleTypeDef *htim, uint32_t psc, uint32_t period_ticks){
+    if(htim == NULL){
+        return;
+    }
+    htim->Init.Prescaler = psc;
+    htim->Init.Period = period_ticks - 1u;
+    htim->Instance->PSC = psc;
+    htim->Instance->ARR = period_ticks - 1u;
+    htim->Instance->EGR = TIM_EGR_UG;
+}
+
+void actuators_init(void){
+    for(uint8_t i = 0; i < ACT_SERVO_COUNT; i++){
+        act_timer_setup(act_servo[i].htim, ACT_PWM_PRESCALER, ACT_SERVO_PERIOD_TICKS);
+    }
+    for(uint8_t i = 0; i < ACT_MOTOR_COUNT; i++){
+        uint32_t psc;
+        uint32_t period;
+
+        (void)esc_out_init(&act_motor[i]);
+        esc_out_timebase(act_motor[i].output, &psc, &period);
+        act_timer_setup(act_motor[i].htim, psc, period);
+    }
+    for(uint8_t i = 0; i < ACT_SERVO_COUNT; i++){
+        servo_initialisation(&act_servo[i]);
+    }
+    for(uint8_t i = 0; i < ACT_MOTOR_COUNT; i++){
+        motor_init(&act_motor[i]);
+        esc_out_start(&act_motor[i]);
+    }
+    act_out_build();
+    act_out_apply();
+}
+
+uint8_t actuators_sel_clamp(uint8_t sel){
+    const uint8_t count = (sel & ACT_SEL_MOTOR) ? (uint8_t)ACT_MOTOR_COUNT : (uint8_t)ACT_SERVO_COUNT;
+    const uint8_t index = sel & ACT_SEL_INDEX_MASK;
+
+    return (uint8_t)((sel & ACT_SEL_MOTOR) | ((index < count) ? index : (uint8_t)(count - 1u)));
+}
+
+MEM_RAMFUNC bool actuators_tick(uint32_t now_ms){
+    bool slewing = false;
+
+    for(uint8_t i = 0; i < ACT_SERVO_COUNT; i++){
+        slewing = servo_slew_tick(&act_servo[i]) || slewing;
+    }
+    for(uint8_t i = 0; i < ACT_MOTOR_COUNT; i++){
+        if(motor_needs_process(&act_motor[i], now_ms)){
+            motor_process_1ms(&act_motor[i], now_ms);
+        }
+        if(MOTOR_OUT_IS_DSHOT(act_motor[i].output)){
+            esc_dshot_update(&act_motor[i]);
+        }
+    }
+    act_out_apply();
+    return slewing;
+}
+
+MEM_RAMFUNC void actuators_apply(void){
+    act_out_apply();
+}
+
+bool actuators_need_process(uint32_t now_ms){
+    for(uint8_t i = 0; i < ACT_MOTOR_COUNT; i++){
+        if(motor_needs_process(&act_motor[i], now_ms)){
+            return true;
+        }
+    }
+    return false;
+}
+
+bool actuators_next_deadline(uint32_t *deadline_ms){
+    bool armed = false;
+    uint32_t d;
+
+    for(uint8_t i = 0; i < ACT_MOTOR_COUNT; i++){
+        if(motor_next_deadline(&act_motor[i], &d) && (!armed || (int32_t)(d - *deadline_ms) < 0)){
+            *deadline_ms = d;
+            armed = true;
+        }
+    }
+    return armed;
+}
+
+int16_t actuators_command(uint8_t sel){
+    const uint8_t index = sel & ACT_SEL_INDEX_MASK;
+
+    if(sel & ACT_SEL_MOTOR){
+        return act_motor[index].ctx.target_speed_mms;
+    }
+
+    const Servo_Handle_t *s = &act_servo[index];
+    if(s->ticks_per_cdeg_q16 == 0u){
+        return 0;
+    }
+    return (int16_t)((((int32_t)s->target_ticks - (int32_t)s->center_ticks) * 65536) / (int32_t)s->ticks_per_cdeg_q16);
+}
+
+uint16_t actuators_output(uint8_t sel){
+    const uint8_t index = sel & ACT_SEL_INDEX_MASK;
+
+    return (sel & ACT_SEL_MOTOR) ? act_motor[index].pulse_ticks : act_servo[index].pulse_ticks;
+}
+
+uint8_t actuators_state(uint8_t sel){
+    const uint8_t index = sel & ACT_SEL_INDEX_MASK;
+
+    if(sel & ACT_SEL_MOTOR){
+        return (uint8_t)act_motor[index].state;
+    }
+    return (act_servo[index].pos_q16 != ((uint32_t)act_servo[index].target_ticks << 16)) ? 1u : 0u;
+}
+
+void actuators_set_aux(uint8_t sel, int16_t value){
+    const uint8_t index = sel & ACT_SEL_INDEX_MASK;
+
+    if(sel & ACT_SEL_MOTOR){
+        motor_set_speed_mms(&act_motor[index], value);
+    }
+    else{
+        servo_set_centideg(&act_servo[index], value);
+    }
+}
+
+void actuators_stop_aux(void){
+    for(uint8_t i = 0; i < ACT_MOTOR_COUNT; i++){
+        if(i != ACT_MOTOR_DRIVE && act_motor[i].ctx.target_speed_mms != 0){
+            motor_set_speed_mms(&act_motor[i], 0);
+        }
+    }
+}
+
+void actuators_outputs_off(void){
+    for(uint8_t i = 0; i < ACT_MOTOR_COUNT; i++){
+        esc_out_stop(&act_motor[i]);
+    }
+    for(uint8_t t = 0; t < act_timer_count; t++){
+        const act_timer_t *g = &act_timers[t];
+
+        for(uint8_t i = g->first; i < g->first + g->count; i++){
+            *act_out_ccr[i] = 0;
+        }
+        g->tim->EGR = TIM_EGR_UG;   // Recharge immédiate des CCR préchargés
+    }
+}
+
+void actuators_outputs_restore(void){
+    act_out_apply();
+    for(uint8_t i = 0; i < ACT_MOTOR_COUNT; i++){
+        esc_out_start(&act_motor[i]);
+    }
+}
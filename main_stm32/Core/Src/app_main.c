@@ -3,10 +3,10 @@
  * @brief   Point d'entrée principal de l'application (Main Loop & Scheduler).
  * @details Ce fichier contient la boucle principale, l'initialisation du système,
  * et l'ordonnanceur coopératif pour les tâches périodiques :
- * - Gestion Moteur (1kHz)
- * - Télémétrie (100Hz)
+ * - Gestion Moteur (sur nouvelle consigne ou échéance de la machine à états)
+ * - Télémétrie (10 à 1000 Hz, 100 Hz par défaut)
  * - Lecture Vitesse (10Hz)
- * - Traitement des commandes et Sécurité Failsafe.
+ * - Traitement des commandes et Sécurité Failsafe (graduée, chien de garde IWDG).
  */
 
 #include "main.h"
@@ -20,213 +20,2104 @@
 #include "bmi08x.h"
 #include "driver_servo.h"
 #include "driver_motor.h"
+#include "actuators.h"
 #include "dma.h"
 #include "serial.h"
 #include "serial_cmd.h"
 #include "driver_speedometer.h"
-#include <stdio.h>
+#include "speed_est.h"
+#include "speed_fuse.h"
+#include "attitude.h"
+#include "odometry.h"
+#include "kin.h"
+#include "timebase.h"
+#include "scheduler.h"
+#include "profiler.h"
+#include "mem_map.h"
+#include "jitter.h"
+#include "irq_prio.h"
+#include "watchdog.h"
+#include "fault_log.h"
+#include "bench.h"
+#include "dlog.h"
+#include "imu_hist.h"
+#include "imu_filt.h"
+#include "vib.h"
+#include "imu_health.h"
+#include "traj.h"
+#include "ramp.h"
+#include "spi_link.h"
+#include "console.h"
+#include "fw_update.h"
+#include "spi_bus.h"
+#include "seqlock.h"
+#include "lowpower.h"
+#include "battery.h"
+#include "replay.h"
+#include "trace.h"
+#include "rtt.h"
 #include <string.h>
 #include <stdbool.h>
 
-/** @brief Période d'exécution de la tâche moteur (1 ms). */
+/** @brief Période nominale de la tâche moteur (1 ms), libérations fixées par la tâche elle-même. */
 #define TASK_MOTOR_US       1000
-/** @brief Période d'envoi de la télémétrie (10 ms). */
-#define TASK_TELEMETRY_US   10000
-/** @brief Période de calcul de la vitesse (100 ms). */
+/** @brief Période de calcul de la vitesse (20 ms avec datation des fronts, 100 ms en comptage). */
+#if SPEEDO_EDGE_TIMING
+#define TASK_SPEED_US		20000
+#else
 #define TASK_SPEED_US		100000
-/** @brief Délai d'inactivité avant déclenchement du Failsafe (arrêt d'urgence). */
-#define FAILSAFE_TIMEOUT_MS 500
-
-/** @brief Durée d'impulsion pour 1ms (référence PWM). */
-#define t_1_ms 3200
-/** @brief Durée d'impulsion pour 2ms (référence PWM). */
-#define t_2_ms 6400
-
-/** @brief Borne PWM minimale pour l'ESC. */
-#define PWM_MIN_ESC 3200
-/** @brief Borne PWM maximale pour l'ESC. */
-#define PWM_MAX_ESC 6400
-
-/** @brief Instance du servomoteur de direction. */
-static Servo_Handle_t hServo1 = {
-    .htim = &htim1,           		   // Instance du Timer
-    .channel = TIM_CHANNEL_1, 	       // Canal PWM
-    .min_pulse_ticks = t_1_ms,         // Ticks pour 0% (ex: 1ms)
-    .max_pulse_ticks = t_2_ms          // Ticks pour 100% (ex: 2ms)
-};
-
-/** @brief Instance du moteur de propulsion (ESC). */
-static Motor_Handle_t hMotor1 = {
-    .htim = &htim2,					   // Instance du Timer
-    .channel = TIM_CHANNEL_1,		   // Canal PWM
-    .min_pulse_ticks = PWM_MIN_ESC,	   //
-    .max_pulse_ticks = PWM_MAX_ESC,    //
-    .max_speed_pos_mms = 1000,         // Limit max frwd
-    .max_speed_neg_mms = -500		   // Limit max bkwd
-};
+#endif
+/** @brief Acquisition IMU cadencée par la ligne data-ready INT1 (1) ou par la tâche télémétrie (0). */
+#ifndef APP_IMU_DATA_READY
+#define APP_IMU_DATA_READY  0
+#endif
+/**
+ * @brief Machine à états moteur exécutée dans l'interruption SysTick (1) ou par l'ordonnanceur (0).
+ * @details Mode 1 : période fixe de 1 ms indépendante de la charge de la boucle principale ;
+ * les consignes passent par une boîte aux lettres sans verrou (motor_mbox).
+ */
+#ifndef APP_MOTOR_TICK_ISR
+#define APP_MOTOR_TICK_ISR  0
+#endif
+#if APP_MOTOR_TICK_ISR && SCHED_RTOS
+#error "APP_MOTOR_TICK_ISR needs SysTick, which belongs to the kernel when SCHED_RTOS is set"
+#endif
+/**
+ * @brief Boucle de lacet chaînée à l'acquisition IMU (1) ou exécutée au retrait de la file (0).
+ * @details Mode 1 : data-ready -> DMA -> publication -> PendSV -> boucle de lacet ->
+ * écriture CCR, d'une traite et sans attendre la boucle principale ni le tick moteur.
+ * Latence capteur -> actionneur de quelques dizaines de µs et indépendante de la charge
+ * (sonde PROF_PROBE_IMU_E2E), au lieu d'une période de chaque étage. Les estimateurs
+ * (fusion de vitesse, attitude, odométrie) restent au retrait de la file, la boucle de
+ * lacet lisant la vitesse publiée (speed_pub, sans verrou). Sans effet sur un braquage
+ * limité en vitesse (REG_SERVO_SLEW) : la rampe reste cadencée par le tick moteur.
+ */
+#ifndef APP_IMU_CHAIN
+#define APP_IMU_CHAIN       0
+#endif
+#if APP_IMU_CHAIN && !APP_IMU_DATA_READY
+#error "APP_IMU_CHAIN needs APP_IMU_DATA_READY: the chain starts from the data-ready acquisition"
+#endif
+#if APP_IMU_CHAIN && !APP_MOTOR_TICK_ISR
+#error "APP_IMU_CHAIN needs APP_MOTOR_TICK_ISR: actuators must be owned by interrupt context"
+#endif
+#if APP_IMU_CHAIN && !KIN_YAW_LOOP
+#error "APP_IMU_CHAIN needs the yaw loop (KIN_YAW_KP or KIN_YAW_KI non-zero)"
+#endif
+/**
+ * @brief Estimateur d'attitude embarqué sur chaque échantillon IMU (1) ou absent (0).
+ * @details Mode 1 : quaternion disponible dans le champ TELEM_F_ATTITUDE ; l'hôte peut
+ * s'abonner à l'attitude seule (20 octets par trame) au lieu des axes bruts.
+ */
+#ifndef APP_ATTITUDE
+#define APP_ATTITUDE        1
+#endif
+/**
+ * @brief Odométrie embarquée sur chaque échantillon IMU (1) ou absente (0).
+ * @details Mode 1 : pose (X, Y, cap) et distance cumulée lisibles à faible cadence
+ * (REG_ODOM_BASE), intégrées à pleine cadence d'acquisition et indépendantes des pertes
+ * de la liaison.
+ */
+#ifndef APP_ODOMETRY
+#define APP_ODOMETRY        1
+#endif
+/**
+ * @brief Vitesse publiée fusionnée accéléromètre / tachymètre (1) ou tachymètre seul (0).
+ * @details Mode 1 (speed_fuse.h) : la vitesse est intégrée et publiée à chaque
+ * échantillon IMU, recalée à chaque mesure du tachymètre ; télémétrie, boucle de
+ * vitesse et commande cinématique voient une vitesse sans le retard des fronts.
+ */
+#ifndef APP_SPEED_FUSE
+#define APP_SPEED_FUSE      1
+#endif
+/** @brief Chien de garde IWDG rafraîchi par la tâche APP_TASK_WATCHDOG (1) ou inactif (0). */
+#ifndef APP_WATCHDOG
+#define APP_WATCHDOG        1
+#endif
+/**
+ * @brief Suite de mesures en cycles exécutée une fois au démarrage (1) ou absente (0).
+ * @details À définir dans une configuration de build dédiée (-DAPP_BENCH=1) : la suite
+ * bloque la boucle principale environ une seconde, résultats émis en trames type 0x07.
+ */
+#ifndef APP_BENCH
+#define APP_BENCH           0
+#endif
+/**
+ * @brief Veille STOP1 du véhicule garé (1) ou absente (0).
+ * @details Mode 1 : après REG_PARK_MS passées désarmé (failsafe), capteurs en veille,
+ * PWM coupées et cœur en STOP1 jusqu'à une activité UART ou un mouvement (any-motion,
+ * si REG_IDLE_RATE l'arme). Boucle coopérative uniquement : avec SCHED_RTOS, la veille
+ * relève du noyau (tickless idle).
+ */
+#ifndef APP_PARK
+#define APP_PARK            (!SCHED_RTOS)
+#endif
+#if APP_PARK && SCHED_RTOS
+#error "APP_PARK requires the cooperative loop (SCHED_RTOS=0)"
+#endif
+/**
+ * @brief Mode endurance pour les essais de longue durée (1) ou absent (0).
+ * @details À définir dans une configuration de build dédiée (-DAPP_SOAK=1) :
+ * - la base de temps démarre SOAK_WRAP_LEAD_US avant le rebouclage de GetMicrosTotal(),
+ *   qui survient ainsi dès les premières minutes d'essai puis toutes les ~71 minutes ;
+ * - la tâche APP_TASK_SOAK journalise chaque seconde un bilan DLOG_SOAK (passages de
+ *   boucle, overruns cumulés de toutes les tâches, pire retard de libération), suivi
+ *   dans le temps par python_serial_reg/soak_test.py.
+ */
+#ifndef APP_SOAK
+#define APP_SOAK            0
+#endif
+/** @brief Avance de la base de temps sur le rebouclage 32 bits en mode endurance (µs). */
+#define SOAK_WRAP_LEAD_US   120000000u
+/** @brief Période du bilan du mode endurance (µs). */
+#define TASK_SOAK_US        1000000u
+/** @brief Délai après lequel la suite de mesures démarre sans IMU prête (ms). */
+#define BENCH_START_TIMEOUT_MS  3000u
+/** @brief Période de rafraîchissement du chien de garde (µs), bien en deçà de WATCHDOG_TIMEOUT_MS. */
+#define TASK_WATCHDOG_US    50000
+/** @brief Période de lecture de la tension batterie et de mise à jour de la compensation (µs). */
+#define TASK_BATTERY_US     100000
+/** @brief Période du flux d'état lent coupé (µs) : délai de prise en compte d'une nouvelle cadence. */
+#define TASK_STATUS_OFF_US  1000000u
+/** @brief Écart minimal du facteur de compensation avant réapplication (Q12, ~1 %). */
+#define BATT_COMP_HYST_Q12  41u
+/** @brief Lectures par tranche du benchmark SPI (chien de garde rafraîchi entre deux tranches). */
+#define SPI_BENCH_CHUNK     256u
 
 /** @brief Instance du capteur de vitesse (Tachymètre). */
 Speedometer_Handle_t hSpeedo;
+/** @brief Estimateur de vitesse signée et filtrée (sur mesure tachymètre). */
+static Speed_Estimator_t hSpeedEst;
+#if APP_SPEED_FUSE
+/** @brief Vitesse fusionnée accéléromètre / tachymètre. */
+static speed_fuse_t hSpeedFuse;
+#endif
+#if APP_ATTITUDE
+/** @brief Estimateur d'attitude (alimenté par chaque échantillon retiré de la file IMU). */
+static Attitude_Estimator_t hAttitude;
+#endif
+#if APP_ODOMETRY
+/** @brief Odométrie (alimentée par chaque échantillon retiré de la file IMU et par le tachymètre). */
+static Odometry_t hOdom;
+#endif
+/** @brief Commande cinématique (REG_KIN_SPEED / REG_KIN_CURV). */
+static Kin_t hKin;
+/** @brief Profil de la consigne moteur (mm/s), bornes REG_MOTOR_ACCEL / REG_MOTOR_JERK. */
+static ramp_t motor_ramp;
+/** @brief Profil de la consigne de braquage (c°), actif si REG_SERVO_ACCEL > 0. */
+static ramp_t servo_ramp;
+
+/**
+ * @brief État de commande de la propulsion publié par le tick moteur.
+ */
+typedef struct{
+    int16_t cmd_mms;        ///< Consigne appliquée (mm/s, après profil).
+    uint8_t state;          ///< État de la machine à états ESC (MotorState_t).
+} motor_status_t;
+
+/** @brief Dernier état publié (écrit par le tick moteur, tâche ou SysTick). */
+static motor_status_t motor_status;
+/** @brief Verrou de séquence de motor_status. */
+static seqlock_t motor_status_lock = SEQLOCK_INIT;
 
 /** @brief Timestamp de la dernière commande valide reçue (pour le Failsafe). */
 static uint32_t last_cmd_time_ms = 0;
-/** @brief Timestamp de la dernière exécution de la tâche moteur. */
-static uint32_t last_motor_us = 0;
-/** @brief Timestamp de la dernière exécution de la tâche télémétrie. */
-static uint32_t last_telemetry_us = 0;
-/** @brief Timestamp de la dernière exécution de la tâche vitesse. */
-static uint32_t last_speed_us = 0;
+/** @brief Dernière consigne moteur demandée par l'hôte (point de départ de la décélération). */
+static int16_t last_motor_cmd_mms = 0;
+/** @brief Moteur armé : 0 après désarmement par le failsafe, jusqu'à une consigne nulle. */
+static uint8_t motor_armed = 1;
+/** @brief Actionneur visé par REG_ACT_CMD (ACT_SEL_*, suivi dans l'ordre des commandes). */
+static uint8_t act_sel = 0;
+/** @brief Étape courante du failsafe (failsafe_stage_t). */
+static uint8_t failsafe_stage = FAILSAFE_OK;
+/** @brief Date d'acquisition du dernier échantillon émis (décimation à la cadence de télémétrie). */
+static uint64_t last_telem_sent_us = 0;
+/** @brief Cadence effective de la télémétrie (Hz, REG_TELEM_RATE ou REG_IDLE_RATE). */
+static uint32_t telem_rate_hz = TELEM_RATE_DEFAULT_HZ;
+/** @brief Cadence effective des acquisitions IMU (Hz, REG_IMU_RATE ou cadence de télémétrie). */
+static uint32_t imu_rate_hz = TELEM_RATE_DEFAULT_HZ;
+/** @brief État de la mise en veille de la télémétrie (idle_state_t). */
+static uint8_t idle_state = IDLE_ST_OFF;
+/** @brief Compteur de détections de mouvement au dernier passage. */
+static uint32_t idle_motion_events = 0;
+/** @brief Date de la dernière activité (mouvement détecté ou consigne moteur non nulle, ms). */
+static uint32_t idle_last_motion_ms = 0;
+/** @brief Décimation de la régulation de débit (REG_TELEM_DECIM, 1 : toutes les trames). */
+static uint8_t telem_decim = 1;
+/** @brief Rang de l'échantillon courant dans le motif de décimation. */
+static uint8_t telem_decim_phase = 0;
+/** @brief Fenêtres dégagées consécutives (régulation de débit). */
+static uint8_t telem_adapt_calm = 0;
+/** @brief Début de la fenêtre d'évaluation en cours (ms). */
+static uint32_t telem_adapt_start_ms = 0;
+/** @brief Trames refusées par le buffer TX au début de la fenêtre. */
+static uint32_t telem_adapt_drops = 0;
+/** @brief Échantillons émis depuis le début de la fenêtre. */
+static uint32_t telem_adapt_sent = 0;
+/** @brief Cadence effective mesurée sur la dernière fenêtre (REG_TELEM_EFF_RATE, Hz). */
+static uint32_t telem_eff_hz = 0;
+#if APP_BENCH
+/** @brief Avancement du banc : 0 suite à exécuter, 1 budgets à contrôler, 2 terminé. */
+static uint8_t bench_done = 0;
+/** @brief Fin de la suite de mesures (ms), origine du délai BENCH_BUDGET_DELAY_MS. */
+static uint32_t bench_end_ms = 0;
+#endif
 
-/** @brief Variable globale stockant la vitesse actuelle (partagée avec serial_cmd). */
-float speed_speedo_data = 0.0f;
+/** @brief Date de chaque étape du démarrage (µs depuis le reset). */
+static uint32_t boot_stage_us[BOOT_STAGE_COUNT];
+/** @brief Étapes du démarrage déjà datées (bit n = étape n). */
+static uint8_t boot_reached = 0;
+/** @brief Décalage entre GetMicros64() et la date depuis le reset (relevé à BOOT_STAGE_HAL). */
+static uint32_t boot_base_us = 0;
 
-/** @brief Compteur de débordements pour le Timer 3 (Extension 16-bit vers 32-bit). */
-volatile uint32_t tim3_overflow_cnt = 0;
+/** @brief Latence réception -> application de la dernière commande (µs). */
+static uint32_t cmd_latency_last_us = 0;
+/** @brief Latence réception -> application maximale observée (µs). */
+static uint32_t cmd_latency_max_us = 0;
+/**
+ * @brief Dates de la dernière commande d'actionneur appliquée (boucle principale -> tick
+ * moteur) : arrivée des octets et application, publiées par act_lat_seq.
+ */
+static volatile uint32_t act_lat_rx_us = 0;
+static volatile uint32_t act_lat_app_us = 0;
+/** @brief Numéro de dépôt des dates act_lat_*, incrémenté après leur écriture. */
+static volatile uint32_t act_lat_seq = 0;
+
+#if APP_MOTOR_TICK_ISR
+/**
+ * @brief Boîte aux lettres de consigne moteur (boucle principale -> SysTick).
+ * @details Mot 32 bits (écriture atomique sur M0+) : bits 17..31 numéro de dépôt,
+ * bit 16 consigne directe (sans profil), bits 0..15 consigne en mm/s. La dernière
+ * consigne déposée l'emporte.
+ */
+static volatile uint32_t motor_mbox = 0;
+/** @brief Position du numéro de dépôt dans motor_mbox. */
+#define MOTOR_MBOX_SEQ_SHIFT    17u
+/** @brief Drapeau de consigne directe dans motor_mbox. */
+#define MOTOR_MBOX_DIRECT       (1u << 16)
+/** @brief Autorise l'exécution du tick moteur en interruption (fin d'app_config). */
+static volatile uint8_t motor_tick_enabled = 0;
+/**
+ * @brief Boîte aux lettres de mesure de vitesse (tâche vitesse -> SysTick).
+ * @details Même format que motor_mbox : numéro de dépôt sur 16 bits, vitesse mesurée (mm/s).
+ */
+static volatile uint32_t speed_fb_mbox = 0;
+#endif
+
+/** @brief Lot d'échantillons bruts en cours de constitution (télémétrie compacte). */
+static telem_raw_sample_t telem_batch[TELEM_DELTA_MAX_SAMPLES];
+/** @brief Nombre d'échantillons dans telem_batch. */
+static uint8_t telem_batch_count = 0;
+#if APP_PARK
+/** @brief Date de la dernière sortie de veille (ms) : délai REG_PARK_MS avant la suivante. */
+static uint32_t park_ref_ms = 0;
+/** @brief Date de sortie de veille (µs), 0 : pas de mesure du temps de réveil en cours. */
+static uint64_t park_wake_us = 0;
+/** @brief Numéro de trame de télémétrie au réveil (première trame suivante : fin du réveil). */
+static uint16_t park_wake_seq = 0;
+/** @brief Cause du dernier réveil (lp_wake_t). */
+static uint8_t park_cause = 0;
+/** @brief Durée de la dernière veille (ms). */
+static uint32_t park_slept_ms = 0;
+#endif
+
+/** @brief Vitesse estimée publiée par la tâche vitesse (partagée avec serial_cmd). */
+speed_pub_t speed_pub;
 
-static uint32_t GetMicrosTotal(void);
 static void process_incoming_commands(void);
 static void check_failsafe_security(void);
-static void task_motor_update(uint32_t now_us);
-static void task_telemetry_update(uint32_t now_us);
-static void task_get_speed(uint32_t now_us);
+#if !APP_MOTOR_TICK_ISR
+static void task_motor_update(uint64_t now_us);
+#endif
+static void task_imu_trigger(uint64_t now_us);
+static void task_telemetry_update(uint64_t now_us);
+static void task_get_speed(uint64_t now_us);
+static void task_watchdog(uint64_t now_us);
+static void task_battery(uint64_t now_us);
+static void task_status(uint64_t now_us);
+#if APP_SOAK
+static void task_soak(uint64_t now_us);
+#endif
+#if !SCHED_RTOS
+static void app_idle(void);
+#endif
+
+/**
+ * @brief Index des tâches dans la table de l'ordonnanceur.
+ */
+typedef enum {
+#if !APP_MOTOR_TICK_ISR
+    APP_TASK_MOTOR,         ///< Machine à états moteur et actionneurs (sur événement ou échéance).
+#endif
+    APP_TASK_IMU,           ///< Déclenchement des acquisitions IMU (cadence REG_IMU_RATE).
+    APP_TASK_SPEED,         ///< Calcul de la vitesse (TASK_SPEED_US).
+    APP_TASK_TELEMETRY,     ///< Vidage de la file IMU vers le port série (chaque passage).
+    APP_TASK_WATCHDOG,      ///< Rafraîchissement du chien de garde (TASK_WATCHDOG_US).
+    APP_TASK_BATTERY,       ///< Tension batterie et compensation moteur (TASK_BATTERY_US).
+    APP_TASK_STATUS,        ///< Flux d'état lent (cadence REG_TELEM_FORMAT bits 8-15).
+#if APP_SOAK
+    APP_TASK_SOAK,          ///< Bilan du mode endurance (TASK_SOAK_US).
+#endif
+    APP_TASK_COUNT
+} app_task_id_t;
+
+/**
+ * @brief Table des tâches périodiques : ajouter une tâche = ajouter une ligne.
+ * @note  Les phases décalent les tâches lentes pour qu'elles ne tombent pas sur le même passage.
+ */
+static sched_task_t app_tasks[APP_TASK_COUNT] = {
+#if !APP_MOTOR_TICK_ISR
+    [APP_TASK_MOTOR]     = { .name = "motor",     .period_us = TASK_MOTOR_US, .phase_us = 0,   .priority = 0, .fn = task_motor_update     },  // Libération fixée par la tâche
+#endif
+    [APP_TASK_IMU]       = { .name = "imu",       .period_us = 1000000u / TELEM_RATE_DEFAULT_HZ, .phase_us = 250, .priority = 1, .fn = task_imu_trigger },
+    [APP_TASK_SPEED]     = { .name = "speed",     .period_us = TASK_SPEED_US, .phase_us = 500, .priority = 2, .fn = task_get_speed        },
+    [APP_TASK_TELEMETRY] = { .name = "telemetry", .period_us = 0,             .phase_us = 0,   .priority = 3, .fn = task_telemetry_update },
+    [APP_TASK_WATCHDOG]  = { .name = "watchdog",  .period_us = TASK_WATCHDOG_US, .phase_us = 750, .priority = 4, .fn = task_watchdog },
+    [APP_TASK_BATTERY]   = { .name = "battery",   .period_us = TASK_BATTERY_US, .phase_us = 900, .priority = 5, .fn = task_battery },
+    [APP_TASK_STATUS]    = { .name = "status",    .period_us = TASK_STATUS_OFF_US, .phase_us = 925, .priority = 6, .fn = task_status },
+#if APP_SOAK
+    [APP_TASK_SOAK]      = { .name = "soak",      .period_us = TASK_SOAK_US, .phase_us = 950, .priority = 7, .fn = task_soak },
+#endif
+};
+
+/**
+ * @brief  Transmet une consigne de braquage, à travers le profil s'il est actif.
+ * @param  cdeg Angle cible en centi-degrés (borné à SERVO_CLAMP_*_CDEG).
+ */
+static void servo_target(int32_t cdeg){
+    if(cdeg < SERVO_CLAMP_MIN_CDEG) cdeg = SERVO_CLAMP_MIN_CDEG;
+    if(cdeg > SERVO_CLAMP_MAX_CDEG) cdeg = SERVO_CLAMP_MAX_CDEG;
+
+    if(ramp_limited(&servo_ramp)){
+        ramp_set_target(&servo_ramp, (int16_t)cdeg);
+    }
+    else{
+        ramp_jump(&servo_ramp, (int16_t)cdeg);
+        servo_set_centideg(&act_servo[ACT_SERVO_STEER], (int16_t)cdeg);
+    }
+}
+
+/**
+ * @brief  Transmet une consigne de vitesse au profil moteur (contexte du tick moteur).
+ * @param  speed_mms Consigne de vitesse (mm/s).
+ * @param  direct    true pour appliquer la consigne d'un bloc (failsafe), profil recalé.
+ */
+static void motor_target(int16_t speed_mms, bool direct){
+    if(direct || !ramp_limited(&motor_ramp)){
+        ramp_jump(&motor_ramp, speed_mms);
+        motor_set_speed_mms(&act_motor[ACT_MOTOR_DRIVE], speed_mms);
+    }
+    else{
+        ramp_set_target(&motor_ramp, speed_mms);
+    }
+}
+
+/**
+ * @brief  Fait avancer les profils de consigne d'un pas (tick moteur).
+ * @details La sortie de chaque profil en mouvement devient la consigne de l'actionneur :
+ * le moteur la reçoit avant l'exécution de sa machine à états.
+ * @return true si un profil n'a pas atteint sa consigne (nouveau tick nécessaire dans 1 ms).
+ */
+static bool ramps_tick(void){
+    bool moving = false;
+
+    if(ramp_busy(&motor_ramp)){
+        moving = ramp_tick(&motor_ramp);
+        motor_set_speed_mms(&act_motor[ACT_MOTOR_DRIVE], ramp_output(&motor_ramp));
+    }
+    if(ramp_busy(&servo_ramp)){
+        moving = ramp_tick(&servo_ramp) || moving;
+        servo_set_centideg(&act_servo[ACT_SERVO_STEER], ramp_output(&servo_ramp));
+    }
+    return moving;
+}
+
+/**
+ * @brief  Applique les points de trajectoire dus (tick moteur).
+ * @details Seul le dernier point dû est appliqué si plusieurs sont échus depuis le tick
+ * précédent. Un moteur désarmé par le failsafe reçoit une consigne nulle.
+ * @param  now_us Timestamp actuel en microsecondes.
+ */
+static void traj_tick(uint64_t now_us){
+    traj_point_t pt;
+    bool due = false;
+
+    while(traj_poll(now_us, &pt)){
+        due = true;
+    }
+    if(!due){
+        return;
+    }
+
+    servo_target(pt.servo_cdeg);
+    last_motor_cmd_mms = motor_armed ? pt.speed_mms : 0;
+    motor_target(last_motor_cmd_mms, false);
+}
+
+/**
+ * @brief  Réveille la tâche moteur : une consigne d'actionneur a été déposée.
+ * @note   Sans effet en mode APP_MOTOR_TICK_ISR (actionneurs appliqués à chaque tick).
+ */
+static void actuators_wake(void){
+#if !APP_MOTOR_TICK_ISR
+    sched_set_release(APP_TASK_MOTOR, GetMicros64());
+#endif
+}
+
+/**
+ * @brief  Dépose les dates d'une commande d'actionneur pour la mesure de latence.
+ * @details Le tick moteur suivant (tâche réveillée ici, ou SysTick) relève l'écriture
+ * des CCR (act_latency_record()). Plusieurs commandes appliquées avant ce tick : seule
+ * la dernière est mesurée.
+ * @param  cmd    Commande appliquée.
+ * @param  app_us Date de son application (GetMicrosTotal).
+ */
+static void act_latency_mark(const serial_cmd_t *cmd, uint32_t app_us){
+    act_lat_rx_us = cmd->t_rx_us;
+    act_lat_app_us = app_us;
+    __DMB();
+    act_lat_seq++;
+    actuators_wake();
+}
+
+/**
+ * @brief  Comptabilise la latence de la dernière commande d'actionneur (après écriture des CCR).
+ * @details Sondes PROF_PROBE_CMD_ACT (application -> CCR) et PROF_PROBE_CMD_E2E
+ * (arrivée des octets -> CCR), alimentées depuis le seul contexte du tick moteur. La
+ * nouvelle valeur d'un CCR préchargé sort au début de la période PWM suivante.
+ */
+static void act_latency_record(void){
+    static uint32_t seen = 0;
+    const uint32_t seq = act_lat_seq;
+
+    if(seq == seen){
+        return;
+    }
+    seen = seq;
+    __DMB();
+    const uint32_t now_us = GetMicrosTotal();
+    prof_record(prof_probe(PROF_PROBE_CMD_ACT), now_us - act_lat_app_us);
+    prof_record(prof_probe(PROF_PROBE_CMD_E2E), now_us - act_lat_rx_us);
+}
+
+/**
+ * @brief  Réveille la tâche moteur si la machine à états a du travail.
+ */
+static void motor_wake(void){
+#if !APP_MOTOR_TICK_ISR
+    if(actuators_need_process(HAL_GetTick())){
+        actuators_wake();
+    }
+#endif
+}
+
+/**
+ * @brief  Publie l'état de commande de la propulsion (fin du tick moteur).
+ */
+static void motor_status_publish(void){
+    const Motor_Handle_t *m = &act_motor[ACT_MOTOR_DRIVE];
+
+    seqlock_write_begin(&motor_status_lock);
+    motor_status.cmd_mms = m->ctx.target_speed_mms;
+    motor_status.state = (uint8_t)m->state;
+    seqlock_write_end(&motor_status_lock);
+}
+
+/**
+ * @brief  Relève un état de commande cohérent, sans masquer le tick SysTick.
+ * @param  out Copie de sortie.
+ */
+static void motor_status_read(motor_status_t *out){
+    uint32_t s;
+
+    do{
+        s = seqlock_read_begin(&motor_status_lock);
+        *out = motor_status;
+    }
+    while(seqlock_read_retry(&motor_status_lock, s));
+}
+
+/**
+ * @brief  Répond à REG_SNAPSHOT : relève l'état du véhicule d'un bloc et l'émet (type 0x0E).
+ * @details Relevé interruptions masquées : ni le tick moteur (SysTick en
+ * APP_MOTOR_TICK_ISR), ni la fin d'une acquisition DMA, ni l'estimateur de vitesse ne
+ * peuvent s'intercaler entre deux champs. La lecture seqlock du dernier échantillon
+ * aboutit donc du premier coup ; sa conversion en virgule fixe (six multiplications)
+ * est la partie la plus longue de la section critique.
+ * @param  token Valeur écrite dans REG_SNAPSHOT, renvoyée dans la trame.
+ */
+static void snapshot_send(uint16_t token){
+    SerialSnapFrame_t frame;
+    bmi088_data_fx_t imu;
+    const Motor_Handle_t *m = &act_motor[ACT_MOTOR_DRIVE];
+
+    __disable_irq();
+    frame.t_us          = GetMicrosTotal();
+    frame.servo_cmd     = (int8_t)reg_file[REG_SERVO_CMD];
+    frame.motor_cmd_mms = m->ctx.target_speed_mms;
+    frame.motor_state   = (uint8_t)m->state;
+    frame.go_forward    = m->go_forward ? 1u : 0u;
+    frame.target_ticks  = m->ctx.target_ticks;
+    frame.fs_stage      = app_failsafe_stage();
+    frame.speed_mms     = (int16_t)speed_pub_mms(&speed_pub);
+    frame.imu_seq       = BMI088_Get_Latest_Fx(&imu);
+    __enable_irq();
+
+    if(frame.imu_seq != 0){
+        frame.imu_t_us = (uint32_t)imu.timestamp_us;
+        memcpy(frame.accel, imu.accel_mms2, sizeof(frame.accel));
+        memcpy(frame.gyro, imu.gyro_urads, sizeof(frame.gyro));
+    }
+    else{
+        frame.imu_t_us = 0;
+        memset(frame.accel, 0, sizeof(frame.accel));
+        memset(frame.gyro, 0, sizeof(frame.gyro));
+    }
+
+    serial_send_snapshot(&frame, token);
+}
+
+/**
+ * @brief  Transmet une consigne de vitesse au moteur.
+ * @details Appel direct en mode ordonnancé ; dépôt dans motor_mbox, relevé par le
+ * tick SysTick, en mode APP_MOTOR_TICK_ISR.
+ * @param  speed_mms Consigne de vitesse (mm/s).
+ * @param  direct    true pour contourner le profil de consigne (neutre du failsafe).
+ */
+static void motor_command(int16_t speed_mms, bool direct){
+#if APP_MOTOR_TICK_ISR
+    uint32_t seq = (motor_mbox >> MOTOR_MBOX_SEQ_SHIFT) + 1u;
+    motor_mbox = (seq << MOTOR_MBOX_SEQ_SHIFT) | (direct ? MOTOR_MBOX_DIRECT : 0u) | (uint16_t)speed_mms;
+#else
+    motor_target(speed_mms, direct);
+    if(ramp_busy(&motor_ramp)){
+        actuators_wake();
+    }
+    else{
+        motor_wake();
+    }
+#endif
+}
+
+/**
+ * @brief  Transmet une mesure de vitesse à la boucle de vitesse du moteur.
+ * @param  speed_mms Vitesse estimée (mm/s, signée).
+ */
+static void motor_feedback(int16_t speed_mms){
+#if APP_MOTOR_TICK_ISR
+    uint32_t seq = (speed_fb_mbox >> 16) + 1u;
+    speed_fb_mbox = (seq << 16) | (uint16_t)speed_mms;
+#else
+    motor_speed_feedback(&act_motor[ACT_MOTOR_DRIVE], speed_mms);
+    motor_wake();
+#endif
+}
+
+/**
+ * @brief Réglages appliqués par le tick moteur (gains, profil ESC, bornes des rampes).
+ * @details Deux bancs : la boucle principale reconstruit le banc inactif depuis les
+ * registres puis publie son numéro ; le tick moteur bascule sur le banc publié au début
+ * de son passage suivant. Un tick voit donc toujours un jeu de réglages cohérent, sans
+ * section critique (le tick préempte la boucle principale, jamais l'inverse).
+ */
+typedef struct{
+    int16_t  kp_q12, ki_q12, kd_q12;       ///< Gains de la boucle de vitesse (Q12).
+    Motor_Esc_Profile_t esc;               ///< Profil de temporisation des ESC.
+    uint32_t motor_vel_q16, motor_acc_q16; ///< Bornes du profil de consigne moteur.
+    uint32_t servo_vel_q16, servo_acc_q16; ///< Bornes du profil de braquage (0 : coupé).
+    uint16_t steer_slew_dps;               ///< Limitation du pilote de braquage (°/s).
+    uint16_t aux_slew_dps;                 ///< Limitation des servos auxiliaires (°/s).
+} act_cfg_t;
+
+static act_cfg_t act_cfg_bank[2];
+static volatile uint8_t act_cfg_seq = 0;   ///< Numéro publié (banc actif : seq & 1).
+static uint8_t act_cfg_seq_applied = 0;    ///< Numéro appliqué par le tick moteur.
+static act_cfg_t act_cfg_cur;              ///< Réglages appliqués (comparaison).
+static bool act_cfg_valid = false;         ///< act_cfg_cur renseigné.
+
+/**
+ * @brief  Reconstruit le banc inactif depuis les registres et le publie.
+ * @details Moteur : 1 mm/s² vaut 1/1000 mm/s par tick, 1 mm/s² par ms 1/1000 mm/s par
+ * tick². Servo : avec REG_SERVO_ACCEL nul, REG_SERVO_SLEW reste une limitation de
+ * vitesse du pilote ; sinon, le profil en c° porte les deux bornes (1 °/s = 0,1 c° par
+ * tick, 1 °/s² = 1/10000 c° par tick²) et la limitation du pilote est coupée. Les servos
+ * auxiliaires gardent REG_SERVO_SLEW comme limitation du pilote.
+ */
+static void act_cfg_publish(void){
+    const uint8_t  seq   = (uint8_t)(act_cfg_seq + 1u);
+    act_cfg_t     *c     = &act_cfg_bank[seq & 1u];
+    const uint32_t accel = (uint16_t)reg_file[REG_MOTOR_ACCEL];
+    const uint32_t jerk  = (uint16_t)reg_file[REG_MOTOR_JERK];
+    const uint32_t dps   = (uint16_t)reg_file[REG_SERVO_SLEW];
+    const uint32_t dps2  = (uint16_t)reg_file[REG_SERVO_ACCEL];
+
+    c->kp_q12 = reg_file[REG_SPEED_KP];
+    c->ki_q12 = reg_file[REG_SPEED_KI];
+    c->kd_q12 = reg_file[REG_SPEED_KD];
+
+    c->esc.brake_ms       = (uint16_t)reg_file[REG_ESC_BRAKE_MS];
+    c->esc.neutral_gap_ms = (uint16_t)reg_file[REG_ESC_GAP_MS];
+    c->esc.brake_depth    = (uint8_t)reg_file[REG_ESC_BRAKE_DEPTH];
+
+    c->motor_vel_q16 = (accel << 16) / 1000u;
+    c->motor_acc_q16 = (accel != 0u) ? (jerk << 16) / 1000u : 0u;
+    if(dps2 == 0u){
+        c->servo_vel_q16  = 0;
+        c->servo_acc_q16  = 0;
+        c->steer_slew_dps = (uint16_t)dps;
+    }
+    else{
+        c->servo_vel_q16  = (dps << 16) / 10u;
+        c->servo_acc_q16  = (dps2 << 16) / 10000u;
+        c->steer_slew_dps = 0;
+    }
+    c->aux_slew_dps = (uint16_t)dps;
+
+    act_cfg_seq = seq;
+}
+
+/**
+ * @brief  Bascule sur le banc publié (début du tick moteur).
+ * @details Seuls les réglages modifiés sont appliqués : un changement de profil ESC ou
+ * de rampe ne remet pas à zéro l'intégrale de la boucle de vitesse.
+ */
+static void act_cfg_apply(void){
+    const uint8_t seq = act_cfg_seq;
+    if(seq == act_cfg_seq_applied){
+        return;
+    }
+    act_cfg_seq_applied = seq;
+
+    const act_cfg_t *c = &act_cfg_bank[seq & 1u];
+    act_cfg_t *o = &act_cfg_cur;
+
+    if(!act_cfg_valid || c->kp_q12 != o->kp_q12 || c->ki_q12 != o->ki_q12 || c->kd_q12 != o->kd_q12){
+        motor_set_speed_gains(&act_motor[ACT_MOTOR_DRIVE], c->kp_q12, c->ki_q12, c->kd_q12);
+    }
+    if(!act_cfg_valid || c->esc.brake_ms != o->esc.brake_ms ||
+       c->esc.neutral_gap_ms != o->esc.neutral_gap_ms || c->esc.brake_depth != o->esc.brake_depth){
+        for(uint8_t i = 0; i < ACT_MOTOR_COUNT; i++){
+            motor_set_esc_profile(&act_motor[i], &c->esc);
+        }
+    }
+    if(!act_cfg_valid || c->motor_vel_q16 != o->motor_vel_q16 || c->motor_acc_q16 != o->motor_acc_q16){
+        ramp_set_limits(&motor_ramp, c->motor_vel_q16, c->motor_acc_q16);
+    }
+    if(!act_cfg_valid || c->servo_vel_q16 != o->servo_vel_q16 || c->servo_acc_q16 != o->servo_acc_q16 ||
+       c->steer_slew_dps != o->steer_slew_dps){
+        ramp_set_limits(&servo_ramp, c->servo_vel_q16, c->servo_acc_q16);
+        servo_set_slew_dps(&act_servo[ACT_SERVO_STEER], c->steer_slew_dps);
+    }
+    if(!act_cfg_valid || c->aux_slew_dps != o->aux_slew_dps){
+        for(uint8_t i = ACT_SERVO_STEER + 1u; i < ACT_SERVO_COUNT; i++){
+            servo_set_slew_dps(&act_servo[i], c->aux_slew_dps);
+        }
+    }
+
+    *o = *c;
+    act_cfg_valid = true;
+}
+
+/**
+ * @brief  Recharge les gains de la boucle de vitesse depuis les registres.
+ * @note   Appliqués au tick moteur suivant (act_cfg_apply()).
+ */
+static void motor_gains_reload(void){
+    act_cfg_publish();
+    actuators_wake();
+}
+
+/**
+ * @brief  Recharge le profil de temporisation des ESC (tous identiques) depuis les registres.
+ * @note   Appliqué au tick moteur suivant (act_cfg_apply()).
+ */
+static void motor_esc_profile_reload(void){
+    act_cfg_publish();
+    actuators_wake();
+}
+
+/**
+ * @brief  Recharge les bornes des profils de consigne depuis les registres.
+ * @note   Appliquées au tick moteur suivant (act_cfg_apply()).
+ */
+static void ramps_reload(void){
+    act_cfg_publish();
+    actuators_wake();
+}
+
+/**
+ * @brief  Applique REG_IDLE_RATE / REG_MOTION_MG : arme ou coupe la détection de mouvement.
+ * @details Une reconfiguration repart de l'état actif : la cadence de repos n'est
+ * reprise qu'après REG_IDLE_HOLD_MS sans mouvement.
+ */
+static void idle_gate_reload(void){
+    const uint16_t thr_mg = (reg_file[REG_IDLE_RATE] != 0) ? (uint16_t)reg_file[REG_MOTION_MG] : 0u;
+    const int8_t   rslt   = BMI088_Motion_Config(thr_mg, TELEM_MOTION_DURATION_MS);
+
+    idle_motion_events  = BMI088_Motion_Events();
+    idle_last_motion_ms = HAL_GetTick();
+
+    if(thr_mg == 0){
+        idle_state = IDLE_ST_OFF;
+    }
+    else{
+        idle_state = (rslt == BMI08_OK) ? IDLE_ST_ACTIVE : IDLE_ST_ERROR;
+    }
+}
+
+/**
+ * @brief  Applique le réglage de l'historique IMU (REG_HIST_THR_MG, REG_HIST_POST, gammes).
+ */
+static void hist_reload(void){
+    bmi088_config_t cfg;
+
+    BMI088_Get_Config(&cfg);
+    imu_hist_configure((uint16_t)reg_file[REG_HIST_THR_MG], (uint16_t)reg_file[REG_HIST_POST],
+                       (uint8_t)(IMU_CFG_PACK(&cfg) & 0x1Fu));
+}
+
+/**
+ * @brief  Applique le réglage de l'analyse vibratoire (REG_VIB_CMD, REG_VIB_AVG, gammes).
+ */
+static void vib_reload(void){
+    bmi088_config_t cfg;
+
+    BMI088_Get_Config(&cfg);
+    vib_configure((uint8_t)reg_file[REG_VIB_CMD], (uint8_t)reg_file[REG_VIB_AVG],
+                  (uint8_t)(IMU_CFG_PACK(&cfg) & 0x1Fu));
+}
+
+/**
+ * @brief  Fait évoluer la mise en veille et renvoie la cadence de télémétrie à appliquer.
+ * @details Toute détection de mouvement (interruption any-motion comptée par le driver)
+ * ou consigne moteur non nulle marque une activité ; au repos, la première activité
+ * rétablit REG_TELEM_RATE et libère immédiatement une acquisition.
+ * @param  now_us Timestamp actuel en microsecondes.
+ * @return Cadence (Hz).
+ */
+static uint32_t idle_gate_rate_hz(uint64_t now_us){
+    const uint32_t rate_hz = (uint32_t)reg_file[REG_TELEM_RATE];
+
+    if(idle_state != IDLE_ST_ACTIVE && idle_state != IDLE_ST_IDLE){
+        return rate_hz;
+    }
+
+    const uint32_t now_ms = HAL_GetTick();
+    const uint32_t events = BMI088_Motion_Events();
+
+    if(events != idle_motion_events || last_motor_cmd_mms != 0){
+        idle_motion_events  = events;
+        idle_last_motion_ms = now_ms;
+        if(idle_state == IDLE_ST_IDLE){
+            idle_state = IDLE_ST_ACTIVE;
+            sched_set_release(APP_TASK_IMU, now_us);
+        }
+    }
+    else if(idle_state == IDLE_ST_ACTIVE && (now_ms - idle_last_motion_ms) >= (uint16_t)reg_file[REG_IDLE_HOLD_MS]){
+        idle_state = IDLE_ST_IDLE;
+    }
+
+    if(idle_state == IDLE_ST_IDLE && (uint32_t)reg_file[REG_IDLE_RATE] < rate_hz){
+        return (uint32_t)reg_file[REG_IDLE_RATE];
+    }
+
+    return rate_hz;
+}
+
+/**
+ * @brief  Cadence des acquisitions IMU à appliquer.
+ * @details REG_IMU_RATE si elle est définie, sinon la cadence de télémétrie ; au repos,
+ * la cadence de veille l'emporte si elle est plus lente. Bornée à la cadence de données
+ * du capteur le plus rapide : un changement d'ODR (profil de REG_IMU_CONFIG) se reporte
+ * au passage suivant d'app_poll().
+ * @return Cadence (Hz).
+ */
+static uint32_t imu_gate_rate_hz(void){
+    uint32_t rate_hz = (uint32_t)reg_file[REG_IMU_RATE];
+    const uint32_t sensor_hz = 1000000u / BMI088_Sample_Period_us();
+
+    if(rate_hz == 0 || (idle_state == IDLE_ST_IDLE && telem_rate_hz < rate_hz)){
+        rate_hz = telem_rate_hz;
+    }
+    if(rate_hz > sensor_hz){
+        rate_hz = sensor_hz;    // Au-delà, chaque lecture rendrait le même échantillon
+    }
+
+    return rate_hz;
+}
+
+/**
+ * @brief  État de la mise en veille de la télémétrie.
+ * @return idle_state_t (REG_IDLE_STATE).
+ */
+uint8_t app_idle_state(void){
+    return idle_state;
+}
+
+/**
+ * @brief  Régulation de débit : ajuste la décimation à la fin de chaque fenêtre.
+ * @details Une fenêtre est saturée si le buffer TX a refusé des trames ou si sa place
+ * libre est sous TELEM_ADAPT_LOW_PCT % : la décimation double (borne REG_TELEM_ADAPT).
+ * Elle n'est divisée par deux qu'après TELEM_ADAPT_CALM_WINDOWS fenêtres consécutives
+ * au-dessus de TELEM_ADAPT_HIGH_PCT % (hystérésis : pas d'oscillation au débit limite).
+ * La cadence effective de la fenêtre écoulée est relevée au passage.
+ */
+static void telem_adapt_update(void){
+    const uint32_t now_ms  = HAL_GetTick();
+    const uint32_t elapsed = now_ms - telem_adapt_start_ms;
+
+    if(elapsed < TELEM_ADAPT_WINDOW_MS){
+        return;
+    }
+
+    const uint32_t drops     = serial_tx_dropped();
+    const uint32_t new_drops = drops - telem_adapt_drops;
+    const uint32_t free_b    = serial_tx_free();
+    const uint8_t  cap       = (reg_file[REG_TELEM_ADAPT] > 1) ? (uint8_t)reg_file[REG_TELEM_ADAPT] : 1u;
+    uint8_t decim = telem_decim;
+
+    telem_eff_hz         = (telem_adapt_sent * 1000u) / elapsed;
+    telem_adapt_sent     = 0;
+    telem_adapt_drops    = drops;
+    telem_adapt_start_ms = now_ms;
+
+    if(new_drops != 0 || free_b < (SERIAL_TX_RING_SIZE * TELEM_ADAPT_LOW_PCT) / 100u){
+        telem_adapt_calm = 0;
+        decim = (uint8_t)(decim * 2u);
+    }
+    else if(free_b > (SERIAL_TX_RING_SIZE * TELEM_ADAPT_HIGH_PCT) / 100u){
+        if(decim > 1u && ++telem_adapt_calm >= TELEM_ADAPT_CALM_WINDOWS){
+            telem_adapt_calm = 0;
+            decim = (uint8_t)(decim / 2u);
+        }
+    }
+    else{
+        telem_adapt_calm = 0;
+    }
+
+    if(decim > cap){
+        decim = cap;        // Borne atteinte ou abaissée par l'hôte
+    }
+
+    if(decim != telem_decim){
+        DLOG3(DLOG_TELEM_DECIM, decim, free_b, new_drops);
+        telem_decim       = decim;
+        telem_decim_phase = 0;
+    }
+}
+
+/**
+ * @brief  Décimation à la cadence de télémétrie : l'échantillon retiré de la file doit-il être émis ?
+ * @details Sans objet si les acquisitions ne sont pas plus rapides que la télémétrie.
+ * Sinon, comparaison sur les dates d'acquisition (et non de retrait : une file
+ * vidée en rafale reste décimée régulièrement), avec une tolérance d'une
+ * demi-période d'acquisition contre la gigue de déclenchement. En mode data-ready,
+ * la cadence est celle du capteur, sans tolérance.
+ * @param  sample_us Date d'acquisition de l'échantillon (µs).
+ * @return 1 si l'échantillon est à émettre, 0 sinon.
+ */
+static uint8_t telem_rate_keep(uint64_t sample_us){
+    const uint8_t drdy = BMI088_DataReady_Active();
+
+    if(!drdy && imu_rate_hz <= telem_rate_hz){
+        return 1;
+    }
+
+    const uint32_t slack_us  = drdy ? 0u : (1000000u / imu_rate_hz) / 2u;
+    const uint32_t period_us = 1000000u / telem_rate_hz;
+
+    if(sample_us - last_telem_sent_us + slack_us < period_us){
+        return 0;
+    }
+
+    last_telem_sent_us = sample_us;
+    return 1;
+}
+
+/**
+ * @brief  Régulation de débit : l'échantillon retiré de la file doit-il être émis ?
+ * @return 1 pour un échantillon sur telem_decim (compté dans la cadence effective), 0 sinon.
+ */
+static uint8_t telem_adapt_keep(void){
+    if(++telem_decim_phase < telem_decim){
+        return 0;
+    }
+    telem_decim_phase = 0;
+    telem_adapt_sent++;
+    return 1;
+}
+
+/**
+ * @brief  Décimation appliquée par la régulation de débit de la télémétrie.
+ * @return 1 : toutes les trames émises, N : une sur N (REG_TELEM_DECIM).
+ */
+uint8_t app_telem_decimation(void){
+    return telem_decim;
+}
+
+/**
+ * @brief  Odométrie embarquée.
+ * @return Pointeur vers l'état de l'odométrie, NULL si APP_ODOMETRY = 0.
+ */
+const Odometry_t *app_odometry(void){
+#if APP_ODOMETRY
+    return &hOdom;
+#else
+    return NULL;
+#endif
+}
+
+/**
+ * @brief  Cadence effective de la télémétrie, mesurée sur la dernière fenêtre.
+ * @return Échantillons émis par seconde (REG_TELEM_EFF_RATE).
+ */
+uint32_t app_telem_effective_hz(void){
+    return telem_eff_hz;
+}
+
+/**
+ * @brief  Restaure la configuration persistante et en tire les limites des actionneurs.
+ * @details Les limites compilées des actionneurs de tête (act_motor / act_servo) sont d'abord publiées dans
+ * les registres, puis la configuration enregistrée en flash les remplace. Une limite
+ * incohérente (vitesse nulle, impulsion min >= max) conserve sa valeur compilée.
+ * @note   Avant servo_initialisation() et motor_init(), qui précalculent leurs tables.
+ */
+static void actuators_limits_restore(void){
+    reg_file[REG_MOTOR_MAX_FWD]   = act_motor[ACT_MOTOR_DRIVE].max_speed_pos_mms;
+    reg_file[REG_MOTOR_MAX_REV]   = (int16_t)-act_motor[ACT_MOTOR_DRIVE].max_speed_neg_mms;
+    reg_file[REG_SERVO_MIN_TICKS] = (int16_t)act_servo[ACT_SERVO_STEER].min_pulse_ticks;
+    reg_file[REG_SERVO_MAX_TICKS] = (int16_t)act_servo[ACT_SERVO_STEER].max_pulse_ticks;
+
+    serial_cmd_nv_restore();
+
+    if(reg_file[REG_MOTOR_MAX_FWD] > 0 && reg_file[REG_MOTOR_MAX_REV] > 0){
+        act_motor[ACT_MOTOR_DRIVE].max_speed_pos_mms = reg_file[REG_MOTOR_MAX_FWD];
+        act_motor[ACT_MOTOR_DRIVE].max_speed_neg_mms = (int16_t)-reg_file[REG_MOTOR_MAX_REV];
+    }
+    else{
+        reg_file[REG_MOTOR_MAX_FWD] = act_motor[ACT_MOTOR_DRIVE].max_speed_pos_mms;
+        reg_file[REG_MOTOR_MAX_REV] = (int16_t)-act_motor[ACT_MOTOR_DRIVE].max_speed_neg_mms;
+    }
+
+    if(reg_file[REG_SERVO_MIN_TICKS] > 0 && reg_file[REG_SERVO_MIN_TICKS] < reg_file[REG_SERVO_MAX_TICKS]){
+        act_servo[ACT_SERVO_STEER].min_pulse_ticks = (uint16_t)reg_file[REG_SERVO_MIN_TICKS];
+        act_servo[ACT_SERVO_STEER].max_pulse_ticks = (uint16_t)reg_file[REG_SERVO_MAX_TICKS];
+    }
+    else{
+        reg_file[REG_SERVO_MIN_TICKS] = (int16_t)act_servo[ACT_SERVO_STEER].min_pulse_ticks;
+        reg_file[REG_SERVO_MAX_TICKS] = (int16_t)act_servo[ACT_SERVO_STEER].max_pulse_ticks;
+    }
+}
+
+/**
+ * @brief  Interrompt la lecture de trajectoire : une consigne directe reprend la main.
+ */
+static void traj_abort(void){
+    if(traj_running()){
+        traj_command(TRAJ_CMD_STOP, 0);
+    }
+}
+
+/**
+ * @brief  Applique une consigne de propulsion de l'hôte (REG_MOTOR_CMD, index 0 de REG_ACT_CMD).
+ * @details Un moteur désarmé par le failsafe n'est réarmé que par une consigne nulle.
+ * @param  speed_mms Consigne de vitesse (mm/s).
+ */
+static void drive_command(int16_t speed_mms){
+    traj_abort();
+    if(!motor_armed && speed_mms == 0){
+        motor_armed = 1;
+    }
+    last_motor_cmd_mms = motor_armed ? speed_mms : 0;
+    motor_command(last_motor_cmd_mms, false);
+}
 
 /**
- * @brief  Récupère un temps système précis en microsecondes.
- * @details Utilise le Timer 3 (16 bits) combiné à un compteur d'overflow logiciel
- * pour générer un timestamp 32 bits continu.
- * @return Temps écoulé en microsecondes.
+ * @brief  Applique une consigne reçue par la fenêtre REG_ACT_CMD.
+ * @details L'index 0 de chaque type reprend la chaîne de REG_SERVO_CDEG / REG_MOTOR_CMD ;
+ * les actionneurs auxiliaires reçoivent la consigne directement (accès indexé), un ESC
+ * auxiliaire restant au neutre tant que le failsafe a désarmé la propulsion.
+ * @param  sel   Actionneur (ACT_SEL_*, borné par le hook d'écriture de REG_ACT_SEL).
+ * @param  value Consigne (servo : c°, ESC : mm/s).
  */
-static uint32_t GetMicrosTotal(void){
-    uint32_t m_overflow;
-    uint16_t m_counter;
+static void act_command(uint8_t sel, int16_t value){
+    const bool motor = (sel & ACT_SEL_MOTOR) != 0u;
 
-    do{
-        m_overflow = tim3_overflow_cnt;
-        m_counter = LL_TIM_GetCounter(TIM3);
+    if((sel & ACT_SEL_INDEX_MASK) == 0u){
+        if(motor){
+            drive_command(value);
+        }
+        else{
+            traj_abort();
+            kin_stop(&hKin);
+            servo_target(value);
+            actuators_wake();
+        }
+        return;
     }
-    while(m_overflow != tim3_overflow_cnt);
 
-    return (m_overflow << 16) + m_counter;
+#if APP_MOTOR_TICK_ISR
+    __disable_irq();
+#endif
+    actuators_set_aux(sel, (motor && !motor_armed) ? 0 : value);
+#if APP_MOTOR_TICK_ISR
+    __enable_irq();
+#endif
+    actuators_wake();
+}
+
+/**
+ * @brief  Ramène les ESC auxiliaires au neutre (failsafe).
+ */
+static void act_stop_aux(void){
+#if APP_MOTOR_TICK_ISR
+    __disable_irq();
+#endif
+    actuators_stop_aux();
+#if APP_MOTOR_TICK_ISR
+    __enable_irq();
+#endif
 }
 
 /**
  * @brief  Applique les commandes reçues via le port série.
- * @details Vérifie l'état du parseur (`parser_state`). Si une commande est prête,
- * met à jour le servo ou le moteur avec les valeurs "shadow".
- * Réinitialise le watchdog de sécurité (`last_cmd_time_ms`).
+ * @details Vide la file de commandes dans l'ordre de réception : toutes celles reçues
+ * depuis la dernière itération (y compris via une trame groupée) sont appliquées ici,
+ * avec la valeur portée par chaque entrée.
+ * Réinitialise le watchdog de sécurité (`last_cmd_time_ms`) et mesure la latence
+ * entre réception et application (sonde PROF_PROBE_CMD_QUEUE) ; les consignes directes
+ * d'actionneur sont suivies jusqu'à l'écriture des CCR (act_latency_mark()).
  */
 static void process_incoming_commands(void){
-    if(parser_state == PARSER_IDLE){
+    serial_cmd_t cmd;
+    bool actuate;
+
+    if(serial_cmd_pending() == 0){
         return;
     }
 
     last_cmd_time_ms = HAL_GetTick();
 
-    switch(parser_state){
-        case PARSER_SERVO_CMD:
-            servo_pwm_angle_degree(&hServo1, shadow_servo_cmd);
+    while(serial_cmd_pop(&cmd)){
+        actuate = false;
+        switch(cmd.type){
+            case PARSER_SERVO_CMD:
+                traj_abort();
+                kin_stop(&hKin);
+                servo_target((int32_t)(int8_t)cmd.value * 100);
+                actuators_wake();
+                actuate = true;
             break;
 
-        case PARSER_MOTOR_CMD:
-            motor_set_speed_mms(&hMotor1, shadow_motor_cmd);
+            case PARSER_SERVO_CDEG:
+                traj_abort();
+                kin_stop(&hKin);
+                servo_target(cmd.value);
+                actuators_wake();
+                actuate = true;
             break;
 
-        default:
+            case PARSER_IMU_FILT:
+                imu_filt_configure((uint8_t)cmd.value);
+            break;
+
+            case PARSER_VIB:
+                vib_reload();
+            break;
+
+            case PARSER_SERVO_SLEW:
+            case PARSER_RAMP:
+                ramps_reload();
+            break;
+
+            case PARSER_MOTOR_CMD:
+                drive_command(cmd.value);
+                actuate = true;
+            break;
+
+            case PARSER_KIN:
+                /* La courbure, écrite en dernier dans la trame groupée, applique la paire */
+                if(cmd.addr == REG_KIN_CURV){
+                    drive_command(reg_file[REG_KIN_SPEED]);
+#if APP_IMU_CHAIN
+                    __disable_irq();    // Boucle de lacet chaînée : consigne et braquage d'un bloc
+#endif
+                    servo_target(kin_command(&hKin, cmd.value));
+#if APP_IMU_CHAIN
+                    __enable_irq();
+#endif
+                    actuators_wake();
+                    actuate = true;
+                }
+            break;
+
+            case PARSER_ACT:
+                if(cmd.addr == REG_ACT_SEL){
+                    act_sel = (uint8_t)cmd.value;
+                }
+                else{
+                    act_command(act_sel, cmd.value);
+                    actuate = true;
+                }
+            break;
+
+            case PARSER_IMU_CFG:{
+                uint16_t v = (uint16_t)cmd.value;
+                bmi088_config_t cfg = {
+                    .accel_range = IMU_CFG_ACC_RANGE(v),
+                    .accel_odr   = IMU_CFG_ACC_ODR(v),
+                    .accel_bw    = IMU_CFG_ACC_BW(v),
+                    .gyro_range  = IMU_CFG_GYR_RANGE(v),
+                    .gyro_odr    = IMU_CFG_GYR_ODR(v)
+                };
+                BMI088_Profile_Apply(IMU_CFG_PROFILE(v), &cfg);
+                (void)BMI088_Configure(&cfg);
+                hist_reload();          // Seuil exprimé dans la nouvelle gamme
+                vib_reload();           // Amplitudes converties dans la nouvelle gamme
+            }
+            break;
+
+            case PARSER_SPEED_GAINS:
+                motor_gains_reload();
+            break;
+
+            case PARSER_IMU_CAL:
+                (void)BMI088_Calibrate((uint8_t)cmd.value);
+            break;
+
+            case PARSER_BMI_CMD:
+                if((uint16_t)cmd.value & BMI088_REGIO_FLAG){
+                    const int8_t rslt = BMI088_RegIO_Request((uint16_t)cmd.value);
+                    if(rslt != BMI08_OK){
+                        const bmi088_regio_t io = { .write = ((uint16_t)cmd.value & BMI088_REGIO_WRITE) ? 1u : 0u,
+                                                    .status = rslt };
+                        serial_send_bmireg(&io);
+                    }
+                }
+                else if(cmd.value == BMI088_ST_CMD_RUN){
+                    BMI088_SelfTest_Start();
+                }
+            break;
+
+            case PARSER_ATT_GAIN:
+#if APP_ATTITUDE
+                attitude_set_gain(&hAttitude, (uint16_t)cmd.value);
+#endif
+            break;
+
+            case PARSER_ESC_PROFILE:
+                motor_esc_profile_reload();
+            break;
+
+            case PARSER_MOTION_CFG:
+                idle_gate_reload();
             break;
-    }
 
-    parser_state = PARSER_IDLE;
+            case PARSER_PING:
+                serial_send_echo((uint16_t)cmd.value, cmd.t_us, GetMicrosTotal());
+            break;
+
+            case PARSER_CAPS:
+                serial_send_caps(APP_BENCH ? (uint16_t)(1u << TELEM_TYPE_BENCH) : 0u);
+            break;
+
+            case PARSER_SNAPSHOT:
+                snapshot_send((uint16_t)cmd.value);
+            break;
+
+            case PARSER_HIST:
+                if(cmd.addr == REG_HIST_CMD){
+                    imu_hist_command((uint8_t)cmd.value);
+                }
+                else if(cmd.addr == REG_HIST_CHUNK){
+                    const uint16_t arg = (uint16_t)cmd.value;
+                    if(arg & IMU_HIST_CHUNK_PACKED){
+                        (void)imu_hist_send_packed((uint16_t)(arg & ~IMU_HIST_CHUNK_PACKED));
+                    }
+                    else{
+                        (void)imu_hist_send_chunk(arg);
+                    }
+                }
+                else{
+                    hist_reload();
+                }
+            break;
+
+            case PARSER_ODOM:
+#if APP_ODOMETRY
+                odom_command(&hOdom, (uint8_t)cmd.value);
+#endif
+            break;
+
+            case PARSER_TRAJ:
+                kin_stop(&hKin);
+                /* Date 0 à la mise en file de la commande, pas à son traitement */
+                traj_command((uint8_t)cmd.value, GetMicros64() - (uint32_t)(GetMicrosTotal() - cmd.t_us));
+                actuators_wake();
+            break;
+
+            case PARSER_NV_CMD:
+                (void)serial_cmd_nv_exec((uint8_t)cmd.value, (last_motor_cmd_mms == 0 && !ramp_busy(&motor_ramp)) ? 1u : 0u);
+            break;
+
+            case PARSER_SPI_PRESC:
+                (void)SPI1_Set_Prescaler((uint32_t)cmd.value << SPI_CR1_BR_Pos);
+            break;
+
+            case PARSER_SPI_BENCH:{
+                /* Par tranches : une mesure longue ne doit pas déclencher le chien de garde */
+                uint16_t remaining = (uint16_t)cmd.value;
+                uint64_t total_ns = 0;
+                uint32_t done = 0;
+                uint32_t avg_ns = 0;
+                int8_t rslt;
+
+                do{
+                    uint16_t chunk = (remaining > SPI_BENCH_CHUNK) ? SPI_BENCH_CHUNK : remaining;
+                    rslt = BMI088_Benchmark_Read(chunk, &avg_ns);
+                    total_ns += (uint64_t)avg_ns * chunk;
+                    done += chunk;
+                    remaining = (uint16_t)(remaining - chunk);
+#if APP_WATCHDOG
+                    watchdog_feed();
+#endif
+                }while(rslt == BMI08_OK && remaining != 0);
+
+                avg_ns = (done != 0) ? (uint32_t)(total_ns / done) : 0u;
+                uint32_t avg_dus = (avg_ns + 50u) / 100u;
+
+                shadow_spi_bench_res = (rslt != BMI08_OK) ? -1 : (int16_t)((avg_dus > INT16_MAX) ? INT16_MAX : avg_dus);
+                (void)proto_send_data16(REG_SPI_BENCH, shadow_spi_bench_res);
+            }
+            break;
+
+            default:
+            break;
+        }
+
+        const uint32_t now_us = GetMicrosTotal();
+        cmd_latency_last_us = now_us - cmd.t_us;
+        if(cmd_latency_last_us > cmd_latency_max_us){
+            cmd_latency_max_us = cmd_latency_last_us;
+        }
+        prof_record(prof_probe(PROF_PROBE_CMD_QUEUE), cmd_latency_last_us);
+        if(actuate){
+            act_latency_mark(&cmd, now_us);
+        }
+    }
 }
 
 /**
- * @brief  Sécurité active (Dead Man's Switch).
- * @details Vérifie si le temps écoulé depuis la dernière commande valide dépasse
- * `FAILSAFE_TIMEOUT_MS`. Si oui, coupe le moteur.
+ * @brief  Sécurité active graduée (Dead Man's Switch).
+ * @details Selon le temps écoulé depuis la dernière commande valide :
+ * - au-delà de REG_FS_DECEL_MS : la consigne moteur décroît linéairement jusqu'à 0
+ *   à REG_FS_NEUTRAL_MS ;
+ * - au-delà de REG_FS_NEUTRAL_MS : moteurs au neutre (ESC auxiliaires compris) ;
+ * - au-delà de REG_FS_DISARM_MS : moteur désarmé, les consignes non nulles sont
+ *   ignorées jusqu'à réception d'une consigne nulle (même après reprise de la liaison).
+ * Pendant la lecture d'une trajectoire, le délai court à partir de sa fin.
  */
 static void check_failsafe_security(void){
-    if((HAL_GetTick() - last_cmd_time_ms) > FAILSAFE_TIMEOUT_MS){
-        motor_set_speed_mms(&hMotor1, 0);
+    if(traj_running()){
+        last_cmd_time_ms = HAL_GetTick();   // Trajectoire téléversée : la liaison n'a pas à suivre
+    }
+
+    const uint32_t elapsed    = HAL_GetTick() - last_cmd_time_ms;
+    const uint32_t decel_ms   = (uint16_t)reg_file[REG_FS_DECEL_MS];
+    const uint32_t neutral_ms = (uint16_t)reg_file[REG_FS_NEUTRAL_MS];
+    const uint32_t disarm_ms  = (uint16_t)reg_file[REG_FS_DISARM_MS];
+    const uint8_t  prev_stage = failsafe_stage;
+    const uint8_t  moving     = (last_motor_cmd_mms != 0) ? 1u : 0u;
+
+    if(elapsed > disarm_ms){
+        failsafe_stage = FAILSAFE_DISARMED;
+        motor_armed = 0;
+        last_motor_cmd_mms = 0;
+        act_stop_aux();
+        motor_command(0, true);
+        kin_stop(&hKin);
+    }
+    else if(elapsed > neutral_ms){
+        failsafe_stage = FAILSAFE_NEUTRAL;
+        act_stop_aux();
+        motor_command(0, true);
+        kin_stop(&hKin);
+    }
+    else if(elapsed > decel_ms){
+        failsafe_stage = FAILSAFE_DECEL;
+        motor_command((int16_t)(((int32_t)last_motor_cmd_mms * (int32_t)(neutral_ms - elapsed)) / (int32_t)(neutral_ms - decel_ms)), false);
+    }
+    else{
+        failsafe_stage = FAILSAFE_OK;
+    }
+
+    if(failsafe_stage != prev_stage){
+        DLOG2(DLOG_FAILSAFE, failsafe_stage, elapsed);
+        if(prev_stage == FAILSAFE_OK && moving){
+            imu_hist_trigger(IMU_HIST_TRIG_FAILSAFE);   // Perte de liaison en roulant
+        }
+    }
+}
+
+/**
+ * @brief  Étape courante du failsafe.
+ * @return Étape (failsafe_stage_t).
+ */
+uint8_t app_failsafe_stage(void){
+    return failsafe_stage;
+}
+
+/**
+ * @brief  Date une étape du démarrage à son premier passage.
+ * @param  stage Étape atteinte (boot_stage_t).
+ */
+static void boot_mark(boot_stage_t stage){
+    if(boot_reached & (1u << stage)){
+        return;
+    }
+
+    boot_stage_us[stage] = boot_base_us + (uint32_t)GetMicros64();
+    boot_reached |= (uint8_t)(1u << stage);
+    DLOG2(DLOG_BOOT_STAGE, stage, boot_stage_us[stage]);
+}
+
+/**
+ * @brief  Date d'une étape du démarrage.
+ * @param  stage Étape (boot_stage_t).
+ * @return Microsecondes depuis le reset, UINT32_MAX si l'étape n'est pas atteinte.
+ */
+uint32_t app_boot_stage_us(uint8_t stage){
+    if(stage >= BOOT_STAGE_COUNT || !(boot_reached & (1u << stage))){
+        return UINT32_MAX;
+    }
+
+    return boot_stage_us[stage];
+}
+
+/**
+ * @brief  Tâche périodique : Rafraîchissement du chien de garde.
+ * @details Exécutée par l'ordonnanceur : une boucle principale bloquée ou qui ne
+ * libère plus les tâches laisse expirer l'IWDG (WATCHDOG_TIMEOUT_MS) et provoque un reset.
+ * @param  now_us Timestamp actuel en microsecondes.
+ */
+static void task_watchdog(uint64_t now_us){
+    (void)now_us;
+#if APP_WATCHDOG
+    watchdog_feed();
+#endif
+    fault_log_heartbeat();
+}
+
+/**
+ * @brief  Tâche périodique : Tension batterie et compensation de la carte moteur.
+ * @details Publie la moyenne de l'anneau ADC (REG_BATT_MV) et, si REG_BATT_NOM_MV est non nul,
+ * applique V_nominale / V_batterie à l'écart au neutre des ESC. Le facteur n'est
+ * réappliqué qu'au-delà de BATT_COMP_HYST_Q12 : pas de consigne qui oscille avec le
+ * bruit de mesure ou les appels de courant.
+ * @param  now_us Timestamp actuel en microsecondes.
+ */
+static void task_battery(uint64_t now_us){
+    static uint16_t comp_applied = BATT_COMP_UNITY_Q12;
+
+    (void)now_us;
+    const uint16_t vbat_mv = batt_mv();
+
+    reg_file[REG_BATT_MV] = (vbat_mv > INT16_MAX) ? INT16_MAX : (int16_t)vbat_mv;
+
+    const uint16_t comp = batt_comp_q12(vbat_mv, (uint16_t)reg_file[REG_BATT_NOM_MV]);
+    const uint16_t diff = (comp > comp_applied) ? (uint16_t)(comp - comp_applied) : (uint16_t)(comp_applied - comp);
+
+    if(diff < BATT_COMP_HYST_Q12 && (comp != BATT_COMP_UNITY_Q12 || comp_applied == BATT_COMP_UNITY_Q12)){
+        return;
+    }
+    comp_applied = comp;
+
+#if APP_MOTOR_TICK_ISR
+    __disable_irq();
+#endif
+    for(uint8_t i = 0; i < ACT_MOTOR_COUNT; i++){
+        motor_set_supply_comp(&act_motor[i], comp);
+    }
+#if APP_MOTOR_TICK_ISR
+    __enable_irq();
+#endif
+    motor_wake();
+}
+
+#if APP_SOAK
+/**
+ * @brief  Tâche périodique : Bilan du mode endurance.
+ * @details La tâche de télémétrie s'exécute à chaque passage : son nombre d'exécutions
+ * donne la cadence de la boucle principale. Overruns et retards sont ceux de
+ * l'ordonnanceur (cumulés depuis le démarrage ou la dernière remise à zéro par
+ * REG_PROF_SEL) : l'hôte en déduit les tendances par différence entre deux bilans.
+ * @param  now_us Timestamp actuel en microsecondes.
+ */
+static void task_soak(uint64_t now_us){
+    static uint32_t runs_prev;
+    static uint64_t prev_us;
+
+    const uint32_t runs = sched_get_task(APP_TASK_TELEMETRY)->runs;
+    uint32_t overruns = 0;
+    uint32_t late_max_us = 0;
+
+    for(uint8_t i = 0; i < APP_TASK_COUNT; i++){
+        const sched_task_t *task = sched_get_task(i);
+        overruns += task->overruns;
+        if(task->late.max_us > late_max_us){
+            late_max_us = task->late.max_us;
+        }
+    }
+
+    if(prev_us != 0u && now_us > prev_us){
+        const uint32_t loop_hz = (uint32_t)(((uint64_t)(runs - runs_prev) * 1000000u) / (now_us - prev_us));
+        DLOG3(DLOG_SOAK, loop_hz, overruns, late_max_us);
+    }
+    runs_prev = runs;
+    prev_us = now_us;
+}
+#endif
+
+/**
+ * @brief  Tâche événementielle : Mise à jour du Moteur.
+ * @details Exécute les machines à états des ESC qui ont du travail (nouvelle consigne,
+ * échéance de frein ou de pause), applique les consignes PWM de tous les actionneurs en
+ * un passage par timer, puis se replanifie à la plus proche échéance. En marche stable, la tâche dort jusqu'au prochain
+ * réveil (actuators_wake()) : aucun calcul ni accès timer à 1 kHz. Pendant une rampe de
+ * braquage ou un profil de consigne, la tâche revient toutes les TASK_MOTOR_US ; pendant une trajectoire, elle
+ * est libérée à la date de chaque point.
+ * @param  now_us Timestamp actuel en microsecondes.
+ */
+#if !APP_MOTOR_TICK_ISR
+static void task_motor_update(uint64_t now_us){
+    const uint32_t now_ms = HAL_GetTick();
+    uint32_t deadline_ms;
+    uint64_t release_us;
+
+    act_cfg_apply();
+    traj_tick(now_us);
+    const bool ramping = ramps_tick();
+    const bool slewing = actuators_tick(now_ms) || ramping;
+    act_latency_record();
+    motor_status_publish();
+
+    if(actuators_next_deadline(&deadline_ms)){
+        int32_t wait_ms = (int32_t)(deadline_ms - now_ms);
+        release_us = now_us + (uint64_t)((wait_ms > 1 && !slewing) ? wait_ms : 1) * 1000u;
+    }
+    else{
+        release_us = slewing ? (now_us + TASK_MOTOR_US) : UINT64_MAX;
+    }
+
+    /* Point de trajectoire suivant : libération à sa date exacte */
+    const uint64_t traj_us = traj_next_us();
+    sched_set_release(APP_TASK_MOTOR, (traj_us < release_us) ? traj_us : release_us);
+}
+#endif
+
+/**
+ * @brief  Tick moteur en interruption SysTick (mode APP_MOTOR_TICK_ISR).
+ * @details Relève la dernière consigne déposée dans motor_mbox et le point de
+ * trajectoire dû, fait avancer les profils de consigne, puis exécute les machines à états
+ * qui ont du travail (consigne modifiée ou échéance atteinte) et applique les sorties.
+ * Sans effet en mode ordonnancé ou avant la fin d'app_config().
+ */
+void app_motor_tick_isr(void){
+#if APP_MOTOR_TICK_ISR
+    static uint16_t last_seq = 0;
+    static uint16_t last_fb_seq = 0;
+
+    if(!motor_tick_enabled){
+        return;
+    }
+
+    uint32_t prof_start = prof_begin();
+    act_cfg_apply();
+    uint32_t mbox = motor_mbox;
+    if((uint16_t)(mbox >> MOTOR_MBOX_SEQ_SHIFT) != last_seq){
+        last_seq = (uint16_t)(mbox >> MOTOR_MBOX_SEQ_SHIFT);
+        motor_target((int16_t)(uint16_t)mbox, (mbox & MOTOR_MBOX_DIRECT) != 0u);
+    }
+
+    mbox = speed_fb_mbox;
+    if((uint16_t)(mbox >> 16) != last_fb_seq){
+        last_fb_seq = (uint16_t)(mbox >> 16);
+        motor_speed_feedback(&act_motor[ACT_MOTOR_DRIVE], (int16_t)(uint16_t)mbox);
+    }
+
+    traj_tick(GetMicros64());
+    (void)ramps_tick();
+
+    (void)actuators_tick(HAL_GetTick());
+    act_latency_record();
+    motor_status_publish();
+    prof_end(PROF_PROBE_MOTOR_ISR, prof_start);
+#endif
+}
+
+#if APP_IMU_CHAIN
+/**
+ * @brief  Observateur de publication IMU (interruption DMA) : demande la boucle chaînée.
+ */
+static void imu_chain_pend(void){
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+#endif
+
+/**
+ * @brief  Boucle de lacet chaînée à l'acquisition IMU (PendSV, mode APP_IMU_CHAIN).
+ * @details Reprend le dernier échantillon publié, ferme la boucle de lacet sur la vitesse
+ * publiée et écrit aussitôt les CCR modifiés. Au niveau du tick moteur (irq_prio.h) : les
+ * deux ne s'interrompent pas. Sans effet en mode ordonnancé ou avant la fin d'app_config().
+ */
+void app_imu_chain_isr(void){
+#if APP_IMU_CHAIN
+    static uint32_t last_seq = 0;
+    bmi088_data_fx_t sample;
+    int32_t cdeg;
+
+    if(!motor_tick_enabled){
+        return;
+    }
+
+    uint32_t prof_start = prof_begin();
+    const uint32_t seq = BMI088_Get_Latest_Fx(&sample);
+    if(seq != last_seq){
+        last_seq = seq;
+        if(kin_update(&hKin, sample.gyro_urads[2], speed_pub_mms(&speed_pub), sample.timestamp_us, &cdeg)){
+            servo_target(cdeg);
+            actuators_apply();
+            prof_record(prof_probe(PROF_PROBE_IMU_E2E), (uint32_t)(GetMicros64() - sample.timestamp_us));
+        }
+    }
+    prof_end(PROF_PROBE_IMU_CHAIN, prof_start);
+#endif
+}
+
+/**
+ * @brief  Tâche périodique : Déclenchement d'une acquisition IMU par DMA.
+ * @details Cadencée à REG_IMU_RATE, indépendamment de la télémétrie. Surveille aussi
+ * le bus SPI et fait avancer le démarrage asynchrone ou la récupération du capteur
+ * (accès aux registres demandés par REG_BMI compris, résultats émis ici) :
+ * la tâche est alors relancée à l'échéance de l'étape suivante si elle précède la
+ * période. Le déclenchement est inutile en mode data-ready (acquisitions déclenchées
+ * par la ligne INT du capteur). Source synthétique du rejeu active : injecte
+ * l'échantillon suivant à la place de l'acquisition.
+ * @param  now_us Timestamp actuel en microsecondes.
+ */
+static void task_imu_trigger(uint64_t now_us){
+    const uint64_t bus_next_us = BMI088_Bus_Poll(now_us);
+    bmi088_regio_t io;
+
+    while(BMI088_RegIO_Pop(&io)){
+        serial_send_bmireg(&io);
+    }
+
+    if(bus_next_us != UINT64_MAX){
+        if(bus_next_us < now_us + sched_get_task(APP_TASK_IMU)->period_us){
+            sched_set_release(APP_TASK_IMU, bus_next_us);
+        }
+        return;
+    }
+
+    boot_mark(BOOT_STAGE_IMU);
+
+    const uint8_t imu_live = !replay_active() && !replay_synth_active()
+                          && (BMI088_SelfTest_Status() & 0xFFu) != BMI088_ST_RUNNING;
+    if(imu_health_check(now_us, imu_live ? sched_get_task(APP_TASK_IMU)->period_us : 0u) == IMU_HEALTH_ACT_RANGE){
+        hist_reload();          // Seuils exprimés dans la nouvelle gamme
+        vib_reload();
+    }
+
+    if(replay_synth_active()){
+        replay_synth_tick(now_us, sched_get_task(APP_TASK_IMU)->period_us);
+        return;
+    }
+    if(!BMI088_DataReady_Active()){
+        BMI088_Start_Read_DMA();
+    }
+}
+
+#if APP_ATTITUDE || APP_ODOMETRY || KIN_YAW_LOOP || APP_SPEED_FUSE
+/**
+ * @brief  Observateur de la file IMU : intègre chaque échantillon dans la vitesse
+ * fusionnée (publiée), l'estimateur d'attitude et l'odométrie, et ferme la boucle de
+ * lacet de la commande cinématique.
+ * @details Appelé au retrait de chaque échantillon, y compris ceux décimés ou émis
+ * au format compact : les estimations ne dépendent pas du format de télémétrie choisi.
+ * @param  sample Échantillon en virgule fixe.
+ */
+static void imu_on_sample(const bmi088_data_fx_t *sample){
+#if APP_SPEED_FUSE
+    speed_sample_t speed;
+    speed.speed_mms = speed_fuse_predict(&hSpeedFuse, sample->accel_mms2, sample->timestamp_us);
+    speed.t_us      = sample->timestamp_us;
+    speed.ticks     = speedometer_ticks(&hSpeedo);
+    speed.forward   = hSpeedEst.forward ? 1u : 0u;
+    speed_pub_write(&speed_pub, &speed);
+#elif APP_ODOMETRY || KIN_YAW_LOOP
+    speed_sample_t speed;
+    (void)speed_pub_read(&speed_pub, &speed);
+#endif
+#if APP_ATTITUDE
+    attitude_update(&hAttitude, sample->gyro_urads, sample->accel_mms2, sample->timestamp_us);
+#endif
+#if APP_ODOMETRY
+    odom_update(&hOdom, sample->gyro_urads[2], speedometer_ticks(&hSpeedo), speed.forward != 0u, sample->timestamp_us);
+#endif
+#if KIN_YAW_LOOP && !APP_IMU_CHAIN
+    int32_t cdeg;
+    if(kin_update(&hKin, sample->gyro_urads[2], speed.speed_mms, sample->timestamp_us, &cdeg)){
+        servo_target(cdeg);
+        actuators_wake();
+    }
+#endif
+}
+#endif
+
+#if IMU_HIST_ENABLE || VIB_ENABLE || IMU_HEALTH_ENABLE
+/**
+ * @brief  Observateur brut de la file IMU : historique, analyse vibratoire et santé du capteur.
+ * @param  raw          Échantillon brut.
+ * @param  timestamp_us Date de l'acquisition (µs).
+ */
+static void imu_on_raw(const bmi088_raw_t *raw, uint64_t timestamp_us){
+#if IMU_HIST_ENABLE
+    imu_hist_record(raw, timestamp_us);
+#endif
+#if VIB_ENABLE
+    vib_record(raw, timestamp_us);
+#endif
+    imu_health_record(raw);
+}
+#endif
+
+/**
+ * @brief  Relève les données d'état hors IMU des trames à contenu choisi.
+ * @param  status Données à remplir (attitude à zéro).
+ */
+static void telemetry_status_fill(telem_status_t *status){
+    motor_status_t motor;
+
+    motor_status_read(&motor);
+    status->speed_mms          = (int16_t)speed_pub_mms(&speed_pub);
+    status->motor_cmd_mms      = motor.cmd_mms;
+    status->motor_state        = motor.state;
+    status->servo_cmd          = (int8_t)reg_file[REG_SERVO_CMD];
+    status->cmd_latency_max_us = cmd_latency_max_us;
+    status->imu_dropped        = BMI088_Queue_Dropped();
+    status->imu_temp_cdeg      = BMI088_Temperature_cdeg();
+    memset(status->attitude_q14, 0, sizeof(status->attitude_q14));
+}
+
+/**
+ * @brief  Envoie les échantillons en file au format à contenu choisi (type 0x03).
+ * @param  fields    Champs demandés (REG_TELEM_FIELDS).
+ */
+static void telemetry_send_subscribed(uint8_t fields){
+    bmi088_data_fx_t imu_sample;
+    telem_status_t status;
+
+    telemetry_status_fill(&status);
+
+    while(BMI088_Queue_Pop_Fx(&imu_sample)){
+        if(!telem_rate_keep(imu_sample.timestamp_us) || !telem_adapt_keep()){
+            continue;
+        }
+#if APP_ATTITUDE
+        attitude_get_q14(&hAttitude, status.attitude_q14);     // Estimation à jour de cet échantillon
+#endif
+        serial_send_telemetry(fields, &imu_sample, &status);
+    }
+}
+
+/**
+ * @brief  Envoie les échantillons en file au format compact (types 0x04 / 0x05).
+ * @details Les échantillons sont accumulés dans un lot de N échantillons datés
+ * (REG_TELEM_BATCH), émis en une seule trame delta avec un seul en-tête et un seul
+ * CRC. Un lot incomplet part dès que son plus ancien échantillon a attendu la
+ * latence maximale ; avec une latence nulle, tout ce qui est disponible part
+ * immédiatement. Un lot d'un seul échantillon part en trame compacte.
+ */
+static void telemetry_send_compact(void){
+    const uint8_t  batch_size = TELEM_BATCH_SIZE(reg_file[REG_TELEM_BATCH]);
+    const uint32_t latency_us = TELEM_BATCH_LATENCY_MS(reg_file[REG_TELEM_BATCH]) * 1000u;
+    bmi088_config_t cfg;
+    const int16_t speed_mms = (int16_t)speed_pub_mms(&speed_pub);
+
+    BMI088_Get_Config(&cfg);
+    const uint8_t ranges = (uint8_t)(IMU_CFG_PACK(&cfg) & 0x1Fu);
+
+    for(;;){
+        while(telem_batch_count < batch_size &&
+              BMI088_Queue_Pop_Raw(&telem_batch[telem_batch_count].raw, &telem_batch[telem_batch_count].timestamp_us)){
+            if(telem_rate_keep(telem_batch[telem_batch_count].timestamp_us) && telem_adapt_keep()){
+                telem_batch_count++;    // Sinon l'emplacement est réutilisé par le suivant
+            }
+        }
+
+        if(telem_batch_count == 0){
+            return;
+        }
+
+        if(telem_batch_count < batch_size &&
+           (GetMicros64() - telem_batch[0].timestamp_us) < latency_us){
+            return;     // Lot incomplet, latence non atteinte : on attend la suite
+        }
+
+        if(telem_batch_count == 1u){
+            serial_send_compact_frame(&telem_batch[0], ranges, speed_mms);
+        }
+        else{
+            serial_send_delta_batch(telem_batch, telem_batch_count, ranges, speed_mms);
+        }
+        telem_batch_count = 0;
     }
 }
 
 /**
- * @brief  Tâche périodique : Mise à jour du Moteur.
- * @details Appelle la machine à états du moteur toutes les 1 ms.
+ * @brief  Tâche de fond : Envoi de la Télémétrie.
+ * @details Envoie une trame IMU+Vitesse pour chaque échantillon présent dans la
+ * file du driver : format compact si REG_TELEM_FORMAT le demande, sinon trame
+ * complète historique si REG_TELEM_FIELDS (flux rapide) vaut 0, ou trame à contenu choisi.
+ * Quel que soit le format, les échantillons sont décimés à REG_TELEM_RATE quand les
+ * acquisitions sont plus rapides (REG_IMU_RATE, data-ready), puis par la régulation
+ * de débit (REG_TELEM_ADAPT) quand le buffer TX sature ; le filtre anti-repliement
+ * (REG_IMU_FILT) a alors déjà lissé chaque échantillon retiré de la file.
  * @param  now_us Timestamp actuel en microsecondes.
  */
-static void task_motor_update(uint32_t now_us){
-    if((uint32_t)(now_us - last_motor_us) >= TASK_MOTOR_US){
-        last_motor_us = now_us;
-        motor_process_1ms(&hMotor1, HAL_GetTick());
+static void task_telemetry_update(uint64_t now_us){
+    const uint8_t fields = TELEM_FIELDS_FAST(reg_file[REG_TELEM_FIELDS]);
+
+    (void)now_us;
+    telem_adapt_update();
+
+    if(TELEM_FORMAT_MODE(reg_file[REG_TELEM_FORMAT]) == TELEM_FMT_COMPACT){
+        telemetry_send_compact();
+    }
+    else if(fields != 0){
+        telemetry_send_subscribed(fields);
+    }
+    else{
+#if TELEMETRY_FIXED_POINT
+        static bmi088_data_fx_t imu_sample;
+
+        while(BMI088_Queue_Pop_Fx(&imu_sample)){
+            if(telem_rate_keep(imu_sample.timestamp_us) && telem_adapt_keep()){
+                serial_send_data_frame_fx(&imu_sample);
+            }
+        }
+#else
+        static bmi088_data_t imu_sample;
+
+        while(BMI088_Queue_Pop(&imu_sample)){
+            if(telem_rate_keep(imu_sample.timestamp_us) && telem_adapt_keep()){
+                serial_send_data_frame(&imu_sample);
+            }
+        }
+#endif
+    }
+
+#if APP_PARK
+    if(park_wake_us != 0 && serial_telem_seq() != park_wake_seq){
+        DLOG3(DLOG_PARK_WAKE, park_cause, park_slept_ms, GetMicros64() - park_wake_us);
+        park_wake_us = 0;
+    }
+#endif
+
+    dlog_flush();
+
+    if(serial_telem_seq() != 0){
+        boot_mark(BOOT_STAGE_TELEMETRY);
+        fault_log_report_pending();
     }
 }
 
 /**
- * @brief  Tâche périodique : Envoi de la Télémétrie.
- * @details Déclenche l'envoi de la trame IMU+Vitesse toutes les 10 ms.
+ * @brief  Tâche périodique : flux d'état lent (type 0x0F).
+ * @details Les champs d'état (REG_TELEM_FIELDS bits 8-15) partent à leur propre cadence
+ * (REG_TELEM_FORMAT bits 8-15), indépendamment du flux IMU : les valeurs lentes ne
+ * grossissent plus chaque trame rapide. La période de la tâche suit la cadence ; coupé,
+ * le flux est réexaminé toutes les TASK_STATUS_OFF_US.
  * @param  now_us Timestamp actuel en microsecondes.
  */
-static void task_telemetry_update(uint32_t now_us){
-    if((uint32_t)(now_us - last_telemetry_us) >= TASK_TELEMETRY_US){
-        last_telemetry_us = now_us;
-        serial_send_data_frame();
+static void task_status(uint64_t now_us){
+    static uint8_t rate_hz = 0;
+    const uint8_t  rate    = TELEM_STATUS_RATE_HZ(reg_file[REG_TELEM_FORMAT]);
+    const uint8_t  fields  = TELEM_FIELDS_STATUS(reg_file[REG_TELEM_FIELDS]);
+    bmi088_data_fx_t imu;
+    telem_status_t status;
+
+    (void)now_us;
+    if(rate != rate_hz){
+        rate_hz = rate;
+        sched_set_period(APP_TASK_STATUS, (rate != 0u) ? (1000000u / rate) : TASK_STATUS_OFF_US);
+    }
+    if(rate == 0u || fields == 0u){
+        return;
+    }
+
+    if(BMI088_Get_Latest_Fx(&imu) == 0u){
+        memset(&imu, 0, sizeof(imu));
     }
+
+    telemetry_status_fill(&status);
+#if APP_ATTITUDE
+    attitude_get_q14(&hAttitude, status.attitude_q14);
+#endif
+    serial_send_status(fields, &imu, &status);
 }
 
 /**
  * @brief  Tâche périodique : Calcul de la vitesse.
- * @details Met à jour la variable globale de vitesse toutes les 100 ms.
+ * @details Toutes les TASK_SPEED_US : mesure tachymètre (vitesse enregistrée en
+ * rejeu, cf. replay.h), filtrage et sens (estimateur), recalage de la vitesse
+ * fusionnée (APP_SPEED_FUSE), publication (speed_pub.h : vitesse, date, cumul de
+ * fronts, sens) et retour vers la boucle de vitesse. La publication reprend aussi
+ * l'observateur IMU : même contexte (boucle principale), écrivain unique.
  * @param  now_us Timestamp actuel en microsecondes.
  */
-static void task_get_speed(uint32_t now_us){
-    if((uint32_t)(now_us - last_speed_us) >= TASK_SPEED_US){
-        last_speed_us = now_us;
-        speed_speedo_data = speedometer_solve_speed(&hSpeedo);
+static void task_get_speed(uint64_t now_us){
+    speed_sample_t s;
+    int32_t raw_mms;
+
+    s.ticks = speedometer_ticks(&hSpeedo);
+    if(replay_active()){
+        /* Vitesse enregistrée signée : module et sens rejoués tels quels */
+        const int32_t rec_mms = replay_speed_mms();
+        raw_mms = (rec_mms < 0) ? -rec_mms : rec_mms;
+        s.speed_mms = speed_est_update(&hSpeedEst, raw_mms, rec_mms >= 0);
+    }
+    else{
+        raw_mms = speedometer_solve_speed_mms(&hSpeedo);
+        s.speed_mms = speed_est_update(&hSpeedEst, raw_mms, act_motor[ACT_MOTOR_DRIVE].go_forward);
     }
+#if APP_SPEED_FUSE
+    s.speed_mms = speed_fuse_correct(&hSpeedFuse, hSpeedEst.forward ? raw_mms : -raw_mms);
+#endif
+    s.t_us = now_us;
+    s.forward = hSpeedEst.forward ? 1u : 0u;
+    speed_pub_write(&speed_pub, &s);
+
+    motor_feedback((s.speed_mms > INT16_MAX) ? INT16_MAX : (s.speed_mms < -INT16_MAX) ? -INT16_MAX : (int16_t)s.speed_mms);
 }
 
 /**
  * @brief  Initialisation générale de l'application.
  * @details Configure les Timers, active les interruptions nécessaires,
- * initialise les drivers (Série, BMI088, Servo, Moteur, Speedo) et cale les horloges.
+ * initialise les drivers (Servo, Moteur, Série, BMI088, Speedo) et cale les horloges.
+ * Les actionneurs passent au neutre en premier, puis la liaison série démarre ;
+ * l'IMU est initialisée en tâche de fond par l'ordonnanceur (BMI088_Init_Async),
+ * sans bloquer la boucle pendant ses délais de redémarrage et de configuration.
+ * Chaque étape est datée (app_boot_stage_us).
  */
 void app_config(void){
+	irq_prio_apply();
+	rtt_init();
+	trace_init();
+	dlog_init();
+	fault_log_init();
+
 	LL_TIM_EnableCounter(TIM3);
 	LL_TIM_EnableIT_UPDATE(TIM3);
-	HAL_TIM_Base_Start(&htim4);
+#if APP_SOAK
+	Timebase_Advance(((uint64_t)1 << 32) - SOAK_WRAP_LEAD_US);
+#endif
+	boot_base_us = mem_boot_us(MEM_BOOT_HAL) + HAL_GetTick() * 1000u - (uint32_t)GetMicros64();
+	prof_record(prof_probe(PROF_PROBE_STARTUP), mem_boot_us(MEM_BOOT_MAIN));
+	boot_mark(BOOT_STAGE_HAL);
+
+	actuators_limits_restore();
+	actuators_init();
+	boot_mark(BOOT_STAGE_ACTUATORS);
 
 	serial_init();
-	BMI088_Init(&hspi1);
-	servo_initialisation(&hServo1);
-	motor_init(&hMotor1);
-	motor_pwm_percent(&hMotor1, 50);
+	spi_link_init();
+	console_init();
+	boot_mark(BOOT_STAGE_SERIAL);
 
-	last_cmd_time_ms  = HAL_GetTick();
-	last_motor_us     = GetMicrosTotal();
-	last_telemetry_us = GetMicrosTotal();
-	last_speed_us     = GetMicrosTotal();
+	spi_bus_init(&hspi1);
+	BMI088_Init_Async(&hspi1);
+#if APP_IMU_DATA_READY
+	BMI088_DataReady_Init(BMI088_DRDY_ACCEL);
+#endif
 
+	batt_init();
 	speedometer_init(&hSpeedo, &htim4);
+	speed_est_init(&hSpeedEst);
+#if APP_SPEED_FUSE
+	speed_fuse_init(&hSpeedFuse);
+#endif
+#if APP_ATTITUDE
+	attitude_init(&hAttitude);
+#endif
+	kin_init(&hKin);
+#if APP_ODOMETRY
+	odom_init(&hOdom);
+#endif
+#if APP_ATTITUDE || APP_ODOMETRY || KIN_YAW_LOOP || APP_SPEED_FUSE
+	BMI088_Set_Sample_Hook(imu_on_sample);
+#endif
+#if IMU_HIST_ENABLE || VIB_ENABLE || IMU_HEALTH_ENABLE
+	BMI088_Set_Raw_Hook(imu_on_raw);
+#endif
+#if IMU_FILT_ENABLE
+	BMI088_Set_Filter_Hook(imu_filt_apply);
+#endif
+#if APP_IMU_CHAIN
+	BMI088_Set_Publish_Hook(imu_chain_pend);
+#endif
+	hist_reload();
+	vib_reload();
+	imu_health_init();
+
+	last_cmd_time_ms  = HAL_GetTick();
+	sched_init(app_tasks, APP_TASK_COUNT, GetMicros64());
+	boot_mark(BOOT_STAGE_SCHED);
+
+#if APP_MOTOR_TICK_ISR
+	motor_tick_enabled = 1;
+#endif
+#if APP_WATCHDOG
+	watchdog_start(WATCHDOG_TIMEOUT_MS);
+#endif
 }
 
+#if APP_PARK
 /**
- * @brief  Boucle principale de l'application (Super Loop).
+ * @brief  Met le véhicule garé en veille STOP1 (bloquant jusqu'au réveil).
+ * @details Conditions : REG_PARK_MS non nul, moteur désarmé par le failsafe depuis
+ * REG_PARK_MS, pas de trajectoire, liaison au repos (émission terminée, rien en
+ * réception), et REG_PARK_MS écoulées depuis le réveil précédent. Au réveil : capteurs
+ * et PWM rétablis, libérations des tâches recalées sans compter la veille en overrun.
+ * Le temps de réveil (sortie de STOP jusqu'à la première trame de télémétrie) est
+ * journalisé (DLOG_PARK_WAKE).
+ */
+static void app_park(void){
+    const uint32_t hold_ms   = (uint16_t)reg_file[REG_PARK_MS];
+    const uint32_t disarm_ms = (uint16_t)reg_file[REG_FS_DISARM_MS];
+    const uint32_t now_ms    = HAL_GetTick();
+
+    if(hold_ms == 0 || failsafe_stage != FAILSAFE_DISARMED || traj_running() || replay_active() ||
+       (now_ms - last_cmd_time_ms) < disarm_ms + hold_ms || (now_ms - park_ref_ms) < hold_ms ||
+       !serial_tx_idle() || serial_rx_frames_available() != 0 || serial_cmd_pending() != 0){
+        return;
+    }
+
+    park_ref_ms = now_ms;
+    if(BMI088_Low_Power(1) != BMI08_OK){
+        BMI088_Low_Power(0);
+        return;             // Nouvel essai dans REG_PARK_MS
+    }
+    actuators_outputs_off();
+
+    park_cause   = lp_stop(&park_slept_ms);
+    park_wake_us = GetMicros64();
+
+    BMI088_Low_Power(0);
+    actuators_outputs_restore();
+    sched_resume(park_wake_us);
+    park_wake_seq = serial_telem_seq();
+    park_ref_ms   = HAL_GetTick();
+}
+#endif
+
+#if !SCHED_RTOS
+/**
+ * @brief  Met le processeur en veille (WFI) jusqu'à la prochaine échéance.
+ * @details Ne dort que si aucune tâche de fond n'a de travail : octets RX, commandes
+ * en file ou échantillons IMU à émettre. Le test et le WFI se font interruptions
+ * masquées : une interruption survenue entre les deux réveille quand même le cœur
+ * (WFI sort sur interruption en attente) et son handler s'exécute au démasquage.
+ * Sources de réveil : compare TIM3 (échéance), SysTick (1 ms), DMA/IDLE UART,
+ * frontières de trames RX (RTO / détection de caractère), fin de DMA SPI et EXTI data-ready.
+ * Une trame partiellement reçue ne tient pas le cœur éveillé : sa frontière le réveillera.
+ */
+static void app_idle(void){
+    uint64_t deadline_us = sched_next_deadline();
+
+    __disable_irq();
+
+    if(serial_rx_frames_available() != 0 || spi_link_pending() != 0 || serial_cmd_pending() != 0 || BMI088_Queue_Pending() != 0 ||
+       !Timebase_Arm_Wakeup(deadline_us)){
+        __enable_irq();
+        return;
+    }
+
+    uint64_t start_us = GetMicros64();
+    __WFI();
+    __enable_irq();
+
+    Timebase_Disarm_Wakeup();
+    sched_account_idle((uint32_t)(GetMicros64() - start_us));
+}
+#endif
+
+/**
+ * @brief  Travail hors table : liaison, commandes, sécurité, cadences.
  * @details Exécute séquentiellement :
  * 1. La lecture des données série (Polling).
  * 2. Le traitement des commandes (si disponibles).
  * 3. La vérification de sécurité.
- * 4. L'ordonnancement des tâches périodiques basées sur `now_us`.
- * @note   Le compteur `now_us` boucle après environ 71 minutes.
+ * 4. La mise à jour des cadences des tâches IMU et télémétrie.
+ * @param  now_us Date courante (µs).
  */
-void app_loop(void){
-	uint32_t now_us = GetMicrosTotal(); //70 minutes max
-
+static void app_poll(uint64_t now_us){
+    uint32_t prof_start = prof_begin();
+    fault_log_loop();
     serial_cmd_reader();
+    spi_link_poll();
+    console_poll();
+    prof_end(PROF_PROBE_SERIAL_RX, prof_start);
 
+    prof_start = prof_begin();
     process_incoming_commands();
+    prof_end(PROF_PROBE_CMD, prof_start);
+    fw_update_poll();
+
     check_failsafe_security();
+    jitter_poll();
+
+    telem_rate_hz = idle_gate_rate_hz(now_us);
+    imu_rate_hz   = imu_gate_rate_hz();
+    sched_set_period(APP_TASK_IMU, 1000000u / imu_rate_hz);
+    imu_filt_set_output_us((1000000u / telem_rate_hz) * telem_decim);
+}
+
+/**
+ * @brief  Boucle principale de l'application (Super Loop).
+ * @details Exécute séquentiellement :
+ * 1. Le travail hors table (app_poll()).
+ * 2. L'ordonnancement des tâches de la table `app_tasks` (échéances absolues).
+ * 3. La mise en veille jusqu'à la prochaine échéance ou interruption.
+ * En build SCHED_RTOS, démarre le noyau au premier appel (sans retour) : app_poll()
+ * devient la tâche de plus basse priorité, chaque entrée de `app_tasks` une tâche noyau.
+ * @note   `now_us` est la base de temps 64 bits : pas de rebouclage en exploitation.
+ */
+void app_loop(void){
+#if SCHED_RTOS
+    sched_rtos_start(app_poll);
+#else
+	uint64_t now_us = GetMicros64();
+
+    app_poll(now_us);
+    sched_run(now_us);
+
+#if APP_BENCH
+    if(!bench_done && (BMI088_Ready() || HAL_GetTick() >= BENCH_START_TIMEOUT_MS)){
+        bench_done = 1;
+        bench_run(&act_motor[ACT_MOTOR_DRIVE], &hSpeedo);
+        bench_end_ms = HAL_GetTick();
+    }
+    else if(bench_done == 1 && (HAL_GetTick() - bench_end_ms) >= BENCH_BUDGET_DELAY_MS){
+        bench_done = 2;
+        (void)bench_budget_check();
+    }
+#endif
 
-    task_motor_update(now_us);
-    task_get_speed(now_us);
-    task_telemetry_update(now_us);
+#if APP_PARK
+    app_park();
+#endif
+    app_idle();
+#endif
 }
@@ -0,0 +1,162 @@
+/**
+ * @file    attitude.c
+ * @brief   Implémentation de l'estimateur d'attitude (filtre complémentaire de Mahony).
+ * @details Pour chaque échantillon : la gravité prédite v est extraite du quaternion,
+ * l'erreur e = a x v (a = accélération mesurée, en g) s'ajoute à la vitesse angulaire
+ * avec le gain Kp, puis le quaternion est intégré au premier ordre sur le demi-angle
+ * w.dt/2 et renormalisé. Toutes les grandeurs sont en Q30 (1.0 = 2^30) ; les produits
+ * passent par des intermédiaires 64 bits.
+ */
+
+#include "attitude.h"
+#include <stddef.h>
+
+/** @brief Gravité (mm/s²), arrondie au mm/s². */
+#define ATT_G_MMS2              9807
+/** @brief Conversion mm/s² -> g en Q30 (2^30 / ATT_G_MMS2). */
+#define ATT_ACC_TO_Q30          (ATT_ONE_Q30 / ATT_G_MMS2)
+/** @brief Carré de la norme minimale acceptée de l'accélération (mm/s²)². */
+#define ATT_ACC_N2_MIN          ((int64_t)(ATT_G_MMS2 * (100 - ATT_ACC_GATE_PCT) / 100) * (ATT_G_MMS2 * (100 - ATT_ACC_GATE_PCT) / 100))
+/** @brief Carré de la norme maximale acceptée de l'accélération (mm/s²)². */
+#define ATT_ACC_N2_MAX          ((int64_t)(ATT_G_MMS2 * (100 + ATT_ACC_GATE_PCT) / 100) * (ATT_G_MMS2 * (100 + ATT_ACC_GATE_PCT) / 100))
+/**
+ * @brief Demi-angle Q30 par µrad/s.µs, en Q32 : 2^29 / 10^12 x 2^32 = 2^61 / 10^12.
+ * @note  w.dt reste sous 2.4e12 (gyroscope + correction bornée, dt <= ATT_DT_MAX_US) :
+ * le produit par cette constante tient dans un int64.
+ */
+#define ATT_HALF_ANGLE_Q32      2305843LL
+
+/** @brief Produit de deux valeurs Q30. */
+static inline int32_t q30_mul(int32_t a, int32_t b){
+    return (int32_t)(((int64_t)a * b) >> 30);
+}
+
+/**
+ * @brief  Initialise l'estimateur (attitude identité, gain par défaut).
+ * @param  att Pointeur vers l'estimateur.
+ */
+void attitude_init(Attitude_Estimator_t *att){
+    att->q[0] = ATT_ONE_Q30;
+    att->q[1] = 0;
+    att->q[2] = 0;
+    att->q[3] = 0;
+    att->kp_milli = ATT_KP_MILLI_DEFAULT;
+    att->primed = false;
+    att->last_us = 0;
+    att->run_us = 0;
+    att->accel_rejected = 0;
+}
+
+/**
+ * @brief  Règle le gain proportionnel de correction.
+ * @param  att      Pointeur vers l'estimateur.
+ * @param  kp_milli Gain (1/s x 1000), borné à ATT_KP_MILLI_MAX.
+ */
+void attitude_set_gain(Attitude_Estimator_t *att, uint16_t kp_milli){
+    att->kp_milli = (kp_milli > ATT_KP_MILLI_MAX) ? (uint16_t)ATT_KP_MILLI_MAX : kp_milli;
+}
+
+/**
+ * @brief  Intègre un échantillon IMU.
+ * @details Le premier échantillon, ou un échantillon séparé du précédent de plus de
+ * ATT_DT_MAX_US (acquisition suspendue, récupération du bus), ne fait que dater :
+ * l'attitude est conservée et l'intégration repart au suivant. Pendant ATT_START_US
+ * de données, le gain ATT_KP_START_MILLI aligne rapidement l'attitude sur la gravité.
+ * @param  att          Pointeur vers l'estimateur.
+ * @param  gyro_urads   Vitesse angulaire [X, Y, Z] (µrad/s).
+ * @param  accel_mms2   Accélération [X, Y, Z] (mm/s²).
+ * @param  timestamp_us Date d'acquisition de l'échantillon (µs).
+ */
+void attitude_update(Attitude_Estimator_t *att, const int32_t gyro_urads[3], const int32_t accel_mms2[3], uint64_t timestamp_us){
+    if(att == NULL || gyro_urads == NULL || accel_mms2 == NULL){
+        return;
+    }
+
+    int32_t *q = att->q;
+    int64_t w[3];
+
+    const uint64_t dt_us = timestamp_us - att->last_us;
+    const bool     valid = att->primed && timestamp_us > att->last_us && dt_us <= ATT_DT_MAX_US;
+
+    att->last_us = timestamp_us;
+    att->primed = true;
+    if(!valid){
+        return;
+    }
+
+    w[0] = gyro_urads[0];
+    w[1] = gyro_urads[1];
+    w[2] = gyro_urads[2];
+
+    /* 1. Correction par la gravité, seulement si la norme mesurée est proche de 1 g */
+    const int64_t n2 = (int64_t)accel_mms2[0] * accel_mms2[0] +
+                       (int64_t)accel_mms2[1] * accel_mms2[1] +
+                       (int64_t)accel_mms2[2] * accel_mms2[2];
+
+    if(n2 >= ATT_ACC_N2_MIN && n2 <= ATT_ACC_N2_MAX){
+        const int32_t ax = accel_mms2[0] * ATT_ACC_TO_Q30;
+        const int32_t ay = accel_mms2[1] * ATT_ACC_TO_Q30;
+        const int32_t az = accel_mms2[2] * ATT_ACC_TO_Q30;
+
+        /* Gravité prédite dans le repère capteur (troisième ligne de la matrice de rotation) */
+        const int32_t vx = (q30_mul(q[1], q[3]) - q30_mul(q[0], q[2])) * 2;
+        const int32_t vy = (q30_mul(q[0], q[1]) + q30_mul(q[2], q[3])) * 2;
+        const int32_t vz = q30_mul(q[0], q[0]) - q30_mul(q[1], q[1]) - q30_mul(q[2], q[2]) + q30_mul(q[3], q[3]);
+
+        /* e = a x v (Q30, |e| <= 2.4 : conservé sur 64 bits) */
+        const int64_t ex = ((int64_t)ay * vz - (int64_t)az * vy) >> 30;
+        const int64_t ey = ((int64_t)az * vx - (int64_t)ax * vz) >> 30;
+        const int64_t ez = ((int64_t)ax * vy - (int64_t)ay * vx) >> 30;
+
+        const int64_t kp_u = (int64_t)((att->run_us < ATT_START_US) ? ATT_KP_START_MILLI : att->kp_milli) * 1000;
+
+        w[0] += (ex * kp_u) >> 30;
+        w[1] += (ey * kp_u) >> 30;
+        w[2] += (ez * kp_u) >> 30;
+    }
+    else{
+        att->accel_rejected++;
+    }
+
+    /* 2. Demi-angle de rotation sur dt (Q30) */
+    const int32_t hx = (int32_t)((w[0] * (int64_t)dt_us * ATT_HALF_ANGLE_Q32) >> 32);
+    const int32_t hy = (int32_t)((w[1] * (int64_t)dt_us * ATT_HALF_ANGLE_Q32) >> 32);
+    const int32_t hz = (int32_t)((w[2] * (int64_t)dt_us * ATT_HALF_ANGLE_Q32) >> 32);
+
+    /* 3. Intégration q += q x (0, h) */
+    const int32_t q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+
+    q[0] = q0 - q30_mul(q1, hx) - q30_mul(q2, hy) - q30_mul(q3, hz);
+    q[1] = q1 + q30_mul(q0, hx) + q30_mul(q2, hz) - q30_mul(q3, hy);
+    q[2] = q2 + q30_mul(q0, hy) - q30_mul(q1, hz) + q30_mul(q3, hx);
+    q[3] = q3 + q30_mul(q0, hz) + q30_mul(q1, hy) - q30_mul(q2, hx);
+
+    /* 4. Renormalisation au premier ordre : q *= (3 - |q|²) / 2 */
+    const int64_t qn2 = ((int64_t)q[0] * q[0] + (int64_t)q[1] * q[1] +
+                         (int64_t)q[2] * q[2] + (int64_t)q[3] * q[3]) >> 30;
+    const int32_t k = (int32_t)((3 * (int64_t)ATT_ONE_Q30 - qn2) >> 1);
+
+    q[0] = q30_mul(q[0], k);
+    q[1] = q30_mul(q[1], k);
+    q[2] = q30_mul(q[2], k);
+    q[3] = q30_mul(q[3], k);
+
+    if(att->run_us < ATT_START_US){
+        att->run_us += (uint32_t)dt_us;
+    }
+}
+
+/**
+ * @brief  Quaternion courant au format de télémétrie.
+ * @param  att Pointeur vers l'estimateur.
+ * @param  q14 Quaternion (w, x, y, z) de sortie, Q14 (16384 = 1.0).
+ */
+void attitude_get_q14(const Attitude_Estimator_t *att, int16_t q14[4]){
+    for(uint8_t i = 0; i < 4u; i++){
+        int32_t v = att->q[i] >> 16;
+
+        if(v > INT16_MAX) v = INT16_MAX;
+        if(v < INT16_MIN) v = INT16_MIN;
+        q14[i] = (int16_t)v;
+    }
+}
@@ -0,0 +1,81 @@
+/**
+ * @file    battery.c
+ * @brief   Implémentation de la mesure batterie (cf. battery.h).
+ * @details Accès direct aux registres ADC1, DMA1 et DMAMUX (module HAL ADC non généré
+ * par CubeMX). Canal DMA1_Channel7 (DMAMUX1_Channel6), libre : canaux 1-2 pris par
+ * l'USART2, 3-4 par le SPI1, 5-6 par la liaison SPI esclave (spi_link.c). La broche du
+ * pont reste en mode analogique, état de reset des broches non configurées par CubeMX.
+ */
+
+#include "main.h"
+#include "battery.h"
+#include "timebase.h"
+
+#if BATT_ENABLE
+
+_Static_assert(BATT_ADC_CHANNEL < 13u, "BATT_ADC_CHANNEL must be converted before VREFINT (channel 13)");
+_Static_assert((BATT_AVG_LEN & (BATT_AVG_LEN - 1u)) == 0u, "BATT_AVG_LEN must be a power of 2");
+
+/** @brief Valeur brute de VREFINT mesurée en usine (12 bits, VDDA = 3,0 V). */
+#define BATT_VREFINT_CAL        (*(const uint16_t *)0x1FFF75AAu)
+#define BATT_VREFINT_CAL_MV     3000u
+
+/** @brief Requête DMAMUX de l'ADC1. */
+#define BATT_DMAMUX_REQ_ADC1    5u
+
+/** @brief Anneau DMA : paires (batterie, VREFINT), ordre croissant des voies. */
+static volatile uint16_t batt_ring[BATT_AVG_LEN * 2u];
+
+void batt_init(void){
+    RCC->APBENR2 |= RCC_APBENR2_ADCEN;
+    RCC->AHBENR  |= RCC_AHBENR_DMA1EN;
+
+    /* Horloge PCLK/4, suréchantillonnage ×256 décalé de 4 bits : résultats 16 bits */
+    ADC1->CFGR2 = ADC_CFGR2_CKMODE_1 | ADC_CFGR2_OVSE | ADC_CFGR2_OVSR | ADC_CFGR2_OVSS_2;
+
+    ADC1->CR = ADC_CR_ADVREGEN;
+    Delay_us(20u);
+    ADC1->CR |= ADC_CR_ADCAL;
+    while(ADC1->CR & ADC_CR_ADCAL){}
+
+    ADC1_COMMON->CCR |= ADC_CCR_VREFEN;
+    ADC1->CFGR1 = ADC_CFGR1_CONT | ADC_CFGR1_DMAEN | ADC_CFGR1_DMACFG;
+    ADC1->SMPR  = ADC_SMPR_SMP1;                    // 160,5 cycles (VREFINT : >= 4 µs)
+
+    ADC1->ISR     = ADC_ISR_CCRDY;
+    ADC1->CHSELR  = (1u << BATT_ADC_CHANNEL) | ADC_CHSELR_CHSEL13;
+    while(!(ADC1->ISR & ADC_ISR_CCRDY)){}
+
+    ADC1->ISR = ADC_ISR_ADRDY;
+    ADC1->CR |= ADC_CR_ADEN;
+    while(!(ADC1->ISR & ADC_ISR_ADRDY)){}
+
+    DMA1_Channel7->CCR    = 0;
+    DMAMUX1_Channel6->CCR = BATT_DMAMUX_REQ_ADC1;
+    DMA1_Channel7->CPAR  = (uint32_t)&ADC1->DR;
+    DMA1_Channel7->CMAR  = (uint32_t)batt_ring;
+    DMA1_Channel7->CNDTR = BATT_AVG_LEN * 2u;
+    DMA1_Channel7->CCR   = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0 | DMA_CCR_EN;
+
+    ADC1->CR |= ADC_CR_ADSTART;
+}
+
+uint16_t batt_mv(void){
+    uint32_t sum_bat = 0, sum_ref = 0;
+
+    /* Les paires non encore écrites valent 0 dans les deux voies : le rapport reste juste */
+    for(uint32_t i = 0; i < BATT_AVG_LEN; i++){
+        sum_bat += batt_ring[2u * i];
+        sum_ref += batt_ring[2u * i + 1u];
+    }
+    if(sum_ref == 0u){
+        return 0u;
+    }
+
+    const uint64_t num = (uint64_t)sum_bat * BATT_VREFINT_CAL * BATT_VREFINT_CAL_MV * BATT_DIV_X1000;
+    const uint64_t mv  = num / ((uint64_t)sum_ref * 4095u * 1000u);
+
+    return (mv > UINT16_MAX) ? UINT16_MAX : (uint16_t)mv;
+}
+
+#endif /* BATT_ENABLE */
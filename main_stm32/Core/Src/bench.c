@@ -0,0 +1,491 @@
+/**
+ * @file    bench.c
+ * @brief   Implémentation du banc de mesure en cycles.
+ * @details Chaque routine est appelée BENCH_CALLS fois (moins pour les routines
+ * longues), chaque appel étant encadré par deux lectures du compteur de cycles.
+ * Les résultats sont regroupés puis émis en fin de suite, ring TX vidé, pour que
+ * les mesures d'émission série ne soient pas faussées par leurs propres trames.
+ */
+
+#include "main.h"
+#include "bench.h"
+#include "driver_ins.h"
+#include "serial.h"
+#include "watchdog.h"
+#include "proto_def.h"
+#include "mem_map.h"
+#include "scheduler.h"
+#include "profiler.h"
+#include <string.h>
+
+/** @brief Nombre d'appels par mesure (routines courtes). */
+#define BENCH_CALLS             256u
+/** @brief Nombre d'appels pour les routines à accès bus ou émission série. */
+#define BENCH_CALLS_SLOW        16u
+/** @brief Longueur du calcul de CRC mesuré (trame de télémétrie courante). */
+#define BENCH_CRC_LEN           36u
+/** @brief Nombre d'états de la machine à états moteur. */
+#define BENCH_MOTOR_STATES      ((uint8_t)MOTOR_STATE_NEUTRAL_TO_REVERSE_GAP + 1u)
+/** @brief Délai maximal de vidange du ring TX (ms). */
+#define BENCH_TX_DRAIN_MS       200u
+/** @brief Nombre de résultats de la suite (une entrée par routine et par variante). */
+#define BENCH_SUITE_RESULTS     (4u + BENCH_MOTOR_STATES + 2u + sizeof(bench_write_sizes) / sizeof(bench_write_sizes[0]) + \
+                                 sizeof(bench_image_regions) / sizeof(bench_image_regions[0]))
+/** @brief Nombre de résultats du contrôle des budgets (une entrée par budget, plus le créneau). */
+#define BENCH_BUDGET_RESULTS    (sizeof(bench_budgets) / sizeof(bench_budgets[0]) + 1u)
+/** @brief Capacité de la table de résultats, partagée par la suite et le contrôle des budgets. */
+#define BENCH_RESULTS           ((BENCH_SUITE_RESULTS > BENCH_BUDGET_RESULTS) ? BENCH_SUITE_RESULTS : BENCH_BUDGET_RESULTS)
+
+/** @brief Tailles mesurées pour serial_write_all_nb() (octets). */
+static const uint16_t bench_write_sizes[] = {8u, 39u, 128u, 512u};
+/** @brief Régions rapportées par BENCH_IMAGE (effet des options d'édition de liens, DBG_NO_STDIO). */
+static const uint8_t bench_image_regions[] = {
+    MEM_REGION_FLASH_IMAGE, MEM_REGION_DATA, MEM_REGION_BSS, MEM_REGION_HEAP_RESERVED
+};
+
+/**
+ * @brief Budget d'exécution d'une tâche ou d'une interruption.
+ */
+typedef struct {
+    const char *task;       ///< Nom de la tâche (sched_task_t::name), NULL pour une sonde du profileur.
+    uint8_t  probe;         ///< Sonde hors ordonnanceur (prof_probe_id_t), si task est NULL.
+    uint8_t  isr;           ///< 1 : interruption (préempte tout, s'ajoute au créneau), 0 : boucle principale.
+    uint16_t budget_us;     ///< Pire cas admis (µs).
+} bench_budget_t;
+
+/**
+ * @brief Budgets déclarés, à tenir pour chaque build (ARG des entrées BENCH_BUDGET).
+ * @details Interruptions : budgets de la carte des priorités (irq_prio.h). Tâches et
+ * travail hors table : part du créneau BENCH_SLOT_US qu'une exécution peut occuper sans
+ * retarder le tick moteur d'une période. L'ordre est celui de BUDGET_NAMES côté hôte.
+ */
+static const bench_budget_t bench_budgets[] = {
+    { "motor",     0,                       0, 200u },
+    { "imu",       0,                       0, 100u },
+    { "speed",     0,                       0, 150u },
+    { "telemetry", 0,                       0, 400u },
+    { "watchdog",  0,                       0,  20u },
+    { "battery",   0,                       0, 100u },
+    { "status",    0,                       0, 300u },
+    { "soak",      0,                       0, 100u },
+    { NULL,        PROF_PROBE_SERIAL_RX,    0, 200u },
+    { NULL,        PROF_PROBE_CMD,          0, 300u },
+    { NULL,        PROF_PROBE_MOTOR_ISR,    1,   5u },
+    { NULL,        PROF_PROBE_IMU_SPI_ISR,  1,  20u },
+    { NULL,        PROF_PROBE_IMU_DRDY_ISR, 1,  20u },
+    { NULL,        PROF_PROBE_IMU_CHAIN,    1,  20u },
+};
+
+/**
+ * @brief Trame de résultat (type 0x07).
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  head1;         ///< Octet de synchronisation 1 (0xAA).
+    uint8_t  head2;         ///< Octet de synchronisation 2 (0x55).
+    uint8_t  type;          ///< Type de packet (0x07 pour Banc de mesure).
+    uint8_t  len;           ///< Longueur du payload (17 octets).
+    uint16_t arg;           ///< Variante mesurée (longueur, état, taille).
+    uint8_t  id;            ///< Routine mesurée (bench_id_t).
+    uint16_t calls;         ///< Nombre d'appels mesurés (0 : mesure impossible).
+    uint32_t min;           ///< Durée minimale (cycles).
+    uint32_t avg;           ///< Durée moyenne (cycles).
+    uint32_t max;           ///< Durée maximale (cycles).
+    uint8_t  crc;           ///< Checksum CRC-8 pour validation de l'intégrité.
+} bench_frame_t;
+
+/**
+ * @brief Cumul des mesures d'une routine.
+ */
+typedef struct {
+    uint16_t arg;           ///< Variante mesurée.
+    uint8_t  id;            ///< Routine mesurée (bench_id_t).
+    uint16_t calls;         ///< Nombre de mesures.
+    uint32_t min;           ///< Durée minimale (cycles).
+    uint32_t max;           ///< Durée maximale (cycles).
+    uint64_t sum;           ///< Somme des durées (cycles).
+} bench_acc_t;
+
+/** @brief Résultats de la suite, émis en fin d'exécution. */
+static bench_acc_t bench_results[BENCH_RESULTS];
+/** @brief Nombre de résultats enregistrés. */
+static uint8_t bench_count = 0;
+/** @brief Surcoût d'une paire de lectures du compteur (cycles), déduit de chaque mesure. */
+static uint32_t bench_overhead = 0;
+/** @brief Puits des résultats de calcul, pour que l'appel mesuré ne soit pas éliminé. */
+static volatile uint32_t bench_sink;
+
+/**
+ * @brief  Compteur de cycles HCLK (rebouclage après ~67 s à 64 MHz).
+ * @details Tick HAL (ms) x période SysTick + position du décompteur. Un rebouclage
+ * du décompteur dont l'interruption n'a pas encore été servie est compté d'après
+ * le drapeau PENDSTSET.
+ * @return Nombre de cycles.
+ */
+static uint32_t bench_cycles(void){
+    uint32_t ms;
+    uint32_t val;
+    uint32_t pend;
+
+    do{
+        ms   = uwTick;
+        val  = SysTick->VAL;
+        pend = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+    }while(ms != uwTick);
+
+    const uint32_t load = SysTick->LOAD;
+    if(pend != 0u && val > (load >> 1)){
+        ms++;
+    }
+
+    return ms * (load + 1u) + (load - val);
+}
+
+/**
+ * @brief  Ouvre un cumul de mesures.
+ * @param  id  Routine mesurée.
+ * @param  arg Variante mesurée.
+ * @return Cumul à alimenter par bench_add(), NULL si la table est pleine.
+ */
+static bench_acc_t *bench_open(bench_id_t id, uint16_t arg){
+    if(bench_count >= BENCH_RESULTS){
+        return NULL;
+    }
+
+    bench_acc_t *a = &bench_results[bench_count++];
+    a->id    = (uint8_t)id;
+    a->arg   = arg;
+    a->calls = 0;
+    a->min   = UINT32_MAX;
+    a->max   = 0;
+    a->sum   = 0;
+    watchdog_feed();
+    return a;
+}
+
+/**
+ * @brief  Ajoute une mesure, surcoût du compteur déduit.
+ * @param  a  Cumul (NULL accepté : mesure ignorée).
+ * @param  t0 Compteur avant l'appel.
+ * @param  t1 Compteur après l'appel.
+ */
+static void bench_add(bench_acc_t *a, uint32_t t0, uint32_t t1){
+    if(a == NULL){
+        return;
+    }
+
+    uint32_t dt = t1 - t0;
+    dt = (dt > bench_overhead) ? dt - bench_overhead : 0u;
+
+    if(dt < a->min) a->min = dt;
+    if(dt > a->max) a->max = dt;
+    a->sum += dt;
+    a->calls++;
+}
+
+/**
+ * @brief  Attend la fin des émissions en cours (ou BENCH_TX_DRAIN_MS).
+ */
+static void bench_tx_drain(void){
+    const uint32_t t0 = HAL_GetTick();
+
+    while(!serial_tx_idle() && (HAL_GetTick() - t0) < BENCH_TX_DRAIN_MS){
+        watchdog_feed();
+    }
+}
+
+/** @brief Calibre le surcoût d'une paire de lectures du compteur (minimum de la paire vide). */
+static void bench_calibrate(void){
+    uint32_t best = UINT32_MAX;
+
+    for(uint16_t i = 0; i < BENCH_CALLS; i++){
+        const uint32_t t0 = bench_cycles();
+        const uint32_t dt = bench_cycles() - t0;
+        if(dt < best) best = dt;
+    }
+    bench_overhead = best;
+}
+
+/** @brief CRC-8 sur une trame de BENCH_CRC_LEN octets. */
+static void bench_crc(void){
+    uint8_t buf[BENCH_CRC_LEN];
+    bench_acc_t *a = bench_open(BENCH_CRC8, BENCH_CRC_LEN);
+
+    for(uint8_t i = 0; i < sizeof(buf); i++){
+        buf[i] = (uint8_t)(i * 37u + 11u);
+    }
+
+    for(uint16_t i = 0; i < BENCH_CALLS; i++){
+        const uint32_t t0 = bench_cycles();
+        bench_sink = serial_crc8_atm(buf, sizeof(buf));
+        bench_add(a, t0, bench_cycles());
+    }
+}
+
+/** @brief Lecture IMU bloquante complète, acquisition data-ready suspendue. */
+static void bench_imu(void){
+    bmi088_data_t data;
+    bench_acc_t *a = bench_open(BENCH_IMU_READ_ALL, 0);
+
+    if(BMI088_Bus_Suspend()){
+        for(uint16_t i = 0; i < BENCH_CALLS_SLOW * 4u; i++){
+            const uint32_t t0 = bench_cycles();
+            const int8_t rslt = BMI088_Read_All(&data);
+            const uint32_t t1 = bench_cycles();
+            if(rslt != BMI08_OK){
+                break;
+            }
+            bench_add(a, t0, t1);
+        }
+    }
+    BMI088_Bus_Resume();
+}
+
+/** @brief Conversions d'unités accéléromètre + gyroscope, flottantes puis virgule fixe. */
+static void bench_conversions(void){
+    struct bmi08_sensor_data acc = { .x = 1234, .y = -2345, .z = 16000 };
+    struct bmi08_sensor_data gyr = { .x = -321, .y = 4567, .z = 89 };
+    float    out_f[3];
+    int32_t  out_fx[3];
+
+    bench_acc_t *a = bench_open(BENCH_CONV_FLOAT, 0);
+    for(uint16_t i = 0; i < BENCH_CALLS; i++){
+        const uint32_t t0 = bench_cycles();
+        BMI088_Convert_Accel(&acc, out_f);
+        BMI088_Convert_Gyro(&gyr, out_f);
+        bench_add(a, t0, bench_cycles());
+    }
+
+    a = bench_open(BENCH_CONV_FX, 0);
+    for(uint16_t i = 0; i < BENCH_CALLS; i++){
+        const uint32_t t0 = bench_cycles();
+        BMI088_Convert_Accel_Fx(&acc, out_fx);
+        BMI088_Convert_Gyro_Fx(&gyr, out_fx);
+        bench_add(a, t0, bench_cycles());
+    }
+    bench_sink = (uint32_t)out_fx[0];
+}
+
+/**
+ * @brief  Tick de la machine à états moteur depuis chaque état.
+ * @details L'échéance des états temporisés est repoussée : le tick mesuré est celui
+ * d'un état établi, la recopie du handle se fait hors mesure.
+ * @param  motor Moteur de référence.
+ */
+static void bench_motor(const Motor_Handle_t *motor){
+    Motor_Handle_t m;
+
+    for(uint8_t s = 0; s < BENCH_MOTOR_STATES; s++){
+        bench_acc_t *a = bench_open(BENCH_MOTOR_TICK, s);
+
+        for(uint16_t i = 0; i < BENCH_CALLS; i++){
+            const uint32_t now_ms = HAL_GetTick();
+
+            m = *motor;
+            m.state = (MotorState_t)s;
+            m.ctx.deadline_ms = now_ms + 1000u;
+
+            const uint32_t t0 = bench_cycles();
+            motor_process_1ms(&m, now_ms);
+            bench_add(a, t0, bench_cycles());
+        }
+    }
+}
+
+/**
+ * @brief  Calcul de vitesse du tachymètre, flottant puis entier.
+ * @param  speedo Tachymètre de référence.
+ */
+static void bench_speedo(const Speedometer_Handle_t *speedo){
+    Speedometer_Handle_t sp;
+
+    bench_acc_t *a = bench_open(BENCH_SPEEDO_SOLVE, 0);
+    for(uint16_t i = 0; i < BENCH_CALLS; i++){
+        sp = *speedo;
+        const uint32_t t0 = bench_cycles();
+        const float v = speedometer_solve_speed(&sp);
+        bench_add(a, t0, bench_cycles());
+        bench_sink = (uint32_t)(int32_t)v;
+    }
+
+    a = bench_open(BENCH_SPEEDO_SOLVE, 1);
+    for(uint16_t i = 0; i < BENCH_CALLS; i++){
+        sp = *speedo;
+        const uint32_t t0 = bench_cycles();
+        bench_sink = (uint32_t)speedometer_solve_speed_mms(&sp);
+        bench_add(a, t0, bench_cycles());
+    }
+}
+
+/**
+ * @brief  Dépôt d'un bloc dans le ring TX vide (copie et lancement du DMA).
+ * @note   Octets 0xFF : ni synchronisation ni entête historique, sautés par le décodeur de l'hôte.
+ */
+static void bench_serial_write(void){
+    static uint8_t buf[512];
+
+    memset(buf, 0xFF, sizeof(buf));
+
+    for(uint8_t k = 0; k < sizeof(bench_write_sizes) / sizeof(bench_write_sizes[0]); k++){
+        bench_acc_t *a = bench_open(BENCH_SERIAL_WRITE, bench_write_sizes[k]);
+
+        for(uint16_t i = 0; i < BENCH_CALLS_SLOW; i++){
+            bench_tx_drain();
+            const uint32_t t0 = bench_cycles();
+            const int rc = serial_write_all_nb(buf, bench_write_sizes[k]);
+            const uint32_t t1 = bench_cycles();
+            if(rc >= 0){
+                bench_add(a, t0, t1);
+            }
+        }
+    }
+    bench_tx_drain();
+}
+
+/** @brief Bilan de l'image : une entrée par région, taille en octets dans MIN / AVG / MAX. */
+static void bench_image(void){
+    for(uint8_t k = 0; k < sizeof(bench_image_regions) / sizeof(bench_image_regions[0]); k++){
+        bench_acc_t *a = bench_open(BENCH_IMAGE, bench_image_regions[k]);
+        if(a == NULL){
+            return;
+        }
+
+        const uint32_t size = mem_region_size((mem_region_t)bench_image_regions[k]);
+        a->calls = 1;
+        a->min   = size;
+        a->max   = size;
+        a->sum   = size;
+    }
+}
+
+/**
+ * @brief  Relève le pire cas d'une source de la table des budgets.
+ * @param  b   Budget.
+ * @param  out Statistiques de sortie.
+ * @return 1 si la source existe dans ce build et a été mesurée, 0 sinon.
+ */
+static uint8_t bench_budget_stat(const bench_budget_t *b, prof_stat_t *out){
+    if(b->task == NULL){
+        const prof_stat_t *s = prof_probe(b->probe);
+        if(s == NULL){
+            return 0;
+        }
+        prof_snapshot(s, out);
+        return (out->count != 0u) ? 1u : 0u;
+    }
+
+    for(uint8_t i = 0; i < sched_task_count(); i++){
+        const sched_task_t *t = sched_get_task(i);
+        if(strcmp(t->name, b->task) == 0){
+            prof_snapshot(&t->exec, out);
+            return (out->count != 0u) ? 1u : 0u;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief  Enregistre une entrée BENCH_BUDGET (marge signée dans AVG).
+ * @param  arg       Entrée de la table, ou BENCH_BUDGET_SLOT.
+ * @param  measured  1 si la source a été mesurée.
+ * @param  budget_us Budget (µs).
+ * @param  worst_us  Pire cas mesuré (µs).
+ * @return 1 si le budget est dépassé.
+ */
+static uint8_t bench_budget_add(uint8_t arg, uint8_t measured, uint32_t budget_us, uint32_t worst_us){
+    bench_acc_t *a = bench_open(BENCH_BUDGET, arg);
+    if(a == NULL){
+        return 0;
+    }
+
+    const int32_t margin = (int32_t)budget_us - (int32_t)worst_us;
+    a->calls = measured;
+    a->min   = budget_us;
+    a->max   = worst_us;
+    a->sum   = (uint32_t)margin;
+    return (measured && margin < 0) ? 1u : 0u;
+}
+
+/** @brief Émet les résultats, une trame type 0x07 par entrée. */
+static void bench_emit(void){
+    bench_frame_t f;
+
+    for(uint8_t i = 0; i < bench_count; i++){
+        const bench_acc_t *a = &bench_results[i];
+
+        f.head1 = 0xAA;
+        f.head2 = 0x55;
+        f.type  = TELEM_TYPE_BENCH;
+        /* payload: arg(2) + id(1) + calls(2) + min(4) + avg(4) + max(4) = 17 */
+        f.len   = 17;
+        f.arg   = a->arg;
+        f.id    = a->id;
+        f.calls = a->calls;
+        f.min   = (a->calls != 0u) ? a->min : 0u;
+        f.avg   = (a->calls != 0u) ? (uint32_t)(a->sum / a->calls) : 0u;
+        f.max   = a->max;
+        f.crc   = serial_crc8_atm((const uint8_t *)&f, sizeof(f) - 1u);
+
+        (void)serial_write_all_nb((const uint8_t *)&f, sizeof(f));
+    }
+}
+
+/**
+ * @brief  Exécute la suite et émet un résultat par routine (et par variante).
+ * @param  motor  Moteur de référence (recopié).
+ * @param  speedo Tachymètre de référence (recopié).
+ */
+void bench_run(const Motor_Handle_t *motor, const Speedometer_Handle_t *speedo){
+    bench_count = 0;
+
+    bench_calibrate();
+    bench_crc();
+    bench_imu();
+    bench_conversions();
+    bench_motor(motor);
+    bench_speedo(speedo);
+    bench_serial_write();
+    bench_image();
+
+    bench_emit();
+
+    /* Budgets : fenêtre de mesure limitée au régime établi, hors démarrage et hors suite */
+    sched_reset_stats();
+    for(uint8_t k = 0; k < sizeof(bench_budgets) / sizeof(bench_budgets[0]); k++){
+        if(bench_budgets[k].task == NULL){
+            prof_reset(prof_probe(bench_budgets[k].probe));
+        }
+    }
+}
+
+/**
+ * @brief  Contrôle des budgets d'exécution (cf. bench.h).
+ * @details Le créneau additionne les pires cas de toutes les interruptions (chacune
+ * peut tomber dans la même période) et celui du plus long travail de boucle principale
+ * (non préemptif : un seul à la fois retarde le tick moteur).
+ * @return Nombre de budgets dépassés.
+ */
+uint8_t bench_budget_check(void){
+    uint32_t isr_us = 0;
+    uint32_t loop_us = 0;
+    uint8_t fails = 0;
+
+    bench_count = 0;
+    for(uint8_t k = 0; k < sizeof(bench_budgets) / sizeof(bench_budgets[0]); k++){
+        const bench_budget_t *b = &bench_budgets[k];
+        prof_stat_t s;
+        const uint8_t measured = bench_budget_stat(b, &s);
+        const uint32_t worst_us = measured ? s.max_us : 0u;
+
+        fails += bench_budget_add(k, measured, b->budget_us, worst_us);
+        if(b->isr){
+            isr_us += worst_us;
+        }
+        else if(worst_us > loop_us){
+            loop_us = worst_us;
+        }
+    }
+    fails += bench_budget_add(BENCH_BUDGET_SLOT, 1u, BENCH_SLOT_US, isr_us + loop_us);
+
+    bench_emit();
+    return fails;
+}
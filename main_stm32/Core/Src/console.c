@@ -0,0 +1,328 @@
+/**
+ * @file    console.c
+ * @brief   Implémentation de la console texte sur USART1 (cf. console.h).
+ * @details Accès direct aux registres USART1, DMA2 et DMAMUX (périphériques non générés
+ * par CubeMX). Canal DMA2_Channel1 (DMAMUX1_Channel7), libre : les sept canaux du DMA1
+ * sont pris par l'USART2, le SPI1, la liaison SPI esclave (spi_link.c) et l'ADC
+ * (battery.c). Aucune interruption : la fin d'un transfert se lit sur CNDTR.
+ */
+
+#include "main.h"
+#include "console.h"
+
+#if CONSOLE_ENABLE
+
+#include "serial.h"
+#include "serial_cmd.h"
+#include "dbgout.h"
+#include "mem_map.h"
+#include <string.h>
+
+#if (CONSOLE_TX_RING_SIZE & (CONSOLE_TX_RING_SIZE - 1u))
+#error "CONSOLE_TX_RING_SIZE must be a power of two"
+#endif
+
+/** @brief Masque d'index du ring d'émission. */
+#define CON_TX_MASK     (CONSOLE_TX_RING_SIZE - 1u)
+
+/** @brief Ring d'émission, lu par le DMA. */
+static uint8_t con_tx_ring[CONSOLE_TX_RING_SIZE] MEM_DMA_BSS;
+/** @brief Index d'écriture (producteurs, interruptions masquées). */
+static volatile uint32_t con_tx_head = 0;
+/** @brief Index de lecture : début du transfert en cours (console_poll() seule). */
+static volatile uint32_t con_tx_tail = 0;
+/** @brief Longueur du transfert DMA en cours (0 : canal libre). */
+static uint32_t con_tx_inflight = 0;
+/** @brief Octets refusés, ring plein. */
+static uint32_t con_tx_lost = 0;
+
+/** @brief Ligne de commande en cours de saisie. */
+static char con_line[CONSOLE_LINE_MAX + 1u];
+/** @brief Longueur de la ligne en cours. */
+static uint8_t con_line_len = 0;
+
+/**
+ * @brief  Configure une broche en fonction alternée.
+ * @param  port Port GPIO.
+ * @param  pin  Broche.
+ * @param  af   Fonction alternée.
+ * @param  pull Tirage (GPIO_NOPULL, GPIO_PULLUP).
+ */
+static void console_pin(GPIO_TypeDef *port, uint32_t pin, uint8_t af, uint32_t pull){
+    GPIO_InitTypeDef init = {0};
+
+    init.Pin = pin;
+    init.Mode = GPIO_MODE_AF_PP;
+    init.Pull = pull;
+    init.Speed = GPIO_SPEED_FREQ_LOW;
+    init.Alternate = af;
+    HAL_GPIO_Init(port, &init);
+}
+
+void console_init(void){
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+    RCC->APBENR2 |= RCC_APBENR2_USART1EN;           // Horloge noyau par défaut : PCLK
+    RCC->AHBENR  |= RCC_AHBENR_DMA2EN;
+
+    console_pin(CONSOLE_TX_PORT, CONSOLE_TX_PIN, CONSOLE_TX_AF, GPIO_NOPULL);
+    console_pin(CONSOLE_RX_PORT, CONSOLE_RX_PIN, CONSOLE_RX_AF, GPIO_PULLUP);   // Ligne au repos sans adaptateur
+
+    USART1->CR1 = 0;
+    USART1->BRR = (HAL_RCC_GetPCLK1Freq() + CONSOLE_BAUD / 2u) / CONSOLE_BAUD;
+    USART1->CR3 = USART_CR3_DMAT;
+    USART1->CR1 = USART_CR1_FIFOEN | USART_CR1_TE | USART_CR1_RE | USART_CR1_UE;
+
+    DMA2_Channel1->CCR    = 0;
+    DMAMUX1_Channel7->CCR = DMA_REQUEST_USART1_TX;
+    DMA2_Channel1->CPAR   = (uint32_t)&USART1->TDR;
+}
+
+uint32_t console_write(const void *data, uint32_t len){
+    const uint8_t *src = (const uint8_t *)data;
+    const uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+
+    const uint32_t head = con_tx_head;
+    const uint32_t space = (con_tx_tail - head - 1u) & CON_TX_MASK;
+    if(len > space){
+        con_tx_lost += len - space;
+        len = space;
+    }
+    uint32_t first = CONSOLE_TX_RING_SIZE - head;
+    if(first > len){
+        first = len;
+    }
+    memcpy(&con_tx_ring[head], src, first);
+    memcpy(con_tx_ring, src + first, len - first);
+    __DMB();
+    con_tx_head = (head + len) & CON_TX_MASK;
+
+    __set_PRIMASK(primask);
+    return len;
+}
+
+uint32_t console_tx_free(void){
+    return (con_tx_tail - con_tx_head - 1u) & CON_TX_MASK;
+}
+
+uint32_t console_tx_dropped(void){
+    return con_tx_lost;
+}
+
+/**
+ * @brief  Libère le transfert DMA terminé et lance le bloc contigu suivant.
+ */
+static void console_tx_service(void){
+    if(con_tx_inflight != 0u){
+        if(DMA2_Channel1->CNDTR != 0u){
+            return;
+        }
+        DMA2_Channel1->CCR = 0;
+        con_tx_tail = (con_tx_tail + con_tx_inflight) & CON_TX_MASK;
+        con_tx_inflight = 0;
+    }
+
+    const uint32_t head = con_tx_head;
+    const uint32_t tail = con_tx_tail;
+    if(head == tail){
+        return;
+    }
+    __DMB();
+    con_tx_inflight = (head > tail) ? (head - tail) : (CONSOLE_TX_RING_SIZE - tail);
+    DMA2_Channel1->CMAR  = (uint32_t)&con_tx_ring[tail];
+    DMA2_Channel1->CNDTR = con_tx_inflight;
+    DMA2_Channel1->CCR   = DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_EN;
+}
+
+/** @brief Émet une chaîne terminée par un zéro. */
+static void con_puts(const char *s){
+    (void)console_write(s, (uint32_t)strlen(s));
+}
+
+/**
+ * @brief  Saute les espaces.
+ * @param  p Position dans la ligne.
+ * @return Premier caractère non blanc.
+ */
+static const char *con_skip(const char *p){
+    while(*p == ' '){
+        p++;
+    }
+    return p;
+}
+
+/**
+ * @brief  Lit un entier décimal ou hexadécimal (0x), éventuellement négatif.
+ * @param  p Position dans la ligne (avancée après le nombre).
+ * @param  v Sortie : valeur.
+ * @return 1 si un nombre a été lu, 0 sinon.
+ */
+static uint8_t con_parse_num(const char **p, int32_t *v){
+    const char *s = con_skip(*p);
+    const uint8_t neg = (*s == '-') ? 1u : 0u;
+    uint32_t base = 10u;
+    uint32_t acc = 0;
+    uint8_t digits = 0;
+
+    s += neg;
+    if(s[0] == '0' && (s[1] == 'x' || s[1] == 'X')){
+        base = 16u;
+        s += 2;
+    }
+    for(;; s++){
+        uint32_t d;
+        if(*s >= '0' && *s <= '9')                  d = (uint32_t)(*s - '0');
+        else if(base == 16u && *s >= 'a' && *s <= 'f') d = (uint32_t)(*s - 'a' + 10);
+        else if(base == 16u && *s >= 'A' && *s <= 'F') d = (uint32_t)(*s - 'A' + 10);
+        else break;
+        acc = acc * base + d;
+        digits++;
+    }
+    if(digits == 0u || (*s != ' ' && *s != '\0')){
+        return 0;
+    }
+    *v = neg ? -(int32_t)acc : (int32_t)acc;
+    *p = s;
+    return 1;
+}
+
+/**
+ * @brief  Commande `r <reg> [n]` : une ligne par registre, valeur signée et hexadécimale.
+ * @param  args Arguments.
+ * @return 1 si la commande est valide.
+ */
+static uint8_t con_cmd_read(const char *args){
+    int32_t addr;
+    int32_t count = 1;
+    int16_t vals[CONSOLE_READ_MAX];
+    char buf[32];
+
+    if(!con_parse_num(&args, &addr) || addr < 0 || addr > (int32_t)PROTO_HDR_ADDR_MASK){
+        return 0;
+    }
+    if(*con_skip(args) != '\0' && (!con_parse_num(&args, &count) || count < 1 || count > (int32_t)CONSOLE_READ_MAX)){
+        return 0;
+    }
+    serial_cmd_reg_read((uint8_t)addr, (uint8_t)count, vals);
+
+    for(int32_t i = 0; i < count; i++){
+        uint8_t n = 0;
+        buf[n++] = '0';
+        buf[n++] = 'x';
+        n += dbg_fmt_hex(&buf[n], (uint32_t)((addr + i) & (int32_t)PROTO_HDR_ADDR_MASK), 2u);
+        buf[n++] = ' ';
+        buf[n++] = '=';
+        buf[n++] = ' ';
+        n += dbg_fmt_i32(&buf[n], vals[i]);
+        buf[n++] = ' ';
+        buf[n++] = '(';
+        buf[n++] = '0';
+        buf[n++] = 'x';
+        n += dbg_fmt_hex(&buf[n], (uint16_t)vals[i], 4u);
+        buf[n++] = ')';
+        buf[n++] = '\r';
+        buf[n++] = '\n';
+        (void)console_write(buf, n);
+    }
+    return 1;
+}
+
+/**
+ * @brief  Commande `w <reg> <valeur>`.
+ * @param  args Arguments.
+ * @return 1 si la commande est valide.
+ */
+static uint8_t con_cmd_write(const char *args){
+    int32_t addr;
+    int32_t value;
+
+    if(!con_parse_num(&args, &addr) || addr < 0 || addr > (int32_t)PROTO_HDR_ADDR_MASK ||
+       !con_parse_num(&args, &value) || value < INT16_MIN || value > (int32_t)UINT16_MAX ||
+       *con_skip(args) != '\0'){
+        return 0;
+    }
+    con_puts(serial_cmd_reg_write((uint8_t)addr, (int16_t)(uint16_t)value) == 0 ? "ok\r\n" : "busy\r\n");
+    return 1;
+}
+
+/**
+ * @brief  Exécute la ligne saisie.
+ */
+static void con_exec(void){
+    const char *p = con_skip(con_line);
+    uint8_t ok = 0;
+
+    if(*p == '\0'){
+        return;
+    }
+    switch(*p++){
+        case 'r': ok = con_cmd_read(p); break;
+        case 'w': ok = con_cmd_write(p); break;
+        case 'h':
+        case '?':
+            con_puts("r <reg> [n] : lecture\r\nw <reg> <valeur> : ecriture\r\n");
+            ok = 1;
+        break;
+        default: break;
+    }
+    if(!ok){
+        con_puts("? (h : aide)\r\n");
+    }
+}
+
+/**
+ * @brief  Traite un caractère reçu : édition de la ligne avec écho, exécution sur CR/LF.
+ * @param  c Caractère.
+ */
+static void con_rx_char(char c){
+    if(c == '\r' || c == '\n'){
+        if(con_line_len != 0u){
+            con_puts("\r\n");
+            con_line[con_line_len] = '\0';
+            con_exec();
+            con_line_len = 0;
+            con_puts("> ");
+        }
+    }
+    else if(c == '\b' || c == 0x7F){
+        if(con_line_len != 0u){
+            con_line_len--;
+            con_puts("\b \b");
+        }
+    }
+    else if(c >= ' ' && c <= '~' && con_line_len < CONSOLE_LINE_MAX){
+        con_line[con_line_len++] = c;
+        (void)console_write(&c, 1u);
+    }
+}
+
+void console_poll(void){
+    const uint32_t isr = USART1->ISR;
+
+    if(isr & (USART_ISR_ORE | USART_ISR_FE | USART_ISR_NE | USART_ISR_PE)){
+        USART1->ICR = USART_ICR_ORECF | USART_ICR_FECF | USART_ICR_NECF | USART_ICR_PECF;
+    }
+    while(USART1->ISR & USART_ISR_RXNE_RXFNE){
+        con_rx_char((char)USART1->RDR);
+    }
+    console_tx_service();
+}
+
+/**
+ * @brief  Sortie standard de newlib redirigée vers la console.
+ * @details Remplace celles de serial.c (USART2) et de rtt.c (voie terminal RTT). La
+ * longueur entière est rendue même tronquée : newlib ne réessaie pas en boucle.
+ */
+int _write(int file, char *ptr, int len){
+    (void)file;
+
+    if(len > 0){
+        (void)console_write(ptr, (uint32_t)len);
+    }
+    return len;
+}
+
+#endif /* CONSOLE_ENABLE */
@@ -0,0 +1,83 @@
+/**
+ * @file    dbgout.c
+ * @brief   Implémentation de la sortie de debug minimale (cf. dbgout.h).
+ * @details Divisions par 10 seulement : le M0+ n'a pas de diviseur matériel, mais
+ * l'appel à __aeabi_uidiv reste bien plus léger que le moteur de formatage newlib.
+ */
+
+#include "main.h"
+#include "dbgout.h"
+#include "rtt.h"
+#include "console.h"
+#include "serial.h"
+#include <string.h>
+
+uint8_t dbg_fmt_u32(char *buf, uint32_t v){
+    char tmp[DBG_U32_DIGITS];
+    uint8_t n = 0;
+
+    do{
+        tmp[n++] = (char)('0' + (v % 10u));
+        v /= 10u;
+    }while(v != 0u);
+
+    for(uint8_t i = 0; i < n; i++){
+        buf[i] = tmp[n - 1u - i];
+    }
+    return n;
+}
+
+uint8_t dbg_fmt_i32(char *buf, int32_t v){
+    if(v < 0){
+        buf[0] = '-';
+        return (uint8_t)(1u + dbg_fmt_u32(&buf[1], 0u - (uint32_t)v));
+    }
+    return dbg_fmt_u32(buf, (uint32_t)v);
+}
+
+uint8_t dbg_fmt_hex(char *buf, uint32_t v, uint8_t digits){
+    static const char hex[] = "0123456789ABCDEF";
+
+    if(digits == 0u) digits = 1u;
+    if(digits > 8u)  digits = 8u;
+
+    for(uint8_t i = 0; i < digits; i++){
+        buf[digits - 1u - i] = hex[v & 0xFu];
+        v >>= 4;
+    }
+    return digits;
+}
+
+/**
+ * @brief  Émet des caractères sur la sortie de debug.
+ * @param  s   Caractères.
+ * @param  len Nombre de caractères.
+ */
+static void dbg_out(const char *s, uint32_t len){
+#if CONSOLE_ENABLE
+    (void)console_write(s, len);
+#elif RTT_ENABLE
+    (void)rtt_write(RTT_CH_TERMINAL, s, len);
+#else
+    (void)serial_write_all_nb((const uint8_t *)s, (uint16_t)len);
+#endif
+}
+
+void dbg_puts(const char *s){
+    dbg_out(s, (uint32_t)strlen(s));
+}
+
+void dbg_put_u32(uint32_t v){
+    char buf[DBG_U32_DIGITS];
+    dbg_out(buf, dbg_fmt_u32(buf, v));
+}
+
+void dbg_put_i32(int32_t v){
+    char buf[DBG_U32_DIGITS];
+    dbg_out(buf, dbg_fmt_i32(buf, v));
+}
+
+void dbg_put_hex(uint32_t v, uint8_t digits){
+    char buf[8];
+    dbg_out(buf, dbg_fmt_hex(buf, v, digits));
+}
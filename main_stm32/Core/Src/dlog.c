@@ -0,0 +1,195 @@
+/**
+ * @file    dlog.c
+ * @brief   Implémentation du journal binaire différé.
+ * @details Ring d'enregistrements de taille fixe, multi-producteurs (boucle principale
+ * et interruptions) : la réservation et la recopie se font sous section critique
+ * courte, PRIMASK restauré (appel possible interruptions déjà masquées). Un seul
+ * consommateur, dlog_flush(), en boucle principale.
+ */
+
+#include "main.h"
+#include "dlog.h"
+#include "serial.h"
+#include "rtt.h"
+#include "console.h"
+#include "dbgout.h"
+#include "timebase.h"
+#include "mem_map.h"
+#include <string.h>
+
+#if DLOG_ENABLE
+
+#if (DLOG_RING_SIZE & (DLOG_RING_SIZE - 1u))
+#error "DLOG_RING_SIZE must be a power of two"
+#endif
+
+/** @brief Longueur d'une trame (entête 4 + SEQ/T_US/ID/N 8 + arguments + CRC). */
+#define DLOG_FRAME_LEN(n)   (4u + 8u + 4u * (n) + 1u)
+
+/**
+ * @brief Enregistrement du ring.
+ */
+typedef struct {
+    uint32_t t_us;                  ///< Date du point de journal (GetMicrosTotal).
+    uint16_t seq;                   ///< Numéro d'enregistrement.
+    uint8_t  id;                    ///< Identifiant (dlog_id_t).
+    uint8_t  n;                     ///< Nombre d'arguments utiles.
+    int32_t  args[DLOG_ARGS_MAX];   ///< Arguments.
+} dlog_record_t;
+
+/** @brief Marque de validité du ring conservé (« DLOG »). */
+#define DLOG_MAGIC          0x474F4C44u
+
+/** @brief Ring des enregistrements en attente d'émission (conservé au reset à chaud). */
+static dlog_record_t dlog_ring[DLOG_RING_SIZE] MEM_NOINIT;
+/** @brief Index d'écriture (producteurs, sous section critique). */
+static volatile uint32_t dlog_head MEM_NOINIT;
+/** @brief Index de lecture (dlog_flush() seule). */
+static volatile uint32_t dlog_tail MEM_NOINIT;
+/** @brief Numéro du prochain enregistrement (perdus compris). */
+static uint16_t dlog_seq MEM_NOINIT;
+/** @brief DLOG_MAGIC si le ring et ses index sont cohérents. */
+static uint32_t dlog_magic MEM_NOINIT;
+/** @brief Enregistrements perdus, ring plein. */
+static uint32_t dlog_lost = 0;
+
+/**
+ * @brief  Reprend le ring conservé au reset à chaud, ou le vide.
+ * @details Contenu aléatoire à la mise sous tension : marque absente, ou index
+ * incohérents. Un enregistrement conservé est borné (nombre d'arguments) avant émission.
+ */
+void dlog_init(void){
+    if(dlog_magic != DLOG_MAGIC || (uint32_t)(dlog_head - dlog_tail) > DLOG_RING_SIZE){
+        dlog_head = 0;
+        dlog_tail = 0;
+        dlog_seq = 0;
+        dlog_magic = DLOG_MAGIC;
+        return;
+    }
+    for(uint32_t i = dlog_tail; i != dlog_head; i++){
+        dlog_record_t *rec = &dlog_ring[i & (DLOG_RING_SIZE - 1u)];
+        if(rec->n > DLOG_ARGS_MAX){
+            rec->n = DLOG_ARGS_MAX;
+        }
+    }
+}
+
+/**
+ * @brief  Dépose un enregistrement dans le ring.
+ * @param  id Identifiant (dlog_id_t).
+ * @param  n  Nombre d'arguments utiles (borné à DLOG_ARGS_MAX).
+ * @param  a0 Premier argument.
+ * @param  a1 Deuxième argument.
+ * @param  a2 Troisième argument.
+ */
+void dlog_write(uint8_t id, uint8_t n, int32_t a0, int32_t a1, int32_t a2){
+    const uint32_t t_us = GetMicrosTotal();
+    const uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+
+    const uint16_t seq = dlog_seq++;
+    const uint32_t head = dlog_head;
+
+    if(head - dlog_tail >= DLOG_RING_SIZE){
+        dlog_lost++;
+        __set_PRIMASK(primask);
+        return;
+    }
+
+    dlog_record_t *rec = &dlog_ring[head & (DLOG_RING_SIZE - 1u)];
+    rec->t_us    = t_us;
+    rec->seq     = seq;
+    rec->id      = id;
+    rec->n       = (n > DLOG_ARGS_MAX) ? (uint8_t)DLOG_ARGS_MAX : n;
+    rec->args[0] = a0;
+    rec->args[1] = a1;
+    rec->args[2] = a2;
+    dlog_head = head + 1u;
+
+    __set_PRIMASK(primask);
+}
+
+#if DLOG_CONSOLE && CONSOLE_ENABLE
+/** @brief Longueur maximale d'une ligne texte (préfixe, SEQ, T_US, ID, arguments, CRLF). */
+#define DLOG_LINE_MAX       (2u + 6u + (DBG_U32_DIGITS + 1u) + 4u + (DBG_U32_DIGITS + 1u) * DLOG_ARGS_MAX + 2u)
+
+/**
+ * @brief  Émet les enregistrements en attente en lignes texte sur la console.
+ * @details Une ligne n'est écrite que si elle tient en entier dans le ring de la console.
+ */
+void dlog_flush(void){
+    char line[DLOG_LINE_MAX];
+
+    for(uint32_t sent = 0; sent < DLOG_FLUSH_MAX && dlog_tail != dlog_head; sent++){
+        const dlog_record_t *rec = &dlog_ring[dlog_tail & (DLOG_RING_SIZE - 1u)];
+        uint32_t n = 0;
+
+        line[n++] = 'D';
+        line[n++] = ' ';
+        n += dbg_fmt_u32(&line[n], rec->seq);
+        line[n++] = ' ';
+        n += dbg_fmt_u32(&line[n], rec->t_us);
+        line[n++] = ' ';
+        n += dbg_fmt_u32(&line[n], rec->id);
+        for(uint8_t i = 0; i < rec->n; i++){
+            line[n++] = ' ';
+            n += dbg_fmt_i32(&line[n], rec->args[i]);
+        }
+        line[n++] = '\r';
+        line[n++] = '\n';
+
+        if(console_tx_free() < n){
+            return;
+        }
+        (void)console_write(line, n);
+
+        dlog_tail = dlog_tail + 1u;
+    }
+}
+#else
+/**
+ * @brief  Émet les enregistrements en attente, dans l'ordre, tant que le ring TX les accepte.
+ */
+void dlog_flush(void){
+    uint8_t frame[DLOG_FRAME_LEN(DLOG_ARGS_MAX)];
+
+    for(uint32_t sent = 0; sent < DLOG_FLUSH_MAX && dlog_tail != dlog_head; sent++){
+        const dlog_record_t *rec = &dlog_ring[dlog_tail & (DLOG_RING_SIZE - 1u)];
+        const uint16_t len = (uint16_t)DLOG_FRAME_LEN(rec->n);
+
+        frame[0]  = 0xAA;
+        frame[1]  = 0x55;
+        frame[2]  = DLOG_FRAME_TYPE;
+        frame[3]  = (uint8_t)(len - 5u);
+        memcpy(&frame[4], &rec->seq, sizeof(rec->seq));
+        memcpy(&frame[6], &rec->t_us, sizeof(rec->t_us));
+        frame[10] = rec->id;
+        frame[11] = rec->n;
+        memcpy(&frame[12], rec->args, 4u * rec->n);
+        frame[len - 1u] = serial_crc8_atm(frame, (uint16_t)(len - 1u));
+
+#if DLOG_RTT && RTT_ENABLE
+        if(rtt_write(RTT_CH_DLOG, frame, len) != len){
+            return;
+        }
+#else
+        if(serial_write_all_nb(frame, len) < 0){
+            return;
+        }
+#endif
+
+        dlog_tail = dlog_tail + 1u;
+    }
+}
+#endif
+
+/**
+ * @brief  Nombre d'enregistrements perdus.
+ * @return Compteur de pertes.
+ */
+uint32_t dlog_dropped(void){
+    return dlog_lost;
+}
+
+#endif /* DLOG_ENABLE */
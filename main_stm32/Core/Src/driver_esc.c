@@ -0,0 +1,190 @@
+/**
+ * @file    driver_esc.c
+ * @brief   Implémentation des sorties ESC rapides (cf. driver_esc.h).
+ * @details DShot : accès direct aux registres DMA2 et DMAMUX (canal non généré par
+ * CubeMX). DMA2_Channel2 (DMAMUX1_Channel8), sur la requête d'update de TIM2 : le
+ * DMA1 est complet et DMA2_Channel1 porte la console (console.c).
+ */
+
+#include "driver_esc.h"
+#include "actuators.h"
+#include "mem_map.h"
+
+/** @brief Fréquence de comptage sans prédiviseur (Hz) : 64 ticks par µs. */
+#define ESC_FAST_TICK_HZ        ACT_PWM_TIMER_CLK_HZ
+/** @brief Conversion µs -> ticks sans prédiviseur. */
+#define ESC_US_TO_TICKS(us)     ((uint16_t)((uint32_t)(us) * (ESC_FAST_TICK_HZ / 1000000u)))
+
+/** @brief Durée d'un bit DShot300 (ticks, 3,33 µs). */
+#define ESC_DSHOT300_BIT_TICKS  ((ESC_FAST_TICK_HZ + 150000u) / 300000u)
+/** @brief Durée d'un bit DShot600 (ticks, 1,67 µs). */
+#define ESC_DSHOT600_BIT_TICKS  ((ESC_FAST_TICK_HZ + 300000u) / 600000u)
+/** @brief Bits d'une trame DShot. */
+#define ESC_DSHOT_FRAME_BITS    16u
+/** @brief Créneaux du buffer circulaire : trame puis séparation au niveau bas. */
+#define ESC_DSHOT_SLOTS         (ESC_DSHOT_FRAME_BITS + ESC_DSHOT_GAP_BITS)
+
+/**
+ * @name Plages de consigne DShot (mode 3D)
+ * @{
+ */
+#define ESC_DSHOT_STOP          0u      ///< Arrêt (neutre, armement).
+#define ESC_DSHOT_REV_MIN       48u     ///< Marche arrière minimale.
+#define ESC_DSHOT_REV_MAX       1047u   ///< Marche arrière maximale.
+#define ESC_DSHOT_FWD_MIN       1049u   ///< Marche avant minimale.
+#define ESC_DSHOT_FWD_MAX       2047u   ///< Marche avant maximale.
+#define ESC_DSHOT_SPAN          999u    ///< Pas par sens.
+/** @} */
+
+_Static_assert(ESC_FAST_TICK_HZ % 1000000u == 0u, "ESC tick rate must be a whole number of ticks per us");
+_Static_assert(ESC_FAST_TICK_HZ / ESC_ONESHOT_HZ > 250u * (ESC_FAST_TICK_HZ / 1000000u) &&
+               ESC_FAST_TICK_HZ / ESC_ONESHOT_HZ <= 65536u, "ESC_ONESHOT_HZ out of range");
+_Static_assert(ESC_FAST_TICK_HZ / ESC_MULTISHOT_HZ > 25u * (ESC_FAST_TICK_HZ / 1000000u) &&
+               ESC_FAST_TICK_HZ / ESC_MULTISHOT_HZ <= 65536u, "ESC_MULTISHOT_HZ out of range");
+
+/** @brief Trame en cours et séparation, une valeur de CCR1 par bit (lu par le DMA). */
+static uint32_t esc_dshot_buf[ESC_DSHOT_SLOTS] MEM_DMA_BSS;
+/** @brief CCR d'un bit à 1 (75 % du bit). */
+static uint32_t esc_dshot_t1h = 0;
+/** @brief CCR d'un bit à 0 (37,5 % du bit). */
+static uint32_t esc_dshot_t0h = 0;
+/** @brief Pas DShot par tick au-dessus du neutre (Q16). */
+static uint32_t esc_dshot_fwd_q16 = 0;
+/** @brief Pas DShot par tick sous le neutre (Q16). */
+static uint32_t esc_dshot_rev_q16 = 0;
+/** @brief Dernière consigne codée (0xFFFF : aucune). */
+static uint16_t esc_dshot_last = 0xFFFFu;
+
+void esc_out_timebase(Motor_Output_t out, uint32_t *psc, uint32_t *period_ticks){
+    switch(out){
+        case MOTOR_OUT_ONESHOT125:
+            *psc = 0;
+            *period_ticks = ESC_FAST_TICK_HZ / ESC_ONESHOT_HZ;
+        break;
+        case MOTOR_OUT_MULTISHOT:
+            *psc = 0;
+            *period_ticks = ESC_FAST_TICK_HZ / ESC_MULTISHOT_HZ;
+        break;
+        case MOTOR_OUT_DSHOT300:
+            *psc = 0;
+            *period_ticks = ESC_DSHOT300_BIT_TICKS;
+        break;
+        case MOTOR_OUT_DSHOT600:
+            *psc = 0;
+            *period_ticks = ESC_DSHOT600_BIT_TICKS;
+        break;
+        default:
+            *psc = ACT_PWM_PRESCALER;
+            *period_ticks = ACT_ESC_PERIOD_TICKS;
+        break;
+    }
+}
+
+bool esc_out_init(Motor_Handle_t *hmotor){
+    uint32_t psc;
+    uint32_t bit;
+
+    switch(hmotor->output){
+        case MOTOR_OUT_ONESHOT125:
+            hmotor->min_pulse_ticks = ESC_US_TO_TICKS(125u);
+            hmotor->max_pulse_ticks = ESC_US_TO_TICKS(250u);
+        break;
+        case MOTOR_OUT_MULTISHOT:
+            hmotor->min_pulse_ticks = ESC_US_TO_TICKS(5u);
+            hmotor->max_pulse_ticks = ESC_US_TO_TICKS(25u);
+        break;
+        case MOTOR_OUT_DSHOT300:
+        case MOTOR_OUT_DSHOT600:
+            if(hmotor->htim == NULL || hmotor->htim->Instance != TIM2 || hmotor->channel != TIM_CHANNEL_1){
+                hmotor->output = MOTOR_OUT_PWM;
+                return false;
+            }
+            esc_out_timebase(hmotor->output, &psc, &bit);
+            esc_dshot_t1h = (bit * 3u) / 4u;
+            esc_dshot_t0h = (bit * 3u) / 8u;
+            // Plage min/max conservée : échelle de la machine à états, recodée en trames
+        break;
+        default:
+        break;
+    }
+    return true;
+}
+
+/**
+ * @brief  Convertit une consigne en ticks (échelle de la machine à états) en valeur DShot 3D.
+ * @param  hmotor Pointeur vers le handle du moteur.
+ * @return Valeur DShot (0, 48..1047 ou 1049..2047).
+ */
+static uint16_t esc_dshot_value(const Motor_Handle_t *hmotor){
+    const int32_t off = (int32_t)hmotor->pulse_ticks - (int32_t)hmotor->map.neutral_ticks;
+    uint32_t v;
+
+    if(off > 0){
+        v = ESC_DSHOT_FWD_MIN - 1u + (((uint32_t)off * esc_dshot_fwd_q16) >> 16);
+        if(v < ESC_DSHOT_FWD_MIN) v = ESC_DSHOT_FWD_MIN;
+        if(v > ESC_DSHOT_FWD_MAX) v = ESC_DSHOT_FWD_MAX;
+    }
+    else if(off < 0){
+        v = ESC_DSHOT_REV_MIN - 1u + (((uint32_t)(-off) * esc_dshot_rev_q16) >> 16);
+        if(v < ESC_DSHOT_REV_MIN) v = ESC_DSHOT_REV_MIN;
+        if(v > ESC_DSHOT_REV_MAX) v = ESC_DSHOT_REV_MAX;
+    }
+    else{
+        v = ESC_DSHOT_STOP;
+    }
+    return (uint16_t)v;
+}
+
+void esc_dshot_update(const Motor_Handle_t *hmotor){
+    const uint16_t value = esc_dshot_value(hmotor);
+
+    if(value == esc_dshot_last){
+        return;
+    }
+    esc_dshot_last = value;
+
+    // 11 bits de consigne, bit de télémétrie à 0, CRC : XOR des trois quartets
+    const uint16_t data = (uint16_t)(value << 1);
+    const uint16_t frame = (uint16_t)((data << 4) | ((data ^ (data >> 4) ^ (data >> 8)) & 0x0Fu));
+
+    for(uint8_t i = 0; i < ESC_DSHOT_FRAME_BITS; i++){
+        esc_dshot_buf[i] = (frame & (0x8000u >> i)) ? esc_dshot_t1h : esc_dshot_t0h;
+    }
+}
+
+void esc_out_start(Motor_Handle_t *hmotor){
+    if(!MOTOR_OUT_IS_DSHOT(hmotor->output)){
+        return;
+    }
+    const uint32_t neutral = hmotor->map.neutral_ticks;
+
+    esc_dshot_fwd_q16 = (hmotor->max_pulse_ticks > neutral) ?
+                        (ESC_DSHOT_SPAN << 16) / (hmotor->max_pulse_ticks - neutral) : 0u;
+    esc_dshot_rev_q16 = (neutral > hmotor->min_pulse_ticks) ?
+                        (ESC_DSHOT_SPAN << 16) / (neutral - hmotor->min_pulse_ticks) : 0u;
+    esc_dshot_last = 0xFFFFu;
+    for(uint8_t i = 0; i < ESC_DSHOT_SLOTS; i++){
+        esc_dshot_buf[i] = 0;
+    }
+    esc_dshot_update(hmotor);
+
+    RCC->AHBENR |= RCC_AHBENR_DMA2EN;
+    DMA2_Channel2->CCR    = 0;
+    DMAMUX1_Channel8->CCR = DMA_REQUEST_TIM2_UP;
+    DMA2_Channel2->CPAR   = (uint32_t)&TIM2->CCR1;
+    DMA2_Channel2->CMAR   = (uint32_t)esc_dshot_buf;
+    DMA2_Channel2->CNDTR  = ESC_DSHOT_SLOTS;
+    DMA2_Channel2->CCR    = DMA_CCR_PL | DMA_CCR_MSIZE_1 | DMA_CCR_PSIZE_1 | DMA_CCR_MINC |
+                            DMA_CCR_CIRC | DMA_CCR_DIR | DMA_CCR_EN;
+    TIM2->DIER |= TIM_DIER_UDE;
+}
+
+void esc_out_stop(const Motor_Handle_t *hmotor){
+    if(!MOTOR_OUT_IS_DSHOT(hmotor->output)){
+        return;
+    }
+    TIM2->DIER &= ~TIM_DIER_UDE;
+    DMA2_Channel2->CCR = 0;
+    TIM2->CCR1 = 0;
+    TIM2->EGR = TIM_EGR_UG;     // Recharge immédiate du CCR préchargé : ligne au niveau bas
+}
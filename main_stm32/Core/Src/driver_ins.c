@@ -3,11 +3,29 @@
  * @brief   Implémentation du pilote pour l'IMU BMI088 (Accéléromètre + Gyroscope).
  * @details Gère l'initialisation, la communication SPI et la conversion des données
  * brutes en unités physiques via l'API Bosch SensorTec.
+ * Fournit également un chemin d'acquisition asynchrone (SPI1 + DMA, transactions
+ * ordonnancées par spi_bus) : la lecture accéléromètre puis gyroscope est enchaînée
+ * en interruption et l'échantillon terminé est publié sous verrou de séquence
+ * (seqlock.h), consulté par l'ordonnanceur.
  */
 
 #include "stm32g0xx_hal.h"
+#include "stm32g0xx_ll_spi.h"
 #include "driver_ins.h"
-#include <stdio.h>
+#include "bmi088_anymotion.h"
+#include "timebase.h"
+#include "profiler.h"
+#include "irq_prio.h"
+#include "mem_map.h"
+#include "nv_flash.h"
+#include "crc8.h"
+#include "dlog.h"
+#include "spi_bus.h"
+#include "seqlock.h"
+#include "pt.h"
+#include "scheduler.h"
+#include "dbgout.h"
+#include <stddef.h>
 #include <string.h>
 
 /** @brief Instance de la structure de périphérique Bosch BMI08. */
@@ -28,10 +46,492 @@ static bmi088_cs_t cs_gyro = {
     .pin  = BMI088_CS_GYRO_Pin
 };
 
+/** @brief Périphérique spi_bus de l'accéléromètre (acquisitions DMA). */
+static uint8_t bus_dev_accel = SPI_BUS_DEV_NONE;
+/** @brief Périphérique spi_bus du gyroscope (acquisitions DMA). */
+static uint8_t bus_dev_gyro = SPI_BUS_DEV_NONE;
+
+/** @brief Facteurs mm/s² par LSB, indexés par code de gamme BMI088_ACCEL_RANGE_*. */
+static const float accel_scale_mms2_table[4] = {
+    G_TO_MM_S2 / ACCEL_RANGE_3G_LSB,
+    G_TO_MM_S2 / ACCEL_RANGE_6G_LSB,
+    G_TO_MM_S2 / ACCEL_RANGE_12G_LSB,
+    G_TO_MM_S2 / ACCEL_RANGE_24G_LSB
+};
+
+/** @brief Facteurs Q12 mm/s² par LSB, indexés par code de gamme BMI088_ACCEL_RANGE_*. */
+static const int32_t accel_scale_q12_table[4] = {
+    ACCEL_RANGE_3G_Q12,
+    ACCEL_RANGE_6G_Q12,
+    ACCEL_RANGE_12G_Q12,
+    ACCEL_RANGE_24G_Q12
+};
+
+/** @brief Facteurs rad/s par LSB, indexés par code de gamme BMI08_GYRO_RANGE_*. */
+static const float gyro_scale_rads_table[5] = {
+    DEG_TO_RAD / GYRO_RANGE_2000DPS_LSB,
+    DEG_TO_RAD / GYRO_RANGE_1000DPS_LSB,
+    DEG_TO_RAD / GYRO_RANGE_500DPS_LSB,
+    DEG_TO_RAD / GYRO_RANGE_250DPS_LSB,
+    DEG_TO_RAD / GYRO_RANGE_125DPS_LSB
+};
+
+/** @brief Facteurs Q4 µrad/s par LSB, indexés par code de gamme BMI08_GYRO_RANGE_*. */
+static const int32_t gyro_scale_q4_table[5] = {
+    GYRO_RANGE_2000DPS_Q4,
+    GYRO_RANGE_1000DPS_Q4,
+    GYRO_RANGE_500DPS_Q4,
+    GYRO_RANGE_250DPS_Q4,
+    GYRO_RANGE_125DPS_Q4
+};
+
+/** @brief Facteur de conversion accéléromètre actif (mm/s² par LSB). */
+static float accel_scale_mms2 = G_TO_MM_S2 / ACCEL_RANGE_6G_LSB;
+/** @brief Facteur de conversion accéléromètre actif (Q12). */
+static int32_t accel_scale_q12 = ACCEL_RANGE_6G_Q12;
+/** @brief Facteur de conversion gyroscope actif (rad/s par LSB). */
+static float gyro_scale_rads = DEG_TO_RAD / GYRO_RANGE_1000DPS_LSB;
+/** @brief Facteur de conversion gyroscope actif (Q4). */
+static int32_t gyro_scale_q4 = GYRO_RANGE_1000DPS_Q4;
+
+/** @brief Offsets actifs, soustraits par les conversions virgule fixe. */
+static bmi088_offsets_t cal_ofs;
+/** @brief Offsets accéléromètre actifs (mm/s²), pour les conversions flottantes. */
+static float cal_accel_ofs_mms2[3];
+/** @brief Offsets gyroscope actifs (rad/s), pour les conversions flottantes. */
+static float cal_gyro_ofs_rads[3];
+
+/** @brief Marqueur d'un enregistrement de calibration en flash ("CAL1"). */
+#define BMI088_CAL_MAGIC        0x314C4143u
+/** @brief Gravité retranchée à l'axe Z par la calibration accéléromètre (mm/s²). */
+#define BMI088_CAL_G_MMS2       ((int32_t)(G_TO_MM_S2 + 0.5f))
+
+/**
+ * @brief Enregistrement de calibration en flash (4 doubles mots).
+ * @note  Ajouté à la suite du précédent dans la page : la page n'est effacée que
+ * lorsqu'elle est pleine, le dernier enregistrement valide fait foi.
+ */
+typedef struct {
+    uint32_t magic;         ///< BMI088_CAL_MAGIC.
+    bmi088_offsets_t ofs;   ///< Offsets calibrés.
+    uint32_t crc;           ///< CRC-8 des champs précédents (octet de poids faible).
+} bmi088_cal_record_t;
+
+/** @brief État de la dernière calibration (bmi088_cal_state_t). */
+static uint8_t cal_state = BMI088_CAL_IDLE;
+/** @brief Demande en cours de moyennage (bmi088_cal_req_t). */
+static uint8_t cal_req = 0;
+/** @brief Offsets actifs issus d'un enregistrement en flash. */
+static uint8_t cal_stored = 0;
+/** @brief Échantillons accumulés par la calibration en cours. */
+static uint16_t cal_count = 0;
+/** @brief Sommes des axes bruts accéléromètre (LSB). */
+static int32_t cal_sum_accel[3];
+/** @brief Sommes des axes bruts gyroscope (LSB). */
+static int32_t cal_sum_gyro[3];
+/** @brief Minimum observé par axe gyroscope (LSB, détection de mouvement). */
+static int16_t cal_gyro_min[3];
+/** @brief Maximum observé par axe gyroscope (LSB, détection de mouvement). */
+static int16_t cal_gyro_max[3];
+
+/** @brief Délai de redémarrage de l'accéléromètre après soft reset (datasheet : 1 ms). */
+#define BMI088_ACCEL_RESET_DELAY_US  1000u
+/** @brief Délai de redémarrage du gyroscope après soft reset (datasheet : 30 ms). */
+#define BMI088_GYRO_RESET_DELAY_US   30000u
+
+/** @brief Taille de la lecture accéléromètre seule : adresse + octet vide + 6 octets de données. */
+#define BMI088_ACCEL_XYZ_LEN    8
+/**
+ * @brief Taille de la transaction DMA accéléromètre : adresse + octet vide + 6 octets de
+ * données + horloge capteur 24 bits (SENSORTIME_0..2, contiguë aux données).
+ */
+#define BMI088_DMA_ACCEL_LEN    (2 + BMI08_REG_ACCEL_SENSORTIME_2 - BMI08_REG_ACCEL_X_LSB + 1)
+/**
+ * @brief Taille de la transaction DMA accéléromètre prolongée jusqu'à TEMP_LSB.
+ * @note  Traverse ACC_INT_STAT_1 : sa lecture n'efface que l'indicateur data-ready,
+ * la ligne INT1 n'est pas affectée.
+ */
+#define BMI088_DMA_ACCEL_TEMP_LEN   (2 + BMI08_REG_TEMP_LSB - BMI08_REG_ACCEL_X_LSB + 1)
+/** @brief Taille de la transaction DMA gyroscope : adresse + 6 octets de données. */
+#define BMI088_DMA_GYRO_LEN     7
+/** @brief Plage lue en mode synchronisé : horloge capteur, GP_0..GP_3, température, GP_4 + 1. */
+#define BMI088_SYNC_DATA_LEN    (BMI08_REG_ACCEL_GP_4 - BMI08_REG_ACCEL_SENSORTIME_0 + 2)
+/** @brief Taille de la transaction DMA accéléromètre en mode synchronisé : adresse + octet vide + données. */
+#define BMI088_DMA_SYNC_LEN     (BMI088_SYNC_DATA_LEN + 2)
+/** @brief Taille des buffers DMA (plus longue des transactions). */
+#define BMI088_DMA_BUF_LEN      ((BMI088_DMA_ACCEL_TEMP_LEN > BMI088_DMA_SYNC_LEN) ? BMI088_DMA_ACCEL_TEMP_LEN : BMI088_DMA_SYNC_LEN)
+
+/**
+ * @brief États de la séquence d'acquisition DMA.
+ */
+typedef enum{
+    BMI088_DMA_IDLE=0,      ///< Bus SPI libre, aucune acquisition en cours.
+    BMI088_DMA_ACCEL,       ///< Lecture des données accéléromètre en cours.
+    BMI088_DMA_GYRO         ///< Lecture des données gyroscope en cours.
+} bmi088_dma_state_t;
+
+/**
+ * @brief Échantillon brut publié par la séquence DMA.
+ */
+typedef struct{
+    struct bmi08_sensor_data accel;     ///< Données brutes accéléromètre.
+    struct bmi08_sensor_data gyro;      ///< Données brutes gyroscope.
+    uint64_t timestamp_us;              ///< Date de déclenchement de l'acquisition (µs, GetMicros64).
+    uint32_t sensor_time;               ///< Horloge du capteur (24 bits).
+} bmi088_raw_sample_t;
+
+/** @brief État courant de la séquence DMA (modifié en interruption). */
+static volatile bmi088_dma_state_t dma_state = BMI088_DMA_IDLE;
+/** @brief Buffer d'émission DMA (adresse registre puis octets vides). */
+static uint8_t dma_tx_buf[BMI088_DMA_BUF_LEN] MEM_DMA_BSS;
+/** @brief Buffer de réception DMA. */
+static uint8_t dma_rx_buf[BMI088_DMA_BUF_LEN] MEM_DMA_BSS;
+/** @brief Longueur de la transaction accéléromètre en cours (avec ou sans température). */
+static volatile uint8_t dma_accel_len = BMI088_DMA_ACCEL_LEN;
+/** @brief Acquisitions depuis la dernière lecture de température. */
+static uint8_t temp_phase = 0;
+/** @brief Dernière température lue (centièmes de °C). */
+static volatile int16_t temp_cdeg = BMI088_TEMP_UNKNOWN;
+/** @brief Échantillon en cours d'acquisition (accéléromètre puis gyroscope, interruption). */
+static bmi088_raw_sample_t dma_stage MEM_HOT_BSS;
+/** @brief Dernier échantillon publié, protégé par dma_lock. */
+static bmi088_raw_sample_t dma_pub MEM_HOT_BSS;
+/** @brief Verrou de séquence de dma_pub (écrit en interruption DMA). */
+static seqlock_t dma_lock = SEQLOCK_INIT;
+/** @brief Dernier compteur de dma_lock consommé par BMI088_Get_Sample. */
+static uint32_t dma_seq_read = 0;
+
+/** @brief File SPSC d'échantillons (producteur : interruption DMA, consommateur : boucle principale). */
+static bmi088_raw_sample_t sample_queue[BMI088_SAMPLE_QUEUE_LEN] MEM_HOT_BSS;
+/** @brief Index d'écriture de la file (modifié uniquement en interruption). */
+static volatile uint8_t queue_head = 0;
+/** @brief Index de lecture de la file (modifié uniquement par la boucle principale). */
+static volatile uint8_t queue_tail = 0;
+/** @brief Nombre d'échantillons perdus (file pleine ou bus occupé au data-ready). */
+static volatile uint32_t queue_dropped = 0;
+/** @brief 1 : acquisitions suspendues, file alimentée par BMI088_Inject() (rejeu). */
+static volatile uint8_t inject_mode = 0;
+/** @brief Observateur des échantillons retirés de la file (NULL : aucun). */
+static bmi088_sample_hook_t sample_hook = NULL;
+/** @brief Observateur brut des échantillons retirés de la file (NULL : aucun). */
+static bmi088_raw_hook_t raw_hook = NULL;
+/** @brief Filtre des échantillons retirés de la file (NULL : aucun). */
+static bmi088_filter_hook_t filter_hook = NULL;
+/** @brief Observateur des publications DMA, appelé en interruption (NULL : aucun). */
+static bmi088_publish_hook_t publish_hook = NULL;
+/** @brief Broche EXTI déclenchant les acquisitions (0 : mode data-ready inactif). */
+static uint16_t drdy_pin = 0;
+/** @brief Mode de synchronisation Accel/Gyro actif (BMI08_ACCEL_DATA_SYNC_MODE_*). */
+static uint8_t data_sync_mode = BMI08_ACCEL_DATA_SYNC_MODE_OFF;
+/** @brief Seuil de détection de mouvement demandé (mg, 0 : détection inactive). */
+static uint16_t motion_thr_mg = 0;
+/** @brief Durée de dépassement du seuil avant détection (ms). */
+static uint16_t motion_dur_ms = 0;
+/** @brief 1 si le fichier de configuration any-motion est chargé dans l'accéléromètre. */
+static uint8_t motion_loaded = 0;
+/** @brief 1 si la ligne INT1 signale les détections de mouvement. */
+static uint8_t motion_armed = 0;
+/** @brief Détections de mouvement signalées par INT1 (incrémenté en interruption). */
+static volatile uint32_t motion_events = 0;
+
+/** @brief Buffer de vidage FIFO accéléromètre (FIFO complète + octet vide SPI). */
+static uint8_t accel_fifo_buf[BMI088_ACCEL_FIFO_SIZE + 1];
+/** @brief Buffer de vidage FIFO gyroscope. */
+static uint8_t gyro_fifo_buf[BMI088_GYRO_FIFO_MAX_FRAMES * BMI08_GYRO_FIFO_XYZ_AXIS_FRAME_SIZE];
+/** @brief Configuration FIFO gyroscope active (nécessaire à l'extraction des trames). */
+static struct bmi08_gyr_fifo_config gyro_fifo_conf;
+/** @brief Période d'échantillonnage accéléromètre en mode FIFO (µs). */
+static uint32_t fifo_accel_period_us = 0;
+/** @brief Période d'échantillonnage gyroscope en mode FIFO (µs). */
+static uint32_t fifo_gyro_period_us = 0;
+/** @brief Capteur cadençant le mode data-ready (ré-appliqué après récupération du bus). */
+static bmi088_drdy_src_t drdy_source = BMI088_DRDY_ACCEL;
+
+/** @brief Délai appliqué par l'API Bosch après l'écriture de ACC_CONF (BMI08_SET_ACCEL_CONF_DELAY, µs). */
+#define BMI088_ACCEL_CONF_DELAY_US   40000u
+/** @brief Délai entre PWR_CONF et PWR_CTRL, puis après PWR_CTRL (BMI08_POWER_CONFIG_DELAY, µs). */
+#define BMI088_POWER_CONF_DELAY_US   5000u
+
+/**
+ * @brief Étapes de la séquence de démarrage / récupération du bus SPI.
+ * @details Le démarrage asynchrone (BMI088_Init_Async) entre en BMI088_BUS_ACCEL_RESET,
+ * la récupération en BMI088_BUS_SPI_REINIT ; la séquence elle-même est la protothread
+ * bmi088_bus_thread(), qui tient bus_state à jour sur l'étape en cours.
+ */
+typedef enum{
+    BMI088_BUS_OK=0,            ///< Bus opérationnel.
+    BMI088_BUS_SPI_REINIT,      ///< Abandon des transferts et ré-initialisation de SPI1.
+    BMI088_BUS_ACCEL_RESET,     ///< Soft reset de l'accéléromètre.
+    BMI088_BUS_GYRO_RESET,      ///< Soft reset du gyroscope, une fois l'accéléromètre redémarré.
+    BMI088_BUS_REINIT,          ///< Ré-initialisation Bosch, une fois le gyroscope redémarré.
+    BMI088_BUS_ACCEL_PWR_CONF,  ///< Accéléromètre : écriture de PWR_CONF.
+    BMI088_BUS_ACCEL_PWR_CTRL,  ///< Accéléromètre : écriture de PWR_CTRL, BMI088_POWER_CONF_DELAY_US après PWR_CONF.
+    BMI088_BUS_MEAS_CONF,       ///< Gammes, ODR et bande passante des deux capteurs.
+    BMI088_BUS_MODE             ///< Mode d'acquisition actif (synchronisation, FIFO, data-ready).
+} bmi088_bus_state_t;
+
+/** @brief Étape courante du démarrage ou de la récupération du bus (BMI088_BUS_OK sinon). */
+static volatile bmi088_bus_state_t bus_state = BMI088_BUS_OK;
+/** @brief 1 pendant le démarrage asynchrone (distingue démarrage et récupération). */
+static uint8_t bus_booting = 0;
+/** @brief Mode data-ready demandé pendant le démarrage, appliqué à l'étape BMI088_BUS_MODE. */
+static uint8_t drdy_pending = 0;
+/** @brief Protothread de la séquence de démarrage / récupération (délais capteurs en attentes datées). */
+static pt_t bus_pt = PT_STATIC_INIT;
+/** @brief Gammes ou ODR modifiés pendant le démarrage, après l'étape BMI088_BUS_MEAS_CONF : à réécrire. */
+static uint8_t bus_meas_redo = 0;
+/** @brief Auto-test en cours ou demandé (BMI088_ST_RUNNING), ou résultat du dernier auto-test. */
+static volatile uint8_t st_state = BMI088_ST_IDLE;
+/** @brief Capteurs en échec lors du dernier auto-test (bmi088_st_fail_t). */
+static uint8_t st_fail = 0;
+/** @brief Capteurs sous excitation d'auto-test : acquisitions refusées (BMI088_E_BUSY). */
+static volatile uint8_t st_hold = 0;
+/** @brief Protothread de l'auto-test (bmi088_st_thread()). */
+static pt_t st_pt = PT_STATIC_INIT;
+/** @brief Mesure accéléromètre sous excitation positive (LSB à ±24 g). */
+static int16_t st_pos[3];
+/** @brief Date limite de l'auto-test intégré du gyroscope (µs). */
+static uint64_t st_gyro_limit_us = 0;
+/** @brief Échecs SPI consécutifs (remis à zéro au premier transfert réussi). */
+static volatile uint8_t bus_fail_streak = 0;
+/** @brief Transferts interrompus par timeout. */
+static volatile uint32_t bus_timeouts = 0;
+/** @brief Erreurs HAL hors timeout. */
+static volatile uint32_t bus_errors = 0;
+/** @brief Séquences de récupération menées à terme. */
+static uint32_t bus_recoveries = 0;
+/** @brief Champ BR de SPI1->CR1 ayant servi au calcul de spi_bytes_per_ms. */
+static uint32_t spi_br_cached = UINT32_MAX;
+/** @brief Octets transférés par milliseconde à la vitesse SPI courante. */
+static uint32_t spi_bytes_per_ms = 1;
+/** @brief Date de lancement de la séquence DMA en cours (ms, HAL_GetTick). */
+static volatile uint32_t dma_start_ms = 0;
+/**
+ * @brief File des accès aux registres : [regio_tail, regio_next) terminés, [regio_next,
+ * regio_head) en attente (index libres, modulo BMI088_REGIO_QUEUE_LEN).
+ * @note  Remplie, servie et vidée depuis la boucle principale.
+ */
+static bmi088_regio_t regio_queue[BMI088_REGIO_QUEUE_LEN];
+static uint8_t regio_head = 0;
+static uint8_t regio_next = 0;
+static uint8_t regio_tail = 0;
+/** @brief Registre sélectionné par la dernière lecture mise en file (capteur << 7 | adresse), 0xFF : aucun. */
+static uint8_t regio_sel = 0xFFu;
+_Static_assert((BMI088_REGIO_QUEUE_LEN & (BMI088_REGIO_QUEUE_LEN - 1u)) == 0u, "register access indexes wrap modulo 256");
+
+#if BMI088_FEATURE_LAZY
+/** @brief Attente après la désactivation de l'économie d'énergie avancée, avant INIT_CTRL (µs). */
+#define BMI088_APS_DISABLE_DELAY_US  450u
+
+/** @brief Étapes du téléversement en tâche de fond d'un fichier de configuration accéléromètre. */
+typedef enum{
+    BMI088_FEAT_IDLE=0,     ///< Aucun téléversement en cours.
+    BMI088_FEAT_START,      ///< Sélection du fichier et désactivation de l'économie d'énergie avancée.
+    BMI088_FEAT_STREAM,     ///< Écriture d'une rafale du fichier (INIT_CTRL à 0 à la première).
+    BMI088_FEAT_COMMIT,     ///< INIT_CTRL à 1 : initialisation de l'ASIC.
+    BMI088_FEAT_CHECK       ///< Contrôle de INTERNAL_STAT puis activation de la fonction.
+} bmi088_feat_state_t;
+
+/** @brief Étape courante du téléversement (BMI088_FEAT_IDLE sinon). */
+static bmi088_feat_state_t feat_state = BMI088_FEAT_IDLE;
+/** @brief Position de la prochaine rafale dans le fichier (octets). */
+static uint16_t feat_index = 0;
+/** @brief Date à partir de laquelle l'étape suivante du téléversement peut s'exécuter (µs). */
+static uint64_t feat_deadline_us = 0;
+/** @brief Mode de synchronisation en attente de son fichier (OFF : fichier any-motion). */
+static uint8_t feat_sync_mode = BMI08_ACCEL_DATA_SYNC_MODE_OFF;
+#endif
+
+/**
+ * @brief  Calcule le timeout d'un transfert SPI bloquant.
+ * @details Durée théorique du transfert à la vitesse SCK courante, plus une marge
+ * couvrant la granularité de HAL_GetTick. Le débit est recalculé uniquement quand
+ * le prédiviseur change (SPI1_Set_Prescaler).
+ * @param  len Nombre d'octets du transfert.
+ * @return Timeout en millisecondes.
+ */
+static uint32_t bmi088_spi_timeout_ms(uint32_t len){
+    const uint32_t br = bmi088_hspi->Instance->CR1 & SPI_CR1_BR;
+
+    if(br != spi_br_cached){
+        /* SCK = PCLK / 2^(BR+1), 8 bits par octet */
+        spi_bytes_per_ms = (HAL_RCC_GetPCLK1Freq() / 1000u) >> ((br >> SPI_CR1_BR_Pos) + 1u + 3u);
+        if(spi_bytes_per_ms == 0){
+            spi_bytes_per_ms = 1;
+        }
+        spi_br_cached = br;
+    }
+
+    return len / spi_bytes_per_ms + BMI088_SPI_TIMEOUT_MARGIN_MS;
+}
+
+/**
+ * @brief  Arme la séquence de récupération (soft reset et reconfiguration des capteurs).
+ * @note   Bus supposé opérationnel (bus_state == BMI088_BUS_OK).
+ */
+static void bmi088_bus_arm_recovery(void){
+    if(st_state == BMI088_ST_RUNNING){
+        /* Le soft reset de la récupération sort les capteurs de l'auto-test */
+        PT_INIT(&st_pt);
+        st_hold = 0;
+        st_state = BMI088_ST_E_COM;
+    }
+    PT_INIT(&bus_pt);
+    bus_state = BMI088_BUS_SPI_REINIT;
+}
+
+/**
+ * @brief  Comptabilise un échec SPI et arme la récupération au-delà du seuil.
+ */
+static void bmi088_bus_fail(void){
+    if(bus_fail_streak < UINT8_MAX){
+        bus_fail_streak++;
+    }
+
+    if(bus_fail_streak >= BMI088_BUS_FAIL_THRESHOLD && bus_state == BMI088_BUS_OK){
+        bmi088_bus_arm_recovery();
+        DLOG3(DLOG_IMU_BUS_FAIL, bus_fail_streak, bus_timeouts, bus_errors);
+    }
+}
+
+/**
+ * @brief  Traduit un statut HAL en code Bosch et tient les compteurs d'erreurs.
+ * @param  status Statut renvoyé par la HAL SPI.
+ * @return BMI08_OK ou BMI08_E_COM_FAIL.
+ */
+static int8_t bmi088_spi_status(HAL_StatusTypeDef status){
+    if(status == HAL_OK){
+        bus_fail_streak = 0;
+        return BMI08_OK;
+    }
+
+    if(status == HAL_TIMEOUT){
+        bus_timeouts++;
+    }
+    else{
+        bus_errors++;
+    }
+    bmi088_bus_fail();
+
+    return BMI08_E_COM_FAIL;
+}
+
+/** @brief Période (µs) associée à chaque code ODR/BW gyroscope (BMI08_GYRO_BW_*). */
+static const uint16_t gyro_odr_period_us[8] = {
+    500,    // BW_532_ODR_2000_HZ
+    500,    // BW_230_ODR_2000_HZ
+    1000,   // BW_116_ODR_1000_HZ
+    2500,   // BW_47_ODR_400_HZ
+    5000,   // BW_23_ODR_200_HZ
+    10000,  // BW_12_ODR_100_HZ
+    5000,   // BW_64_ODR_200_HZ
+    10000   // BW_32_ODR_100_HZ
+};
+
+/**
+ * @brief  Réserve le bus (spi_bus_lock) puis sélectionne un capteur (CS à l'état bas).
+ * @details Attend au plus la durée d'une transaction DMA que le bus se libère : les
+ * transactions des autres périphériques soumises pendant l'accès bloquant restent
+ * en file jusqu'à bmi088_cs_high().
+ * @param  cs Chip Select du capteur.
+ * @return 1 si le capteur est sélectionné, 0 si le bus est resté occupé.
+ */
+static uint8_t bmi088_cs_low(const bmi088_cs_t *cs){
+    const uint32_t t0 = HAL_GetTick();
+
+    while(!spi_bus_lock()){
+        if((HAL_GetTick() - t0) > bmi088_spi_timeout_ms(BMI088_DMA_BUF_LEN)){
+            return 0;
+        }
+    }
+    cs->port->BRR = cs->pin;
+    return 1;
+}
+
+/** @brief Relâche un capteur (CS à l'état haut) et le bus. */
+static inline void bmi088_cs_high(const bmi088_cs_t *cs){
+    cs->port->BSRR = cs->pin;
+    spi_bus_unlock();
+}
+
+/**
+ * @brief  Échange bloquant de `len` octets sur le bus SPI du BMI088.
+ * @details BMI088_SPI_LL : accès direct au registre DR, au plus deux octets en vol
+ * (le FIFO RX de 4 octets ne peut pas déborder même si une interruption retarde la
+ * boucle). Sinon : HAL_SPI_Transmit/Receive/TransmitReceive.
+ * @param  tx  Octets à émettre, ou NULL pour émettre des 0x00.
+ * @param  rx  Buffer de réception, ou NULL pour ignorer les octets reçus.
+ * @param  len Nombre d'octets.
+ * @return Statut au format HAL (HAL_OK, HAL_BUSY, HAL_TIMEOUT), pour bmi088_spi_status().
+ */
+static HAL_StatusTypeDef bmi088_spi_xfer(const uint8_t *tx, uint8_t *rx, uint16_t len){
+    const uint32_t timeout_ms = bmi088_spi_timeout_ms(len);
+#if BMI088_SPI_LL
+    SPI_TypeDef *spi = bmi088_hspi->Instance;
+    const uint32_t start = HAL_GetTick();
+    uint16_t tx_left = len, rx_left = len;
+
+    if(bmi088_hspi->State != HAL_SPI_STATE_READY){
+        return HAL_BUSY;
+    }
+
+    LL_SPI_SetRxFIFOThreshold(spi, LL_SPI_RX_FIFO_TH_QUARTER);
+    if(!LL_SPI_IsEnabled(spi)){
+        LL_SPI_Enable(spi);
+    }
+    while(LL_SPI_IsActiveFlag_RXNE(spi)){
+        (void)LL_SPI_ReceiveData8(spi);
+    }
+    LL_SPI_ClearFlag_OVR(spi);
+
+    while(rx_left > 0u){
+        if(tx_left > 0u && (uint16_t)(rx_left - tx_left) < 2u && LL_SPI_IsActiveFlag_TXE(spi)){
+            LL_SPI_TransmitData8(spi, (tx != NULL) ? *tx++ : 0x00u);
+            tx_left--;
+        }
+        if(LL_SPI_IsActiveFlag_RXNE(spi)){
+            const uint8_t b = LL_SPI_ReceiveData8(spi);
+            if(rx != NULL){
+                *rx++ = b;
+            }
+            rx_left--;
+        }
+        else if((HAL_GetTick() - start) >= timeout_ms){
+            return HAL_TIMEOUT;
+        }
+    }
+
+    while(LL_SPI_IsActiveFlag_BSY(spi)){
+        if((HAL_GetTick() - start) >= timeout_ms){
+            return HAL_TIMEOUT;
+        }
+    }
+
+    return HAL_OK;
+#else
+    if(rx == NULL){
+        return HAL_SPI_Transmit(bmi088_hspi, (uint8_t*)tx, len, timeout_ms);
+    }
+    if(tx == NULL){
+        return HAL_SPI_Receive(bmi088_hspi, rx, len, timeout_ms);
+    }
+    return HAL_SPI_TransmitReceive(bmi088_hspi, (uint8_t*)tx, rx, len, timeout_ms);
+#endif
+}
+
+/** @brief Buffer de travail SPI en émission (adresse + octets vides), dimensionné pour BMI08_MAX_LEN. */
+static uint8_t spi_tx_scratch[BMI08_MAX_LEN + 2];
+/** @brief Buffer de travail SPI en réception, dimensionné pour BMI08_MAX_LEN. */
+static uint8_t spi_rx_scratch[BMI08_MAX_LEN + 2];
+
 /**
  * @brief  Fonction de lecture SPI bas niveau conforme à l'interface Bosch.
- * @note   Gère la différence de protocole entre l'accéléromètre (byte vide requis)
- * et le gyroscope (pas de byte vide).
+ * @note   L'octet vide de l'accéléromètre est déjà demandé par l'API Bosch (dev->dummy_byte) :
+ * les deux capteurs se lisent donc de la même façon (adresse puis `len` octets).
+ * Les buffers de travail sont statiques et jamais remis à zéro : seul l'octet
+ * d'adresse est écrit en émission, les octets suivants restent à 0x00.
+ * Les lectures plus longues que BMI08_MAX_LEN (vidage FIFO) sont reçues
+ * directement dans `reg_data`.
  * @param  reg_addr Adresse du registre à lire.
  * @param  reg_data Pointeur vers le buffer de réception des données.
  * @param  len      Nombre d'octets à lire.
@@ -40,52 +540,43 @@ static bmi088_cs_t cs_gyro = {
  */
 static int8_t bmi088_spi_read(uint8_t reg_addr, uint8_t *reg_data, uint32_t len, void *intf_ptr){
     if (reg_data == NULL || intf_ptr == NULL) return BMI08_E_NULL_PTR;
-    if (len == 0 || len > BMI08_MAX_LEN) return BMI08_E_RD_WR_LENGTH_INVALID;
+    if (len == 0 || len > UINT16_MAX) return BMI08_E_RD_WR_LENGTH_INVALID;
+    if (dma_state != BMI088_DMA_IDLE) return BMI08_E_COM_FAIL;
 
     bmi088_cs_t *cs = (bmi088_cs_t*)intf_ptr;
     HAL_StatusTypeDef status;
 
-    HAL_GPIO_WritePin(cs->port, cs->pin, GPIO_PIN_RESET);
-
-    if(cs->pin == BMI088_CS_ACC_Pin){
-        uint8_t tx_buf[256] = {0};
-        uint8_t rx_buf[256] = {0};
-
-        tx_buf[0] = reg_addr | 0x80;
-        tx_buf[1] = 0x00;
-
-        status = HAL_SPI_TransmitReceive(bmi088_hspi, tx_buf, rx_buf, len + 2, HAL_MAX_DELAY);
+    if(len > BMI08_MAX_LEN){
+        /* Lecture FIFO : émission de l'adresse puis réception directe dans reg_data */
+        uint8_t addr = reg_addr | 0x80;
 
-        /*
-        for(uint32_t i = 0; i < len + 2; i++){
-            printf("REG RX i : %d : %02X\r\n", i, rx_buf[i]);
+        if(!bmi088_cs_low(cs)){
+            return bmi088_spi_status(HAL_BUSY);
         }
-        */
 
-        HAL_GPIO_WritePin(cs->port, cs->pin, GPIO_PIN_SET);
+        status = bmi088_spi_xfer(&addr, NULL, 1);
+        if(status == HAL_OK){
+            status = bmi088_spi_xfer(NULL, reg_data, (uint16_t)len);
+        }
 
-        if(status != HAL_OK) return BMI08_E_COM_FAIL;
+        bmi088_cs_high(cs);
 
-        for(uint32_t i = 0; i < len; i++){
-            reg_data[i] = rx_buf[i + 1];
-        }
+        return bmi088_spi_status(status);
     }
-    else{
-        uint8_t tx_buf[256] = {0};
-        uint8_t rx_buf[256] = {0};
 
-        tx_buf[0] = reg_addr | 0x80;
+    spi_tx_scratch[0] = reg_addr | 0x80;
+
+    if(!bmi088_cs_low(cs)){
+        return bmi088_spi_status(HAL_BUSY);
+    }
 
-        status = HAL_SPI_TransmitReceive(bmi088_hspi, tx_buf, rx_buf, len + 1, HAL_MAX_DELAY);
+    status = bmi088_spi_xfer(spi_tx_scratch, spi_rx_scratch, (uint16_t)(len + 1));
 
-        HAL_GPIO_WritePin(cs->port, cs->pin, GPIO_PIN_SET);
+    bmi088_cs_high(cs);
 
-        if(status != HAL_OK) return BMI08_E_COM_FAIL;
+    if(bmi088_spi_status(status) != BMI08_OK) return BMI08_E_COM_FAIL;
 
-        for(uint32_t i = 0; i < len; i++){
-            reg_data[i] = rx_buf[i + 1];
-        }
-    }
+    memcpy(reg_data, &spi_rx_scratch[1], len);
 
     return BMI08_OK;
 }
@@ -96,87 +587,290 @@ static int8_t bmi088_spi_read(uint8_t reg_addr, uint8_t *reg_data, uint32_t len,
  * @param  reg_data Pointeur vers les données à écrire.
  * @param  len      Nombre d'octets à écrire.
  * @param  intf_ptr Pointeur vers l'interface matérielle (struct bmi088_cs_t).
- * @return BMI08_OK en cas de succès.
+ * @return BMI08_OK en cas de succès, ou code d'erreur (ex: BMI08_E_COM_FAIL).
  */
 static int8_t bmi088_spi_write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t len, void *intf_ptr){
+    if(reg_data == NULL || intf_ptr == NULL) return BMI08_E_NULL_PTR;
+    if(len == 0 || len > UINT16_MAX) return BMI08_E_RD_WR_LENGTH_INVALID;
+    if(dma_state != BMI088_DMA_IDLE) return BMI08_E_COM_FAIL;
+
     bmi088_cs_t *cs = (bmi088_cs_t*)intf_ptr;
+    HAL_StatusTypeDef status;
 
-    HAL_GPIO_WritePin(cs->port, cs->pin, GPIO_PIN_RESET);
+    if(!bmi088_cs_low(cs)){
+        return bmi088_spi_status(HAL_BUSY);
+    }
 
     uint8_t addr = reg_addr & 0x7F;
-    HAL_SPI_Transmit(bmi088_hspi, &addr, 1, HAL_MAX_DELAY);
-
-    HAL_SPI_Transmit(bmi088_hspi, (uint8_t*)reg_data, len, HAL_MAX_DELAY);
+    status = bmi088_spi_xfer(&addr, NULL, 1);
+    if(status == HAL_OK){
+        status = bmi088_spi_xfer(reg_data, NULL, (uint16_t)len);
+    }
 
-    HAL_GPIO_WritePin(cs->port, cs->pin, GPIO_PIN_SET);
+    bmi088_cs_high(cs);
 
-    return BMI08_OK;
+    return bmi088_spi_status(status);
 }
 
 /**
  * @brief  Fonction de délai microseconde pour l'interface Bosch.
- * @note   Utilise HAL_Delay (millisecondes), avec un minimum de 1ms.
+ * @note   Attente active sur le compteur TIM3 (résolution 1 µs).
  * @param  period   Durée du délai en microsecondes.
  * @param  intf_ptr Pointeur d'interface (inutilisé).
  */
 static void bmi088_delay_us(uint32_t period, void *intf_ptr){
-    uint32_t delay_ms = period / 1000;
-    if(delay_ms == 0) delay_ms = 1;
-    HAL_Delay(delay_ms);
+    Delay_us(period);
 }
 
 /**
- * @brief  Initialise le module BMI088 (Accéléromètre et Gyroscope).
- * @param  hspi Pointeur vers le handle SPI STM32.
- * @return BMI08_OK si l'initialisation réussit, code d'erreur sinon.
+ * @brief  Sélectionne les facteurs de conversion correspondant aux gammes configurées.
+ * @note   Appelée après chaque changement de gamme pour garder capteur et conversions cohérents.
  */
-int8_t BMI088_Init(SPI_HandleTypeDef *hspi){
-    if(hspi == NULL){
-        return BMI08_E_NULL_PTR;
+static void bmi088_update_scales(void){
+    uint8_t acc = bmi088_dev.accel_cfg.range;
+    uint8_t gyr = bmi088_dev.gyro_cfg.range;
+    const int32_t accel_prev = accel_scale_q12;
+    const int32_t gyro_prev  = gyro_scale_q4;
+
+    if(acc <= BMI088_ACCEL_RANGE_24G){
+        accel_scale_mms2 = accel_scale_mms2_table[acc];
+        accel_scale_q12  = accel_scale_q12_table[acc];
+    }
+
+    if(gyr <= BMI08_GYRO_RANGE_125_DPS){
+        gyro_scale_rads = gyro_scale_rads_table[gyr];
+        gyro_scale_q4   = gyro_scale_q4_table[gyr];
+    }
+
+    /* Les sommes brutes en cours ne sont plus homogènes avec la nouvelle gamme */
+    if(cal_state == BMI088_CAL_RUNNING && cal_count != 0u && (accel_scale_q12 != accel_prev || gyro_scale_q4 != gyro_prev)){
+        cal_state = BMI088_CAL_E_ABORTED;
+    }
+}
+
+/**
+ * @brief  Active des offsets pour toutes les conversions (virgule fixe et flottantes).
+ * @param  ofs Offsets à appliquer.
+ */
+static void bmi088_cal_apply(const bmi088_offsets_t *ofs){
+    cal_ofs = *ofs;
+
+    for(uint8_t i = 0; i < 3u; i++){
+        cal_accel_ofs_mms2[i] = (float)ofs->accel_mms2[i];
+        cal_gyro_ofs_rads[i]  = (float)ofs->gyro_urads[i] * 1e-6f;
+    }
+}
+
+/**
+ * @brief  Vérifie un enregistrement de calibration lu en flash.
+ * @param  rec Enregistrement.
+ * @return 1 si le marqueur et le CRC sont valides, 0 sinon.
+ */
+static uint8_t bmi088_cal_record_valid(const bmi088_cal_record_t *rec){
+    return (rec->magic == BMI088_CAL_MAGIC &&
+            rec->crc == crc8_compute((const uint8_t *)rec, offsetof(bmi088_cal_record_t, crc))) ? 1u : 0u;
+}
+
+/**
+ * @brief  Applique le dernier enregistrement de calibration valide de la flash.
+ * @return 1 si un enregistrement a été trouvé, 0 sinon (offsets nuls).
+ */
+static uint8_t bmi088_cal_load(void){
+    const bmi088_cal_record_t *last = NULL;
+    static const bmi088_offsets_t zero = { 0 };
+
+    for(uint32_t a = NV_FLASH_CALIB_START; a + sizeof(bmi088_cal_record_t) <= NV_FLASH_CALIB_END; a += sizeof(bmi088_cal_record_t)){
+        const bmi088_cal_record_t *rec = (const bmi088_cal_record_t *)a;
+
+        if(nv_flash_is_blank(a, sizeof(*rec))){
+            break;
+        }
+        if(bmi088_cal_record_valid(rec)){
+            last = rec;
+        }
+    }
+
+    bmi088_cal_apply((last != NULL) ? &last->ofs : &zero);
+    cal_stored = (last != NULL) ? 1u : 0u;
+
+    return cal_stored;
+}
+
+/**
+ * @brief  Ajoute un enregistrement de calibration à la page de flash.
+ * @details Écrit à la première place libre ; la page n'est effacée (bloquant,
+ * 40 ms au plus) que lorsqu'elle est pleine.
+ * @param  ofs Offsets à enregistrer.
+ * @return 0 si succès, code d'erreur nv_flash sinon.
+ */
+static int8_t bmi088_cal_save(const bmi088_offsets_t *ofs){
+    bmi088_cal_record_t rec = { .magic = BMI088_CAL_MAGIC, .ofs = *ofs };
+    uint32_t a = NV_FLASH_CALIB_START;
+
+    rec.crc = crc8_compute((const uint8_t *)&rec, offsetof(bmi088_cal_record_t, crc));
+
+    while(a + sizeof(rec) <= NV_FLASH_CALIB_END && !nv_flash_is_blank(a, sizeof(rec))){
+        a += sizeof(rec);
+    }
+
+    if(a + sizeof(rec) > NV_FLASH_CALIB_END){
+        const int8_t err = nv_flash_erase_page(NV_FLASH_CALIB_START);
+        if(err != 0){
+            return err;
+        }
+        a = NV_FLASH_CALIB_START;
+    }
+
+    return nv_flash_program(a, &rec, sizeof(rec));
+}
+
+/**
+ * @brief  Termine la calibration : contrôle d'immobilité, moyennes, application et enregistrement.
+ */
+static void bmi088_cal_finish(void){
+    bmi088_offsets_t ofs = cal_ofs;
+
+    for(uint8_t i = 0; i < 3u; i++){
+        const int32_t spread_urads = ((int32_t)(cal_gyro_max[i] - cal_gyro_min[i]) * gyro_scale_q4) >> GYRO_Q_SHIFT;
+
+        if(spread_urads > BMI088_CAL_GYRO_SPREAD_URADS){
+            cal_state = BMI088_CAL_E_MOTION;
+            return;
+        }
+    }
+
+    for(uint8_t i = 0; i < 3u; i++){
+        ofs.gyro_urads[i] = (int32_t)(((int64_t)cal_sum_gyro[i] * gyro_scale_q4) >> (GYRO_Q_SHIFT + BMI088_CAL_SAMPLES_SHIFT));
+        if(cal_req == BMI088_CAL_REQ_GYRO_ACCEL){
+            ofs.accel_mms2[i] = (int32_t)(((int64_t)cal_sum_accel[i] * accel_scale_q12) >> (ACCEL_Q_SHIFT + BMI088_CAL_SAMPLES_SHIFT));
+        }
+    }
+    if(cal_req == BMI088_CAL_REQ_GYRO_ACCEL){
+        ofs.accel_mms2[2] -= BMI088_CAL_G_MMS2;
     }
 
+    bmi088_cal_apply(&ofs);
+
+    if(bmi088_cal_save(&ofs) != 0){
+        cal_state = BMI088_CAL_E_FLASH;
+        return;
+    }
+
+    cal_stored = 1;
+    cal_state = BMI088_CAL_DONE;
+}
+
+/**
+ * @brief  Accumule un échantillon brut dans la calibration en cours.
+ * @details Les sommes portent sur les axes bruts, avant offsets : les moyennes
+ * donnent directement les nouveaux offsets, indépendamment des précédents.
+ * @param  s Échantillon retiré de la file.
+ */
+static void bmi088_cal_accumulate(const bmi088_raw_sample_t *s){
+    const int16_t g[3] = { s->gyro.x, s->gyro.y, s->gyro.z };
+
+    cal_sum_accel[0] += s->accel.x;
+    cal_sum_accel[1] += s->accel.y;
+    cal_sum_accel[2] += s->accel.z;
+
+    for(uint8_t i = 0; i < 3u; i++){
+        cal_sum_gyro[i] += g[i];
+        if(cal_count == 0u || g[i] < cal_gyro_min[i]) cal_gyro_min[i] = g[i];
+        if(cal_count == 0u || g[i] > cal_gyro_max[i]) cal_gyro_max[i] = g[i];
+    }
+
+    if(++cal_count >= BMI088_CAL_SAMPLES){
+        bmi088_cal_finish();
+    }
+}
+
+/**
+ * @brief  Démarre le moyennage d'une calibration.
+ * @param  req BMI088_CAL_REQ_GYRO ou BMI088_CAL_REQ_GYRO_ACCEL.
+ */
+static void bmi088_cal_begin(uint8_t req){
+    memset(cal_sum_accel, 0, sizeof(cal_sum_accel));
+    memset(cal_sum_gyro, 0, sizeof(cal_sum_gyro));
+    cal_count = 0;
+    cal_req = req;
+    cal_state = BMI088_CAL_RUNNING;
+}
+
+/**
+ * @brief  Charge la calibration enregistrée au démarrage du driver.
+ * @note   Sans enregistrement valide et avec BMI088_CAL_AT_BOOT, une calibration du
+ * gyroscope démarre sur les premiers échantillons acquis.
+ */
+static void bmi088_cal_boot(void){
+    if(!bmi088_cal_load() && BMI088_CAL_AT_BOOT){
+        bmi088_cal_begin(BMI088_CAL_REQ_GYRO);
+    }
+}
+
+/**
+ * @brief  Relie le driver au bus SPI et renseigne l'interface Bosch.
+ * @param  hspi Pointeur vers le handle SPI STM32.
+ */
+static void bmi088_dev_setup(SPI_HandleTypeDef *hspi){
     bmi088_hspi = hspi;
 
     HAL_GPIO_WritePin(BMI088_CS_ACC_GPIO_Port, BMI088_CS_ACC_Pin, GPIO_PIN_SET);
     HAL_GPIO_WritePin(BMI088_CS_GYRO_GPIO_Port, BMI088_CS_GYRO_Pin, GPIO_PIN_SET);
 
+    /* Le gyroscope passe devant : il termine une séquence déjà commencée */
+    if(bus_dev_accel == SPI_BUS_DEV_NONE){
+        bus_dev_accel = spi_bus_add_device(cs_accel.port, cs_accel.pin, BMI088_SPI_BUS_PRIO + 1u);
+        bus_dev_gyro  = spi_bus_add_device(cs_gyro.port, cs_gyro.pin, BMI088_SPI_BUS_PRIO);
+    }
+
     bmi088_dev.intf = BMI08_SPI_INTF;
     bmi088_dev.read = bmi088_spi_read;
     bmi088_dev.write = bmi088_spi_write;
     bmi088_dev.delay_us = bmi088_delay_us;
     bmi088_dev.intf_ptr_accel = &cs_accel;
     bmi088_dev.intf_ptr_gyro = &cs_gyro;
+    bmi088_dev.variant = BMI088_VARIANT;
+}
 
-    int8_t rslt_accel = bmi08a_init(&bmi088_dev);
+/**
+ * @brief  Charge la configuration de mesure par défaut (±6 g 100 Hz, ±1000 dps 200 Hz).
+ */
+static void bmi088_default_config(void){
+    bmi088_dev.accel_cfg.odr   = BMI08_ACCEL_ODR_100_HZ;
+    bmi088_dev.accel_cfg.range = BMI088_ACCEL_RANGE_6G;
+    bmi088_dev.accel_cfg.bw    = BMI08_ACCEL_BW_NORMAL;
+    bmi088_dev.accel_cfg.power = BMI08_ACCEL_PM_ACTIVE;
 
-#ifdef DEBUG
-    //printf("BMI088 Init Accel: %d (0=OK)\r\n", rslt_accel);
-    //printf("Accel Chip ID: 0x%02X (attendu: 0x1E)\r\n", bmi088_dev.accel_chip_id);
-#endif
+    bmi088_dev.gyro_cfg.odr   = BMI08_GYRO_BW_23_ODR_200_HZ;
+    bmi088_dev.gyro_cfg.range = BMI08_GYRO_RANGE_1000_DPS;
+    bmi088_dev.gyro_cfg.bw    = BMI08_GYRO_BW_23_ODR_200_HZ;
+    bmi088_dev.gyro_cfg.power = BMI08_GYRO_PM_NORMAL;
+}
 
-    int8_t rslt_gyro = bmi08g_init(&bmi088_dev);
+/**
+ * @brief  Initialise le module BMI088 (Accéléromètre et Gyroscope).
+ * @note   Bloquant (délais Bosch, ~100 ms) ; le démarrage applicatif utilise BMI088_Init_Async().
+ * @param  hspi Pointeur vers le handle SPI STM32.
+ * @return BMI08_OK si l'initialisation réussit, code d'erreur sinon.
+ */
+int8_t BMI088_Init(SPI_HandleTypeDef *hspi){
+    if(hspi == NULL){
+        return BMI08_E_NULL_PTR;
+    }
 
-#ifdef DEBUG
-    //printf("BMI088 Init Gyro: %d (0=OK)\r\n", rslt_gyro);
-    //printf("Gyro Chip ID: 0x%02X (attendu: 0x0F)\r\n", bmi088_dev.gyro_chip_id);
-#endif
+    bmi088_dev_setup(hspi);
+
+    int8_t rslt_accel = bmi08a_init(&bmi088_dev);
+    int8_t rslt_gyro = bmi08g_init(&bmi088_dev);
 
     if(rslt_accel != BMI08_OK || rslt_gyro != BMI08_OK){
         return BMI08_E_DEV_NOT_FOUND;
     }
 
-    bmi088_dev.accel_cfg.odr   = BMI08_ACCEL_ODR_100_HZ;
-    bmi088_dev.accel_cfg.range = BMI088_ACCEL_RANGE_6G;
-    bmi088_dev.accel_cfg.bw    = BMI08_ACCEL_BW_NORMAL;
-    bmi088_dev.accel_cfg.power = BMI08_ACCEL_PM_ACTIVE;
+    bmi088_default_config();
 
     rslt_accel  = bmi08a_set_power_mode(&bmi088_dev);
-    rslt_accel |= bmi08a_set_meas_conf(&bmi088_dev);
-
-    bmi088_dev.gyro_cfg.odr   = BMI08_GYRO_BW_23_ODR_200_HZ;
-    bmi088_dev.gyro_cfg.range = BMI08_GYRO_RANGE_1000_DPS;
-    bmi088_dev.gyro_cfg.bw    = BMI08_GYRO_BW_23_ODR_200_HZ;
-    bmi088_dev.gyro_cfg.power = BMI08_GYRO_PM_NORMAL;
+    rslt_accel |= bmi08xa_set_meas_conf(&bmi088_dev);
 
     rslt_gyro  = bmi08g_set_power_mode(&bmi088_dev);
     rslt_gyro |= bmi08g_set_meas_conf(&bmi088_dev);
@@ -185,13 +879,47 @@ int8_t BMI088_Init(SPI_HandleTypeDef *hspi){
         return BMI08_E_COM_FAIL;
     }
 
-#ifdef DEBUG
-    //printf("BMI088 initialisé avec succès!\r\n");
-#endif
+    bmi088_update_scales();
+    bmi088_cal_boot();
+
+    return BMI08_OK;
+}
+
+/**
+ * @brief  Lance l'initialisation du BMI088 sans bloquer.
+ * @details Soft reset des deux capteurs, initialisation Bosch puis configuration par
+ * défaut, déroulés étape par étape par BMI088_Bus_Poll() : les délais de redémarrage
+ * et de configuration des capteurs deviennent des échéances de l'ordonnanceur.
+ * Le reset logiciel remet les capteurs dans un état connu après un reset du seul
+ * microcontrôleur (brown-out, chien de garde), où l'IMU a gardé sa configuration.
+ * @param  hspi Pointeur vers le handle SPI STM32.
+ * @return BMI08_OK si la séquence est lancée, BMI08_E_NULL_PTR sinon.
+ */
+int8_t BMI088_Init_Async(SPI_HandleTypeDef *hspi){
+    if(hspi == NULL){
+        return BMI08_E_NULL_PTR;
+    }
+
+    bmi088_dev_setup(hspi);
+    bmi088_default_config();
+    bmi088_update_scales();
+    bmi088_cal_boot();
+
+    bus_booting = 1;
+    PT_INIT(&bus_pt);
+    bus_state = BMI088_BUS_ACCEL_RESET;
 
     return BMI08_OK;
 }
 
+/**
+ * @brief  Indique si les capteurs sont initialisés et le bus opérationnel.
+ * @return 1 si prêt, 0 pendant le démarrage ou une récupération.
+ */
+uint8_t BMI088_Ready(void){
+    return (bmi088_hspi != NULL && bus_state == BMI088_BUS_OK) ? 1u : 0u;
+}
+
 /**
  * @brief  Lit les données brutes de l'accéléromètre.
  * @param  accel_data Pointeur vers la structure de destination des données brutes.
@@ -219,36 +947,116 @@ int8_t BMI088_Read_Gyro_Raw(struct bmi08_sensor_data *gyro_data){
 }
 
 /**
- * @brief  Lit et convertit l'ensemble des données IMU (Accel + Gyro).
- * @param  data Pointeur vers la structure de données utilisateur (unités physiques).
- * @return BMI08_OK en cas de succès, ou code d'erreur.
+ * @brief  Lecture rafale d'un bloc de registres, hors couche Bosch.
+ * @details Un seul front de Chip Select par capteur.
+ * Le résultat est laissé dans `spi_rx_scratch` (octet 0 = écho de l'adresse).
+ * @param  cs       Chip Select du capteur ciblé.
+ * @param  reg_addr Adresse du premier registre.
+ * @param  len      Longueur totale de la transaction (adresse incluse).
+ * @return BMI08_OK ou BMI08_E_COM_FAIL.
  */
-int8_t BMI088_Read_All(bmi088_data_t *data){
-    if(data == NULL){
-        return BMI08_E_NULL_PTR;
-    }
+static int8_t bmi088_burst_read(const bmi088_cs_t *cs, uint8_t reg_addr, uint16_t len){
+    spi_tx_scratch[0] = reg_addr | 0x80;
 
-    struct bmi08_sensor_data accel_raw, gyro_raw;
-
-    int8_t rslt = BMI088_Read_Accel_Raw(&accel_raw);
-    if(rslt != BMI08_OK){
-        return rslt;
+    if(!bmi088_cs_low(cs)){
+        return bmi088_spi_status(HAL_BUSY);
     }
+    HAL_StatusTypeDef status = bmi088_spi_xfer(spi_tx_scratch, spi_rx_scratch, len);
+    bmi088_cs_high(cs);
 
-    rslt = BMI088_Read_Gyro_Raw(&gyro_raw);
-    if(rslt != BMI08_OK){
-        return rslt;
-    }
+    return bmi088_spi_status(status);
+}
+
+/**
+ * @brief  Reconstruit trois entiers signés à partir de 6 octets little-endian.
+ * @param  buf Pointeur vers le premier octet (X LSB).
+ * @param  out Tableau de sortie [X, Y, Z].
+ */
+static void bmi088_unpack_i16x3(const uint8_t *buf, int16_t *out){
+    out[0] = (int16_t)((uint16_t)buf[0] | ((uint16_t)buf[1] << 8));
+    out[1] = (int16_t)((uint16_t)buf[2] | ((uint16_t)buf[3] << 8));
+    out[2] = (int16_t)((uint16_t)buf[4] | ((uint16_t)buf[5] << 8));
+}
+
+/**
+ * @brief  Lecture rapide des registres de données accéléromètre et gyroscope.
+ * @details Lit ACC 0x12..0x17 (précédés de l'octet vide) puis GYR 0x02..0x07
+ * en une transaction par capteur, sans passer par bmi08a_get_data()/bmi08g_get_data().
+ * La couche Bosch reste utilisée pour la configuration.
+ * @param  raw Structure de sortie (valeurs brutes).
+ * @return BMI08_OK, BMI08_E_NULL_PTR, BMI088_E_BUSY (récupération du bus en cours)
+ * ou BMI08_E_COM_FAIL (bus occupé par le DMA ou erreur SPI).
+ */
+int8_t BMI088_Read_Raw_Fast(bmi088_raw_t *raw){
+    if(raw == NULL){
+        return BMI08_E_NULL_PTR;
+    }
+
+    if(bus_state != BMI088_BUS_OK || st_hold){
+        return BMI088_E_BUSY;
+    }
+
+    if(dma_state != BMI088_DMA_IDLE){
+        return BMI08_E_COM_FAIL;
+    }
+
+    int8_t rslt = bmi088_burst_read(&cs_accel, BMI08_REG_ACCEL_X_LSB, BMI088_ACCEL_XYZ_LEN);
+    if(rslt != BMI08_OK){
+        return rslt;
+    }
+    bmi088_unpack_i16x3(&spi_rx_scratch[2], raw->accel);
+
+    rslt = bmi088_burst_read(&cs_gyro, BMI08_REG_GYRO_X_LSB, BMI088_DMA_GYRO_LEN);
+    if(rslt != BMI08_OK){
+        return rslt;
+    }
+    bmi088_unpack_i16x3(&spi_rx_scratch[1], raw->gyro);
+
+    return BMI08_OK;
+}
+
+/**
+ * @brief  Lit et convertit l'ensemble des données IMU (Accel + Gyro).
+ * @note   L'échantillon est daté avant la première lecture SPI, au plus près de l'acquisition.
+ * @param  data Pointeur vers la structure de données utilisateur (unités physiques).
+ * @return BMI08_OK en cas de succès, ou code d'erreur.
+ */
+int8_t BMI088_Read_All(bmi088_data_t *data){
+    if(data == NULL){
+        return BMI08_E_NULL_PTR;
+    }
+
+    const uint64_t t_us = GetMicros64();
+    bmi088_raw_t raw;
+    int8_t rslt;
+
+    if(data_sync_mode != BMI08_ACCEL_DATA_SYNC_MODE_OFF){
+        struct bmi08_sensor_data accel_raw, gyro_raw;
+
+        rslt = bmi08a_get_synchronized_data(&accel_raw, &gyro_raw, &bmi088_dev);
+        if(rslt != BMI08_OK){
+            return rslt;
+        }
 
-    data->accel_x_mms2 = ((float)accel_raw.x / ACCEL_RANGE_6G_LSB) * G_TO_MM_S2;
-    data->accel_y_mms2 = ((float)accel_raw.y / ACCEL_RANGE_6G_LSB) * G_TO_MM_S2;
-    data->accel_z_mms2 = ((float)accel_raw.z / ACCEL_RANGE_6G_LSB) * G_TO_MM_S2;
+        raw.accel[0] = accel_raw.x; raw.accel[1] = accel_raw.y; raw.accel[2] = accel_raw.z;
+        raw.gyro[0]  = gyro_raw.x;  raw.gyro[1]  = gyro_raw.y;  raw.gyro[2]  = gyro_raw.z;
+    }
+    else{
+        rslt = BMI088_Read_Raw_Fast(&raw);
+        if(rslt != BMI08_OK){
+            return rslt;
+        }
+    }
 
-    data->gyro_x_rads = ((float)gyro_raw.x / GYRO_RANGE_1000DPS_LSB) * DEG_TO_RAD;
-    data->gyro_y_rads = ((float)gyro_raw.y / GYRO_RANGE_1000DPS_LSB) * DEG_TO_RAD;
-    data->gyro_z_rads = ((float)gyro_raw.z / GYRO_RANGE_1000DPS_LSB) * DEG_TO_RAD;
+    data->accel_x_mms2 = (float)raw.accel[0] * accel_scale_mms2 - cal_accel_ofs_mms2[0];
+    data->accel_y_mms2 = (float)raw.accel[1] * accel_scale_mms2 - cal_accel_ofs_mms2[1];
+    data->accel_z_mms2 = (float)raw.accel[2] * accel_scale_mms2 - cal_accel_ofs_mms2[2];
 
-    data->timestamp_ms = HAL_GetTick();
+    data->gyro_x_rads = (float)raw.gyro[0] * gyro_scale_rads - cal_gyro_ofs_rads[0];
+    data->gyro_y_rads = (float)raw.gyro[1] * gyro_scale_rads - cal_gyro_ofs_rads[1];
+    data->gyro_z_rads = (float)raw.gyro[2] * gyro_scale_rads - cal_gyro_ofs_rads[2];
+
+    data->timestamp_us = t_us;
 
     return BMI08_OK;
 }
@@ -263,9 +1071,9 @@ void BMI088_Convert_Accel(struct bmi08_sensor_data *accel_raw, float *accel_mms2
         return;
     }
 
-    accel_mms2[0] = ((float)accel_raw->x / ACCEL_RANGE_6G_LSB) * G_TO_MM_S2;
-    accel_mms2[1] = ((float)accel_raw->y / ACCEL_RANGE_6G_LSB) * G_TO_MM_S2;
-    accel_mms2[2] = ((float)accel_raw->z / ACCEL_RANGE_6G_LSB) * G_TO_MM_S2;
+    accel_mms2[0] = (float)accel_raw->x * accel_scale_mms2 - cal_accel_ofs_mms2[0];
+    accel_mms2[1] = (float)accel_raw->y * accel_scale_mms2 - cal_accel_ofs_mms2[1];
+    accel_mms2[2] = (float)accel_raw->z * accel_scale_mms2 - cal_accel_ofs_mms2[2];
 }
 
 /**
@@ -278,9 +1086,48 @@ void BMI088_Convert_Gyro(struct bmi08_sensor_data *gyro_raw, float *gyro_rads){
         return;
     }
 
-    gyro_rads[0] = ((float)gyro_raw->x / GYRO_RANGE_1000DPS_LSB) * DEG_TO_RAD;
-    gyro_rads[1] = ((float)gyro_raw->y / GYRO_RANGE_1000DPS_LSB) * DEG_TO_RAD;
-    gyro_rads[2] = ((float)gyro_raw->z / GYRO_RANGE_1000DPS_LSB) * DEG_TO_RAD;
+    gyro_rads[0] = (float)gyro_raw->x * gyro_scale_rads - cal_gyro_ofs_rads[0];
+    gyro_rads[1] = (float)gyro_raw->y * gyro_scale_rads - cal_gyro_ofs_rads[1];
+    gyro_rads[2] = (float)gyro_raw->z * gyro_scale_rads - cal_gyro_ofs_rads[2];
+}
+
+/**
+ * @brief  Convertit les données brutes d'accélération en mm/s² sans flottant.
+ * @details Une multiplication entière 32 bits par axe avec le facteur Q12
+ * précalculé : |raw| * facteur reste < 2^31 pour toutes les gammes. L'offset
+ * calibré est soustrait au résultat.
+ * @param  accel_raw  Pointeur vers les données brutes d'entrée.
+ * @param  accel_mms2 Pointeur vers le tableau de sortie (x, y, z) en mm/s².
+ */
+void BMI088_Convert_Accel_Fx(const struct bmi08_sensor_data *accel_raw, int32_t *accel_mms2){
+    if(accel_raw == NULL || accel_mms2 == NULL){
+        return;
+    }
+
+    const int32_t round = 1 << (ACCEL_Q_SHIFT - 1);
+
+    accel_mms2[0] = (((int32_t)accel_raw->x * accel_scale_q12 + round) >> ACCEL_Q_SHIFT) - cal_ofs.accel_mms2[0];
+    accel_mms2[1] = (((int32_t)accel_raw->y * accel_scale_q12 + round) >> ACCEL_Q_SHIFT) - cal_ofs.accel_mms2[1];
+    accel_mms2[2] = (((int32_t)accel_raw->z * accel_scale_q12 + round) >> ACCEL_Q_SHIFT) - cal_ofs.accel_mms2[2];
+}
+
+/**
+ * @brief  Convertit les données brutes gyroscopiques en µrad/s sans flottant.
+ * @details Une multiplication entière 32 bits par axe avec le facteur Q4 précalculé,
+ * puis soustraction du biais calibré.
+ * @param  gyro_raw   Pointeur vers les données brutes d'entrée.
+ * @param  gyro_urads Pointeur vers le tableau de sortie (x, y, z) en µrad/s.
+ */
+void BMI088_Convert_Gyro_Fx(const struct bmi08_sensor_data *gyro_raw, int32_t *gyro_urads){
+    if(gyro_raw == NULL || gyro_urads == NULL){
+        return;
+    }
+
+    const int32_t round = 1 << (GYRO_Q_SHIFT - 1);
+
+    gyro_urads[0] = (((int32_t)gyro_raw->x * gyro_scale_q4 + round) >> GYRO_Q_SHIFT) - cal_ofs.gyro_urads[0];
+    gyro_urads[1] = (((int32_t)gyro_raw->y * gyro_scale_q4 + round) >> GYRO_Q_SHIFT) - cal_ofs.gyro_urads[1];
+    gyro_urads[2] = (((int32_t)gyro_raw->z * gyro_scale_q4 + round) >> GYRO_Q_SHIFT) - cal_ofs.gyro_urads[2];
 }
 
 /**
@@ -293,33 +1140,1953 @@ uint8_t BMI088_Test_Communication(uint8_t print_result){
     uint8_t gyro_ok = (bmi088_dev.gyro_chip_id == BMI08_GYRO_CHIP_ID);
 
     if(print_result){
-
-    	/*
-    	printf("=== BMI088 Communication Test ===\r\n");
-        printf("Accelerometer: %s (ID: 0x%02X)\r\n",
-               accel_ok ? "OK" : "FAIL", bmi088_dev.accel_chip_id);
-        printf("Gyroscope: %s (ID: 0x%02X)\r\n",
-               gyro_ok ? "OK" : "FAIL", bmi088_dev.gyro_chip_id);
-        printf("================================\r\n");
-    	*/
+        dbg_puts("=== BMI088 Communication Test ===\r\nAccelerometer: ");
+        dbg_puts(accel_ok ? "OK" : "FAIL");
+        dbg_puts(" (ID: 0x");
+        dbg_put_hex(bmi088_dev.accel_chip_id, 2);
+        dbg_puts(")\r\nGyroscope: ");
+        dbg_puts(gyro_ok ? "OK" : "FAIL");
+        dbg_puts(" (ID: 0x");
+        dbg_put_hex(bmi088_dev.gyro_chip_id, 2);
+        dbg_puts(")\r\n================================\r\n");
     }
 
     return (accel_ok && gyro_ok);
 }
 
+/**
+ * @brief  Envoie la commande de soft reset à un capteur, sans attendre son redémarrage.
+ * @param  cs       Chip Select du capteur ciblé.
+ * @param  reg_addr Registre SOFTRESET du capteur.
+ * @return BMI08_OK ou code d'erreur SPI.
+ */
+static int8_t bmi088_soft_reset_sensor(bmi088_cs_t *cs, uint8_t reg_addr){
+    const uint8_t soft_reset_cmd = BMI08_SOFT_RESET_CMD;
+
+    return bmi088_spi_write(reg_addr, &soft_reset_cmd, 1, cs);
+}
+
 /**
  * @brief  Effectue une réinitialisation logicielle (Soft Reset) des capteurs.
  * @return BMI08_OK en cas de succès, ou code d'erreur SPI.
  */
 int8_t BMI088_Soft_Reset(void){
-    uint8_t soft_reset_cmd = BMI08_SOFT_RESET_CMD;
-    int8_t rslt = bmi088_spi_write(BMI08_REG_ACCEL_SOFTRESET, &soft_reset_cmd, 1, &cs_accel);
+    int8_t rslt = bmi088_soft_reset_sensor(&cs_accel, BMI08_REG_ACCEL_SOFTRESET);
 
-    HAL_Delay(50);
+    Delay_us(BMI088_ACCEL_RESET_DELAY_US);
 
-    rslt |= bmi088_spi_write(BMI08_REG_GYRO_SOFTRESET, &soft_reset_cmd, 1, &cs_gyro);
+    rslt |= bmi088_soft_reset_sensor(&cs_gyro, BMI08_REG_GYRO_SOFTRESET);
 
-    HAL_Delay(50);
+    Delay_us(BMI088_GYRO_RESET_DELAY_US);
 
     return rslt;
 }
+
+/**
+ * @brief  Reconstruit un triplet X/Y/Z signé à partir de 6 octets little-endian.
+ * @param  buf  Pointeur vers le premier octet de données (X LSB).
+ * @param  out  Structure de sortie.
+ */
+static void bmi088_unpack_xyz(const uint8_t *buf, struct bmi08_sensor_data *out){
+    out->x = (int16_t)((uint16_t)buf[0] | ((uint16_t)buf[1] << 8));
+    out->y = (int16_t)((uint16_t)buf[2] | ((uint16_t)buf[3] << 8));
+    out->z = (int16_t)((uint16_t)buf[4] | ((uint16_t)buf[5] << 8));
+}
+
+/**
+ * @brief  Reconstruit l'horloge capteur 24 bits (SENSORTIME_0..2, little-endian).
+ * @param  buf Pointeur vers SENSORTIME_0.
+ * @return Horloge capteur.
+ */
+static uint32_t bmi088_unpack_u24(const uint8_t *buf){
+    return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16);
+}
+
+/**
+ * @brief  Convertit TEMP_MSB/TEMP_LSB en centièmes de °C.
+ * @details Entier signé 11 bits, 0,125 °C/LSB, 0 = 23 °C (même calcul que
+ * bmi08a_get_sensor_temperature, sans lecture SPI supplémentaire).
+ * @param  buf Pointeur vers TEMP_MSB.
+ * @return Température (c°C).
+ */
+static int16_t bmi088_unpack_temp(const uint8_t *buf){
+    int32_t t = (int32_t)(((uint32_t)buf[0] << 3) | ((uint32_t)buf[1] >> 5));
+
+    if(t > 1023){
+        t -= 2048;
+    }
+    return (int16_t)((t * 25) / 2 + 2300);
+}
+
+/**
+ * @brief  Convertit un échantillon brut en unités physiques.
+ * @param  raw  Échantillon brut.
+ * @param  data Structure de sortie.
+ */
+static void bmi088_raw_to_data(const bmi088_raw_sample_t *raw, bmi088_data_t *data){
+    data->accel_x_mms2 = (float)raw->accel.x * accel_scale_mms2 - cal_accel_ofs_mms2[0];
+    data->accel_y_mms2 = (float)raw->accel.y * accel_scale_mms2 - cal_accel_ofs_mms2[1];
+    data->accel_z_mms2 = (float)raw->accel.z * accel_scale_mms2 - cal_accel_ofs_mms2[2];
+
+    data->gyro_x_rads = (float)raw->gyro.x * gyro_scale_rads - cal_gyro_ofs_rads[0];
+    data->gyro_y_rads = (float)raw->gyro.y * gyro_scale_rads - cal_gyro_ofs_rads[1];
+    data->gyro_z_rads = (float)raw->gyro.z * gyro_scale_rads - cal_gyro_ofs_rads[2];
+
+    data->timestamp_us = raw->timestamp_us;
+}
+
+/**
+ * @brief  Ajoute un échantillon dans la file SPSC (contexte interruption).
+ * @note   File pleine : l'échantillon le plus récent est perdu et comptabilisé.
+ * @param  raw Échantillon à publier.
+ */
+static void bmi088_queue_push(const bmi088_raw_sample_t *raw){
+    uint8_t head = queue_head;
+    uint8_t next = (uint8_t)((head + 1u) & (BMI088_SAMPLE_QUEUE_LEN - 1u));
+
+    if(next == queue_tail){
+        queue_dropped++;
+        return;
+    }
+
+    sample_queue[head] = *raw;
+    __DMB();
+    queue_head = next;
+}
+
+/**
+ * @brief  Recopie un échantillon de la file au format brut compact.
+ * @param  sample Échantillon de la file.
+ * @param  raw    Échantillon brut de sortie (LSB).
+ */
+static void bmi088_sample_to_raw(const bmi088_raw_sample_t *sample, bmi088_raw_t *raw){
+    raw->accel[0] = sample->accel.x;
+    raw->accel[1] = sample->accel.y;
+    raw->accel[2] = sample->accel.z;
+    raw->gyro[0]  = sample->gyro.x;
+    raw->gyro[1]  = sample->gyro.y;
+    raw->gyro[2]  = sample->gyro.z;
+}
+
+/**
+ * @brief  Retire le plus ancien échantillon brut de la file SPSC.
+ * @details Une calibration en cours accumule chaque échantillon retiré, et les
+ * observateurs éventuels le reçoivent, brut (BMI088_Set_Raw_Hook) puis converti en
+ * virgule fixe (BMI088_Set_Sample_Hook) : tous voient toute la file, dans l'ordre,
+ * quel que soit le mode de retrait. Le filtre éventuel (BMI088_Set_Filter_Hook)
+ * remplace ensuite l'échantillon retourné par sa valeur filtrée.
+ * @param  raw Échantillon de sortie.
+ * @return 1 si un échantillon a été retiré, 0 si la file est vide.
+ */
+static uint8_t bmi088_queue_pop_raw(bmi088_raw_sample_t *raw){
+    uint8_t tail = queue_tail;
+
+    if(tail == queue_head){
+        return 0;
+    }
+
+    __DMB();
+    *raw = sample_queue[tail];
+    __DMB();
+    queue_tail = (uint8_t)((tail + 1u) & (BMI088_SAMPLE_QUEUE_LEN - 1u));
+
+    if(cal_state == BMI088_CAL_RUNNING){
+        bmi088_cal_accumulate(raw);
+    }
+
+    if(raw_hook != NULL){
+        bmi088_raw_t r;
+
+        bmi088_sample_to_raw(raw, &r);
+        raw_hook(&r, raw->timestamp_us);
+    }
+
+    if(sample_hook != NULL){
+        bmi088_data_fx_t fx;
+
+        BMI088_Convert_Accel_Fx(&raw->accel, fx.accel_mms2);
+        BMI088_Convert_Gyro_Fx(&raw->gyro, fx.gyro_urads);
+        fx.timestamp_us = raw->timestamp_us;
+        fx.sensor_time  = raw->sensor_time;
+        sample_hook(&fx);
+    }
+
+    if(filter_hook != NULL){
+        bmi088_raw_t r;
+
+        bmi088_sample_to_raw(raw, &r);
+        filter_hook(&r, raw->timestamp_us);
+        raw->accel.x = r.accel[0];
+        raw->accel.y = r.accel[1];
+        raw->accel.z = r.accel[2];
+        raw->gyro.x  = r.gyro[0];
+        raw->gyro.y  = r.gyro[1];
+        raw->gyro.z  = r.gyro[2];
+    }
+
+    return 1;
+}
+
+static void bmi088_dma_done(void *ctx, int8_t status);
+
+/**
+ * @brief  Soumet une transaction DMA de lecture à l'ordonnanceur du bus SPI.
+ * @param  dev      Périphérique spi_bus du capteur ciblé.
+ * @param  reg_addr Adresse du premier registre à lire.
+ * @param  len      Longueur totale de la transaction (adresse incluse).
+ * @return BMI08_OK si la transaction est acceptée, BMI08_E_COM_FAIL sinon.
+ */
+static int8_t bmi088_dma_start(uint8_t dev, uint8_t reg_addr, uint16_t len){
+    const spi_bus_xfer_t xfer = {
+        .tx   = dma_tx_buf,
+        .rx   = dma_rx_buf,
+        .len  = len,
+        .done = bmi088_dma_done,
+        .ctx  = NULL
+    };
+
+    dma_tx_buf[0] = reg_addr | 0x80;
+
+    return spi_bus_submit(dev, &xfer) ? BMI08_OK : BMI08_E_COM_FAIL;
+}
+
+/**
+ * @brief  Lance une acquisition asynchrone Accéléromètre + Gyroscope.
+ * @details La lecture accéléromètre est démarrée immédiatement ; la lecture
+ * gyroscope est enchaînée depuis la fin de transaction (spi_bus). L'échantillon est
+ * disponible via BMI088_Get_Sample une fois la séquence terminée.
+ * @return BMI08_OK si la séquence est lancée, BMI088_E_BUSY si une acquisition
+ * ou une récupération du bus est en cours, ou code d'erreur.
+ */
+int8_t BMI088_Start_Read_DMA(void){
+    int8_t rslt;
+
+    if(bmi088_hspi == NULL){
+        return BMI08_E_NULL_PTR;
+    }
+
+    if(dma_state != BMI088_DMA_IDLE || bus_state != BMI088_BUS_OK || st_hold || inject_mode){
+        return BMI088_E_BUSY;
+    }
+
+    dma_state = BMI088_DMA_ACCEL;
+    dma_start_ms = HAL_GetTick();
+    dma_stage.timestamp_us = GetMicros64();   // Datation au déclenchement (data-ready)
+
+    if(data_sync_mode != BMI08_ACCEL_DATA_SYNC_MODE_OFF){
+        dma_accel_len = BMI088_DMA_SYNC_LEN;
+        rslt = bmi088_dma_start(bus_dev_accel, BMI08_REG_ACCEL_SENSORTIME_0, BMI088_DMA_SYNC_LEN);
+    }
+    else{
+        if(++temp_phase >= BMI088_TEMP_EVERY || temp_cdeg == BMI088_TEMP_UNKNOWN){
+            temp_phase = 0;
+            dma_accel_len = BMI088_DMA_ACCEL_TEMP_LEN;
+        }
+        else{
+            dma_accel_len = BMI088_DMA_ACCEL_LEN;
+        }
+        rslt = bmi088_dma_start(bus_dev_accel, BMI08_REG_ACCEL_X_LSB, dma_accel_len);
+    }
+
+    if(rslt != BMI08_OK){
+        dma_state = BMI088_DMA_IDLE;
+        return BMI08_E_COM_FAIL;
+    }
+
+    return BMI08_OK;
+}
+
+/**
+ * @brief  Récupère le dernier échantillon publié par la séquence DMA.
+ * @details Convertit l'échantillon brut en unités physiques. Chaque échantillon
+ * n'est rendu qu'une seule fois.
+ * @param  data Pointeur vers la structure de sortie (unités physiques).
+ * @return 1 si un nouvel échantillon a été copié, 0 sinon.
+ */
+uint8_t BMI088_Get_Sample(bmi088_data_t *data){
+    if(data == NULL){
+        return 0;
+    }
+
+    bmi088_raw_sample_t raw;
+    uint32_t seq;
+
+    do{
+        seq = seqlock_read_begin(&dma_lock);
+        raw = dma_pub;
+    }
+    while(seqlock_read_retry(&dma_lock, seq));
+
+    if(seq == dma_seq_read){
+        return 0;
+    }
+
+    dma_seq_read = seq;
+
+    bmi088_raw_to_data(&raw, data);
+
+    return 1;
+}
+
+/**
+ * @brief  Lit le dernier échantillon publié, sans le consommer.
+ * @details Copie de l'échantillon publié, recommencée si une séquence DMA se
+ * termine pendant la copie (seqlock_read_retry) : sans état côté lecteur, plusieurs consommateurs
+ * de la boucle principale peuvent l'appeler sans accès SPI ni retrait de la file.
+ * @param  data Pointeur vers la structure de sortie (mm/s², µrad/s).
+ * @return Numéro de l'échantillon (incrémenté à chaque publication), 0 si aucun.
+ */
+uint32_t BMI088_Get_Latest_Fx(bmi088_data_fx_t *data){
+    bmi088_raw_sample_t raw;
+    uint32_t seq;
+
+    if(data == NULL){
+        return 0;
+    }
+
+    do{
+        seq = seqlock_read_begin(&dma_lock);
+        raw = dma_pub;
+    }
+    while(seqlock_read_retry(&dma_lock, seq));
+
+    if(seq == 0){
+        return 0;
+    }
+
+    BMI088_Convert_Accel_Fx(&raw.accel, data->accel_mms2);
+    BMI088_Convert_Gyro_Fx(&raw.gyro, data->gyro_urads);
+    data->timestamp_us = raw.timestamp_us;
+    data->sensor_time  = raw.sensor_time;
+
+    return seqlock_count(seq);
+}
+
+/**
+ * @brief  Dernière température lue par les acquisitions DMA.
+ * @return Température (centièmes de °C), BMI088_TEMP_UNKNOWN avant la première lecture.
+ */
+int16_t BMI088_Temperature_cdeg(void){
+    return temp_cdeg;
+}
+
+/**
+ * @brief  Retire le plus ancien échantillon de la file d'acquisition.
+ * @details Chaque séquence DMA terminée (déclenchée par data-ready ou par
+ * BMI088_Start_Read_DMA) est ajoutée à la file, dans l'ordre d'acquisition.
+ * @param  data Pointeur vers la structure de sortie (unités physiques).
+ * @return 1 si un échantillon a été retiré, 0 si la file est vide.
+ */
+uint8_t BMI088_Queue_Pop(bmi088_data_t *data){
+    bmi088_raw_sample_t raw;
+
+    if(data == NULL || !bmi088_queue_pop_raw(&raw)){
+        return 0;
+    }
+
+    bmi088_raw_to_data(&raw, data);
+
+    return 1;
+}
+
+/**
+ * @brief  Retire le plus ancien échantillon de la file, converti en virgule fixe.
+ * @param  data Pointeur vers la structure de sortie (mm/s², µrad/s).
+ * @return 1 si un échantillon a été retiré, 0 si la file est vide.
+ */
+uint8_t BMI088_Queue_Pop_Fx(bmi088_data_fx_t *data){
+    bmi088_raw_sample_t raw;
+
+    if(data == NULL || !bmi088_queue_pop_raw(&raw)){
+        return 0;
+    }
+
+    BMI088_Convert_Accel_Fx(&raw.accel, data->accel_mms2);
+    BMI088_Convert_Gyro_Fx(&raw.gyro, data->gyro_urads);
+    data->timestamp_us = raw.timestamp_us;
+    data->sensor_time  = raw.sensor_time;
+
+    return 1;
+}
+
+/**
+ * @brief  Retire le plus ancien échantillon de la file, sans conversion.
+ * @details Destiné à la télémétrie compacte : les axes int16 natifs du capteur
+ * sont transmis tels quels, la mise à l'échelle est faite par l'hôte.
+ * @param  raw          Échantillon brut de sortie (LSB).
+ * @param  timestamp_us Date de l'acquisition (µs).
+ * @return 1 si un échantillon a été retiré, 0 si la file est vide.
+ */
+uint8_t BMI088_Queue_Pop_Raw(bmi088_raw_t *raw, uint64_t *timestamp_us){
+    bmi088_raw_sample_t sample;
+
+    if(raw == NULL || timestamp_us == NULL || !bmi088_queue_pop_raw(&sample)){
+        return 0;
+    }
+
+    bmi088_sample_to_raw(&sample, raw);
+    *timestamp_us = sample.timestamp_us;
+
+    return 1;
+}
+
+/**
+ * @brief  Nombre d'échantillons perdus depuis le démarrage.
+ * @return Compteur de pertes (file pleine ou data-ready pendant une acquisition).
+ */
+uint32_t BMI088_Queue_Dropped(void){
+    return queue_dropped;
+}
+
+void BMI088_Inject_Mode(uint8_t on){
+    inject_mode = on ? 1u : 0u;
+}
+
+uint8_t BMI088_Inject(const bmi088_raw_t *raw, uint64_t timestamp_us){
+    bmi088_raw_sample_t sample;
+    uint32_t dropped;
+
+    sample.accel.x = raw->accel[0];
+    sample.accel.y = raw->accel[1];
+    sample.accel.z = raw->accel[2];
+    sample.gyro.x  = raw->gyro[0];
+    sample.gyro.y  = raw->gyro[1];
+    sample.gyro.z  = raw->gyro[2];
+    sample.timestamp_us = timestamp_us;
+    sample.sensor_time  = (uint32_t)((timestamp_us * 16u) / 625u) & 0x00FFFFFFu;   // 39,0625 µs/LSB
+
+    /* Une acquisition lancée avant le passage en rejeu peut encore publier */
+    __disable_irq();
+    dropped = queue_dropped;
+    bmi088_queue_push(&sample);
+    dropped = queue_dropped - dropped;
+    __enable_irq();
+
+    return (dropped == 0u) ? 1u : 0u;
+}
+
+/**
+ * @brief  Nombre d'échantillons en attente dans la file.
+ * @return Échantillons publiés et non encore retirés.
+ */
+uint8_t BMI088_Queue_Pending(void){
+    return (uint8_t)((queue_head - queue_tail) & (BMI088_SAMPLE_QUEUE_LEN - 1u));
+}
+
+/**
+ * @brief  Installe l'observateur des échantillons de la file.
+ * @param  hook Fonction appelée pour chaque échantillon retiré, NULL pour le retirer.
+ */
+void BMI088_Set_Sample_Hook(bmi088_sample_hook_t hook){
+    sample_hook = hook;
+}
+
+/**
+ * @brief  Installe l'observateur brut des échantillons de la file.
+ * @param  hook Fonction appelée pour chaque échantillon retiré, NULL pour le retirer.
+ */
+void BMI088_Set_Raw_Hook(bmi088_raw_hook_t hook){
+    raw_hook = hook;
+}
+
+/**
+ * @brief  Installe le filtre des échantillons retirés de la file.
+ * @param  hook Fonction appelée pour chaque échantillon retiré, NULL pour le retirer.
+ */
+void BMI088_Set_Filter_Hook(bmi088_filter_hook_t hook){
+    filter_hook = hook;
+}
+
+/**
+ * @brief  Installe l'observateur de publication des acquisitions DMA.
+ * @param  hook Fonction appelée en interruption à chaque publication, NULL pour le retirer.
+ */
+void BMI088_Set_Publish_Hook(bmi088_publish_hook_t hook){
+    publish_hook = hook;
+}
+
+/**
+ * @brief  Configure la broche EXTI data-ready de l'hôte et arme son interruption.
+ * @param  port Port GPIO de la ligne.
+ * @param  pin  Broche GPIO de la ligne.
+ * @param  irq  Vecteur EXTI associé.
+ */
+static void bmi088_drdy_enable(GPIO_TypeDef *port, uint16_t pin, IRQn_Type irq){
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    GPIO_InitStruct.Pin  = pin;
+    GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    HAL_GPIO_Init(port, &GPIO_InitStruct);
+
+    drdy_pin = pin;
+
+    HAL_NVIC_SetPriority(irq, IRQ_PRIO_IMU, 0);
+    HAL_NVIC_EnableIRQ(irq);
+}
+
+/**
+ * @brief  Active l'acquisition déclenchée par la ligne data-ready d'un capteur.
+ * @details Configure l'interruption data-ready du capteur choisi (INT1 pour
+ * l'accéléromètre, INT3 pour le gyroscope ; push-pull, actif haut), puis la
+ * broche EXTI correspondante sur front montant. Chaque front lance une séquence
+ * DMA Accel + Gyro dont le résultat est poussé dans la file.
+ * @param  source Capteur dont la sortie cadence les acquisitions.
+ * @return BMI08_OK en cas de succès, ou code d'erreur.
+ */
+static int8_t bmi088_drdy_config(bmi088_drdy_src_t source){
+    GPIO_TypeDef *port;
+    IRQn_Type irq;
+    uint16_t pin;
+    int8_t rslt;
+
+    const struct bmi08_int_pin_cfg pin_cfg = {
+        .lvl            = BMI08_INT_ACTIVE_HIGH,
+        .output_mode    = BMI08_INT_MODE_PUSH_PULL,
+        .enable_int_pin = BMI08_ENABLE
+    };
+
+    if(source == BMI088_DRDY_ACCEL){
+        struct bmi08_accel_int_channel_cfg accel_int = {
+            .int_channel = BMI08_INT_CHANNEL_1,
+            .int_type    = BMI08_ACCEL_INT_DATA_RDY,
+            .int_pin_cfg = pin_cfg
+        };
+        rslt = bmi08a_set_int_config(&accel_int, &bmi088_dev);
+        port = BMI088_INT_ACC_GPIO_Port;
+        pin  = BMI088_INT_ACC_Pin;
+        irq  = BMI088_INT_ACC_IRQn;
+    }
+    else{
+        struct bmi08_gyro_int_channel_cfg gyro_int = {
+            .int_channel = BMI08_INT_CHANNEL_3,
+            .int_type    = BMI08_GYRO_INT_DATA_RDY,
+            .int_pin_cfg = pin_cfg
+        };
+        rslt = bmi08g_set_int_config(&gyro_int, &bmi088_dev);
+        port = BMI088_INT_GYRO_GPIO_Port;
+        pin  = BMI088_INT_GYRO_Pin;
+        irq  = BMI088_INT_GYRO_IRQn;
+    }
+
+    if(rslt != BMI08_OK){
+        return rslt;
+    }
+
+    drdy_source = source;
+    bmi088_drdy_enable(port, pin, irq);
+
+    return BMI08_OK;
+}
+
+/**
+ * @brief  Active l'acquisition déclenchée par la ligne data-ready d'un capteur.
+ * @details Pendant le démarrage asynchrone, la demande est mémorisée et appliquée
+ * à la dernière étape, une fois les capteurs configurés.
+ * @param  source Capteur dont la sortie cadence les acquisitions.
+ * @return BMI08_OK en cas de succès (ou demande mémorisée), ou code d'erreur.
+ */
+int8_t BMI088_DataReady_Init(bmi088_drdy_src_t source){
+    if(bus_booting){
+        drdy_source  = source;
+        drdy_pending = 1;
+        return BMI08_OK;
+    }
+
+    return bmi088_drdy_config(source);
+}
+
+/**
+ * @brief  Sélectionne l'ODR gyroscope correspondant à un mode de synchronisation.
+ * @param  mode BMI08_ACCEL_DATA_SYNC_MODE_400HZ, _1000HZ ou _2000HZ.
+ * @return BMI08_OK, ou BMI08_E_INVALID_INPUT pour un autre mode.
+ */
+static int8_t bmi088_data_sync_odr(uint8_t mode){
+    switch(mode){
+        case BMI08_ACCEL_DATA_SYNC_MODE_400HZ:
+            bmi088_dev.gyro_cfg.odr = BMI08_GYRO_BW_47_ODR_400_HZ;
+            break;
+        case BMI08_ACCEL_DATA_SYNC_MODE_1000HZ:
+            bmi088_dev.gyro_cfg.odr = BMI08_GYRO_BW_116_ODR_1000_HZ;
+            break;
+        case BMI08_ACCEL_DATA_SYNC_MODE_2000HZ:
+            bmi088_dev.gyro_cfg.odr = BMI08_GYRO_BW_230_ODR_2000_HZ;
+            break;
+        default:
+            return BMI08_E_INVALID_INPUT;
+    }
+
+    return BMI08_OK;
+}
+
+/**
+ * @brief  Termine l'activation de la synchronisation, fichier de configuration chargé.
+ * @details Capteurs actifs, gyroscope à l'ODR du mode, interpolation et routage des
+ * interruptions INT1/INT2/INT3, puis acquisitions cadencées par le data-ready synchronisé.
+ * @param  mode Mode de synchronisation (ODR gyroscope déjà sélectionné).
+ * @return BMI08_OK ou code d'erreur.
+ */
+static int8_t bmi088_data_sync_setup(uint8_t mode){
+    struct bmi08_data_sync_cfg sync_cfg;
+    struct bmi08_int_cfg int_config;
+    int8_t rslt;
+
+    bmi088_dev.accel_cfg.power = BMI08_ACCEL_PM_ACTIVE;
+    rslt = bmi08a_set_power_mode(&bmi088_dev);
+
+    bmi088_dev.gyro_cfg.power = BMI08_GYRO_PM_NORMAL;
+    rslt |= bmi08g_set_power_mode(&bmi088_dev);
+
+    bmi088_dev.accel_cfg.range = BMI088_ACCEL_RANGE_6G;
+    bmi088_dev.gyro_cfg.range  = BMI08_GYRO_RANGE_1000_DPS;
+    bmi088_dev.gyro_cfg.bw     = bmi088_dev.gyro_cfg.odr;
+    rslt |= bmi08g_set_meas_conf(&bmi088_dev);
+
+    sync_cfg.mode = mode;
+    rslt |= bmi08xa_configure_data_synchronization(sync_cfg, &bmi088_dev);
+    if(rslt != BMI08_OK){
+        return BMI08_E_COM_FAIL;
+    }
+
+    int_config.accel_int_config_1.int_channel = BMI08_INT_CHANNEL_1;
+    int_config.accel_int_config_1.int_type    = BMI08_ACCEL_SYNC_INPUT;
+    int_config.accel_int_config_1.int_pin_cfg.output_mode    = BMI08_INT_MODE_PUSH_PULL;
+    int_config.accel_int_config_1.int_pin_cfg.lvl            = BMI08_INT_ACTIVE_HIGH;
+    int_config.accel_int_config_1.int_pin_cfg.enable_int_pin = BMI08_ENABLE;
+
+    int_config.accel_int_config_2.int_channel = BMI08_INT_CHANNEL_2;
+    int_config.accel_int_config_2.int_type    = BMI08_ACCEL_INT_SYNC_DATA_RDY;
+    int_config.accel_int_config_2.int_pin_cfg.output_mode    = BMI08_INT_MODE_PUSH_PULL;
+    int_config.accel_int_config_2.int_pin_cfg.lvl            = BMI08_INT_ACTIVE_HIGH;
+    int_config.accel_int_config_2.int_pin_cfg.enable_int_pin = BMI08_ENABLE;
+
+    int_config.gyro_int_config_1.int_channel = BMI08_INT_CHANNEL_3;
+    int_config.gyro_int_config_1.int_type    = BMI08_GYRO_INT_DATA_RDY;
+    int_config.gyro_int_config_1.int_pin_cfg.output_mode    = BMI08_INT_MODE_PUSH_PULL;
+    int_config.gyro_int_config_1.int_pin_cfg.lvl            = BMI08_INT_ACTIVE_HIGH;
+    int_config.gyro_int_config_1.int_pin_cfg.enable_int_pin = BMI08_ENABLE;
+
+    int_config.gyro_int_config_2.int_channel = BMI08_INT_CHANNEL_4;
+    int_config.gyro_int_config_2.int_type    = BMI08_GYRO_INT_DATA_RDY;
+    int_config.gyro_int_config_2.int_pin_cfg.output_mode    = BMI08_INT_MODE_PUSH_PULL;
+    int_config.gyro_int_config_2.int_pin_cfg.lvl            = BMI08_INT_ACTIVE_HIGH;
+    int_config.gyro_int_config_2.int_pin_cfg.enable_int_pin = BMI08_DISABLE;
+
+    rslt = bmi08a_set_data_sync_int_config(&int_config, &bmi088_dev);
+    if(rslt != BMI08_OK){
+        return rslt;
+    }
+
+    data_sync_mode = mode;
+    bmi088_update_scales();
+
+    bmi088_drdy_enable(BMI088_INT_ACC_GPIO_Port, BMI088_INT_ACC_Pin, BMI088_INT_ACC_IRQn);
+
+    return BMI08_OK;
+}
+
+/**
+ * @brief  Active le mode de synchronisation Accel/Gyro (Bosch data sync).
+ * @details Téléverse le fichier de configuration de l'accéléromètre, règle le
+ * gyroscope sur l'ODR correspondant au mode et active l'interpolation de
+ * l'accéléromètre sur le data-ready gyroscope. Câblage attendu (cf. DataSync.md) :
+ * INT3 (gyro) relié à INT1 (accel, entrée de synchronisation) et INT2 (accel,
+ * data-ready synchronisé) relié à la broche BMI088_INT_ACC_Pin de l'hôte.
+ * Les acquisitions DMA lisent ensuite l'accélération synchronisée (GP_0..GP_4)
+ * en une seule transaction, suivie des données gyroscope.
+ * @note   Les gammes restent ±6 g / ±1000 dps (cohérentes avec les conversions).
+ * @param  mode BMI08_ACCEL_DATA_SYNC_MODE_400HZ, _1000HZ ou _2000HZ.
+ * @return BMI08_OK en cas de succès, ou code d'erreur.
+ */
+int8_t BMI088_DataSync_Init(uint8_t mode){
+    int8_t rslt = bmi088_data_sync_odr(mode);
+    if(rslt != BMI08_OK){
+        return rslt;
+    }
+
+    bmi088_dev.variant = BMI088_VARIANT;
+
+    rslt = bmi08xa_init(&bmi088_dev);
+    if(rslt != BMI08_OK){
+        return rslt;
+    }
+
+    rslt = bmi08a_soft_reset(&bmi088_dev);
+
+    bmi088_dev.read_write_len = 32;
+    rslt |= bmi08a_load_config_file(&bmi088_dev);
+    if(rslt != BMI08_OK){
+        return BMI08_E_CONFIG_STREAM_ERROR;
+    }
+
+    return bmi088_data_sync_setup(mode);
+}
+
+#if BMI088_FEATURE_LAZY
+/**
+ * @brief  Demande le téléversement en tâche de fond du fichier de configuration.
+ * @details Fichier de synchronisation si feat_sync_mode est renseigné, any-motion sinon.
+ * Sans effet si un téléversement est déjà en cours.
+ */
+static void bmi088_feat_request(void){
+    if(feat_state == BMI088_FEAT_IDLE){
+        feat_deadline_us = 0;
+        feat_state = BMI088_FEAT_START;
+    }
+}
+
+#endif
+
+/**
+ * @brief  Configure la détection any-motion et sa sortie sur INT1.
+ * @details Le fichier de configuration any-motion remplace le micrologiciel de
+ * l'accéléromètre : il n'est téléversé qu'après un soft reset (motion_loaded) ; un
+ * simple changement de seuil ne réécrit que les deux mots de configuration.
+ * @return BMI08_OK ou code d'erreur.
+ */
+static int8_t bmi088_motion_setup(void){
+    const struct bmi088_anymotion_anymotion_cfg am_cfg = {
+        .threshold = (uint16_t)(((uint32_t)motion_thr_mg * 2048u) / 1000u),
+        .enable    = BMI08_ENABLE,
+        .duration  = (uint16_t)(motion_dur_ms / BMI088_MOTION_TICK_MS),
+        .x_en      = BMI08_ENABLE,
+        .y_en      = BMI08_ENABLE,
+        .z_en      = BMI08_ENABLE
+    };
+    const struct bmi08_accel_int_channel_cfg int_cfg = {
+        .int_channel = BMI08_INT_CHANNEL_1,
+        .int_pin_cfg = {
+            .lvl            = BMI08_INT_ACTIVE_HIGH,
+            .output_mode    = BMI08_INT_MODE_PUSH_PULL,
+            .enable_int_pin = BMI08_ENABLE
+        }
+    };
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    int8_t rslt = BMI08_OK;
+
+    if(!motion_loaded){
+        rslt = bmi088_anymotion_init(&bmi088_dev);
+
+        bmi088_dev.read_write_len = 32;
+        rslt |= bmi08a_load_config_file(&bmi088_dev);
+
+        bmi088_dev.accel_cfg.power = BMI08_ACCEL_PM_ACTIVE;
+        rslt |= bmi08a_set_power_mode(&bmi088_dev);
+        rslt |= bmi088_anymotion_set_meas_conf(&bmi088_dev);
+        if(rslt != BMI08_OK){
+            return BMI08_E_CONFIG_STREAM_ERROR;
+        }
+        motion_loaded = 1;
+    }
+
+    rslt  = bmi088_anymotion_configure_anymotion(am_cfg, &bmi088_dev);
+    rslt |= bmi088_anymotion_set_int_config(&int_cfg, BMI088_ANYMOTION_ANYMOTION_INT, &bmi088_dev);
+    if(rslt != BMI08_OK){
+        return BMI08_E_COM_FAIL;
+    }
+
+    GPIO_InitStruct.Pin  = BMI088_INT_ACC_Pin;
+    GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    HAL_GPIO_Init(BMI088_INT_ACC_GPIO_Port, &GPIO_InitStruct);
+
+    motion_armed = 1;
+    HAL_NVIC_SetPriority(BMI088_INT_ACC_IRQn, IRQ_PRIO_IMU, 0);
+    HAL_NVIC_EnableIRQ(BMI088_INT_ACC_IRQn);
+
+    return BMI08_OK;
+}
+
+
+/**
+ * @brief  Indique si les acquisitions sont cadencées par la ligne data-ready.
+ * @return 1 si le mode data-ready est actif, 0 sinon.
+ */
+uint8_t BMI088_DataReady_Active(void){
+    return (drdy_pin != 0) ? 1u : 0u;
+}
+
+/**
+ * @brief  Callback HAL de front montant EXTI : lance l'acquisition data-ready ou compte
+ * une détection de mouvement (INT1 réservée à l'une ou à l'autre).
+ * @param  GPIO_Pin Broche ayant généré l'interruption.
+ */
+void HAL_GPIO_EXTI_Rising_Callback(uint16_t GPIO_Pin){
+    if(motion_armed && GPIO_Pin == BMI088_INT_ACC_Pin){
+        motion_events++;
+        return;
+    }
+
+    if(drdy_pin == 0 || GPIO_Pin != drdy_pin || inject_mode || st_hold){
+        return;
+    }
+
+    uint32_t prof_start = prof_begin();
+
+    if(BMI088_Start_Read_DMA() != BMI08_OK){
+        queue_dropped++;
+    }
+
+    prof_end(PROF_PROBE_IMU_DRDY_ISR, prof_start);
+}
+
+/**
+ * @brief  Fin de transfert d'une acquisition DMA (contexte interruption DMA).
+ * @details Le Chip Select du capteur lu est déjà relâché par spi_bus : enchaîne la
+ * lecture gyroscope ou publie l'échantillon complet (verrou de séquence et file).
+ */
+static void bmi088_dma_complete(void){
+    uint32_t prof_start = prof_begin();
+    bmi088_raw_sample_t *back = &dma_stage;
+    uint8_t published = 0;
+
+    switch(dma_state){
+        case BMI088_DMA_ACCEL:
+            /* rx[0] : écho adresse, rx[1] : octet vide accéléromètre */
+            if(data_sync_mode != BMI08_ACCEL_DATA_SYNC_MODE_OFF){
+                /* Horloge capteur, X/Y dans GP_0..GP_3, température, Z dans GP_4..GP_4+1 */
+                const uint8_t *base = &dma_rx_buf[2];
+                const uint8_t *gp = base + (BMI08_REG_ACCEL_GP_0 - BMI08_REG_ACCEL_SENSORTIME_0);
+                back->sensor_time = bmi088_unpack_u24(base);
+                back->accel.x = (int16_t)((uint16_t)gp[0] | ((uint16_t)gp[1] << 8));
+                back->accel.y = (int16_t)((uint16_t)gp[2] | ((uint16_t)gp[3] << 8));
+                gp += BMI08_REG_ACCEL_GP_4 - BMI08_REG_ACCEL_GP_0;
+                back->accel.z = (int16_t)((uint16_t)gp[0] | ((uint16_t)gp[1] << 8));
+                temp_cdeg = bmi088_unpack_temp(base + (BMI08_REG_TEMP_MSB - BMI08_REG_ACCEL_SENSORTIME_0));
+            }
+            else{
+                const uint8_t *base = &dma_rx_buf[2];
+                bmi088_unpack_xyz(base, &back->accel);
+                back->sensor_time = bmi088_unpack_u24(base + (BMI08_REG_ACCEL_SENSORTIME_0 - BMI08_REG_ACCEL_X_LSB));
+                if(dma_accel_len == BMI088_DMA_ACCEL_TEMP_LEN){
+                    temp_cdeg = bmi088_unpack_temp(base + (BMI08_REG_TEMP_MSB - BMI08_REG_ACCEL_X_LSB));
+                }
+            }
+
+            dma_state = BMI088_DMA_GYRO;
+            if(bmi088_dma_start(bus_dev_gyro, BMI08_REG_GYRO_X_LSB, BMI088_DMA_GYRO_LEN) != BMI08_OK){
+                dma_state = BMI088_DMA_IDLE;
+            }
+            break;
+
+        case BMI088_DMA_GYRO:
+            bmi088_unpack_xyz(&dma_rx_buf[1], &back->gyro);
+            bmi088_queue_push(back);
+
+            seqlock_write_begin(&dma_lock);
+            dma_pub = *back;
+            seqlock_write_end(&dma_lock);
+            bus_fail_streak = 0;
+            dma_state = BMI088_DMA_IDLE;
+            sched_wake_from_isr();
+            published = 1;
+            break;
+
+        default:
+            dma_state = BMI088_DMA_IDLE;
+            break;
+    }
+
+    prof_end(PROF_PROBE_IMU_SPI_ISR, prof_start);
+
+    if(published && publish_hook != NULL){
+        publish_hook();
+    }
+}
+
+/**
+ * @brief  Erreur de transfert d'une acquisition DMA : abandonne la séquence en cours.
+ */
+static void bmi088_dma_error(void){
+    dma_state = BMI088_DMA_IDLE;
+
+    bus_errors++;
+    bmi088_bus_fail();
+}
+
+/**
+ * @brief  Fin d'une transaction soumise à spi_bus (contexte interruption DMA).
+ * @param  ctx    Inutilisé.
+ * @param  status SPI_BUS_OK ou code d'erreur SPI_BUS_E_*.
+ */
+static void bmi088_dma_done(void *ctx, int8_t status){
+    (void)ctx;
+
+    if(status != SPI_BUS_OK){
+        bmi088_dma_error();
+        return;
+    }
+    bmi088_dma_complete();
+}
+
+/**
+ * @brief  Active le mode d'acquisition FIFO (Accéléromètre + Gyroscope).
+ * @details Configure les ODR demandés, les deux FIFO en mode "stream" (les plus
+ * anciennes trames sont écrasées si la FIFO n'est pas vidée à temps) et le même
+ * seuil (watermark) exprimé en nombre de trames pour les deux capteurs.
+ * @param  accel_odr  ODR accéléromètre (BMI08_ACCEL_ODR_12_5_HZ ... BMI08_ACCEL_ODR_1600_HZ).
+ * @param  gyro_odr   ODR/BW gyroscope (BMI08_GYRO_BW_*).
+ * @param  wm_frames  Seuil de déclenchement en trames (1 à BMI088_GYRO_FIFO_MAX_FRAMES).
+ * @return BMI08_OK en cas de succès, ou code d'erreur.
+ */
+int8_t BMI088_FIFO_Init(uint8_t accel_odr, uint8_t gyro_odr, uint16_t wm_frames){
+    if(accel_odr < BMI08_ACCEL_ODR_12_5_HZ || accel_odr > BMI08_ACCEL_ODR_1600_HZ ||
+       gyro_odr > BMI08_GYRO_BW_32_ODR_100_HZ ||
+       wm_frames == 0 || wm_frames > BMI088_GYRO_FIFO_MAX_FRAMES){
+        return BMI08_E_INVALID_INPUT;
+    }
+
+    bmi088_dev.accel_cfg.odr = accel_odr;
+    bmi088_dev.gyro_cfg.odr  = gyro_odr;
+    bmi088_dev.gyro_cfg.bw   = gyro_odr;
+
+    int8_t rslt = bmi08a_set_meas_conf(&bmi088_dev);
+    rslt |= bmi08g_set_meas_conf(&bmi088_dev);
+
+    struct bmi08_accel_fifo_config accel_conf = {
+        .mode     = BMI08_ACC_STREAM_MODE,
+        .accel_en = BMI08_ENABLE,
+        .int1_en  = BMI08_DISABLE,
+        .int2_en  = BMI08_DISABLE
+    };
+    rslt |= bmi08a_get_set_fifo_config(&accel_conf, &bmi088_dev, SET_FUNC);
+
+    uint16_t accel_wm = (uint16_t)(wm_frames * BMI088_ACCEL_FIFO_FRAME_SIZE);
+    rslt |= bmi08a_get_set_fifo_wm(&accel_wm, &bmi088_dev, SET_FUNC);
+
+    gyro_fifo_conf.mode        = BMI08_GYRO_FIFO_MODE_STREAM;
+    gyro_fifo_conf.data_select = BMI08_GYRO_FIFO_XYZ_AXIS_ENABLED;
+    gyro_fifo_conf.tag         = BMI08_GYRO_FIFO_TAG_DISABLED;
+    gyro_fifo_conf.wm_level    = wm_frames;
+    rslt |= bmi08g_set_fifo_config(&gyro_fifo_conf, &bmi088_dev);
+    rslt |= bmi08g_enable_watermark(BMI08_ENABLE, &bmi088_dev);
+
+    if(rslt != BMI08_OK){
+        return BMI08_E_COM_FAIL;
+    }
+
+    fifo_accel_period_us = 80000u >> (accel_odr - BMI08_ACCEL_ODR_12_5_HZ);
+    fifo_gyro_period_us  = gyro_odr_period_us[gyro_odr];
+
+    return BMI08_OK;
+}
+
+/**
+ * @brief  Vide les deux FIFO en une rafale et extrait un lot d'échantillons.
+ * @details Une transaction de longueur pour l'accéléromètre, une lecture de statut
+ * pour le gyroscope, puis une seule lecture de données par capteur, quel que
+ * soit le nombre de trames disponibles.
+ * La date de vidage `timestamp_us` (relevée avant la lecture) correspond au dernier échantillon du lot ;
+ * les dates des échantillons précédents s'en déduisent avec les périodes
+ * fournies (voir BMI088_FIFO_Sample_Age_us).
+ * @param  batch Lot de sortie (données brutes).
+ * @return BMI08_OK, BMI08_W_FIFO_EMPTY si aucune trame n'est disponible, ou code d'erreur.
+ */
+int8_t BMI088_FIFO_Read_Batch(bmi088_fifo_batch_t *batch){
+    if(batch == NULL){
+        return BMI08_E_NULL_PTR;
+    }
+
+    if(bus_state != BMI088_BUS_OK || st_hold){
+        return BMI088_E_BUSY;
+    }
+
+    struct bmi08_fifo_frame fifo;
+    int8_t rslt;
+    const uint64_t t_us = GetMicros64();
+
+    /* Accéléromètre : bmi08a_read_fifo_data lit tout le contenu de la FIFO */
+    memset(&fifo, 0, sizeof(fifo));
+    fifo.data = accel_fifo_buf;
+
+    rslt = bmi08a_read_fifo_data(&fifo, &bmi088_dev);
+    if(rslt != BMI08_OK){
+        return rslt;
+    }
+
+    batch->accel_count = BMI088_ACCEL_FIFO_MAX_FRAMES;
+    rslt = bmi08a_extract_accel(batch->accel, &batch->accel_count, &fifo, &bmi088_dev);
+    if(rslt != BMI08_OK){
+        return rslt;
+    }
+
+    /* Gyroscope : longueur déduite du compteur de trames, bornée au buffer */
+    rslt = bmi08g_get_fifo_config(&gyro_fifo_conf, &bmi088_dev);
+    if(rslt != BMI08_OK){
+        return rslt;
+    }
+
+    memset(&fifo, 0, sizeof(fifo));
+    fifo.data   = gyro_fifo_buf;
+    fifo.length = sizeof(gyro_fifo_buf);
+    bmi08g_get_fifo_length(&gyro_fifo_conf, &fifo);
+
+    batch->gyro_count = 0;
+    if(fifo.length > 0){
+        rslt = bmi08g_read_fifo_data(&fifo, &bmi088_dev);
+        if(rslt != BMI08_OK){
+            return rslt;
+        }
+
+        batch->gyro_count = (uint16_t)(fifo.length / BMI08_GYRO_FIFO_XYZ_AXIS_FRAME_SIZE);
+        bmi08g_extract_gyro(batch->gyro, &batch->gyro_count, &gyro_fifo_conf, &fifo);
+    }
+
+    batch->accel_period_us = fifo_accel_period_us;
+    batch->gyro_period_us  = fifo_gyro_period_us;
+    batch->timestamp_us    = t_us;
+
+    if(batch->accel_count == 0 && batch->gyro_count == 0){
+        return BMI08_W_FIFO_EMPTY;
+    }
+
+    return BMI08_OK;
+}
+
+/**
+ * @brief  Suspend le déclenchement data-ready et attend la fin de la séquence DMA en cours.
+ * @return 1 si le bus est libre, 0 si la séquence DMA ne s'est pas terminée à temps
+ * ou si une récupération du bus est en cours.
+ * @note   Doit toujours être suivie de bmi088_bus_resume().
+ */
+static uint8_t bmi088_bus_suspend(void){
+    if(drdy_pin != 0){
+        HAL_NVIC_DisableIRQ((drdy_pin == BMI088_INT_GYRO_Pin) ? BMI088_INT_GYRO_IRQn : BMI088_INT_ACC_IRQn);
+    }
+
+    uint32_t t0 = HAL_GetTick();
+    while(dma_state != BMI088_DMA_IDLE && (HAL_GetTick() - t0) < 2u){
+    }
+
+    return (dma_state == BMI088_DMA_IDLE && bus_state == BMI088_BUS_OK) ? 1 : 0;
+}
+
+/**
+ * @brief  Réactive le déclenchement data-ready suspendu par bmi088_bus_suspend().
+ * @note   Sans effet pendant une récupération du bus : la dernière étape s'en charge.
+ */
+static void bmi088_bus_resume(void){
+    if(drdy_pin != 0 && bus_state == BMI088_BUS_OK){
+        HAL_NVIC_EnableIRQ((drdy_pin == BMI088_INT_GYRO_Pin) ? BMI088_INT_GYRO_IRQn : BMI088_INT_ACC_IRQn);
+    }
+}
+
+/** @brief Recopie une configuration capteurs dans le descripteur Bosch (sans écriture SPI). */
+static void bmi088_set_meas_fields(const bmi088_config_t *cfg){
+    bmi088_dev.accel_cfg.range = cfg->accel_range;
+    bmi088_dev.accel_cfg.odr   = cfg->accel_odr;
+    bmi088_dev.accel_cfg.bw    = cfg->accel_bw;
+    bmi088_dev.gyro_cfg.range  = cfg->gyro_range;
+    bmi088_dev.gyro_cfg.odr    = cfg->gyro_odr;
+    bmi088_dev.gyro_cfg.bw     = cfg->gyro_odr;
+}
+
+/**
+ * @brief  Reconfigure à chaud les gammes, ODR et bande passante des capteurs.
+ * @details Suspend le déclenchement data-ready, attend la fin d'une éventuelle
+ * séquence DMA (quelques dizaines de µs), applique la configuration puis
+ * sélectionne les facteurs de conversion dans les tables précalculées. Pendant le
+ * démarrage asynchrone, la configuration est mémorisée et appliquée par la séquence.
+ * @param  cfg Nouvelle configuration (codes Bosch).
+ * @return BMI08_OK, BMI08_E_INVALID_INPUT si un champ est hors plage, BMI088_E_BUSY
+ * si le bus ne s'est pas libéré, ou code d'erreur SPI.
+ */
+int8_t BMI088_Configure(const bmi088_config_t *cfg){
+    if(cfg == NULL){
+        return BMI08_E_NULL_PTR;
+    }
+
+    if(cfg->accel_range > BMI088_ACCEL_RANGE_24G ||
+       cfg->accel_odr < BMI08_ACCEL_ODR_12_5_HZ || cfg->accel_odr > BMI08_ACCEL_ODR_1600_HZ ||
+       cfg->accel_bw < BMI08_ACCEL_BW_OSR4 || cfg->accel_bw > BMI08_ACCEL_BW_NORMAL ||
+       cfg->gyro_range > BMI08_GYRO_RANGE_125_DPS ||
+       cfg->gyro_odr > BMI08_GYRO_BW_32_ODR_100_HZ){
+        return BMI08_E_INVALID_INPUT;
+    }
+
+    int8_t rslt = BMI088_E_BUSY;
+
+    if(bus_booting){
+        /* Écrite à l'étape BMI088_BUS_MEAS_CONF, reprise si celle-ci est déjà passée */
+        bmi088_set_meas_fields(cfg);
+        if(bus_state >= BMI088_BUS_MEAS_CONF){
+            bus_meas_redo = 1;
+        }
+        return BMI08_OK;
+    }
+
+    if(st_hold){
+        /* Écrite par la dernière étape de l'auto-test, qui restaure la configuration */
+        bmi088_set_meas_fields(cfg);
+        bmi088_update_scales();
+        return BMI08_OK;
+    }
+
+    if(bmi088_bus_suspend()){
+        bmi088_set_meas_fields(cfg);
+
+        rslt  = bmi08xa_set_meas_conf(&bmi088_dev);
+        rslt |= bmi08g_set_meas_conf(&bmi088_dev);
+        rslt  = (rslt != BMI08_OK) ? BMI08_E_COM_FAIL : BMI08_OK;
+
+        bmi088_update_scales();
+    }
+
+    bmi088_bus_resume();
+
+    return rslt;
+}
+
+/**
+ * @brief  Active (ou désactive) la détection de mouvement any-motion de l'accéléromètre.
+ * @details Pendant le démarrage asynchrone, la demande est mémorisée et appliquée
+ * à la dernière étape ; après une récupération du bus, la même étape la ré-applique.
+ * Avec BMI088_FEATURE_LAZY, un fichier any-motion absent est téléversé en tâche de
+ * fond et le seuil appliqué à la fin du téléversement. La désactivation masque seulement INT1 : le capteur continue d'évaluer, sans effet.
+ * @param  threshold_mg Seuil de variation d'accélération (mg, 1..BMI088_MOTION_THRESH_MAX_MG), 0 pour désactiver.
+ * @param  duration_ms  Durée de dépassement avant détection (ms, multiple de BMI088_MOTION_TICK_MS).
+ * @return BMI08_OK (ou demande mémorisée pendant le démarrage), BMI08_E_INVALID_CONFIG si
+ * INT1 est déjà utilisée, BMI088_E_BUSY ou code d'erreur.
+ */
+int8_t BMI088_Motion_Config(uint16_t threshold_mg, uint16_t duration_ms){
+    if(threshold_mg == 0){
+        if(motion_armed){
+            HAL_NVIC_DisableIRQ(BMI088_INT_ACC_IRQn);
+            motion_armed = 0;
+        }
+        motion_thr_mg = 0;
+        return BMI08_OK;
+    }
+
+    if(threshold_mg > BMI088_MOTION_THRESH_MAX_MG){
+        return BMI08_E_INVALID_INPUT;
+    }
+
+    if(data_sync_mode != BMI08_ACCEL_DATA_SYNC_MODE_OFF ||
+#if BMI088_FEATURE_LAZY
+       feat_sync_mode != BMI08_ACCEL_DATA_SYNC_MODE_OFF ||
+#endif
+       ((drdy_pin != 0 || drdy_pending) && drdy_source == BMI088_DRDY_ACCEL)){
+        return BMI08_E_INVALID_CONFIG;
+    }
+
+    motion_thr_mg = threshold_mg;
+    motion_dur_ms = duration_ms;
+
+    if(bus_booting){
+        return BMI08_OK;
+    }
+
+#if BMI088_FEATURE_LAZY
+    if(!motion_loaded){
+        bmi088_feat_request();
+        return BMI08_OK;
+    }
+#endif
+
+    int8_t rslt = BMI088_E_BUSY;
+
+    if(bmi088_bus_suspend()){
+        rslt = bmi088_motion_setup();
+    }
+    bmi088_bus_resume();
+
+    return rslt;
+}
+
+/**
+ * @brief  Nombre de détections de mouvement signalées depuis le démarrage.
+ * @return Compteur (reboucle), constant tant que la détection est inactive.
+ */
+uint32_t BMI088_Motion_Events(void){
+    return motion_events;
+}
+
+/**
+ * @brief  Met les capteurs en veille ou les réveille.
+ * @param  enable 1 : veille, 0 : réveil.
+ * @return BMI08_OK, BMI088_E_BUSY ou code d'erreur.
+ */
+int8_t BMI088_Low_Power(uint8_t enable){
+    int8_t rslt = BMI088_E_BUSY;
+
+    if(bus_booting){
+        return rslt;
+    }
+
+    if(bmi088_bus_suspend()){
+        bmi088_dev.gyro_cfg.power = enable ? BMI08_GYRO_PM_SUSPEND : BMI08_GYRO_PM_NORMAL;
+        rslt = bmi08g_set_power_mode(&bmi088_dev);
+
+        if(!motion_armed){
+            bmi088_dev.accel_cfg.power = enable ? BMI08_ACCEL_PM_SUSPEND : BMI08_ACCEL_PM_ACTIVE;
+            rslt |= bmi08a_set_power_mode(&bmi088_dev);
+        }
+    }
+    bmi088_bus_resume();
+
+    return rslt;
+}
+
+/**
+ * @brief  Renvoie la configuration capteurs active.
+ * @param  cfg Structure de sortie (codes Bosch).
+ */
+void BMI088_Get_Config(bmi088_config_t *cfg){
+    if(cfg == NULL){
+        return;
+    }
+
+    cfg->accel_range = bmi088_dev.accel_cfg.range;
+    cfg->accel_odr   = bmi088_dev.accel_cfg.odr;
+    cfg->accel_bw    = bmi088_dev.accel_cfg.bw;
+    cfg->gyro_range  = bmi088_dev.gyro_cfg.range;
+    cfg->gyro_odr    = bmi088_dev.gyro_cfg.odr;
+}
+
+/**
+ * @brief  Mesure le temps moyen d'une lecture bloquante accéléromètre + gyroscope.
+ * @details Enchaîne `count` lectures BMI088_Read_Raw_Fast() en
+ * chronométrant l'ensemble avec la base de temps TIM3, acquisition data-ready suspendue.
+ * @param  count     Nombre de lectures (1 minimum).
+ * @param  avg_ns    Sortie : durée moyenne d'une lecture en nanosecondes.
+ * @return BMI08_OK, BMI08_E_INVALID_INPUT, BMI088_E_BUSY ou code d'erreur SPI.
+ */
+int8_t BMI088_Benchmark_Read(uint16_t count, uint32_t *avg_ns){
+    if(avg_ns == NULL){
+        return BMI08_E_NULL_PTR;
+    }
+
+    if(count == 0){
+        return BMI08_E_INVALID_INPUT;
+    }
+
+    bmi088_raw_t raw;
+    int8_t rslt = BMI088_E_BUSY;
+
+    if(bmi088_bus_suspend()){
+        rslt = BMI08_OK;
+
+        uint32_t t0 = GetMicrosTotal();
+        for(uint16_t i = 0; i < count && rslt == BMI08_OK; i++){
+            rslt = BMI088_Read_Raw_Fast(&raw);
+        }
+        uint32_t elapsed_us = GetMicrosTotal() - t0;
+
+        *avg_ns = (uint32_t)(((uint64_t)elapsed_us * 1000u) / count);
+    }
+
+    bmi088_bus_resume();
+
+    return rslt;
+}
+
+/**
+ * @brief  Suspend l'acquisition data-ready pour des lectures bloquantes hors driver (banc de mesure).
+ * @return 1 si le bus est libre, 0 sinon.
+ * @note   Doit toujours être suivie de BMI088_Bus_Resume().
+ */
+uint8_t BMI088_Bus_Suspend(void){
+    return bmi088_bus_suspend();
+}
+
+/**
+ * @brief  Réactive l'acquisition suspendue par BMI088_Bus_Suspend().
+ */
+void BMI088_Bus_Resume(void){
+    bmi088_bus_resume();
+}
+
+/**
+ * @brief  Interrompt une séquence DMA qui ne s'est pas terminée dans les temps.
+ * @details La séquence est d'abord marquée terminée interruptions masquées (la fin
+ * de transfert a pu arriver entre-temps), puis le bus est interrompu (spi_bus_abort) :
+ * les transactions des autres périphériques en file sont perdues avec elle.
+ */
+static void bmi088_dma_abort_stalled(void){
+    __disable_irq();
+    const uint8_t stalled = (dma_state != BMI088_DMA_IDLE) &&
+                            ((HAL_GetTick() - dma_start_ms) > bmi088_spi_timeout_ms(BMI088_DMA_BUF_LEN));
+    if(stalled){
+        dma_state = BMI088_DMA_IDLE;
+    }
+    __enable_irq();
+
+    if(!stalled){
+        return;
+    }
+
+    spi_bus_abort();
+
+    bus_timeouts++;
+    bmi088_bus_fail();
+}
+
+/**
+ * @brief  Écrit directement un registre d'un capteur, hors couche Bosch (sans délai).
+ * @param  cs       Chip Select du capteur ciblé.
+ * @param  reg_addr Adresse du registre.
+ * @param  value    Valeur à écrire.
+ * @return BMI08_OK ou code d'erreur SPI.
+ */
+static int8_t bmi088_write_reg(bmi088_cs_t *cs, uint8_t reg_addr, uint8_t value){
+    return bmi088_spi_write(reg_addr, &value, 1, cs);
+}
+
+/**
+ * @brief  Écrit la configuration de mesure conservée dans bmi088_dev.
+ * @details Mêmes registres que bmi08xa_set_meas_conf() / bmi08g_set_meas_conf(),
+ * les délais Bosch étant reportés sur l'échéance de l'étape.
+ * @return BMI08_OK ou code d'erreur SPI.
+ */
+static int8_t bmi088_write_meas_conf(void){
+    const uint8_t acc_conf = (uint8_t)((bmi088_dev.accel_cfg.bw << BMI08_ACCEL_BW_POS) & BMI08_ACCEL_BW_MASK) |
+                             (uint8_t)(bmi088_dev.accel_cfg.odr & BMI08_ACCEL_ODR_MASK);
+
+    int8_t rslt = bmi088_write_reg(&cs_accel, BMI08_REG_ACCEL_CONF, acc_conf);
+    rslt |= bmi088_write_reg(&cs_accel, BMI08_REG_ACCEL_RANGE, bmi088_dev.accel_cfg.range);
+    rslt |= bmi088_write_reg(&cs_gyro, BMI08_REG_GYRO_LPM1, bmi088_dev.gyro_cfg.power);
+    rslt |= bmi088_write_reg(&cs_gyro, BMI08_REG_GYRO_RANGE, bmi088_dev.gyro_cfg.range);
+    rslt |= bmi088_write_reg(&cs_gyro, BMI08_REG_GYRO_BANDWIDTH, bmi088_dev.gyro_cfg.odr);
+
+    return (rslt != BMI08_OK) ? BMI08_E_COM_FAIL : BMI08_OK;
+}
+
+#if BMI088_FEATURE_LAZY
+/**
+ * @brief  Active la fonction dont le fichier vient d'être accepté par le capteur.
+ * @details La configuration de mesure est réécrite (sans délai : valeurs inchangées)
+ * avant l'activation, comme après bmi08a_load_config_file() dans les modes bloquants.
+ * @return BMI08_OK ou code d'erreur.
+ */
+static int8_t bmi088_feat_finish(void){
+    int8_t rslt = bmi088_write_meas_conf();
+
+    if(feat_sync_mode != BMI08_ACCEL_DATA_SYNC_MODE_OFF){
+        const uint8_t mode = feat_sync_mode;
+
+        feat_sync_mode = BMI08_ACCEL_DATA_SYNC_MODE_OFF;
+        rslt |= bmi088_data_sync_odr(mode);
+        rslt |= bmi088_data_sync_setup(mode);
+        if(rslt != BMI08_OK){
+            feat_sync_mode = mode;
+        }
+        return rslt;
+    }
+
+    motion_loaded = 1;
+    if(motion_thr_mg != 0){
+        rslt |= bmi088_motion_setup();
+    }
+
+    return rslt;
+}
+
+/**
+ * @brief  Exécute une étape du téléversement en tâche de fond, bus opérationnel.
+ * @details Séquence de bmi08a_load_config_file() découpée en étapes courtes :
+ * économie d'énergie avancée désactivée, INIT_CTRL à 0, fichier écrit par rafales de
+ * BMI088_FEATURE_BURST_LEN octets (adresse en mots dans 0x5B/0x5C), INIT_CTRL à 1 puis
+ * contrôle de INTERNAL_STAT après BMI08_ASIC_INIT_TIME_MS. Chaque étape attend la fin de
+ * l'acquisition DMA en cours ; les attentes capteur sont des échéances. Un fichier refusé
+ * est téléversé de nouveau après BMI088_BUS_RETRY_US.
+ * @param  now_us Timestamp actuel en microsecondes.
+ */
+static void bmi088_feat_poll(uint64_t now_us){
+    if(feat_state == BMI088_FEAT_IDLE || now_us < feat_deadline_us){
+        return;
+    }
+
+    if(!bmi088_bus_suspend()){
+        bmi088_bus_resume();
+        return;
+    }
+
+    int8_t rslt = BMI08_OK;
+    uint8_t stat[2] = {0};
+    uint16_t word;
+
+    switch(feat_state){
+        case BMI088_FEAT_START:
+            /* Sélection du fichier (config_file_ptr), sans soft reset : le flux continue */
+            bmi088_dev.variant = BMI088_VARIANT;
+            rslt  = (feat_sync_mode != BMI08_ACCEL_DATA_SYNC_MODE_OFF) ?
+                    bmi08xa_init(&bmi088_dev) : bmi088_anymotion_init(&bmi088_dev);
+            rslt |= bmi088_write_reg(&cs_accel, BMI08_REG_ACCEL_PWR_CONF, BMI08_ACCEL_PM_ACTIVE);
+            feat_index = 0;
+            feat_deadline_us = now_us + BMI088_APS_DISABLE_DELAY_US;
+            feat_state = BMI088_FEAT_STREAM;
+            break;
+
+        case BMI088_FEAT_STREAM:
+            if(feat_index == 0){
+                rslt = bmi088_write_reg(&cs_accel, BMI08_REG_ACCEL_INIT_CTRL, BMI08_DISABLE);
+            }
+            word  = feat_index / 2u;
+            rslt |= bmi088_write_reg(&cs_accel, BMI08_REG_ACCEL_RESERVED_5B, (uint8_t)(word & 0x0Fu));
+            rslt |= bmi088_write_reg(&cs_accel, BMI08_REG_ACCEL_RESERVED_5C, (uint8_t)(word >> 4));
+            rslt |= bmi088_spi_write(BMI08_REG_ACCEL_FEATURE_CFG, bmi088_dev.config_file_ptr + feat_index,
+                                     BMI088_FEATURE_BURST_LEN, &cs_accel);
+            feat_index += BMI088_FEATURE_BURST_LEN;
+            if(feat_index >= BMI08_CONFIG_STREAM_SIZE){
+                feat_state = BMI088_FEAT_COMMIT;
+            }
+            break;
+
+        case BMI088_FEAT_COMMIT:
+            rslt = bmi088_write_reg(&cs_accel, BMI08_REG_ACCEL_INIT_CTRL, BMI08_ENABLE);
+            feat_deadline_us = now_us + BMI08_MS_TO_US(BMI08_ASIC_INIT_TIME_MS);
+            feat_state = BMI088_FEAT_CHECK;
+            break;
+
+        case BMI088_FEAT_CHECK:
+            /* Octet factice de l'accéléromètre en tête de lecture */
+            rslt = bmi088_spi_read(BMI08_REG_ACCEL_INTERNAL_STAT, stat, 2, &cs_accel);
+            if(rslt == BMI08_OK && stat[1] != BMI08_INIT_OK){
+                rslt = BMI08_E_CONFIG_STREAM_ERROR;
+            }
+            if(rslt == BMI08_OK){
+                feat_state = BMI088_FEAT_IDLE;
+                rslt = bmi088_feat_finish();
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if(rslt != BMI08_OK){
+        feat_deadline_us = now_us + BMI088_BUS_RETRY_US;
+        feat_state = BMI088_FEAT_START;
+    }
+
+    bmi088_bus_resume();
+}
+#endif
+
+/**
+ * @brief  Ré-applique le mode d'acquisition actif, capteurs configurés.
+ * @details Synchronisation Accel/Gyro, détection any-motion, FIFO et/ou data-ready
+ * (y compris une demande data-ready ou any-motion mémorisée pendant le démarrage).
+ * @note   Les modes synchronisé et any-motion téléversent à nouveau le fichier de
+ * configuration de l'accéléromètre : en tâche de fond avec BMI088_FEATURE_LAZY (le bus
+ * redevient opérationnel avec les données de base), bloquant ~160 ms sinon. Le mode FIFO
+ * repasse par la couche Bosch et bloque aussi.
+ * @return BMI08_OK ou code d'erreur.
+ */
+static int8_t bmi088_apply_mode(void){
+    if(data_sync_mode != BMI08_ACCEL_DATA_SYNC_MODE_OFF){
+#if BMI088_FEATURE_LAZY
+        /* Acquisitions déclenchées par la tâche IMU jusqu'à la fin du téléversement */
+        if(drdy_pin != 0){
+            HAL_NVIC_DisableIRQ(BMI088_INT_ACC_IRQn);
+            drdy_pin = 0;
+        }
+        feat_sync_mode = data_sync_mode;
+        data_sync_mode = BMI08_ACCEL_DATA_SYNC_MODE_OFF;
+        bmi088_feat_request();
+        return BMI08_OK;
+#else
+        return BMI088_DataSync_Init(data_sync_mode);
+#endif
+    }
+
+    int8_t rslt = BMI08_OK;
+
+    if(motion_thr_mg != 0){
+#if BMI088_FEATURE_LAZY
+        bmi088_feat_request();
+#else
+        rslt = bmi088_motion_setup();
+#endif
+    }
+
+    if(fifo_accel_period_us != 0){
+        rslt = BMI088_FIFO_Init(bmi088_dev.accel_cfg.odr, bmi088_dev.gyro_cfg.odr, gyro_fifo_conf.wm_level);
+    }
+
+    if(rslt == BMI08_OK && (drdy_pin != 0 || drdy_pending)){
+        rslt = bmi088_drdy_config(drdy_source);
+        if(rslt == BMI08_OK){
+            drdy_pending = 0;
+        }
+    }
+
+    return (rslt != BMI08_OK) ? BMI08_E_COM_FAIL : BMI08_OK;
+}
+
+/**
+ * @brief Contrôle d'une étape de la séquence du bus : en échec, la séquence repart de la
+ * ré-initialisation de SPI1 après BMI088_BUS_RETRY_US.
+ */
+#define BMI088_BUS_CHECK(pt, now_us, rslt)                                      \
+    do{                                                                         \
+        if((rslt) != BMI08_OK){                                                 \
+            bus_state = BMI088_BUS_SPI_REINIT;                                  \
+            PT_RESTART_AT(pt, (now_us) + BMI088_BUS_RETRY_US);                  \
+        }                                                                       \
+    }while(0)
+
+/**
+ * @brief  Séquence de démarrage ou de récupération du bus (protothread).
+ * @details Ré-initialisation de SPI1 (récupération seulement), soft reset de chaque
+ * capteur, initialisation Bosch puis configuration. Les délais de redémarrage et de
+ * configuration des capteurs sont des attentes datées, les étapes sans délai rendent
+ * la main entre elles : chaque appel exécute au plus une étape.
+ * @param  pt     Protothread (bus_pt).
+ * @param  now_us Timestamp actuel en microsecondes.
+ * @return PT_ENDED une fois le bus opérationnel.
+ */
+static pt_status_t bmi088_bus_thread(pt_t *pt, uint64_t now_us){
+    int8_t rslt;
+
+    PT_BEGIN(pt);
+
+    if(bus_state == BMI088_BUS_SPI_REINIT){
+        (void)bmi088_bus_suspend();
+        spi_bus_abort();
+        dma_state = BMI088_DMA_IDLE;
+
+        /* Init conserve le prédiviseur courant (tenu à jour par SPI1_Set_Prescaler) */
+        rslt = BMI08_E_COM_FAIL;
+        if(spi_bus_lock()){
+            if(HAL_SPI_DeInit(bmi088_hspi) == HAL_OK && HAL_SPI_Init(bmi088_hspi) == HAL_OK){
+                rslt = BMI08_OK;
+            }
+            spi_bus_unlock();
+            spi_br_cached = UINT32_MAX;
+        }
+        BMI088_BUS_CHECK(pt, now_us, rslt);
+        PT_YIELD(pt);
+    }
+
+    bus_state = BMI088_BUS_ACCEL_RESET;
+    motion_loaded = 0;
+#if BMI088_FEATURE_LAZY
+    feat_state = BMI088_FEAT_IDLE;
+#endif
+    BMI088_BUS_CHECK(pt, now_us, bmi088_soft_reset_sensor(&cs_accel, BMI08_REG_ACCEL_SOFTRESET));
+    PT_SLEEP_US(pt, now_us, BMI088_ACCEL_RESET_DELAY_US);
+
+    bus_state = BMI088_BUS_GYRO_RESET;
+    BMI088_BUS_CHECK(pt, now_us, bmi088_soft_reset_sensor(&cs_gyro, BMI08_REG_GYRO_SOFTRESET));
+    PT_SLEEP_US(pt, now_us, BMI088_GYRO_RESET_DELAY_US);
+
+    /* bmi08a_init refait la lecture factice qui repasse l'accéléromètre en SPI */
+    bus_state = BMI088_BUS_REINIT;
+    rslt  = bmi08a_init(&bmi088_dev);
+    rslt |= bmi08g_init(&bmi088_dev);
+    BMI088_BUS_CHECK(pt, now_us, rslt);
+    PT_YIELD(pt);
+
+    bus_state = BMI088_BUS_ACCEL_PWR_CONF;
+    BMI088_BUS_CHECK(pt, now_us, bmi088_write_reg(&cs_accel, BMI08_REG_ACCEL_PWR_CONF, bmi088_dev.accel_cfg.power));
+    PT_SLEEP_US(pt, now_us, BMI088_POWER_CONF_DELAY_US);
+
+    bus_state = BMI088_BUS_ACCEL_PWR_CTRL;
+    BMI088_BUS_CHECK(pt, now_us, bmi088_write_reg(&cs_accel, BMI08_REG_ACCEL_PWR_CTRL, BMI08_ACCEL_POWER_ENABLE));
+    PT_SLEEP_US(pt, now_us, BMI088_POWER_CONF_DELAY_US);
+
+    /* Réécrite si BMI088_Set_Config() change les champs pendant le délai de prise en compte */
+    do{
+        bus_state = BMI088_BUS_MEAS_CONF;
+        bus_meas_redo = 0;
+        BMI088_BUS_CHECK(pt, now_us, bmi088_write_meas_conf());
+        PT_SLEEP_US(pt, now_us, BMI088_ACCEL_CONF_DELAY_US);
+    }while(bus_meas_redo);
+
+    bus_state = BMI088_BUS_MODE;
+    BMI088_BUS_CHECK(pt, now_us, bmi088_apply_mode());
+
+    bmi088_update_scales();
+    bus_fail_streak = 0;
+    if(bus_booting){
+        bus_booting = 0;
+#if BMI088_SELFTEST_AT_BOOT
+        BMI088_SelfTest_Start();
+#endif
+    }
+    else{
+        bus_recoveries++;
+        DLOG1(DLOG_IMU_BUS_RECOVERED, bus_recoveries);
+    }
+    bus_state = BMI088_BUS_OK;
+    bmi088_bus_resume();
+
+    PT_END(pt);
+}
+
+/** @brief Valeur de ACC_CONF imposée par l'auto-test accéléromètre (1,6 kHz, filtre normal). */
+#define BMI088_SELFTEST_ACC_CONF                                                \
+    ((uint8_t)(((BMI08_ACCEL_BW_NORMAL << BMI08_ACCEL_BW_POS) & BMI08_ACCEL_BW_MASK) | BMI08_ACCEL_ODR_1600_HZ))
+
+/**
+ * @brief  Lit une mesure brute de l'accéléromètre par lecture bloquante (hors DMA).
+ * @param  xyz Mesure [X, Y, Z] (LSB).
+ * @return BMI08_OK ou code d'erreur SPI.
+ */
+static int8_t bmi088_st_read_accel(int16_t xyz[3]){
+    uint8_t buf[7];
+
+    /* Octet factice de l'accéléromètre en tête de lecture */
+    const int8_t rslt = bmi088_spi_read(BMI08_REG_ACCEL_X_LSB, buf, sizeof(buf), &cs_accel);
+    for(uint8_t i = 0; i < 3u; i++){
+        xyz[i] = (int16_t)((uint16_t)buf[2u * i + 1u] | ((uint16_t)buf[2u * i + 2u] << 8));
+    }
+
+    return rslt;
+}
+
+/**
+ * @brief  Termine l'auto-test sur une erreur SPI.
+ * @details Tente de sortir l'accéléromètre de l'excitation et de restaurer la
+ * configuration de mesure ; une récupération du bus, si elle suit, s'en charge sinon.
+ */
+static void bmi088_st_abort(void){
+    (void)bmi088_write_reg(&cs_accel, BMI08_REG_ACCEL_SELF_TEST, BMI08_ACCEL_SWITCH_OFF_SELF_TEST);
+    (void)bmi088_write_meas_conf();
+
+    PT_INIT(&st_pt);
+    st_hold = 0;
+    st_state = BMI088_ST_E_COM;
+    DLOG2(DLOG_IMU_SELFTEST, st_state, st_fail);
+}
+
+/** @brief Contrôle d'une étape de l'auto-test : en échec, l'auto-test est abandonné (BMI088_ST_E_COM). */
+#define BMI088_ST_CHECK(rslt)                                                   \
+    do{                                                                         \
+        if((rslt) != BMI08_OK){                                                 \
+            bmi088_st_abort();                                                  \
+            return PT_ENDED;                                                    \
+        }                                                                       \
+    }while(0)
+
+/**
+ * @brief  Auto-test des capteurs (protothread).
+ * @details Gyroscope : auto-test intégré (bist_rdy puis bist_fail de GYRO_SELF_TEST),
+ * scruté à chaque passage jusqu'à BMI088_SELFTEST_GYRO_TIMEOUT_US. Accéléromètre :
+ * ±24 g à 1,6 kHz, mesures sous excitation positive puis négative après
+ * BMI088_SELFTEST_SETTLE_US chacune ; l'écart doit atteindre 1000 mg sur X et Y,
+ * 500 mg sur Z (datasheet). L'excitation coupée, la configuration de mesure est
+ * restaurée. Les attentes sont des échéances : la séquence dure ~200 ms sans
+ * jamais bloquer la boucle principale.
+ * @param  pt     Protothread (st_pt).
+ * @param  now_us Timestamp actuel en microsecondes.
+ * @return PT_ENDED une fois le résultat publié.
+ */
+static pt_status_t bmi088_st_thread(pt_t *pt, uint64_t now_us){
+    uint8_t reg = 0;
+    int16_t neg[3];
+
+    PT_BEGIN(pt);
+
+    st_hold = 1;
+    st_fail = 0;
+    BMI088_ST_CHECK(bmi088_write_reg(&cs_gyro, BMI08_REG_GYRO_SELF_TEST, BMI08_GYRO_SELF_TEST_EN_MASK));
+    st_gyro_limit_us = now_us + BMI088_SELFTEST_GYRO_TIMEOUT_US;
+    do{
+        PT_YIELD(pt);
+        BMI088_ST_CHECK(bmi088_spi_read(BMI08_REG_GYRO_SELF_TEST, &reg, 1, &cs_gyro));
+    }while((reg & BMI08_GYRO_SELF_TEST_RDY_MASK) == 0u && now_us < st_gyro_limit_us);
+    if((reg & BMI08_GYRO_SELF_TEST_RDY_MASK) == 0u || (reg & BMI08_GYRO_SELF_TEST_RESULT_MASK) != 0u){
+        st_fail |= BMI088_ST_FAIL_GYRO;
+    }
+
+    BMI088_ST_CHECK(bmi088_write_reg(&cs_accel, BMI08_REG_ACCEL_RANGE, BMI088_ACCEL_RANGE_24G));
+    BMI088_ST_CHECK(bmi088_write_reg(&cs_accel, BMI08_REG_ACCEL_CONF, BMI088_SELFTEST_ACC_CONF));
+    PT_SLEEP_US(pt, now_us, BMI08_MS_TO_US(BMI08_SELF_TEST_DELAY_MS));
+
+    BMI088_ST_CHECK(bmi088_write_reg(&cs_accel, BMI08_REG_ACCEL_SELF_TEST, BMI08_ACCEL_POSITIVE_SELF_TEST));
+    PT_SLEEP_US(pt, now_us, BMI088_SELFTEST_SETTLE_US);
+    BMI088_ST_CHECK(bmi088_st_read_accel(st_pos));
+
+    BMI088_ST_CHECK(bmi088_write_reg(&cs_accel, BMI08_REG_ACCEL_SELF_TEST, BMI08_ACCEL_NEGATIVE_SELF_TEST));
+    PT_SLEEP_US(pt, now_us, BMI088_SELFTEST_SETTLE_US);
+    BMI088_ST_CHECK(bmi088_st_read_accel(neg));
+
+    if((int32_t)st_pos[0] - neg[0] < BMI088_SELFTEST_MIN_XY_LSB){
+        st_fail |= BMI088_ST_FAIL_ACC_X;
+    }
+    if((int32_t)st_pos[1] - neg[1] < BMI088_SELFTEST_MIN_XY_LSB){
+        st_fail |= BMI088_ST_FAIL_ACC_Y;
+    }
+    if((int32_t)st_pos[2] - neg[2] < BMI088_SELFTEST_MIN_Z_LSB){
+        st_fail |= BMI088_ST_FAIL_ACC_Z;
+    }
+
+    BMI088_ST_CHECK(bmi088_write_reg(&cs_accel, BMI08_REG_ACCEL_SELF_TEST, BMI08_ACCEL_SWITCH_OFF_SELF_TEST));
+    PT_SLEEP_US(pt, now_us, BMI088_SELFTEST_SETTLE_US);
+
+    /* Configuration courante, y compris une modification reçue pendant l'auto-test */
+    BMI088_ST_CHECK(bmi088_write_meas_conf());
+    PT_SLEEP_US(pt, now_us, BMI088_ACCEL_CONF_DELAY_US);
+
+    st_hold = 0;
+    st_state = (st_fail != 0u) ? BMI088_ST_FAIL : BMI088_ST_PASS;
+    DLOG2(DLOG_IMU_SELFTEST, st_state, st_fail);
+
+    PT_END(pt);
+}
+
+/**
+ * @brief  Exécute une étape de l'auto-test, bus opérationnel.
+ * @details Comme le téléversement en tâche de fond, chaque étape attend la fin de
+ * l'acquisition DMA en cours ; les acquisitions suivantes sont refusées (st_hold)
+ * jusqu'à la restauration de la configuration.
+ * @param  now_us Timestamp actuel en microsecondes.
+ */
+static void bmi088_st_poll(uint64_t now_us){
+    if(st_state != BMI088_ST_RUNNING || now_us < st_pt.wake_us){
+        return;
+    }
+
+    if(bmi088_bus_suspend()){
+        (void)bmi088_st_thread(&st_pt, now_us);
+    }
+
+    bmi088_bus_resume();
+}
+
+/**
+ * @brief  Exécute l'accès aux registres en tête de file, bus opérationnel.
+ * @details Attend une fenêtre sans acquisition DMA au lieu de la forcer : la requête
+ * reste en file jusqu'au prochain passage. Une lecture ne dure que quelques µs ; une
+ * écriture ajoute le délai Bosch (2 µs capteur actif, 450 µs en veille).
+ */
+static void bmi088_regio_poll(void){
+    if(regio_next == regio_head || dma_state != BMI088_DMA_IDLE){
+        return;
+    }
+
+    if(bmi088_bus_suspend()){
+        bmi088_regio_t *io = &regio_queue[regio_next % BMI088_REGIO_QUEUE_LEN];
+        int8_t rslt = BMI08_OK;
+
+        if(io->write){
+            rslt = io->sensor ? bmi08g_set_regs(io->addr, io->data, 1, &bmi088_dev) :
+                                bmi08a_get_set_regs(io->addr, io->data, 1, &bmi088_dev, SET_FUNC);
+        }
+        if(rslt == BMI08_OK){
+            rslt = io->sensor ? bmi08g_get_regs(io->addr, io->data, io->len, &bmi088_dev) :
+                                bmi08a_get_set_regs(io->addr, io->data, io->len, &bmi088_dev, GET_FUNC);
+        }
+        io->status = rslt;
+        regio_next++;
+    }
+
+    bmi088_bus_resume();
+}
+
+/**
+ * @brief  Surveille le bus SPI et fait avancer la séquence de démarrage ou de récupération.
+ * @details Au-delà de BMI088_BUS_FAIL_THRESHOLD échecs consécutifs, la séquence
+ * (bmi088_bus_thread()) ré-initialise SPI1, envoie un soft reset à chaque capteur,
+ * relance l'initialisation Bosch puis ré-applique la configuration. Le démarrage
+ * asynchrone suit la même séquence à partir du soft reset. Les délais de
+ * redémarrage et de configuration des capteurs sont des échéances et non des
+ * attentes actives : chaque appel exécute au plus une étape et rend la main.
+ * Une étape en échec relance la séquence après BMI088_BUS_RETRY_US.
+ * Pendant la séquence, les acquisitions renvoient BMI088_E_BUSY.
+ * Bus opérationnel, chaque appel fait aussi avancer d'une étape un téléversement
+ * de fichier de configuration en tâche de fond (BMI088_FEATURE_LAZY), puis, une fois
+ * celui-ci terminé, l'auto-test des capteurs ; hors auto-test, un accès aux registres en file.
+ * @param  now_us Timestamp actuel en microsecondes.
+ * @return Date de l'étape suivante (µs), UINT64_MAX si aucune séquence n'est en cours.
+ */
+uint64_t BMI088_Bus_Poll(uint64_t now_us){
+    if(bmi088_hspi == NULL){
+        return UINT64_MAX;
+    }
+
+    bmi088_dma_abort_stalled();
+
+    if(bus_state == BMI088_BUS_OK){
+#if BMI088_FEATURE_LAZY
+        bmi088_feat_poll(now_us);
+        if(feat_state != BMI088_FEAT_IDLE){
+            return UINT64_MAX;
+        }
+#endif
+        bmi088_st_poll(now_us);
+        if(st_state != BMI088_ST_RUNNING){
+            bmi088_regio_poll();
+        }
+        return UINT64_MAX;
+    }
+
+    if(now_us < bus_pt.wake_us){
+        return bus_pt.wake_us;
+    }
+
+    if(bmi088_bus_thread(&bus_pt, now_us) == PT_ENDED){
+        return UINT64_MAX;
+    }
+
+    return pt_next_us(&bus_pt, now_us);
+}
+
+/**
+ * @brief  Demande la séquence de récupération hors échec SPI (capteur figé ou muet).
+ * @details Même séquence qu'après BMI088_BUS_FAIL_THRESHOLD échecs consécutifs, déroulée
+ * par BMI088_Bus_Poll() ; comptée dans bmi088_bus_stats_t::recoveries à son terme.
+ * @return BMI08_OK si la séquence est armée, BMI088_E_BUSY si un démarrage ou une
+ * récupération est déjà en cours.
+ */
+int8_t BMI088_Recover(void){
+    int8_t rslt = BMI088_E_BUSY;
+
+    __disable_irq();
+    if(bus_state == BMI088_BUS_OK){
+        bmi088_bus_arm_recovery();
+        rslt = BMI08_OK;
+    }
+    __enable_irq();
+
+    return rslt;
+}
+
+/**
+ * @brief  Copie les compteurs d'erreurs du bus SPI.
+ * @param  stats Structure de sortie.
+ */
+void BMI088_Get_Bus_Stats(bmi088_bus_stats_t *stats){
+    if(stats == NULL){
+        return;
+    }
+
+    stats->timeouts   = bus_timeouts;
+    stats->errors     = bus_errors;
+    stats->recoveries = bus_recoveries;
+    stats->recovering = (bus_state != BMI088_BUS_OK) ? 1u : 0u;
+}
+
+/**
+ * @brief  Lance une calibration par moyennage, ou efface la calibration enregistrée.
+ * @details Le moyennage porte sur les BMI088_CAL_SAMPLES échantillons suivants de la
+ * file, à la cadence d'acquisition (2.6 s à 100 Hz). L'effacement est bloquant
+ * (une page de flash, 40 ms au plus).
+ * @param  req Demande (bmi088_cal_req_t).
+ * @return BMI08_OK, BMI08_E_INVALID_INPUT si la demande est inconnue, BMI08_E_COM_FAIL
+ * si l'effacement de la flash échoue.
+ */
+int8_t BMI088_Calibrate(uint8_t req){
+    static const bmi088_offsets_t zero = { 0 };
+
+    switch(req){
+        case BMI088_CAL_REQ_GYRO:
+        case BMI088_CAL_REQ_GYRO_ACCEL:
+            bmi088_cal_begin(req);
+            return BMI08_OK;
+
+        case BMI088_CAL_REQ_CLEAR:
+            bmi088_cal_apply(&zero);
+            cal_stored = 0;
+            cal_state = BMI088_CAL_IDLE;
+            return (nv_flash_erase_page(NV_FLASH_CALIB_START) == 0) ? BMI08_OK : BMI08_E_COM_FAIL;
+
+        default:
+            return BMI08_E_INVALID_INPUT;
+    }
+}
+
+/**
+ * @brief  État de la dernière calibration.
+ * @return bmi088_cal_state_t.
+ */
+uint8_t BMI088_Cal_State(void){
+    return cal_state;
+}
+
+/**
+ * @brief  Indique si les offsets actifs proviennent d'un enregistrement en flash.
+ * @return 1 si un enregistrement valide existe, 0 sinon.
+ */
+uint8_t BMI088_Cal_Stored(void){
+    return cal_stored;
+}
+
+/**
+ * @brief  Copie les offsets actifs.
+ * @param  ofs Structure de sortie.
+ */
+void BMI088_Get_Offsets(bmi088_offsets_t *ofs){
+    if(ofs == NULL){
+        return;
+    }
+
+    *ofs = cal_ofs;
+}
+
+/**
+ * @brief  Lance l'auto-test des capteurs en tâche de fond.
+ * @details Déroulé par BMI088_Bus_Poll() (bmi088_st_thread()) une fois le bus
+ * opérationnel et tout téléversement terminé. Sans effet si un auto-test est déjà en cours.
+ */
+void BMI088_SelfTest_Start(void){
+    if(st_state == BMI088_ST_RUNNING){
+        return;
+    }
+
+    PT_INIT(&st_pt);
+    st_fail = 0;
+    st_state = BMI088_ST_RUNNING;
+}
+
+/**
+ * @brief  Résultat du dernier auto-test.
+ * @return bmi088_st_state_t | (bmi088_st_fail_t << 8).
+ */
+uint16_t BMI088_SelfTest_Status(void){
+    return (uint16_t)(st_state | ((uint16_t)st_fail << 8));
+}
+
+/**
+ * @brief  Met en file un accès direct aux registres des capteurs.
+ * @param  cmd Valeur écrite dans REG_BMI (BMI088_REGIO_*).
+ * @return BMI08_OK, BMI08_E_INVALID_INPUT ou BMI088_E_BUSY.
+ */
+int8_t BMI088_RegIO_Request(uint16_t cmd){
+    if((uint8_t)(regio_head - regio_tail) >= BMI088_REGIO_QUEUE_LEN){
+        return BMI088_E_BUSY;
+    }
+
+    bmi088_regio_t *io = &regio_queue[regio_head % BMI088_REGIO_QUEUE_LEN];
+
+    if(cmd & BMI088_REGIO_WRITE){
+        if(regio_sel == 0xFFu){
+            return BMI08_E_INVALID_INPUT;
+        }
+        io->write   = 1;
+        io->sensor  = (uint8_t)(regio_sel >> 7);
+        io->addr    = (uint8_t)(regio_sel & BMI088_REGIO_ADDR_MASK);
+        io->len     = 1;
+        io->data[0] = (uint8_t)cmd;
+    }
+    else{
+        io->write  = 0;
+        io->sensor = (cmd & BMI088_REGIO_GYRO) ? 1u : 0u;
+        io->addr   = (uint8_t)(cmd & BMI088_REGIO_ADDR_MASK);
+        io->len    = (uint8_t)(((cmd >> BMI088_REGIO_LEN_SHIFT) & BMI088_REGIO_LEN_MASK) + 1u);
+        regio_sel  = (uint8_t)((io->sensor << 7) | io->addr);
+    }
+    io->status = BMI08_OK;
+    regio_head++;
+
+    return BMI08_OK;
+}
+
+/**
+ * @brief  Retire un accès aux registres terminé.
+ * @param  io Sortie.
+ * @return 1 si un résultat a été retiré, 0 sinon.
+ */
+uint8_t BMI088_RegIO_Pop(bmi088_regio_t *io){
+    if(io == NULL || regio_tail == regio_next){
+        return 0;
+    }
+
+    *io = regio_queue[regio_tail % BMI088_REGIO_QUEUE_LEN];
+    regio_tail++;
+
+    return 1;
+}
@@ -8,64 +8,194 @@
 
 #include "driver_motor.h"
 #include "tim.h"
+#include "mem_map.h"
+#if MOTOR_TRAC_ENABLE
+#include "dlog.h"
+#endif
 
-// 64Mhz - PSC=19 - ARR=63999 soit PWM{50Hz, duty=50%}
+// Base de temps et bornes d'impulsion : constantes ACT_PWM_* / ACT_PULSE_* (actuators.h)
 
-/** @brief Durée de l'état de freinage actif lors d'une inversion de sens (ms). */
-#define T_BRAKE_MS          120
-/** @brief Durée de pause au point mort après un freinage (ms). */
-#define T_NEUTRAL_GAP_MS    120
-/** @brief Rapport cyclique (%) correspondant au point mort (arrêt). */
+/** @brief Rapport cyclique (%) du point mort : borne de la profondeur de frein. */
 #define PWM_NEUTRAL         50u
-/** @brief Rapport cyclique (%) pour le freinage en marche arrière. */
-#define PWM_BRAKE_REV       40u
-/** @brief Rapport cyclique (%) pour le freinage en marche avant. */
-#define PWM_BRAKE_FWD       60u
+/** @brief Borne de l'erreur de vitesse prise en compte par la boucle (mm/s, évite les débordements). */
+#define LOOP_ERR_MAX_MMS    8000
+/** @brief Borne du terme intégral (Q12, ±50 % PWM). */
+#define LOOP_INTEG_MAX_Q12  (50 << MOTOR_LOOP_Q)
 
-static uint8_t motor_speed_mms_to_pwm_percent(Motor_Handle_t *hmotor, int16_t value);
+/**
+ * @name Sélections de la table des états
+ * @{
+ */
+#define MOTOR_PWM_NEUTRAL   0u      ///< Point mort.
+#define MOTOR_PWM_TARGET    1u      ///< Consigne (feed-forward + boucle de vitesse).
+#define MOTOR_PWM_BRAKE_REV 2u      ///< Impulsion sous le neutre (frein depuis l'avant, amorce de marche arrière).
+#define MOTOR_PWM_BRAKE_FWD 3u      ///< Impulsion au-dessus du neutre (frein depuis l'arrière).
+
+#define MOTOR_TIMER_NONE    0u      ///< État stable, sans échéance.
+#define MOTOR_TIMER_BRAKE   1u      ///< Durée Motor_Esc_Profile_t::brake_ms.
+#define MOTOR_TIMER_GAP     2u      ///< Durée Motor_Esc_Profile_t::neutral_gap_ms.
+
+#define MOTOR_TARGET_NEUTRAL 0u     ///< Cible nulle.
+#define MOTOR_TARGET_FORWARD 1u     ///< Cible en marche avant.
+#define MOTOR_TARGET_REVERSE 2u     ///< Cible en marche arrière.
+
+#define MOTOR_ROW_NEUTRAL   0u      ///< Transitions depuis le neutre.
+#define MOTOR_ROW_FORWARD   1u      ///< Transitions depuis la marche avant.
+#define MOTOR_ROW_REVERSE   2u      ///< Transitions depuis la marche arrière.
+#define MOTOR_ROW_GAP_END   3u      ///< Transitions en fin de pause au neutre (sens direct).
+#define MOTOR_ROW_NONE      0xFFu   ///< État temporisé à successeur fixe.
+/** @} */
+
+/** @brief Nombre d'états de la machine à états (MotorState_t). */
+#define MOTOR_STATE_COUNT   (MOTOR_STATE_NEUTRAL_TO_REVERSE_GAP + 1)
 
 /**
- * @brief  Écrit la valeur brute dans le registre de comparaison du Timer PWM.
+ * @brief Description d'un état : commande appliquée, temporisation et transitions.
+ */
+typedef struct{
+    uint8_t      pwm;      ///< Commande appliquée dans l'état (MOTOR_PWM_*).
+    uint8_t      timer;    ///< Temporisation de l'état (MOTOR_TIMER_*).
+    uint8_t      row;      ///< Ligne de motor_target_table évaluée (MOTOR_ROW_*), à échéance si temporisé.
+    MotorState_t next;     ///< Successeur à échéance si row vaut MOTOR_ROW_NONE.
+} motor_state_desc_t;
+
+/** @brief Table des états, indexée par MotorState_t. */
+static const motor_state_desc_t motor_state_table[MOTOR_STATE_COUNT] = {
+    [MOTOR_STATE_NEUTRAL]                = { MOTOR_PWM_NEUTRAL,   MOTOR_TIMER_NONE,  MOTOR_ROW_NEUTRAL, MOTOR_STATE_NEUTRAL },
+    [MOTOR_STATE_FORWARD_HOLD]           = { MOTOR_PWM_TARGET,    MOTOR_TIMER_NONE,  MOTOR_ROW_FORWARD, MOTOR_STATE_NEUTRAL },
+    [MOTOR_STATE_FWD_BRAKE_TAP]          = { MOTOR_PWM_BRAKE_REV, MOTOR_TIMER_BRAKE, MOTOR_ROW_NONE,    MOTOR_STATE_FWD_NEUTRAL_GAP },
+    [MOTOR_STATE_FWD_NEUTRAL_GAP]        = { MOTOR_PWM_NEUTRAL,   MOTOR_TIMER_GAP,   MOTOR_ROW_GAP_END, MOTOR_STATE_NEUTRAL },
+    [MOTOR_STATE_REVERSE_HOLD]           = { MOTOR_PWM_TARGET,    MOTOR_TIMER_NONE,  MOTOR_ROW_REVERSE, MOTOR_STATE_NEUTRAL },
+    [MOTOR_STATE_REV_BRAKE_TAP]          = { MOTOR_PWM_BRAKE_FWD, MOTOR_TIMER_BRAKE, MOTOR_ROW_NONE,    MOTOR_STATE_REV_NEUTRAL_GAP },
+    [MOTOR_STATE_REV_NEUTRAL_GAP]        = { MOTOR_PWM_NEUTRAL,   MOTOR_TIMER_GAP,   MOTOR_ROW_GAP_END, MOTOR_STATE_NEUTRAL },
+    [MOTOR_STATE_NEUTRAL_TO_REVERSE_TAP] = { MOTOR_PWM_BRAKE_REV, MOTOR_TIMER_BRAKE, MOTOR_ROW_NONE,    MOTOR_STATE_NEUTRAL_TO_REVERSE_GAP },
+    [MOTOR_STATE_NEUTRAL_TO_REVERSE_GAP] = { MOTOR_PWM_NEUTRAL,   MOTOR_TIMER_GAP,   MOTOR_ROW_GAP_END, MOTOR_STATE_NEUTRAL },
+};
+
+/**
+ * @brief Transitions selon la cible : [ligne MOTOR_ROW_*][MOTOR_TARGET_*].
+ * @details Une inversion depuis une marche stable (ou l'amorce de marche arrière depuis
+ * le neutre, propre aux ESC voiture) passe par un coup de frein puis une pause.
+ */
+static const MotorState_t motor_target_table[4][3] = {
+    [MOTOR_ROW_NEUTRAL] = { MOTOR_STATE_NEUTRAL, MOTOR_STATE_FORWARD_HOLD,  MOTOR_STATE_NEUTRAL_TO_REVERSE_TAP },
+    [MOTOR_ROW_FORWARD] = { MOTOR_STATE_NEUTRAL, MOTOR_STATE_FORWARD_HOLD,  MOTOR_STATE_FWD_BRAKE_TAP },
+    [MOTOR_ROW_REVERSE] = { MOTOR_STATE_NEUTRAL, MOTOR_STATE_REV_BRAKE_TAP, MOTOR_STATE_REVERSE_HOLD },
+    [MOTOR_ROW_GAP_END] = { MOTOR_STATE_NEUTRAL, MOTOR_STATE_FORWARD_HOLD,  MOTOR_STATE_REVERSE_HOLD },
+};
+
+static uint16_t motor_speed_mms_to_ticks(const Motor_Handle_t *hmotor, int16_t value);
+static int32_t motor_loop_ticks(const Motor_Handle_t *hmotor, int32_t corr_q12);
+static uint16_t motor_clamp_ticks(const Motor_Handle_t *hmotor, int32_t ticks, bool forward);
+static uint16_t motor_trac_limit(const Motor_Handle_t *hmotor, uint16_t ticks);
+
+/**
+ * @brief  Mémorise la valeur brute de comparaison, appliquée par motor_apply().
  * @param  hmotor Pointeur vers le handle du moteur.
  * @param  value  Valeur en ticks d'horloge à appliquer.
  */
 static inline void pwm_pulse(Motor_Handle_t *hmotor, uint16_t value){
-    if (hmotor && hmotor->htim) {
-        __HAL_TIM_SET_COMPARE(hmotor->htim, hmotor->channel, value);
+    if (hmotor) {
+        hmotor->pulse_ticks = value;
     }
 }
 
 /**
- * @brief  Mappe un pourcentage (0-100%) vers la plage de ticks du Timer.
- * @param  hmotor  Pointeur vers le handle du moteur (contient min/max ticks).
- * @param  percent Pourcentage cible.
- * @return Valeur correspondante en ticks Timer.
+ * @brief  Met à jour la consigne CCR de marche, en signalant un changement à la machine à états.
+ * @param  hmotor Pointeur vers le handle du moteur.
+ * @param  ticks  Nouvelle consigne (ticks CCR).
  */
-static inline uint16_t motor_map_percent(Motor_Handle_t *hmotor, int16_t percent){
-    if (percent < 0)   percent = 0;
-    if (percent > 100) percent = 100;
+static inline void motor_set_target_ticks(Motor_Handle_t *hmotor, uint16_t ticks){
+    ticks = motor_trac_limit(hmotor, ticks);
+    if(hmotor->ctx.target_ticks != ticks){
+        hmotor->ctx.target_ticks = ticks;
+        hmotor->pending = true;
+    }
+}
 
+/**
+ * @brief  Précalcule les pentes de conversion vers les ticks CCR.
+ * @details Seules divisions du chemin de commande, exécutées une fois à l'initialisation.
+ * @param  hmotor Pointeur vers le handle du moteur.
+ */
+static void motor_map_init(Motor_Handle_t *hmotor){
     const uint16_t min = hmotor->min_pulse_ticks;
     const uint16_t max = hmotor->max_pulse_ticks;
+    Motor_Pwm_Map_t *map = &hmotor->map;
 
-    return (uint16_t)(min + ((uint32_t)(max - min) * (uint32_t)percent) / 100u);
+    map->neutral_ticks = (uint16_t)(min + (uint16_t)(max - min) / 2u);
+    map->fwd_slope_q16 = (hmotor->max_speed_pos_mms > 0) ?
+                         ((uint32_t)(max - map->neutral_ticks) << 16) / (uint32_t)hmotor->max_speed_pos_mms : 0u;
+    map->rev_slope_q16 = (hmotor->max_speed_neg_mms < 0) ?
+                         ((uint32_t)(map->neutral_ticks - min) << 16) / (uint32_t)(-hmotor->max_speed_neg_mms) : 0u;
+    map->ticks_per_pct_q16 = ((uint32_t)(max - min) << 16) / 100u;
+    map->supply_comp_q12 = 4096u;
 }
 
 /**
- * @brief  Convertit une vitesse linéaire (mm/s) en pourcentage PWM.
- * @note   Gère l'asymétrie des vitesses maximales avant et arrière.
+ * @brief  Précalcule les consignes CCR de frein à partir du profil ESC.
+ * @param  hmotor Pointeur vers le handle du moteur.
+ */
+static void motor_map_brake(Motor_Handle_t *hmotor){
+    const uint16_t depth = (uint16_t)(((uint32_t)hmotor->esc.brake_depth * hmotor->map.ticks_per_pct_q16) >> 16);
+
+    hmotor->map.brake_fwd_ticks = (uint16_t)(hmotor->map.neutral_ticks + depth);
+    hmotor->map.brake_rev_ticks = (uint16_t)(hmotor->map.neutral_ticks - depth);
+}
+
+/**
+ * @brief  Convertit une vitesse linéaire (mm/s) en consigne CCR.
+ * @note   Gère l'asymétrie des vitesses maximales avant et arrière. Pente Q16
+ * précalculée : une multiplication 32 bits, sans débordement puisque |value| reste
+ * sous la vitesse maximale du sens considéré. L'écart au neutre est ensuite corrigé
+ * de la tension d'alimentation (supply_comp_q12) et borné à la demi-plage du sens.
  * @param  hmotor Pointeur vers le handle du moteur.
  * @param  value  Vitesse cible en mm/s.
- * @return Pourcentage PWM calculé (0 à 100).
+ * @return Consigne en ticks Timer (min_pulse_ticks à max_pulse_ticks).
+ */
+static uint16_t motor_speed_mms_to_ticks(const Motor_Handle_t *hmotor, int16_t value){
+    const uint16_t neutral = hmotor->map.neutral_ticks;
+    uint32_t offset;
+
+    if (value >= hmotor->max_speed_pos_mms) return hmotor->max_pulse_ticks;
+    if (value <= hmotor->max_speed_neg_mms) return hmotor->min_pulse_ticks;
+
+    if (value >= 0){
+        offset = ((((uint32_t)value * hmotor->map.fwd_slope_q16) >> 16) * hmotor->map.supply_comp_q12) >> 12;
+        return (offset > (uint32_t)(hmotor->max_pulse_ticks - neutral)) ? hmotor->max_pulse_ticks : (uint16_t)(neutral + offset);
+    }
+    else{
+        offset = ((((uint32_t)(-value) * hmotor->map.rev_slope_q16) >> 16) * hmotor->map.supply_comp_q12) >> 12;
+        return (offset > (uint32_t)(neutral - hmotor->min_pulse_ticks)) ? hmotor->min_pulse_ticks : (uint16_t)(neutral - offset);
+    }
+}
+
+/**
+ * @brief  Sortie de boucle en ticks : feed-forward + correction convertie, non bornée.
+ * @param  hmotor   Pointeur vers le handle du moteur.
+ * @param  corr_q12 Correction de la boucle (% PWM, Q12).
+ * @return Consigne CCR avant saturation.
+ */
+static int32_t motor_loop_ticks(const Motor_Handle_t *hmotor, int32_t corr_q12){
+    return (int32_t)hmotor->loop.ff_ticks +
+           (int32_t)(((int64_t)corr_q12 * hmotor->map.ticks_per_pct_q16) >> (16 + MOTOR_LOOP_Q));
+}
+
+/**
+ * @brief  Borne une consigne CCR à la moitié de plage du sens donné.
+ * @param  hmotor  Pointeur vers le handle du moteur.
+ * @param  ticks   Consigne non bornée.
+ * @param  forward Sens appliqué (true = avant).
+ * @return Consigne CCR bornée.
  */
-static uint8_t motor_speed_mms_to_pwm_percent(Motor_Handle_t *hmotor, int16_t value){
-    if (value >= hmotor->max_speed_pos_mms) return 100;
-    if (value <= hmotor->max_speed_neg_mms) return 0;
-
-    if (value >= 0)
-        return (uint8_t)(50 + ((int32_t)value * 50) / hmotor->max_speed_pos_mms);
-    else
-        return (uint8_t)(50 + ((int32_t)value * 50) / (-hmotor->max_speed_neg_mms));
+static uint16_t motor_clamp_ticks(const Motor_Handle_t *hmotor, int32_t ticks, bool forward){
+    const int32_t lo = forward ? hmotor->map.neutral_ticks : hmotor->min_pulse_ticks;
+    const int32_t hi = forward ? hmotor->max_pulse_ticks : hmotor->map.neutral_ticks;
+
+    if(ticks > hi) ticks = hi;
+    if(ticks < lo) ticks = lo;
+
+    return (uint16_t)ticks;
 }
 
 /**
@@ -82,7 +212,7 @@ static inline bool time_reached(uint32_t now, uint32_t deadline){
 /**
  * @brief  Initialise le moteur et sa machine à états.
  * @details Place le moteur au neutre, réinitialise le contexte de commande
- * et démarre la génération PWM hardware.
+ * place le PWM au neutre (préchargement CCR actif) et démarre la génération PWM hardware.
  * @param  hmotor Pointeur vers le handle du moteur à initialiser.
  */
 void motor_init(Motor_Handle_t *hmotor){
@@ -90,24 +220,64 @@ void motor_init(Motor_Handle_t *hmotor){
         hmotor->state = MOTOR_STATE_NEUTRAL;
         hmotor->go_forward = true;
         hmotor->ctx.target_speed_mms = 0;
-        hmotor->ctx.target_pwm = PWM_NEUTRAL;
+        hmotor->esc.brake_ms = MOTOR_ESC_BRAKE_MS_DEFAULT;
+        hmotor->esc.neutral_gap_ms = MOTOR_ESC_GAP_MS_DEFAULT;
+        hmotor->esc.brake_depth = MOTOR_ESC_BRAKE_DEPTH_DEFAULT;
+        motor_map_init(hmotor);
+        motor_map_brake(hmotor);
+
+        hmotor->ctx.target_ticks = hmotor->map.neutral_ticks;
         hmotor->ctx.target_forward = true;
         hmotor->ctx.deadline_ms = 0;
+        hmotor->pending = false;
+        hmotor->loop.ff_ticks = hmotor->map.neutral_ticks;
+        hmotor->loop.integ_q12 = 0;
+        hmotor->loop.prev_err_mms = 0;
+        hmotor->trac = (Motor_Traction_Det_t){ 0 };
 
+        __HAL_TIM_ENABLE_OCxPRELOAD(hmotor->htim, hmotor->channel);
+        pwm_pulse(hmotor, hmotor->map.neutral_ticks);
+        motor_apply(hmotor);
         HAL_TIM_PWM_Start(hmotor->htim, hmotor->channel);
     }
 }
 
+/**
+ * @brief  Applique la consigne PWM en attente au registre de comparaison.
+ * @details Le préchargement CCR (OCxPE) reporte la nouvelle valeur à l'événement
+ * d'update : pas d'impulsion tronquée vers l'ESC. Une consigne identique à la valeur
+ * déjà chargée n'entraîne aucun accès au bus. Sans effet en DShot : le CCR est alors
+ * écrit par le DMA (esc_dshot_update()).
+ * @param  hmotor Pointeur vers le handle du moteur.
+ */
+void motor_apply(Motor_Handle_t *hmotor){
+    if (hmotor && hmotor->htim && !MOTOR_OUT_IS_DSHOT(hmotor->output) && __HAL_TIM_GET_COMPARE(hmotor->htim, hmotor->channel) != hmotor->pulse_ticks) {
+        __HAL_TIM_SET_COMPARE(hmotor->htim, hmotor->channel, hmotor->pulse_ticks);
+    }
+}
+
+/**
+ * @brief  Force une consigne CCR directe, bornée à [min_pulse_ticks, max_pulse_ticks].
+ * @param  hmotor Pointeur vers le handle du moteur.
+ * @param  ticks  Consigne en ticks Timer.
+ */
+void motor_pwm_ticks(Motor_Handle_t *hmotor, uint16_t ticks){
+    if (ticks < hmotor->min_pulse_ticks) ticks = hmotor->min_pulse_ticks;
+    if (ticks > hmotor->max_pulse_ticks) ticks = hmotor->max_pulse_ticks;
+
+    pwm_pulse(hmotor, ticks);
+}
+
 /**
  * @brief  Force une commande PWM directe en pourcentage.
- * @note   Utilisé principalement par la machine à états pour appliquer
- * les commandes de freinage ou de neutre.
+ * @note   Conversion par la pente précalculée ticks_per_pct_q16 (sans division).
  * @param  hmotor  Pointeur vers le handle du moteur.
  * @param  percent Pourcentage PWM cible (0-100).
  */
 void motor_pwm_percent(Motor_Handle_t *hmotor, uint8_t percent){
-    uint16_t value = motor_map_percent(hmotor, (int16_t)percent);
-    pwm_pulse(hmotor, value);
+    if (percent > 100u) percent = 100u;
+
+    motor_pwm_ticks(hmotor, (uint16_t)(hmotor->min_pulse_ticks + (((uint32_t)percent * hmotor->map.ticks_per_pct_q16) >> 16)));
 }
 
 /**
@@ -118,153 +288,334 @@ void motor_pwm_percent(Motor_Handle_t *hmotor, uint8_t percent){
  * @param  speed_mms Vitesse cible en mm/s (Positif = Avant, Négatif = Arrière).
  */
 void motor_set_speed_mms(Motor_Handle_t *hmotor, int16_t speed_mms){
-    hmotor->ctx.target_speed_mms = speed_mms;
+    if(speed_mms == 0 || (speed_mms > 0) != (hmotor->ctx.target_speed_mms > 0)){
+        hmotor->loop.integ_q12 = 0;
+        hmotor->loop.prev_err_mms = 0;
+    }
+
+    if(speed_mms != hmotor->ctx.target_speed_mms){
+        hmotor->ctx.target_speed_mms = speed_mms;
+        hmotor->pending = true;
+    }
 
     if(speed_mms == 0){
-        hmotor->ctx.target_pwm = PWM_NEUTRAL;
+        hmotor->loop.ff_ticks = hmotor->map.neutral_ticks;
     }
     else{
-        hmotor->ctx.target_pwm = motor_speed_mms_to_pwm_percent(hmotor, speed_mms);
+        hmotor->loop.ff_ticks = motor_speed_mms_to_ticks(hmotor, speed_mms);
         hmotor->ctx.target_forward = (speed_mms > 0);
     }
+
+    /* Boucle active : l'intégrale acquise reste appliquée au nouveau feed-forward */
+    if(speed_mms != 0 && hmotor->loop.integ_q12 != 0){
+        motor_set_target_ticks(hmotor, motor_clamp_ticks(hmotor, motor_loop_ticks(hmotor, hmotor->loop.integ_q12),
+                                                         hmotor->ctx.target_forward));
+    }
+    else{
+        motor_set_target_ticks(hmotor, hmotor->loop.ff_ticks);
+    }
 }
 
 /**
- * @brief  Machine à états principale de gestion du moteur.
- * @details Doit être appelée périodiquement (ex: 1kHz). Gère la logique séquentielle :
- * - Marche Avant -> Neutre -> Marche Arrière : Passage direct (géré par ESC en général) ou via frein.
- * - Inversion brusque : Application d'une séquence Frein -> Pause -> Nouveau sens.
+ * @brief  Règle les gains de la boucle de vitesse.
+ * @param  hmotor Pointeur vers le handle du moteur.
+ * @param  kp_q12 Gain proportionnel (Q12, % PWM par mm/s).
+ * @param  ki_q12 Gain intégral par échantillon (Q12).
+ * @param  kd_q12 Gain dérivé par échantillon (Q12).
+ */
+void motor_set_speed_gains(Motor_Handle_t *hmotor, int16_t kp_q12, int16_t ki_q12, int16_t kd_q12){
+    hmotor->loop.kp_q12 = kp_q12;
+    hmotor->loop.ki_q12 = ki_q12;
+    hmotor->loop.kd_q12 = kd_q12;
+    hmotor->loop.integ_q12 = 0;
+    hmotor->loop.prev_err_mms = 0;
+    hmotor->pending = true;
+}
+
+/**
+ * @brief  Règle la compensation de tension d'alimentation de la carte vitesse -> PWM.
+ * @details La consigne courante est reconvertie avec le nouveau facteur ; l'intégrale
+ * de la boucle de vitesse est conservée (même cible).
+ * @param  hmotor   Pointeur vers le handle du moteur.
+ * @param  comp_q12 Facteur appliqué à l'écart au neutre (Q12, 4096 : aucun).
+ */
+void motor_set_supply_comp(Motor_Handle_t *hmotor, uint16_t comp_q12){
+    if(hmotor->map.supply_comp_q12 != comp_q12){
+        hmotor->map.supply_comp_q12 = comp_q12;
+        motor_set_speed_mms(hmotor, hmotor->ctx.target_speed_mms);
+    }
+}
+
+/**
+ * @brief  Limite l'écart au neutre d'une consigne CCR pendant une anomalie d'adhérence.
+ * @param  hmotor Pointeur vers le handle du moteur.
+ * @param  ticks  Consigne CCR.
+ * @return Consigne bornée à ±MOTOR_TRAC_LIMIT_PCT du neutre, inchangée hors anomalie.
+ */
+static uint16_t motor_trac_limit(const Motor_Handle_t *hmotor, uint16_t ticks){
+#if MOTOR_TRAC_ENABLE && MOTOR_TRAC_LIMIT
+    if(hmotor->trac.state != MOTOR_TRAC_OK){
+        const int32_t span = (int32_t)((MOTOR_TRAC_LIMIT_PCT * hmotor->map.ticks_per_pct_q16) >> 16);
+        const int32_t n = hmotor->map.neutral_ticks;
+
+        if((int32_t)ticks > n + span) return (uint16_t)(n + span);
+        if((int32_t)ticks < n - span) return (uint16_t)(n - span);
+    }
+#else
+    (void)hmotor;
+#endif
+    return ticks;
+}
+
+#if MOTOR_TRAC_ENABLE
+/**
+ * @brief  Change l'anomalie confirmée et la signale (DLOG_TRACTION).
+ * @param  hmotor    Pointeur vers le handle du moteur.
+ * @param  state     Nouvel état (Motor_Traction_t).
+ * @param  speed_mms Vitesse mesurée (mm/s).
+ */
+static void motor_trac_set(Motor_Handle_t *hmotor, uint8_t state, int16_t speed_mms){
+    Motor_Traction_Det_t *t = &hmotor->trac;
+
+    if(state != MOTOR_TRAC_OK){
+        t->events++;
+    }
+    t->state = state;
+    t->clear = 0;
+    DLOG3(DLOG_TRACTION, state, hmotor->ctx.target_speed_mms, speed_mms);
+}
+
+/**
+ * @brief  Compare la mesure à la consigne et à la sortie appliquée (patinage / blocage).
+ * @details Quelques comparaisons par mesure, sans division :
+ * - blocage : sortie à plus de MOTOR_TRAC_STALL_PCT du neutre et roue quasi immobile ;
+ * - patinage : survitesse de plus de MOTOR_TRAC_SLIP_MMS sur la consigne, ou
+ *   accélération au-delà de MOTOR_TRAC_SLIP_DV_MMS par mesure (roue qui s'emballe).
+ * Confirmation sur plusieurs mesures consécutives, levée après MOTOR_TRAC_CLEAR_SAMPLES
+ * mesures saines ; levée immédiate hors marche stable, à consigne faible ou inversée.
+ * @param  hmotor    Pointeur vers le handle du moteur.
+ * @param  speed_mms Vitesse estimée (mm/s, signée).
+ * @param  holding   Machine à états en marche stable dans le sens de la consigne.
+ */
+static void motor_trac_update(Motor_Handle_t *hmotor, int16_t speed_mms, bool holding){
+    Motor_Traction_Det_t *t = &hmotor->trac;
+    const int32_t target = hmotor->ctx.target_speed_mms;
+    const int32_t dir = hmotor->go_forward ? 1 : -1;
+    const int32_t cmd = target * dir;
+    const int32_t meas = (int32_t)speed_mms * dir;
+    const int32_t dv = meas - (int32_t)t->prev_mms * dir;
+    uint8_t now = MOTOR_TRAC_OK;
+
+    t->prev_mms = speed_mms;
+
+    if(!holding || cmd < MOTOR_TRAC_MIN_CMD_MMS){
+        t->count = 0;
+        if(t->state != MOTOR_TRAC_OK){
+            motor_trac_set(hmotor, MOTOR_TRAC_OK, speed_mms);
+        }
+        return;
+    }
+
+    const int32_t drive = (int32_t)hmotor->ctx.target_ticks - hmotor->map.neutral_ticks;
+    const int32_t stall_ticks = (int32_t)((MOTOR_TRAC_STALL_PCT * hmotor->map.ticks_per_pct_q16) >> 16);
+
+    if(drive * dir >= stall_ticks && meas < MOTOR_TRAC_STALL_MMS && meas > -MOTOR_TRAC_STALL_MMS){
+        now = MOTOR_TRAC_STALL;
+    }
+    else if(meas > cmd + MOTOR_TRAC_SLIP_MMS || dv > MOTOR_TRAC_SLIP_DV_MMS){
+        now = MOTOR_TRAC_SLIP;
+    }
+
+    if(now == MOTOR_TRAC_OK){
+        t->count = 0;
+        if(t->state != MOTOR_TRAC_OK && ++t->clear >= MOTOR_TRAC_CLEAR_SAMPLES){
+            motor_trac_set(hmotor, MOTOR_TRAC_OK, speed_mms);
+        }
+        return;
+    }
+
+    t->clear = 0;
+    if(now != t->cand){
+        t->cand = now;
+        t->count = 0;
+    }
+    if(t->count < UINT8_MAX){
+        t->count++;
+    }
+    if(now != t->state &&
+       t->count >= ((now == MOTOR_TRAC_STALL) ? MOTOR_TRAC_STALL_SAMPLES : MOTOR_TRAC_SLIP_SAMPLES)){
+        motor_trac_set(hmotor, now, speed_mms);
+    }
+}
+#endif /* MOTOR_TRAC_ENABLE */
+
+/**
+ * @brief  Exécute un pas de la boucle de vitesse PI(D) sur une nouvelle mesure.
+ * @details Sortie = feed-forward + Kp.e + intégrale + Kd.de, bornée à la moitié de
+ * plage PWM du sens appliqué (la machine à états garde la main sur les inversions).
+ * Anti-windup : l'intégrale est bornée et gelée quand la sortie sature dans le sens
+ * de l'erreur. Hors marche stable (freinage, neutre) ou gains nuls, la consigne
+ * revient au feed-forward et l'intégrale est remise à zéro.
+ * @param  hmotor    Pointeur vers le handle du moteur.
+ * @param  speed_mms Vitesse estimée (mm/s, signée).
+ */
+void motor_speed_feedback(Motor_Handle_t *hmotor, int16_t speed_mms){
+    Motor_Speed_Loop_t *loop = &hmotor->loop;
+    const int16_t target = hmotor->ctx.target_speed_mms;
+    const bool holding = (hmotor->state == MOTOR_STATE_FORWARD_HOLD) || (hmotor->state == MOTOR_STATE_REVERSE_HOLD);
+
+    loop->measured_mms = speed_mms;
+#if MOTOR_TRAC_ENABLE
+    motor_trac_update(hmotor, speed_mms, holding && target != 0 && (target > 0) == hmotor->go_forward);
+#endif
+
+    if((loop->kp_q12 == 0 && loop->ki_q12 == 0 && loop->kd_q12 == 0) ||
+       !holding || target == 0 || (target > 0) != hmotor->go_forward){
+        loop->integ_q12 = 0;
+        loop->prev_err_mms = 0;
+        motor_set_target_ticks(hmotor, loop->ff_ticks);
+        return;
+    }
+
+    int32_t err = (int32_t)target - loop->measured_mms;
+    if(err >  LOOP_ERR_MAX_MMS) err =  LOOP_ERR_MAX_MMS;
+    if(err < -LOOP_ERR_MAX_MMS) err = -LOOP_ERR_MAX_MMS;
+
+    int32_t integ = loop->integ_q12 + (int32_t)loop->ki_q12 * err;
+    if(integ >  LOOP_INTEG_MAX_Q12) integ =  LOOP_INTEG_MAX_Q12;
+    if(integ < -LOOP_INTEG_MAX_Q12) integ = -LOOP_INTEG_MAX_Q12;
+
+    const int32_t out = motor_loop_ticks(hmotor, (int32_t)loop->kp_q12 * err
+                                               + integ
+                                               + (int32_t)loop->kd_q12 * (err - loop->prev_err_mms));
+    loop->prev_err_mms = (int16_t)err;
+
+    const int32_t lo = hmotor->go_forward ? hmotor->map.neutral_ticks : hmotor->min_pulse_ticks;
+    const int32_t hi = hmotor->go_forward ? hmotor->max_pulse_ticks : hmotor->map.neutral_ticks;
+
+    /* Intégrale gelée si la sortie sature dans le sens de l'erreur, ou pendant une anomalie d'adhérence */
+    if(hmotor->trac.state == MOTOR_TRAC_OK &&
+       ((out > hi && err < 0) || (out < lo && err > 0) || (out >= lo && out <= hi))){
+        loop->integ_q12 = integ;
+    }
+
+    motor_set_target_ticks(hmotor, motor_clamp_ticks(hmotor, out, hmotor->go_forward));
+}
+
+/**
+ * @brief  Consigne CCR d'une sélection de la table des états.
+ * @param  hmotor Pointeur vers le handle du moteur.
+ * @param  sel    Sélection (MOTOR_PWM_*).
+ * @return Consigne à appliquer (ticks).
+ */
+static uint16_t motor_state_ticks(const Motor_Handle_t *hmotor, uint8_t sel){
+    switch(sel){
+        case MOTOR_PWM_TARGET:    return hmotor->ctx.target_ticks;
+        case MOTOR_PWM_BRAKE_REV: return hmotor->map.brake_rev_ticks;
+        case MOTOR_PWM_BRAKE_FWD: return hmotor->map.brake_fwd_ticks;
+        default:                  return hmotor->map.neutral_ticks;
+    }
+}
+
+/**
+ * @brief  Entre dans un état : arme son échéance et met à jour le sens appliqué.
  * @param  hmotor Pointeur vers le handle du moteur.
+ * @param  state  Nouvel état.
  * @param  now_ms Temps système actuel en millisecondes.
  */
-void motor_process_1ms(Motor_Handle_t *hmotor, uint32_t now_ms){
-    if (!hmotor) return;
+static void motor_enter_state(Motor_Handle_t *hmotor, MotorState_t state, uint32_t now_ms){
+    const motor_state_desc_t *desc = &motor_state_table[state];
 
-    const bool want_neutral = (hmotor->ctx.target_speed_mms == 0);
-
-    switch (hmotor->state){
-        case MOTOR_STATE_NEUTRAL:
-            motor_pwm_percent(hmotor, PWM_NEUTRAL);
-
-            if(!want_neutral){
-                if(hmotor->ctx.target_forward){
-                    motor_pwm_percent(hmotor, hmotor->ctx.target_pwm);
-                    hmotor->go_forward = true;
-                    hmotor->state = MOTOR_STATE_FORWARD_HOLD;
-                }
-                else{
-                    motor_pwm_percent(hmotor, PWM_BRAKE_REV);
-                    hmotor->ctx.deadline_ms = now_ms + T_BRAKE_MS;
-                    hmotor->state = MOTOR_STATE_NEUTRAL_TO_REVERSE_TAP;
-                }
-            }
-            break;
+    hmotor->state = state;
+    if(desc->timer == MOTOR_TIMER_BRAKE){
+        hmotor->ctx.deadline_ms = now_ms + hmotor->esc.brake_ms;
+    }
+    else if(desc->timer == MOTOR_TIMER_GAP){
+        hmotor->ctx.deadline_ms = now_ms + hmotor->esc.neutral_gap_ms;
+    }
 
-        case MOTOR_STATE_NEUTRAL_TO_REVERSE_TAP:
-            if (!time_reached(now_ms, hmotor->ctx.deadline_ms)) break;
-            motor_pwm_percent(hmotor, PWM_NEUTRAL);
-            hmotor->ctx.deadline_ms = now_ms + T_NEUTRAL_GAP_MS;
-            hmotor->state = MOTOR_STATE_NEUTRAL_TO_REVERSE_GAP;
-            break;
+    if(state == MOTOR_STATE_FORWARD_HOLD){
+        hmotor->go_forward = true;
+    }
+    else if(state == MOTOR_STATE_REVERSE_HOLD){
+        hmotor->go_forward = false;
+    }
+}
 
-        case MOTOR_STATE_NEUTRAL_TO_REVERSE_GAP:
-            if(!time_reached(now_ms, hmotor->ctx.deadline_ms)) break;
-            if(want_neutral){
-                motor_pwm_percent(hmotor, PWM_NEUTRAL);
-                hmotor->state = MOTOR_STATE_NEUTRAL;
-            }
-            else if (hmotor->ctx.target_forward){
-                motor_pwm_percent(hmotor, hmotor->ctx.target_pwm);
-                hmotor->go_forward = true;
-                hmotor->state = MOTOR_STATE_FORWARD_HOLD;
-            }
-            else{
-                motor_pwm_percent(hmotor, hmotor->ctx.target_pwm);
-                hmotor->go_forward = false;
-                hmotor->state = MOTOR_STATE_REVERSE_HOLD;
-            }
-            break;
+/**
+ * @brief  Règle le profil de temporisation de l'ESC.
+ * @details Pris en compte à la prochaine transition ; une séquence en cours garde
+ * l'échéance déjà armée. Profondeur de frein bornée à PWM_NEUTRAL.
+ * @param  hmotor  Pointeur vers le handle du moteur.
+ * @param  profile Profil à appliquer.
+ */
+void motor_set_esc_profile(Motor_Handle_t *hmotor, const Motor_Esc_Profile_t *profile){
+    hmotor->esc = *profile;
+    if(hmotor->esc.brake_depth > PWM_NEUTRAL){
+        hmotor->esc.brake_depth = PWM_NEUTRAL;
+    }
+    motor_map_brake(hmotor);
+    hmotor->pending = true;
+}
 
-        case MOTOR_STATE_FORWARD_HOLD:
-            if(want_neutral){
-                motor_pwm_percent(hmotor, PWM_NEUTRAL);
-                hmotor->state = MOTOR_STATE_NEUTRAL;
-                break;
-            }
-            if(hmotor->ctx.target_forward){
-                motor_pwm_percent(hmotor, hmotor->ctx.target_pwm);
-            }
-            else{
-                motor_pwm_percent(hmotor, PWM_BRAKE_REV);
-                hmotor->ctx.deadline_ms = now_ms + T_BRAKE_MS;
-                hmotor->state = MOTOR_STATE_FWD_BRAKE_TAP;
-            }
-            break;
+/**
+ * @brief  Indique si la machine à états a du travail.
+ * @param  hmotor Pointeur vers le handle du moteur.
+ * @param  now_ms Temps système actuel en millisecondes.
+ * @return true si une consigne a changé ou si l'échéance de l'état courant est atteinte.
+ */
+bool motor_needs_process(const Motor_Handle_t *hmotor, uint32_t now_ms){
+    return hmotor->pending ||
+           (motor_state_table[hmotor->state].timer != MOTOR_TIMER_NONE && time_reached(now_ms, hmotor->ctx.deadline_ms));
+}
 
-        case MOTOR_STATE_FWD_BRAKE_TAP:
-            if(!time_reached(now_ms, hmotor->ctx.deadline_ms)) break;
-            motor_pwm_percent(hmotor, PWM_NEUTRAL);
-            hmotor->ctx.deadline_ms = now_ms + T_NEUTRAL_GAP_MS;
-            hmotor->state = MOTOR_STATE_FWD_NEUTRAL_GAP;
-            break;
+/**
+ * @brief  Prochaine échéance de la machine à états.
+ * @param  hmotor      Pointeur vers le handle du moteur.
+ * @param  deadline_ms Échéance de l'état courant (ms), renseignée si l'état est temporisé.
+ * @return true si l'état courant est temporisé, false si seul un événement le fera évoluer.
+ */
+bool motor_next_deadline(const Motor_Handle_t *hmotor, uint32_t *deadline_ms){
+    if(motor_state_table[hmotor->state].timer == MOTOR_TIMER_NONE){
+        return false;
+    }
+    *deadline_ms = hmotor->ctx.deadline_ms;
+    return true;
+}
 
-        case MOTOR_STATE_FWD_NEUTRAL_GAP:
-            if(!time_reached(now_ms, hmotor->ctx.deadline_ms)) break;
-            if(want_neutral){
-                motor_pwm_percent(hmotor, PWM_NEUTRAL);
-                hmotor->state = MOTOR_STATE_NEUTRAL;
-            }
-            else if(hmotor->ctx.target_forward){
-                motor_pwm_percent(hmotor, hmotor->ctx.target_pwm);
-                hmotor->go_forward = true;
-                hmotor->state = MOTOR_STATE_FORWARD_HOLD;
-            }
-            else{
-                motor_pwm_percent(hmotor, hmotor->ctx.target_pwm);
-                hmotor->go_forward = false;
-                hmotor->state = MOTOR_STATE_REVERSE_HOLD;
-            }
-            break;
+/**
+ * @brief  Machine à états principale de gestion du moteur.
+ * @details Doit être appelée périodiquement (ex: 1kHz). Les transitions sont décrites
+ * par motor_state_table : un état temporisé passe à son successeur à échéance, un état
+ * stable (ou une fin de pause) suit la ligne de motor_target_table correspondant à la
+ * cible (neutre, avant, arrière). Les états de durée nulle sont traversés dans le même
+ * appel : avec un profil sans frein ni pause (ESC bidirectionnel), l'inversion est directe.
+ * Il suffit de l'appeler quand motor_needs_process() le demande : en marche stable, rien
+ * n'évolue sans nouvelle consigne.
+ * @param  hmotor Pointeur vers le handle du moteur.
+ * @param  now_ms Temps système actuel en millisecondes.
+ */
+MEM_RAMFUNC void motor_process_1ms(Motor_Handle_t *hmotor, uint32_t now_ms){
+    if (!hmotor) return;
 
-        case MOTOR_STATE_REVERSE_HOLD:
-            if(want_neutral){
-                motor_pwm_percent(hmotor, PWM_NEUTRAL);
-                hmotor->state = MOTOR_STATE_NEUTRAL;
-                break;
-            }
-            if(!hmotor->ctx.target_forward){
-                motor_pwm_percent(hmotor, hmotor->ctx.target_pwm);
-            }
-            else{
-                motor_pwm_percent(hmotor, PWM_BRAKE_FWD);
-                hmotor->ctx.deadline_ms = now_ms + T_BRAKE_MS;
-                hmotor->state = MOTOR_STATE_REV_BRAKE_TAP;
-            }
-            break;
+    hmotor->pending = false;
+
+    const uint8_t target = (hmotor->ctx.target_speed_mms == 0) ? MOTOR_TARGET_NEUTRAL :
+                           hmotor->ctx.target_forward ? MOTOR_TARGET_FORWARD : MOTOR_TARGET_REVERSE;
 
-        case MOTOR_STATE_REV_BRAKE_TAP:
-            if(!time_reached(now_ms, hmotor->ctx.deadline_ms)) break;
-            motor_pwm_percent(hmotor, PWM_NEUTRAL);
-            hmotor->ctx.deadline_ms = now_ms + T_NEUTRAL_GAP_MS;
-            hmotor->state = MOTOR_STATE_REV_NEUTRAL_GAP;
+    for(uint8_t step = 0; step < MOTOR_STATE_COUNT; step++){
+        const motor_state_desc_t *desc = &motor_state_table[hmotor->state];
+
+        if(desc->timer != MOTOR_TIMER_NONE && !time_reached(now_ms, hmotor->ctx.deadline_ms)){
             break;
+        }
 
-        case MOTOR_STATE_REV_NEUTRAL_GAP:
-            if(!time_reached(now_ms, hmotor->ctx.deadline_ms)) break;
-            if(want_neutral){
-                motor_pwm_percent(hmotor, PWM_NEUTRAL);
-                hmotor->state = MOTOR_STATE_NEUTRAL;
-            }
-            else if(!hmotor->ctx.target_forward){
-                motor_pwm_percent(hmotor, hmotor->ctx.target_pwm);
-                hmotor->go_forward = false;
-                hmotor->state = MOTOR_STATE_REVERSE_HOLD;
-            }
-            else{
-                motor_pwm_percent(hmotor, hmotor->ctx.target_pwm);
-                hmotor->go_forward = true;
-                hmotor->state = MOTOR_STATE_FORWARD_HOLD;
-            }
+        const MotorState_t next = (desc->row == MOTOR_ROW_NONE) ? desc->next : motor_target_table[desc->row][target];
+        if(next == hmotor->state){
             break;
+        }
+        motor_enter_state(hmotor, next, now_ms);
     }
+
+    pwm_pulse(hmotor, motor_state_ticks(hmotor, motor_state_table[hmotor->state].pwm));
 }
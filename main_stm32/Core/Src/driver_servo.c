@@ -8,120 +8,193 @@
 #include "tim.h"
 #include "driver_servo.h"
 
-/** @brief Décalage (offset) en pourcentage appliqué à la commande (Trim). */
-#define SERVO_OFFSET_PERCENT  5
-/** @brief Angle minimum autorisé en degrés (Borne mécanique logicielle). */
-#define SERVO_CLAMP_MIN       -20
-/** @brief Angle maximum autorisé en degrés (Borne mécanique logicielle). */
-#define SERVO_CLAMP_MAX       20
+/** @brief Décalage (offset) en pourcentage appliqué à la commande (Trim, profil véhicule). */
+#define SERVO_OFFSET_PERCENT  VEH_SERVO_TRIM_PCT
+/** @brief Demi-course (centi-degrés) couverte par la plage min/max des ticks (profil véhicule). */
+#define SERVO_HALF_SPAN_CDEG  VEH_SERVO_HALF_SPAN_CDEG
+/** @brief 1/100 en Q16 (arrondi) : pourcentage -> fraction de la plage sans division. */
+#define SERVO_PCT_RECIP_Q16   655u
+/** @brief Course de servo_pwm_angle_abs_value() (9000 c°) par pas de l'entrée 16 bits, Q16 par excès. */
+#define SERVO_ABS_SPAN_Q16    9001u
 
 //static inline void pwm_pulse(Servo_Handle_t *hservo, uint16_t value);
-static int32_t map(int32_t x, int32_t in_min, int32_t in_max, int32_t out_min, int32_t out_max);
 
 /**
- * @brief  Applique la valeur de comparaison (CCR) au registre du Timer.
+ * @brief  Mémorise la valeur de comparaison (CCR), appliquée par servo_apply().
  * @param  hservo Pointeur vers le handle du servo.
  * @param  value  Valeur brute en ticks d'horloge.
  */
 static inline void pwm_pulse(Servo_Handle_t *hservo, uint16_t value){
-    if (hservo && hservo->htim) {
-        __HAL_TIM_SET_COMPARE(hservo->htim, hservo->channel, value);
+    if (hservo) {
+        hservo->pulse_ticks = value;
     }
 }
 
 /**
- * @brief  Fonction utilitaire de mappage linéaire (Règle de trois).
- * @param  x       Valeur d'entrée à mapper.
- * @param  in_min  Borne inférieure d'entrée.
- * @param  in_max  Borne supérieure d'entrée.
- * @param  out_min Borne inférieure de sortie.
- * @param  out_max Borne supérieure de sortie.
- * @return Valeur mappée dans la plage de sortie.
+ * @brief  Applique la consigne en attente au registre de comparaison.
+ * @details Le préchargement CCR (OCxPE) reporte la nouvelle valeur à l'événement
+ * d'update : la période en cours n'est jamais tronquée. Une consigne identique à la
+ * valeur déjà chargée n'entraîne aucun accès au bus.
+ * @param  hservo Pointeur vers le handle du servo.
  */
-static int32_t map(int32_t x, int32_t in_min, int32_t in_max, int32_t out_min, int32_t out_max){
-    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+void servo_apply(Servo_Handle_t *hservo){
+    if (hservo && hservo->htim && __HAL_TIM_GET_COMPARE(hservo->htim, hservo->channel) != hservo->pulse_ticks) {
+        __HAL_TIM_SET_COMPARE(hservo->htim, hservo->channel, hservo->pulse_ticks);
+    }
 }
 
 /**
- * @brief  Convertit un pourcentage théorique en ticks Timer avec gestion d'offset.
- * @note   Applique SERVO_OFFSET_PERCENT et borne le résultat entre 0 et 100 avant calcul.
- * @param  hservo  Pointeur vers le handle du servo.
- * @param  percent Pourcentage d'entrée (peut être négatif avant correction offset).
- * @return Valeur en ticks Timer correspondant au pourcentage corrigé.
+ * @brief  Place directement le servo sur une consigne CCR (sans rampe).
+ * @param  hservo Pointeur vers le handle du servo.
+ * @param  value  Consigne en ticks.
  */
-static inline uint16_t servo_map_percent(Servo_Handle_t *hservo, int16_t percent){
-    int16_t corrected = percent + SERVO_OFFSET_PERCENT;
+static void servo_jump(Servo_Handle_t *hservo, uint16_t value){
+    hservo->target_ticks = value;
+    hservo->pos_q16 = (uint32_t)value << 16;
+    pwm_pulse(hservo, value);
+}
 
-    if (corrected < 0)   corrected = 0;
-    if (corrected > 100) corrected = 100;
+/**
+ * @brief  Commande le servo par une consigne CCR directe (pleine résolution).
+ * @note   Contourne la limitation de vitesse ; bornée à [min_pulse_ticks, max_pulse_ticks].
+ * @param  hservo Pointeur vers le handle du servo.
+ * @param  ticks  Consigne en ticks Timer.
+ */
+void servo_pwm_ticks(Servo_Handle_t *hservo, uint16_t ticks){
+    if (ticks < hservo->min_pulse_ticks) ticks = hservo->min_pulse_ticks;
+    if (ticks > hservo->max_pulse_ticks) ticks = hservo->max_pulse_ticks;
 
-    uint16_t min = hservo->min_pulse_ticks;
-    uint16_t max = hservo->max_pulse_ticks;
-    return min + ((max - min) * corrected) / 100;
+    servo_jump(hservo, ticks);
 }
 
 /**
  * @brief  Commande le servo via un pourcentage (0 à 100%).
+ * @note   Contourne la limitation de vitesse. 50 % : centre trim compris (center_ticks).
+ * Division par 100 remplacée par la réciproque Q16 (arrondi au tick).
  * @param  hservo  Pointeur vers le handle du servo.
  * @param  percent Position cible en pourcentage.
  */
 void servo_pwm_percent(Servo_Handle_t *hservo, uint8_t percent){
-    uint16_t value = servo_map_percent(hservo, percent);
-    pwm_pulse(hservo, value);
+    const uint32_t range = (uint32_t)(hservo->max_pulse_ticks - hservo->min_pulse_ticks);
+
+    if (percent > 100u) percent = 100u;
+    const uint32_t off = (percent >= 50u) ? (uint32_t)(percent - 50u) : (uint32_t)(50u - percent);
+    const int32_t delta = (int32_t)((off * range * SERVO_PCT_RECIP_Q16 + 0x8000u) >> 16);
+    int32_t ticks = (int32_t)hservo->center_ticks + ((percent >= 50u) ? delta : -delta);
+
+    if (ticks < 0) ticks = 0;
+    servo_pwm_ticks(hservo, (uint16_t)ticks);
 }
 
 /**
- * @brief  Commande le servo via un angle en degrés.
- * @details Applique un bornage de sécurité (CLAMP_MIN / CLAMP_MAX) puis convertit
- * l'angle en pourcentage pour le PWM.
+ * @brief  Commande le servo en centi-degrés.
+ * @details Bornage de sécurité puis conversion par la pente Q16 précalculée (une
+ * multiplication, sans division). Avec la limitation de vitesse active, seule la
+ * consigne visée change : servo_slew_tick() rejoint la consigne en rampe.
  * @param  hservo Pointeur vers le handle du servo.
- * @param  angle  Angle cible en degrés.
+ * @param  cdeg   Angle cible en centi-degrés.
  */
-void servo_pwm_angle_degree(Servo_Handle_t *hservo, int8_t angle){
-    if (angle < SERVO_CLAMP_MIN) angle = SERVO_CLAMP_MIN;
-    if (angle > SERVO_CLAMP_MAX) angle = SERVO_CLAMP_MAX;
+void servo_set_centideg(Servo_Handle_t *hservo, int16_t cdeg){
+    if (cdeg < SERVO_CLAMP_MIN_CDEG) cdeg = SERVO_CLAMP_MIN_CDEG;
+    if (cdeg > SERVO_CLAMP_MAX_CDEG) cdeg = SERVO_CLAMP_MAX_CDEG;
 
-    int16_t percent = ((angle + 35) * 100) / 70;
-    uint16_t value = servo_map_percent(hservo, percent);
+    int32_t ticks = (cdeg >= 0) ?
+                    (int32_t)hservo->center_ticks + (int32_t)(((uint32_t)cdeg * hservo->ticks_per_cdeg_q16) >> 16) :
+                    (int32_t)hservo->center_ticks - (int32_t)(((uint32_t)(-cdeg) * hservo->ticks_per_cdeg_q16) >> 16);
 
-    pwm_pulse(hservo, value);
+    // Sécurité bornes hardware
+    if (ticks > hservo->max_pulse_ticks) ticks = hservo->max_pulse_ticks;
+    if (ticks < hservo->min_pulse_ticks) ticks = hservo->min_pulse_ticks;
+
+    if (hservo->slew_q16 == 0) {
+        servo_jump(hservo, (uint16_t)ticks);
+    }
+    else {
+        hservo->target_ticks = (uint16_t)ticks;
+    }
 }
 
 /**
- * @brief  Commande le servo via une valeur absolue haute résolution (0-65535).
- * @details Effectue une double conversion : Entrée -> Centi-degrés -> Ticks PWM.
- * Gère également l'offset (Trim) et les limites physiques du timer.
- * @param  hservo    Pointeur vers le handle du servo.
- * @param  abs_value Valeur absolue normalisée (0 à 65535).
+ * @brief  Règle la limitation de vitesse de braquage.
+ * @details 1 °/s = 0,1 centi-degré par tick de 1 ms. Désactiver la limitation place
+ * immédiatement le servo sur la consigne visée.
+ * @param  hservo Pointeur vers le handle du servo.
+ * @param  dps    Vitesse maximale (degrés par seconde), 0 = sans limitation.
  */
-void servo_pwm_angle_abs_value(Servo_Handle_t *hservo, uint16_t abs_value){
-    int32_t angle_centi = map(abs_value, 0, 65535, -4500, 4500);
+void servo_set_slew_dps(Servo_Handle_t *hservo, uint16_t dps){
+    hservo->slew_q16 = ((uint32_t)dps * hservo->ticks_per_cdeg_q16) / 10u;
+    if (hservo->slew_q16 == 0) {
+        servo_jump(hservo, hservo->target_ticks);
+    }
+}
 
-    if (angle_centi < -2000) angle_centi = -2000;
-    if (angle_centi >  2000) angle_centi =  2000;
+/**
+ * @brief  Fait avancer la rampe de braquage d'un pas (tick de 1 ms).
+ * @details À appeler au tick matériel de 1 ms, avant servo_apply().
+ * @param  hservo Pointeur vers le handle du servo.
+ * @return true si la consigne visée n'est pas encore atteinte.
+ */
+bool servo_slew_tick(Servo_Handle_t *hservo){
+    const uint32_t target_q16 = (uint32_t)hservo->target_ticks << 16;
+    const uint32_t step = hservo->slew_q16;
 
-    int32_t pwm_ticks = map(angle_centi, -3500, 3500, hservo->min_pulse_ticks, hservo->max_pulse_ticks);
+    if (hservo->pos_q16 == target_q16) {
+        return false;
+    }
 
-    int32_t range = hservo->max_pulse_ticks - hservo->min_pulse_ticks;
-    int32_t offset_ticks = (range * SERVO_OFFSET_PERCENT) / 100;
+    if (step == 0) {
+        hservo->pos_q16 = target_q16;
+    }
+    else if (hservo->pos_q16 < target_q16) {
+        hservo->pos_q16 = (target_q16 - hservo->pos_q16 > step) ? hservo->pos_q16 + step : target_q16;
+    }
+    else {
+        hservo->pos_q16 = (hservo->pos_q16 - target_q16 > step) ? hservo->pos_q16 - step : target_q16;
+    }
 
-    pwm_ticks += offset_ticks;
+    pwm_pulse(hservo, (uint16_t)((hservo->pos_q16 + 0x8000u) >> 16));
+    return hservo->pos_q16 != target_q16;
+}
 
-    // Sécurité bornes hardware
-    if (pwm_ticks > hservo->max_pulse_ticks) pwm_ticks = hservo->max_pulse_ticks;
-    if (pwm_ticks < hservo->min_pulse_ticks) pwm_ticks = hservo->min_pulse_ticks;
+/**
+ * @brief  Commande le servo via un angle en degrés.
+ * @param  hservo Pointeur vers le handle du servo.
+ * @param  angle  Angle cible en degrés.
+ */
+void servo_pwm_angle_degree(Servo_Handle_t *hservo, int8_t angle){
+    servo_set_centideg(hservo, (int16_t)(angle * 100));
+}
 
-    pwm_pulse(hservo, (uint16_t)pwm_ticks);
+/**
+ * @brief  Commande le servo via une valeur absolue haute résolution (0-65535).
+ * @details Entrée -> Centi-degrés (±45°, pente Q16 sans division) -> Ticks PWM via
+ * servo_set_centideg().
+ * @param  hservo    Pointeur vers le handle du servo.
+ * @param  abs_value Valeur absolue normalisée (0 à 65535).
+ */
+void servo_pwm_angle_abs_value(Servo_Handle_t *hservo, uint16_t abs_value){
+    servo_set_centideg(hservo, (int16_t)((int32_t)(((uint32_t)abs_value * SERVO_ABS_SPAN_Q16) >> 16) - 4500));
 }
 
 /**
  * @brief  Initialise le driver Servo.
- * @details Positionne le servo à 0 degrés (neutre) et active le canal PWM.
+ * @details Précalcule la conversion centi-degrés -> ticks (±35° sur la plage min/max,
+ * trim SERVO_OFFSET_PERCENT), active le préchargement CCR, positionne le servo à
+ * 0 degrés (neutre) sans limitation de vitesse et active le canal PWM.
  * @param  hservo Pointeur vers le handle du servo.
  */
 void servo_initialisation(Servo_Handle_t *hservo){
     if(hservo && hservo->htim){
-        servo_pwm_angle_degree(hservo, 0);
+        const uint32_t range = (uint32_t)(hservo->max_pulse_ticks - hservo->min_pulse_ticks);
+
+        hservo->center_ticks = (uint16_t)(hservo->min_pulse_ticks + range / 2u + (range * SERVO_OFFSET_PERCENT) / 100u);
+        hservo->ticks_per_cdeg_q16 = (range << 16) / (2u * SERVO_HALF_SPAN_CDEG);
+        hservo->slew_q16 = 0;
+        hservo->target_ticks = hservo->center_ticks;
+
+        __HAL_TIM_ENABLE_OCxPRELOAD(hservo->htim, hservo->channel);
+        servo_set_centideg(hservo, 0);
+        servo_apply(hservo);
         HAL_TIM_PWM_Start(hservo->htim, hservo->channel);
     }
 }
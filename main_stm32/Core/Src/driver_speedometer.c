@@ -2,40 +2,194 @@
  * @file    driver_speedometer.c
  * @brief   Driver de calcul de vitesse basé sur un capteur à effet Hall.
  * @details Utilise un timer en mode compteur pour mesurer le nombre d'impulsions
- * générées par la rotation de la roue et déduit la vitesse linéaire.
+ * générées par la rotation de la roue et déduit la vitesse linéaire. Le compteur
+ * 16 bits est étendu à 32 bits par l'interruption de débordement de TIM4, comme la
+ * base de temps l'est pour TIM3. En mode SPEEDO_EDGE_TIMING, chaque impulsion est en
+ * plus datée avec la base de temps µs.
  */
 
 #include "driver_speedometer.h"
 #include "tim.h"
+#include "timebase.h"
+
+#if SPEEDO_EDGE_TIMING && (SPEEDO_EDGE_HIST - 1u) * SPEEDO_UM_PER_TICK > 4294967u
+#error "SPEEDO_EDGE_HIST * SPEEDO_UM_PER_TICK overflows the 32-bit speed computation"
+#endif
+
+/** @brief Tachymètre dont le timer génère les interruptions update et trigger. */
+static Speedometer_Handle_t *speedo_irq_handle = NULL;
 
 /**
- * @brief  Calcule la vitesse instantanée en m/s.
- * @details Cette fonction doit être appelée périodiquement. Elle calcule la différence
- * de temps et de nombre d'impulsions (ticks) depuis le dernier appel.
- * @note   Gère implicitement le débordement (overflow) du compteur 16 bits via
- * l'arithmétique non signée.
+ * @brief  Callback HAL de débordement (update de TIM4, contexte interruption).
+ * @details Le flag a déjà été effacé par l'appelant : TIM3_TIM4_IRQHandler() efface le
+ * flag et appelle ce callback interruptions masquées, pour qu'une lecture depuis une
+ * interruption plus prioritaire ne voie jamais l'un sans l'autre.
+ * @param  htim Handle du Timer ayant généré l'interruption.
+ */
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim){
+    Speedometer_Handle_t *h = speedo_irq_handle;
+
+    if(h == NULL || htim != h->htim){
+        return;
+    }
+
+    h->overflow_cnt++;
+}
+
+#if SPEEDO_EDGE_TIMING
+
+#if (SPEEDO_EDGE_HIST & (SPEEDO_EDGE_HIST - 1u))
+#error "SPEEDO_EDGE_HIST must be a power of two"
+#endif
+
+/**
+ * @brief  Callback HAL de trigger (front TI1 de TIM4, contexte interruption).
+ * @details Date le front avec la base de temps 64 bits, publié sous edge_lock.
+ * @param  htim Handle du Timer ayant généré l'interruption.
+ */
+void HAL_TIM_TriggerCallback(TIM_HandleTypeDef *htim){
+    Speedometer_Handle_t *h = speedo_irq_handle;
+
+    if(h == NULL || htim != h->htim){
+        return;
+    }
+
+    const uint64_t now = GetMicros64();
+
+    seqlock_write_begin(&h->edge_lock);
+    h->edge_us[h->edge_count & (SPEEDO_EDGE_HIST - 1u)] = now;
+    h->edge_count++;
+    seqlock_write_end(&h->edge_lock);
+}
+
+/**
+ * @brief  Estime la vitesse à partir des dates des derniers fronts.
+ * @details Le front le plus récent sert de référence ; on remonte tant que les fronts
+ * restent dans SPEEDO_WINDOW_US (au moins un intervalle). Entre deux fronts, la
+ * vitesse est bornée par celle qu'impliquerait un front à l'instant présent, ce qui
+ * la fait décroître sans attendre le front suivant lors d'un ralentissement.
+ * @param  hSpeedo Pointeur vers la structure du tachymètre.
+ * @return Vitesse en mm/s.
+ */
+static int32_t speedometer_edge_speed_mms(Speedometer_Handle_t *hSpeedo){
+    uint64_t edges[SPEEDO_EDGE_HIST];
+    uint32_t count;
+    uint32_t s;
+
+    /* Copie cohérente sans masquer l'interruption de datation (recommencée si un front arrive) */
+    do{
+        s = seqlock_read_begin(&hSpeedo->edge_lock);
+        count = hSpeedo->edge_count;
+        for(uint32_t i = 0; i < SPEEDO_EDGE_HIST; i++){
+            edges[i] = hSpeedo->edge_us[i];
+        }
+    }
+    while(seqlock_read_retry(&hSpeedo->edge_lock, s));
+
+    const uint64_t now = GetMicros64();
+    if(count < 2u){
+        return 0;
+    }
+
+    const uint64_t last = edges[(count - 1u) & (SPEEDO_EDGE_HIST - 1u)];
+    const uint64_t since_last = now - last;
+    if(since_last > SPEEDO_STOP_TIMEOUT_US){
+        return 0;
+    }
+
+    uint32_t avail = (count - 1u < SPEEDO_EDGE_HIST - 1u) ? (count - 1u) : (SPEEDO_EDGE_HIST - 1u);
+    uint32_t n = 1;
+    while(n < avail && (last - edges[(count - 1u - (n + 1u)) & (SPEEDO_EDGE_HIST - 1u)]) <= SPEEDO_WINDOW_US){
+        n++;
+    }
+
+    const uint32_t span = (uint32_t)(last - edges[(count - 1u - n) & (SPEEDO_EDGE_HIST - 1u)]);
+    if(span == 0){
+        return hSpeedo->current_speed_mms;
+    }
+
+    /* µm/µs = m/s : x1000 pour des mm/s (n * µm/front * 1000 < 2^32) */
+    uint32_t speed_mms = (n * SPEEDO_UM_PER_TICK * 1000u) / span;
+    uint32_t bound_mms = (uint32_t)(((uint64_t)SPEEDO_UM_PER_TICK * 1000u) / since_last);
+
+    return (int32_t)((since_last > span / n && bound_mms < speed_mms) ? bound_mms : speed_mms);
+}
+
+#endif
+
+/**
+ * @brief  Calcule la vitesse instantanée en mm/s (calcul entier).
+ * @details Cette fonction doit être appelée périodiquement. En mode SPEEDO_EDGE_TIMING,
+ * la vitesse est déduite des dates des derniers fronts (cf. speedometer_edge_speed_mms()).
+ * Sinon, elle calcule la différence de temps et de nombre d'impulsions (ticks) depuis
+ * le dernier appel : µm parcourus / ms écoulées = mm/s.
+ * @note   Différence sur le cumul 32 bits (speedometer_ticks()) : juste quel que soit
+ * l'intervalle entre deux appels, y compris au-delà de 65536 fronts.
  * @param  hSpeedo Pointeur vers la structure de gestion du tachymètre.
- * @return Vitesse calculée en mètres par seconde (m/s).
+ * @return Vitesse calculée en mm/s.
  */
-float speedometer_solve_speed(Speedometer_Handle_t *hSpeedo){
+int32_t speedometer_solve_speed_mms(Speedometer_Handle_t *hSpeedo){
+#if SPEEDO_EDGE_TIMING
+    hSpeedo->current_speed_mms = speedometer_edge_speed_mms(hSpeedo);
+    return hSpeedo->current_speed_mms;
+#else
     uint32_t now = HAL_GetTick();
     uint32_t time_diff_ms = now - hSpeedo->last_process_time;
 
     if(time_diff_ms == 0){
-        return hSpeedo->current_speed_ms;
+        return hSpeedo->current_speed_mms;
     }
 
-    uint16_t current_counter = (uint16_t)__HAL_TIM_GET_COUNTER(hSpeedo->htim);
-    uint16_t pulses = current_counter - hSpeedo->last_counter_val;
-    float wheel_turns = (float)pulses / TICKS_PER_WHEEL_TURN;
-    float distance_m = wheel_turns * PERIMETER_M;
-    float speed_ms = distance_m / ((float)time_diff_ms / 1000.0f);
+    uint32_t current_counter = speedometer_ticks(hSpeedo);
+    uint32_t pulses = current_counter - hSpeedo->last_counter_val;
+    uint64_t distance_um = (uint64_t)pulses * SPEEDO_UM_PER_TICK;
 
     hSpeedo->last_counter_val = current_counter;
     hSpeedo->last_process_time = now;
-    hSpeedo->current_speed_ms = speed_ms;
+    hSpeedo->current_speed_mms = (int32_t)(uint32_t)(distance_um / time_diff_ms);
 
-    return speed_ms;
+    return hSpeedo->current_speed_mms;
+#endif
+}
+
+/**
+ * @brief  Nombre de fronts du capteur depuis l'initialisation.
+ * @details Compteur matériel de TIM4 étendu par overflow_cnt, dans les deux modes : un
+ * front n'y est jamais perdu, même quand deux fronts rapprochés ne lèvent qu'une
+ * interruption trigger. Lecture sans verrou, même principe que GetTicks64() : la
+ * boucle ne recommence que si l'interruption de débordement s'est exécutée pendant la
+ * lecture, et un débordement encore en attente (flag levé, compteur rebouclé) est
+ * compté ici.
+ * @param  hSpeedo Pointeur vers la structure du tachymètre.
+ * @return Compteur de fronts (modulo 2^32).
+ */
+uint32_t speedometer_ticks(const Speedometer_Handle_t *hSpeedo){
+    uint32_t m_overflow;
+    uint16_t m_counter;
+    uint32_t m_pending;
+
+    do{
+        m_overflow = hSpeedo->overflow_cnt;
+        m_counter  = (uint16_t)__HAL_TIM_GET_COUNTER(hSpeedo->htim);
+        m_pending  = __HAL_TIM_GET_FLAG(hSpeedo->htim, TIM_FLAG_UPDATE);
+    }
+    while(m_overflow != hSpeedo->overflow_cnt);
+
+    if(m_pending && m_counter < 0x8000u){
+        m_overflow++;   // Débordement survenu mais pas encore compté par l'interruption
+    }
+
+    return (m_overflow << 16) | m_counter;
+}
+
+/**
+ * @brief  Calcule la vitesse instantanée en m/s.
+ * @details Enveloppe flottante de speedometer_solve_speed_mms() (une seule division).
+ * @param  hSpeedo Pointeur vers la structure de gestion du tachymètre.
+ * @return Vitesse calculée en mètres par seconde (m/s).
+ */
+float speedometer_solve_speed(Speedometer_Handle_t *hSpeedo){
+    return (float)speedometer_solve_speed_mms(hSpeedo) / 1000.0f;
 }
 
 /**
@@ -47,9 +201,21 @@ float speedometer_solve_speed(Speedometer_Handle_t *hSpeedo){
  */
 void speedometer_init(Speedometer_Handle_t *hSpeedo, TIM_HandleTypeDef *htim){
     hSpeedo->htim = htim;
-    hSpeedo->last_counter_val = (uint16_t)__HAL_TIM_GET_COUNTER(hSpeedo->htim);
+    hSpeedo->overflow_cnt = 0;
     hSpeedo->last_process_time = HAL_GetTick();
-    hSpeedo->current_speed_ms = 0.0f;
+    hSpeedo->current_speed_mms = 0;
+    speedo_irq_handle = hSpeedo;
+
+    __HAL_TIM_CLEAR_FLAG(hSpeedo->htim, TIM_FLAG_UPDATE);
+    __HAL_TIM_ENABLE_IT(hSpeedo->htim, TIM_IT_UPDATE);
+    hSpeedo->last_counter_val = speedometer_ticks(hSpeedo);
+
+#if SPEEDO_EDGE_TIMING
+    hSpeedo->edge_count = 0;
+    hSpeedo->edge_lock = (seqlock_t)SEQLOCK_INIT;
+    __HAL_TIM_CLEAR_FLAG(hSpeedo->htim, TIM_FLAG_TRIGGER);
+    __HAL_TIM_ENABLE_IT(hSpeedo->htim, TIM_IT_TRIGGER);
+#endif
 
     HAL_TIM_Base_Start(hSpeedo->htim);
 }
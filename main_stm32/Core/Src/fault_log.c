@@ -0,0 +1,194 @@
+/**
+ * @file    fault_log.c
+ * @brief   Implémentation du relevé de faute persistant (cf. fault_log.h).
+ * @details Relevé et traces en .noinit (MEM_NOINIT) : ni mis à zéro ni recopiés au
+ * démarrage, valides au reset à chaud. Une marque distingue un contenu aléatoire
+ * (mise sous tension) d'un relevé conservé.
+ */
+
+#include "main.h"
+#include "fault_log.h"
+
+#if FAULT_LOG_ENABLE
+
+#include "serial.h"
+#include "serial_cmd.h"
+#include "mem_map.h"
+#include <string.h>
+
+/** @brief Marque de validité du relevé conservé (« FLOG »). */
+#define FAULT_MAGIC         0x474F4C46u
+
+extern uint32_t _estack;
+
+/**
+ * @brief État conservé au reset à chaud.
+ */
+typedef struct {
+    uint32_t       magic;       ///< FAULT_MAGIC si le contenu est valide.
+    uint8_t        armed;       ///< HardFault relevé, redémarrage en cours.
+    uint8_t        reported;    ///< Relevé émis après le démarrage.
+    fault_record_t rec;         ///< Dernier relevé.
+    fault_record_t link;        ///< Compteurs de liaison au dernier rafraîchissement du chien de garde.
+} fault_store_t;
+
+/** @brief Relevé conservé. */
+static fault_store_t fault_store MEM_NOINIT;
+fault_live_t fault_live MEM_NOINIT;
+/** @brief Cause du démarrage courant (fault_cause_t). */
+static uint8_t fault_boot_cause = FAULT_CAUSE_NONE;
+
+void fault_log_init(void){
+    const uint8_t iwdg = (RCC->CSR & RCC_CSR_IWDGRSTF) ? 1u : 0u;
+
+    if(fault_store.magic != FAULT_MAGIC){
+        memset(&fault_store, 0, sizeof(fault_store));
+        fault_store.magic = FAULT_MAGIC;
+        fault_store.reported = 1;
+        fault_live.task = FAULT_TASK_NONE;
+    }
+
+    if(fault_store.armed){
+        fault_boot_cause = FAULT_CAUSE_HARDFAULT;
+    }
+    else if(iwdg){
+        fault_record_t *r = &fault_store.rec;
+
+        fault_boot_cause = FAULT_CAUSE_WATCHDOG;
+        *r = fault_store.link;      // Compteurs de liaison et date du dernier rafraîchissement
+        r->cause = FAULT_CAUSE_WATCHDOG;
+        r->task  = fault_live.task;
+        r->loops = fault_live.loops;
+        r->count = (uint16_t)(fault_store.rec.count + 1u);
+        memset(r->regs, 0, sizeof(r->regs));
+        r->sp = 0;
+    }
+
+    if(fault_boot_cause != FAULT_CAUSE_NONE){
+        fault_store.armed = 0;
+        fault_store.reported = 0;
+    }
+    fault_live.loops = 0;
+    fault_live.task = FAULT_TASK_NONE;
+    memset(&fault_store.link, 0, sizeof(fault_store.link));
+}
+
+void fault_log_heartbeat(void){
+    fault_record_t *l = &fault_store.link;
+
+    l->count      = fault_store.rec.count;
+    l->uptime_ms  = HAL_GetTick();
+    l->rx_drop    = serial_rx_dropped();
+    l->tx_drop    = serial_tx_dropped();
+    l->rx_overrun = serial_rx_overruns();
+    l->telem_seq  = serial_telem_seq();
+}
+
+void fault_log_report_pending(void){
+    if(!fault_store.reported){
+        fault_store.reported = 1;
+        serial_send_fault(&fault_store.rec);
+    }
+}
+
+void fault_log_command(uint16_t cmd){
+    switch(cmd){
+        case FAULT_CMD_REPORT:
+            serial_send_fault(&fault_store.rec);
+        break;
+
+        case FAULT_CMD_CLEAR:
+            memset(&fault_store.rec, 0, sizeof(fault_store.rec));
+            fault_store.reported = 1;
+        break;
+
+        default:
+        break;
+    }
+}
+
+uint8_t fault_log_boot_cause(void){
+    return fault_boot_cause;
+}
+
+/**
+ * @brief  Relève un HardFault puis redémarre (ou boucle, FAULT_LOG_RESET à 0).
+ * @details Une pile hors de la SRAM (débordement, pointeur corrompu) n'est pas relue :
+ * le relevé garde alors des registres nuls.
+ * @param  frame       Trame d'exception empilée (r0, r1, r2, r3, r12, lr, pc, xpsr).
+ * @param  exc_return  Valeur de LR à l'entrée du gestionnaire.
+ */
+void fault_log_capture(const uint32_t *frame, uint32_t exc_return){
+    fault_record_t *r = &fault_store.rec;
+    const uintptr_t sp = (uintptr_t)frame;
+
+    (void)exc_return;
+    if(fault_store.magic != FAULT_MAGIC){
+        memset(&fault_store, 0, sizeof(fault_store));
+        fault_store.magic = FAULT_MAGIC;
+    }
+
+    r->cause      = FAULT_CAUSE_HARDFAULT;
+    r->task       = fault_live.task;
+    r->count      = (uint16_t)(r->count + 1u);
+    r->uptime_ms  = HAL_GetTick();
+    r->loops      = fault_live.loops;
+    r->rx_drop    = fault_store.link.rx_drop;
+    r->tx_drop    = fault_store.link.tx_drop;
+    r->rx_overrun = fault_store.link.rx_overrun;
+    r->telem_seq  = fault_store.link.telem_seq;
+
+    if((sp & 3u) == 0u && sp >= SRAM_BASE && sp + 8u * sizeof(uint32_t) <= (uintptr_t)&_estack){
+        for(uint8_t i = 0; i < 8u; i++){
+            r->regs[i] = frame[i];
+        }
+        r->sp = (uint32_t)(sp + 8u * sizeof(uint32_t) + ((frame[7] & (1u << 9)) ? 4u : 0u));
+    }
+    else{
+        memset(r->regs, 0, sizeof(r->regs));
+        r->sp = (uint32_t)sp;
+    }
+    fault_store.armed = 1;
+
+#if FAULT_LOG_RESET
+    __DSB();
+    SCB->AIRCR = (0x5FAu << SCB_AIRCR_VECTKEY_Pos) | SCB_AIRCR_SYSRESETREQ_Msk;
+    __DSB();
+#endif
+    for(;;){
+    }
+}
+
+/**
+ * @brief  Gestionnaire HardFault : choisit la pile active (bit 2 de EXC_RETURN : PSP en
+ * mode SCHED_RTOS, MSP sinon) et passe la trame empilée à fault_log_capture().
+ * @note   Sans prologue (naked) : SP et LR sont ceux de l'entrée en exception.
+ */
+__attribute__((naked)) void HardFault_Handler(void){
+    __asm volatile(
+        "movs r0, #4              \n"
+        "mov  r1, lr              \n"
+        "tst  r0, r1              \n"
+        "beq  1f                  \n"
+        "mrs  r0, psp             \n"
+        "b    2f                  \n"
+        "1:                       \n"
+        "mrs  r0, msp             \n"
+        "2:                       \n"
+        "ldr  r2, =fault_log_capture \n"
+        "bx   r2                  \n"
+        ".ltorg                   \n"
+    );
+}
+
+#else
+
+/**
+ * @brief  Gestionnaire HardFault sans relevé : boucle infinie (débogueur, chien de garde).
+ */
+void HardFault_Handler(void){
+    for(;;){
+    }
+}
+
+#endif /* FAULT_LOG_ENABLE */
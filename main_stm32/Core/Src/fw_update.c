@@ -0,0 +1,396 @@
+/**
+ * @file    fw_update.c
+ * @brief   Implémentation de la mise à jour du firmware par la liaison série (cf. fw_update.h).
+ * @details Préparation des pages par nv_flash (banque 2, lue et écrite pendant que
+ * l'application s'exécute depuis la banque 1). La recopie finale efface la banque 1 :
+ * elle s'exécute depuis la SRAM, interruptions masquées, par accès direct aux registres
+ * FLASH (ni HAL ni bibliothèque C, qui résident en flash).
+ */
+
+#include "main.h"
+#include "fw_update.h"
+
+#if FW_UPDATE_ENABLE
+
+#include "serial.h"
+#include "serial_cmd.h"
+#include "nv_flash.h"
+#include "actuators.h"
+
+/** @brief Pages de l'application (banque 1, jusqu'à la zone de préparation). */
+#define FW_APP_PAGES        ((NV_FLASH_STAGE_START - FLASH_BASE) / FLASH_PAGE_SIZE)
+/** @brief Emplacements de la zone de préparation. */
+#define FW_STAGE_SLOTS      ((NV_FLASH_STAGE_END - NV_FLASH_STAGE_START) / FLASH_PAGE_SIZE)
+/** @brief Taille de la table des emplacements (borne de FW_STAGE_SLOTS). */
+#define FW_SLOT_MAX         128u
+/** @brief Aucune commande en attente. */
+#define FW_CMD_NONE         0xFFFFFFFFu
+/** @brief Attente de la fin d'émission de l'acquittement avant la recopie (ms). */
+#define FW_TX_DRAIN_MS      50u
+
+/**
+ * @brief Placement en SRAM inconditionnel : contrairement à MEM_RAMFUNC, la recopie ne
+ * peut pas retomber en flash quand MEM_RAMFUNC_ENABLE vaut 0.
+ */
+#define FW_RAMFUNC          __attribute__((section(".RamFunc"), noinline))
+
+/** @brief États du décodeur de flux de page. */
+typedef enum{
+    FW_DEC_IDLE = 0,        ///< Aucune page annoncée.
+    FW_DEC_HDR,             ///< En-tête du flux.
+    FW_DEC_CTRL,            ///< Octet de contrôle PackBits.
+    FW_DEC_LIT,             ///< Octets littéraux.
+    FW_DEC_RUN,             ///< Octet répété.
+    FW_DEC_DONE,            ///< Page complète, à préparer par fw_update_poll().
+    FW_DEC_ERROR            ///< Flux refusé, à acquitter par fw_update_poll().
+}fw_dec_t;
+
+/** @brief Session ouverte. */
+static uint8_t fw_session = 0;
+/** @brief Commande en attente de fw_update_poll() (FW_CMD_NONE : aucune). */
+static volatile uint32_t fw_cmd = FW_CMD_NONE;
+
+/** @brief État du décodeur. */
+static volatile fw_dec_t fw_dec = FW_DEC_IDLE;
+/** @brief Statut d'un flux refusé (FW_DEC_ERROR). */
+static uint8_t fw_dec_status = FW_ST_OK;
+/** @brief Page annoncée. */
+static uint16_t fw_page = 0;
+/** @brief En-tête du flux en cours. */
+static uint8_t fw_hdr[FW_STREAM_HDR_LEN];
+/** @brief Octets d'en-tête reçus, puis octets restants du bloc PackBits en cours. */
+static uint16_t fw_count = 0;
+/** @brief Octets de page décodés. */
+static uint16_t fw_pos = 0;
+/** @brief Page décodée (alignée pour la programmation par double mot). */
+static uint8_t fw_buf[FLASH_PAGE_SIZE] __attribute__((aligned(8)));
+
+/** @brief Page de l'application préparée dans chaque emplacement. */
+static uint16_t fw_slot_page[FW_SLOT_MAX];
+/** @brief Emplacements occupés. */
+static uint8_t fw_staged = 0;
+
+/**
+ * @brief  CRC-32 IEEE (zlib) d'un bloc aligné, par l'unité CRC.
+ * @details L'unité est partagée avec le backend matériel de crc8.c : sa configuration
+ * est sauvée puis rétablie, interruptions masquées (quelques dizaines de µs par page).
+ * @param  data Bloc (aligné sur 4 octets).
+ * @param  len  Longueur (multiple de 4).
+ * @return CRC calculé.
+ */
+static uint32_t fw_crc32(const void *data, uint32_t len){
+    const uint32_t *w = (const uint32_t *)data;
+    const uint32_t primask = __get_PRIMASK();
+
+    RCC->AHBENR |= RCC_AHBENR_CRCEN;
+    __disable_irq();
+
+    const uint32_t cr = CRC->CR;
+    const uint32_t pol = CRC->POL;
+    const uint32_t init = CRC->INIT;
+
+    CRC->POL  = 0x04C11DB7u;
+    CRC->INIT = 0xFFFFFFFFu;
+    CRC->CR   = CRC_CR_REV_IN_0 | CRC_CR_REV_OUT | CRC_CR_RESET;
+    for(uint32_t i = 0; i < len / 4u; i++){
+        CRC->DR = __REV(w[i]);     // Octet de poids faible en premier, comme zlib
+    }
+    const uint32_t crc = CRC->DR ^ 0xFFFFFFFFu;
+
+    CRC->POL  = pol;
+    CRC->INIT = init;
+    CRC->CR   = cr | CRC_CR_RESET;
+
+    __set_PRIMASK(primask);
+    return crc;
+}
+
+/**
+ * @brief  Indique si la propulsion est à l'arrêt (ni consigne, ni séquence de freinage).
+ * @return 1 si le véhicule peut être mis à jour.
+ */
+static uint8_t fw_vehicle_stopped(void){
+    const Motor_Handle_t *m = &act_motor[ACT_MOTOR_DRIVE];
+
+    return (m->ctx.target_speed_mms == 0 && m->state == MOTOR_STATE_NEUTRAL) ? 1u : 0u;
+}
+
+/**
+ * @brief  Cherche l'emplacement d'une page déjà préparée (renvoi après échec).
+ * @param  page Page de l'application.
+ * @return Emplacement, ou fw_staged si la page n'est pas préparée.
+ */
+static uint8_t fw_slot_find(uint16_t page){
+    uint8_t s = 0;
+
+    while(s < fw_staged && fw_slot_page[s] != page){
+        s++;
+    }
+    return s;
+}
+
+/**
+ * @brief  Refuse le flux de la page en cours ; l'acquittement part de fw_update_poll().
+ * @param  status Statut (FW_ST_*).
+ */
+static void fw_dec_fail(uint8_t status){
+    fw_dec_status = status;
+    fw_dec = FW_DEC_ERROR;
+}
+
+/**
+ * @brief  Annonce d'une page : démarre le décodeur dès l'analyse de la commande.
+ * @details Les trames groupées qui suivent peuvent être analysées dans la même passe,
+ * avant fw_update_poll().
+ * @param  page Page de l'application.
+ */
+static void fw_page_begin(uint16_t page){
+    fw_page = page;
+    if(!fw_session){
+        fw_dec_fail(FW_ST_STATE);
+    }
+    else if(page >= FW_APP_PAGES ||
+            (fw_slot_find(page) == fw_staged && (fw_staged >= FW_STAGE_SLOTS || fw_staged >= FW_SLOT_MAX))){
+        fw_dec_fail(FW_ST_RANGE);
+    }
+    else{
+        fw_count = 0;
+        fw_pos = 0;
+        fw_dec = FW_DEC_HDR;
+    }
+}
+
+void fw_update_command(uint16_t value){
+    if((value >> FW_OP_SHIFT) == FW_OP_PAGE){
+        fw_page_begin(value & FW_ARG_MASK);
+        return;
+    }
+    fw_cmd = value;
+}
+
+void fw_update_data(const uint8_t *data, uint8_t count){
+    const uint16_t len = (uint16_t)count * 2u;
+
+    for(uint16_t i = 0; i < len; i++){
+        const uint8_t b = data[i];
+
+        switch(fw_dec){
+            case FW_DEC_HDR:
+                fw_hdr[fw_count++] = b;
+                if(fw_count == FW_STREAM_HDR_LEN){
+                    fw_dec = FW_DEC_CTRL;
+                }
+            break;
+
+            case FW_DEC_CTRL:
+                if(b < 0x80u){
+                    fw_count = (uint16_t)b + 1u;
+                    fw_dec = FW_DEC_LIT;
+                }
+                else{
+                    fw_count = (uint16_t)(b & 0x7Fu) + FW_RUN_MIN;
+                    fw_dec = FW_DEC_RUN;
+                }
+            break;
+
+            case FW_DEC_LIT:
+                if(fw_pos >= FLASH_PAGE_SIZE){
+                    fw_dec_fail(FW_ST_FORMAT);
+                    return;
+                }
+                fw_buf[fw_pos++] = b;
+                if(--fw_count == 0u){
+                    fw_dec = FW_DEC_CTRL;
+                }
+            break;
+
+            case FW_DEC_RUN:
+                if(fw_pos + fw_count > FLASH_PAGE_SIZE){
+                    fw_dec_fail(FW_ST_FORMAT);
+                    return;
+                }
+                for(uint16_t k = 0; k < fw_count; k++){
+                    fw_buf[fw_pos++] = b;
+                }
+                fw_dec = FW_DEC_CTRL;
+            break;
+
+            default:
+                return;     // Hors page, ou octet de bourrage après la page complète
+        }
+
+        if(fw_pos == FLASH_PAGE_SIZE && fw_dec == FW_DEC_CTRL){
+            fw_dec = FW_DEC_DONE;
+        }
+    }
+}
+
+/**
+ * @brief  Page décodée : combinaison delta, contrôle du CRC, préparation dans la banque 2.
+ */
+static void fw_page_stage(void){
+    const uint32_t expected = (uint32_t)fw_hdr[2] | ((uint32_t)fw_hdr[3] << 8) |
+                              ((uint32_t)fw_hdr[4] << 16) | ((uint32_t)fw_hdr[5] << 24);
+    const uint8_t slot = fw_slot_find(fw_page);
+    uint8_t status = FW_ST_OK;
+
+    if(fw_hdr[0] & FW_PAGE_F_XOR){
+        const uint32_t *cur = (const uint32_t *)(FLASH_BASE + (uint32_t)fw_page * FLASH_PAGE_SIZE);
+        uint32_t *dst = (uint32_t *)fw_buf;
+
+        for(uint32_t i = 0; i < FLASH_PAGE_SIZE / 4u; i++){
+            dst[i] ^= cur[i];
+        }
+    }
+
+    const uint32_t crc = fw_crc32(fw_buf, FLASH_PAGE_SIZE);
+    if(crc != expected){
+        status = FW_ST_CRC;
+    }
+    else{
+        const uint32_t addr = NV_FLASH_STAGE_START + (uint32_t)slot * FLASH_PAGE_SIZE;
+
+        if(nv_flash_erase_page(addr) != 0 || nv_flash_program(addr, fw_buf, FLASH_PAGE_SIZE) != 0){
+            status = FW_ST_FLASH;
+        }
+        else if(slot == fw_staged){
+            fw_slot_page[slot] = fw_page;
+            fw_staged++;
+        }
+    }
+    serial_send_fw(FW_OP_PAGE, status, fw_page, fw_staged, crc);
+}
+
+/**
+ * @brief  Attend une opération flash de la banque 1 en rafraîchissant l'IWDG.
+ */
+FW_RAMFUNC static void fw_ram_wait(void){
+    while(FLASH->SR & FLASH_SR_BSY1){
+        IWDG->KR = 0xAAAAu;
+    }
+}
+
+/**
+ * @brief  Recopie les pages préparées dans la banque 1 puis redémarre (sans retour).
+ * @details Exécutée depuis la SRAM, interruptions masquées : pendant l'effacement, la
+ * banque 1 (vecteurs, HAL, code de l'application) est illisible. La banque 2 reste
+ * lisible. Aucun appel de fonction : seules des écritures de registres et des
+ * intrinsèques à inlining forcé.
+ * @param  pages Page de destination de chaque emplacement.
+ * @param  count Nombre d'emplacements.
+ * @param  stage Adresse du premier emplacement.
+ */
+FW_RAMFUNC static void fw_ram_copy(const uint16_t *pages, uint32_t count, uint32_t stage){
+    __disable_irq();
+
+    fw_ram_wait();
+    if(FLASH->CR & FLASH_CR_LOCK){
+        FLASH->KEYR = FLASH_KEY1;
+        FLASH->KEYR = FLASH_KEY2;
+    }
+    FLASH->SR = FLASH_SR_ERRORS;
+
+    for(uint32_t s = 0; s < count; s++){
+        volatile uint32_t *dst = (volatile uint32_t *)(FLASH_BASE + (uint32_t)pages[s] * FLASH_PAGE_SIZE);
+        const uint32_t *src = (const uint32_t *)(stage + s * FLASH_PAGE_SIZE);
+
+        FLASH->CR = FLASH_CR_PER | ((uint32_t)pages[s] << FLASH_CR_PNB_Pos);
+        FLASH->CR |= FLASH_CR_STRT;
+        fw_ram_wait();
+
+        FLASH->CR = FLASH_CR_PG;
+        for(uint32_t i = 0; i < FLASH_PAGE_SIZE / 4u; i += 2u){
+            dst[i]      = src[i];
+            dst[i + 1u] = src[i + 1u];      // Double mot complet : lance la programmation
+            fw_ram_wait();
+        }
+        FLASH->CR = 0;
+    }
+
+    FLASH->CR = FLASH_CR_LOCK;
+    __DSB();
+    SCB->AIRCR = (0x5FAu << SCB_AIRCR_VECTKEY_Pos) | SCB_AIRCR_SYSRESETREQ_Msk;
+    __DSB();
+    for(;;){
+    }
+}
+
+/**
+ * @brief  Validation : acquitte, laisse partir l'acquittement, recopie et redémarre.
+ * @param  count Nombre de pages annoncé par l'hôte.
+ * @return Statut en cas de refus (la fonction ne revient pas sinon).
+ */
+static uint8_t fw_commit(uint16_t count){
+    if(count == 0u || count != fw_staged){
+        return FW_ST_STATE;
+    }
+    if(!fw_vehicle_stopped()){
+        return FW_ST_BUSY;
+    }
+
+    serial_send_fw(FW_OP_COMMIT, FW_ST_OK, count, fw_staged, 0);
+    const uint32_t t0 = HAL_GetTick();
+    while(!serial_tx_idle() && (HAL_GetTick() - t0) < FW_TX_DRAIN_MS){
+    }
+
+    fw_ram_copy(fw_slot_page, fw_staged, NV_FLASH_STAGE_START);
+    return FW_ST_FLASH;
+}
+
+void fw_update_poll(void){
+    if(fw_dec == FW_DEC_DONE){
+        fw_page_stage();
+        fw_dec = FW_DEC_IDLE;
+    }
+    else if(fw_dec == FW_DEC_ERROR){
+        serial_send_fw(FW_OP_PAGE, fw_dec_status, fw_page, fw_staged, 0);
+        fw_dec = FW_DEC_IDLE;
+    }
+
+    const uint32_t cmd = fw_cmd;
+    if(cmd == FW_CMD_NONE){
+        return;
+    }
+    fw_cmd = FW_CMD_NONE;
+
+    const uint8_t op = (uint8_t)(cmd >> FW_OP_SHIFT);
+    uint16_t arg = (uint16_t)(cmd & FW_ARG_MASK);
+    uint8_t status = FW_ST_OK;
+    uint32_t crc = 0;
+
+    switch(op){
+        case FW_OP_ABORT:
+            fw_session = 0;
+            fw_staged = 0;
+            fw_dec = FW_DEC_IDLE;
+        break;
+
+        case FW_OP_BEGIN:
+            if(!fw_vehicle_stopped()){
+                status = FW_ST_BUSY;
+                break;
+            }
+            fw_session = 1;
+            fw_staged = 0;
+            fw_dec = FW_DEC_IDLE;
+            arg = (uint16_t)FW_APP_PAGES;   // Taille de l'application, en pages
+        break;
+
+        case FW_OP_QUERY:
+            if(!fw_session)                 status = FW_ST_STATE;
+            else if(arg >= FW_APP_PAGES)    status = FW_ST_RANGE;
+            else crc = fw_crc32((const void *)(FLASH_BASE + (uint32_t)arg * FLASH_PAGE_SIZE), FLASH_PAGE_SIZE);
+        break;
+
+        case FW_OP_COMMIT:
+            status = fw_session ? fw_commit(arg) : FW_ST_STATE;
+        break;
+
+        default:
+            status = FW_ST_STATE;
+        break;
+    }
+    serial_send_fw(op, status, arg, fw_staged, crc);
+}
+
+#endif /* FW_UPDATE_ENABLE */
@@ -0,0 +1,203 @@
+/**
+ * @file    imu_filt.c
+ * @brief   Implémentation du filtre anti-repliement des échantillons IMU (cf. imu_filt.h).
+ * @details Biquads en forme directe I : y = b0 (x + 2 x1 + x2) - a1 y1 - a2 y2, produits
+ * sur 64 bits. Seuls a1 et a2 sont tabulés ; b0 = (1 + a1 + a2) / 4 en est déduit, ce
+ * qui garantit un gain statique exactement unitaire (pas de biais sur la gravité ou
+ * l'offset gyroscope). Entrées et états en Q8 du LSB capteur ; le reste de chaque
+ * arrondi est réinjecté au pas suivant : avec des pôles proches de 1 (D = 32), un
+ * arrondi simple laisserait une zone morte d'un demi-LSB en régime établi.
+ * Exécution en boucle principale uniquement (retrait de la file) : aucune section critique.
+ */
+
+#include "imu_filt.h"
+
+#if IMU_FILT_ENABLE
+
+/** @brief Nombre d'axes filtrés (accéléromètre puis gyroscope). */
+#define IMU_FILT_AXES           6u
+/** @brief Bits fractionnaires des coefficients. */
+#define IMU_FILT_COEF_Q         30
+/** @brief Bits fractionnaires des entrées et des états. */
+#define IMU_FILT_STATE_Q        8
+
+/**
+ * @brief Coefficients (a1, a2) en Q30 par rapport de décimation D = 2..IMU_FILT_DECIM_MAX,
+ * coupure fs / (4 D) : [0] ordre 2 (Q = 0,7071), [1] et [2] ordre 4 (Q = 0,5412 et 1,3066).
+ * @details Transformée bilinéaire, K = tan(pi / 4D) : a1 = 2 (K² - 1) n, a2 = (1 - K/Q + K²) n,
+ * n = 1 / (1 + K/Q + K²).
+ */
+static const int32_t filt_coef[IMU_FILT_DECIM_MAX - 1u][3][2] = {
+    { { -1012333500, 357913941 }, { -918476537, 225180151 }, { -1195106706, 616394288 } },   // D = 2
+    { { -1373994854, 512810774 }, { -1272128604, 395185759 }, { -1561076363, 728833893 } },   // D = 3
+    { { -1561482161, 616394288 }, { -1465783472, 512810774 }, { -1730578792, 799423163 } },   // D = 4
+    { { -1676130396, 688645970 }, { -1588788093, 596808838 }, { -1826396544, 846645149 } },   // D = 5
+    { { -1753413056, 741524947 }, { -1674021809, 659333080 }, { -1887373567, 880211073 } },   // D = 6
+    { { -1809002354, 781782396 }, { -1736622493, 707541152 }, { -1929347978, 905222932 } },   // D = 7
+    { { -1850890572, 813409838 }, { -1784569606, 745789567 }, { -1959898570, 924553429 } },   // D = 8
+    { { -1883578125, 838893529 }, { -1822478350, 776851192 }, { -1983078460, 939928817 } },   // D = 9
+    { { -1909791329, 859855294 }, { -1853206872, 802565504 }, { -2001240540, 952444431 } },   // D = 10
+    { { -1931277459, 877395398 }, { -1878620959, 824197420 }, { -2015839648, 962827160 } },   // D = 11
+    { { -1949207645, 892285457 }, { -1899990827, 842643949 }, { -2027821515, 971577683 } },   // D = 12
+    { { -1964396071, 905082102 }, { -1918211419, 858558238 }, { -2037826458, 979051810 } },   // D = 13
+    { { -1977426226, 916196718 }, { -1933931575, 872426851 }, { -2046302884, 985509198 } },   // D = 14
+    { { -1988727146, 925939787 }, { -1947633240, 884619524 }, { -2053573861, 991143696 } },   // D = 15
+    { { -1998621313, 934549963 }, { -1959681914, 895422152 }, { -2059877865, 996102909 } },   // D = 16
+    { { -2007355779, 942213665 }, { -1970359835, 905059228 }, { -2065394659, 1000501190 } },   // D = 17
+    { { -2015122985, 949078604 }, { -1979888423, 913709451 }, { -2070262246, 1004428487 } },   // D = 18
+    { { -2022075056, 955263314 }, { -1988443828, 921516824 }, { -2074588288, 1007956519 } },   // D = 19
+    { { -2028333824, 960864011 }, { -1996167941, 928598664 }, { -2078457980, 1011143161 } },   // D = 20
+    { { -2033998008, 965959603 }, { -2003176341, 935051510 }, { -2081939604, 1014035630 } },   // D = 21
+    { { -2039148445, 970615409 }, { -2009564123, 940955517 }, { -2085088515, 1016672828 } },   // D = 22
+    { { -2043851959, 974885960 }, { -2015410248, 946377789 }, { -2087950049, 1019087093 } },   // D = 23
+    { { -2048164275, 978817138 }, { -2020780823, 951374929 }, { -2090561692, 1021305525 } },   // D = 24
+    { { -2052132225, 982447822 }, { -2025731614, 955995012 }, { -2092954698, 1023351008 } },   // D = 25
+    { { -2055795457, 985811176 }, { -2030309998, 960279135 }, { -2095155334, 1025242994 } },   // D = 26
+    { { -2059187759, 988935659 }, { -2034556478, 964262635 }, { -2097185832, 1026998128 } },   // D = 27
+    { { -2062338104, 991845831 }, { -2038505887, 967976063 }, { -2099065133, 1028630730 } },   // D = 28
+    { { -2065271477, 994563001 }, { -2042188349, 971445970 }, { -2100809474, 1030153194 } },   // D = 29
+    { { -2068009541, 997105741 }, { -2045630049, 974695537 }, { -2102432854, 1031576295 } },   // D = 30
+    { { -2070571165, 999490319 }, { -2048853853, 977745098 }, { -2103947402, 1032909450 } },   // D = 31
+    { { -2072972867, 1001731041 }, { -2051879822, 980612557 }, { -2105363683, 1034160920 } },   // D = 32
+};
+
+/**
+ * @brief État d'un biquad pour un axe.
+ */
+typedef struct {
+    int32_t x1;     ///< Entrée précédente (Q8).
+    int32_t x2;     ///< Entrée d'avant (Q8).
+    int32_t y1;     ///< Sortie précédente (Q8).
+    int32_t y2;     ///< Sortie d'avant (Q8).
+    int32_t rem;    ///< Reste de l'arrondi précédent (Q30 du pas Q8), réinjecté.
+} imu_filt_state_t;
+
+/** @brief États des biquads, par section et par axe. */
+static imu_filt_state_t filt_state[IMU_FILT_SECTIONS_MAX][IMU_FILT_AXES];
+/** @brief Coefficients en service, par section : b0, a1, a2 (Q30). */
+static int32_t filt_b[IMU_FILT_SECTIONS_MAX][3];
+/** @brief Nombre de biquads en service. */
+static uint8_t filt_sections = 0;
+/** @brief Ordre demandé (imu_filt_order_t). */
+static uint8_t filt_order = IMU_FILT_OFF;
+/** @brief Rapport de décimation des coefficients en service, 0 : filtre inactif. */
+static uint8_t filt_d = 0;
+/** @brief Les états sont à recaler sur le prochain échantillon (activation, changement d'ordre). */
+static uint8_t filt_reset = 1;
+/** @brief Période d'émission de la télémétrie (µs). */
+static uint32_t filt_out_us = 0;
+/** @brief Période d'acquisition mesurée (µs, Q4, moyenne glissante sur 16 échantillons). */
+static uint32_t filt_in_us_q4 = 0;
+/** @brief Date de l'échantillon précédent (µs). */
+static uint64_t filt_last_us = 0;
+
+/**
+ * @brief  Met en service les coefficients d'un rapport de décimation.
+ * @param  d Rapport (2..IMU_FILT_DECIM_MAX).
+ */
+static void imu_filt_load(uint8_t d){
+    const int32_t (*c)[2] = filt_coef[d - 2u];
+
+    filt_sections = (filt_order == IMU_FILT_ORDER2) ? 1u : 2u;
+    for(uint8_t s = 0; s < filt_sections; s++){
+        const int32_t *ab = c[(filt_order == IMU_FILT_ORDER2) ? 0u : (uint8_t)(s + 1u)];
+
+        filt_b[s][0] = (int32_t)((((int64_t)1 << IMU_FILT_COEF_Q) + ab[0] + ab[1]) / 4);
+        filt_b[s][1] = ab[0];
+        filt_b[s][2] = ab[1];
+    }
+}
+
+/**
+ * @brief  Filtre un axe à travers la cascade.
+ * @param  axis Axe (0..2 accéléromètre, 3..5 gyroscope).
+ * @param  in   Échantillon brut (LSB).
+ * @return Échantillon filtré (LSB, saturé sur 16 bits).
+ */
+static int16_t imu_filt_axis(uint8_t axis, int16_t in){
+    int32_t v = (int32_t)in * (1 << IMU_FILT_STATE_Q);
+
+    for(uint8_t s = 0; s < filt_sections; s++){
+        imu_filt_state_t *st = &filt_state[s][axis];
+        const int32_t *b = filt_b[s];
+
+        if(filt_reset){
+            st->x1 = st->x2 = st->y1 = st->y2 = v;     // Régime établi : pas de transitoire
+            st->rem = 0;
+        }
+
+        const int64_t acc = (int64_t)b[0] * (v + 2 * st->x1 + st->x2)
+                          - (int64_t)b[1] * st->y1 - (int64_t)b[2] * st->y2 + st->rem;
+        const int32_t y = (int32_t)((acc + ((int64_t)1 << (IMU_FILT_COEF_Q - 1))) >> IMU_FILT_COEF_Q);
+
+        st->rem = (int32_t)(acc - ((int64_t)y << IMU_FILT_COEF_Q));
+
+        st->x2 = st->x1;
+        st->x1 = v;
+        st->y2 = st->y1;
+        st->y1 = y;
+        v = y;
+    }
+
+    v = (v + (1 << (IMU_FILT_STATE_Q - 1))) >> IMU_FILT_STATE_Q;
+    if(v > INT16_MAX) v = INT16_MAX;
+    if(v < INT16_MIN) v = INT16_MIN;
+    return (int16_t)v;
+}
+
+void imu_filt_configure(uint8_t order){
+    filt_order = (order > IMU_FILT_ORDER4) ? (uint8_t)IMU_FILT_ORDER4 : order;
+    filt_d = 0;         // Coefficients rechargés et états recalés au prochain échantillon
+}
+
+void imu_filt_set_output_us(uint32_t period_us){
+    filt_out_us = period_us;
+}
+
+void imu_filt_apply(bmi088_raw_t *raw, uint64_t timestamp_us){
+    const uint64_t dt = timestamp_us - filt_last_us;
+    uint32_t d = 0;
+
+    filt_last_us = timestamp_us;
+    if(dt != 0u && dt < IMU_FILT_GAP_US){
+        const int32_t dt_q4 = (int32_t)dt * 16;
+        filt_in_us_q4 = (filt_in_us_q4 == 0u) ? (uint32_t)dt_q4 :
+                        (uint32_t)((int32_t)filt_in_us_q4 + (dt_q4 - (int32_t)filt_in_us_q4) / 16);
+    }
+
+    if(filt_order != IMU_FILT_OFF && filt_in_us_q4 != 0u){
+        d = (filt_out_us * 16u + filt_in_us_q4 / 2u) / filt_in_us_q4;
+        if(d < 2u){
+            d = 0;
+        }
+        else if(d > IMU_FILT_DECIM_MAX){
+            d = IMU_FILT_DECIM_MAX;
+        }
+    }
+
+    if(d != filt_d){
+        if(filt_d == 0u){
+            filt_reset = 1;     // Activation : départ en régime établi
+        }
+        filt_d = (uint8_t)d;
+        if(d != 0u){
+            imu_filt_load((uint8_t)d);
+        }
+    }
+
+    if(filt_d == 0u){
+        return;
+    }
+
+    for(uint8_t i = 0; i < 3u; i++){
+        raw->accel[i] = imu_filt_axis(i, raw->accel[i]);
+        raw->gyro[i]  = imu_filt_axis((uint8_t)(3u + i), raw->gyro[i]);
+    }
+    filt_reset = 0;
+}
+
+uint8_t imu_filt_decim(void){
+    return filt_d;
+}
+
+#endif /* IMU_FILT_ENABLE */
@@ -0,0 +1,241 @@
+/**
+ * @file    imu_health.c
+ * @brief   Implémentation de la surveillance de la santé de l'IMU (cf. imu_health.h).
+ * @details Le contrôle par échantillon ne fait que comparer et compter ; les décisions
+ * (reconfiguration, récupération, journal) sont prises par imu_health_check() dans la
+ * tâche IMU. Observateur et tâche s'exécutent en boucle principale : aucune section
+ * critique.
+ */
+
+#include "imu_health.h"
+#include "dlog.h"
+#include <string.h>
+
+#if IMU_HEALTH_ENABLE
+
+/** @brief Détection d'un capteur figé à transmettre (champ stuck). */
+#define HEALTH_STUCK_ACC    0x01u
+#define HEALTH_STUCK_GYR    0x02u
+
+/**
+ * @brief État de la surveillance.
+ */
+typedef struct {
+    bmi088_raw_t prev;          ///< Échantillon précédent.
+    uint16_t acc_same;          ///< Échantillons accéléromètre identiques consécutifs.
+    uint16_t gyr_same;          ///< Échantillons gyroscope identiques consécutifs.
+    uint16_t n;                 ///< Échantillons de la fenêtre en cours.
+    uint16_t acc_sat;           ///< Échantillons accéléromètre saturés de la fenêtre en cours.
+    uint16_t gyr_sat;           ///< Échantillons gyroscope saturés de la fenêtre en cours.
+    uint16_t win_acc_sat;       ///< Saturations de la dernière fenêtre close.
+    uint16_t win_gyr_sat;
+    uint8_t  win_ready;         ///< Fenêtre close, à évaluer.
+    uint8_t  stuck;             ///< Capteurs figés à signaler (HEALTH_STUCK_*).
+    uint8_t  rearm;             ///< Capteur réinitialisé ou reconfiguré : surveillance à réarmer.
+    uint32_t seen;              ///< Échantillons contrôlés.
+    uint32_t seen_ref;          ///< Valeur de seen au dernier échantillon vu par la tâche.
+    uint64_t last_us;           ///< Date à laquelle la tâche a vu le dernier échantillon.
+    uint32_t bus_ref;           ///< Erreurs SPI cumulées au début de la fenêtre.
+    uint32_t events;            ///< Détections journalisées.
+} imu_health_t;
+
+static imu_health_t health;
+
+/**
+ * @brief  Indique si un axe d'un capteur atteint le seuil de saturation.
+ * @param  v Axes X, Y, Z (LSB).
+ * @return 1 si saturé.
+ */
+static inline uint8_t health_saturated(const int16_t v[3]){
+    for(uint8_t i = 0; i < 3u; i++){
+        if(v[i] >= IMU_HEALTH_SAT_LSB || v[i] <= -IMU_HEALTH_SAT_LSB){
+            return 1u;
+        }
+    }
+    return 0u;
+}
+
+/**
+ * @brief  Erreurs SPI cumulées (timeouts et erreurs HAL).
+ */
+static uint32_t health_bus_errors(void){
+    bmi088_bus_stats_t stats;
+
+    BMI088_Get_Bus_Stats(&stats);
+    return stats.timeouts + stats.errors;
+}
+
+/**
+ * @brief  Journalise une détection.
+ * @param  cause  imu_health_cause_t.
+ * @param  value  Mesure associée.
+ * @param  action imu_health_action_t.
+ */
+static void health_report(uint8_t cause, uint32_t value, uint8_t action){
+    health.events++;
+    DLOG3(DLOG_IMU_HEALTH, cause, value, action);
+}
+
+/**
+ * @brief  Arme la récupération du driver.
+ * @return IMU_HEALTH_ACT_RECOVER si armée, IMU_HEALTH_ACT_NONE sinon.
+ */
+static uint8_t health_recover(void){
+#if IMU_HEALTH_AUTO_RECOVER
+    if(BMI088_Recover() == BMI08_OK){
+        health.acc_same = 0;
+        health.gyr_same = 0;
+        health.rearm = 1;
+        return IMU_HEALTH_ACT_RECOVER;
+    }
+#endif
+    return IMU_HEALTH_ACT_NONE;
+}
+
+/**
+ * @brief  Élargit d'un cran la gamme d'un capteur saturé.
+ * @param  gyro 0 : accéléromètre, 1 : gyroscope.
+ * @return IMU_HEALTH_ACT_RANGE si la gamme a changé, IMU_HEALTH_ACT_NONE sinon.
+ */
+static uint8_t health_range_up(uint8_t gyro){
+#if IMU_HEALTH_AUTO_RANGE
+    bmi088_config_t cfg;
+
+    BMI088_Get_Config(&cfg);
+    if(!gyro && cfg.accel_range < BMI088_ACCEL_RANGE_24G){
+        cfg.accel_range++;
+    }
+    else if(gyro && cfg.gyro_range > BMI08_GYRO_RANGE_2000_DPS){
+        cfg.gyro_range--;               // Codes Bosch : 0 = ±2000 °/s, gamme la plus large
+    }
+    else{
+        return IMU_HEALTH_ACT_NONE;
+    }
+    if(BMI088_Configure(&cfg) == BMI08_OK){
+        health.rearm = 1;
+        return IMU_HEALTH_ACT_RANGE;
+    }
+#else
+    (void)gyro;
+#endif
+    return IMU_HEALTH_ACT_NONE;
+}
+
+void imu_health_init(void){
+    memset(&health, 0, sizeof(health));
+    health.bus_ref = health_bus_errors();
+}
+
+void imu_health_record(const bmi088_raw_t *raw){
+    imu_health_t *h = &health;
+
+    if(memcmp(raw->accel, h->prev.accel, sizeof(raw->accel)) == 0){
+        if(++h->acc_same == IMU_HEALTH_STUCK_SAMPLES){
+            h->stuck |= HEALTH_STUCK_ACC;
+        }
+    }
+    else{
+        h->acc_same = 0;
+    }
+    if(memcmp(raw->gyro, h->prev.gyro, sizeof(raw->gyro)) == 0){
+        if(++h->gyr_same == IMU_HEALTH_STUCK_SAMPLES){
+            h->stuck |= HEALTH_STUCK_GYR;
+        }
+    }
+    else{
+        h->gyr_same = 0;
+    }
+    h->prev = *raw;
+
+    h->acc_sat += health_saturated(raw->accel);
+    h->gyr_sat += health_saturated(raw->gyro);
+    if(++h->n >= IMU_HEALTH_WINDOW){
+        h->win_acc_sat = h->acc_sat;
+        h->win_gyr_sat = h->gyr_sat;
+        h->win_ready = 1;
+        h->n = 0;
+        h->acc_sat = 0;
+        h->gyr_sat = 0;
+    }
+    h->seen++;
+}
+
+uint8_t imu_health_check(uint64_t now_us, uint32_t period_us){
+    imu_health_t *h = &health;
+    uint8_t action = IMU_HEALTH_ACT_NONE;
+
+    if(period_us == 0u || h->rearm){
+        /* Aucun échantillon attendu, ou capteur tout juste relancé : la fenêtre en cours
+           n'est pas représentative et le silence de la récupération n'est pas un défaut */
+        h->seen_ref = h->seen;
+        h->last_us = now_us;
+        h->win_ready = 0;
+        h->stuck = 0;
+        h->rearm = 0;
+        h->n = 0;
+        h->acc_sat = 0;
+        h->gyr_sat = 0;
+        h->bus_ref = health_bus_errors();
+        return IMU_HEALTH_ACT_NONE;
+    }
+
+    if(h->seen != h->seen_ref){
+        h->seen_ref = h->seen;
+        h->last_us = now_us;
+    }
+    else{
+        uint64_t limit_us = (uint64_t)period_us * IMU_HEALTH_SILENCE_PERIODS;
+        if(limit_us < IMU_HEALTH_SILENCE_MIN_US){
+            limit_us = IMU_HEALTH_SILENCE_MIN_US;
+        }
+        if(now_us - h->last_us > limit_us){
+            action = health_recover();
+            health_report(IMU_HEALTH_SILENT, (uint32_t)((now_us - h->last_us) / 1000u), action);
+            h->last_us = now_us;
+            return action;
+        }
+    }
+
+    if(h->stuck != 0u){
+        const uint8_t stuck = h->stuck;
+
+        h->stuck = 0;
+        action = health_recover();
+        health_report((stuck & HEALTH_STUCK_ACC) ? IMU_HEALTH_ACC_STUCK : IMU_HEALTH_GYR_STUCK,
+                      IMU_HEALTH_STUCK_SAMPLES, action);
+        return action;
+    }
+
+    if(h->win_ready){
+        const uint32_t errs = health_bus_errors();
+        const uint32_t win_errs = errs - h->bus_ref;
+
+        h->win_ready = 0;
+        h->bus_ref = errs;
+
+        if(win_errs >= IMU_HEALTH_ERR_MAX){
+            action = health_recover();
+            health_report(IMU_HEALTH_BUS_ERRORS, win_errs, action);
+            return action;
+        }
+        if(h->win_acc_sat >= IMU_HEALTH_SAT_MAX){
+            action = health_range_up(0u);
+            health_report(IMU_HEALTH_ACC_SAT, h->win_acc_sat, action);
+        }
+        if(h->win_gyr_sat >= IMU_HEALTH_SAT_MAX){
+            const uint8_t gyr_action = health_range_up(1u);
+            health_report(IMU_HEALTH_GYR_SAT, h->win_gyr_sat, gyr_action);
+            if(gyr_action != IMU_HEALTH_ACT_NONE){
+                action = gyr_action;
+            }
+        }
+    }
+
+    return action;
+}
+
+uint32_t imu_health_events(void){
+    return health.events;
+}
+
+#endif /* IMU_HEALTH_ENABLE */
@@ -0,0 +1,347 @@
+/**
+ * @file    imu_hist.c
+ * @brief   Implémentation de l'historique IMU figé sur événement.
+ * @details Producteur (observateur brut du driver) et consommateurs (commandes,
+ * téléchargement) s'exécutent tous en boucle principale : aucune section critique.
+ */
+
+#include "imu_hist.h"
+#include "serial.h"
+#include "dlog.h"
+#include "rice.h"
+#include "mem_map.h"
+#include <string.h>
+
+#if IMU_HIST_ENABLE
+
+#if (IMU_HIST_LEN & (IMU_HIST_LEN - 1u))
+#error "IMU_HIST_LEN must be a power of two"
+#endif
+
+/** @brief Longueur d'une trame de bloc (entête 4 + INDEX/TOTAL/TRIG/RANGES/COUNT 8 + échantillons + CRC). */
+#define IMU_HIST_FRAME_LEN(n)   (4u + 8u + sizeof(imu_hist_sample_t) * (n) + 1u)
+
+/**
+ * @brief Échantillon de l'historique (16 octets).
+ */
+typedef struct {
+    uint32_t     t_us;      ///< Date d'acquisition (µs, GetMicros64 tronqué).
+    bmi088_raw_t raw;       ///< Axes bruts (LSB).
+} imu_hist_sample_t;
+
+/** @brief Historique circulaire (64 Ko, non mis à zéro : seuls les hist_count derniers échantillons sont lus). */
+static imu_hist_sample_t hist_ring[IMU_HIST_LEN] MEM_NOINIT;
+/** @brief Nombre d'échantillons enregistrés depuis le réarmement (index libre). */
+static uint32_t hist_head = 0;
+/** @brief Échantillons valides dans l'historique (au plus IMU_HIST_LEN). */
+static uint16_t hist_count = 0;
+/** @brief État (imu_hist_state_t). */
+static uint8_t hist_state = IMU_HIST_RECORDING;
+/** @brief Source du déclenchement (imu_hist_trig_t). */
+static uint8_t hist_source = IMU_HIST_TRIG_NONE;
+/** @brief Index libre de l'échantillon de déclenchement. */
+static uint32_t hist_trig_pos = 0;
+/** @brief Échantillons restant à enregistrer avant de figer. */
+static uint16_t hist_post_left = 0;
+/** @brief Profondeur post-déclenchement (échantillons). */
+static uint16_t hist_post = IMU_HIST_POST_DEFAULT;
+/** @brief Seuil de déclenchement par axe (LSB accéléromètre, 0 : inactif). */
+static int32_t hist_thr_lsb = 0;
+/** @brief Gammes IMU reportées dans les blocs. */
+static uint8_t hist_ranges = 0;
+
+/**
+ * @brief  Règle le déclenchement sur seuil et la profondeur post-déclenchement.
+ * @details Gamme accéléromètre n : 32768 LSB pour (3 << n) g.
+ * @param  thr_mg Seuil d'accélération par axe (mg), 0 : inactif.
+ * @param  post   Échantillons enregistrés après le déclenchement.
+ * @param  ranges Gammes IMU courantes (IMU_CFG_PACK).
+ */
+void imu_hist_configure(uint16_t thr_mg, uint16_t post, uint8_t ranges){
+    hist_thr_lsb = (int32_t)(((uint32_t)thr_mg * 32768u) / (3000u << (ranges & 0x03u)));
+    hist_post    = (post >= IMU_HIST_LEN) ? (uint16_t)(IMU_HIST_LEN - 1u) : post;
+    hist_ranges  = ranges;
+}
+
+/**
+ * @brief  Fige l'historique.
+ */
+static void imu_hist_freeze(void){
+    hist_state = IMU_HIST_FROZEN;
+    DLOG3(DLOG_IMU_HIST_FROZEN, hist_source, hist_count, imu_hist_trigger_index());
+}
+
+/**
+ * @brief  Teste le seuil de déclenchement sur les trois axes de l'accéléromètre.
+ * @param  raw Échantillon brut.
+ * @return 1 si un axe dépasse le seuil.
+ */
+static uint8_t imu_hist_over_threshold(const bmi088_raw_t *raw){
+    for(uint8_t i = 0; i < 3u; i++){
+        const int32_t a = raw->accel[i];
+
+        if(a > hist_thr_lsb || -a > hist_thr_lsb){
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief  Enregistre un échantillon.
+ * @param  raw          Échantillon brut.
+ * @param  timestamp_us Date de l'acquisition (µs).
+ */
+void imu_hist_record(const bmi088_raw_t *raw, uint64_t timestamp_us){
+    if(hist_state == IMU_HIST_FROZEN){
+        return;
+    }
+
+    imu_hist_sample_t *s = &hist_ring[hist_head & (IMU_HIST_LEN - 1u)];
+    s->t_us = (uint32_t)timestamp_us;
+    s->raw  = *raw;
+    hist_head++;
+    if(hist_count < IMU_HIST_LEN){
+        hist_count++;
+    }
+
+    if(hist_state == IMU_HIST_POST_TRIGGER){
+        if(--hist_post_left == 0){
+            imu_hist_freeze();
+        }
+    }
+    else if(hist_thr_lsb != 0 && imu_hist_over_threshold(raw)){
+        imu_hist_trigger(IMU_HIST_TRIG_THRESHOLD);
+    }
+}
+
+/**
+ * @brief  Déclenche la capture sur le dernier échantillon enregistré.
+ * @param  source Source du déclenchement (imu_hist_trig_t).
+ */
+void imu_hist_trigger(uint8_t source){
+    if(hist_state != IMU_HIST_RECORDING){
+        return;
+    }
+
+    hist_source    = source;
+    hist_trig_pos  = (hist_head != 0) ? hist_head - 1u : 0u;
+    hist_post_left = hist_post;
+    hist_state     = IMU_HIST_POST_TRIGGER;
+
+    if(hist_post_left == 0){
+        imu_hist_freeze();
+    }
+}
+
+/**
+ * @brief  Exécute une commande de REG_HIST_CMD.
+ * @param  cmd Commande (imu_hist_cmd_t).
+ */
+void imu_hist_command(uint8_t cmd){
+    switch(cmd){
+        case IMU_HIST_CMD_TRIGGER:
+            imu_hist_trigger(IMU_HIST_TRIG_HOST);
+            break;
+
+        case IMU_HIST_CMD_REARM:
+            hist_head   = 0;
+            hist_count  = 0;
+            hist_source = IMU_HIST_TRIG_NONE;
+            hist_state  = IMU_HIST_RECORDING;
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief  État et source du déclenchement.
+ * @return imu_hist_state_t | (imu_hist_trig_t << 4).
+ */
+uint8_t imu_hist_status(void){
+    return (uint8_t)(hist_state | (hist_source << 4));
+}
+
+/**
+ * @brief  Nombre d'échantillons enregistrés.
+ * @return Échantillons disponibles.
+ */
+uint16_t imu_hist_count(void){
+    return hist_count;
+}
+
+/**
+ * @brief  Rang de l'échantillon de déclenchement.
+ * @return Rang depuis le plus ancien échantillon, 0 si non déclenché.
+ */
+uint16_t imu_hist_trigger_index(void){
+    if(hist_source == IMU_HIST_TRIG_NONE){
+        return 0;
+    }
+    return (uint16_t)(hist_trig_pos - (hist_head - hist_count));
+}
+
+/**
+ * @brief  Émet un bloc de l'historique figé.
+ * @param  index Numéro du bloc.
+ * @return Octets mis en file ou -EWOULDBLOCK.
+ */
+int imu_hist_send_chunk(uint16_t index){
+    static uint8_t frame[IMU_HIST_FRAME_LEN(IMU_HIST_CHUNK)];
+    const uint16_t total = (hist_state == IMU_HIST_FROZEN) ? hist_count : 0u;
+    const uint16_t trig  = (total != 0) ? imu_hist_trigger_index() : 0u;
+    const uint32_t first = (uint32_t)index * IMU_HIST_CHUNK;
+    uint8_t count = 0;
+
+    if(first < total){
+        count = (total - first > IMU_HIST_CHUNK) ? (uint8_t)IMU_HIST_CHUNK : (uint8_t)(total - first);
+    }
+
+    const uint16_t len    = (uint16_t)IMU_HIST_FRAME_LEN(count);
+    const uint32_t oldest = hist_head - hist_count;
+
+    frame[0]  = 0xAA;
+    frame[1]  = 0x55;
+    frame[2]  = IMU_HIST_FRAME_TYPE;
+    frame[3]  = (uint8_t)(len - 5u);
+    memcpy(&frame[4], &index, sizeof(index));
+    memcpy(&frame[6], &total, sizeof(total));
+    memcpy(&frame[8], &trig, sizeof(trig));
+    frame[10] = hist_ranges;
+    frame[11] = count;
+    for(uint8_t i = 0; i < count; i++){
+        memcpy(&frame[12u + sizeof(imu_hist_sample_t) * i],
+               &hist_ring[(oldest + first + i) & (IMU_HIST_LEN - 1u)], sizeof(imu_hist_sample_t));
+    }
+    frame[len - 1u] = serial_crc8_atm(frame, (uint16_t)(len - 1u));
+
+    return serial_write_ctrl_nb(frame, len);
+}
+
+#if IMU_HIST_PACK
+
+/** @brief Canaux d'un échantillon compressé : date puis six axes. */
+#define IMU_HIST_PACK_CH        7u
+/** @brief Octets avant le flux Rice (entête 4 + FIRST..COUNT 8 + K 7 + T_US 4 + axes 12). */
+#define IMU_HIST_PACK_HEAD      (4u + 8u + IMU_HIST_PACK_CH + 4u + 12u)
+/** @brief Flux Rice au plus (payload limité à 255 octets). */
+#define IMU_HIST_PACK_STREAM    (255u - (IMU_HIST_PACK_HEAD - 4u))
+/** @brief Marge d'écriture d'un échantillon entier au-delà du flux utile (annulé ensuite). */
+#define IMU_HIST_PACK_SLACK     ((IMU_HIST_PACK_CH * RICE_MAX_BITS + 7u) / 8u)
+
+/**
+ * @brief  Résidus repliés d'un échantillon par rapport au précédent.
+ * @param  cur     Échantillon.
+ * @param  prev    Échantillon précédent.
+ * @param  dt_prev Entrée : intervalle précédent (µs) ; sortie : intervalle courant.
+ * @param  v       Sortie : IMU_HIST_PACK_CH valeurs repliées.
+ */
+static void imu_hist_residuals(const imu_hist_sample_t *cur, const imu_hist_sample_t *prev,
+                               uint32_t *dt_prev, uint32_t *v){
+    const uint32_t dt = cur->t_us - prev->t_us;
+
+    v[0] = rice_zigzag((int32_t)(dt - *dt_prev));
+    *dt_prev = dt;
+    for(uint8_t a = 0; a < 3u; a++){
+        v[1u + a] = rice_zigzag((int32_t)cur->raw.accel[a] - prev->raw.accel[a]);
+        v[4u + a] = rice_zigzag((int32_t)cur->raw.gyro[a] - prev->raw.gyro[a]);
+    }
+}
+
+/**
+ * @brief  Émet des échantillons de l'historique figé sous forme compressée.
+ * @details Première passe sur la fenêtre (au plus IMU_HIST_PACK_MAX échantillons) pour
+ * choisir k par canal, seconde passe d'encodage arrêtée au premier échantillon qui
+ * ne tient plus dans le flux.
+ * @param  first Rang du premier échantillon.
+ * @return Octets mis en file ou -EWOULDBLOCK.
+ */
+int imu_hist_send_packed(uint16_t first){
+    static uint8_t frame[IMU_HIST_PACK_HEAD + IMU_HIST_PACK_STREAM + IMU_HIST_PACK_SLACK + 1u];
+    const uint16_t total = (hist_state == IMU_HIST_FROZEN) ? hist_count : 0u;
+    const uint16_t trig  = (total != 0) ? imu_hist_trigger_index() : 0u;
+    const uint32_t base  = hist_head - hist_count + first;
+    uint32_t window = 0;
+    uint8_t k[IMU_HIST_PACK_CH] = {0};
+    uint8_t count = 0;
+    rice_writer_t w;
+
+    if(first < total){
+        window = (uint32_t)(total - first);
+        if(window > IMU_HIST_PACK_MAX){
+            window = IMU_HIST_PACK_MAX;
+        }
+    }
+
+    frame[0]  = 0xAA;
+    frame[1]  = 0x55;
+    frame[2]  = IMU_HIST_PACK_TYPE;
+    memcpy(&frame[4], &first, sizeof(first));
+    memcpy(&frame[6], &total, sizeof(total));
+    memcpy(&frame[8], &trig, sizeof(trig));
+    frame[10] = hist_ranges;
+    memset(&frame[19], 0, 16u);
+    rice_begin(&w, &frame[IMU_HIST_PACK_HEAD]);
+
+    if(window != 0){
+        const imu_hist_sample_t *s0 = &hist_ring[base & (IMU_HIST_LEN - 1u)];
+        uint32_t sum[IMU_HIST_PACK_CH] = {0};
+        uint32_t v[IMU_HIST_PACK_CH];
+        uint32_t dt_prev = 0;
+
+        for(uint32_t i = 1; i < window; i++){
+            imu_hist_residuals(&hist_ring[(base + i) & (IMU_HIST_LEN - 1u)],
+                               &hist_ring[(base + i - 1u) & (IMU_HIST_LEN - 1u)], &dt_prev, v);
+            for(uint8_t c = 0; c < IMU_HIST_PACK_CH; c++){
+                sum[c] += (v[c] > 0xFFFFu) ? 0xFFFFu : v[c];
+            }
+        }
+        for(uint8_t c = 0; c < IMU_HIST_PACK_CH; c++){
+            k[c] = (window > 1u) ? rice_choose_k(sum[c], window - 1u) : 0u;
+        }
+
+        memcpy(&frame[19], &s0->t_us, sizeof(s0->t_us));
+        memcpy(&frame[23], &s0->raw, sizeof(s0->raw));
+        count   = 1;
+        dt_prev = 0;
+        for(uint32_t i = 1; i < window; i++){
+            const uint32_t mark = rice_bits(&w);
+
+            imu_hist_residuals(&hist_ring[(base + i) & (IMU_HIST_LEN - 1u)],
+                               &hist_ring[(base + i - 1u) & (IMU_HIST_LEN - 1u)], &dt_prev, v);
+            for(uint8_t c = 0; c < IMU_HIST_PACK_CH; c++){
+                rice_put(&w, v[c], k[c]);
+            }
+            if(rice_bits(&w) > IMU_HIST_PACK_STREAM * 8u){
+                rice_rewind(&w, mark);
+                break;
+            }
+            count++;
+        }
+    }
+
+    frame[11] = count;
+    memcpy(&frame[12], k, sizeof(k));
+    const uint16_t len = (uint16_t)(IMU_HIST_PACK_HEAD + rice_end(&w) + 1u);
+    frame[3] = (uint8_t)(len - 5u);
+    frame[len - 1u] = serial_crc8_atm(frame, (uint16_t)(len - 1u));
+
+    return serial_write_ctrl_nb(frame, len);
+}
+
+#else
+
+/**
+ * @brief  Compression absente : émet le bloc brut qui contient `first`.
+ * @param  first Rang du premier échantillon.
+ * @return Octets mis en file ou -EWOULDBLOCK.
+ */
+int imu_hist_send_packed(uint16_t first){
+    return imu_hist_send_chunk((uint16_t)(first / IMU_HIST_CHUNK));
+}
+
+#endif /* IMU_HIST_PACK */
+
+#endif /* IMU_HIST_ENABLE */
@@ -0,0 +1,33 @@
+/**
+ * @file    irq_prio.c
+ * @brief   Application de la carte des priorités NVIC (cf. irq_prio.h).
+ */
+
+#include "main.h"
+#include "irq_prio.h"
+
+#if (IRQ_PRIO_TIMEBASE > 3u) || (IRQ_PRIO_MOTOR > 3u) || (IRQ_PRIO_IMU > 3u) || (IRQ_PRIO_UART > 3u)
+#error "Cortex-M0+ NVIC priorities range from 0 to 3"
+#endif
+
+/**
+ * @brief  Applique la carte des priorités NVIC.
+ * @details uwTickPrio est mis à jour pour qu'une reconfiguration ultérieure du tick
+ * par la HAL (HAL_InitTick) conserve le niveau choisi.
+ */
+void irq_prio_apply(void){
+    NVIC_SetPriority(TIM3_TIM4_IRQn, IRQ_PRIO_TIMEBASE);
+
+    NVIC_SetPriority(SysTick_IRQn, IRQ_PRIO_MOTOR);
+    uwTickPrio = IRQ_PRIO_MOTOR;
+    NVIC_SetPriority(PendSV_IRQn, IRQ_PRIO_MOTOR);
+
+    NVIC_SetPriority(EXTI0_1_IRQn, IRQ_PRIO_IMU);
+    NVIC_SetPriority(EXTI2_3_IRQn, IRQ_PRIO_IMU);
+    NVIC_SetPriority(SPI1_IRQn, IRQ_PRIO_IMU);
+    NVIC_SetPriority(DMA1_Ch4_7_DMA2_Ch1_5_DMAMUX1_OVR_IRQn, IRQ_PRIO_IMU);
+    NVIC_SetPriority(DMA1_Channel2_3_IRQn, IRQ_PRIO_IMU);
+
+    NVIC_SetPriority(USART2_LPUART2_IRQn, IRQ_PRIO_UART);
+    NVIC_SetPriority(DMA1_Channel1_IRQn, IRQ_PRIO_UART);
+}
@@ -0,0 +1,82 @@
+/**
+ * @file    jitter.c
+ * @brief   Implémentation du banc de mesure de latence d'interruption et de gigue.
+ * @details La charge RX est produite par l'hôte (inondation de requêtes de lecture,
+ * qui génèrent aussi des réponses) ; la charge TX est générée ici en remplissant le
+ * ring d'émission d'octets nuls, ignorés par le décodeur de l'hôte.
+ */
+
+#include "main.h"
+#include "jitter.h"
+#include "profiler.h"
+#include "serial.h"
+#include <string.h>
+
+/** @brief Taille d'un bloc de remplissage pour la charge TX. */
+#define JITTER_TX_FILL_LEN  64u
+
+/** @brief Modes actifs (JITTER_MODE_*). */
+static volatile uint8_t jitter_mode = 0;
+
+/**
+ * @brief  Active ou désactive les modes du banc de mesure.
+ * @param  mode Combinaison de JITTER_MODE_*.
+ */
+void jitter_set_mode(uint8_t mode){
+    mode &= JITTER_MODE_MASK;
+
+    if((mode & JITTER_MODE_ISR_PROBE) && !(jitter_mode & JITTER_MODE_ISR_PROBE)){
+        prof_reset(prof_probe(PROF_PROBE_TIM3_LATENCY));
+        LL_TIM_OC_SetCompareCH2(TIM3, (uint16_t)(LL_TIM_GetCounter(TIM3) + JITTER_PROBE_PERIOD));
+        LL_TIM_ClearFlag_CC2(TIM3);
+        LL_TIM_EnableIT_CC2(TIM3);
+    }
+    else if(!(mode & JITTER_MODE_ISR_PROBE)){
+        LL_TIM_DisableIT_CC2(TIM3);
+        LL_TIM_ClearFlag_CC2(TIM3);
+    }
+
+    jitter_mode = mode;
+}
+
+/**
+ * @brief  Modes actifs.
+ * @return Combinaison de JITTER_MODE_*.
+ */
+uint8_t jitter_get_mode(void){
+    return jitter_mode;
+}
+
+/**
+ * @brief  Traitement du compare CH2 de TIM3 (contexte interruption).
+ * @details Latence = compteur à l'entrée - valeur de compare (modulo 2^16), puis
+ * réarmement une période plus loin, calé sur la compare précédente.
+ */
+void jitter_tim3_irq(void){
+    if(!LL_TIM_IsEnabledIT_CC2(TIM3) || !LL_TIM_IsActiveFlag_CC2(TIM3)){
+        return;
+    }
+
+    uint16_t now = (uint16_t)LL_TIM_GetCounter(TIM3);
+    uint16_t ccr = (uint16_t)LL_TIM_OC_GetCompareCH2(TIM3);
+    LL_TIM_ClearFlag_CC2(TIM3);
+
+    prof_record(prof_probe(PROF_PROBE_TIM3_LATENCY), (uint16_t)(now - ccr));
+    LL_TIM_OC_SetCompareCH2(TIM3, (uint16_t)(ccr + JITTER_PROBE_PERIOD));
+}
+
+/**
+ * @brief  Traitement de fond : charge TX si demandée.
+ * @details Écritures partielles non bloquantes : le ring reste plein sans incrémenter
+ * le compteur de trames refusées des autres émetteurs.
+ */
+void jitter_poll(void){
+    static const uint8_t fill[JITTER_TX_FILL_LEN] = {0};
+
+    if(!(jitter_mode & JITTER_MODE_TX_STRESS)){
+        return;
+    }
+
+    while(serial_write_nb(fill, sizeof(fill)) == (int)sizeof(fill)){
+    }
+}
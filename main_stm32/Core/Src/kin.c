@@ -0,0 +1,108 @@
+/**
+ * @file    kin.c
+ * @brief   Implémentation de la commande cinématique (cf. kin.h).
+ * @details Le braquage est calculé dans le repère de la courbure (positif à gauche),
+ * puis ramené au repère servo par KIN_STEER_SIGN. Les produits de la boucle de lacet
+ * passent par des intermédiaires 64 bits.
+ */
+
+#include "kin.h"
+
+/** @brief Valeur unité de L·κ (Q12). */
+#define KIN_ONE_Q12             4096
+/** @brief Borne de l'écart de cap cumulé (µrad) : intégrale saturée à la correction maximale. */
+#if KIN_YAW_KI != 0
+#define KIN_INTEG_MAX_URAD      ((int32_t)(((int64_t)KIN_YAW_TRIM_MAX_CDEG * 1000000) / KIN_YAW_KI))
+#else
+#define KIN_INTEG_MAX_URAD      0
+#endif
+
+/** @brief Borne une valeur à [-lim, lim]. */
+static inline int32_t kin_clamp(int32_t v, int32_t lim){
+    return (v > lim) ? lim : (v < -lim) ? -lim : v;
+}
+
+/**
+ * @brief  Initialise la commande cinématique (inactive).
+ * @param  kin Pointeur vers l'état.
+ */
+void kin_init(Kin_t *kin){
+    kin->active = false;
+    kin->curv_pkm = 0;
+    kin->ff_cdeg = 0;
+    kin->integ_urad = 0;
+    kin->out_cdeg = 0;
+    kin->last_us = 0;
+}
+
+/**
+ * @brief  Angle de braquage du modèle bicyclette pour une courbure.
+ * @details L·κ = L(mm)·κ(km⁻¹)·10⁻⁶, soit en Q12 L·κ·64 / 15625 (exact).
+ * @param  curv_pkm Courbure (km⁻¹).
+ * @return Angle (c°).
+ */
+int32_t kin_curv_to_cdeg(int32_t curv_pkm){
+    const int32_t x   = kin_clamp((int32_t)KIN_WHEELBASE_MM * curv_pkm * 64 / 15625, KIN_ONE_Q12);
+    const int32_t ax  = (x < 0) ? -x : x;
+    /* 4500 c° = pi/4 ; 1564 c° = 0,273 rad */
+    const int32_t k   = 4500 + (1564 * (KIN_ONE_Q12 - ax)) / KIN_ONE_Q12;
+
+    return (x * k) / KIN_ONE_Q12;
+}
+
+/**
+ * @brief  Braquage servo : modèle bicyclette et correction de lacet.
+ * @param  kin     Pointeur vers l'état.
+ * @param  p_cdeg  Terme proportionnel (c°, repère courbure).
+ * @return Braquage servo (c°).
+ */
+static int32_t kin_output(const Kin_t *kin, int32_t p_cdeg){
+    const int32_t i_cdeg = (int32_t)(((int64_t)kin->integ_urad * KIN_YAW_KI) / 1000000);
+    const int32_t trim   = kin_clamp(p_cdeg + i_cdeg, KIN_YAW_TRIM_MAX_CDEG);
+
+    return KIN_STEER_SIGN * (kin->ff_cdeg + trim);
+}
+
+int32_t kin_command(Kin_t *kin, int16_t curv_pkm){
+    kin->active   = true;
+    kin->curv_pkm = curv_pkm;
+    kin->ff_cdeg  = kin_curv_to_cdeg(curv_pkm);
+    kin->out_cdeg = kin_output(kin, 0);
+    return kin->out_cdeg;
+}
+
+void kin_stop(Kin_t *kin){
+    kin->active = false;
+    kin->integ_urad = 0;
+    kin->last_us = 0;
+}
+
+bool kin_update(Kin_t *kin, int32_t gyro_z_urads, int32_t speed_mms, uint64_t timestamp_us, int32_t *cdeg){
+    if(!kin->active || !KIN_YAW_LOOP){
+        return false;
+    }
+
+    const uint64_t dt_us = (kin->last_us != 0) ? (timestamp_us - kin->last_us) : 0u;
+    kin->last_us = timestamp_us;
+
+    int32_t p_cdeg = 0;
+    if(speed_mms >= KIN_YAW_MIN_SPEED_MMS || speed_mms <= -KIN_YAW_MIN_SPEED_MMS){
+        /* mm/s x km⁻¹ = µrad/s : vitesse de lacet attendue, dans l'unité du gyroscope */
+        const int64_t err_urads = (int64_t)speed_mms * kin->curv_pkm - (int64_t)KIN_YAW_SIGN * gyro_z_urads;
+
+        p_cdeg = (int32_t)((err_urads * KIN_YAW_KP) / 1000000);
+        if(dt_us != 0u && dt_us <= KIN_DT_MAX_US){
+            const int64_t integ = kin->integ_urad + (err_urads * (int64_t)dt_us) / 1000000;
+            kin->integ_urad = (integ > KIN_INTEG_MAX_URAD) ? KIN_INTEG_MAX_URAD :
+                              (integ < -KIN_INTEG_MAX_URAD) ? -KIN_INTEG_MAX_URAD : (int32_t)integ;
+        }
+    }
+
+    const int32_t out = kin_output(kin, p_cdeg);
+    if(out == kin->out_cdeg){
+        return false;
+    }
+    kin->out_cdeg = out;
+    *cdeg = out;
+    return true;
+}
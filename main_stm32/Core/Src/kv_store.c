@@ -0,0 +1,255 @@
+/**
+ * @file    kv_store.c
+ * @brief   Implémentation du magasin clé-valeur persistant.
+ * @details Une page commence par un entête de 8 octets (magique, génération, CRC-8)
+ * suivi d'enregistrements de 8 octets. La page active est celle dont l'entête est
+ * valide et la génération la plus récente. Un enregistrement au CRC invalide (coupure
+ * pendant la programmation) est ignoré ; l'écriture suivante se place après lui.
+ */
+
+#include "main.h"
+#include "kv_store.h"
+#include "nv_flash.h"
+#include "crc8.h"
+#include <errno.h>
+#include <stddef.h>
+#include <string.h>
+
+/** @brief Magique d'entête de page ("KVS1" en petit-boutiste). */
+#define KV_PAGE_MAGIC           0x3153564Bu
+/** @brief Marqueur d'un enregistrement programmé (une zone effacée se lit à 0xFF). */
+#define KV_REC_TAG              0xA5u
+
+/**
+ * @brief Entête de page (un double mot).
+ */
+typedef struct{
+    uint32_t magic;         ///< KV_PAGE_MAGIC.
+    uint16_t gen;           ///< Génération, incrémentée à chaque recopie.
+    uint8_t  rsv;           ///< Réservé (0xFF).
+    uint8_t  crc;           ///< CRC-8 des octets précédents.
+} kv_page_hdr_t;
+
+/**
+ * @brief Enregistrement d'une valeur (un double mot).
+ */
+typedef struct{
+    uint8_t  key;           ///< Clé (< KV_KEY_COUNT).
+    uint8_t  tag;           ///< KV_REC_TAG.
+    int16_t  value;         ///< Valeur.
+    uint8_t  crc;           ///< CRC-8 des octets précédents.
+    uint8_t  pad[3];        ///< Bourrage (0xFF).
+} kv_record_t;
+
+/** @brief Page active (0 : magasin vide). */
+static uint32_t kv_page = 0;
+/** @brief 1 si la page active ne reflète plus le cache (échec flash) : recopie à la prochaine écriture. */
+static uint8_t kv_stale = 0;
+/** @brief Adresse du prochain enregistrement libre de la page active. */
+static uint32_t kv_next = 0;
+/** @brief Génération de la page active. */
+static uint16_t kv_gen = 0;
+/** @brief Dernière valeur de chaque clé. */
+static int16_t kv_val[KV_KEY_COUNT];
+/** @brief Présence de chaque clé (un bit par clé). */
+static uint8_t kv_have[KV_KEY_COUNT / 8u];
+
+/** @brief Indique si une clé a une valeur. */
+static inline uint8_t kv_has(uint8_t key){
+    return (kv_have[key >> 3] >> (key & 7u)) & 1u;
+}
+
+/** @brief Vérifie l'entête d'une page. */
+static uint8_t kv_hdr_valid(const kv_page_hdr_t *hdr){
+    return (hdr->magic == KV_PAGE_MAGIC &&
+            hdr->crc == crc8_compute((const uint8_t *)hdr, offsetof(kv_page_hdr_t, crc))) ? 1u : 0u;
+}
+
+/** @brief Vérifie un enregistrement. */
+static uint8_t kv_rec_valid(const kv_record_t *rec){
+    return (rec->tag == KV_REC_TAG && rec->key < KV_KEY_COUNT &&
+            rec->crc == crc8_compute((const uint8_t *)rec, offsetof(kv_record_t, crc))) ? 1u : 0u;
+}
+
+/** @brief Programme un enregistrement à l'adresse donnée. */
+static int8_t kv_write_record(uint32_t addr, uint8_t key, int16_t value){
+    kv_record_t rec;
+
+    memset(&rec, 0xFF, sizeof(rec));
+    rec.key   = key;
+    rec.tag   = KV_REC_TAG;
+    rec.value = value;
+    rec.crc   = crc8_compute((const uint8_t *)&rec, offsetof(kv_record_t, crc));
+
+    return nv_flash_program(addr, &rec, sizeof(rec));
+}
+
+/**
+ * @brief  Recopie les valeurs courantes dans l'autre page, puis l'active.
+ * @details L'entête est programmé en dernier : tant qu'il ne l'est pas, l'ancienne
+ * page reste la page active au démarrage suivant.
+ * @return 0 si succès, -EIO sinon (l'ancienne page reste active, la recopie sera retentée).
+ */
+static int8_t kv_compact(void){
+    const uint32_t dst = (kv_page == NV_FLASH_KV_START) ? NV_FLASH_KV_START + FLASH_PAGE_SIZE : NV_FLASH_KV_START;
+    kv_page_hdr_t hdr = { .magic = KV_PAGE_MAGIC, .gen = (uint16_t)(kv_gen + 1u), .rsv = 0xFFu };
+    uint32_t a = dst + sizeof(kv_page_hdr_t);
+    int8_t err;
+
+    kv_stale = 1;
+
+    err = nv_flash_erase_page(dst);
+    for(uint8_t k = 0; k < KV_KEY_COUNT && err == 0; k++){
+        if(kv_has(k)){
+            err = kv_write_record(a, k, kv_val[k]);
+            a += sizeof(kv_record_t);
+        }
+    }
+
+    if(err == 0){
+        hdr.crc = crc8_compute((const uint8_t *)&hdr, offsetof(kv_page_hdr_t, crc));
+        err = nv_flash_program(dst, &hdr, sizeof(hdr));
+    }
+    if(err != 0){
+        return -EIO;
+    }
+
+    kv_page  = dst;
+    kv_next  = a;
+    kv_gen   = hdr.gen;
+    kv_stale = 0;
+
+    return 0;
+}
+
+/**
+ * @brief  Charge la page active et les dernières valeurs de chaque clé.
+ * @note   À appeler une fois au démarrage, avant kv_get().
+ */
+void kv_init(void){
+    memset(kv_have, 0, sizeof(kv_have));
+    kv_page  = 0;
+    kv_gen   = 0;
+    kv_stale = 0;
+
+    for(uint32_t p = NV_FLASH_KV_START; p + FLASH_PAGE_SIZE <= NV_FLASH_KV_END; p += FLASH_PAGE_SIZE){
+        const kv_page_hdr_t *hdr = (const kv_page_hdr_t *)p;
+
+        if(kv_hdr_valid(hdr) && (kv_page == 0 || (int16_t)(hdr->gen - kv_gen) > 0)){
+            kv_page = p;
+            kv_gen  = hdr->gen;
+        }
+    }
+
+    if(kv_page == 0){
+        return;
+    }
+
+    kv_next = kv_page + sizeof(kv_page_hdr_t);
+    for(uint32_t a = kv_next; a + sizeof(kv_record_t) <= kv_page + FLASH_PAGE_SIZE; a += sizeof(kv_record_t)){
+        const kv_record_t *rec = (const kv_record_t *)a;
+
+        if(nv_flash_is_blank(a, sizeof(kv_record_t))){
+            continue;
+        }
+
+        kv_next = a + sizeof(kv_record_t);
+        if(kv_rec_valid(rec)){
+            kv_val[rec->key] = rec->value;
+            kv_have[rec->key >> 3] |= (uint8_t)(1u << (rec->key & 7u));
+        }
+    }
+}
+
+/**
+ * @brief  Lit la dernière valeur enregistrée d'une clé.
+ * @param  key   Clé (< KV_KEY_COUNT).
+ * @param  value Valeur de sortie.
+ * @return 1 si la clé est présente, 0 sinon.
+ */
+uint8_t kv_get(uint8_t key, int16_t *value){
+    if(key >= KV_KEY_COUNT || value == NULL || !kv_has(key)){
+        return 0;
+    }
+
+    *value = kv_val[key];
+    return 1;
+}
+
+/**
+ * @brief  Enregistre une valeur (sans écriture flash si elle est inchangée).
+ * @details Page pleine, magasin vide ou échec précédent : la valeur est placée dans
+ * le cache puis la recopie l'écrit avec toutes les autres.
+ * @param  key   Clé (< KV_KEY_COUNT).
+ * @param  value Valeur à enregistrer.
+ * @return 0 si succès, -EINVAL si la clé est hors plage, -EIO en cas d'échec flash.
+ */
+int8_t kv_set(uint8_t key, int16_t value){
+    if(key >= KV_KEY_COUNT){
+        return -EINVAL;
+    }
+
+    if(kv_page != 0 && !kv_stale && kv_has(key) && kv_val[key] == value){
+        return 0;
+    }
+
+    kv_val[key] = value;
+    kv_have[key >> 3] |= (uint8_t)(1u << (key & 7u));
+
+    if(kv_page == 0 || kv_stale || kv_next + sizeof(kv_record_t) > kv_page + FLASH_PAGE_SIZE){
+        return kv_compact();
+    }
+
+    const int8_t err = kv_write_record(kv_next, key, value);
+
+    kv_next += sizeof(kv_record_t);
+    if(err != 0){
+        kv_stale = 1;
+        return -EIO;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief  Efface les deux pages : toutes les clés disparaissent.
+ * @return 0 si succès, -EIO en cas d'échec flash.
+ */
+int8_t kv_clear(void){
+    int8_t err = 0;
+
+    for(uint32_t p = NV_FLASH_KV_START; p + FLASH_PAGE_SIZE <= NV_FLASH_KV_END; p += FLASH_PAGE_SIZE){
+        if(!nv_flash_is_blank(p, FLASH_PAGE_SIZE) && nv_flash_erase_page(p) != 0){
+            err = -EIO;
+        }
+    }
+
+    memset(kv_have, 0, sizeof(kv_have));
+    kv_page  = 0;
+    kv_gen   = 0;
+    kv_stale = 0;
+
+    return err;
+}
+
+/**
+ * @brief  Nombre de clés présentes.
+ * @return Nombre de clés ayant une valeur enregistrée.
+ */
+uint8_t kv_count(void){
+    uint8_t n = 0;
+
+    for(uint8_t k = 0; k < KV_KEY_COUNT; k++){
+        n += kv_has(k);
+    }
+
+    return n;
+}
+
+/**
+ * @brief  Génération de la page active (nombre de recopies depuis le premier effacement).
+ * @return Génération, 0 si le magasin est vide.
+ */
+uint16_t kv_generation(void){
+    return kv_gen;
+}
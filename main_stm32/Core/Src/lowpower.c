@@ -0,0 +1,159 @@
+/**
+ * @file    lowpower.c
+ * @brief   Implémentation de la veille STOP1 (cf. lowpower.h).
+ * @details Accès direct aux registres LPTIM1 et EXTI (modules HAL LPTIM / RTC non
+ * générés par CubeMX). LPTIM1 compte le LSI en continu (ARR = 0xFFFF) ; son compare
+ * est reprogrammé à chaque réveil pour l'échéance suivante du chien de garde. Le
+ * réveil passe par WFE avec SEVONPEND : les lignes LPTIM1 et EXTI RX réveillent le
+ * cœur sans que leur vecteur soit activé au NVIC.
+ */
+
+#include "main.h"
+#include "lowpower.h"
+#include "timebase.h"
+#include "watchdog.h"
+#include "driver_ins.h"
+
+/** @brief Ligne EXTI de la broche RX (numéro de broche). */
+#define LP_UART_LINE        3u
+_Static_assert((1u << LP_UART_LINE) == USART2_RX_Pin, "LP_UART_LINE must match USART2_RX_Pin");
+
+/** @brief Ticks LPTIM1 (LSI) entre deux rafraîchissements du chien de garde. */
+#define LP_FEED_TICKS       ((uint16_t)((LSI_VALUE * LP_FEED_MS) / 1000u))
+
+/** @brief Configuration d'horloge CubeMX (main.c), à réappliquer en sortie de STOP. */
+void SystemClock_Config(void);
+
+/**
+ * @brief  Lit le compteur LPTIM1 (domaine asynchrone : deux lectures identiques).
+ * @return Compteur (ticks LSI).
+ */
+static uint16_t lp_cnt(void){
+    uint32_t a, b;
+
+    do{
+        a = LPTIM1->CNT;
+        b = LPTIM1->CNT;
+    }while(a != b);
+
+    return (uint16_t)a;
+}
+
+/**
+ * @brief  Programme le compare LPTIM1 et attend sa prise en compte.
+ * @param  cmp Valeur de compare (ticks LSI).
+ */
+static void lp_set_cmp(uint16_t cmp){
+    LPTIM1->ICR = LPTIM_ICR_CMPOKCF;
+    LPTIM1->CMP = cmp;
+    while(!(LPTIM1->ISR & LPTIM_ISR_CMPOK)){}
+    LPTIM1->ICR = LPTIM_ICR_CMPOKCF | LPTIM_ICR_CMPMCF;
+}
+
+/**
+ * @brief  Démarre LPTIM1 sur le LSI, en comptage continu.
+ */
+static void lp_timer_start(void){
+    RCC->CSR |= RCC_CSR_LSION;
+    while(!(RCC->CSR & RCC_CSR_LSIRDY)){}
+
+    RCC->CCIPR = (RCC->CCIPR & ~RCC_CCIPR_LPTIM1SEL) | RCC_CCIPR_LPTIM1SEL_0;
+    RCC->APBENR1 |= RCC_APBENR1_LPTIM1EN;
+
+    LPTIM1->CR   = 0;
+    LPTIM1->CFGR = 0;
+    LPTIM1->IER  = LPTIM_IER_CMPMIE;
+    LPTIM1->CR   = LPTIM_CR_ENABLE;
+
+    LPTIM1->ICR = LPTIM_ICR_ARROKCF;
+    LPTIM1->ARR = 0xFFFFu;
+    while(!(LPTIM1->ISR & LPTIM_ISR_ARROK)){}
+    LPTIM1->ICR = LPTIM_ICR_ARROKCF;
+
+    LPTIM1->CR |= LPTIM_CR_CNTSTRT;
+    EXTI->IMR1 |= EXTI_IMR1_IM29;
+}
+
+/**
+ * @brief  Arrête LPTIM1.
+ */
+static void lp_timer_stop(void){
+    LPTIM1->CR = 0;
+    RCC->APBENR1 &= ~RCC_APBENR1_LPTIM1EN;
+    NVIC_ClearPendingIRQ(TIM6_DAC_LPTIM1_IRQn);
+}
+
+/**
+ * @brief  Arme (ou désarme) le réveil sur front descendant de la ligne RX.
+ * @details La broche reste en fonction alternée USART : l'EXTI lit son entrée.
+ * @param  on 1 pour armer, 0 pour désarmer et effacer le front mémorisé.
+ */
+static void lp_uart_wake(uint8_t on){
+    const uint32_t mask  = 1u << LP_UART_LINE;
+    const uint32_t shift = (LP_UART_LINE & 3u) * 8u;
+
+    if(on){
+        EXTI->EXTICR[LP_UART_LINE >> 2] = (EXTI->EXTICR[LP_UART_LINE >> 2] & ~(0xFFu << shift)) |
+                                          (GPIO_GET_INDEX(USART2_RX_GPIO_Port) << shift);
+        EXTI->FPR1   = mask;
+        EXTI->FTSR1 |= mask;
+        EXTI->IMR1  |= mask;
+    }
+    else{
+        EXTI->IMR1  &= ~mask;
+        EXTI->FTSR1 &= ~mask;
+        EXTI->FPR1   = mask;
+        NVIC_ClearPendingIRQ(EXTI2_3_IRQn);
+    }
+}
+
+uint8_t lp_stop(uint32_t *slept_ms){
+    const uint32_t primask = __get_PRIMASK();
+    uint64_t slept_ticks = 0;
+    uint8_t cause = 0;
+
+    __disable_irq();
+    HAL_SuspendTick();
+    lp_uart_wake(1);
+    lp_timer_start();
+    SCB->SCR |= SCB_SCR_SEVONPEND_Msk;
+
+    uint16_t last = lp_cnt();
+
+    while(cause == 0){
+        watchdog_feed();
+        lp_set_cmp((uint16_t)(last + LP_FEED_TICKS));
+        NVIC_ClearPendingIRQ(TIM6_DAC_LPTIM1_IRQn);
+
+        HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFE);
+
+        const uint16_t now = lp_cnt();
+        slept_ticks += (uint16_t)(now - last);
+        last = now;
+
+        if(EXTI->FPR1 & (1u << LP_UART_LINE)){
+            cause = LP_WAKE_UART;
+        }
+        else if(EXTI->RPR1 & BMI088_INT_ACC_Pin){
+            cause = LP_WAKE_MOTION;     // Compté par le callback EXTI au démasquage
+        }
+    }
+
+    /* Sortie de STOP sur HSI16 : PLL et horloges bus à rétablir avant tout le reste */
+    SystemClock_Config();
+    SCB->SCR &= ~SCB_SCR_SEVONPEND_Msk;
+    lp_timer_stop();
+    lp_uart_wake(0);
+
+    const uint64_t us = (slept_ticks * 1000000u) / LSI_VALUE;
+    Timebase_Advance(us);
+    uwTick += (uint32_t)(us / 1000u);
+    HAL_ResumeTick();
+
+    __set_PRIMASK(primask);
+
+    if(slept_ms != NULL){
+        *slept_ms = (uint32_t)(us / 1000u);
+    }
+    return cause;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file    mem_map.c
+ * @brief   Implémentation du bilan RAM : tailles de sections et peinture de pile.
+ * @details Les bornes viennent des symboles des scripts de liens ; la valeur des
+ * symboles de taille (_Min_Heap_Size, _Min_Stack_Size) est leur adresse.
+ */
+
+#include "main.h"
+#include "mem_map.h"
+
+extern uint32_t _sdata, _edata, _sidata, _sbss, _ebss, _estack, end;
+extern uint8_t _sdma_buffer, _edma_buffer, _shot_state, _ehot_state, _sramfunc, _eramfunc;
+extern uint8_t _snoinit, _enoinit;
+extern uint8_t _Min_Heap_Size, _Min_Stack_Size;
+
+/** @brief Octets laissés intacts sous le pointeur de pile au moment de la peinture. */
+#define MEM_STACK_PAINT_MARGIN  32u
+
+/** @brief Premier mot de la fenêtre peinte (NULL tant que mem_stack_paint() n'a pas tourné). */
+static uint32_t *paint_bottom = NULL;
+/** @brief Ticks SysTick écoulés depuis le reset à chaque instant daté. */
+static uint32_t boot_ticks[MEM_BOOT_COUNT];
+
+/**
+ * @brief  Peint la fenêtre de pile libre avec MEM_STACK_PAINT_WORD.
+ * @details La fenêtre part de MEM_STACK_PAINT_BYTES sous _estack, sans descendre
+ * sous la fin du tas réservé, et s'arrête MEM_STACK_PAINT_MARGIN octets sous SP.
+ */
+void mem_stack_paint(void){
+    uintptr_t bottom = (uintptr_t)&_estack - MEM_STACK_PAINT_BYTES;
+    const uintptr_t heap_end = (uintptr_t)&end + (uintptr_t)&_Min_Heap_Size;
+
+    if(bottom < heap_end){
+        bottom = (heap_end + 3u) & ~(uintptr_t)3u;
+    }
+
+    uint32_t *p   = (uint32_t *)bottom;
+    uint32_t *top = (uint32_t *)((__get_MSP() - MEM_STACK_PAINT_MARGIN) & ~(uintptr_t)3u);
+
+    while(p < top){
+        *p++ = MEM_STACK_PAINT_WORD;
+    }
+
+    paint_bottom = (uint32_t *)bottom;
+}
+
+/**
+ * @brief  Profondeur maximale de pile atteinte depuis mem_stack_paint().
+ * @details Remonte la fenêtre depuis son bas jusqu'au premier mot repeint par la
+ * pile (au plus MEM_STACK_PAINT_BYTES / 4 lectures).
+ * @return Octets utilisés sous _estack.
+ */
+uint32_t mem_stack_peak(void){
+    if(paint_bottom == NULL){
+        return 0;
+    }
+
+    const uint32_t *p   = paint_bottom;
+    const uint32_t *top = &_estack;
+
+    while(p < top && *p == MEM_STACK_PAINT_WORD){
+        p++;
+    }
+
+    return (uint32_t)((uintptr_t)&_estack - (uintptr_t)p);
+}
+
+/**
+ * @brief  Taille d'une région mémoire.
+ * @param  region Région demandée.
+ * @return Taille en octets (0 si région inconnue).
+ */
+uint32_t mem_region_size(mem_region_t region){
+    switch(region){
+        case MEM_REGION_DMA:            return (uint32_t)(&_edma_buffer - &_sdma_buffer);
+        case MEM_REGION_HOT:            return (uint32_t)(&_ehot_state - &_shot_state);
+        case MEM_REGION_STATIC:         return (uint32_t)((uintptr_t)&_enoinit - (uintptr_t)&_sdata);
+        case MEM_REGION_RAMFUNC:        return (uint32_t)(&_eramfunc - &_sramfunc);
+        case MEM_REGION_HEAP_RESERVED:  return (uint32_t)(uintptr_t)&_Min_Heap_Size;
+        case MEM_REGION_STACK_RESERVED: return (uint32_t)(uintptr_t)&_Min_Stack_Size;
+        case MEM_REGION_FLASH_IMAGE:    return (uint32_t)((uintptr_t)&_sidata - FLASH_BASE) +
+                                               (uint32_t)((uintptr_t)&_edata - (uintptr_t)&_sdata);
+        case MEM_REGION_DATA:           return (uint32_t)((uintptr_t)&_edata - (uintptr_t)&_sdata);
+        case MEM_REGION_BSS:            return (uint32_t)((uintptr_t)&_ebss - (uintptr_t)&_sbss);
+        case MEM_REGION_NOINIT:         return (uint32_t)(&_enoinit - &_snoinit);
+        default:                        return 0;
+    }
+}
+
+/**
+ * @brief  Date un instant du démarrage.
+ * @details SysTick décompte depuis 0xFFFFFF (chargé par Reset_Handler) : écoulé =
+ * LOAD - VAL, sans rebouclage avant 1 s à 16 MHz.
+ * @param  point Instant.
+ */
+void mem_boot_stamp(mem_boot_point_t point){
+    if(point < MEM_BOOT_COUNT){
+        boot_ticks[point] = SysTick->LOAD - SysTick->VAL;
+    }
+}
+
+/**
+ * @brief  Date d'un instant du démarrage.
+ * @param  point Instant.
+ * @return Microsecondes depuis le reset.
+ */
+uint32_t mem_boot_us(mem_boot_point_t point){
+    return (point < MEM_BOOT_COUNT) ? boot_ticks[point] / (MEM_BOOT_CLK_HZ / 1000000u) : 0u;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file    nv_flash.c
+ * @brief   Implémentation de l'accès bas niveau aux pages de flash persistantes.
+ * @details Fine couche sur le HAL FLASH : déverrouillage le temps de l'opération,
+ * calcul de la banque et du numéro de page, effacement des drapeaux d'erreur.
+ */
+
+#include "main.h"
+#include "nv_flash.h"
+#include <errno.h>
+#include <string.h>
+
+/**
+ * @brief Numéro de la première page de la banque 2 dans FLASH_CR.PNB (RM0444).
+ * @note  Les pages de la banque 2 sont numérotées à partir de 256, quelle que soit
+ * la taille de la banque.
+ */
+#define NV_FLASH_BANK2_FIRST_PAGE   256u
+
+/**
+ * @brief  Efface une page de flash (bloquant, 22 ms typique, 40 ms au plus).
+ * @param  addr Adresse de début de page (alignée sur FLASH_PAGE_SIZE).
+ * @return 0 si succès, -EINVAL si l'adresse n'est pas un début de page, -EIO sinon.
+ */
+int8_t nv_flash_erase_page(uint32_t addr){
+    FLASH_EraseInitTypeDef erase = { .TypeErase = FLASH_TYPEERASE_PAGES, .NbPages = 1 };
+    uint32_t page_error = 0;
+
+    if(addr < FLASH_BASE || ((addr - FLASH_BASE) % FLASH_PAGE_SIZE) != 0u){
+        return -EINVAL;
+    }
+
+    const uint32_t offset = addr - FLASH_BASE;
+
+    if(offset < FLASH_BANK_SIZE){
+        erase.Banks = FLASH_BANK_1;
+        erase.Page  = offset / FLASH_PAGE_SIZE;
+    }
+    else{
+        erase.Banks = FLASH_BANK_2;
+        erase.Page  = NV_FLASH_BANK2_FIRST_PAGE + (offset - FLASH_BANK_SIZE) / FLASH_PAGE_SIZE;
+    }
+
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_SR_ERRORS);
+    const HAL_StatusTypeDef st = HAL_FLASHEx_Erase(&erase, &page_error);
+    HAL_FLASH_Lock();
+
+    return (st == HAL_OK) ? 0 : -EIO;
+}
+
+/**
+ * @brief  Programme une zone effacée, par double mot.
+ * @param  addr Adresse de destination (alignée sur NV_FLASH_WORD_SIZE).
+ * @param  src  Données à écrire.
+ * @param  len  Nombre d'octets (multiple de NV_FLASH_WORD_SIZE).
+ * @return 0 si succès, -EINVAL si l'alignement est incorrect, -EIO sinon.
+ */
+int8_t nv_flash_program(uint32_t addr, const void *src, uint32_t len){
+    const uint8_t *p = (const uint8_t *)src;
+    HAL_StatusTypeDef st = HAL_OK;
+
+    if(src == NULL || (addr % NV_FLASH_WORD_SIZE) != 0u || (len % NV_FLASH_WORD_SIZE) != 0u){
+        return -EINVAL;
+    }
+
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_SR_ERRORS);
+    for(uint32_t i = 0; i < len && st == HAL_OK; i += NV_FLASH_WORD_SIZE){
+        uint64_t dword;
+
+        memcpy(&dword, &p[i], sizeof(dword));
+        st = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, addr + i, dword);
+    }
+    HAL_FLASH_Lock();
+
+    if(st != HAL_OK || memcmp((const void *)addr, src, len) != 0){
+        return -EIO;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief  Indique si une zone est effacée (tous les octets à 0xFF).
+ * @param  addr Adresse de début.
+ * @param  len  Nombre d'octets.
+ * @return 1 si la zone est vierge, 0 sinon.
+ */
+uint8_t nv_flash_is_blank(uint32_t addr, uint32_t len){
+    const uint8_t *p = (const uint8_t *)addr;
+
+    for(uint32_t i = 0; i < len; i++){
+        if(p[i] != 0xFFu){
+            return 0;
+        }
+    }
+
+    return 1;
+}
@@ -0,0 +1,184 @@
+/**
+ * @file    odometry.c
+ * @brief   Implémentation de l'odométrie embarquée.
+ * @details Pour chaque échantillon : le cap tourne de dtheta = wz.dt (Q30), le vecteur
+ * (cos, sin) est tourné au premier ordre puis renormalisé, et la distance des fronts
+ * reçus depuis l'échantillon précédent est projetée sur ce vecteur. Les produits
+ * passent par des intermédiaires 64 bits.
+ */
+
+#include "odometry.h"
+#include "driver_speedometer.h"
+
+/**
+ * @brief Angle Q30 par µrad/s.µs, en Q32 : 2^30 / 10^12 x 2^32 = 2^62 / 10^12.
+ * @note  wz.dt reste sous 7e11 (pleine échelle gyroscope, dt <= ODOM_DT_MAX_US) :
+ * le produit par cette constante tient dans un int64.
+ */
+#define ODOM_ANGLE_Q32          4611686LL
+/** @brief pi en Q30. */
+#define ODOM_PI_Q30             3373259426LL
+
+/** @brief Produit de deux valeurs Q30. */
+static inline int32_t q30_mul(int32_t a, int32_t b){
+    return (int32_t)(((int64_t)a * b) >> 30);
+}
+
+/**
+ * @brief  Remet la position et le cap à zéro.
+ * @param  odo Pointeur vers l'odométrie.
+ */
+static void odom_reset_pose(Odometry_t *odo){
+    odo->x_um = 0;
+    odo->y_um = 0;
+    odo->heading_q30 = 0;
+    odo->cs_q30[0] = ODOM_ONE_Q30;
+    odo->cs_q30[1] = 0;
+}
+
+/**
+ * @brief  Initialise l'odométrie (origine, cap nul, distance nulle).
+ * @param  odo Pointeur vers l'odométrie.
+ */
+void odom_init(Odometry_t *odo){
+    odom_reset_pose(odo);
+    odo->dist_mm = 0;
+    odo->dist_frac_um = 0;
+    odo->last_ticks = 0;
+    odo->primed = false;
+    odo->last_us = 0;
+    odo->last_tick_us = 0;
+}
+
+/**
+ * @brief  Exécute une commande de REG_ODOM_CMD.
+ * @param  odo Pointeur vers l'odométrie.
+ * @param  cmd Commande (odom_cmd_t).
+ */
+void odom_command(Odometry_t *odo, uint8_t cmd){
+    switch(cmd){
+        case ODOM_CMD_RESET_ALL:
+            odo->dist_mm = 0;
+            odo->dist_frac_um = 0;
+            odom_reset_pose(odo);
+            break;
+
+        case ODOM_CMD_RESET_POSE:
+            odom_reset_pose(odo);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief  Tourne le vecteur cap d'un petit angle et le renormalise.
+ * @param  odo        Pointeur vers l'odométrie.
+ * @param  dtheta_q30 Angle (rad Q30).
+ */
+static void odom_rotate(Odometry_t *odo, int32_t dtheta_q30){
+    const int32_t c = odo->cs_q30[0];
+    const int32_t s = odo->cs_q30[1];
+    const int32_t nc = c - q30_mul(s, dtheta_q30);
+    const int32_t ns = s + q30_mul(c, dtheta_q30);
+
+    /* |v| reste proche de 1 : 1/|v| ~ (3 - |v|²) / 2 */
+    const int64_t n2 = ((int64_t)nc * nc + (int64_t)ns * ns) >> 30;
+    const int32_t k  = (int32_t)((3 * (int64_t)ODOM_ONE_Q30 - n2) >> 1);
+    odo->cs_q30[0] = q30_mul(nc, k);
+    odo->cs_q30[1] = q30_mul(ns, k);
+
+    odo->heading_q30 += dtheta_q30;
+    if(odo->heading_q30 > ODOM_PI_Q30){
+        odo->heading_q30 -= 2 * ODOM_PI_Q30;
+    }
+    else if(odo->heading_q30 <= -ODOM_PI_Q30){
+        odo->heading_q30 += 2 * ODOM_PI_Q30;
+    }
+}
+
+/**
+ * @brief  Intègre un échantillon IMU et les fronts du tachymètre reçus depuis le précédent.
+ * @details Le premier échantillon ne fait que dater l'état. Un écart supérieur à
+ * ODOM_DT_MAX_US (reprise après arrêt des acquisitions) n'est pas intégré en cap ; les
+ * fronts reçus pendant l'écart restent comptés en distance.
+ * @param  odo          Pointeur vers l'odométrie.
+ * @param  gyro_z_urads Vitesse angulaire autour de Z capteur (µrad/s).
+ * @param  ticks        Compteur de fronts du tachymètre (modulo 2^32).
+ * @param  forward      Sens de déplacement estimé (true = avant).
+ * @param  timestamp_us Date d'acquisition de l'échantillon (µs).
+ */
+void odom_update(Odometry_t *odo, int32_t gyro_z_urads, uint32_t ticks, bool forward, uint64_t timestamp_us){
+    if(!odo->primed){
+        odo->primed = true;
+        odo->last_us = timestamp_us;
+        odo->last_tick_us = timestamp_us;
+        odo->last_ticks = ticks;
+        return;
+    }
+
+    const uint64_t dt = timestamp_us - odo->last_us;
+    const uint32_t dticks = ticks - odo->last_ticks;
+    odo->last_us = timestamp_us;
+    odo->last_ticks = ticks;
+
+    if(dticks != 0){
+        odo->last_tick_us = timestamp_us;
+    }
+
+    if(dt <= ODOM_DT_MAX_US && (timestamp_us - odo->last_tick_us) < ODOM_STILL_US){
+        odom_rotate(odo, (int32_t)(((int64_t)gyro_z_urads * (int64_t)dt * ODOM_ANGLE_Q32) >> 32));
+    }
+
+    if(dticks == 0){
+        return;
+    }
+
+    /* Sur 32 bits jusqu'à 104 000 fronts (~4 km) entre deux échantillons */
+    const uint32_t ds_um = dticks * SPEEDO_UM_PER_TICK;
+    const int64_t  ds    = forward ? (int64_t)ds_um : -(int64_t)ds_um;
+
+    odo->x_um += (ds * odo->cs_q30[0]) >> 30;
+    odo->y_um += (ds * odo->cs_q30[1]) >> 30;
+
+    odo->dist_frac_um += ds_um;
+    odo->dist_mm      += odo->dist_frac_um / 1000u;
+    odo->dist_frac_um %= 1000u;
+}
+
+/**
+ * @brief  Position X.
+ * @param  odo Pointeur vers l'odométrie.
+ * @return Position (mm).
+ */
+int32_t odom_x_mm(const Odometry_t *odo){
+    return (int32_t)(odo->x_um / 1000);
+}
+
+/**
+ * @brief  Position Y.
+ * @param  odo Pointeur vers l'odométrie.
+ * @return Position (mm).
+ */
+int32_t odom_y_mm(const Odometry_t *odo){
+    return (int32_t)(odo->y_um / 1000);
+}
+
+/**
+ * @brief  Cap.
+ * @param  odo Pointeur vers l'odométrie.
+ * @return Cap (centièmes de degré, -18000..18000).
+ */
+int16_t odom_heading_cdeg(const Odometry_t *odo){
+    return (int16_t)((odo->heading_q30 * 18000) / ODOM_PI_Q30);
+}
+
+/**
+ * @brief  Distance parcourue cumulée.
+ * @param  odo Pointeur vers l'odométrie.
+ * @return Distance (mm, modulo 2^32).
+ */
+uint32_t odom_distance_mm(const Odometry_t *odo){
+    return odo->dist_mm;
+}
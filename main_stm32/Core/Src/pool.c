@@ -0,0 +1,49 @@
+/**
+ * @file    pool.c
+ * @brief   Implémentation de l'allocateur de blocs (cf. pool.h).
+ */
+
+#include "pool.h"
+#include "main.h"
+#include <stddef.h>
+
+void *pool_alloc(pool_t *pool){
+    void *block = NULL;
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if(pool->free_list != NULL){
+        block = pool->free_list;
+        pool->free_list = *(void **)block;
+    }
+    else if(pool->fresh < pool->count){
+        block = pool->storage + (uint32_t)pool->fresh * pool->block_size;
+        pool->fresh++;
+    }
+
+    if(block != NULL){
+        pool->available--;
+        if(pool->available < pool->low_water){
+            pool->low_water = pool->available;
+        }
+    }
+    else{
+        pool->failures++;
+    }
+
+    __set_PRIMASK(primask);
+    return block;
+}
+
+void pool_free(pool_t *pool, void *block){
+    if(block == NULL){
+        return;
+    }
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *(void **)block = pool->free_list;
+    pool->free_list = block;
+    pool->available++;
+    __set_PRIMASK(primask);
+}
@@ -0,0 +1,109 @@
+/**
+ * @file    profiler.c
+ * @brief   Implémentation des sondes de temps d'exécution.
+ * @details Les durées sont des différences de GetMicrosTotal() (modulo 2^32), justes
+ * tant qu'une exécution dure moins de 71 minutes.
+ */
+
+#include "main.h"
+#include "profiler.h"
+#include "timebase.h"
+#include "mem_map.h"
+#include <stddef.h>
+#include <string.h>
+
+/** @brief Statistiques des sondes hors ordonnanceur. */
+static prof_stat_t prof_probes[PROF_PROBE_COUNT] MEM_HOT_BSS;
+
+/**
+ * @brief  Comptabilise une mesure.
+ * @param  s     Statistiques de la sonde.
+ * @param  dt_us Durée mesurée (µs).
+ */
+void prof_record(prof_stat_t *s, uint32_t dt_us){
+    if(s->count == 0 || dt_us < s->min_us){
+        s->min_us = dt_us;
+    }
+    if(dt_us > s->max_us){
+        s->max_us = dt_us;
+    }
+    s->sum_us += dt_us;
+    s->count++;
+
+#if PROF_HISTOGRAM
+    uint8_t bin = 0;
+    uint32_t limit = 4u;
+    while(bin < PROF_HIST_BINS - 1u && dt_us >= limit){
+        bin++;
+        limit <<= 2;
+    }
+    s->hist[bin]++;
+#endif
+}
+
+/**
+ * @brief  Remet à zéro les statistiques d'une sonde.
+ * @param  s Statistiques de la sonde.
+ */
+void prof_reset(prof_stat_t *s){
+    __disable_irq();
+    memset(s, 0, sizeof(*s));
+    __enable_irq();
+}
+
+/**
+ * @brief  Copie cohérente des statistiques.
+ * @param  s   Statistiques de la sonde.
+ * @param  out Copie de sortie.
+ */
+void prof_snapshot(const prof_stat_t *s, prof_stat_t *out){
+    __disable_irq();
+    *out = *s;
+    __enable_irq();
+}
+
+/**
+ * @brief  Durée moyenne d'une sonde.
+ * @param  s Statistiques de la sonde.
+ * @return Moyenne (µs), 0 si aucune mesure.
+ */
+uint32_t prof_avg_us(const prof_stat_t *s){
+    return (s->count != 0) ? (uint32_t)(s->sum_us / s->count) : 0u;
+}
+
+/**
+ * @brief  Démarre la mesure d'une sonde.
+ * @return Date de début (µs).
+ */
+uint32_t prof_begin(void){
+    return GetMicrosTotal();
+}
+
+/**
+ * @brief  Termine la mesure d'une sonde hors ordonnanceur.
+ * @param  id       Sonde.
+ * @param  start_us Date renvoyée par prof_begin().
+ */
+void prof_end(prof_probe_id_t id, uint32_t start_us){
+    if(id < PROF_PROBE_COUNT){
+        prof_record(&prof_probes[id], GetMicrosTotal() - start_us);
+    }
+}
+
+/**
+ * @brief  Accès aux statistiques d'une sonde hors ordonnanceur.
+ * @param  id Sonde.
+ * @return Statistiques, NULL si l'index est invalide.
+ */
+prof_stat_t *prof_probe(uint8_t id){
+    return (id < PROF_PROBE_COUNT) ? &prof_probes[id] : NULL;
+}
+
+/**
+ * @brief  Remet à zéro toutes les sondes hors ordonnanceur.
+ */
+void prof_reset_probes(void){
+    for(uint8_t i = 0; i < PROF_PROBE_COUNT; i++){
+        prof_reset(&prof_probes[i]);
+    }
+}
@@ -0,0 +1,120 @@
+/**
+ * @file    ramp.c
+ * @brief   Implémentation du générateur de profil de consigne (cf. ramp.h).
+ * @details À chaque tick, la variation visée est la plus grande qui permet encore de
+ * s'arrêter sur la consigne en la réduisant de acc_max par tick : un freinage
+ * discret depuis v parcourt v²/(2a) + v/2, d'où v = (sqrt(a² + 8ae) - a) / 2 pour un
+ * écart e. La variation appliquée rejoint cette valeur d'au plus acc_max par tick,
+ * puis est bornée à rate_max. Le dernier pas, plus court que acc_max, se cale sur la
+ * consigne.
+ */
+
+#include "ramp.h"
+
+/**
+ * @brief  Racine carrée entière (bit à bit, sans division).
+ * @param  x Argument.
+ * @return Partie entière de sqrt(x).
+ */
+static uint32_t ramp_isqrt(uint64_t x){
+    uint64_t bit = (uint64_t)1 << 62;
+    uint64_t res = 0;
+
+    while(bit > x){
+        bit >>= 2;
+    }
+    while(bit != 0){
+        if(x >= res + bit){
+            x -= res + bit;
+            res = (res >> 1) + bit;
+        }
+        else{
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)res;
+}
+
+void ramp_set_limits(ramp_t *ramp, uint32_t rate_max_q16, uint32_t acc_max_q16){
+    ramp->rate_max_q16 = rate_max_q16;
+    ramp->acc_max_q16 = acc_max_q16;
+}
+
+void ramp_set_target(ramp_t *ramp, int16_t target){
+    ramp->target_q16 = (int32_t)target * 65536;
+}
+
+void ramp_jump(ramp_t *ramp, int16_t value){
+    ramp->pos_q16 = (int32_t)value * 65536;
+    ramp->rate_q16 = 0;
+    ramp->target_q16 = ramp->pos_q16;
+}
+
+bool ramp_tick(ramp_t *ramp){
+    const int32_t target = ramp->target_q16;
+    const int64_t err = (int64_t)target - ramp->pos_q16;
+    const uint64_t err_abs = (err < 0) ? (uint64_t)-err : (uint64_t)err;
+    const uint32_t rate_max = ramp->rate_max_q16;
+    const uint32_t acc = ramp->acc_max_q16;
+    int64_t rate;
+
+    if(err == 0 && ramp->rate_q16 == 0){
+        return false;
+    }
+
+    if(acc == 0){
+        /* Variation seule bornée : pas constant jusqu'à la consigne */
+        if(rate_max == 0 || err_abs <= rate_max){
+            ramp->pos_q16 = target;
+            ramp->rate_q16 = 0;
+            return false;
+        }
+        ramp->rate_q16 = (err < 0) ? -(int32_t)rate_max : (int32_t)rate_max;
+        ramp->pos_q16 += ramp->rate_q16;
+        return true;
+    }
+
+    /* Variation permettant encore de s'arrêter sur la consigne */
+    uint64_t v = (ramp_isqrt((uint64_t)acc * acc + 8u * (uint64_t)acc * err_abs) - acc) / 2u;
+    if(rate_max != 0 && v > rate_max){
+        v = rate_max;
+    }
+    const int64_t v_des = (err < 0) ? -(int64_t)v : (int64_t)v;
+
+    rate = ramp->rate_q16;
+    if(v_des > rate + (int64_t)acc){
+        rate += acc;
+    }
+    else if(v_des < rate - (int64_t)acc){
+        rate -= acc;
+    }
+    else{
+        rate = v_des;
+    }
+
+    /* Dernier pas : la consigne est atteinte à l'arrêt */
+    const uint64_t rate_abs = (rate < 0) ? (uint64_t)-rate : (uint64_t)rate;
+    const int32_t prev = ramp->rate_q16;
+    if((rate < 0) == (err < 0) && rate_abs >= err_abs && (uint32_t)((prev < 0) ? -prev : prev) <= acc){
+        ramp->pos_q16 = target;
+        ramp->rate_q16 = 0;
+        return false;
+    }
+
+    ramp->rate_q16 = (int32_t)rate;
+    ramp->pos_q16 += (int32_t)rate;
+    return true;
+}
+
+bool ramp_busy(const ramp_t *ramp){
+    return ramp->pos_q16 != ramp->target_q16 || ramp->rate_q16 != 0;
+}
+
+bool ramp_limited(const ramp_t *ramp){
+    return ramp->rate_max_q16 != 0 || ramp->acc_max_q16 != 0;
+}
+
+int16_t ramp_output(const ramp_t *ramp){
+    return (int16_t)((ramp->pos_q16 + 0x8000) >> 16);
+}
@@ -0,0 +1,119 @@
+/**
+ * @file    replay.c
+ * @brief   Implémentation du rejeu de mesures enregistrées (cf. replay.h).
+ */
+
+#include "replay.h"
+
+#if REPLAY_ENABLE
+
+#include "driver_ins.h"
+#include "timebase.h"
+
+/** @brief 1 pendant le rejeu. */
+static uint8_t replay_on = 0;
+/** @brief Date du dernier échantillon injecté (µs). */
+static uint64_t replay_t_us = 0;
+/** @brief Vitesse du dernier enregistrement (mm/s). */
+static int16_t replay_speed = 0;
+/** @brief Échantillons publiés depuis REPLAY_CMD_START. */
+static uint32_t replay_cnt = 0;
+/** @brief 1 pendant la source synthétique (replay_on aussi à 1). */
+static uint8_t synth_on = 0;
+/** @brief Date du premier échantillon synthétique de la grille (µs). */
+static uint64_t synth_t0_us = 0;
+/** @brief Période de la grille (µs), 0 : à (re)démarrer au prochain tick. */
+static uint32_t synth_period_us = 0;
+/** @brief Rang du prochain échantillon synthétique. */
+static uint32_t synth_n = 0;
+
+/**
+ * @brief  Lit un registre little-endian de l'enregistrement.
+ * @param  data Enregistrement.
+ * @param  i    Indice du registre.
+ * @return Valeur 16 bits.
+ */
+static inline uint16_t replay_u16(const uint8_t *data, uint8_t i){
+    return (uint16_t)data[2u * i] | ((uint16_t)data[2u * i + 1u] << 8);
+}
+
+void replay_command(uint8_t cmd){
+    if(cmd == REPLAY_CMD_START || cmd == REPLAY_CMD_SYNTH){
+        replay_t_us  = GetMicros64();
+        replay_speed = 0;
+        replay_cnt   = 0;
+        replay_on    = 1;
+        synth_on     = (cmd == REPLAY_CMD_SYNTH) ? 1u : 0u;
+        synth_period_us = 0;
+        synth_n      = 0;
+        BMI088_Inject_Mode(1);
+    }
+    else{
+        replay_on = 0;
+        synth_on  = 0;
+        BMI088_Inject_Mode(0);
+    }
+}
+
+void replay_push(const uint8_t *data, uint8_t count){
+    bmi088_raw_t raw;
+
+    if(!replay_on || synth_on || count != REPLAY_REC_REGS){
+        return;
+    }
+
+    replay_t_us += replay_u16(data, 0);
+    for(uint8_t i = 0; i < 3u; i++){
+        raw.accel[i] = (int16_t)replay_u16(data, (uint8_t)(1u + i));
+        raw.gyro[i]  = (int16_t)replay_u16(data, (uint8_t)(4u + i));
+    }
+    replay_speed = (int16_t)replay_u16(data, 7);
+
+    if(BMI088_Inject(&raw, replay_t_us)){
+        replay_cnt++;
+    }
+}
+
+uint8_t replay_active(void){
+    return replay_on;
+}
+
+int16_t replay_speed_mms(void){
+    return replay_speed;
+}
+
+uint32_t replay_count(void){
+    return replay_cnt;
+}
+
+uint8_t replay_synth_active(void){
+    return synth_on;
+}
+
+void replay_synth_tick(uint64_t now_us, uint32_t period_us){
+    bmi088_raw_t raw;
+
+    if(!synth_on || period_us == 0){
+        return;
+    }
+    if(period_us != synth_period_us){
+        synth_period_us = period_us;
+        synth_t0_us = now_us;
+        synth_n = 0;
+    }
+
+    const int16_t saw = (int16_t)(synth_n & (REPLAY_SYNTH_SAW - 1u)) - (int16_t)(REPLAY_SYNTH_SAW / 2u);
+    raw.accel[0] = (int16_t)(uint16_t)synth_n;
+    raw.accel[1] = (int16_t)(uint16_t)(synth_n >> 16);
+    raw.accel[2] = REPLAY_SYNTH_AZ;
+    raw.gyro[0]  = saw;
+    raw.gyro[1]  = (int16_t)-saw;
+    raw.gyro[2]  = (int16_t)(saw / 4);
+
+    if(BMI088_Inject(&raw, synth_t0_us + (uint64_t)synth_n * synth_period_us)){
+        replay_cnt++;
+    }
+    synth_n++;
+}
+
+#endif /* REPLAY_ENABLE */
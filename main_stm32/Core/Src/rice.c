@@ -0,0 +1,58 @@
+/**
+ * @file    rice.c
+ * @brief   Implémentation du codage de Rice (cf. rice.h).
+ */
+
+#include "rice.h"
+
+/**
+ * @brief  Ajoute au plus 24 bits au flux.
+ * @param  w Flux.
+ * @param  v Bits, poids faible d'abord.
+ * @param  n Nombre de bits (0..24).
+ */
+static void rice_put_bits(rice_writer_t *w, uint32_t v, uint8_t n){
+    w->acc |= v << w->nacc;
+    w->nacc = (uint8_t)(w->nacc + n);
+    while(w->nacc >= 8u){
+        w->buf[w->pos++] = (uint8_t)w->acc;
+        w->acc >>= 8;
+        w->nacc = (uint8_t)(w->nacc - 8u);
+    }
+}
+
+void rice_put(rice_writer_t *w, uint32_t v, uint8_t k){
+    const uint32_t q = v >> k;
+
+    if(q >= RICE_ESCAPE){
+        rice_put_bits(w, (1u << RICE_ESCAPE) - 1u, RICE_ESCAPE);
+        rice_put_bits(w, v & 0xFFFFu, 16u);
+        rice_put_bits(w, v >> 16, 16u);
+        return;
+    }
+    rice_put_bits(w, (1u << q) - 1u, (uint8_t)(q + 1u));
+    if(k > 0u){
+        rice_put_bits(w, v & ((1u << k) - 1u), k);
+    }
+}
+
+void rice_rewind(rice_writer_t *w, uint32_t bits){
+    const uint16_t pos  = (uint16_t)(bits >> 3);
+    const uint8_t  nacc = (uint8_t)(bits & 7u);
+
+    if(pos < w->pos){
+        w->acc = w->buf[pos];
+    }
+    w->acc &= (1u << nacc) - 1u;
+    w->pos  = pos;
+    w->nacc = nacc;
+}
+
+uint16_t rice_end(rice_writer_t *w){
+    if(w->nacc > 0u){
+        w->buf[w->pos++] = (uint8_t)w->acc;
+        w->acc  = 0;
+        w->nacc = 0;
+    }
+    return w->pos;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file    rtt.c
+ * @brief   Implémentation du journal RAM lu par la sonde SWD (cf. rtt.h).
+ * @details Disposition du bloc de contrôle identique à SEGGER_RTT_CB (version 6+), ce
+ * qui le rend lisible par les outils existants sans bibliothèque SEGGER. Dans chaque
+ * anneau, la cible ne modifie que son index (WrOff en montée, RdOff en descente) : la
+ * sonde, qui modifie l'autre, n'a pas besoin de verrou. Les accès concurrents côté
+ * cible (boucle principale, interruptions) sont sérialisés interruptions masquées.
+ */
+
+#include "main.h"
+#include "rtt.h"
+#include "console.h"
+#include <string.h>
+
+#if RTT_ENABLE
+
+/** @brief Mode d'un anneau montant plein : ne rien écrire. */
+#define RTT_MODE_NO_BLOCK_SKIP  0u
+/** @brief Mode d'un anneau montant plein : écrire ce qui tient. */
+#define RTT_MODE_NO_BLOCK_TRIM  1u
+
+/**
+ * @brief Anneau montant ou descendant (disposition SEGGER_RTT_BUFFER_UP / _DOWN).
+ */
+typedef struct{
+    const char *name;               ///< Nom affiché par l'outil.
+    char *buf;                      ///< Mémoire de l'anneau.
+    uint32_t size;                  ///< Taille de l'anneau (octets).
+    volatile uint32_t wr_off;       ///< Index d'écriture (cible en montée, sonde en descente).
+    volatile uint32_t rd_off;       ///< Index de lecture (sonde en montée, cible en descente).
+    uint32_t flags;                 ///< Mode (RTT_MODE_*).
+} rtt_ring_t;
+
+/**
+ * @brief Bloc de contrôle (disposition SEGGER_RTT_CB).
+ */
+typedef struct{
+    volatile char id[16];           ///< "SEGGER RTT", écrit en dernier.
+    int32_t max_up;                 ///< Nombre d'anneaux montants.
+    int32_t max_down;               ///< Nombre d'anneaux descendants.
+    rtt_ring_t up[RTT_CH_COUNT];    ///< Anneaux montants.
+    rtt_ring_t down[1];             ///< Anneaux descendants.
+} rtt_cb_t;
+
+/** @brief Bloc de contrôle, en tête de la section .rtt (hors .bss : non remis à zéro au démarrage). */
+__attribute__((section(".rtt"), aligned(4))) static rtt_cb_t rtt_cb;
+
+static char rtt_term_up[RTT_TERMINAL_UP_SIZE];
+static char rtt_dlog_up[RTT_DLOG_UP_SIZE];
+static char rtt_term_down[RTT_TERMINAL_DOWN_SIZE];
+
+/**
+ * @brief  Renseigne un anneau vide.
+ * @param  r     Anneau.
+ * @param  name  Nom affiché.
+ * @param  buf   Mémoire.
+ * @param  size  Taille (octets).
+ * @param  flags Mode.
+ */
+static void rtt_ring_init(rtt_ring_t *r, const char *name, char *buf, uint32_t size, uint32_t flags){
+    r->name   = name;
+    r->buf    = buf;
+    r->size   = size;
+    r->wr_off = 0;
+    r->rd_off = 0;
+    r->flags  = flags;
+}
+
+void rtt_init(void){
+    /* Identifiant en dernier, écrit à l'envers : absent de la flash, il ne désigne le
+       bloc qu'une fois celui-ci complet */
+    static const char id_rev[] = "TTR REGGES";
+
+    memset((void *)rtt_cb.id, 0, sizeof(rtt_cb.id));
+    rtt_cb.max_up   = RTT_CH_COUNT;
+    rtt_cb.max_down = 1;
+    rtt_ring_init(&rtt_cb.up[RTT_CH_TERMINAL], "Terminal", rtt_term_up, sizeof(rtt_term_up), RTT_MODE_NO_BLOCK_TRIM);
+    rtt_ring_init(&rtt_cb.up[RTT_CH_DLOG], "DLog", rtt_dlog_up, sizeof(rtt_dlog_up), RTT_MODE_NO_BLOCK_SKIP);
+    rtt_ring_init(&rtt_cb.down[0], "Terminal", rtt_term_down, sizeof(rtt_term_down), RTT_MODE_NO_BLOCK_SKIP);
+
+    __DMB();
+    for(uint32_t i = 0; i < sizeof(id_rev) - 1u; i++){
+        rtt_cb.id[sizeof(id_rev) - 2u - i] = id_rev[i];
+    }
+    __DMB();
+}
+
+uint32_t rtt_write(uint8_t ch, const void *data, uint32_t len){
+    if(ch >= RTT_CH_COUNT){
+        return 0;
+    }
+
+    rtt_ring_t *r = &rtt_cb.up[ch];
+    const uint8_t *src = (const uint8_t *)data;
+    const uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+
+    uint32_t wr = r->wr_off;
+    const uint32_t rd = r->rd_off;
+    const uint32_t avail = (rd > wr) ? (rd - wr - 1u) : (r->size - 1u - wr + rd);
+
+    if(len > avail){
+        if(r->flags == RTT_MODE_NO_BLOCK_SKIP){
+            __set_PRIMASK(primask);
+            return 0;
+        }
+        len = avail;
+    }
+
+    const uint32_t first = (len < r->size - wr) ? len : (r->size - wr);
+    memcpy(&r->buf[wr], src, first);
+    memcpy(r->buf, src + first, len - first);
+    wr += len;
+    if(wr >= r->size){
+        wr -= r->size;
+    }
+
+    /* Données visibles par la sonde avant l'index qui les publie */
+    __DMB();
+    r->wr_off = wr;
+
+    __set_PRIMASK(primask);
+    return len;
+}
+
+uint32_t rtt_read(void *data, uint32_t len){
+    rtt_ring_t *r = &rtt_cb.down[0];
+    uint8_t *dst = (uint8_t *)data;
+    const uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+
+    uint32_t rd = r->rd_off;
+    const uint32_t wr = r->wr_off;
+    uint32_t n = 0;
+
+    __DMB();
+    while(rd != wr && n < len){
+        dst[n++] = (uint8_t)r->buf[rd];
+        rd = (rd + 1u < r->size) ? (rd + 1u) : 0u;
+    }
+    r->rd_off = rd;
+
+    __set_PRIMASK(primask);
+    return n;
+}
+
+#if !CONSOLE_ENABLE
+/**
+ * @brief  Sortie standard de newlib redirigée vers la voie terminal.
+ * @details Remplace celle de serial.c (ring TX de l'USART2), compilée hors RTT_ENABLE.
+ * La longueur entière est rendue même tronquée : newlib ne réessaie pas en boucle.
+ * La console sur second UART (console.h), si présente, a priorité.
+ */
+int _write(int file, char *ptr, int len){
+    (void)file;
+
+    if(len > 0){
+        (void)rtt_write(RTT_CH_TERMINAL, ptr, (uint32_t)len);
+    }
+    return len;
+}
+#endif
+
+#endif /* RTT_ENABLE */
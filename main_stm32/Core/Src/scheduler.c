@@ -0,0 +1,380 @@
+/**
+ * @file    scheduler.c
+ * @brief   Implémentation de l'ordonnanceur coopératif à échéances absolues.
+ * @details À chaque passage, les tâches échues sont exécutées une fois chacune, de la
+ * plus prioritaire à la moins prioritaire. La libération suivante est l'échéance
+ * précédente plus la période ; les libérations déjà dépassées sont comptées comme
+ * manquées (overrun) et sautées, en conservant la phase.
+ * En build SCHED_RTOS, chaque tâche noyau applique la même règle à son entrée.
+ */
+
+#include "scheduler.h"
+#include "timebase.h"
+#include "trace.h"
+#include "fault_log.h"
+#include <stddef.h>
+
+#if SCHED_RTOS
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#endif
+
+/** @brief Table de tâches fournie par l'application. */
+static sched_task_t *sched_tasks = NULL;
+/** @brief Nombre de tâches de la table. */
+static uint8_t sched_count = 0;
+/** @brief Début de la fenêtre de mesure d'inactivité en cours (µs). */
+static uint64_t idle_window_start_us = 0;
+/** @brief Temps de veille cumulé dans la fenêtre en cours (µs). */
+static uint32_t idle_acc_us = 0;
+/** @brief Taux d'inactivité de la dernière fenêtre complète (%). */
+static uint8_t idle_pct = 0;
+
+#if SCHED_RTOS
+/** @brief Tâches noyau : une par entrée de la table, plus la tâche de scrutation (dernière). */
+static TaskHandle_t rtos_handle[SCHED_RTOS_MAX_TASKS + 1u];
+static StaticTask_t rtos_tcb[SCHED_RTOS_MAX_TASKS + 1u];
+static StackType_t rtos_stack[SCHED_RTOS_MAX_TASKS + 1u][SCHED_RTOS_STACK_WORDS];
+/** @brief Verrou global des exécutions (héritage de priorité). */
+static SemaphoreHandle_t rtos_lock = NULL;
+static StaticSemaphore_t rtos_lock_buf;
+/** @brief Travail hors table exécuté par la tâche de scrutation. */
+static sched_fn_t rtos_poll_fn = NULL;
+/** @brief Nombre de tâches noyau de la table (hors scrutation). */
+static uint8_t rtos_count = 0;
+/** @brief Noyau démarré : les notifications sont valides. */
+static volatile uint8_t rtos_started = 0;
+#endif
+
+/**
+ * @brief  Initialise l'ordonnanceur avec la table de tâches de l'application.
+ * @param  tasks  Table de tâches.
+ * @param  count  Nombre de tâches.
+ * @param  now_us Date de référence des phases (µs).
+ */
+void sched_init(sched_task_t *tasks, uint8_t count, uint64_t now_us){
+    sched_tasks = tasks;
+    sched_count = (tasks != NULL) ? count : 0;
+    if(sched_count > SCHED_MAX_TASKS){
+        sched_count = SCHED_MAX_TASKS;
+    }
+
+    for(uint8_t i = 0; i < sched_count; i++){
+        sched_tasks[i].next_release_us = now_us + sched_tasks[i].phase_us;
+    }
+
+    idle_window_start_us = now_us;
+    idle_acc_us = 0;
+
+    sched_reset_stats();
+}
+
+/**
+ * @brief  Exécute une tâche et met à jour ses statistiques.
+ * @param  t      Tâche à exécuter.
+ * @param  now_us Date du passage courant (µs).
+ */
+static void sched_dispatch(sched_task_t *t, uint64_t now_us){
+    const uint64_t start = GetMicros64();
+
+    if(t->period_us != 0){
+        uint64_t late = (start > t->next_release_us) ? (start - t->next_release_us) : 0u;
+        prof_record(&t->late, (late > UINT32_MAX) ? UINT32_MAX : (uint32_t)late);
+    }
+
+    t->rescheduled = 0;
+    TRACE_HI(TASK);
+    fault_log_task((uint8_t)(t - sched_tasks));
+    t->fn(start);
+    fault_log_task(FAULT_TASK_NONE);
+    TRACE_LO(TASK);
+
+    const uint64_t end = GetMicros64();
+    t->exec_last_us = (uint32_t)(end - start);
+    prof_record(&t->exec, t->exec_last_us);
+    t->runs++;
+
+    if(t->rescheduled){
+        return;
+    }
+
+    if(t->period_us == 0){
+        t->next_release_us = now_us;
+        return;
+    }
+
+    /* Échéance suivante calée sur le calendrier, pas sur la date d'exécution */
+    t->next_release_us += t->period_us;
+    if(t->next_release_us <= end){
+        uint64_t missed = (end - t->next_release_us) / t->period_us + 1u;
+        t->next_release_us += missed * t->period_us;
+        t->overruns += (uint32_t)missed;
+    }
+}
+
+/**
+ * @brief  Exécute les tâches échues, par ordre de priorité.
+ * @details Chaque tâche échue est exécutée au plus une fois par appel : une tâche
+ * en retard ne peut pas monopoliser la boucle principale.
+ * @param  now_us Date courante (µs).
+ */
+void sched_run(uint64_t now_us){
+    uint32_t done = 0;
+
+    if((now_us - idle_window_start_us) >= SCHED_IDLE_WINDOW_US){
+        uint64_t window = now_us - idle_window_start_us;
+        uint64_t pct = ((uint64_t)idle_acc_us * 100u) / window;
+        idle_pct = (pct > 100u) ? 100u : (uint8_t)pct;
+        idle_window_start_us = now_us;
+        idle_acc_us = 0;
+    }
+
+    for(;;){
+        sched_task_t *best = NULL;
+        uint8_t best_id = 0;
+
+        for(uint8_t i = 0; i < sched_count; i++){
+            sched_task_t *t = &sched_tasks[i];
+            if((done & (1u << i)) || t->next_release_us > now_us){
+                continue;
+            }
+            if(best == NULL || t->priority < best->priority){
+                best = t;
+                best_id = i;
+            }
+        }
+
+        if(best == NULL){
+            return;
+        }
+
+        done |= (1u << best_id);
+        sched_dispatch(best, now_us);
+    }
+}
+
+/**
+ * @brief  Modifie la période d'une tâche.
+ * @param  id        Index de la tâche.
+ * @param  period_us Nouvelle période (µs).
+ */
+void sched_set_period(uint8_t id, uint32_t period_us){
+    if(id < sched_count){
+        sched_tasks[id].period_us = period_us;
+    }
+}
+
+/**
+ * @brief  Fixe la prochaine libération d'une tâche.
+ * @param  id         Index de la tâche.
+ * @param  release_us Date de libération absolue (µs).
+ */
+void sched_set_release(uint8_t id, uint64_t release_us){
+    if(id < sched_count){
+        sched_tasks[id].next_release_us = release_us;
+        sched_tasks[id].rescheduled = 1;
+#if SCHED_RTOS
+        /* La tâche recalcule son attente (appelant sous rtos_lock) */
+        if(rtos_started && id < rtos_count){
+            xTaskNotifyGive(rtos_handle[id]);
+        }
+#endif
+    }
+}
+
+/**
+ * @brief  Donne accès à l'état d'une tâche.
+ * @param  id Index de la tâche.
+ * @return Pointeur vers la tâche, NULL si l'index est invalide.
+ */
+const sched_task_t *sched_get_task(uint8_t id){
+    return (id < sched_count) ? &sched_tasks[id] : NULL;
+}
+
+/**
+ * @brief  Nombre de tâches de la table.
+ * @return Nombre de tâches ordonnancées.
+ */
+uint8_t sched_task_count(void){
+    return sched_count;
+}
+
+/**
+ * @brief  Remet à zéro les statistiques de toutes les tâches.
+ */
+void sched_reset_stats(void){
+    for(uint8_t i = 0; i < sched_count; i++){
+        sched_tasks[i].runs            = 0;
+        sched_tasks[i].overruns        = 0;
+        prof_reset(&sched_tasks[i].late);
+        sched_tasks[i].exec_last_us    = 0;
+        prof_reset(&sched_tasks[i].exec);
+    }
+}
+
+/**
+ * @brief  Prochaine échéance parmi les tâches périodiques.
+ * @return Échéance absolue (µs), UINT64_MAX si aucune tâche périodique.
+ */
+uint64_t sched_next_deadline(void){
+    uint64_t next = UINT64_MAX;
+
+    for(uint8_t i = 0; i < sched_count; i++){
+        if(sched_tasks[i].period_us != 0 && sched_tasks[i].next_release_us < next){
+            next = sched_tasks[i].next_release_us;
+        }
+    }
+
+    return next;
+}
+
+/**
+ * @brief  Recale les libérations échues après une période hors ordonnanceur.
+ * @param  now_us Date courante (µs).
+ */
+void sched_resume(uint64_t now_us){
+    for(uint8_t i = 0; i < sched_count; i++){
+        if(sched_tasks[i].next_release_us < now_us){
+            sched_tasks[i].next_release_us = now_us + sched_tasks[i].phase_us;
+        }
+    }
+}
+
+/**
+ * @brief  Comptabilise une période d'inactivité.
+ * @param  idle_us Durée passée en veille (µs).
+ */
+void sched_account_idle(uint32_t idle_us){
+    idle_acc_us += idle_us;
+}
+
+/**
+ * @brief  Taux d'inactivité de la dernière fenêtre complète.
+ * @return Part du temps passée en veille (%).
+ */
+uint8_t sched_idle_percent(void){
+    return idle_pct;
+}
+
+#if SCHED_RTOS
+/**
+ * @brief  Convertit une échéance en attente noyau, arrondie au tick supérieur.
+ * @param  release_us Échéance absolue (µs), UINT64_MAX : pas d'échéance.
+ * @param  now_us     Date courante (µs).
+ * @return Nombre de ticks (portMAX_DELAY : attente d'une notification).
+ */
+static TickType_t sched_rtos_ticks(uint64_t release_us, uint64_t now_us){
+    const uint32_t us_per_tick = 1000000u / configTICK_RATE_HZ;
+
+    if(release_us == UINT64_MAX){
+        return portMAX_DELAY;
+    }
+    if(release_us <= now_us){
+        return 0;
+    }
+
+    uint64_t delta = release_us - now_us;
+    if(delta > (uint64_t)(portMAX_DELAY - 1u) * us_per_tick){
+        return portMAX_DELAY - 1u;
+    }
+    return (TickType_t)(((uint32_t)delta + us_per_tick - 1u) / us_per_tick);
+}
+
+/**
+ * @brief  Corps d'une tâche noyau : exécute son entrée de table à chaque libération.
+ * @details Les tâches périodiques dorment jusqu'à leur échéance ; les tâches de fond
+ * (période nulle) jusqu'à une notification ou SCHED_RTOS_POLL_MS.
+ * @param  arg Entrée de la table (sched_task_t *).
+ */
+static void sched_rtos_task(void *arg){
+    sched_task_t *t = (sched_task_t *)arg;
+
+    for(;;){
+        TickType_t wait;
+
+        xSemaphoreTake(rtos_lock, portMAX_DELAY);
+        uint64_t now_us = GetMicros64();
+        if(t->next_release_us <= now_us){
+            sched_dispatch(t, now_us);
+        }
+        if(t->period_us == 0 && t->next_release_us <= now_us){
+            wait = pdMS_TO_TICKS(SCHED_RTOS_POLL_MS);
+        }
+        else{
+            wait = sched_rtos_ticks(t->next_release_us, GetMicros64());
+        }
+        xSemaphoreGive(rtos_lock);
+
+        if(wait != 0){
+            (void)ulTaskNotifyTake(pdTRUE, wait);
+        }
+    }
+}
+
+/**
+ * @brief  Corps de la tâche de scrutation (plus basse priorité applicative).
+ * @param  arg Inutilisé.
+ */
+static void sched_rtos_poll(void *arg){
+    (void)arg;
+
+    for(;;){
+        xSemaphoreTake(rtos_lock, portMAX_DELAY);
+        rtos_poll_fn(GetMicros64());
+        xSemaphoreGive(rtos_lock);
+
+        (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SCHED_RTOS_POLL_MS));
+    }
+}
+
+/**
+ * @brief  Crée les tâches noyau de la table et démarre FreeRTOS.
+ * @note   Priorité noyau : configMAX_PRIORITIES - 1 - priority, bornée au-dessus de la
+ * tâche de scrutation. Le taux d'inactivité (sched_idle_percent()) n'est pas mesuré
+ * dans ce mode.
+ * @param  poll_fn Travail hors table.
+ */
+void sched_rtos_start(sched_fn_t poll_fn){
+    const UBaseType_t poll_prio = tskIDLE_PRIORITY + 1u;
+
+    rtos_poll_fn = poll_fn;
+    rtos_lock = xSemaphoreCreateMutexStatic(&rtos_lock_buf);
+    rtos_count = (sched_count > SCHED_RTOS_MAX_TASKS) ? SCHED_RTOS_MAX_TASKS : sched_count;
+
+    for(uint8_t i = 0; i < rtos_count; i++){
+        int32_t prio = (int32_t)configMAX_PRIORITIES - 1 - (int32_t)sched_tasks[i].priority;
+        if(prio <= (int32_t)poll_prio){
+            prio = (int32_t)poll_prio + 1;
+        }
+        rtos_handle[i] = xTaskCreateStatic(sched_rtos_task, sched_tasks[i].name, SCHED_RTOS_STACK_WORDS,
+                                           &sched_tasks[i], (UBaseType_t)prio, rtos_stack[i], &rtos_tcb[i]);
+    }
+    rtos_handle[rtos_count] = xTaskCreateStatic(sched_rtos_poll, "poll", SCHED_RTOS_STACK_WORDS,
+                                                NULL, poll_prio, rtos_stack[rtos_count], &rtos_tcb[rtos_count]);
+
+    rtos_started = 1;
+    vTaskStartScheduler();
+
+    for(;;){}
+}
+
+/**
+ * @brief  Réveille la tâche de scrutation et les tâches de fond (contexte interruption).
+ */
+void sched_wake_from_isr(void){
+    BaseType_t woken = pdFALSE;
+
+    if(!rtos_started){
+        return;
+    }
+
+    vTaskNotifyGiveFromISR(rtos_handle[rtos_count], &woken);
+    for(uint8_t i = 0; i < rtos_count; i++){
+        if(sched_tasks[i].period_us == 0){
+            vTaskNotifyGiveFromISR(rtos_handle[i], &woken);
+        }
+    }
+    portYIELD_FROM_ISR(woken);
+}
+#endif
@@ -1,27 +1,33 @@
 /**
  * @file    serial.c
  * @brief   Gestionnaire de communication Série (UART) avec DMA et Buffers Circulaires.
+ * @note    Les buffers RX et TX sont des files SPSC sans verrou : chaque index n'est
+ * écrit que par un seul contexte, et une barrière mémoire sépare l'accès aux données
+ * de la publication de l'index.
  * @details Ce fichier implémente un driver UART haute performance asynchrone.
- * - Réception : Utilise un buffer DMA linéaire couplé à un buffer circulaire logiciel.
+ * - Réception : DMA circulaire écrivant directement dans le buffer circulaire (SERIAL_RX_ZERO_COPY),
+ *   ou buffer DMA linéaire recopié dans un buffer circulaire logiciel.
  * - Transmission : Utilise un buffer circulaire logiciel vidé par DMA.
- * - Supporte les fonctions standard stdio (_write) pour printf.
+ * - Supporte les fonctions standard stdio (_write) pour printf, hors RTT_ENABLE (rtt.h)
+ *   et CONSOLE_ENABLE (console.h).
  */
 
 #include "serial.h"
 #include "usart.h"
 #include "dma.h"
+#include "crc8.h"
+#include "mem_map.h"
+#include "timebase.h"
+#include "dlog.h"
+#include "proto_def.h"
+#include "scheduler.h"
+#include "rtt.h"
+#include "console.h"
 #include <string.h>
-#include <stdio.h>
 #include <errno.h>
 
-/** @brief Buffer temporaire pour la réception DMA brute (Linear buffer). */
-static uint8_t rx_chunk[SERIAL_RX_CHUNK_SIZE];
-
-/** @brief Buffer circulaire logiciel pour la réception (Ring buffer). */
-static uint8_t rx_ring[SERIAL_RX_RING_SIZE];
-
-/** @brief Index de tête (écriture) du buffer circulaire RX. */
-static volatile uint32_t rx_head=0;
+/** @brief Buffer circulaire pour la réception (Ring buffer, cible du DMA en mode zero-copy). */
+static uint8_t rx_ring[SERIAL_RX_RING_SIZE] MEM_DMA_BSS;
 
 /** @brief Index de queue (lecture) du buffer circulaire RX. */
 static volatile uint32_t rx_tail=0;
@@ -29,39 +35,163 @@ static volatile uint32_t rx_tail=0;
 /** @brief Masque pour le calcul modulo du buffer RX (taille doit être puissance de 2). */
 #define RING_MASK (SERIAL_RX_RING_SIZE-1u)
 
+/** @brief Relance de la réception demandée par HAL_UART_ErrorCallback, traitée côté consommateur. */
+static volatile uint8_t rx_restart_pending=0;
+
+/** @brief Remplissage maximal observé du buffer RX (octets non lus). */
+static uint32_t rx_high_water=0;
+
+/** @brief Débordements matériels de l'UART (ORE) signalés par HAL_UART_ErrorCallback. */
+static volatile uint32_t rx_overruns=0;
+
+/** @brief Date de la dernière arrivée d'octets constatée (µs, GetMicrosTotal). */
+static volatile uint32_t rx_event_us=0;
+
+/** @brief Octets déjà parcourus sans délimiteur par serial_rx_peek_until(), depuis rx_scan_tail. */
+static uint32_t rx_scan_len=0;
+/** @brief Index de lecture au moment du dernier parcours (un autre index invalide rx_scan_len). */
+static uint32_t rx_scan_tail=0;
+/** @brief Délimiteur du dernier parcours. */
+static uint8_t rx_scan_delim=0;
+
+static void serial_rx_start(void);
+
+/**
+ * @brief  Relance la réception DMA si une erreur bloquante l'a interrompue.
+ * @note   Appelée par le consommateur : les index RX ne sont remis à zéro que hors interruption.
+ */
+static inline void rx_restart_service(void){
+    if(rx_restart_pending){
+        rx_restart_pending=0;
+        serial_rx_start();
+    }
+}
+
 #if (SERIAL_RX_RING_SIZE&(SERIAL_RX_RING_SIZE-1u))
 #error "SERIAL_RX_RING_SIZE must be a power of two"
 #endif
 
+#if SERIAL_RX_ZERO_COPY
+
+#if (SERIAL_RX_RING_SIZE>0xFFFFu)
+#error "SERIAL_RX_RING_SIZE must fit in the DMA NDTR counter"
+#endif
+
+/** @brief Dernière tête d'écriture DMA observée, pour dater l'arrivée de nouveaux octets. */
+static uint32_t rx_seen_head=0;
+
+#if SERIAL_RX_HW_FRAMING
+/** @brief Position DMA relevée à la dernière frontière de trame (RTO / détection de caractère). */
+static volatile uint32_t rx_frame_head=0;
+#endif
+
 /**
- * @brief  Ajoute un octet dans le buffer circulaire de réception.
- * @note   Fonction interne. Écrase les données si le buffer est plein (Overrun).
- * @param  b Octet à ajouter.
+ * @brief  Retourne l'index de tête (écriture DMA) du buffer circulaire RX.
+ * @note   Déduit du compteur de transferts restants du canal DMA circulaire. Sans
+ * interruption de réception, l'arrivée d'octets est datée à sa première observation.
+ * @return Index du prochain octet qui sera écrit par le DMA.
  */
-static inline void ring_push(uint8_t b){
-    rx_ring[rx_head]=b;
-    rx_head=(rx_head+1u)&RING_MASK;
-    if(rx_head==rx_tail)rx_tail=(rx_tail+1u)&RING_MASK;
+static inline uint32_t rx_head_get(void){
+    rx_restart_service();
+    const uint32_t head=(SERIAL_RX_RING_SIZE-__HAL_DMA_GET_COUNTER(SERIAL_UART.hdmarx))&RING_MASK;
+    if(head!=rx_seen_head){
+        rx_seen_head=head;
+        rx_event_us=GetMicrosTotal();
+    }
+    return head;
+}
+
+#else
+
+#if (SERIAL_RX_CHUNK_SIZE<2u)||(SERIAL_RX_CHUNK_SIZE&1u)
+#error "SERIAL_RX_CHUNK_SIZE must be even: the half-transfer event splits it in two"
+#endif
+#if (SERIAL_RX_CHUNK_SIZE>0xFFFFu)
+#error "SERIAL_RX_CHUNK_SIZE must fit in the DMA NDTR counter"
+#endif
+
+/** @brief Buffer temporaire pour la réception DMA brute (Linear buffer). */
+static uint8_t rx_chunk[SERIAL_RX_CHUNK_SIZE] MEM_DMA_BSS;
+
+/** @brief Index de tête (écriture) du buffer circulaire RX. */
+static volatile uint32_t rx_head=0;
+
+/** @brief Position DMA déjà recopiée dans rx_ring (0..SERIAL_RX_CHUNK_SIZE). */
+static uint16_t rx_old_pos=0;
+
+/** @brief Nombre d'octets reçus perdus faute de place dans rx_ring. */
+static volatile uint32_t rx_dropped=0;
+
+/**
+ * @brief  Ajoute un bloc dans le buffer circulaire de réception (producteur, rx_drain()).
+ * @note   Fonction interne. Deux memcpy au plus (rebouclage), l'index d'écriture est
+ * publié une fois pour tout le bloc. Buffer plein : les octets en trop sont perdus et
+ * comptabilisés, l'index de lecture (propriété du consommateur) n'est jamais modifié ici.
+ * @param  src Octets à ajouter.
+ * @param  len Nombre d'octets.
+ */
+static void ring_push_block(const uint8_t *src,uint32_t len){
+    const uint32_t head=rx_head;
+    const uint32_t space=(rx_tail-head-1u)&RING_MASK;
+    if(len>space){
+        rx_dropped+=len-space;
+        len=space;
+    }
+    uint32_t first=SERIAL_RX_RING_SIZE-head;
+    if(first>len)first=len;
+    memcpy(&rx_ring[head],src,first);
+    memcpy(rx_ring,src+first,len-first);
+    __DMB();
+    rx_head=(head+len)&RING_MASK;
 }
 
+/**
+ * @brief  Recopie dans rx_ring les octets écrits par le DMA depuis le dernier appel.
+ * @details Exécutée en boucle principale (consommateur) et non plus dans
+ * HAL_UARTEx_RxEventCallback : l'interruption UART reste courte et ne retarde plus
+ * la base de temps. La position DMA est lue sur NDTR. Une avance de plus de
+ * SERIAL_RX_CHUNK_SIZE octets entre deux appels n'est pas détectable (données écrasées).
+ */
+static void rx_drain(void){
+    uint16_t pos=(uint16_t)(SERIAL_RX_CHUNK_SIZE-__HAL_DMA_GET_COUNTER(SERIAL_UART.hdmarx));
+    if(pos>=SERIAL_RX_CHUNK_SIZE)pos=0;
+
+    while(rx_old_pos!=pos){
+        const uint32_t run=(pos>rx_old_pos)?(uint32_t)(pos-rx_old_pos):(SERIAL_RX_CHUNK_SIZE-rx_old_pos);
+        ring_push_block(&rx_chunk[rx_old_pos],run);
+        rx_old_pos=(uint16_t)((rx_old_pos+run==SERIAL_RX_CHUNK_SIZE)?0u:(rx_old_pos+run));
+    }
+}
+
+/** @brief Retourne l'index de tête (écriture) du buffer circulaire RX, après recopie des octets DMA. */
+static inline uint32_t rx_head_get(void){
+    rx_restart_service();
+    rx_drain();
+    return rx_head;
+}
+
+#endif
+
 /**
  * @brief  Retourne le nombre d'octets disponibles en lecture dans le buffer RX.
+ * @note   En mode zero-copy, un tour complet non lu du DMA n'est pas détecté (données écrasées).
  * @return Nombre d'octets.
  */
-static inline uint32_t ring_count(void){return (rx_head-rx_tail)&RING_MASK;}
-
-/** @brief Taille du buffer circulaire d'émission. */
-#define TX_RING_SIZE 1024u
+static inline uint32_t ring_count(void){
+    uint32_t count=(rx_head_get()-rx_tail)&RING_MASK;
+    if(count>rx_high_water)rx_high_water=count;
+    return count;
+}
 
 /** @brief Masque pour le calcul modulo du buffer TX. */
-#define TX_RING_MASK (TX_RING_SIZE-1u)
+#define TX_RING_MASK (SERIAL_TX_RING_SIZE-1u)
 
-#if (TX_RING_SIZE&(TX_RING_SIZE-1u))
-#error "TX_RING_SIZE must be a power of two"
+#if (SERIAL_TX_RING_SIZE&(SERIAL_TX_RING_SIZE-1u))
+#error "SERIAL_TX_RING_SIZE must be a power of two"
 #endif
 
 /** @brief Buffer circulaire pour la transmission. */
-static uint8_t tx_ring[TX_RING_SIZE];
+static uint8_t tx_ring[SERIAL_TX_RING_SIZE] MEM_DMA_BSS;
 
 /** @brief Index de tête (écriture utilisateur) du buffer TX. */
 static volatile uint32_t tx_head=0;
@@ -72,6 +202,63 @@ static volatile uint32_t tx_tail=0;
 /** @brief Indicateur d'activité du canal DMA TX. */
 static volatile uint8_t tx_busy=0;
 
+/** @brief Nombre d'octets du transfert DMA TX en cours. */
+static volatile uint16_t tx_inflight=0;
+
+#if SERIAL_TX_PRIORITY
+/** @brief Masque pour le calcul modulo de la file prioritaire. */
+#define TX_CTRL_MASK (SERIAL_TX_CTRL_SIZE-1u)
+/** @brief Masque pour le calcul modulo de la liste des frontières. */
+#define TX_BOUND_MASK (SERIAL_TX_BOUNDS-1u)
+
+#if (SERIAL_TX_CTRL_SIZE&(SERIAL_TX_CTRL_SIZE-1u))||(SERIAL_TX_BOUNDS&(SERIAL_TX_BOUNDS-1u))
+#error "SERIAL_TX_CTRL_SIZE and SERIAL_TX_BOUNDS must be powers of two"
+#endif
+
+/** @brief File d'émission prioritaire (réponses de commande, échos). */
+static uint8_t tx_ctrl_ring[SERIAL_TX_CTRL_SIZE] MEM_DMA_BSS;
+
+/** @brief Index de tête de la file prioritaire. */
+static volatile uint32_t tx_ctrl_head=0;
+
+/** @brief Index de queue de la file prioritaire. */
+static volatile uint32_t tx_ctrl_tail=0;
+
+/** @brief Source du transfert DMA en cours : 1 file prioritaire, 0 ring principal. */
+static volatile uint8_t tx_inflight_ctrl=0;
+
+/** @brief 1 si le dernier transfert du ring principal s'est arrêté au milieu d'une trame. */
+static volatile uint8_t tx_mid_frame=0;
+
+/** @brief Fins de publication du ring principal pas encore émises (frontières de trame). */
+static volatile uint16_t tx_bound[SERIAL_TX_BOUNDS];
+
+/** @brief Index d'écriture de tx_bound (free-running). */
+static volatile uint32_t tx_bound_head=0;
+
+/** @brief Index de lecture de tx_bound (free-running). */
+static volatile uint32_t tx_bound_tail=0;
+#endif
+
+#if SERIAL_TX_LL_KICK
+/** @brief 1 quand le canal DMA TX a été configuré par la HAL et peut être relancé en direct. */
+static uint8_t tx_ll_armed=0;
+#endif
+
+/** @brief Nombre d'octets réservés par serial_tx_reserve() en attente de commit. */
+static uint16_t tx_reserved=0;
+
+#if SERIAL_TX_COBS
+/** @brief Décalage de la trame brute réservée par rapport à tx_head (place des codes COBS). */
+static uint16_t tx_cobs_skip=0;
+#endif
+
+/** @brief Nombre de trames refusées faute de place dans le buffer TX. */
+static uint32_t tx_dropped=0;
+
+/** @brief Remplissage maximal observé du buffer TX (octets en attente d'émission). */
+static uint32_t tx_high_water=0;
+
 /**
  * @brief  Retourne le nombre d'octets en attente d'émission dans le buffer TX.
  * @return Nombre d'octets occupés.
@@ -85,69 +272,371 @@ static inline uint32_t tx_count(void){return (tx_head-tx_tail)&TX_RING_MASK;}
 static inline uint32_t tx_space(void){return TX_RING_MASK-tx_count();}
 
 /**
- * @brief  Déclenche le transfert DMA pour l'émission si nécessaire.
- * @details Cette fonction vérifie si le DMA est libre et s'il y a des données à envoyer.
- * Elle gère le découpage mémoire si les données bouclent à la fin du buffer (wrap-around).
- * Section critique protégée par désactivation des interruptions.
+ * @brief  Publie de nouveaux octets dans le ring principal.
+ * @details En mode prioritaire, la nouvelle tête est aussi une frontière de trame : liste
+ * pleine, elle remplace la dernière frontière (deux publications fusionnées).
+ * @param  head Nouvelle tête.
  */
-static void serial_kick_tx(void){
+static inline void tx_publish(uint32_t head){
+#if SERIAL_TX_PRIORITY
     __disable_irq();
-    if(tx_busy){
-        __enable_irq();
-        return;
+    tx_head=head;
+    uint32_t bh=tx_bound_head;
+    if(bh-tx_bound_tail>=SERIAL_TX_BOUNDS){
+        tx_bound[(bh-1u)&TX_BOUND_MASK]=(uint16_t)head;
     }
+    else{
+        tx_bound[bh&TX_BOUND_MASK]=(uint16_t)head;
+        tx_bound_head=bh+1u;
+    }
+    __enable_irq();
+#else
+    tx_head=head;
+#endif
+}
+
+/**
+ * @brief  Choisit le prochain bloc à confier au DMA (canal TX réservé par l'appelant).
+ * @details Mode prioritaire : file prioritaire d'abord si le ring principal est à une
+ * frontière de trame ; sinon ring principal, coupé à la dernière frontière tenant dans
+ * SERIAL_TX_BULK_CHUNK (au moins une trame entière, rebouclage du ring excepté).
+ * Mode FIFO : tout le bloc linéaire disponible.
+ * @param  src Sortie : début du bloc.
+ * @return Longueur du bloc, 0 si rien à émettre.
+ */
+MEM_RAMFUNC static uint16_t tx_next_chunk(const uint8_t **src){
+#if SERIAL_TX_PRIORITY
+    uint32_t ch=tx_ctrl_head, ct=tx_ctrl_tail;
+    if(ch!=ct&&!tx_mid_frame){
+        tx_inflight_ctrl=1;
+        *src=&tx_ctrl_ring[ct];
+        return(uint16_t)((ch>ct)?(ch-ct):(SERIAL_TX_CTRL_SIZE-ct));
+    }
+    tx_inflight_ctrl=0;
+#endif
+
     uint32_t head=tx_head, tail=tx_tail;
-    if(head==tail){
-        __enable_irq();
+    if(head==tail)return 0;
+
+    uint32_t linear=(head>tail)?(head-tail):(SERIAL_TX_RING_SIZE-tail);
+    uint32_t chunk=linear;
+
+#if SERIAL_TX_PRIORITY
+    const uint32_t limit=(linear<SERIAL_TX_BULK_CHUNK)?linear:SERIAL_TX_BULK_CHUNK;
+    uint32_t first=0, best=0;
+    for(uint32_t i=tx_bound_tail;i!=tx_bound_head;i++){
+        uint32_t d=(tx_bound[i&TX_BOUND_MASK]-tail)&TX_RING_MASK;
+        if(d==0)continue;
+        if(d>linear)break;
+        if(first==0)first=d;
+        if(d>limit)break;
+        best=d;
+    }
+    if(best!=0)chunk=best;
+    else if(first!=0)chunk=first;
+    tx_mid_frame=(best==0&&first==0&&((tail+chunk)&TX_RING_MASK)!=head)?1u:0u;
+#endif
+
+    *src=&tx_ring[tail];
+    return(uint16_t)((chunk>SERIAL_TX_CHUNK_MAX)?SERIAL_TX_CHUNK_MAX:chunk);
+}
+
+/**
+ * @brief  Acquitte le bloc DMA terminé (interruption de fin de transfert).
+ */
+static inline void tx_chunk_done(void){
+    const uint32_t len=tx_inflight;
+#if SERIAL_TX_PRIORITY
+    if(tx_inflight_ctrl){
+        tx_ctrl_tail=(tx_ctrl_tail+len)&TX_CTRL_MASK;
         return;
     }
+    const uint32_t old=tx_tail;
+    uint32_t bt=tx_bound_tail;
+    while(bt!=tx_bound_head&&((tx_bound[bt&TX_BOUND_MASK]-old)&TX_RING_MASK)<=len)bt++;
+    tx_bound_tail=bt;
+#endif
+    tx_tail=(tx_tail+len)&TX_RING_MASK;
+}
+
+/** @brief Met à jour le remplissage maximal du buffer TX (après publication de tx_head). */
+static inline void tx_high_water_update(void){
+    uint32_t count=tx_count();
+    if(count>tx_high_water)tx_high_water=count;
+}
+
+#if SERIAL_TX_COBS
+/**
+ * @brief  Encode en COBS, sur place, une trame déposée dans un ring.
+ * @details La trame brute occupe `len` octets à partir de start+skip, avec
+ * skip = SERIAL_COBS_OVERHEAD(len)-1 : l'écriture encodée, qui ne prend d'avance
+ * qu'un code par bloc de 254 octets, ne rattrape jamais la lecture. Un 0x00 ferme la
+ * trame encodée.
+ * @param  ring Ring (taille puissance de 2).
+ * @param  mask Masque du ring.
+ * @param  start Index du premier octet encodé.
+ * @param  skip Décalage de la trame brute.
+ * @param  len  Longueur de la trame brute.
+ * @return Longueur encodée, délimiteur compris (au plus len+skip+1).
+ */
+static uint32_t tx_cobs_encode(uint8_t *ring,uint32_t mask,uint32_t start,uint32_t skip,uint32_t len){
+    uint32_t in=start+skip;
+    const uint32_t end=in+len;
+    uint32_t code_at=start, out=start+1u;
+    uint8_t code=1u;
+
+    for(;in!=end;in++){
+        const uint8_t b=ring[in&mask];
+        if(b!=0u){
+            ring[out&mask]=b;
+            out++;
+            if(++code!=0xFFu)continue;
+        }
+        ring[code_at&mask]=code;
+        code_at=out++;
+        code=1u;
+    }
+    ring[code_at&mask]=code;
+    ring[out&mask]=0u;
+    return out+1u-start;
+}
+#endif
 
-    uint32_t linear=(head>=tail)?(head-tail):(TX_RING_SIZE-tail);
-    uint16_t chunk=(linear>SERIAL_TX_CHUNK_MAX)?SERIAL_TX_CHUNK_MAX:(uint16_t)linear;
+#if SERIAL_TX_LL_CHAIN || SERIAL_TX_LL_KICK
+/**
+ * @brief  Relance directement le canal DMA TX sur le bloc suivant du ring.
+ * @details Appelée en interruption de fin de transfert ou par serial_kick_tx(), une fois
+ * le canal configuré par un premier HAL_UART_Transmit_DMA() (CPAR, callbacks) :
+ * reprogramme CMAR/CNDTR, réactive les interruptions DMA (coupées par
+ * HAL_DMA_IRQHandler) et la requête DMAT de l'USART. La fin de ce transfert repasse
+ * par les mêmes callbacks HAL (UART_DMATransmitCplt puis TC) que HAL_UART_Transmit_DMA().
+ * @param  src  Début du bloc (tx_ring ou file prioritaire).
+ * @param  len  Nombre d'octets à émettre.
+ */
+static void serial_tx_chain_ll(const uint8_t *src,uint16_t len){
+    UART_HandleTypeDef *huart=&SERIAL_UART;
+    DMA_HandleTypeDef *hdma=huart->hdmatx;
 
     tx_busy=1;
+    tx_inflight=len;
+    huart->gState=HAL_UART_STATE_BUSY_TX;
 
-    if(HAL_UART_Transmit_DMA(&SERIAL_UART, &tx_ring[tail], chunk) != HAL_OK){
+    __HAL_DMA_DISABLE(hdma);
+    hdma->DmaBaseAddress->IFCR=(DMA_ISR_GIF1<<(hdma->ChannelIndex&0x1CU));
+    hdma->Instance->CMAR=(uint32_t)src;
+    hdma->Instance->CNDTR=len;
+    __HAL_DMA_ENABLE_IT(hdma,DMA_IT_TC|DMA_IT_TE);
+    __HAL_DMA_ENABLE(hdma);
+
+    __HAL_UART_CLEAR_FLAG(huart,UART_CLEAR_TCF);
+    ATOMIC_SET_BIT(huart->Instance->CR3,USART_CR3_DMAT);
+}
+#endif
+
+/**
+ * @brief  Déclenche le transfert DMA pour l'émission si nécessaire.
+ * @details Cette fonction vérifie si le DMA est libre et s'il y a des données à envoyer.
+ * Le bloc est choisi par tx_next_chunk() ; il s'arrête au plus tard à la fin physique
+ * du buffer (wrap-around) : la partie rebouclée part au transfert suivant.
+ * @note   Seul le test-and-set de `tx_busy` est protégé (Cortex-M0+ sans LDREX/STREX) :
+ * une fois le canal réservé, aucun transfert n'est en vol et l'interruption de fin
+ * ne peut pas concurrencer la suite ; le démarrage DMA se fait interruptions actives.
+ * Avec SERIAL_TX_LL_KICK, seul le premier démarrage passe par la HAL.
+ */
+MEM_RAMFUNC static void serial_kick_tx(void){
+    __disable_irq();
+    uint8_t busy=tx_busy;
+    tx_busy=1;
+    __enable_irq();
+
+    if(busy)return;
+
+    const uint8_t *src;
+    uint16_t chunk=tx_next_chunk(&src);
+    if(chunk==0){
         tx_busy=0;
+        return;
     }
 
-    __enable_irq();
+#if SERIAL_TX_LL_KICK
+    if(tx_ll_armed && SERIAL_UART.gState==HAL_UART_STATE_READY){
+        serial_tx_chain_ll(src,chunk);
+        return;
+    }
+#endif
+
+    tx_inflight=chunk;
+
+    if(HAL_UART_Transmit_DMA(&SERIAL_UART, (uint8_t*)src, chunk) != HAL_OK){
+        tx_busy=0;
+        return;
+    }
+#if SERIAL_TX_LL_KICK
+    tx_ll_armed=1;
+#endif
 }
 
 /**
- * @brief  Initialise le driver Série.
- * @details Lance la réception DMA en mode "ReceiveToIdle" pour détecter les fins de trames
- * sans attendre que le buffer soit plein.
+ * @brief  Applique le mode FIFO et les seuils de l'UART (SERIAL_UART_FIFO).
+ * @details À appeler l'UART au repos, avant le démarrage de la réception : chaque appel
+ * HAL désactive puis réactive l'USART.
+ * @return 0 si succès, -1 si la HAL refuse.
  */
-void serial_init(void){
+static int serial_fifo_apply(void){
+#if SERIAL_UART_FIFO
+    if(HAL_UARTEx_SetTxFifoThreshold(&SERIAL_UART,SERIAL_UART_TXFT)!=HAL_OK)return -1;
+    if(HAL_UARTEx_SetRxFifoThreshold(&SERIAL_UART,SERIAL_UART_RXFT)!=HAL_OK)return -1;
+    if(HAL_UARTEx_EnableFifoMode(&SERIAL_UART)!=HAL_OK)return -1;
+#else
+    if(HAL_UARTEx_DisableFifoMode(&SERIAL_UART)!=HAL_OK)return -1;
+#endif
+    return 0;
+}
+
+/**
+ * @brief  Active le receiver timeout et la détection de PROTO_SYNC (SERIAL_RX_HW_FRAMING).
+ * @details ADD ne s'écrit qu'USART désactivé ; à réappliquer après HAL_UART_Init().
+ */
+static void serial_rx_framing_apply(void){
+#if SERIAL_RX_ZERO_COPY && SERIAL_RX_HW_FRAMING
+    USART_TypeDef *u=SERIAL_UART.Instance;
+
+    __HAL_UART_DISABLE(&SERIAL_UART);
+#if SERIAL_CMD_FRAMED
+    MODIFY_REG(u->CR2,USART_CR2_ADD,(uint32_t)PROTO_SYNC<<USART_CR2_ADD_Pos);
+#endif
+    WRITE_REG(u->RTOR,SERIAL_RX_RTO_BITS);
+    SET_BIT(u->CR2,USART_CR2_RTOEN);
+    u->ICR=USART_ICR_RTOCF|USART_ICR_CMCF;
+#if SERIAL_CMD_FRAMED
+    SET_BIT(u->CR1,USART_CR1_RTOIE|USART_CR1_CMIE);
+#else
+    SET_BIT(u->CR1,USART_CR1_RTOIE);
+#endif
+    __HAL_UART_ENABLE(&SERIAL_UART);
+#endif
+}
+
+/**
+ * @brief  Démarre la réception DMA circulaire continue.
+ * @details Appelée une seule fois à l'initialisation, puis uniquement si la HAL a
+ * interrompu la réception sur erreur bloquante (overrun). Les index repartent de 0.
+ * Mode zero-copy : réception circulaire permanente sur rx_ring (le consommateur lit la
+ * position via NDTR), interruptions DMA de demi-transfert et de fin de transfert
+ * seulement avec SERIAL_RX_HALF_XFER.
+ * Sinon : réception "ReceiveToIdle" circulaire dans rx_chunk, signalée sur IDLE/TC, et
+ * sur HT avec SERIAL_RX_HALF_XFER ; recopie par le consommateur (rx_drain()).
+ * La FIFO RX est vidée au préalable : après un overrun ou un changement de débit, les
+ * octets en attente appartiennent à une trame déjà perdue.
+ */
+static void serial_rx_start(void){
+    __HAL_UART_SEND_REQ(&SERIAL_UART,UART_RXDATA_FLUSH_REQUEST);
+    rx_scan_len=0;
+#if SERIAL_RX_ZERO_COPY
+    rx_tail=0;
+#if SERIAL_RX_HW_FRAMING
+    rx_frame_head=0;
+#endif
+    HAL_UART_Receive_DMA(&SERIAL_UART,rx_ring,SERIAL_RX_RING_SIZE);
+#if !SERIAL_RX_HALF_XFER
+    __HAL_DMA_DISABLE_IT(SERIAL_UART.hdmarx,DMA_IT_HT|DMA_IT_TC);
+#endif
+#else
+    rx_old_pos=0;
     HAL_UARTEx_ReceiveToIdle_DMA(&SERIAL_UART,rx_chunk,SERIAL_RX_CHUNK_SIZE);
+#if !SERIAL_RX_HALF_XFER
     __HAL_DMA_DISABLE_IT(SERIAL_UART.hdmarx,DMA_IT_HT);
+#endif
+#endif
 }
 
+/**
+ * @brief  Initialise le driver Série.
+ * @details Configure les FIFO de l'UART (serial_fifo_apply()) puis lance une fois pour
+ * toutes la réception DMA circulaire (cf. serial_rx_start()).
+ */
+void serial_init(void){
+    crc8_init();
+    (void)serial_fifo_apply();
+    serial_rx_framing_apply();
+    serial_rx_start();
+}
+
+/**
+ * @brief  Indique si toute l'émission est terminée (ring vide, DMA libre, dernier octet sorti).
+ * @return 1 si la ligne TX est au repos, 0 sinon.
+ */
+uint8_t serial_tx_idle(void){
+    if(tx_busy||tx_head!=tx_tail)return 0;
+#if SERIAL_TX_PRIORITY
+    if(tx_ctrl_head!=tx_ctrl_tail)return 0;
+#endif
+    return(__HAL_UART_GET_FLAG(&SERIAL_UART,UART_FLAG_TC)!=RESET)?1u:0u;
+}
+
+/**
+ * @brief  Change le débit de la liaison série.
+ * @details Abandonne les transferts en cours, ré-applique la configuration UART
+ * (BRR) et le mode FIFO, puis relance la réception circulaire. Les octets RX non lus
+ * sont perdus.
+ * @param  baud Nouveau débit (bauds).
+ * @return 0 si succès, -1 si une émission est encore en cours ou si la HAL refuse.
+ */
+int serial_set_baud(uint32_t baud){
+    if(!serial_tx_idle())return -1;
+
+    HAL_UART_Abort(&SERIAL_UART);
+#if SERIAL_TX_LL_KICK
+    tx_ll_armed=0;
+#endif
+    SERIAL_UART.Init.BaudRate=baud;
+    if(HAL_UART_Init(&SERIAL_UART)!=HAL_OK)return -1;
+    if(serial_fifo_apply()!=0)return -1;
+    serial_rx_framing_apply();
+
+    serial_rx_start();
+    DLOG1(DLOG_SERIAL_BAUD,baud);
+    return 0;
+}
+
+/**
+ * @brief  Retourne le débit courant de la liaison série.
+ * @return Débit en bauds.
+ */
+uint32_t serial_get_baud(void){return SERIAL_UART.Init.BaudRate;}
+
 /**
  * @brief  Écrit des données dans le buffer d'émission (Non-bloquant partiel).
- * @note   Copie autant de données que possible. S'arrête si le buffer est plein.
+ * @note   Copie autant de données que possible. S'arrête si le buffer est plein ;
+ * une écriture tronquée ou refusée est comptabilisée dans serial_tx_dropped().
  * @param  data Pointeur vers les données.
  * @param  len  Nombre d'octets à écrire.
  * @return Nombre d'octets réellement écrits ou code d'erreur négatif.
  */
 int serial_write_nb(const uint8_t *data,uint16_t len){
+#if SERIAL_TX_COBS
+    return serial_write_all_nb(data,len);
+#else
     uint16_t written=0;
     while(written<len){
         uint32_t space=tx_space();
-        if(space==0)return(written>0)?(int)written:-EWOULDBLOCK;
         uint32_t head=tx_head;
-        uint32_t room_linear=(head>=tx_tail)?(TX_RING_SIZE-head-((tx_tail==0)?1u:0u)):(tx_tail-head-1u);
-        if(room_linear==0)return(written>0)?(int)written:-EWOULDBLOCK;
+        uint32_t room_linear=(head>=tx_tail)?(SERIAL_TX_RING_SIZE-head-((tx_tail==0)?1u:0u)):(tx_tail-head-1u);
+        if(space==0||room_linear==0)break;
         uint32_t to_copy=len-written;
         if(to_copy>room_linear)to_copy=room_linear;
         if(to_copy>space)to_copy=space;
         memcpy(&tx_ring[head],&data[written],to_copy);
-        tx_head=(head+to_copy)&TX_RING_MASK;
+        __DMB();
+        tx_publish((head+to_copy)&TX_RING_MASK);
         written+=(uint16_t)to_copy;
     }
+    if(written<len)tx_dropped++;
+    if(written==0&&len>0)return -EWOULDBLOCK;
+    tx_high_water_update();
     serial_kick_tx();
     return(int)written;
+#endif
 }
 
 /**
@@ -157,19 +646,113 @@ int serial_write_nb(const uint8_t *data,uint16_t len){
  * @return len si succès, -EWOULDBLOCK si pas assez d'espace.
  */
 int serial_write_all_nb(const uint8_t *data,uint16_t len){
-    if(tx_space()<len)return -EWOULDBLOCK;
-    uint32_t head=tx_head;
-    uint32_t first=(head>=tx_tail)?(TX_RING_SIZE-head-((tx_tail==0)?1u:0u)):(tx_tail-head-1u);
-    if(first>len)first=len;
-    memcpy(&tx_ring[head],data,first);
-    tx_head=(head+first)&TX_RING_MASK;
-    uint16_t remain=len-(uint16_t)first;
-    if(remain){
-        memcpy(&tx_ring[tx_head],data+first,remain);
-        tx_head=(tx_head+remain)&TX_RING_MASK;
+    serial_tx_span_t span;
+    if(serial_tx_reserve(len,&span)!=0)return -EWOULDBLOCK;
+    serial_tx_span_copy(&span,data);
+    serial_tx_commit();
+    return(int)len;
+}
+
+/**
+ * @brief  Écrit une trame dans la file prioritaire, seulement si elle y entre en entier.
+ * @details Mode FIFO (SERIAL_TX_PRIORITY à 0) : même chose que serial_write_all_nb().
+ * @param  data Pointeur vers la trame.
+ * @param  len  Nombre d'octets.
+ * @return len si succès, -EWOULDBLOCK si pas assez d'espace.
+ */
+int serial_write_ctrl_nb(const uint8_t *data,uint16_t len){
+#if SERIAL_TX_PRIORITY
+    uint32_t head=tx_ctrl_head;
+    uint32_t space=TX_CTRL_MASK-((head-tx_ctrl_tail)&TX_CTRL_MASK);
+#if SERIAL_TX_COBS
+    const uint32_t skip=SERIAL_COBS_OVERHEAD(len)-1u;
+#else
+    const uint32_t skip=0u;
+#endif
+    if(len==0||len+skip+(SERIAL_TX_COBS?1u:0u)>space){
+        tx_dropped++;
+        return -EWOULDBLOCK;
     }
+    const uint32_t at=(head+skip)&TX_CTRL_MASK;
+    uint32_t first=SERIAL_TX_CTRL_SIZE-at;
+    if(first>len)first=len;
+    memcpy(&tx_ctrl_ring[at],data,first);
+    memcpy(tx_ctrl_ring,data+first,len-first);
+#if SERIAL_TX_COBS
+    const uint32_t used=tx_cobs_encode(tx_ctrl_ring,TX_CTRL_MASK,head,skip,len);
+#else
+    const uint32_t used=len;
+#endif
+    __DMB();
+    tx_ctrl_head=(head+used)&TX_CTRL_MASK;
     serial_kick_tx();
     return(int)len;
+#else
+    return serial_write_all_nb(data,len);
+#endif
+}
+
+/**
+ * @brief  Réserve `len` octets directement dans le buffer d'émission.
+ * @details La zone peut être coupée en deux par la fin physique du ring : `p2`/`len2`
+ * décrivent alors la partie rebouclée en début de buffer (sinon `len2` = 0).
+ * Une seule réservation peut être ouverte à la fois (producteur unique).
+ * @param  len  Nombre d'octets à réserver.
+ * @param  span Sortie : zone(s) réservée(s).
+ * @return 0 si succès, -EWOULDBLOCK si pas assez d'espace.
+ */
+int serial_tx_reserve(uint16_t len,serial_tx_span_t *span){
+    if(len==0)return -EWOULDBLOCK;
+#if SERIAL_TX_COBS
+    const uint32_t skip=SERIAL_COBS_OVERHEAD(len)-1u;
+    if(tx_space()<len+skip+1u){
+#else
+    const uint32_t skip=0u;
+    if(tx_space()<len){
+#endif
+        tx_dropped++;
+        return -EWOULDBLOCK;
+    }
+    uint32_t head=(tx_head+skip)&TX_RING_MASK;
+    uint32_t first=SERIAL_TX_RING_SIZE-head;
+    if(first>len)first=len;
+    span->p1=&tx_ring[head];
+    span->len1=(uint16_t)first;
+    span->p2=(first<len)?&tx_ring[0]:NULL;
+    span->len2=(uint16_t)(len-first);
+    tx_reserved=len;
+#if SERIAL_TX_COBS
+    tx_cobs_skip=(uint16_t)skip;
+#endif
+    return 0;
+}
+
+/**
+ * @brief  Copie un bloc dans une zone réservée (gère la coupure du ring).
+ * @param  span Zone réservée par serial_tx_reserve().
+ * @param  data Données à copier (len1 + len2 octets).
+ */
+void serial_tx_span_copy(const serial_tx_span_t *span,const void *data){
+    const uint8_t *src=(const uint8_t*)data;
+    memcpy(span->p1,src,span->len1);
+    if(span->len2)memcpy(span->p2,src+span->len1,span->len2);
+}
+
+/**
+ * @brief  Publie la zone réservée et déclenche l'émission DMA.
+ */
+void serial_tx_commit(void){
+    if(!tx_reserved)return;
+#if SERIAL_TX_COBS
+    const uint32_t used=tx_cobs_encode(tx_ring,TX_RING_MASK,tx_head,tx_cobs_skip,tx_reserved);
+#else
+    const uint32_t used=tx_reserved;
+#endif
+    __DMB();
+    tx_publish((tx_head+used)&TX_RING_MASK);
+    tx_reserved=0;
+    tx_high_water_update();
+    serial_kick_tx();
 }
 
 /**
@@ -184,8 +767,11 @@ int serial_write(const uint8_t *data,uint16_t len){
     return(r>=0)?0:-1;
 }
 
+#if !RTT_ENABLE && !CONSOLE_ENABLE
 /**
  * @brief  Fonction système bas niveau pour rediriger printf().
+ * @note   Avec CONSOLE_ENABLE, la sortie standard part sur la console (console.c) ; avec
+ * RTT_ENABLE, sur la voie terminal RTT (rtt.c).
  * @param  file Descripteur de fichier (ignoré).
  * @param  ptr  Données à écrire.
  * @param  len  Longueur.
@@ -196,6 +782,7 @@ int _write(int file,char *ptr,int len){
     int r=serial_write_all_nb((const uint8_t*)ptr,(uint16_t)len);
     return(r>=0)?r:-1;
 }
+#endif
 
 /**
  * @brief  Vérifie le nombre d'octets disponibles à la lecture.
@@ -204,117 +791,405 @@ int _write(int file,char *ptr,int len){
 size_t serial_available(void){return ring_count();}
 
 /**
- * @brief  Lit des données depuis le buffer RX.
- * @details Copie les données du buffer circulaire interne vers le buffer utilisateur.
- * Gère le cas où les données sont à cheval sur la fin du buffer (wrap).
- * @param  dst     Buffer de destination.
- * @param  max_len Nombre maximum d'octets à lire.
- * @return Nombre d'octets réellement lus.
+ * @brief  Recherche un octet dans un bloc, 32 bits à la fois.
+ * @details Octets de tête jusqu'à l'alignement, puis mots alignés : un mot contient
+ * l'octet cherché si x = mot ^ motif a un octet nul, détecté sans branchement par
+ * (x - 0x01010101) & ~x & 0x80808080. Le mot trouvé est repris octet par octet.
+ * @param  p Début du bloc.
+ * @param  n Longueur du bloc.
+ * @param  c Octet cherché.
+ * @return Index de la première occurrence, n si absente.
  */
-size_t serial_read(uint8_t *dst, size_t max_len){
-    __disable_irq();
+static size_t rx_find_byte(const uint8_t *p,size_t n,uint8_t c){
+    typedef uint32_t __attribute__((may_alias)) word_t;
+    const uint32_t pat=0x01010101u*c;
+    size_t i=0;
 
-    size_t avail = ring_count();
-    if(!avail || !max_len){
-        __enable_irq();
-        return 0;
+    while(i<n&&((uintptr_t)&p[i]&3u)!=0u){
+        if(p[i]==c)return i;
+        i++;
+    }
+    while(i+4u<=n){
+        const uint32_t x=*(const word_t*)&p[i]^pat;
+        if(((x-0x01010101u)&~x&0x80808080u)!=0u)break;
+        i+=4u;
+    }
+    while(i<n){
+        if(p[i]==c)return i;
+        i++;
     }
+    return n;
+}
+
+/**
+ * @brief  Décrit en place les `len` premiers octets non lus (au plus deux blocs).
+ * @param  tail Index de lecture.
+ * @param  len  Nombre d'octets (au plus ceux disponibles).
+ * @param  span Sortie : bloc(s).
+ */
+static void rx_span_fill(uint32_t tail,size_t len,serial_rx_span_t *span){
+    size_t first=SERIAL_RX_RING_SIZE-tail;
+    if(first>len)first=len;
+    span->p1=&rx_ring[tail];
+    span->len1=(uint16_t)first;
+    span->p2=(first<len)?&rx_ring[0]:NULL;
+    span->len2=(uint16_t)(len-first);
+}
+
+/**
+ * @brief  Donne accès en place à tous les octets reçus, rebouclage compris.
+ * @param  span Sortie : bloc(s) non lus (len1 + len2 octets).
+ * @return Nombre d'octets disponibles ; à libérer par serial_rx_consume().
+ */
+size_t serial_rx_peek_span(serial_rx_span_t *span){
+    const uint32_t tail=rx_tail;
+    const size_t avail=ring_count();
+
+    __DMB();
+    rx_span_fill(tail,avail,span);
+    return avail;
+}
 
-    size_t to_copy = (avail < max_len) ? avail : max_len;
-    size_t first = to_copy;
+/**
+ * @brief  Donne accès en place aux octets reçus jusqu'au délimiteur inclus.
+ * @details Le parcours reprend où le précédent s'était arrêté (même index de lecture,
+ * même délimiteur) : un flux qui grandit sans délimiteur est parcouru une seule fois au
+ * total, et non depuis rx_tail à chaque appel. Recherche 32 bits à la fois
+ * (rx_find_byte()), sur chacun des deux blocs contigus.
+ * @param  delim Délimiteur.
+ * @param  span  Sortie : bloc(s) du message, délimiteur compris.
+ * @return Longueur du message (délimiteur compris), 0 si le délimiteur n'est pas encore
+ * reçu ; à libérer par serial_rx_consume().
+ */
+size_t serial_rx_peek_until(uint8_t delim,serial_rx_span_t *span){
+    const uint32_t tail=rx_tail;
+    const size_t avail=ring_count();
 
-    if(rx_tail + first > SERIAL_RX_RING_SIZE) {
-        first = SERIAL_RX_RING_SIZE - rx_tail;
+    if(tail!=rx_scan_tail||delim!=rx_scan_delim||rx_scan_len>avail){
+        rx_scan_tail=tail;
+        rx_scan_delim=delim;
+        rx_scan_len=0;
     }
+    __DMB();
+
+    while(rx_scan_len<avail){
+        const uint32_t from=(tail+rx_scan_len)&RING_MASK;
+        size_t run=SERIAL_RX_RING_SIZE-from;
+        if(run>avail-rx_scan_len)run=avail-rx_scan_len;
 
-    memcpy(dst, &rx_ring[rx_tail], first);
-    if(first < to_copy) {
-        memcpy(dst + first, &rx_ring[0], to_copy - first);
+        const size_t k=rx_find_byte(&rx_ring[from],run,delim);
+        if(k<run){
+            const size_t msg_len=rx_scan_len+k+1u;
+            rx_scan_len=0;
+            rx_scan_tail=(tail+msg_len)&RING_MASK;   // Parcours suivant : après le message
+            rx_span_fill(tail,msg_len,span);
+            return msg_len;
+        }
+        rx_scan_len+=(uint32_t)run;
     }
+    return 0;
+}
 
-    rx_tail = (rx_tail + to_copy) & RING_MASK;
+/**
+ * @brief  Copie un bloc décrit par serial_rx_peek_span() / serial_rx_peek_until().
+ * @param  dst  Destination.
+ * @param  span Bloc(s) source.
+ * @param  len  Octets à copier (au plus len1 + len2).
+ */
+static void rx_span_copy(uint8_t *dst,const serial_rx_span_t *span,size_t len){
+    const size_t first=(len<span->len1)?len:span->len1;
+    memcpy(dst,span->p1,first);
+    if(len>first){
+        memcpy(dst+first,span->p2,len-first);
+    }
+}
 
-    __enable_irq();
+/**
+ * @brief  Lit des données depuis le buffer RX.
+ * @details Copie les données du buffer circulaire interne vers le buffer utilisateur
+ * (deux memcpy au plus, rebouclage compris), sans section critique : l'index de lecture
+ * n'appartient qu'au consommateur. Pour un traitement en place, voir serial_rx_peek_span().
+ * @param  dst     Buffer de destination.
+ * @param  max_len Nombre maximum d'octets à lire.
+ * @return Nombre d'octets réellement lus.
+ */
+size_t serial_read(uint8_t *dst, size_t max_len){
+    serial_rx_span_t span;
+    size_t n = serial_rx_peek_span(&span);
 
-    return to_copy;
+    if(n > max_len){
+        n = max_len;
+    }
+    if(n == 0){
+        return 0;
+    }
+    rx_span_copy(dst, &span, n);
+    serial_rx_consume(n);
+    return n;
 }
 
 /**
  * @brief  Lit des données jusqu'à rencontrer un délimiteur.
- * @note   Fonction utile pour lire des lignes complètes (ex: jusqu'à '\\n').
+ * @note   Fonction utile pour lire des lignes complètes (ex: jusqu'à '\\n'). Temps
+ * linéaire sur un message reçu par morceaux (cf. serial_rx_peek_until()).
  * @param  dst     Buffer de destination.
  * @param  max_len Taille max du buffer destination.
  * @param  delim   Caractère délimiteur recherché.
- * @return Nombre d'octets lus (incluant le délimiteur), ou 0 si non trouvé.
+ * @return Nombre d'octets lus (incluant le délimiteur), ou 0 si non trouvé ou si le
+ * message dépasse max_len (il reste alors dans le buffer).
  */
 size_t serial_read_until(uint8_t *dst,size_t max_len,uint8_t delim){
-    if(!max_len)return 0;
-    uint32_t head=rx_head,tail=rx_tail;
+    serial_rx_span_t span;
+    const size_t msg_len=serial_rx_peek_until(delim,&span);
+
+    if(msg_len==0||msg_len>max_len)return 0;
+    rx_span_copy(dst,&span,msg_len);
+    serial_rx_consume(msg_len);
+    return msg_len;
+}
+
+/**
+ * @brief  Donne accès en place au plus long bloc contigu d'octets reçus.
+ * @details Le bloc s'arrête à la tête d'écriture ou à la fin physique du buffer ;
+ * un second appel après serial_rx_consume() renvoie la partie rebouclée.
+ * @param  span Sortie : pointeur vers le premier octet non lu.
+ * @return Nombre d'octets contigus disponibles.
+ */
+size_t serial_rx_peek(const uint8_t **span){
+    uint32_t head=rx_head_get(),tail=rx_tail;
+    uint32_t count=(head-tail)&RING_MASK;
+    if(count>rx_high_water)rx_high_water=count;
+    *span=&rx_ring[tail];
     if(head==tail)return 0;
-    uint32_t i=tail;
-    while(i!=head){
-        if(rx_ring[i]==delim){
-            size_t msg_len=(i>=tail)?(i-tail+1u):(SERIAL_RX_RING_SIZE-tail+i+1u);
-            if(msg_len>max_len)return 0;
-            size_t first=msg_len;
-            if(tail+first>SERIAL_RX_RING_SIZE)first=SERIAL_RX_RING_SIZE-tail;
-            memcpy(dst,&rx_ring[tail],first);
-            if(first<msg_len)memcpy(dst+first,&rx_ring[0],msg_len-first);
-            rx_tail=(tail+msg_len)&RING_MASK;
-            return msg_len;
-        }
-        i=(i+1u)&RING_MASK;
+    return(head>tail)?(head-tail):(SERIAL_RX_RING_SIZE-tail);
+}
+
+/**
+ * @brief  Donne accès en place aux octets reçus jusqu'à la dernière frontière de trame.
+ * @details Sans frontière relevée, rien n'est rendu tant que moins de SERIAL_RX_FRAME_MAX
+ * octets attendent : l'interruption RTO ou CM suivante les libère. Au-delà (flux continu
+ * sans PROTO_SYNC), tout est rendu, le parseur gardant les trames partielles.
+ * @param  span Sortie : pointeur vers le premier octet non lu.
+ * @return Nombre d'octets contigus disponibles.
+ */
+size_t serial_rx_peek_frames(const uint8_t **span){
+#if SERIAL_RX_ZERO_COPY && SERIAL_RX_HW_FRAMING
+    size_t n=serial_rx_peek(span);
+    const uint32_t tail=rx_tail;
+    const uint32_t avail=(rx_head_get()-tail)&RING_MASK;
+    const uint32_t framed=(rx_frame_head-tail)&RING_MASK;
+
+    if(avail>=SERIAL_RX_FRAME_MAX){
+        return n;
+    }
+    if(framed>avail){
+        return 0;       // Frontière déjà consommée
+    }
+    return(n<framed)?n:framed;
+#else
+    return serial_rx_peek(span);
+#endif
+}
+
+/**
+ * @brief  Nombre d'octets de trames terminées en attente.
+ * @return Nombre d'octets (cf. serial_rx_peek_frames()).
+ */
+size_t serial_rx_frames_available(void){
+#if SERIAL_RX_ZERO_COPY && SERIAL_RX_HW_FRAMING
+    const uint32_t tail=rx_tail;
+    const uint32_t avail=ring_count();
+    const uint32_t framed=(rx_frame_head-tail)&RING_MASK;
+
+    if(avail>=SERIAL_RX_FRAME_MAX){
+        return avail;
+    }
+    return(framed>avail)?0u:framed;
+#else
+    return ring_count();
+#endif
+}
+
+/**
+ * @brief  Relève une frontière de trame signalée par l'USART (contexte interruption).
+ * @details RTOF : ligne silencieuse, tout ce qui est reçu est terminé. CMF : PROTO_SYNC
+ * reçu, la trame précédente est terminée. La position DMA est relevée sur NDTR.
+ */
+MEM_RAMFUNC void serial_uart_irq(void){
+#if SERIAL_RX_ZERO_COPY && SERIAL_RX_HW_FRAMING
+    USART_TypeDef *u=SERIAL_UART.Instance;
+    const uint32_t isr=u->ISR;
+
+    if(isr&(USART_ISR_RTOF|USART_ISR_CMF)){
+        u->ICR=USART_ICR_RTOCF|USART_ICR_CMCF;
+        rx_frame_head=(SERIAL_RX_RING_SIZE-__HAL_DMA_GET_COUNTER(SERIAL_UART.hdmarx))&RING_MASK;
+        rx_event_us=GetMicrosTotal();
+        sched_wake_from_isr();
     }
+#endif
+}
+
+/**
+ * @brief  Libère des octets lus en place via serial_rx_peek().
+ * @param  len Nombre d'octets consommés (au plus la valeur retournée par serial_rx_peek()).
+ */
+void serial_rx_consume(size_t len){
+    __DMB();
+    rx_tail=(rx_tail+len)&RING_MASK;
+}
+
+/**
+ * @brief  Retourne le nombre d'octets reçus perdus faute de place.
+ * @note   Toujours 0 en mode zero-copy (le DMA écrase les données non lues sans le signaler).
+ * @return Compteur cumulé depuis le démarrage.
+ */
+uint32_t serial_rx_dropped(void){
+#if SERIAL_RX_ZERO_COPY
     return 0;
+#else
+    return rx_dropped;
+#endif
+}
+
+/**
+ * @brief  Retourne le nombre de trames refusées faute de place dans le buffer TX.
+ * @note   Comptabilisé dans serial_tx_reserve(), donc pour toute émission (télémétrie,
+ * réponses, printf) : une trame refusée n'est jamais émise partiellement. Les
+ * écritures tronquées de serial_write_nb() sont aussi comptées.
+ * @return Compteur cumulé depuis le démarrage.
+ */
+uint32_t serial_tx_dropped(void){
+    return tx_dropped;
+}
+
+/**
+ * @brief  Remplissage maximal observé du buffer RX.
+ * @note   Relevé à chaque consultation par le consommateur : en mode zero-copy, une
+ * valeur proche de SERIAL_RX_RING_SIZE signale un risque d'écrasement par le DMA.
+ * @return Octets non lus au pire moment observé.
+ */
+uint32_t serial_rx_high_water(void){
+    return rx_high_water;
+}
+
+/**
+ * @brief  Remplissage maximal observé du buffer TX.
+ * @note   Relevé à chaque publication de données (serial_tx_commit, serial_write_nb).
+ * @return Octets en attente d'émission au pire moment observé.
+ */
+uint32_t serial_tx_high_water(void){
+    return tx_high_water;
+}
+
+/**
+ * @brief  Place libre dans le buffer TX (télémétrie).
+ * @note   Le ring prioritaire des réponses n'est pas compté : c'est la place dont
+ * dispose le producteur de télémétrie pour régler sa cadence.
+ * @return Octets pouvant encore être déposés sans refus.
+ */
+uint32_t serial_tx_free(void){
+    return tx_space();
+}
+
+/**
+ * @brief  Retourne le nombre de débordements matériels de l'UART (overrun).
+ * @note   Octet reçu alors que le précédent n'avait pas été transféré par le DMA.
+ * @return Compteur cumulé depuis le démarrage.
+ */
+uint32_t serial_rx_overruns(void){
+    return rx_overruns;
+}
+
+/**
+ * @brief  Retourne la date de la dernière arrivée d'octets.
+ * @note   Mode zero-copy : date de la première lecture de la tête DMA qui a vu les
+ * octets (boucle principale). Sinon : date de l'événement IDLE/TC, un caractère
+ * après le dernier octet reçu.
+ * @return Date en µs (GetMicrosTotal).
+ */
+uint32_t serial_rx_last_us(void){
+    return rx_event_us;
 }
 
 /**
  * @brief  Callback HAL appelé quand un transfert DMA TX est terminé.
- * @details Met à jour l'index de queue TX et relance une transmission si
- * il reste des données dans le buffer.
+ * @details Acquitte le bloc émis et relance une transmission s'il reste des données
+ * dans l'une des files (directement sur le canal DMA si SERIAL_TX_LL_CHAIN, sinon
+ * via serial_kick_tx()).
  * @param  huart Handle UART concerné.
  */
 void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart){
     if(huart!=&SERIAL_UART)return;
-    uint16_t sent=huart->TxXferSize;
-    tx_tail=(tx_tail+sent)&TX_RING_MASK;
+    tx_chunk_done();
     tx_busy=0;
+
+#if SERIAL_TX_LL_CHAIN
+    const uint8_t *src;
+    uint16_t len=tx_next_chunk(&src);
+    if(len!=0){
+        serial_tx_chain_ll(src,len);
+    }
+#else
     serial_kick_tx();
+#endif
 }
 
 /**
- * @brief  Callback HAL appelé lors d'un événement RX (Idle Line ou Transfer Complete).
- * @details Transfère les données du buffer DMA linéaire (rx_chunk) vers le
- * buffer circulaire logiciel (rx_ring).
- * @note   Gère la position précédente pour ne copier que les nouveaux octets reçus.
+ * @brief  Callback HAL appelé lors d'un événement RX (Idle Line, Half Transfer ou Transfer Complete).
+ * @details Seule la date de l'événement est relevée (serial_rx_last_us()) : il sert à
+ * réveiller la boucle principale (WFI) ou la tâche de scrutation (SCHED_RTOS), qui recopie les octets via rx_drain().
  * @param  huart Handle UART concerné.
- * @param  Size  Nombre total d'octets reçus dans le buffer DMA.
+ * @param  Size  Position courante d'écriture du DMA dans rx_chunk (non utilisée).
  */
-void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size){
+#if !SERIAL_RX_ZERO_COPY
+MEM_RAMFUNC void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size){
+    (void)huart;
+    (void)Size;
+    rx_event_us=GetMicrosTotal();
+    sched_wake_from_isr();
+}
+#elif SERIAL_RX_HALF_XFER
+/**
+ * @brief  Callback HAL de demi-transfert DMA RX (zero-copy) : moitié de rx_ring remplie.
+ * @details Date l'arrivée des octets et réveille le consommateur, comme RTO / CMF, pour
+ * un flux continu sans silence de ligne.
+ * @param  huart Handle UART concerné.
+ */
+MEM_RAMFUNC void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef *huart){
     if(huart != &SERIAL_UART) return;
+    rx_event_us=GetMicrosTotal();
+    sched_wake_from_isr();
+}
 
-    static uint16_t old_pos = 0;
+/**
+ * @brief  Callback HAL de fin de transfert DMA RX (zero-copy) : rebouclage de rx_ring.
+ * @param  huart Handle UART concerné.
+ */
+MEM_RAMFUNC void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart){
+    if(huart != &SERIAL_UART) return;
+    rx_event_us=GetMicrosTotal();
+    sched_wake_from_isr();
+}
+#endif
 
-    if(Size != old_pos){
-        if(Size > old_pos){
-            for(uint16_t k = old_pos; k < Size; k++){
-                ring_push(rx_chunk[k]);
-            }
-        }
-        else{
-            for(uint16_t k = old_pos; k < SERIAL_RX_CHUNK_SIZE; k++){
-                ring_push(rx_chunk[k]);
-            }
-            for(uint16_t k = 0; k < Size; k++){
-                ring_push(rx_chunk[k]);
-            }
-        }
-        old_pos = Size;
-    }
+/**
+ * @brief  Callback HAL d'erreur UART.
+ * @details Une erreur bloquante (overrun en réception DMA) fait abandonner la
+ * réception par la HAL : sa relance est différée à la prochaine lecture en boucle
+ * principale. Les erreurs non bloquantes (bruit, trame) laissent le DMA actif.
+ * @param  huart Handle UART concerné.
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart){
+    if(huart != &SERIAL_UART) return;
 
-    HAL_UARTEx_ReceiveToIdle_DMA(huart, rx_chunk, SERIAL_RX_CHUNK_SIZE);
+    if(huart->ErrorCode & HAL_UART_ERROR_ORE){
+        rx_overruns++;
+        DLOG1(DLOG_SERIAL_RX_OVERRUN, rx_overruns);
+    }
 
-    __HAL_DMA_DISABLE_IT(huart->hdmarx, DMA_IT_HT);
+    if(huart->RxState == HAL_UART_STATE_READY){
+        rx_restart_pending=1;
+    }
 }
 
 /**
@@ -324,14 +1199,7 @@ void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size){
  * @return Valeur du CRC calculé.
  */
 uint8_t serial_crc8_atm(const uint8_t *data,uint16_t len){
-    uint8_t crc=0x00u;
-    for(uint16_t i=0;i<len;i++){
-        crc^=data[i];
-        for(uint8_t b=0;b<8;b++){
-            crc=(crc&0x80u)?(uint8_t)((crc<<1)^0x07u):(uint8_t)(crc<<1);
-        }
-    }
-    return crc;
+    return crc8_compute(data,len);
 }
 
 /**
@@ -342,12 +1210,16 @@ uint8_t serial_crc8_atm(const uint8_t *data,uint16_t len){
  * @return Résultat de l'écriture série.
  */
 static int proto_send_frame3(uint8_t hdr,uint8_t d0,uint8_t d1){
-    uint8_t buf[4];
-    buf[0]=hdr;
-    buf[1]=d0;
-    buf[2]=d1;
-    buf[3]=serial_crc8_atm(buf,3);
-    return serial_write_all_nb(buf,4);
+    uint8_t buf[5];
+    uint8_t *f=buf;
+#if SERIAL_CMD_FRAMED
+    *f++=PROTO_SYNC;
+#endif
+    f[0]=hdr;
+    f[1]=d0;
+    f[2]=d1;
+    f[3]=serial_crc8_atm(f,3);
+    return serial_write_ctrl_nb(buf,PROTO_FRAME_LEN);
 }
 
 /**
@@ -362,6 +1234,59 @@ int proto_send_write16(uint8_t addr,int16_t value){
     return proto_send_frame3(hdr,(uint8_t)(u&0xFFu),(uint8_t)(u>>8));
 }
 
+/**
+ * @brief  Envoie la réponse groupée à une lecture de plusieurs registres.
+ * @details La trame complète est construite puis confiée au ring TX en une seule
+ * écriture : un seul CRC et un seul lancement DMA, quel que soit le nombre de registres.
+ * @param  addr   Adresse du premier registre.
+ * @param  values Valeurs des registres.
+ * @param  count  Nombre de registres.
+ * @return Résultat de l'envoi.
+ */
+int proto_send_data_burst(uint8_t addr,const int16_t *values,uint8_t count){
+#if SERIAL_TX_ENVELOPE
+    static uint8_t buf[PROTO_ENV_LEN(PROTO_ENV_MAX_REGS)];
+    int ret=0;
+    if(values==NULL||count==0||count>PROTO_BURST_RESP_MAX_REGS)return -1;
+    while(count>0u){
+        const uint8_t n=(count>PROTO_ENV_MAX_REGS)?(uint8_t)PROTO_ENV_MAX_REGS:count;
+        const uint16_t len=(uint16_t)PROTO_ENV_LEN(n);
+        buf[0]=0xAA;
+        buf[1]=0x55;
+        buf[2]=TELEM_TYPE_REG;
+        buf[3]=(uint8_t)(2u+2u*n);
+        buf[4]=PROTO_MAKE_HDR(1,addr);
+        buf[5]=n;
+        for(uint8_t i=0;i<n;i++){
+            uint16_t u=(uint16_t)values[i];
+            buf[6u+2u*i]=(uint8_t)(u&0xFFu);
+            buf[7u+2u*i]=(uint8_t)(u>>8);
+        }
+        buf[len-1u]=serial_crc8_atm(buf,(uint16_t)(len-1u));
+        ret=serial_write_ctrl_nb(buf,len);
+        if(ret<0)break;
+        addr=(uint8_t)((addr+n)&PROTO_HDR_ADDR_MASK);
+        values+=n;
+        count=(uint8_t)(count-n);
+    }
+    return ret;
+#else
+    static uint8_t buf[PROTO_BURST_LEN(PROTO_BURST_RESP_MAX_REGS)];
+    if(values==NULL||count==0||count>PROTO_BURST_RESP_MAX_REGS)return -1;
+    const uint16_t len=(uint16_t)PROTO_BURST_LEN(count);
+    buf[0]=PROTO_SYNC_BURST;
+    buf[1]=PROTO_MAKE_HDR(1,addr);
+    buf[2]=count;
+    for(uint8_t i=0;i<count;i++){
+        uint16_t u=(uint16_t)values[i];
+        buf[3u+2u*i]=(uint8_t)(u&0xFFu);
+        buf[4u+2u*i]=(uint8_t)(u>>8);
+    }
+    buf[len-1u]=serial_crc8_atm(&buf[1],(uint16_t)(len-2u));
+    return serial_write_ctrl_nb(buf,len);
+#endif
+}
+
 /**
  * @brief  Envoie une demande de lecture multiple (Burst).
  * @param  addr  Adresse de départ.
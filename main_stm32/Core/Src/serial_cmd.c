@@ -8,14 +8,37 @@
 
 #include "serial_cmd.h"
 #include "serial.h"
+#include "crc8.h"
 #include "driver_motor.h"
 #include "driver_servo.h"
 #include "driver_ins.h"
 #include "app_main.h"
+#include "imu_hist.h"
+#include "dlog.h"
+#include "imu_filt.h"
+#include "vib.h"
+#include "actuators.h"
+#include "traj.h"
+#include "replay.h"
+#include "mem_map.h"
+#include "spi.h"
+#include "timebase.h"
+#include "scheduler.h"
+#include "profiler.h"
+#include "jitter.h"
+#include "attitude.h"
+#include "kv_store.h"
+#include "spi_link.h"
+#include "fw_update.h"
+#include "fault_log.h"
 #include <string.h>
 
-/** @brief État courant du parseur, exposé à l'application principale pour déclencher les actions. */
-ParserSwitch parser_state = PARSER_IDLE;
+/** @brief File des commandes décodées, vidée dans l'ordre par la boucle principale. */
+static serial_cmd_t cmd_queue[SERIAL_CMD_QUEUE_LEN];
+/** @brief Index d'écriture de la file (compteur libre). */
+static uint32_t cmd_head = 0;
+/** @brief Index de lecture de la file (compteur libre). */
+static uint32_t cmd_tail = 0;
 
 /**
  * @brief États de la machine à états de réception (Protocole 4 octets).
@@ -35,37 +58,949 @@ static uint8_t hdr = 0;
 static uint8_t d0  = 0;
 /** @brief Buffer temporaire pour la donnée 1. */
 static uint8_t d1  = 0;
+/** @brief CRC calculé au fil de la réception de la trame courante. */
+static uint8_t rx_crc = CRC8_INIT;
 
-/** @brief Copie locale de la dernière commande servo reçue. */
-int8_t  shadow_servo_cmd = 0;
-/** @brief Copie locale de la dernière commande moteur reçue. */
-int16_t shadow_motor_cmd = 0;
+#if SERIAL_CMD_FRAMED
+/** @brief Fenêtre glissante des derniers octets reçus, commençant toujours par un octet de synchronisation. */
+static uint8_t rx_win[PROTO_BURST_LEN(PROTO_BURST_MAX_REGS)];
+/** @brief Nombre d'octets valides dans rx_win. */
+static uint8_t rx_win_len = 0;
+#endif
+
+/** @brief Banc de registres virtuels (dernières valeurs écrites). */
+int16_t reg_file[REG_COUNT] = {
+    [REG_TELEM_RATE]  = TELEM_RATE_DEFAULT_HZ,
+    [REG_TELEM_BATCH] = TELEM_BATCH_DEFAULT,
+    [REG_ESC_BRAKE_MS]    = MOTOR_ESC_BRAKE_MS_DEFAULT,
+    [REG_ESC_GAP_MS]      = MOTOR_ESC_GAP_MS_DEFAULT,
+    [REG_ESC_BRAKE_DEPTH] = MOTOR_ESC_BRAKE_DEPTH_DEFAULT,
+    [REG_FS_DECEL_MS]     = FAILSAFE_DECEL_MS_DEFAULT,
+    [REG_FS_NEUTRAL_MS]   = FAILSAFE_NEUTRAL_MS_DEFAULT,
+    [REG_FS_DISARM_MS]    = FAILSAFE_DISARM_MS_DEFAULT,
+    [REG_ATT_KP]          = ATT_KP_MILLI_DEFAULT,
+    [REG_IDLE_HOLD_MS]    = TELEM_IDLE_HOLD_MS_DEFAULT,
+    [REG_MOTION_MG]       = TELEM_MOTION_MG_DEFAULT,
+    [REG_TELEM_ADAPT]     = TELEM_ADAPT_DEFAULT,
+    [REG_HIST_POST]       = IMU_HIST_POST_DEFAULT,
+    [REG_VIB_AVG]         = VIB_AVG_DEFAULT,
+};
+/** @brief Numéro de séquence de la prochaine trame de télémétrie (tous formats confondus). */
+static uint16_t telem_seq = 0;
+
+_Static_assert(FRAME_POOL_BLOCK_LEN >= TELEM_FRAME_MAX_LEN, "frame pool block must hold the longest telemetry frame");
+POOL_DEFINE(frame_pool, FRAME_POOL_BLOCK_LEN, FRAME_POOL_BLOCKS);
+
+/** @brief Fenêtre de mesure du débit de trames reçues (ms). */
+#define LINK_RATE_WINDOW_MS     1000u
+/** @brief Trames reçues rejetées (CRC ou format invalide). */
+static uint32_t link_rx_rejected = 0;
+/** @brief Trames valides reçues dans la fenêtre en cours. */
+static uint32_t link_rx_frames = 0;
+/** @brief Début de la fenêtre de mesure en cours (ms). */
+static uint32_t link_rate_start_ms = 0;
+/** @brief Trames valides par seconde sur la dernière fenêtre complète. */
+static uint16_t link_rx_rate = 0;
+
+/** @brief Dernier résultat du benchmark SPI (0.1 µs par lecture). */
+int16_t shadow_spi_bench_res = 0;
+/** @brief Résultat de la dernière opération sur la configuration persistante. */
+static nv_status_t nv_status = NV_ST_DEFAULTS;
+/** @brief Banc de préparation ouvert (NV_CMD_STAGE) : les registres REG_F_NV écrits y sont retenus. */
+static uint8_t nv_staging = 0;
+/** @brief Valeurs préparées, indexées par adresse. */
+static int16_t reg_shadow[REG_COUNT];
+/** @brief Registres préparés (un bit par adresse). */
+static uint32_t reg_shadow_dirty[REG_COUNT / 32u];
+/** @brief Date d'arrivée des octets du dernier écho demandé (un seul écho en vol à la fois). */
+static uint32_t ping_rx_us = 0;
+/** @brief Date d'arrivée des octets en cours d'analyse par serial_cmd_reader() (0 : hors liaison UART). */
+static uint32_t cmd_rx_us = 0;
+
+/**
+ * @brief États de la négociation de débit.
+ */
+typedef enum{
+    LINK_IDLE=0,        ///< Débit stable.
+    LINK_SWITCH,        ///< Acquittement en cours d'émission, bascule dès que TX est au repos.
+    LINK_CONFIRM        ///< Nouveau débit appliqué, attente d'une trame valide de l'hôte.
+} LinkState;
+
+/** @brief Débits associés aux codes SERIAL_BAUD_CODE_*. */
+static const uint32_t baud_table[] = {115200u, 460800u, 921600u, 2000000u};
+
+/** @brief État courant de la négociation de débit. */
+static LinkState link_st = LINK_IDLE;
+/** @brief Code de débit demandé par l'hôte. */
+static uint8_t link_code = SERIAL_BAUD_CODE_115200;
+/** @brief Code de débit actuellement appliqué. */
+static uint8_t link_code_cur = SERIAL_BAUD_CODE_115200;
+/** @brief Date de la bascule de débit (ms), pour le délai de confirmation. */
+static uint32_t link_switch_ms = 0;
 
 /** @brief Reconstruit un uint16_t à partir de deux octets. */
 static inline uint16_t to_u16(uint8_t lo,uint8_t hi){return(uint16_t)lo|((uint16_t)hi<<8);}
 /** @brief Reconstruit un int16_t à partir de deux octets. */
 static inline int16_t to_i16(uint8_t lo,uint8_t hi){return(int16_t)to_u16(lo,hi);}
 
+/** @brief Lecture de REG_IMU_CONFIG : configuration effectivement appliquée au capteur, profil compris. */
+static int16_t reg_rd_imu_cfg(uint8_t addr){
+    bmi088_config_t cfg;
+    (void)addr;
+    BMI088_Get_Config(&cfg);
+    return (int16_t)(IMU_CFG_PACK(&cfg) | ((uint16_t)BMI088_Profile_Of(&cfg) << IMU_CFG_PROFILE_SHIFT));
+}
+
+/** @brief Lecture de REG_SPI_PRESC : code BR actuellement programmé. */
+static int16_t reg_rd_spi_presc(uint8_t addr){
+    (void)addr;
+    return (int16_t)((hspi1.Init.BaudRatePrescaler & SPI_CR1_BR) >> SPI_CR1_BR_Pos);
+}
+
+/** @brief Lecture de REG_SPI_BENCH : dernier résultat du benchmark. */
+static int16_t reg_rd_spi_bench(uint8_t addr){
+    (void)addr;
+    return shadow_spi_bench_res;
+}
+
+/** @brief Lecture de REG_BAUD : code de débit actuellement appliqué. */
+static int16_t reg_rd_baud(uint8_t addr){
+    (void)addr;
+    return link_code_cur;
+}
+
+/** @brief Sature une durée (µs) ou une taille (octets) sur un registre 16 bits signé. */
+static int16_t reg_sat_u32(uint32_t v){
+    return (v > INT16_MAX) ? INT16_MAX : (int16_t)v;
+}
+
+/** @brief Lecture des registres de statistiques (compteurs modulo 65536, tailles saturées). */
+static int16_t reg_rd_stats(uint8_t addr){
+    switch(addr){
+        case REG_STAT_TELEM_SEQ:return (int16_t)telem_seq;
+        case REG_STAT_TX_DROP:return (int16_t)serial_tx_dropped();
+        case REG_STAT_RX_DROP:return (int16_t)serial_rx_dropped();
+        case REG_STAT_IMU_DROP:return (int16_t)BMI088_Queue_Dropped();
+        case REG_STAT_IDLE_PCT:return (int16_t)sched_idle_percent();
+        case REG_FS_STAGE:return (int16_t)app_failsafe_stage();
+        case REG_STAT_RX_REJECT:return (int16_t)link_rx_rejected;
+        case REG_STAT_RX_RATE:return (int16_t)link_rx_rate;
+        case REG_STAT_RESET_CAUSE:return (int16_t)fault_log_boot_cause();
+        case REG_STAT_IMU_BUS_ERR:{
+            bmi088_bus_stats_t bus;
+            BMI088_Get_Bus_Stats(&bus);
+            return (int16_t)(bus.timeouts + bus.errors);
+        }
+        case REG_STAT_IMU_RECOVER:{
+            bmi088_bus_stats_t bus;
+            BMI088_Get_Bus_Stats(&bus);
+            return (int16_t)((bus.recoveries & 0x7FFFu) | (bus.recovering ? 0x8000u : 0u));
+        }
+        case REG_STAT_STACK_PEAK:return reg_sat_u32(mem_stack_peak());
+        case REG_STAT_STACK_SIZE:return reg_sat_u32(mem_region_size(MEM_REGION_STACK_RESERVED));
+        case REG_STAT_RAM_DMA:return reg_sat_u32(mem_region_size(MEM_REGION_DMA));
+        case REG_STAT_RAM_HOT:return reg_sat_u32(mem_region_size(MEM_REGION_HOT));
+        case REG_STAT_RAM_STATIC:return reg_sat_u32(mem_region_size(MEM_REGION_STATIC));
+        case REG_STAT_RX_HWM:return reg_sat_u32(serial_rx_high_water());
+        case REG_STAT_TX_HWM:return reg_sat_u32(serial_tx_high_water());
+        case REG_STAT_RX_OVERRUN:return (int16_t)serial_rx_overruns();
+        case REG_STAT_RAM_FUNC:return reg_sat_u32(mem_region_size(MEM_REGION_RAMFUNC));
+        case REG_TELEM_DECIM:return (int16_t)app_telem_decimation();
+        case REG_TELEM_EFF_RATE:return reg_sat_u32(app_telem_effective_hz());
+        default:return 0;
+    }
+}
+
+/** @brief Lecture de REG_IMU_CAL : état de la calibration, bit 8 = enregistrement en flash. */
+static int16_t reg_rd_imu_cal(uint8_t addr){
+    (void)addr;
+    return (int16_t)(BMI088_Cal_State() | (BMI088_Cal_Stored() ? 0x100u : 0u));
+}
+
+/** @brief Lecture de REG_BMI : état de l'auto-test IMU, capteurs en échec dans l'octet haut. */
+static int16_t reg_rd_imu_st(uint8_t addr){
+    (void)addr;
+    return (int16_t)BMI088_SelfTest_Status();
+}
+
+/** @brief Lecture des offsets IMU actifs (saturés sur 16 bits). */
+static int16_t reg_rd_imu_ofs(uint8_t addr){
+    bmi088_offsets_t ofs;
+    const uint8_t idx = (uint8_t)(addr - REG_IMU_OFS_BASE);
+    int32_t v;
+
+    BMI088_Get_Offsets(&ofs);
+    v = (idx < 3u) ? ofs.gyro_urads[idx] : ofs.accel_mms2[idx - 3u];
+
+    if(v > INT16_MAX) v = INT16_MAX;
+    if(v < INT16_MIN) v = INT16_MIN;
+    return (int16_t)v;
+}
+
+/** @brief Lecture de REG_NV_CMD / REG_NV_KEYS / REG_NV_GEN : état du magasin de configuration. */
+static int16_t reg_rd_nv(uint8_t addr){
+    switch(addr){
+        case REG_NV_CMD:  return (int16_t)nv_status;
+        case REG_NV_KEYS: return (int16_t)kv_count();
+        default:          return (int16_t)kv_generation();
+    }
+}
+
+/** @brief Lecture de REG_IDLE_STATE : état de la mise en veille de la télémétrie. */
+static int16_t reg_rd_idle_state(uint8_t addr){
+    (void)addr;
+    return (int16_t)app_idle_state();
+}
+
+/** @brief Lecture des registres de l'historique IMU. */
+static int16_t reg_rd_hist(uint8_t addr){
+    switch(addr){
+        case REG_HIST_CMD:return (int16_t)imu_hist_status();
+        case REG_HIST_COUNT:return (int16_t)imu_hist_count();
+        case REG_HIST_TRIG:return (int16_t)imu_hist_trigger_index();
+        default:return 0;
+    }
+}
+
+/** @brief Lecture des registres du tampon de trajectoire. */
+static int16_t reg_rd_traj(uint8_t addr){
+    return (addr == REG_TRAJ_CMD) ? (int16_t)traj_state() : (int16_t)traj_count();
+}
+
+/** @brief Lecture de REG_REPLAY : échantillons injectés depuis le démarrage du rejeu (saturé). */
+static int16_t reg_rd_replay(uint8_t addr){
+    (void)addr;
+    return reg_sat_u32(replay_count());
+}
+
+/** @brief Lecture de REG_IMU_FILT_DECIM. */
+static int16_t reg_rd_imu_filt(uint8_t addr){
+    (void)addr;
+    return (int16_t)imu_filt_decim();
+}
+
+/** @brief Lecture de la fenêtre d'actionneurs (actionneur de REG_ACT_SEL). */
+static int16_t reg_rd_act(uint8_t addr){
+    const uint8_t sel = (uint8_t)reg_file[REG_ACT_SEL];
+
+    switch(addr){
+        case REG_ACT_CMD: return actuators_command(sel);
+        case REG_ACT_OUT: return (int16_t)actuators_output(sel);
+        default:          return (int16_t)actuators_state(sel);
+    }
+}
+
+/** @brief Lecture de REG_CAPS : version du protocole. */
+static int16_t reg_rd_caps(uint8_t addr){
+    (void)addr;
+    return (int16_t)PROTO_VERSION;
+}
+
+/** @brief Lecture des résultats du dernier rapport vibratoire. */
+static int16_t reg_rd_vib(uint8_t addr){
+    const uint16_t v = (addr == REG_VIB_PEAK_DHZ) ? vib_peak_dhz() : vib_peak_mg();
+    return (v > INT16_MAX) ? INT16_MAX : (int16_t)v;
+}
+
+/** @brief Sature une valeur signée 32 bits sur un registre 16 bits. */
+static int16_t reg_sat_i32(int32_t v){
+    return (v > INT16_MAX) ? INT16_MAX : (v < -INT16_MAX) ? -INT16_MAX : (int16_t)v;
+}
+
+/** @brief Lecture de la pose de l'odométrie (0 si l'odométrie est absente). */
+static int16_t reg_rd_odom(uint8_t addr){
+    const Odometry_t *odo = app_odometry();
+
+    if(odo == NULL){
+        return 0;
+    }
+    switch(addr - REG_ODOM_BASE){
+        case 0:return reg_sat_i32(odom_x_mm(odo) / 10);
+        case 1:return reg_sat_i32(odom_y_mm(odo) / 10);
+        case 2:return odom_heading_cdeg(odo);
+        case 3:return (int16_t)(odom_distance_mm(odo) & 0xFFFFu);
+        case 4:return (int16_t)(odom_distance_mm(odo) >> 16);
+        default:return 0;
+    }
+}
+
+/** @brief Lecture des registres d'étapes du démarrage (unité REG_BOOT_STAGE_UNIT_US, -1 si non atteinte). */
+static int16_t reg_rd_boot_stage(uint8_t addr){
+    const uint32_t t_us = app_boot_stage_us((uint8_t)(addr - REG_BOOT_STAGE_BASE));
+
+    if(t_us == UINT32_MAX){
+        return -1;
+    }
+    return reg_sat_u32(t_us / REG_BOOT_STAGE_UNIT_US);
+}
+
 /**
- * @brief  Lit la valeur d'un registre virtuel.
- * @note   Utilisé pour répondre aux requêtes de lecture du protocole.
- * @param  addr Adresse du registre à lire.
- * @return Valeur actuelle du registre (commande shadow).
+ * @brief  Lecture des registres du profileur pour la sonde choisie par REG_PROF_SEL.
+ * @details Copie cohérente de la sonde à chaque lecture : une lecture en rafale de
+ * 0x11..0x1E peut mêler deux états successifs, sans incohérence à l'intérieur d'un champ.
  */
-static int16_t read_reg16(uint8_t addr){
+static int16_t reg_rd_prof(uint8_t addr){
+    const uint8_t sel = (uint8_t)reg_file[REG_PROF_SEL] & (uint8_t)~PROF_SEL_LATENESS;
+    const sched_task_t *task = NULL;
+    const prof_stat_t *src;
+    prof_stat_t s;
+
+    if(sel < PROF_SEL_PROBE){
+        task = sched_get_task(sel);
+        if(task != NULL){
+            src = (reg_file[REG_PROF_SEL] & PROF_SEL_LATENESS) ? &task->late : &task->exec;
+        }
+        else{
+            src = NULL;
+        }
+    }
+    else{
+        src = prof_probe((uint8_t)(sel - PROF_SEL_PROBE));
+    }
+    if(src == NULL){
+        return 0;
+    }
+    prof_snapshot(src, &s);
+
     switch(addr){
-        case REG_SERVO_CMD:return shadow_servo_cmd;
-        case REG_MOTOR_CMD:return shadow_motor_cmd;
-        case REG_BMI:return 0;
-        default:return 0;
+        case REG_PROF_COUNT:return (int16_t)s.count;
+        case REG_PROF_MIN:return reg_sat_u32(s.min_us);
+        case REG_PROF_AVG:return reg_sat_u32(prof_avg_us(&s));
+        case REG_PROF_MAX:return reg_sat_u32(s.max_us);
+        case REG_PROF_OVERRUNS:return (task != NULL) ? (int16_t)task->overruns : 0;
+        case REG_PROF_LATE_MAX:return (task != NULL) ? reg_sat_u32(task->late.max_us) : 0;
+        default:
+#if PROF_HISTOGRAM
+            if(addr >= REG_PROF_HIST0 && addr < REG_PROF_HIST0 + PROF_HIST_BINS){
+                return (int16_t)s.hist[addr - REG_PROF_HIST0];
+            }
+#endif
+            return 0;
+    }
+}
+
+/** @brief Écriture de REG_PROF_SEL : sélection de la sonde, bit 7 = remise à zéro de tous les profils. */
+static int16_t reg_wr_prof_sel(uint8_t addr,int16_t value){
+    (void)addr;
+    if((uint16_t)value & PROF_SEL_RESET){
+        sched_reset_stats();
+        prof_reset_probes();
+    }
+    return (int16_t)((uint16_t)value & 0x7Fu);
+}
+
+/** @brief Écriture de REG_JITTER_MODE : application immédiate des modes du banc de gigue. */
+static int16_t reg_wr_jitter_mode(uint8_t addr,int16_t value){
+    (void)addr;
+    jitter_set_mode((uint8_t)value);
+    return (int16_t)jitter_get_mode();
+}
+
+/** @brief Écriture des registres non négatifs (gains, vitesse servo, délais failsafe, profils) : valeurs négatives ramenées à 0. */
+static int16_t reg_wr_non_negative(uint8_t addr,int16_t value){
+    (void)addr;
+    return (value < 0) ? 0 : value;
+}
+
+/** @brief Écriture de REG_TELEM_ADAPT : borné à 0..TELEM_ADAPT_DECIM_MAX. */
+static int16_t reg_wr_telem_adapt(uint8_t addr,int16_t value){
+    (void)addr;
+    if(value < 0){
+        return 0;
     }
+    return (value > (int16_t)TELEM_ADAPT_DECIM_MAX) ? (int16_t)TELEM_ADAPT_DECIM_MAX : value;
+}
+
+/** @brief Écriture de REG_HIST_POST : borné à 0..IMU_HIST_LEN - 1. */
+static int16_t reg_wr_hist_post(uint8_t addr,int16_t value){
+    (void)addr;
+    if(value < 0){
+        return 0;
+    }
+    return (value > (int16_t)(IMU_HIST_LEN - 1u)) ? (int16_t)(IMU_HIST_LEN - 1u) : value;
+}
+
+/** @brief Écriture de REG_IMU_FILT : borné à IMU_FILT_OFF..IMU_FILT_ORDER4. */
+static int16_t reg_wr_imu_filt(uint8_t addr,int16_t value){
+    (void)addr;
+    if(value < 0){
+        return IMU_FILT_OFF;
+    }
+    return (value > IMU_FILT_ORDER4) ? (int16_t)IMU_FILT_ORDER4 : value;
+}
+
+/** @brief Écriture de REG_ACT_SEL : index ramené aux actionneurs présents. */
+static int16_t reg_wr_act_sel(uint8_t addr,int16_t value){
+    (void)addr;
+    return (int16_t)actuators_sel_clamp((uint8_t)value);
+}
+
+/** @brief Écriture de REG_VIB_CMD (borné à VIB_OFF..VIB_AXIS_Z) et REG_VIB_AVG (borné à 1..VIB_AVG_MAX). */
+static int16_t reg_wr_vib(uint8_t addr,int16_t value){
+    const int16_t lo = (addr == REG_VIB_CMD) ? (int16_t)VIB_OFF : 1;
+    const int16_t hi = (addr == REG_VIB_CMD) ? (int16_t)VIB_AXIS_Z : (int16_t)VIB_AVG_MAX;
+    return (value < lo) ? lo : (value > hi) ? hi : value;
+}
+
+/** @brief Écriture de REG_ESC_* : durées négatives ramenées à 0, profondeur de frein bornée à 50 %. */
+static int16_t reg_wr_esc_profile(uint8_t addr,int16_t value){
+    if(value < 0){
+        return 0;
+    }
+    if(addr == REG_ESC_BRAKE_DEPTH && value > 50){
+        return 50;
+    }
+    return value;
+}
+
+/** @brief Écriture de REG_SERVO_CMD : consigne ramenée sur 8 bits signés. */
+static int16_t reg_wr_servo(uint8_t addr,int16_t value){
+    (void)addr;
+    return (int8_t)value;
+}
+
+/** @brief Écriture de REG_SERVO_CDEG : consigne bornée à la course logicielle du servo. */
+static int16_t reg_wr_servo_cdeg(uint8_t addr,int16_t value){
+    (void)addr;
+    if(value < SERVO_CLAMP_MIN_CDEG){
+        return SERVO_CLAMP_MIN_CDEG;
+    }
+    if(value > SERVO_CLAMP_MAX_CDEG){
+        return SERVO_CLAMP_MAX_CDEG;
+    }
+    return value;
+}
+
+/** @brief Écriture du registre de vitesse d'un emplacement REG_TRAJ_PT_BASE : ajoute le point. */
+static int16_t reg_wr_traj_pt(uint8_t addr,int16_t value){
+    const uint8_t base = (uint8_t)(REG_TRAJ_PT_BASE + ((addr - REG_TRAJ_PT_BASE) / REG_TRAJ_PT_LEN) * REG_TRAJ_PT_LEN);
+    const traj_point_t pt = {
+        .t_us       = (uint32_t)(uint16_t)reg_file[base] | ((uint32_t)(uint16_t)reg_file[base + 1u] << 16),
+        .servo_cdeg = reg_file[base + 2u],
+        .speed_mms  = value
+    };
+
+    (void)traj_push(&pt);
+    return value;
+}
+
+/**
+ * @brief  Écriture de REG_REPLAY : commande appliquée dès le décodage, avant les
+ * trames groupées d'enregistrements qui la suivent dans le même bloc reçu.
+ */
+static int16_t reg_wr_replay(uint8_t addr,int16_t value){
+    (void)addr;
+    replay_command((uint8_t)value);
+    return (int16_t)replay_active();
+}
+
+/** @brief Écriture de REG_SPI_PRESC : seul le code BR (0..7) est retenu. */
+static int16_t reg_wr_spi_presc(uint8_t addr,int16_t value){
+    (void)addr;
+    return (int16_t)(value & 0x07);
+}
+
+/** @brief Écriture de REG_TELEM_RATE : cadence bornée à [TELEM_RATE_MIN_HZ, TELEM_RATE_MAX_HZ]. */
+static int16_t reg_wr_telem_rate(uint8_t addr,int16_t value){
+    (void)addr;
+    if(value < (int16_t)TELEM_RATE_MIN_HZ){
+        return (int16_t)TELEM_RATE_MIN_HZ;
+    }
+    if(value > (int16_t)TELEM_RATE_MAX_HZ){
+        return (int16_t)TELEM_RATE_MAX_HZ;
+    }
+    return value;
+}
+
+/** @brief Écriture de REG_IMU_RATE : 0 (cadence de télémétrie) ou cadence bornée comme REG_TELEM_RATE. */
+static int16_t reg_wr_imu_rate(uint8_t addr,int16_t value){
+    return (value <= 0) ? 0 : reg_wr_telem_rate(addr, value);
+}
+
+/** @brief Écriture de REG_IDLE_RATE : 0 (inactive) ou cadence bornée à TELEM_RATE_MAX_HZ. */
+static int16_t reg_wr_idle_rate(uint8_t addr,int16_t value){
+    (void)addr;
+    if(value < 0){
+        return 0;
+    }
+    return (value > (int16_t)TELEM_RATE_MAX_HZ) ? (int16_t)TELEM_RATE_MAX_HZ : value;
+}
+
+/** @brief Écriture de REG_MOTION_MG : seuil borné à [1, BMI088_MOTION_THRESH_MAX_MG]. */
+static int16_t reg_wr_motion_mg(uint8_t addr,int16_t value){
+    (void)addr;
+    if(value < 1){
+        return 1;
+    }
+    return (value > (int16_t)BMI088_MOTION_THRESH_MAX_MG) ? (int16_t)BMI088_MOTION_THRESH_MAX_MG : value;
+}
+
+/** @brief Écriture de REG_PING : relève la date d'arrivée des octets de la commande. */
+static int16_t reg_wr_ping(uint8_t addr,int16_t value){
+    (void)addr;
+    ping_rx_us = serial_rx_last_us();
+    return value;
+}
+
+/** @brief Écriture de REG_TELEM_FIELDS : seuls les champs connus sont retenus (deux flux). */
+static int16_t reg_wr_telem_fields(uint8_t addr,int16_t value){
+    (void)addr;
+    return (int16_t)(value & (TELEM_F_ALL | (TELEM_F_ALL << 8)));
+}
+
+/**
+ * @brief Écriture de REG_TELEM_FORMAT : format inconnu ramené au format historique,
+ * cadence du flux d'état bornée à TELEM_STATUS_RATE_MAX_HZ.
+ */
+static int16_t reg_wr_telem_format(uint8_t addr,int16_t value){
+    const uint8_t fmt  = (TELEM_FORMAT_MODE(value) == TELEM_FMT_COMPACT) ? TELEM_FMT_COMPACT : TELEM_FMT_LEGACY;
+    uint8_t       rate = TELEM_STATUS_RATE_HZ(value);
+    (void)addr;
+    if(rate > TELEM_STATUS_RATE_MAX_HZ){
+        rate = TELEM_STATUS_RATE_MAX_HZ;
+    }
+    return (int16_t)(((uint16_t)rate << 8) | fmt);
+}
+
+/** @brief Écriture de REG_TELEM_BATCH : taille de lot bornée à [1, TELEM_DELTA_MAX_SAMPLES]. */
+static int16_t reg_wr_telem_batch(uint8_t addr,int16_t value){
+    uint8_t n = TELEM_BATCH_SIZE(value);
+    (void)addr;
+    if(n == 0){
+        n = 1;
+    }
+    if(n > TELEM_DELTA_MAX_SAMPLES){
+        n = TELEM_DELTA_MAX_SAMPLES;
+    }
+    return (int16_t)(((uint16_t)TELEM_BATCH_LATENCY_MS(value) << 8) | n);
+}
+
+static void write_reg16(uint8_t addr,int16_t data16);
+
+/**
+ * @brief  Applique le banc de préparation : chaque registre préparé repasse par write_reg16().
+ * @details Tous les registres sont écrits dans reg_file avant que la boucle principale ne
+ * traite la première commande postée : chaque rechargement voit le jeu complet. Refusé
+ * (banc conservé) si la file ne peut absorber toutes les commandes.
+ * @return Résultat (NV_ST_COMMITTED ou NV_ST_E_BUSY).
+ */
+static nv_status_t nv_commit(void){
+    uint32_t count = 0;
+
+    for(uint8_t w = 0; w < (REG_COUNT / 32u); w++){
+        for(uint32_t m = reg_shadow_dirty[w]; m != 0u; m &= m - 1u){
+            count++;
+        }
+    }
+    if(count + 1u > SERIAL_CMD_QUEUE_LEN - (cmd_head - cmd_tail)){
+        return NV_ST_E_BUSY;
+    }
+
+    nv_staging = 0;
+    for(uint8_t a = 0; a < REG_COUNT; a++){
+        if(reg_shadow_dirty[a >> 5] & (1u << (a & 31u))){
+            write_reg16(a, reg_shadow[a]);
+        }
+    }
+    memset(reg_shadow_dirty, 0, sizeof(reg_shadow_dirty));
+    return NV_ST_COMMITTED;
+}
+
+/** @brief Écriture de REG_NV_CMD : les demandes sur le banc de préparation sont traitées dès l'analyse. */
+static int16_t reg_wr_nv_cmd(uint8_t addr,int16_t value){
+    (void)addr;
+    switch((uint16_t)value){
+        case NV_CMD_STAGE:
+            memset(reg_shadow_dirty, 0, sizeof(reg_shadow_dirty));
+            nv_staging = 1;
+            nv_status = NV_ST_STAGING;
+        break;
+
+        case NV_CMD_COMMIT:
+            nv_status = nv_staging ? nv_commit() : NV_ST_E_INVALID;
+        break;
+
+        case NV_CMD_DISCARD:
+            memset(reg_shadow_dirty, 0, sizeof(reg_shadow_dirty));
+            nv_staging = 0;
+            nv_status = NV_ST_DISCARDED;
+        break;
+
+        default:
+        break;
+    }
+    return value;
+}
+
+/** @brief Écriture de REG_BAUD : lance la négociation et acquitte à l'ancien débit. */
+static int16_t reg_wr_baud(uint8_t addr,int16_t value){
+    const uint16_t code = (uint16_t)value;
+
+    if(code < (sizeof(baud_table)/sizeof(baud_table[0])) && code != link_code_cur){
+        link_code = (uint8_t)code;
+        link_st = LINK_SWITCH;
+    }
+    (void)proto_send_data16(addr, value);  // Acquittement à l'ancien débit
+    return value;
+}
+
+/** @brief Écriture de REG_FW_UPDATE : commande de mise à jour, exécutée par fw_update_poll(). */
+static int16_t reg_wr_fw(uint8_t addr,int16_t value){
+    (void)addr;
+    fw_update_command((uint16_t)value);
+    return value;
+}
+
+/** @brief Écriture de REG_FAULT : renvoi ou effacement du relevé de faute. */
+static int16_t reg_wr_fault(uint8_t addr,int16_t value){
+    (void)addr;
+    fault_log_command((uint16_t)value);
+    return value;
+}
+
+/**
+ * @brief Table des registres virtuels, indexée directement par l'adresse 7 bits.
+ * @note  Les adresses absentes sont nulles : lues à 0, leur écriture est seulement
+ * signalée (PARSER_OTHERS) pour entretenir le Failsafe.
+ */
+_Static_assert(REG_TRAJ_PT_SLOTS * REG_TRAJ_PT_LEN == PROTO_BURST_MAX_REGS, "one burst frame fills every trajectory slot");
+_Static_assert(REPLAY_REC_REGS <= PROTO_BURST_MAX_REGS, "one burst frame carries a replay record");
+_Static_assert(REG_HEARTBEAT == REG_FS_STAGE, "heartbeat writes must land on a read-only register");
+_Static_assert(REG_SNAPSHOT == REG_STAT_TELEM_SEQ, "snapshot requests share the sequence register");
+_Static_assert(REG_KIN_SPEED == REG_STAT_TX_DROP && REG_KIN_CURV == REG_KIN_SPEED + 1, "kinematic pair shares the drop counters");
+_Static_assert(REG_FW_UPDATE == REG_STAT_RAM_FUNC, "firmware update commands share a read-only register");
+_Static_assert(REG_FAULT == REG_STAT_RESET_CAUSE, "fault log commands share the reset cause register");
+
+static const reg_desc_t reg_map[REG_COUNT] = {
+    [REG_SERVO_CMD]  = { REG_F_RW, PARSER_SERVO_CMD, NULL,             reg_wr_servo     },
+    [REG_MOTOR_CMD]  = { REG_F_RW, PARSER_MOTOR_CMD, NULL,             NULL             },
+    [REG_BMI]        = { REG_F_RW, PARSER_BMI_CMD,   reg_rd_imu_st,    NULL             },
+    [REG_IMU_CONFIG] = { REG_F_RW | REG_F_NV, PARSER_IMU_CFG, reg_rd_imu_cfg, NULL      },
+    [REG_SPI_PRESC]  = { REG_F_RW, PARSER_SPI_PRESC, reg_rd_spi_presc, reg_wr_spi_presc },
+    [REG_SPI_BENCH]  = { REG_F_RW, PARSER_SPI_BENCH, reg_rd_spi_bench, NULL             },
+    [REG_BAUD]       = { REG_F_RW, PARSER_OTHERS,    reg_rd_baud,      reg_wr_baud      },
+    [REG_TELEM_RATE]   = { REG_F_RW | REG_F_NV, PARSER_OTHERS, NULL,   reg_wr_telem_rate   },
+    [REG_TELEM_FIELDS] = { REG_F_RW | REG_F_NV, PARSER_OTHERS, NULL,   reg_wr_telem_fields },
+    [REG_TELEM_FORMAT] = { REG_F_RW | REG_F_NV, PARSER_OTHERS, NULL,   reg_wr_telem_format },
+    [REG_TELEM_BATCH]  = { REG_F_RW | REG_F_NV, PARSER_OTHERS, NULL,   reg_wr_telem_batch  },
+    [REG_STAT_TELEM_SEQ] = { REG_F_RW, PARSER_SNAPSHOT, reg_rd_stats,  NULL                },
+    [REG_STAT_TX_DROP]   = { REG_F_RW, PARSER_KIN,   reg_rd_stats,     NULL                },
+    [REG_STAT_RX_DROP]   = { REG_F_RW, PARSER_KIN,   reg_rd_stats,     NULL                },
+    [REG_STAT_IMU_DROP]  = { REG_F_R, PARSER_OTHERS, reg_rd_stats,     NULL                },
+    [REG_STAT_IDLE_PCT]  = { REG_F_R, PARSER_OTHERS, reg_rd_stats,     NULL                },
+    [REG_PROF_SEL]       = { REG_F_RW, PARSER_OTHERS, NULL,            reg_wr_prof_sel     },
+    [REG_PROF_COUNT]     = { REG_F_R, PARSER_OTHERS, reg_rd_prof,      NULL                },
+    [REG_PROF_MIN]       = { REG_F_R, PARSER_OTHERS, reg_rd_prof,      NULL                },
+    [REG_PROF_AVG]       = { REG_F_R, PARSER_OTHERS, reg_rd_prof,      NULL                },
+    [REG_PROF_MAX]       = { REG_F_R, PARSER_OTHERS, reg_rd_prof,      NULL                },
+    [REG_PROF_HIST0 + 0] = { REG_F_R, PARSER_OTHERS, reg_rd_prof,      NULL                },
+    [REG_PROF_HIST0 + 1] = { REG_F_R, PARSER_OTHERS, reg_rd_prof,      NULL                },
+    [REG_PROF_HIST0 + 2] = { REG_F_R, PARSER_OTHERS, reg_rd_prof,      NULL                },
+    [REG_PROF_HIST0 + 3] = { REG_F_R, PARSER_OTHERS, reg_rd_prof,      NULL                },
+    [REG_PROF_HIST0 + 4] = { REG_F_R, PARSER_OTHERS, reg_rd_prof,      NULL                },
+    [REG_PROF_HIST0 + 5] = { REG_F_R, PARSER_OTHERS, reg_rd_prof,      NULL                },
+    [REG_PROF_HIST0 + 6] = { REG_F_R, PARSER_OTHERS, reg_rd_prof,      NULL                },
+    [REG_PROF_HIST0 + 7] = { REG_F_R, PARSER_OTHERS, reg_rd_prof,      NULL                },
+    [REG_PROF_OVERRUNS]  = { REG_F_R, PARSER_OTHERS, reg_rd_prof,      NULL                },
+    [REG_PROF_LATE_MAX]  = { REG_F_R, PARSER_OTHERS, reg_rd_prof,      NULL                },
+    [REG_JITTER_MODE]    = { REG_F_RW, PARSER_OTHERS, NULL,            reg_wr_jitter_mode  },
+    [REG_SPEED_KP]       = { REG_F_RW | REG_F_NV, PARSER_SPEED_GAINS, NULL, reg_wr_non_negative },
+    [REG_SPEED_KI]       = { REG_F_RW | REG_F_NV, PARSER_SPEED_GAINS, NULL, reg_wr_non_negative },
+    [REG_SPEED_KD]       = { REG_F_RW | REG_F_NV, PARSER_SPEED_GAINS, NULL, reg_wr_non_negative },
+    [REG_ESC_BRAKE_MS]   = { REG_F_RW | REG_F_NV, PARSER_ESC_PROFILE, NULL, reg_wr_esc_profile  },
+    [REG_ESC_GAP_MS]     = { REG_F_RW | REG_F_NV, PARSER_ESC_PROFILE, NULL, reg_wr_esc_profile  },
+    [REG_ESC_BRAKE_DEPTH]= { REG_F_RW | REG_F_NV, PARSER_ESC_PROFILE, NULL, reg_wr_esc_profile  },
+    [REG_SERVO_CDEG]     = { REG_F_RW, PARSER_SERVO_CDEG,  NULL,       reg_wr_servo_cdeg   },
+    [REG_SERVO_SLEW]     = { REG_F_RW | REG_F_NV, PARSER_SERVO_SLEW,  NULL, reg_wr_non_negative },
+    [REG_FS_DECEL_MS]    = { REG_F_RW | REG_F_NV, PARSER_OTHERS,      NULL, reg_wr_non_negative },
+    [REG_FS_NEUTRAL_MS]  = { REG_F_RW | REG_F_NV, PARSER_OTHERS,      NULL, reg_wr_non_negative },
+    [REG_FS_DISARM_MS]   = { REG_F_RW | REG_F_NV, PARSER_OTHERS,      NULL, reg_wr_non_negative },
+    [REG_FS_STAGE]       = { REG_F_R,  PARSER_OTHERS,      reg_rd_stats, NULL              },
+    [REG_STAT_RX_REJECT] = { REG_F_R,  PARSER_OTHERS,      reg_rd_stats, NULL              },
+    [REG_STAT_RX_RATE]   = { REG_F_R,  PARSER_OTHERS,      reg_rd_stats, NULL              },
+    [REG_STAT_RESET_CAUSE] = { REG_F_RW, PARSER_OTHERS,    reg_rd_stats, reg_wr_fault      },
+    [REG_STAT_IMU_BUS_ERR] = { REG_F_R, PARSER_OTHERS,     reg_rd_stats, NULL              },
+    [REG_STAT_IMU_RECOVER] = { REG_F_R, PARSER_OTHERS,     reg_rd_stats, NULL              },
+    [REG_STAT_STACK_PEAK]  = { REG_F_R, PARSER_OTHERS,     reg_rd_stats, NULL              },
+    [REG_STAT_STACK_SIZE]  = { REG_F_R, PARSER_OTHERS,     reg_rd_stats, NULL              },
+    [REG_STAT_RAM_DMA]     = { REG_F_R, PARSER_OTHERS,     reg_rd_stats, NULL              },
+    [REG_STAT_RAM_HOT]     = { REG_F_R, PARSER_OTHERS,     reg_rd_stats, NULL              },
+    [REG_STAT_RAM_STATIC]  = { REG_F_R, PARSER_OTHERS,     reg_rd_stats, NULL              },
+    [REG_STAT_RX_HWM]      = { REG_F_R, PARSER_OTHERS,     reg_rd_stats, NULL              },
+    [REG_STAT_TX_HWM]      = { REG_F_R, PARSER_OTHERS,     reg_rd_stats, NULL              },
+    [REG_STAT_RX_OVERRUN]  = { REG_F_R, PARSER_OTHERS,     reg_rd_stats, NULL              },
+    [REG_STAT_RAM_FUNC]    = { REG_F_RW, PARSER_OTHERS,    reg_rd_stats, reg_wr_fw         },
+    [REG_BOOT_STAGE_BASE + BOOT_STAGE_HAL]       = { REG_F_R, PARSER_OTHERS, reg_rd_boot_stage, NULL },
+    [REG_BOOT_STAGE_BASE + BOOT_STAGE_ACTUATORS] = { REG_F_R, PARSER_OTHERS, reg_rd_boot_stage, NULL },
+    [REG_BOOT_STAGE_BASE + BOOT_STAGE_SERIAL]    = { REG_F_R, PARSER_OTHERS, reg_rd_boot_stage, NULL },
+    [REG_BOOT_STAGE_BASE + BOOT_STAGE_SCHED]     = { REG_F_R, PARSER_OTHERS, reg_rd_boot_stage, NULL },
+    [REG_BOOT_STAGE_BASE + BOOT_STAGE_IMU]       = { REG_F_R, PARSER_OTHERS, reg_rd_boot_stage, NULL },
+    [REG_BOOT_STAGE_BASE + BOOT_STAGE_TELEMETRY] = { REG_F_R, PARSER_OTHERS, reg_rd_boot_stage, NULL },
+    [REG_ATT_KP]           = { REG_F_RW | REG_F_NV, PARSER_ATT_GAIN, NULL, reg_wr_non_negative },
+    [REG_IMU_CAL]          = { REG_F_RW, PARSER_IMU_CAL,   reg_rd_imu_cal, NULL            },
+    [REG_IMU_OFS_BASE + 0] = { REG_F_R,  PARSER_OTHERS,    reg_rd_imu_ofs, NULL            },
+    [REG_IMU_OFS_BASE + 1] = { REG_F_R,  PARSER_OTHERS,    reg_rd_imu_ofs, NULL            },
+    [REG_IMU_OFS_BASE + 2] = { REG_F_R,  PARSER_OTHERS,    reg_rd_imu_ofs, NULL            },
+    [REG_IMU_OFS_BASE + 3] = { REG_F_R,  PARSER_OTHERS,    reg_rd_imu_ofs, NULL            },
+    [REG_IMU_OFS_BASE + 4] = { REG_F_R,  PARSER_OTHERS,    reg_rd_imu_ofs, NULL            },
+    [REG_IMU_OFS_BASE + 5] = { REG_F_R,  PARSER_OTHERS,    reg_rd_imu_ofs, NULL            },
+    [REG_MOTOR_MAX_FWD]    = { REG_F_RW | REG_F_NV, PARSER_OTHERS, NULL, reg_wr_non_negative },
+    [REG_MOTOR_MAX_REV]    = { REG_F_RW | REG_F_NV, PARSER_OTHERS, NULL, reg_wr_non_negative },
+    [REG_SERVO_MIN_TICKS]  = { REG_F_RW | REG_F_NV, PARSER_OTHERS, NULL, reg_wr_non_negative },
+    [REG_SERVO_MAX_TICKS]  = { REG_F_RW | REG_F_NV, PARSER_OTHERS, NULL, reg_wr_non_negative },
+    [REG_NV_CMD]           = { REG_F_RW, PARSER_NV_CMD,    reg_rd_nv,  reg_wr_nv_cmd       },
+    [REG_NV_KEYS]          = { REG_F_R,  PARSER_OTHERS,    reg_rd_nv,  NULL                },
+    [REG_NV_GEN]           = { REG_F_R,  PARSER_OTHERS,    reg_rd_nv,  NULL                },
+    [REG_IDLE_RATE]        = { REG_F_RW | REG_F_NV, PARSER_MOTION_CFG, NULL, reg_wr_idle_rate   },
+    [REG_IDLE_HOLD_MS]     = { REG_F_RW | REG_F_NV, PARSER_OTHERS,     NULL, reg_wr_non_negative },
+    [REG_MOTION_MG]        = { REG_F_RW | REG_F_NV, PARSER_MOTION_CFG, NULL, reg_wr_motion_mg   },
+    [REG_IDLE_STATE]       = { REG_F_R,  PARSER_OTHERS,    reg_rd_idle_state, NULL         },
+    [REG_PING]             = { REG_F_RW, PARSER_PING,      NULL, reg_wr_ping               },
+    [REG_TELEM_ADAPT]      = { REG_F_RW | REG_F_NV, PARSER_OTHERS, NULL, reg_wr_telem_adapt },
+    [REG_TELEM_DECIM]      = { REG_F_R,  PARSER_OTHERS,    reg_rd_stats, NULL              },
+    [REG_TELEM_EFF_RATE]   = { REG_F_R,  PARSER_OTHERS,    reg_rd_stats, NULL              },
+    [REG_IMU_RATE]         = { REG_F_RW | REG_F_NV, PARSER_OTHERS, NULL, reg_wr_imu_rate    },
+    [REG_HIST_CMD]         = { REG_F_RW, PARSER_HIST,      reg_rd_hist, NULL               },
+    [REG_HIST_THR_MG]      = { REG_F_RW | REG_F_NV, PARSER_HIST, NULL, reg_wr_non_negative  },
+    [REG_HIST_POST]        = { REG_F_RW | REG_F_NV, PARSER_HIST, NULL, reg_wr_hist_post     },
+    [REG_HIST_COUNT]       = { REG_F_R,  PARSER_OTHERS,    reg_rd_hist, NULL               },
+    [REG_HIST_TRIG]        = { REG_F_R,  PARSER_OTHERS,    reg_rd_hist, NULL               },
+    [REG_HIST_CHUNK]       = { REG_F_RW, PARSER_HIST,      NULL, NULL                      },
+    [REG_ODOM_CMD]         = { REG_F_RW, PARSER_ODOM,      NULL, NULL                      },
+    [REG_ODOM_BASE + 0]    = { REG_F_R,  PARSER_OTHERS,    reg_rd_odom, NULL               },
+    [REG_ODOM_BASE + 1]    = { REG_F_R,  PARSER_OTHERS,    reg_rd_odom, NULL               },
+    [REG_ODOM_BASE + 2]    = { REG_F_R,  PARSER_OTHERS,    reg_rd_odom, NULL               },
+    [REG_ODOM_BASE + 3]    = { REG_F_R,  PARSER_OTHERS,    reg_rd_odom, NULL               },
+    [REG_ODOM_BASE + 4]    = { REG_F_R,  PARSER_OTHERS,    reg_rd_odom, NULL               },
+    [REG_TRAJ_CMD]         = { REG_F_RW, PARSER_TRAJ,      reg_rd_traj, NULL               },
+    [REG_TRAJ_COUNT]       = { REG_F_R,  PARSER_OTHERS,    reg_rd_traj, NULL               },
+    [REG_TRAJ_PT_BASE + 0] = { REG_F_RW, PARSER_OTHERS,    NULL, NULL                      },
+    [REG_TRAJ_PT_BASE + 1] = { REG_F_RW, PARSER_OTHERS,    NULL, NULL                      },
+    [REG_TRAJ_PT_BASE + 2] = { REG_F_RW, PARSER_OTHERS,    NULL, reg_wr_servo_cdeg         },
+    [REG_TRAJ_PT_BASE + 3] = { REG_F_RW, PARSER_OTHERS,    NULL, reg_wr_traj_pt            },
+    [REG_TRAJ_PT_BASE + 4] = { REG_F_RW, PARSER_OTHERS,    NULL, NULL                      },
+    [REG_TRAJ_PT_BASE + 5] = { REG_F_RW, PARSER_OTHERS,    NULL, NULL                      },
+    [REG_TRAJ_PT_BASE + 6] = { REG_F_RW, PARSER_OTHERS,    NULL, reg_wr_servo_cdeg         },
+    [REG_TRAJ_PT_BASE + 7] = { REG_F_RW, PARSER_OTHERS,    NULL, reg_wr_traj_pt            },
+    [REG_MOTOR_ACCEL]      = { REG_F_RW | REG_F_NV, PARSER_RAMP, NULL, reg_wr_non_negative },
+    [REG_MOTOR_JERK]       = { REG_F_RW | REG_F_NV, PARSER_RAMP, NULL, reg_wr_non_negative },
+    [REG_SERVO_ACCEL]      = { REG_F_RW | REG_F_NV, PARSER_RAMP, NULL, reg_wr_non_negative },
+    [REG_IMU_FILT]         = { REG_F_RW | REG_F_NV, PARSER_IMU_FILT, NULL, reg_wr_imu_filt },
+    [REG_IMU_FILT_DECIM]   = { REG_F_R,  PARSER_OTHERS, reg_rd_imu_filt, NULL             },
+    [REG_VIB_CMD]          = { REG_F_RW, PARSER_VIB,    NULL,            reg_wr_vib       },
+    [REG_VIB_AVG]          = { REG_F_RW, PARSER_VIB,    NULL,            reg_wr_vib       },
+    [REG_VIB_PEAK_DHZ]     = { REG_F_R,  PARSER_OTHERS, reg_rd_vib,      NULL             },
+    [REG_VIB_PEAK_MG]      = { REG_F_R,  PARSER_OTHERS, reg_rd_vib,      NULL             },
+    [REG_ACT_SEL]          = { REG_F_RW, PARSER_ACT,    NULL,            reg_wr_act_sel   },
+    [REG_ACT_CMD]          = { REG_F_RW, PARSER_ACT,    reg_rd_act,      NULL             },
+    [REG_ACT_OUT]          = { REG_F_R,  PARSER_OTHERS, reg_rd_act,      NULL             },
+    [REG_ACT_STATE]        = { REG_F_R,  PARSER_OTHERS, reg_rd_act,      NULL             },
+    [REG_CAPS]             = { REG_F_RW, PARSER_CAPS,   reg_rd_caps,     NULL             },
+    [REG_PARK_MS]          = { REG_F_RW | REG_F_NV, PARSER_OTHERS, NULL,     reg_wr_non_negative },
+    [REG_BATT_MV]          = { REG_F_R,  PARSER_OTHERS,    NULL,              NULL         },
+    [REG_BATT_NOM_MV]      = { REG_F_RW | REG_F_NV, PARSER_OTHERS, NULL,     reg_wr_non_negative },
+    [REG_REPLAY]           = { REG_F_RW, PARSER_OTHERS,    reg_rd_replay,     reg_wr_replay },
+};
+
+/**
+ * @brief  Lit un bloc de registres virtuels consécutifs.
+ * @details Les plages de registres mémorisés (lisibles, sans read hook) sont copiées
+ * d'un seul memcpy depuis reg_file ; les registres calculés passent par leur hook
+ * et les registres non lisibles valent 0. L'adresse reboucle après 0x7F.
+ * @param  addr  Adresse du premier registre.
+ * @param  count Nombre de registres.
+ * @param  out   Valeurs lues (count entrées).
+ */
+static void reg_read_block(uint8_t addr,uint8_t count,int16_t *out){
+    uint8_t i = 0;
+
+    while(i < count){
+        const uint8_t a = (uint8_t)((addr + i) & PROTO_HDR_ADDR_MASK);
+        const reg_desc_t *r = &reg_map[a];
+
+        if(!(r->flags & REG_F_R)){
+            out[i++] = 0;
+        }
+        else if(r->read != NULL){
+            out[i++] = r->read(a);
+        }
+        else{
+            uint8_t run = 1;
+            while((uint8_t)(i + run) < count && (uint8_t)(a + run) < REG_COUNT &&
+                  (reg_map[a + run].flags & REG_F_R) && reg_map[a + run].read == NULL){
+                run++;
+            }
+            memcpy(&out[i], &reg_file[a], (size_t)run * sizeof(int16_t));
+            i = (uint8_t)(i + run);
+        }
+    }
+}
+
+/**
+ * @brief  Met une commande reçue en file pour la boucle principale.
+ * @details La commande est datée deux fois : arrivée de ses octets (dernière fin de
+ * trame relevée par la réception DMA, cf. serial_cmd_reader()) et décodage. L'écart
+ * alimente la sonde PROF_PROBE_CMD_RX (attente dans le ring RX, lecteur série). Hors
+ * liaison UART (lien SPI, restauration NV, validation du banc), seule la date de
+ * décodage existe.
+ * @note   La place est garantie par serial_cmd_reader(), qui ne lit de nouveaux
+ * octets que si la file peut absorber toutes les commandes qu'ils contiennent.
+ * @param  cmd   Type de commande.
+ * @param  addr  Adresse du registre écrit.
+ * @param  value Valeur écrite.
+ */
+static inline void parser_post(ParserSwitch cmd,uint8_t addr,int16_t value){
+    if((cmd_head - cmd_tail) >= SERIAL_CMD_QUEUE_LEN){
+        return;
+    }
+    serial_cmd_t *e = &cmd_queue[cmd_head & (SERIAL_CMD_QUEUE_LEN - 1u)];
+    e->type  = (uint8_t)cmd;
+    e->addr  = addr;
+    e->value = value;
+    e->t_us  = GetMicrosTotal();
+    e->t_rx_us = e->t_us;
+    if(cmd_rx_us != 0u){
+        e->t_rx_us = cmd_rx_us;
+        prof_record(prof_probe(PROF_PROBE_CMD_RX), e->t_us - cmd_rx_us);
+    }
+    cmd_head++;
+}
+
+uint8_t serial_cmd_pop(serial_cmd_t *cmd){
+    if(cmd == NULL || cmd_tail == cmd_head){
+        return 0;
+    }
+    *cmd = cmd_queue[cmd_tail & (SERIAL_CMD_QUEUE_LEN - 1u)];
+    cmd_tail++;
+    return 1;
+}
+
+uint32_t serial_cmd_pending(void){
+    return cmd_head - cmd_tail;
+}
+
+uint16_t serial_telem_seq(void){
+    return telem_seq;
+}
+
+/**
+ * @brief  Nombre d'octets RX pouvant être analysés sans risque de saturer la file.
+ * @details Une trame produit au plus une commande par paire d'octets (trame groupée :
+ * 4 + 2n octets pour n commandes), fenêtre partielle déjà reçue comprise : lire
+ * 2 * (libre - PROTO_BURST_MAX_REGS) octets ne peut donc jamais déborder. Les octets
+ * non lus restent dans le buffer RX jusqu'à l'itération suivante.
+ * @return Nombre d'octets maximum à lire.
+ */
+static size_t cmd_rx_budget(void){
+    uint32_t free_slots = SERIAL_CMD_QUEUE_LEN - (cmd_head - cmd_tail);
+    if(free_slots <= PROTO_BURST_MAX_REGS){
+        return 0;
+    }
+    return (size_t)(2u * (free_slots - PROTO_BURST_MAX_REGS));
+}
+
+/** @brief Signale qu'une trame valide a été reçue (confirme une négociation de débit en cours). */
+static inline void link_frame_received(void){
+    if(link_st == LINK_CONFIRM){
+        link_st = LINK_IDLE;    // Trame valide reçue au nouveau débit : négociation confirmée
+    }
+}
+
+/**
+ * @brief  Applique l'écriture d'un registre virtuel.
+ * @details Accès direct au descripteur par l'adresse : le write hook éventuel
+ * filtre la valeur, qui est mémorisée dans reg_file puis mise en file pour la
+ * boucle principale. Une écriture sur un registre non inscriptible est seulement
+ * signalée (PARSER_OTHERS). Banc de préparation ouvert, un registre REG_F_NV est
+ * retenu dans reg_shadow sans effet (signalée PARSER_OTHERS pour le Failsafe).
+ * @param  addr   Adresse du registre.
+ * @param  data16 Valeur écrite.
+ */
+static void write_reg16(uint8_t addr,int16_t data16){
+    const reg_desc_t *r = &reg_map[addr & PROTO_HDR_ADDR_MASK];
+
+    if(!(r->flags & REG_F_W)){
+        parser_post(PARSER_OTHERS,addr,data16);
+        return;
+    }
+
+    if(nv_staging && (r->flags & REG_F_NV)){
+        reg_shadow[addr & PROTO_HDR_ADDR_MASK] = data16;
+        reg_shadow_dirty[(addr & PROTO_HDR_ADDR_MASK) >> 5] |= 1u << (addr & 31u);
+        parser_post(PARSER_OTHERS,addr,data16);
+        return;
+    }
+
+    if(r->write != NULL){
+        data16 = r->write(addr,data16);
+    }
+    reg_file[addr & PROTO_HDR_ADDR_MASK] = data16;
+    parser_post((ParserSwitch)r->cmd,addr,data16);
+}
+
+void serial_cmd_nv_restore(void){
+    int16_t value;
+
+    kv_init();
+
+    for(uint8_t a = 0; a < REG_COUNT; a++){
+        if((reg_map[a].flags & REG_F_NV) && kv_get(a, &value)){
+            write_reg16(a, value);
+            nv_status = NV_ST_LOADED;
+        }
+    }
+}
+
+/**
+ * @brief  Enregistre la valeur effective de chaque registre persistant.
+ * @details Les registres calculés (REG_IMU_CONFIG) sont relus par leur hook : c'est
+ * la configuration réellement appliquée qui est sauvegardée. Seules les valeurs
+ * modifiées depuis la dernière sauvegarde sont programmées.
+ * @return 0 si succès, code d'erreur de kv_set() au premier échec.
+ */
+static int8_t nv_save(void){
+    for(uint8_t a = 0; a < REG_COUNT; a++){
+        const reg_desc_t *r = &reg_map[a];
+
+        if(r->flags & REG_F_NV){
+            const int16_t v = (r->read != NULL) ? r->read(a) : reg_file[a];
+
+            const int8_t err = kv_set(a, v);
+            if(err != 0){
+                return err;
+            }
+        }
+    }
+
+    return 0;
+}
+
+nv_status_t serial_cmd_nv_exec(uint8_t request, uint8_t allowed){
+    if(request == NV_CMD_STAGE || request == NV_CMD_COMMIT || request == NV_CMD_DISCARD){
+        return nv_status;       // Déjà traitée à l'analyse (reg_wr_nv_cmd)
+    }
+    if(request != NV_CMD_SAVE && request != NV_CMD_CLEAR){
+        nv_status = NV_ST_E_INVALID;
+    }
+    else if(!allowed){
+        nv_status = NV_ST_E_BUSY;
+    }
+    else if(request == NV_CMD_SAVE){
+        nv_status = (nv_save() == 0) ? NV_ST_SAVED : NV_ST_E_FLASH;
+    }
+    else{
+        nv_status = (kv_clear() == 0) ? NV_ST_CLEARED : NV_ST_E_FLASH;
+    }
+
+    return nv_status;
 }
 
 /**
  * @brief  Traite une trame complète et validée par CRC.
  * @details Identifie si c'est une lecture ou une écriture.
- * - Écriture : Met à jour les variables shadow et l'état global du parseur.
- * - Lecture : Envoie immédiatement la réponse sur le port série.
+ * - Écriture : Met à jour le banc de registres et la file de commandes.
+ * - Lecture : Envoie immédiatement la réponse sur le port série (une trame
+ *   groupée si plusieurs registres sont demandés).
  * @param  hdr_b Octet d'entête reçu.
  * @param  d0_b  Octet de donnée 0 reçu.
  * @param  d1_b  Octet de donnée 1 reçu.
@@ -78,111 +1013,878 @@ static void handle_frame(uint8_t hdr_b,uint8_t d0_b,uint8_t d1_b){
 
     (void)udata16;
 
+    link_frame_received();
+
     if(is_read){
+        int16_t vals[PROTO_HDR_ADDR_MASK + 1u];
         uint8_t count=d0_b;
+        if(count > REG_COUNT){
+            count = REG_COUNT;
+        }
+        reg_read_block(addr,count,vals);
+#if SERIAL_CMD_FRAMED || SERIAL_TX_ENVELOPE
+        if(count > 1u){
+            (void)proto_send_data_burst(addr,vals,count);   // Une seule trame pour tout le bloc
+            return;
+        }
+#endif
         for(uint8_t i=0; i<count; i++){
-            uint8_t a = (uint8_t)((addr+i)&PROTO_HDR_ADDR_MASK);
-            int16_t v = read_reg16(a);
-            (void)proto_send_data16(a,v);
+            (void)proto_send_data16((uint8_t)((addr+i)&PROTO_HDR_ADDR_MASK),vals[i]);
         }
         return;
     }
 
-    switch(addr){
-        case REG_SERVO_CMD:
-            parser_state = PARSER_SERVO_CMD;
-            shadow_servo_cmd = data16;
-        break;
+    write_reg16(addr,data16);
+}
 
-        case REG_MOTOR_CMD:
-            parser_state = PARSER_MOTOR_CMD;
-            shadow_motor_cmd = data16;
-        break;
+/** @brief Abandonne la trame en cours de réception (changement de débit, etc.). */
+static void parse_reset(void){
+    st = S_HDR;
+#if SERIAL_CMD_FRAMED
+    rx_win_len = 0;
+#endif
+}
 
-        case REG_BMI:
-            parser_state = PARSER_BMI_CMD;
-        break;
+#if SERIAL_CMD_FRAMED
+/**
+ * @brief  Traite une trame d'écriture groupée validée par CRC.
+ * @details Toutes les écritures sont mises en file dans le même appel, dans l'ordre
+ * des adresses : la boucle principale les applique ensemble. Exceptions : une trame
+ * adressée à REG_REPLAY porte un enregistrement de rejeu, injecté directement ; une
+ * trame adressée à REG_FW_UPDATE, un bloc de page de mise à jour du firmware.
+ * @param  addr  Adresse du premier registre.
+ * @param  count Nombre de registres écrits.
+ * @param  data  Valeurs little-endian (2 octets par registre).
+ */
+static void handle_burst(uint8_t addr,uint8_t count,const uint8_t *data){
+    link_frame_received();
 
-        default:
-            parser_state = PARSER_OTHERS;
-        break;
+    if(addr == REG_REPLAY){
+        replay_push(data, count);
+        return;
+    }
+    if(addr == REG_FW_UPDATE){
+        fw_update_data(data, count);
+        return;
+    }
+
+    for(uint8_t i=0; i<count; i++){
+        write_reg16((uint8_t)((addr+i)&PROTO_HDR_ADDR_MASK), to_i16(data[2u*i],data[2u*i+1u]));
     }
 }
 
+/**
+ * @brief  Retourne la longueur attendue de la trame en tête de fenêtre.
+ * @return Longueur totale, 0 si pas encore connue, 0xFF si l'en-tête est invalide.
+ */
+static uint8_t rx_win_expected(void){
+    if(rx_win[0] == PROTO_SYNC){
+        return PROTO_FRAME_LEN;
+    }
+    if(rx_win_len < 3u){
+        return 0;
+    }
+    uint8_t count = rx_win[2];
+    if(count == 0 || count > PROTO_BURST_MAX_REGS){
+        return 0xFF;
+    }
+    return (uint8_t)PROTO_BURST_LEN(count);
+}
+
+/**
+ * @brief  Injecte un octet dans la fenêtre de réception synchronisée.
+ * @details La fenêtre commence toujours par PROTO_SYNC ou PROTO_SYNC_BURST. Une fois
+ * la trame complète, elle est acceptée si son CRC est valide ; sinon la fenêtre glisse
+ * jusqu'au prochain octet de synchronisation qu'elle contient, ce qui recale le parseur
+ * en au plus une trame après un octet perdu ou parasite, sans jamais accepter une trame décalée.
+ * @param  b Octet entrant.
+ */
+static void parse_byte(uint8_t b){
+    if(rx_win_len == 0 && b != PROTO_SYNC && b != PROTO_SYNC_BURST){
+        return;
+    }
+
+    rx_win[rx_win_len++] = b;
+
+    while(rx_win_len > 0){
+        uint8_t expected = rx_win_expected();
+        if(expected == 0 || (expected != 0xFF && rx_win_len < expected)){
+            return;
+        }
+
+        uint8_t used = 0;
+        if(expected != 0xFF){
+            uint8_t crc = crc8_compute(&rx_win[1], (uint16_t)(expected - 2u));
+            if(crc == rx_win[expected - 1u]){
+                link_rx_frames++;
+                if(rx_win[0] == PROTO_SYNC){
+                    handle_frame(rx_win[1], rx_win[2], rx_win[3]);
+                }
+                else{
+                    handle_burst(rx_win[1], rx_win[2], &rx_win[3]);
+                }
+                used = expected;
+            }
+        }
+
+        if(used == 0){
+            /* Trame invalide : glissement jusqu'au prochain octet de synchronisation */
+            link_rx_rejected++;
+            used = 1;
+            while(used < rx_win_len && rx_win[used] != PROTO_SYNC && rx_win[used] != PROTO_SYNC_BURST){
+                used++;
+            }
+        }
+
+        rx_win_len = (uint8_t)(rx_win_len - used);
+        memmove(rx_win, &rx_win[used], rx_win_len);
+    }
+}
+#else
 /**
  * @brief  Injecte un octet dans la machine à états de réception.
- * @note   Vérifie le CRC à la fin de la séquence. Si OK, appelle handle_frame.
+ * @note   Le CRC est cumulé octet par octet (crc8_update) puis comparé à la fin
+ * de la séquence. Si OK, appelle handle_frame.
  * @param  b Octet entrant.
  */
 static void parse_byte(uint8_t b){
     switch(st){
-        case S_HDR:hdr=b;st=S_D0;break;
-        case S_D0:d0=b;st=S_D1;break;
-        case S_D1:d1=b;st=S_CRC;break;
-        case S_CRC:{
-            uint8_t buf[3]={hdr,d0,d1};
-            uint8_t crc=serial_crc8_atm(buf,3);
-            if(crc==b)handle_frame(hdr,d0,d1);
+        case S_HDR:hdr=b;rx_crc=crc8_update(CRC8_INIT,b);st=S_D0;break;
+        case S_D0:d0=b;rx_crc=crc8_update(rx_crc,b);st=S_D1;break;
+        case S_D1:d1=b;rx_crc=crc8_update(rx_crc,b);st=S_CRC;break;
+        case S_CRC:
+            if(rx_crc==b){
+                link_rx_frames++;
+                handle_frame(hdr,d0,d1);
+            }
+            else{
+                link_rx_rejected++;
+            }
             st=S_HDR;
-        }
         break;
         default:st=S_HDR;break;
     }
 }
+#endif
+
+#if SERIAL_CMD_FRAMED
+/**
+ * @brief  Décode un bloc de trames de commande complètes (transport à trames fixes).
+ * @details Indépendant de la fenêtre de réception série : chaque trame doit tenir
+ * entière dans le bloc, le reste (bourrage, trame tronquée) est ignoré. Les trames
+ * valides suivent le même chemin que sur l'UART (handle_frame / handle_burst) ; les
+ * réponses aux lectures partent sur le port série.
+ * @param  data Bloc reçu.
+ * @param  len  Longueur du bloc.
+ */
+void serial_cmd_feed_block(const uint8_t *data, size_t len){
+    size_t i = 0;
+
+    while(i < len){
+        const uint8_t b = data[i];
+        size_t flen;
+
+        if(b == PROTO_SYNC){
+            flen = PROTO_FRAME_LEN;
+        }
+        else if(b == PROTO_SYNC_BURST && (i + 3u) <= len && data[i + 2u] != 0 && data[i + 2u] <= PROTO_BURST_MAX_REGS){
+            flen = PROTO_BURST_LEN(data[i + 2u]);
+        }
+        else{
+            i++;
+            continue;
+        }
+
+        if((i + flen) > len || crc8_compute(&data[i + 1u], (uint16_t)(flen - 2u)) != data[i + flen - 1u]){
+            i++;
+            continue;
+        }
+
+        link_rx_frames++;
+        if(b == PROTO_SYNC){
+            handle_frame(data[i + 1u], data[i + 2u], data[i + 3u]);
+        }
+        else{
+            handle_burst(data[i + 1u], data[i + 2u], &data[i + 3u]);
+        }
+        i += flen;
+    }
+}
+#endif
+
+/**
+ * @brief  Fait avancer la négociation de débit.
+ * @details Bascule au débit demandé une fois l'acquittement entièrement émis,
+ * puis revient à 115200 bauds si l'hôte ne confirme pas dans SERIAL_BAUD_CONFIRM_MS.
+ */
+static void link_poll(void){
+    switch(link_st){
+        case LINK_SWITCH:
+            if(serial_set_baud(baud_table[link_code]) == 0){
+                link_code_cur = link_code;
+                link_switch_ms = HAL_GetTick();
+                parse_reset();
+                link_st = LINK_CONFIRM;
+            }
+        break;
+
+        case LINK_CONFIRM:
+            if((HAL_GetTick() - link_switch_ms) >= SERIAL_BAUD_CONFIRM_MS){
+                if(serial_set_baud(baud_table[SERIAL_BAUD_CODE_115200]) == 0){
+                    link_code_cur = SERIAL_BAUD_CODE_115200;
+                    parse_reset();
+                    link_st = LINK_IDLE;
+                }
+            }
+        break;
+
+        default:
+        break;
+    }
+}
+
+/**
+ * @brief  Met à jour le débit de trames valides reçues (fenêtre LINK_RATE_WINDOW_MS).
+ */
+static void link_rate_poll(void){
+    const uint32_t now = HAL_GetTick();
+    const uint32_t elapsed = now - link_rate_start_ms;
+
+    if(elapsed >= LINK_RATE_WINDOW_MS){
+        uint32_t rate = (link_rx_frames * 1000u) / elapsed;
+        link_rx_rate = (rate > UINT16_MAX) ? UINT16_MAX : (uint16_t)rate;
+        link_rx_frames = 0;
+        link_rate_start_ms = now;
+    }
+}
 
 /**
  * @brief  Fonction principale de lecture (Polling).
  * @details Récupère les données brutes du buffer circulaire RX et les passe
- * octet par octet à la machine à états.
+ * octet par octet à la machine à états. Les octets sont lus en place dans le
+ * buffer RX (buffer DMA en mode zero-copy), sans copie intermédiaire, et en
+ * zero-copy jusqu'à la dernière frontière de trame relevée
+ * par l'USART (SERIAL_RX_HW_FRAMING) : rien n'est analysé tant qu'aucune trame
+ * n'est terminée. La lecture s'arrête dès que la file de
+ * commandes ne peut plus absorber le pire cas (cmd_rx_budget) : les octets
+ * restants attendent l'itération suivante, aucune commande n'est perdue.
+ * Les commandes décodées sont datées de la dernière arrivée d'octets relevée par la
+ * réception (fin de trame USART, événement IDLE, ou première observation en
+ * zero-copy sans SERIAL_RX_HW_FRAMING) : pour plusieurs trames lues d'un coup, c'est
+ * l'arrivée de la dernière, et la latence des premières est sous-estimée d'autant.
+ * Gère aussi la négociation de débit.
  */
 void serial_cmd_reader(void){
-    uint8_t tmp[64];
-    size_t n = serial_read(tmp,sizeof(tmp));
-    if(!n)return;
-    for(size_t i=0;i<n;i++){
-        parse_byte(tmp[i]);
+    link_poll();
+    link_rate_poll();
+
+    const uint8_t *span;
+    size_t n;
+    size_t budget;
+    while((budget = cmd_rx_budget()) != 0 && (n = serial_rx_peek_frames(&span)) != 0){
+        if(n > budget){
+            n = budget;
+        }
+        cmd_rx_us = serial_rx_last_us();
+        for(size_t i=0;i<n;i++){
+            parse_byte(span[i]);
+        }
+        serial_rx_consume(n);
+    }
+    cmd_rx_us = 0;
+}
+
+/**
+ * @brief  Lit des registres hors liaison (console texte, console.h).
+ * @param  addr  Premier registre.
+ * @param  count Nombre de registres (adresses rebouclées modulo 128).
+ * @param  out   Valeurs lues (0 pour un registre non lisible).
+ */
+void serial_cmd_reg_read(uint8_t addr, uint8_t count, int16_t *out){
+    reg_read_block((uint8_t)(addr & PROTO_HDR_ADDR_MASK), count, out);
+}
+
+/**
+ * @brief  Écrit un registre hors liaison, par le même chemin qu'une trame reçue.
+ * @details Hooks, banc de préparation et file de commandes compris. La même réserve de
+ * file que pour la liaison (cmd_rx_budget()) est exigée : une trame groupée en cours
+ * de réception trouve toujours sa place.
+ * @param  addr  Registre.
+ * @param  value Valeur.
+ * @return 0 si l'écriture est prise en compte, -1 si la file de commandes est pleine.
+ */
+int serial_cmd_reg_write(uint8_t addr, int16_t value){
+    if(cmd_rx_budget() == 0){
+        return -1;
+    }
+    write_reg16((uint8_t)(addr & PROTO_HDR_ADDR_MASK), value);
+    return 0;
+}
+
+/**
+ * @brief Trames de télémétrie 0x01 / 0x02 en construction.
+ * @details Chaque champ est sérialisé une seule fois, dès qu'il est disponible, et le
+ * CRC le suit dans l'ordre de la trame : en-tête fixe (CRC précalculé au premier
+ * usage), échantillon IMU (séquence, date, axes) au retrait de la file, vitesse
+ * convertie seulement quand une nouvelle estimation est publiée (speed_pub.h). L'envoi
+ * se réduit à prolonger le CRC sur les octets de vitesse puis à recopier la trame
+ * dans le ring TX : aucune relecture de la trame entière sur le chemin d'émission.
+ */
+static struct{
+    SerialImuFrame_t   legacy;      ///< Trame flottante (type 0x01).
+    SerialImuFrameFx_t fx;          ///< Trame virgule fixe (type 0x02).
+    uint8_t  hdr_crc_legacy;        ///< CRC de l'en-tête fixe de la trame 0x01.
+    uint8_t  hdr_crc_fx;            ///< CRC de l'en-tête fixe de la trame 0x02.
+    uint8_t  hdr_ready;             ///< En-têtes et CRC précalculés.
+    uint32_t speed_rank;            ///< Rang de la dernière estimation convertie (0 : aucune).
+    float    speed_ms;              ///< Vitesse convertie pour la trame 0x01 (m/s).
+    int16_t  speed_mms;             ///< Vitesse convertie pour la trame 0x02 (mm/s).
+} telem_stage;
+
+/**
+ * @brief  Précalcule les en-têtes fixes des trames 0x01 / 0x02 et leur CRC.
+ * @note   Au premier envoi : crc8_init() a alors été appelé par serial_init().
+ */
+static void telem_stage_headers(void){
+    /* payload: seq(2) + timestamp(4) + accel(12) + gyro(12) + speed(4) = 34 */
+    telem_stage.legacy.head1 = 0xAA;
+    telem_stage.legacy.head2 = 0x55;
+    telem_stage.legacy.type  = TELEM_TYPE_LEGACY;
+    telem_stage.legacy.len   = 34;
+    telem_stage.hdr_crc_legacy = crc8_extend(CRC8_INIT, (const uint8_t*)&telem_stage.legacy,
+                                             offsetof(SerialImuFrame_t, seq));
+
+    /* payload: seq(2) + timestamp(4) + accel(12) + gyro(12) + speed(2) = 32 */
+    telem_stage.fx.head1 = 0xAA;
+    telem_stage.fx.head2 = 0x55;
+    telem_stage.fx.type  = TELEM_TYPE_FX;
+    telem_stage.fx.len   = 32;
+    telem_stage.hdr_crc_fx = crc8_extend(CRC8_INIT, (const uint8_t*)&telem_stage.fx,
+                                         offsetof(SerialImuFrameFx_t, seq));
+    telem_stage.hdr_ready = 1;
+}
+
+/**
+ * @brief  Met à jour la vitesse sérialisée si une nouvelle estimation a été publiée.
+ */
+static void telem_stage_speed(void){
+    speed_sample_t s;
+    const uint32_t rank = speed_pub_read(&speed_pub, &s);
+
+    if(rank != telem_stage.speed_rank){
+        telem_stage.speed_rank = rank;
+        telem_stage.speed_ms   = (float)s.speed_mms / 1000.0f;     // Vitesse estimée, déjà signée
+        telem_stage.speed_mms  = (int16_t)s.speed_mms;
+    }
+}
+
+/**
+ * @brief  Recopie une trame préparée dans le ring TX et la valide.
+ * @param  frame Trame complète (CRC compris).
+ * @param  len   Taille de la trame.
+ */
+static void telem_stage_commit(const void *frame, uint16_t len){
+    serial_tx_span_t span;
+
+    if(serial_tx_reserve(len, &span) == 0){
+        serial_tx_span_copy(&span, frame);
+        serial_tx_commit();
     }
 }
 
 /**
  * @brief  Construit et envoie la trame de télémétrie complète.
  * @details
- * 1. Lit l'IMU (Accéléromètre + Gyroscope).
- * 2. Récupère la vitesse (Speedometer).
- * 3. Déduit le signe de la vitesse grâce à la commande moteur (Marche AR).
- * 4. Formate le paquet binaire (SerialImuFrame_t) avec CRC.
- * 5. Envoie le tout de manière non-bloquante via DMA.
+ * 1. Reçoit l'échantillon IMU (Accéléromètre + Gyroscope) acquis par DMA.
+ * 2. Sérialise séquence, date et axes derrière l'en-tête précalculé, CRC à la suite.
+ * 3. Ajoute la vitesse estimée (déjà signée, convertie à la publication).
+ * 4. Recopie la trame dans le ring TX, envoyée de manière non-bloquante via DMA.
+ * @param  imu_data Échantillon IMU en unités physiques.
+ */
+void serial_send_data_frame(const bmi088_data_t *imu_data) {
+    SerialImuFrame_t *frame = &telem_stage.legacy;
+
+    if (imu_data == NULL) {
+        return;
+    }
+    if (!telem_stage.hdr_ready) {
+        telem_stage_headers();
+    }
+
+    /* La séquence avance même si la trame est refusée : l'hôte voit le trou */
+    frame->seq       = telem_seq++;
+    frame->timestamp = (uint32_t)imu_data->timestamp_us;
+
+    frame->accel[0] = imu_data->accel_x_mms2;
+    frame->accel[1] = imu_data->accel_y_mms2;
+    frame->accel[2] = imu_data->accel_z_mms2;
+
+    frame->gyro[0]  = imu_data->gyro_x_rads;
+    frame->gyro[1]  = imu_data->gyro_y_rads;
+    frame->gyro[2]  = imu_data->gyro_z_rads;
+
+    uint8_t crc = crc8_extend(telem_stage.hdr_crc_legacy, (const uint8_t*)&frame->seq,
+                              offsetof(SerialImuFrame_t, speed) - offsetof(SerialImuFrame_t, seq));
+
+    telem_stage_speed();
+    frame->speed = telem_stage.speed_ms;
+    for (uint8_t i = 0; i < sizeof(frame->speed); i++) {
+        crc = crc8_update(crc, ((const uint8_t*)&frame->speed)[i]);
+    }
+    frame->crc = crc;
+
+    telem_stage_commit(frame, sizeof(SerialImuFrame_t));
+}
+
+/**
+ * @brief  Construit et envoie la trame de télémétrie virgule fixe (type 0x02).
+ * @details Même séquence que serial_send_data_frame, sans aucune opération
+ * flottante sur l'IMU ; seule la vitesse est convertie en mm/s.
+ * @param  imu_data Échantillon IMU en virgule fixe.
  */
-void serial_send_data_frame(void) {
-    bmi088_data_t imu_data;
+void serial_send_data_frame_fx(const bmi088_data_fx_t *imu_data) {
+    SerialImuFrameFx_t *frame = &telem_stage.fx;
 
-    if (BMI088_Read_All(&imu_data) != BMI08_OK) {
+    if (imu_data == NULL) {
         return;
     }
+    if (!telem_stage.hdr_ready) {
+        telem_stage_headers();
+    }
+
+    frame->seq       = telem_seq++;
+    frame->timestamp = (uint32_t)imu_data->timestamp_us;
+
+    frame->accel[0] = imu_data->accel_mms2[0];
+    frame->accel[1] = imu_data->accel_mms2[1];
+    frame->accel[2] = imu_data->accel_mms2[2];
+
+    frame->gyro[0]  = imu_data->gyro_urads[0];
+    frame->gyro[1]  = imu_data->gyro_urads[1];
+    frame->gyro[2]  = imu_data->gyro_urads[2];
+
+    uint8_t crc = crc8_extend(telem_stage.hdr_crc_fx, (const uint8_t*)&frame->seq,
+                              offsetof(SerialImuFrameFx_t, speed) - offsetof(SerialImuFrameFx_t, seq));
+
+    telem_stage_speed();
+    frame->speed = telem_stage.speed_mms;
+    for (uint8_t i = 0; i < sizeof(frame->speed); i++) {
+        crc = crc8_update(crc, ((const uint8_t*)&frame->speed)[i]);
+    }
+    frame->crc = crc;
 
-    static SerialImuFrame_t frame;
+    telem_stage_commit(frame, sizeof(SerialImuFrameFx_t));
+}
+
+/** @brief Ajoute `len` octets à la trame en construction et fait avancer le curseur. */
+static inline uint8_t *telem_put(uint8_t *p,const void *src,size_t len){
+    memcpy(p,src,len);
+    return p + len;
+}
 
-    frame.head1 = 0xAA;
-    frame.head2 = 0x55;
-    frame.type  = 0x01;
-    /* payload: timestamp(4) + accel(12) + gyro(12) + speed(4) = 32 */
-    frame.len   = 32;
-    frame.timestamp = HAL_GetTick();
+/**
+ * @brief  Remplit une trame à contenu choisi (types 0x03 et 0x0F).
+ * @details Seuls les champs demandés sont émis, dans l'ordre des bits TELEM_F_*, en
+ * little-endian et en virgule fixe.
+ * @param  buf      Bloc de frame_pool.
+ * @param  type     Type de trame.
+ * @param  seq      Numéro de séquence.
+ * @param  ts32     Date de la trame (µs).
+ * @param  fields   Masque des champs à émettre.
+ * @param  imu_data Échantillon IMU en virgule fixe.
+ * @param  status   Données d'état hors IMU.
+ * @return Pointeur après le CRC.
+ */
+static uint8_t *telem_fields_build(uint8_t *buf, uint8_t type, uint16_t seq, uint32_t ts32, uint8_t fields,
+                                   const bmi088_data_fx_t *imu_data, const telem_status_t *status) {
+    uint8_t *p = &buf[4];
+
+    fields &= TELEM_F_ALL;
+
+    buf[0] = 0xAA;
+    buf[1] = 0x55;
+    buf[2] = type;
+
+    p = telem_put(p, &seq, 2);
+    p = telem_put(p, &ts32, 4);
+    *p++ = fields;
+
+    if (fields & TELEM_F_ACCEL) {
+        p = telem_put(p, imu_data->accel_mms2, sizeof(imu_data->accel_mms2));
+    }
+    if (fields & TELEM_F_GYRO) {
+        p = telem_put(p, imu_data->gyro_urads, sizeof(imu_data->gyro_urads));
+    }
+    if (fields & TELEM_F_SPEED) {
+        p = telem_put(p, &status->speed_mms, 2);
+    }
+    if (fields & TELEM_F_MOTOR) {
+        p = telem_put(p, &status->motor_cmd_mms, 2);
+        *p++ = status->motor_state;
+    }
+    if (fields & TELEM_F_SERVO) {
+        *p++ = (uint8_t)status->servo_cmd;
+    }
+    if (fields & TELEM_F_TIMING) {
+        p = telem_put(p, &status->cmd_latency_max_us, 4);
+        p = telem_put(p, &status->imu_dropped, 4);
+    }
+    if (fields & TELEM_F_ATTITUDE) {
+        p = telem_put(p, status->attitude_q14, sizeof(status->attitude_q14));
+    }
+    if (fields & TELEM_F_SENSOR) {
+        p = telem_put(p, &imu_data->sensor_time, 4);
+        p = telem_put(p, &status->imu_temp_cdeg, 2);
+    }
+
+    /* payload: de timestamp au dernier champ, CRC exclu */
+    buf[3] = (uint8_t)(p - &buf[4]);
+    *p = serial_crc8_atm(buf, (uint16_t)(p - buf));
+    return p + 1;
+}
+
+/**
+ * @brief  Construit et envoie la trame de télémétrie à contenu choisi (type 0x03).
+ * @details Seuls les champs demandés par l'hôte (REG_TELEM_FIELDS) sont émis. La trame est
+ * construite dans un bloc de frame_pool, confiée au ring TX en une seule écriture ;
+ * si la liaison SPI est active, le bloc lui est ensuite remis tel quel (sans recopie).
+ * @param  fields   Masque des champs à émettre.
+ * @param  imu_data Échantillon IMU en virgule fixe.
+ * @param  status   Données d'état hors IMU.
+ */
+void serial_send_telemetry(uint8_t fields, const bmi088_data_fx_t *imu_data, const telem_status_t *status) {
+    if (imu_data == NULL || status == NULL) {
+        return;
+    }
+
+    uint8_t *buf = pool_alloc(&frame_pool);
+    if (buf == NULL) {
+        return;
+    }
+
+    uint8_t *p = telem_fields_build(buf, TELEM_TYPE_FIELDS, telem_seq, (uint32_t)imu_data->timestamp_us,
+                                    fields, imu_data, status);
+    telem_seq++;
+
+    (void)serial_write_all_nb(buf, (uint16_t)(p - buf));
+#if SPI_LINK_ENABLE
+    /* Le bloc passe à la liaison SPI, qui le rend au pool une fois émis */
+    memset(p, 0, FRAME_POOL_BLOCK_LEN - (size_t)(p - buf));
+    spi_link_publish_block(buf);
+#else
+    pool_free(&frame_pool, buf);
+#endif
+}
+
+void serial_send_status(uint8_t fields, const bmi088_data_fx_t *imu_data, const telem_status_t *status) {
+    static uint16_t status_seq = 0;
+
+    if (imu_data == NULL || status == NULL) {
+        return;
+    }
+
+    uint8_t *buf = pool_alloc(&frame_pool);
+    if (buf == NULL) {
+        return;
+    }
+
+    uint8_t *p = telem_fields_build(buf, TELEM_TYPE_STATUS, status_seq, GetMicrosTotal(), fields, imu_data, status);
+    status_seq++;
+
+    (void)serial_write_all_nb(buf, (uint16_t)(p - buf));
+    pool_free(&frame_pool, buf);
+}
+
+/**
+ * @brief  Construit et envoie la trame de télémétrie compacte (type 0x04).
+ * @details Axes int16 natifs, timestamp µs et vitesse int16 :
+ * 26 octets au lieu de 39 pour la trame flottante.
+ * @param  sample    Échantillon brut daté.
+ * @param  ranges    Gammes capteur.
+ * @param  speed_mms Vitesse signée du véhicule (mm/s).
+ */
+void serial_send_compact_frame(const telem_raw_sample_t *sample, uint8_t ranges, int16_t speed_mms) {
+    if (sample == NULL) {
+        return;
+    }
+
+    const uint16_t seq = telem_seq++;
+
+    serial_tx_span_t span;
+    if (serial_tx_reserve(sizeof(SerialImuFrameCompact_t), &span) != 0) {
+        return;
+    }
 
-    frame.accel[0] = imu_data.accel_x_mms2;
-    frame.accel[1] = imu_data.accel_y_mms2;
-    frame.accel[2] = imu_data.accel_z_mms2;
+    /* Construction en place dans le ring TX, ou dans une copie locale si la zone est coupée */
+    SerialImuFrameCompact_t local;
+    SerialImuFrameCompact_t *frame = (span.len2 == 0) ? (SerialImuFrameCompact_t*)span.p1 : &local;
 
-    frame.gyro[0]  = imu_data.gyro_x_rads;
-    frame.gyro[1]  = imu_data.gyro_y_rads;
-    frame.gyro[2]  = imu_data.gyro_z_rads;
+    frame->head1 = 0xAA;
+    frame->head2 = 0x55;
+    frame->type  = TELEM_TYPE_COMPACT;
+    /* payload: seq(2) + timestamp(4) + ranges(1) + accel(6) + gyro(6) + speed(2) = 21 */
+    frame->len   = 21;
+    frame->seq   = seq;
+    frame->timestamp = (uint32_t)sample->timestamp_us;
+    frame->ranges    = ranges;
 
-    frame.speed = speed_speedo_data;
-    frame.speed = (shadow_motor_cmd < 0) ? frame.speed * -1 : frame.speed; // Prise en compte de la commande pour le sens de rotation
+    frame->accel[0] = sample->raw.accel[0];
+    frame->accel[1] = sample->raw.accel[1];
+    frame->accel[2] = sample->raw.accel[2];
 
-    uint8_t *raw_bytes = (uint8_t*)&frame;
+    frame->gyro[0]  = sample->raw.gyro[0];
+    frame->gyro[1]  = sample->raw.gyro[1];
+    frame->gyro[2]  = sample->raw.gyro[2];
 
-    frame.crc = serial_crc8_atm(raw_bytes, sizeof(SerialImuFrame_t) - 1);
+    frame->speed = speed_mms;
+
+    uint8_t *raw_bytes = (uint8_t*)frame;
+
+    frame->crc = serial_crc8_atm(raw_bytes, sizeof(SerialImuFrameCompact_t) - 1);
+
+    if (frame == &local) {
+        serial_tx_span_copy(&span, &local);
+    }
+
+    serial_tx_commit();
+}
+
+/** @brief Retourne l'axe `i` (0-2 accéléromètre, 3-5 gyroscope) d'un échantillon brut. */
+static inline int16_t telem_axis(const bmi088_raw_t *raw, uint8_t i){
+    return (i < 3u) ? raw->accel[i] : raw->gyro[i - 3u];
+}
+
+/**
+ * @brief  Construit et envoie un lot d'échantillons encodés en delta (type 0x05).
+ * @details Le premier échantillon est transmis en absolu, les suivants en écarts
+ * int8 par axe (8 octets par échantillon en régime normal). Un écart trop grand
+ * est échappé et transmis en absolu, l'hôte n'accumule donc jamais d'erreur.
+ * @param  samples   Échantillons, du plus ancien au plus récent.
+ * @param  count     Nombre d'échantillons.
+ * @param  ranges    Gammes capteur.
+ * @param  speed_mms Vitesse signée du véhicule (mm/s).
+ */
+void serial_send_delta_batch(const telem_raw_sample_t *samples, uint8_t count, uint8_t ranges, int16_t speed_mms) {
+    uint8_t buf[TELEM_DELTA_MAX_LEN];
+    uint8_t *p = &buf[4];
+
+    if (samples == NULL || count == 0 || count > TELEM_DELTA_MAX_SAMPLES) {
+        return;
+    }
+
+    buf[0] = 0xAA;
+    buf[1] = 0x55;
+    buf[2] = TELEM_TYPE_DELTA;
+
+    p = telem_put(p, &telem_seq, 2);
+    telem_seq++;
+    const uint32_t ts32 = (uint32_t)samples[0].timestamp_us;
+    p = telem_put(p, &ts32, 4);
+    *p++ = ranges;
+    *p++ = count;
+    p = telem_put(p, &speed_mms, 2);
+    p = telem_put(p, samples[0].raw.accel, sizeof(samples[0].raw.accel));
+    p = telem_put(p, samples[0].raw.gyro, sizeof(samples[0].raw.gyro));
+
+    for (uint8_t n = 1; n < count; n++) {
+        uint64_t dt = samples[n].timestamp_us - samples[n - 1u].timestamp_us;
+        uint16_t dt16 = (uint16_t)((dt > 0xFFFFu) ? 0xFFFFu : dt);
+        p = telem_put(p, &dt16, 2);
+
+        for (uint8_t i = 0; i < 6u; i++) {
+            int16_t cur = telem_axis(&samples[n].raw, i);
+            int32_t d = (int32_t)cur - (int32_t)telem_axis(&samples[n - 1u].raw, i);
+            if (d >= -127 && d <= 127) {
+                *p++ = (uint8_t)(int8_t)d;
+            }
+            else {
+                *p++ = (uint8_t)TELEM_DELTA_ESCAPE;
+                p = telem_put(p, &cur, 2);
+            }
+        }
+    }
+
+    buf[3] = (uint8_t)(p - &buf[4]);
+    *p = serial_crc8_atm(buf, (uint16_t)(p - buf));
+    p++;
+
+    (void)serial_write_all_nb(buf, (uint16_t)(p - buf));
+}
+
+/**
+ * @brief  Répond à une écriture de REG_PING par une trame d'écho (type 0x06).
+ * @details Trame émise par la file prioritaire (serial_write_ctrl_nb()), comme les
+ * réponses de commande. La date de remise au TX est relevée juste avant le lancement
+ * du DMA : l'hôte en déduit la part de la liaison (USB-VCP, UART, DMA TX) dans l'aller-retour.
+ * @param  token      Valeur écrite dans REG_PING.
+ * @param  t_parse_us Date de mise en file de la commande (serial_cmd_t::t_us).
+ * @param  t_app_us   Date de son traitement par la boucle principale.
+ */
+void serial_send_echo(uint16_t token, uint32_t t_parse_us, uint32_t t_app_us) {
+    SerialEchoFrame_t frame;
+
+    frame.head1   = 0xAA;
+    frame.head2   = 0x55;
+    frame.type    = TELEM_TYPE_ECHO;
+    /* payload: token(2) + 4 dates(16) = 18 */
+    frame.len     = 18;
+    frame.token   = token;
+    frame.t_rx    = ping_rx_us;
+    frame.t_parse = t_parse_us;
+    frame.t_app   = t_app_us;
+    frame.t_tx    = GetMicrosTotal();
+    frame.crc     = serial_crc8_atm((uint8_t*)&frame, sizeof(SerialEchoFrame_t) - 1);
+
+    (void)serial_write_ctrl_nb((const uint8_t*)&frame, sizeof(SerialEchoFrame_t));
+}
+
+/**
+ * @brief  Répond à une écriture de REG_CAPS par la trame de capacités (type 0x0B).
+ * @details Tout est fixé à la compilation : les types de trame suivent les modules
+ * présents dans le build (historique, journal, analyse vibratoire). Trame émise par la
+ * file prioritaire, comme l'écho.
+ * @param  app_types Types de trame émis par l'application (bit n pour le type n).
+ */
+void serial_send_caps(uint16_t app_types) {
+    SerialCapsFrame_t frame;
+    uint16_t types = (uint16_t)((TELEMETRY_FIXED_POINT ? (1u << TELEM_TYPE_FX) : (1u << TELEM_TYPE_LEGACY)) |
+                                (1u << TELEM_TYPE_FIELDS) | (1u << TELEM_TYPE_COMPACT) |
+                                (1u << TELEM_TYPE_DELTA) | (1u << TELEM_TYPE_ECHO) | (1u << TELEM_TYPE_CAPS) |
+                                (1u << TELEM_TYPE_SNAP) | (1u << TELEM_TYPE_STATUS) |
+                                (SERIAL_TX_ENVELOPE ? (1u << TELEM_TYPE_REG) : 0u));
+#if DLOG_ENABLE
+    types |= (uint16_t)(1u << TELEM_TYPE_LOG);
+#endif
+#if IMU_HIST_ENABLE
+    types |= (uint16_t)(1u << TELEM_TYPE_HIST);
+#if IMU_HIST_PACK
+    types |= (uint16_t)(1u << TELEM_TYPE_HIST_PACKED);
+#endif
+#endif
+#if VIB_ENABLE
+    types |= (uint16_t)(1u << TELEM_TYPE_VIB);
+#endif
+
+    frame.head1          = 0xAA;
+    frame.head2          = 0x55;
+    frame.type           = TELEM_TYPE_CAPS;
+    frame.len            = (uint8_t)(sizeof(SerialCapsFrame_t) - 5u);
+    frame.version        = PROTO_VERSION;
+    frame.types          = (uint16_t)(types | app_types);
+    frame.fields         = TELEM_F_ALL;
+    frame.formats        = (uint8_t)((1u << TELEM_FMT_LEGACY) | (1u << TELEM_FMT_COMPACT));
+    frame.rate_min_hz    = TELEM_RATE_MIN_HZ;
+    frame.rate_max_hz    = TELEM_RATE_MAX_HZ;
+    frame.bauds          = (uint8_t)((1u << (SERIAL_BAUD_CODE_2M + 1)) - 1u);
+    frame.link           = (uint8_t)((SERIAL_CMD_FRAMED ? CAPS_LINK_FRAMED : 0u) |
+                                     (SPI_LINK_ENABLE ? CAPS_LINK_SPI : 0u) |
+                                     (SERIAL_TX_ENVELOPE ? CAPS_LINK_ENVELOPE : 0u) |
+                                     (SERIAL_TX_COBS ? CAPS_LINK_COBS : 0u) |
+                                     (FW_UPDATE_ENABLE ? CAPS_LINK_FW_UPDATE : 0u));
+    frame.burst_max_regs = PROTO_BURST_MAX_REGS;
+    frame.cmd_queue_len  = SERIAL_CMD_QUEUE_LEN;
+    frame.rx_ring        = SERIAL_RX_RING_SIZE;
+    frame.tx_ring        = SERIAL_TX_RING_SIZE;
+    frame.batch_max      = TELEM_DELTA_MAX_SAMPLES;
+    frame.crc            = serial_crc8_atm((uint8_t*)&frame, sizeof(SerialCapsFrame_t) - 1);
+
+    (void)serial_write_ctrl_nb((const uint8_t*)&frame, sizeof(SerialCapsFrame_t));
+}
+
+/**
+ * @brief  Répond à une écriture de REG_SNAPSHOT par la trame d'état instantané (type 0x0E).
+ * @details Le relevé lui-même appartient à l'application ; la trame part par la file
+ * prioritaire, comme l'écho : pas de file de télémétrie à traverser.
+ * @param  frame Trame dont le payload (après le jeton) est renseigné.
+ * @param  token Valeur écrite dans REG_SNAPSHOT.
+ */
+void serial_send_snapshot(SerialSnapFrame_t *frame, uint16_t token) {
+    if (frame == NULL) {
+        return;
+    }
+
+    frame->head1 = 0xAA;
+    frame->head2 = 0x55;
+    frame->type  = TELEM_TYPE_SNAP;
+    frame->len   = (uint8_t)(sizeof(SerialSnapFrame_t) - 5u);
+    frame->token = token;
+    frame->crc   = serial_crc8_atm((uint8_t*)frame, sizeof(SerialSnapFrame_t) - 1);
+
+    (void)serial_write_ctrl_nb((const uint8_t*)frame, sizeof(SerialSnapFrame_t));
+}
+
+/**
+ * @brief  Acquitte une commande de mise à jour du firmware (type 0x10).
+ * @details Trame émise par la file prioritaire, comme l'écho : l'hôte attend cet
+ * acquittement avant d'envoyer la page suivante (contrôle de flux).
+ */
+void serial_send_fw(uint8_t op, uint8_t status, uint16_t arg, uint8_t staged, uint32_t page_crc) {
+    SerialFwFrame_t frame;
+
+    frame.head1    = 0xAA;
+    frame.head2    = 0x55;
+    frame.type     = TELEM_TYPE_FW;
+    frame.len      = (uint8_t)(sizeof(SerialFwFrame_t) - 5u);
+    frame.op       = op;
+    frame.status   = status;
+    frame.arg      = arg;
+    frame.staged   = staged;
+    frame.page_crc = page_crc;
+    frame.crc      = serial_crc8_atm((uint8_t*)&frame, sizeof(SerialFwFrame_t) - 1);
+
+    (void)serial_write_ctrl_nb((const uint8_t*)&frame, sizeof(SerialFwFrame_t));
+}
+
+/**
+ * @brief  Émet un relevé de faute (type 0x11).
+ * @details File prioritaire : émis une seule fois, le relevé ne doit pas être perdu
+ * derrière une file de télémétrie pleine.
+ */
+void serial_send_fault(const fault_record_t *rec) {
+    SerialFaultFrame_t frame;
+
+    frame.head1      = 0xAA;
+    frame.head2      = 0x55;
+    frame.type       = TELEM_TYPE_FAULT;
+    frame.len        = (uint8_t)(sizeof(SerialFaultFrame_t) - 5u);
+    frame.cause      = rec->cause;
+    frame.task       = rec->task;
+    frame.count      = rec->count;
+    frame.uptime_ms  = rec->uptime_ms;
+    frame.loops      = rec->loops;
+    memcpy(frame.regs, rec->regs, sizeof(frame.regs));
+    frame.sp         = rec->sp;
+    frame.rx_drop    = (uint16_t)rec->rx_drop;
+    frame.tx_drop    = (uint16_t)rec->tx_drop;
+    frame.rx_overrun = (uint16_t)rec->rx_overrun;
+    frame.telem_seq  = rec->telem_seq;
+    frame.crc        = serial_crc8_atm((uint8_t*)&frame, sizeof(SerialFaultFrame_t) - 1);
+
+    (void)serial_write_ctrl_nb((const uint8_t*)&frame, sizeof(SerialFaultFrame_t));
+}
+
+/**
+ * @brief  Émet le résultat d'un accès direct aux registres IMU (type 0x12).
+ * @details File prioritaire, comme l'écho : une réponse par requête.
+ */
+void serial_send_bmireg(const bmi088_regio_t *io) {
+    SerialBmiRegFrame_t frame;
+
+    _Static_assert(sizeof(frame.data) == BMI088_REGIO_MAX_LEN, "register access frame carries a full read");
+    frame.head1  = 0xAA;
+    frame.head2  = 0x55;
+    frame.type   = TELEM_TYPE_BMIREG;
+    frame.len    = (uint8_t)(sizeof(SerialBmiRegFrame_t) - 5u);
+    frame.write  = io->write;
+    frame.sensor = io->sensor;
+    frame.addr   = io->addr;
+    frame.count  = io->len;
+    frame.status = io->status;
+    memset(frame.data, 0, sizeof(frame.data));
+    if(io->status == 0){
+        memcpy(frame.data, io->data, io->len);
+    }
+    frame.crc    = serial_crc8_atm((uint8_t*)&frame, sizeof(SerialBmiRegFrame_t) - 1);
 
-    serial_write_all_nb(raw_bytes, sizeof(SerialImuFrame_t));
+    (void)serial_write_ctrl_nb((const uint8_t*)&frame, sizeof(SerialBmiRegFrame_t));
 }
@@ -0,0 +1,76 @@
+/**
+ * @file    speed_est.c
+ * @brief   Implémentation de l'estimateur de vitesse signée et filtrée.
+ * @details Filtre alpha-bêta : prédiction x + v, puis correction par le résidu
+ * r = mesure - prédiction (x += alpha.r, v += bêta.r). Suit les rampes sans le retard
+ * d'une moyenne glissante tout en lissant le bruit de datation des fronts.
+ */
+
+#include "speed_est.h"
+
+/**
+ * @brief  Initialise l'estimateur (vitesse nulle, marche avant).
+ * @param  est Pointeur vers l'estimateur.
+ */
+void speed_est_init(Speed_Estimator_t *est){
+    est->speed_q = 0;
+    est->rate_q = 0;
+    est->forward = true;
+    est->primed = false;
+    est->speed_mms = 0;
+}
+
+/**
+ * @brief  Intègre une nouvelle mesure (appel à période fixe).
+ * @details Une mesure nulle (plus de front depuis SPEEDO_STOP_TIMEOUT_US) ramène
+ * l'estimation à zéro dès qu'elle passe sous SPEED_EST_ZERO_MMS : pas de traîne
+ * ni de dépassement négatif à l'arrêt. Le sens suit celui de la machine à états
+ * moteur, mais seulement une fois la vitesse quasi nulle : pendant un coup de frein
+ * ou en roue libre, le véhicule garde le sens dans lequel il roulait.
+ * @param  est           Pointeur vers l'estimateur.
+ * @param  raw_mms       Vitesse mesurée par le tachymètre (mm/s, valeur absolue).
+ * @param  motor_forward Sens appliqué par la machine à états moteur.
+ * @return Vitesse estimée, signée (mm/s).
+ */
+int32_t speed_est_update(Speed_Estimator_t *est, int32_t raw_mms, bool motor_forward){
+    if(raw_mms < 0) raw_mms = -raw_mms;
+    if(raw_mms > SPEED_EST_RAW_MAX_MMS) raw_mms = SPEED_EST_RAW_MAX_MMS;
+
+    const int32_t meas_q = raw_mms << SPEED_EST_Q;
+
+    if(!est->primed){
+        est->speed_q = meas_q;
+        est->rate_q = 0;
+        est->primed = true;
+    }
+    else{
+        const int32_t pred_q = est->speed_q + est->rate_q;
+        const int32_t resid_q = meas_q - pred_q;
+
+        est->speed_q = pred_q + (SPEED_EST_ALPHA_Q8 * resid_q) / 256;
+        est->rate_q += (SPEED_EST_BETA_Q8 * resid_q) / 256;
+    }
+
+    if(est->speed_q < 0 || (raw_mms == 0 && est->speed_q < (SPEED_EST_ZERO_MMS << SPEED_EST_Q))){
+        est->speed_q = 0;
+        est->rate_q = 0;
+    }
+
+    const int32_t mag = (est->speed_q + (1 << (SPEED_EST_Q - 1))) >> SPEED_EST_Q;
+
+    if(motor_forward != est->forward && mag <= SPEED_EST_ZERO_MMS){
+        est->forward = motor_forward;
+    }
+
+    est->speed_mms = est->forward ? mag : -mag;
+    return est->speed_mms;
+}
+
+/**
+ * @brief  Dernière vitesse estimée.
+ * @param  est Pointeur vers l'estimateur.
+ * @return Vitesse signée (mm/s, positive en marche avant).
+ */
+int32_t speed_est_get(const Speed_Estimator_t *est){
+    return est->speed_mms;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file    speed_fuse.c
+ * @brief   Implémentation de la vitesse fusionnée accéléromètre / tachymètre (cf. speed_fuse.h).
+ * @details Sans division d'exécution : l'intégration a·dt passe par la réciproque
+ * SPEED_FUSE_US_RECIP (produit 64 bits), les gains sont des Q8 (décalages).
+ */
+
+#include "speed_fuse.h"
+
+_Static_assert(SPEED_FUSE_AXIS >= 0 && SPEED_FUSE_AXIS <= 2, "SPEED_FUSE_AXIS must be 0, 1 or 2");
+_Static_assert(SPEED_FUSE_SIGN == 1 || SPEED_FUSE_SIGN == -1, "SPEED_FUSE_SIGN must be +1 or -1");
+
+/**
+ * @brief  Convertit l'état Q8 en mm/s (arrondi au plus proche).
+ * @param  q Valeur Q SPEED_FUSE_Q.
+ * @return Valeur entière.
+ */
+static inline int32_t fuse_round(int32_t q){
+    return (q >= 0) ? ((q + (1 << (SPEED_FUSE_Q - 1))) >> SPEED_FUSE_Q)
+                    : -((-q + (1 << (SPEED_FUSE_Q - 1))) >> SPEED_FUSE_Q);
+}
+
+void speed_fuse_init(speed_fuse_t *f){
+    f->v_q = 0;
+    f->bias_q = 0;
+    f->last_us = 0;
+    f->still = true;
+    f->speed_mms = 0;
+}
+
+int32_t speed_fuse_predict(speed_fuse_t *f, const int32_t accel_mms2[3], uint64_t t_us){
+    const int32_t a_q = (SPEED_FUSE_SIGN * accel_mms2[SPEED_FUSE_AXIS]) * (1 << SPEED_FUSE_Q);
+    const uint64_t dt_us = t_us - f->last_us;
+
+    if(f->still){
+        /* Arrêt : l'accélération mesurée n'est que biais (pente, décalage) */
+        f->bias_q += (a_q - f->bias_q) >> SPEED_FUSE_STILL_SHIFT;
+    }
+    else if(f->last_us != 0u && t_us > f->last_us && dt_us <= SPEED_FUSE_DT_MAX_US){
+        const int32_t a_mms2 = fuse_round(a_q - f->bias_q);
+        f->v_q += (int32_t)(((int64_t)a_mms2 * (int64_t)dt_us * SPEED_FUSE_US_RECIP) >> 24);
+    }
+    f->last_us = t_us;
+
+    f->speed_mms = fuse_round(f->v_q);
+    return f->speed_mms;
+}
+
+int32_t speed_fuse_correct(speed_fuse_t *f, int32_t enc_mms){
+    const int32_t err_q = enc_mms * (1 << SPEED_FUSE_Q) - f->v_q;
+
+    f->still = (enc_mms == 0);
+    if(f->still){
+        f->v_q = 0;
+    }
+    else{
+        f->v_q += (err_q * SPEED_FUSE_KV_Q8) / 256;
+        /* Vitesse prédite trop faible : accélération sous-estimée, biais trop fort */
+        f->bias_q -= (err_q / 256) * SPEED_FUSE_KB_Q8;
+    }
+    if(f->bias_q > (SPEED_FUSE_BIAS_MAX << SPEED_FUSE_Q)) f->bias_q = SPEED_FUSE_BIAS_MAX << SPEED_FUSE_Q;
+    if(f->bias_q < -(SPEED_FUSE_BIAS_MAX << SPEED_FUSE_Q)) f->bias_q = -(SPEED_FUSE_BIAS_MAX << SPEED_FUSE_Q);
+
+    f->speed_mms = fuse_round(f->v_q);
+    return f->speed_mms;
+}
@@ -0,0 +1,398 @@
+/**
+ * @file    spi_bus.c
+ * @brief   Implémentation de l'ordonnanceur de transactions SPI1 (cf. spi_bus.h).
+ * @details La transaction en cours reste en tête de la file de son périphérique
+ * jusqu'à sa fin : spi_bus_abort() retrouve ainsi le CS à relâcher et la transaction
+ * perdue. Files et état du bus sont modifiés interruptions masquées (soumissions
+ * depuis la boucle principale ou des interruptions de priorités différentes) ; les
+ * callbacks sont appelés hors section critique.
+ */
+
+#include "spi_bus.h"
+#include "stm32g0xx_ll_spi.h"
+#include "timebase.h"
+#include "trace.h"
+#include <string.h>
+
+_Static_assert((SPI_BUS_QUEUE_LEN & (SPI_BUS_QUEUE_LEN - 1u)) == 0u, "SPI_BUS_QUEUE_LEN must be a power of 2");
+_Static_assert(SPI_BUS_DEV_MAX < SPI_BUS_DEV_NONE, "SPI_BUS_DEV_MAX too large");
+
+/**
+ * @brief Périphérique du bus et sa file de transactions.
+ */
+typedef struct{
+    GPIO_TypeDef *port;                             ///< Port du CS.
+    uint16_t pin;                                   ///< Broche du CS.
+    uint8_t priority;                               ///< Priorité (0 = la plus haute).
+    volatile uint8_t head;                          ///< Prochaine place libre.
+    volatile uint8_t tail;                          ///< Transaction la plus ancienne (en cours si active).
+    spi_bus_xfer_t queue[SPI_BUS_QUEUE_LEN];        ///< Transactions en attente.
+    uint32_t queued_us[SPI_BUS_QUEUE_LEN];          ///< Date de soumission (µs, GetMicrosTotal).
+    spi_bus_stats_t stats;                          ///< Statistiques.
+} spi_bus_dev_t;
+
+/** @brief Handle du bus. */
+static SPI_HandleTypeDef *bus_hspi = NULL;
+/** @brief Périphériques enregistrés. */
+static spi_bus_dev_t bus_dev[SPI_BUS_DEV_MAX];
+/** @brief Nombre de périphériques enregistrés. */
+static uint8_t bus_dev_count = 0;
+/** @brief Périphérique dont la transaction occupe le bus (SPI_BUS_DEV_NONE sinon). */
+static volatile uint8_t bus_active = SPI_BUS_DEV_NONE;
+/** @brief Bus réservé aux transferts bloquants. */
+static volatile uint8_t bus_locked = 0;
+/** @brief Dernier périphérique servi (tour de rôle à priorité égale). */
+static uint8_t bus_last = 0;
+
+/** @brief Nombre de transactions en file d'un périphérique. */
+static inline uint8_t spi_bus_pending(const spi_bus_dev_t *d){
+    return (uint8_t)((d->head - d->tail) & (SPI_BUS_QUEUE_LEN - 1u));
+}
+
+#if SPI_BUS_DMA_LL
+/**
+ * @brief  Arme les deux canaux DMA du SPI1 et lance la transaction, sans la HAL.
+ * @details Les canaux gardent la configuration de HAL_DMA_Init (sens, incrément, priorité) ;
+ * seuls adresse, longueur et validations sont réécrits. Le canal TX ne lève aucune
+ * interruption : la fin de réception implique la fin d'émission. L'état du handle SPI
+ * passe à BUSY_TX_RX pendant la transaction pour que les accès HAL et le changement
+ * de prédiviseur la respectent comme une transaction HAL.
+ * @param  xfer Transaction.
+ * @return HAL_OK, ou HAL_BUSY si le handle SPI est occupé.
+ */
+static HAL_StatusTypeDef spi_bus_ll_start(const spi_bus_xfer_t *xfer){
+    SPI_TypeDef *spi = bus_hspi->Instance;
+    DMA_HandleTypeDef *hrx = bus_hspi->hdmarx;
+    DMA_HandleTypeDef *htx = bus_hspi->hdmatx;
+
+    if(bus_hspi->State != HAL_SPI_STATE_READY){
+        return HAL_BUSY;
+    }
+    bus_hspi->State = HAL_SPI_STATE_BUSY_TX_RX;
+
+    CLEAR_BIT(hrx->Instance->CCR, DMA_CCR_EN | DMA_CCR_HTIE);
+    CLEAR_BIT(htx->Instance->CCR, DMA_CCR_EN | DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_TEIE);
+    hrx->DmaBaseAddress->IFCR = DMA_IFCR_CGIF1 << (hrx->ChannelIndex & 0x1CU);
+    htx->DmaBaseAddress->IFCR = DMA_IFCR_CGIF1 << (htx->ChannelIndex & 0x1CU);
+
+    LL_SPI_SetRxFIFOThreshold(spi, LL_SPI_RX_FIFO_TH_QUARTER);
+    while(LL_SPI_IsActiveFlag_RXNE(spi)){
+        (void)LL_SPI_ReceiveData8(spi);
+    }
+    LL_SPI_ClearFlag_OVR(spi);
+
+    hrx->Instance->CPAR  = (uint32_t)&spi->DR;
+    hrx->Instance->CMAR  = (uint32_t)xfer->rx;
+    hrx->Instance->CNDTR = xfer->len;
+    htx->Instance->CPAR  = (uint32_t)&spi->DR;
+    htx->Instance->CMAR  = (uint32_t)xfer->tx;
+    htx->Instance->CNDTR = xfer->len;
+
+    /* Ordre RM0444 : RXDMAEN, canaux actifs, TXDMAEN en dernier (démarre l'horloge) */
+    SET_BIT(hrx->Instance->CCR, DMA_CCR_TCIE | DMA_CCR_TEIE | DMA_CCR_EN);
+    SET_BIT(spi->CR2, SPI_CR2_RXDMAEN);
+    SET_BIT(htx->Instance->CCR, DMA_CCR_EN);
+    if(!LL_SPI_IsEnabled(spi)){
+        LL_SPI_Enable(spi);
+    }
+    SET_BIT(spi->CR2, SPI_CR2_TXDMAEN);
+
+    return HAL_OK;
+}
+
+/**
+ * @brief  Arrête les canaux DMA d'une transaction au niveau registre et rend le handle SPI.
+ */
+static void spi_bus_ll_stop(void){
+    CLEAR_BIT(bus_hspi->hdmarx->Instance->CCR, DMA_CCR_EN | DMA_CCR_TCIE | DMA_CCR_TEIE);
+    CLEAR_BIT(bus_hspi->hdmatx->Instance->CCR, DMA_CCR_EN);
+    CLEAR_BIT(bus_hspi->Instance->CR2, SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN);
+    bus_hspi->State = HAL_SPI_STATE_READY;
+}
+#endif
+
+/**
+ * @brief  Choisit le périphérique à servir : file non vide de plus haute priorité,
+ * en partant du suivant du dernier servi.
+ * @return Identifiant, SPI_BUS_DEV_NONE si toutes les files sont vides.
+ */
+static uint8_t spi_bus_pick(void){
+    uint8_t best = SPI_BUS_DEV_NONE;
+    uint8_t i = bus_last;
+
+    for(uint8_t n = 0; n < bus_dev_count; n++){
+        if(++i >= bus_dev_count){
+            i = 0;
+        }
+        if(spi_bus_pending(&bus_dev[i]) != 0u &&
+           (best == SPI_BUS_DEV_NONE || bus_dev[i].priority < bus_dev[best].priority)){
+            best = i;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief  Lance les transactions en attente tant que le bus est libre.
+ * @details Une transaction refusée au démarrage est retirée de sa file et son callback
+ * appelé avec SPI_BUS_E_START ; la suivante est alors tentée.
+ */
+static void spi_bus_run(void){
+    for(;;){
+        const uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+
+        if(bus_active != SPI_BUS_DEV_NONE || bus_locked || bus_hspi == NULL){
+            __set_PRIMASK(primask);
+            return;
+        }
+
+        const uint8_t id = spi_bus_pick();
+        if(id == SPI_BUS_DEV_NONE){
+            __set_PRIMASK(primask);
+            return;
+        }
+
+        spi_bus_dev_t *d = &bus_dev[id];
+        const spi_bus_xfer_t *x = &d->queue[d->tail];
+        const uint32_t wait_us = GetMicrosTotal() - d->queued_us[d->tail];
+        HAL_StatusTypeDef st;
+
+        bus_last = id;
+        if(wait_us > d->stats.wait_max_us){
+            d->stats.wait_max_us = wait_us;
+        }
+
+        d->port->BRR = d->pin;
+        TRACE_HI(SPI);
+#if SPI_BUS_DMA_LL
+        st = spi_bus_ll_start(x);
+#else
+        st = HAL_SPI_TransmitReceive_DMA(bus_hspi, (uint8_t*)x->tx, x->rx, x->len);
+#endif
+        if(st == HAL_OK){
+            bus_active = id;
+            __set_PRIMASK(primask);
+            return;
+        }
+
+        d->port->BSRR = d->pin;
+        TRACE_LO(SPI);
+        const spi_bus_xfer_t failed = *x;
+        d->tail = (uint8_t)((d->tail + 1u) & (SPI_BUS_QUEUE_LEN - 1u));
+        d->stats.errors++;
+        __set_PRIMASK(primask);
+
+        if(failed.done != NULL){
+            failed.done(failed.ctx, SPI_BUS_E_START);
+        }
+    }
+}
+
+/**
+ * @brief  Termine la transaction en cours : CS relâché, callback, puis transaction suivante.
+ * @param  status SPI_BUS_OK ou SPI_BUS_E_XFER.
+ */
+static void spi_bus_complete(int8_t status){
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    const uint8_t id = bus_active;
+    if(id == SPI_BUS_DEV_NONE){
+        __set_PRIMASK(primask);
+        return;
+    }
+
+    spi_bus_dev_t *d = &bus_dev[id];
+    const spi_bus_xfer_t x = d->queue[d->tail];
+
+    d->port->BSRR = d->pin;
+    TRACE_LO(SPI);
+    d->tail = (uint8_t)((d->tail + 1u) & (SPI_BUS_QUEUE_LEN - 1u));
+    if(status == SPI_BUS_OK){
+        d->stats.xfers++;
+        d->stats.bytes += x.len;
+    }
+    else{
+        d->stats.errors++;
+    }
+    bus_active = SPI_BUS_DEV_NONE;
+    __set_PRIMASK(primask);
+
+    if(x.done != NULL){
+        x.done(x.ctx, status);
+    }
+    spi_bus_run();
+}
+
+void spi_bus_init(SPI_HandleTypeDef *hspi){
+    bus_hspi = hspi;
+    bus_dev_count = 0;
+    bus_active = SPI_BUS_DEV_NONE;
+    bus_locked = 0;
+    bus_last = 0;
+    memset(bus_dev, 0, sizeof(bus_dev));
+}
+
+uint8_t spi_bus_add_device(GPIO_TypeDef *port, uint16_t pin, uint8_t priority){
+    if(bus_dev_count >= SPI_BUS_DEV_MAX || port == NULL){
+        return SPI_BUS_DEV_NONE;
+    }
+
+    spi_bus_dev_t *d = &bus_dev[bus_dev_count];
+    d->port = port;
+    d->pin = pin;
+    d->priority = priority;
+    port->BSRR = pin;
+
+    return bus_dev_count++;
+}
+
+bool spi_bus_submit(uint8_t dev, const spi_bus_xfer_t *xfer){
+    if(dev >= bus_dev_count || xfer == NULL || xfer->len == 0u){
+        return false;
+    }
+
+    spi_bus_dev_t *d = &bus_dev[dev];
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if(spi_bus_pending(d) >= SPI_BUS_QUEUE_LEN - 1u){
+        d->stats.rejected++;
+        __set_PRIMASK(primask);
+        return false;
+    }
+    d->queue[d->head] = *xfer;
+    d->queued_us[d->head] = GetMicrosTotal();
+    d->head = (uint8_t)((d->head + 1u) & (SPI_BUS_QUEUE_LEN - 1u));
+    __set_PRIMASK(primask);
+
+    spi_bus_run();
+    return true;
+}
+
+bool spi_bus_lock(void){
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    const bool free = (bus_active == SPI_BUS_DEV_NONE && !bus_locked);
+    if(free){
+        bus_locked = 1;
+    }
+    __set_PRIMASK(primask);
+    return free;
+}
+
+void spi_bus_unlock(void){
+    bus_locked = 0;
+    spi_bus_run();
+}
+
+bool spi_bus_busy(void){
+    if(bus_active != SPI_BUS_DEV_NONE){
+        return true;
+    }
+    for(uint8_t i = 0; i < bus_dev_count; i++){
+        if(spi_bus_pending(&bus_dev[i]) != 0u){
+            return true;
+        }
+    }
+    return false;
+}
+
+void spi_bus_abort(void){
+    if(bus_hspi == NULL){
+        return;
+    }
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    const uint8_t was_locked = bus_locked;
+    bus_locked = 1;
+#if SPI_BUS_DMA_LL
+    if(bus_active != SPI_BUS_DEV_NONE){
+        spi_bus_ll_stop();
+    }
+#endif
+    bus_active = SPI_BUS_DEV_NONE;
+    TRACE_LO(SPI);
+    for(uint8_t i = 0; i < bus_dev_count; i++){
+        spi_bus_dev_t *d = &bus_dev[i];
+
+        d->port->BSRR = d->pin;
+        d->stats.errors += spi_bus_pending(d);
+        d->tail = d->head;
+    }
+    __set_PRIMASK(primask);
+
+    (void)HAL_SPI_Abort(bus_hspi);
+
+    bus_locked = was_locked;
+    if(!was_locked){
+        spi_bus_run();
+    }
+}
+
+uint8_t spi_bus_dma_rx_irq(void){
+#if SPI_BUS_DMA_LL
+    if(bus_hspi == NULL || bus_active == SPI_BUS_DEV_NONE){
+        return 0;
+    }
+
+    DMA_HandleTypeDef *hrx = bus_hspi->hdmarx;
+    const uint32_t shift = hrx->ChannelIndex & 0x1CU;
+    const uint32_t isr = hrx->DmaBaseAddress->ISR;
+
+    if(isr & (DMA_ISR_TEIF1 << shift)){
+        hrx->DmaBaseAddress->IFCR = DMA_IFCR_CGIF1 << shift;
+        spi_bus_ll_stop();
+        spi_bus_complete(SPI_BUS_E_XFER);
+        return 1;
+    }
+    if(!(isr & (DMA_ISR_TCIF1 << shift))){
+        return 0;
+    }
+
+    /* Dernier octet reçu : l'horloge est arrêtée, le CS peut être relâché */
+    hrx->DmaBaseAddress->IFCR = DMA_IFCR_CGIF1 << shift;
+    spi_bus_ll_stop();
+    spi_bus_complete(SPI_BUS_OK);
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+void spi_bus_get_stats(uint8_t dev, spi_bus_stats_t *stats){
+    if(stats == NULL){
+        return;
+    }
+    if(dev >= bus_dev_count){
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = bus_dev[dev].stats;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief  Callback HAL de fin de transfert SPI (transactions via la HAL).
+ * @param  hspi Handle SPI ayant terminé son transfert.
+ */
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi){
+    if(hspi == bus_hspi){
+        spi_bus_complete(SPI_BUS_OK);
+    }
+}
+
+/**
+ * @brief  Callback HAL d'erreur SPI : termine la transaction en cours en erreur.
+ * @param  hspi Handle SPI en erreur.
+ */
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi){
+    if(hspi == bus_hspi){
+        spi_bus_complete(SPI_BUS_E_XFER);
+    }
+}
@@ -0,0 +1,236 @@
+/**
+ * @file    spi_link.c
+ * @brief   Implémentation de la liaison SPI esclave (cf. spi_link.h).
+ * @details SPI2 en esclave, NSS matériel, 8 bits, mode 0. Les canaux DMA1_Channel5
+ * (RX) et DMA1_Channel6 (TX) sont pilotés directement par la HAL DMA, sans passer par
+ * les callbacks HAL SPI (réservés au BMI088 sur SPI1). La fin de réception d'une
+ * transaction déclenche le réarmement : en esclave, la FIFO TX contient déjà des octets
+ * préchargés du buffer précédent, seule une remise à zéro du périphérique les vide.
+ */
+
+#include "main.h"
+#include "spi_link.h"
+
+#if SPI_LINK_ENABLE
+
+#include "serial.h"
+#include "serial_cmd.h"
+
+#if !SERIAL_CMD_FRAMED
+#error "SPI_LINK_ENABLE requires SERIAL_CMD_FRAMED (sync bytes delimit frames in a transaction)"
+#endif
+
+_Static_assert(SPI_LINK_FRAME_LEN >= TELEM_FRAME_MAX_LEN, "SPI link frame must hold the longest telemetry frame");
+_Static_assert(SPI_LINK_FRAME_LEN == FRAME_POOL_BLOCK_LEN, "SPI link transactions are sent straight from frame pool blocks");
+
+/** @brief Handle SPI2 (esclave). */
+static SPI_HandleTypeDef hspi2;
+/** @brief Canal DMA de réception (MOSI). */
+static DMA_HandleTypeDef hdma_spi2_rx;
+/** @brief Canal DMA d'émission (MISO). */
+static DMA_HandleTypeDef hdma_spi2_tx;
+
+/** @brief Transaction émise tant qu'aucune trame n'est publiée (premier octet nul). */
+static const uint8_t tx_idle[SPI_LINK_FRAME_LEN];
+/** @brief Bloc lu par le DMA (tx_idle ou bloc de frame_pool). */
+static const uint8_t *tx_front_blk = tx_idle;
+/** @brief Bloc publié en attente du réarmement, NULL sinon. */
+static uint8_t *volatile tx_back_blk = NULL;
+/** @brief Commandes reçues : rx_buf[rx_dma] est écrit par le DMA, l'autre attend le décodage. */
+static uint8_t rx_buf[2][SPI_LINK_FRAME_LEN];
+/** @brief Buffer RX écrit par le DMA. */
+static volatile uint8_t rx_dma = 0;
+/** @brief Un buffer RX (rx_dma ^ 1) attend spi_link_poll(). */
+static volatile uint8_t rx_ready = 0;
+/** @brief Transactions complètes reçues. */
+static volatile uint32_t link_frames = 0;
+/** @brief Transactions perdues ou abandonnées. */
+static volatile uint32_t link_errors = 0;
+/** @brief Dernier compteur DMA RX observé par spi_link_poll() (détection d'abandon). */
+static uint32_t stall_cnt = SPI_LINK_FRAME_LEN;
+/** @brief Date depuis laquelle le compteur DMA RX n'a pas bougé (ms). */
+static uint32_t stall_since_ms = 0;
+
+static void spi_link_rx_cplt(DMA_HandleTypeDef *hdma);
+
+/**
+ * @brief  Configure un canal DMA octet par octet, mode normal.
+ * @param  hdma      Handle à initialiser.
+ * @param  channel   Canal DMA1.
+ * @param  request   Requête DMAMUX.
+ * @param  direction Sens du transfert.
+ */
+static void spi_link_dma_setup(DMA_HandleTypeDef *hdma, DMA_Channel_TypeDef *channel, uint32_t request, uint32_t direction){
+    hdma->Instance = channel;
+    hdma->Init.Request = request;
+    hdma->Init.Direction = direction;
+    hdma->Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma->Init.MemInc = DMA_MINC_ENABLE;
+    hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma->Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma->Init.Mode = DMA_NORMAL;
+    hdma->Init.Priority = DMA_PRIORITY_HIGH;
+    if(HAL_DMA_Init(hdma) != HAL_OK){
+        Error_Handler();
+    }
+}
+
+/** @brief Configure une broche en fonction alternée SPI2. */
+static void spi_link_pin(GPIO_TypeDef *port, uint32_t pin, uint8_t af){
+    GPIO_InitTypeDef init = {0};
+
+    init.Pin = pin;
+    init.Mode = GPIO_MODE_AF_PP;
+    init.Pull = (pin == SPI_LINK_NSS_PIN && port == SPI_LINK_NSS_PORT) ? GPIO_PULLUP : GPIO_NOPULL;
+    init.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+    init.Alternate = af;
+    HAL_GPIO_Init(port, &init);
+}
+
+/**
+ * @brief  Arme une transaction : DMA RX/TX sur les buffers courants puis SPI2 actif.
+ * @details SPI2 est remis à zéro (vidage de la FIFO TX préchargée) ; CR1/CR2 sont
+ * restaurés depuis la configuration HAL. Contexte : interruption DMA ou init.
+ */
+static void spi_link_arm(void){
+    const uint32_t cr1 = SPI2->CR1 & ~SPI_CR1_SPE;
+    const uint32_t cr2 = SPI2->CR2 & ~(SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN);
+
+    (void)HAL_DMA_Abort(&hdma_spi2_tx);
+    (void)HAL_DMA_Abort(&hdma_spi2_rx);
+
+    __HAL_RCC_SPI2_FORCE_RESET();
+    __HAL_RCC_SPI2_RELEASE_RESET();
+    SPI2->CR1 = cr1;
+    SPI2->CR2 = cr2;
+
+    uint8_t *const back = tx_back_blk;
+    if(back != NULL){
+        if(tx_front_blk != tx_idle){
+            pool_free(&frame_pool, (void *)tx_front_blk);
+        }
+        tx_front_blk = back;
+        tx_back_blk = NULL;
+    }
+
+    /* Ordre RM0444 : RXDMAEN, DMA armés, TXDMAEN, puis SPE */
+    SET_BIT(SPI2->CR2, SPI_CR2_RXDMAEN);
+    (void)HAL_DMA_Start_IT(&hdma_spi2_rx, (uint32_t)&SPI2->DR, (uint32_t)rx_buf[rx_dma], SPI_LINK_FRAME_LEN);
+    (void)HAL_DMA_Start(&hdma_spi2_tx, (uint32_t)tx_front_blk, (uint32_t)&SPI2->DR, SPI_LINK_FRAME_LEN);
+    SET_BIT(SPI2->CR2, SPI_CR2_TXDMAEN);
+    SET_BIT(SPI2->CR1, SPI_CR1_SPE);
+
+    stall_cnt = SPI_LINK_FRAME_LEN;
+}
+
+/**
+ * @brief  Fin de réception d'une transaction (interruption DMA).
+ * @details Le buffer reçu est confié à la boucle principale s'il n'y en a pas déjà un
+ * en attente ; sinon la transaction est perdue et son buffer réutilisé.
+ * @param  hdma Canal DMA RX.
+ */
+static void spi_link_rx_cplt(DMA_HandleTypeDef *hdma){
+    (void)hdma;
+
+    link_frames++;
+    if(!rx_ready){
+        rx_dma ^= 1u;
+        rx_ready = 1;
+    }
+    else{
+        link_errors++;
+    }
+
+    spi_link_arm();
+}
+
+void spi_link_init(void){
+    __HAL_RCC_SPI2_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    spi_link_pin(SPI_LINK_NSS_PORT, SPI_LINK_NSS_PIN, SPI_LINK_NSS_AF);
+    spi_link_pin(SPI_LINK_SCK_PORT, SPI_LINK_SCK_PIN, SPI_LINK_SCK_AF);
+    spi_link_pin(SPI_LINK_MISO_PORT, SPI_LINK_MISO_PIN, SPI_LINK_MISO_AF);
+    spi_link_pin(SPI_LINK_MOSI_PORT, SPI_LINK_MOSI_PIN, SPI_LINK_MOSI_AF);
+
+    hspi2.Instance = SPI2;
+    hspi2.Init.Mode = SPI_MODE_SLAVE;
+    hspi2.Init.Direction = SPI_DIRECTION_2LINES;
+    hspi2.Init.DataSize = SPI_DATASIZE_8BIT;
+    hspi2.Init.CLKPolarity = SPI_POLARITY_LOW;
+    hspi2.Init.CLKPhase = SPI_PHASE_1EDGE;
+    hspi2.Init.NSS = SPI_NSS_HARD_INPUT;
+    hspi2.Init.FirstBit = SPI_FIRSTBIT_MSB;
+    hspi2.Init.TIMode = SPI_TIMODE_DISABLE;
+    hspi2.Init.CRCCalculation = SPI_CRCCALCULATION_DISABLE;
+    hspi2.Init.CRCPolynomial = 7;
+    hspi2.Init.CRCLength = SPI_CRC_LENGTH_DATASIZE;
+    hspi2.Init.NSSPMode = SPI_NSS_PULSE_DISABLE;
+    if(HAL_SPI_Init(&hspi2) != HAL_OK){
+        Error_Handler();
+    }
+
+    spi_link_dma_setup(&hdma_spi2_rx, DMA1_Channel5, DMA_REQUEST_SPI2_RX, DMA_PERIPH_TO_MEMORY);
+    spi_link_dma_setup(&hdma_spi2_tx, DMA1_Channel6, DMA_REQUEST_SPI2_TX, DMA_MEMORY_TO_PERIPH);
+    hdma_spi2_rx.XferCpltCallback = spi_link_rx_cplt;
+
+    /* Vecteur partagé avec le DMA TX de SPI1 : déjà au niveau IRQ_PRIO_IMU */
+    HAL_NVIC_EnableIRQ(DMA1_Ch4_7_DMA2_Ch1_5_DMAMUX1_OVR_IRQn);
+
+    spi_link_arm();
+}
+
+void spi_link_poll(void){
+    if(rx_ready){
+        serial_cmd_feed_block(rx_buf[rx_dma ^ 1u], SPI_LINK_FRAME_LEN);
+        rx_ready = 0;
+    }
+
+    /* Transaction entamée puis abandonnée (NSS relâché) : réarmement pour se recaler */
+    const uint32_t cnt = __HAL_DMA_GET_COUNTER(&hdma_spi2_rx);
+    const uint32_t now = HAL_GetTick();
+    if(cnt == SPI_LINK_FRAME_LEN || cnt != stall_cnt ||
+       HAL_GPIO_ReadPin(SPI_LINK_NSS_PORT, SPI_LINK_NSS_PIN) == GPIO_PIN_RESET){
+        stall_cnt = cnt;
+        stall_since_ms = now;
+        return;
+    }
+    if((now - stall_since_ms) >= SPI_LINK_STALL_MS){
+        __disable_irq();
+        if(__HAL_DMA_GET_COUNTER(&hdma_spi2_rx) == cnt){
+            link_errors++;
+            spi_link_arm();
+        }
+        __enable_irq();
+    }
+}
+
+void spi_link_publish_block(uint8_t *block){
+    /* Échange atomique avec le réarmement (interruption DMA) */
+    __disable_irq();
+    uint8_t *const stale = tx_back_blk;
+    tx_back_blk = block;
+    __enable_irq();
+
+    pool_free(&frame_pool, stale);
+}
+
+uint8_t spi_link_pending(void){
+    return rx_ready;
+}
+
+uint32_t spi_link_frames(void){
+    return link_frames;
+}
+
+uint32_t spi_link_errors(void){
+    return link_errors;
+}
+
+void spi_link_dma_irq(void){
+    HAL_DMA_IRQHandler(&hdma_spi2_rx);
+}
+
+#endif /* SPI_LINK_ENABLE */
@@ -23,11 +23,14 @@
 /* Includes */
 #include <errno.h>
 #include <stdint.h>
+#include "dbgout.h"
 
+#if !DBG_NO_STDIO
 /**
  * Pointer to the current high watermark of the heap usage
  */
 static uint8_t *__sbrk_heap_end = NULL;
+#endif
 
 /**
  * @brief _sbrk() allocates memory to the newlib heap and is used by malloc
@@ -52,6 +55,12 @@ static uint8_t *__sbrk_heap_end = NULL;
  */
 void *_sbrk(ptrdiff_t incr)
 {
+#if DBG_NO_STDIO
+  /* Image sans tas (dbgout.h) : toute allocation échoue, _Min_Heap_Size est nul */
+  (void)incr;
+  errno = ENOMEM;
+  return (void *)-1;
+#else
   extern uint8_t _end; /* Symbol defined in the linker script */
   extern uint8_t _estack; /* Symbol defined in the linker script */
   extern uint32_t _Min_Stack_Size; /* Symbol defined in the linker script */
@@ -76,4 +85,5 @@ void *_sbrk(ptrdiff_t incr)
   __sbrk_heap_end += incr;
 
   return (void *)prev_heap_end;
+#endif
 }
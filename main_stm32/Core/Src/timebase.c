@@ -0,0 +1,150 @@
+/**
+ * @file    timebase.c
+ * @brief   Implémentation de la base de temps microseconde.
+ * @details Le Timer 3 (16 bits, 1 MHz) est étendu à 48 bits utiles par un compteur
+ * d'overflow logiciel 32 bits mis à jour dans TIM3_TIM4_IRQHandler. Son canal 1
+ * en compare sert de réveil à la veille de la boucle principale.
+ */
+
+#include "main.h"
+#include "timebase.h"
+
+/** @brief Compteur de débordements pour le Timer 3 (Extension 16-bit vers 48-bit). */
+volatile uint32_t tim3_overflow_cnt = 0;
+
+/**
+ * @brief  Récupère le nombre de ticks TIM3 écoulés depuis le démarrage.
+ * @details Lecture sans verrou ni masquage d'interruption : la boucle ne recommence
+ * que si l'interruption d'overflow s'est exécutée pendant la lecture, soit au plus
+ * une fois (une fois toutes les 65,5 ms). Si le débordement n'a pas encore été
+ * traité (appel depuis une interruption plus prioritaire, interruptions masquées,
+ * ou handler partagé avec TIM4 retardé), le flag UIF encore levé avec un compteur
+ * déjà rebouclé est pris en compte : la valeur ne recule jamais.
+ * @return Ticks écoulés (64 bits).
+ */
+uint64_t GetTicks64(void){
+    uint32_t m_overflow;
+    uint16_t m_counter;
+    uint32_t m_pending;
+
+    do{
+        m_overflow = tim3_overflow_cnt;
+        m_counter  = (uint16_t)LL_TIM_GetCounter(TIM3);
+        m_pending  = LL_TIM_IsActiveFlag_UPDATE(TIM3);
+    }
+    while(m_overflow != tim3_overflow_cnt);
+
+    if(m_pending && m_counter < 0x8000u){
+        m_overflow++;   // Débordement survenu mais pas encore compté par l'interruption
+    }
+
+    return ((uint64_t)m_overflow << 16) | m_counter;
+}
+
+/**
+ * @brief  Récupère le temps écoulé depuis le démarrage en microsecondes.
+ * @return Temps monotone en microsecondes (64 bits).
+ */
+uint64_t GetMicros64(void){
+#if TIMEBASE_TICK_HZ == 1000000u
+    return GetTicks64();
+#else
+    return (GetTicks64() * 1000000u) / TIMEBASE_TICK_HZ;
+#endif
+}
+
+/**
+ * @brief  Récupère un temps système précis en microsecondes.
+ * @details Troncature 32 bits de GetMicros64() : les différences restent justes
+ * à travers le rebouclage tant que les durées mesurées sont inférieures à 71 minutes.
+ * @return Temps écoulé en microsecondes (modulo 2^32).
+ */
+uint32_t GetMicrosTotal(void){
+    return (uint32_t)GetMicros64();
+}
+
+/**
+ * @brief  Attente active précise à la microseconde.
+ * @details Cumule les écarts successifs du compteur 16 bits de TIM3 (ARR = 0xFFFF) :
+ * l'arithmétique modulo 2^16 absorbe les rebouclages sans dépendre de l'interruption d'overflow.
+ * @param  us Durée de l'attente en microsecondes.
+ */
+void Delay_us(uint32_t us){
+    uint16_t last = (uint16_t)LL_TIM_GetCounter(TIM3);
+    uint32_t elapsed = 0;
+
+    while(elapsed < us){
+        uint16_t now = (uint16_t)LL_TIM_GetCounter(TIM3);
+        elapsed += (uint16_t)(now - last);
+        last = now;
+    }
+}
+
+/**
+ * @brief  Avance la base de temps d'une durée passée horloges arrêtées.
+ * @details Le débordement éventuellement en attente est intégré à la nouvelle valeur
+ * (GetTicks64()) puis son flag effacé : l'interruption ne le compte pas une seconde fois.
+ * @param  us Durée à ajouter (µs).
+ */
+void Timebase_Advance(uint64_t us){
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+#if TIMEBASE_TICK_HZ == 1000000u
+    const uint64_t t = GetTicks64() + us;
+#else
+    const uint64_t t = GetTicks64() + (us * TIMEBASE_TICK_HZ) / 1000000u;
+#endif
+
+    LL_TIM_DisableCounter(TIM3);
+    LL_TIM_SetCounter(TIM3, (uint16_t)t);
+    LL_TIM_ClearFlag_UPDATE(TIM3);
+    tim3_overflow_cnt = (uint32_t)(t >> 16);
+    LL_TIM_EnableCounter(TIM3);
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief  Arme le réveil de la veille sur une échéance.
+ * @details Le compare CH1 de TIM3 lève une interruption quand les 16 bits de poids
+ * faible du compteur atteignent l'échéance ; le handler la désarme aussitôt.
+ * Une échéance dépassée pendant l'armement est détectée par relecture du temps.
+ * @param  deadline_us Échéance absolue (µs).
+ * @return 1 si le processeur peut dormir, 0 si l'échéance est trop proche.
+ */
+uint8_t Timebase_Arm_Wakeup(uint64_t deadline_us){
+    uint64_t now_us = GetMicros64();
+
+    if(deadline_us < now_us + TIMEBASE_WAKEUP_MIN_US){
+        return 0;
+    }
+
+    if((deadline_us - now_us) >= 0xFFFFu){
+        LL_TIM_DisableIT_CC1(TIM3);
+        return 1;
+    }
+
+#if TIMEBASE_TICK_HZ == 1000000u
+    LL_TIM_OC_SetCompareCH1(TIM3, (uint16_t)deadline_us);
+#else
+    LL_TIM_OC_SetCompareCH1(TIM3, (uint16_t)((deadline_us * TIMEBASE_TICK_HZ) / 1000000u));
+#endif
+    LL_TIM_ClearFlag_CC1(TIM3);
+    LL_TIM_EnableIT_CC1(TIM3);
+
+    if(GetMicros64() >= deadline_us){
+        LL_TIM_DisableIT_CC1(TIM3);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief  Désarme le réveil de la veille.
+ */
+void Timebase_Disarm_Wakeup(void){
+    LL_TIM_DisableIT_CC1(TIM3);
+    LL_TIM_ClearFlag_CC1(TIM3);
+}
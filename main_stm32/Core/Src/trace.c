@@ -0,0 +1,38 @@
+/**
+ * @file    trace.c
+ * @brief   Implémentation des marqueurs de timing (cf. trace.h).
+ */
+
+#include "trace.h"
+
+#if TRACE_ENABLE
+
+/**
+ * @brief  Configure une broche de voie en sortie push-pull, état bas.
+ * @param  port Port GPIO.
+ * @param  pin  Broche.
+ */
+static void trace_pin_init(GPIO_TypeDef *port, uint16_t pin){
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    port->BRR = pin;
+    GPIO_InitStruct.Pin   = pin;
+    GPIO_InitStruct.Mode  = GPIO_MODE_OUTPUT_PP;
+    GPIO_InitStruct.Pull  = GPIO_NOPULL;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+    HAL_GPIO_Init(port, &GPIO_InitStruct);
+}
+
+void trace_init(void){
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+    __HAL_RCC_GPIOD_CLK_ENABLE();
+
+    trace_pin_init(TRACE_TICK_PORT, TRACE_TICK_PIN);
+    trace_pin_init(TRACE_SPI_PORT,  TRACE_SPI_PIN);
+    trace_pin_init(TRACE_DMA_PORT,  TRACE_DMA_PIN);
+    trace_pin_init(TRACE_TASK_PORT, TRACE_TASK_PIN);
+}
+
+#endif /* TRACE_ENABLE */
@@ -0,0 +1,113 @@
+/**
+ * @file    traj.c
+ * @brief   Implémentation du tampon de trajectoire (cf. traj.h).
+ * @details Anneau à index libres : traj_push() n'écrit que traj_head, traj_poll() que
+ * traj_tail. Les commandes (boucle principale) coupent la lecture avant de toucher aux
+ * index ; le tick moteur, plus prioritaire, ne lit alors plus le tampon.
+ */
+
+#include "traj.h"
+
+#if (TRAJ_LEN & (TRAJ_LEN - 1u))
+#error "TRAJ_LEN must be a power of two"
+#endif
+
+/** @brief Points en attente. */
+static traj_point_t traj_ring[TRAJ_LEN];
+/** @brief Nombre de points ajoutés (index libre du producteur). */
+static volatile uint32_t traj_head = 0;
+/** @brief Nombre de points retirés (index libre du consommateur). */
+static volatile uint32_t traj_tail = 0;
+/** @brief Date du dernier point ajouté depuis TRAJ_CMD_CLEAR (µs relatives). */
+static uint32_t traj_last_t_us = 0;
+/** @brief Date absolue de la date relative 0 (µs, GetMicros64). */
+static volatile uint64_t traj_start_us = 0;
+/** @brief 1 pendant la lecture. */
+static volatile uint8_t traj_run = 0;
+/** @brief État du lecteur (traj_state_t), hors refus. */
+static volatile uint8_t traj_st = TRAJ_ST_IDLE;
+/** @brief Un point a été refusé depuis le dernier TRAJ_CMD_CLEAR. */
+static uint8_t traj_rejected = 0;
+
+uint8_t traj_push(const traj_point_t *pt){
+    if((traj_head - traj_tail) >= TRAJ_LEN || pt->t_us < traj_last_t_us){
+        traj_rejected = 1;
+        return 0;
+    }
+
+    traj_ring[traj_head & (TRAJ_LEN - 1u)] = *pt;
+    traj_last_t_us = pt->t_us;
+    traj_head++;
+    return 1;
+}
+
+void traj_command(uint8_t cmd, uint64_t t_us){
+    switch(cmd){
+        case TRAJ_CMD_CLEAR:
+            traj_run = 0;
+            traj_tail = traj_head;
+            traj_last_t_us = 0;
+            traj_rejected = 0;
+            traj_st = TRAJ_ST_IDLE;
+            break;
+
+        case TRAJ_CMD_START:
+            traj_run = 0;
+            traj_start_us = t_us;
+            traj_st = TRAJ_ST_RUNNING;
+            traj_run = 1;
+            break;
+
+        case TRAJ_CMD_STOP:
+            traj_run = 0;
+            traj_st = TRAJ_ST_IDLE;
+            break;
+
+        default:
+            break;
+    }
+}
+
+uint8_t traj_poll(uint64_t now_us, traj_point_t *pt){
+    if(!traj_run){
+        return 0;
+    }
+
+    const uint32_t tail = traj_tail;
+    if(tail == traj_head){
+        traj_run = 0;
+        traj_st = TRAJ_ST_DONE;
+        return 0;
+    }
+
+    const traj_point_t *next = &traj_ring[tail & (TRAJ_LEN - 1u)];
+    if(now_us < traj_start_us + next->t_us){
+        return 0;
+    }
+
+    *pt = *next;
+    traj_tail = tail + 1u;
+    return 1;
+}
+
+uint64_t traj_next_us(void){
+    const uint32_t tail = traj_tail;
+
+    if(!traj_run || tail == traj_head){
+        return traj_run ? 0u : UINT64_MAX;
+    }
+
+    return traj_start_us + traj_ring[tail & (TRAJ_LEN - 1u)].t_us;
+}
+
+uint8_t traj_running(void){
+    return traj_run;
+}
+
+uint8_t traj_state(void){
+    return traj_rejected ? (uint8_t)TRAJ_ST_REJECTED : traj_st;
+}
+
+uint16_t traj_count(void){
+    return (uint16_t)(traj_head - traj_tail);
+}
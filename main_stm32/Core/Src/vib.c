@@ -0,0 +1,337 @@
+/**
+ * @file    vib.c
+ * @brief   Implémentation de l'analyse vibratoire embarquée (cf. vib.h).
+ * @details Tables (quart de sinus, fenêtre de Hann) calculées pour 128 points et lues
+ * avec un pas de 128 / VIB_FFT_N. L'entrée fenêtrée est décalée pour que son maximum
+ * tombe dans [2^13, 2^14[ : avec la division par deux à chaque étage, aucun papillon
+ * ne déborde, et la résolution ne dépend pas de l'amplitude vibratoire. Les puissances
+ * sont ramenées à l'échelle d'origine (LSB², Q16) avant d'être cumulées.
+ * Tout s'exécute en boucle principale (observateur du driver) : aucune section critique.
+ */
+
+#include "vib.h"
+#include "serial.h"
+#include <string.h>
+
+#if VIB_ENABLE
+
+#if (VIB_FFT_N != 64u) && (VIB_FFT_N != 128u)
+#error "VIB_FFT_N must be 64 or 128"
+#endif
+
+/** @brief Nombre de points des tables. */
+#define VIB_TBL_N       128u
+/** @brief Pas de lecture des tables. */
+#define VIB_STRIDE      (VIB_TBL_N / VIB_FFT_N)
+/** @brief Raies du spectre unilatéral (0 à fs/2 exclu). */
+#define VIB_BINS        (VIB_FFT_N / 2u)
+/** @brief Raies par bande rapportée. */
+#define VIB_BAND_BINS   (VIB_BINS / VIB_BANDS)
+
+_Static_assert(VIB_BINS % VIB_BANDS == 0u, "VIB_BANDS must divide VIB_FFT_N / 2");
+
+/** @brief sin(2 pi m / 128) pour m = 0..32 (Q15). */
+static const int16_t vib_sin_q15[VIB_TBL_N / 4u + 1u] = {
+         0,   1608,   3212,   4808,   6393,   7962,   9512,  11039,  12539,  14010,  15446,
+     16846,  18204,  19519,  20787,  22005,  23170,  24279,  25329,  26319,  27245,  28105,
+     28898,  29621,  30273,  30852,  31356,  31785,  32137,  32412,  32609,  32728,  32767
+};
+
+/** @brief Fenêtre de Hann sin²(pi n / 128) pour n = 0..64 (Q15, symétrique). */
+static const int16_t vib_hann_q15[VIB_TBL_N / 2u + 1u] = {
+         0,     20,     79,    177,    315,    491,    705,    958,   1247,   1573,   1935,
+      2331,   2761,   3224,   3719,   4244,   4799,   5381,   5990,   6624,   7281,   7961,
+      8660,   9379,  10114,  10864,  11628,  12403,  13187,  13980,  14778,  15580,  16383,
+     17187,  17989,  18787,  19580,  20364,  21139,  21903,  22653,  23388,  24107,  24806,
+     25486,  26143,  26777,  27386,  27968,  28523,  29048,  29543,  30006,  30436,  30832,
+     31194,  31520,  31809,  32062,  32276,  32452,  32590,  32688,  32747,  32767
+};
+
+/** @brief Partie réelle : bloc d'échantillons en cours puis spectre. */
+static int16_t vib_re[VIB_FFT_N];
+/** @brief Partie imaginaire du spectre. */
+static int16_t vib_im[VIB_FFT_N];
+/** @brief Puissance cumulée par raie sur les blocs du rapport (LSB², Q16). */
+static uint64_t vib_acc[VIB_BINS];
+/** @brief Échantillons dans le bloc en cours. */
+static uint16_t vib_fill = 0;
+/** @brief Spectres cumulés dans vib_acc. */
+static uint8_t vib_blocks = 0;
+/** @brief Axe analysé (vib_cmd_t). */
+static uint8_t vib_axis = VIB_OFF;
+/** @brief Spectres moyennés par rapport. */
+static uint8_t vib_avg = VIB_AVG_DEFAULT;
+/** @brief Gammes IMU courantes (conversion en mg). */
+static uint8_t vib_ranges = 0;
+/** @brief Période d'acquisition mesurée (µs, Q4, moyenne glissante sur 16 échantillons). */
+static uint32_t vib_in_us_q4 = 0;
+/** @brief Date de l'échantillon précédent (µs). */
+static uint64_t vib_last_us = 0;
+/** @brief Raie dominante du dernier rapport (0,1 Hz). */
+static uint16_t vib_last_dhz = 0;
+/** @brief Amplitude de la raie dominante du dernier rapport (mg). */
+static uint16_t vib_last_mg = 0;
+
+/**
+ * @brief  Racine carrée entière (bit à bit, sans division).
+ * @param  x Argument.
+ * @return Partie entière de sqrt(x).
+ */
+static uint32_t vib_isqrt(uint64_t x){
+    uint64_t bit = (uint64_t)1 << 62;
+    uint64_t res = 0;
+
+    while(bit > x){
+        bit >>= 2;
+    }
+    while(bit != 0){
+        if(x >= res + bit){
+            x -= res + bit;
+            res = (res >> 1) + bit;
+        }
+        else{
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)res;
+}
+
+/** @brief sin(2 pi m / 128) pour m = 0..64 (Q15). */
+static int32_t vib_sin(uint32_t m){
+    return (m <= VIB_TBL_N / 4u) ? vib_sin_q15[m] : vib_sin_q15[VIB_TBL_N / 2u - m];
+}
+
+/** @brief cos(2 pi m / 128) pour m = 0..64 (Q15). */
+static int32_t vib_cos(uint32_t m){
+    return (m <= VIB_TBL_N / 4u) ? vib_sin_q15[VIB_TBL_N / 4u - m] : -vib_sin_q15[m - VIB_TBL_N / 4u];
+}
+
+/**
+ * @brief  FFT radix-2 sur place (décimation temporelle), sortie divisée par VIB_FFT_N.
+ */
+static void vib_fft(void){
+    for(uint32_t i = 1, j = 0; i < VIB_FFT_N; i++){
+        uint32_t bit = VIB_FFT_N >> 1;
+        for(; j & bit; bit >>= 1){
+            j ^= bit;
+        }
+        j ^= bit;
+        if(i < j){
+            int16_t t = vib_re[i]; vib_re[i] = vib_re[j]; vib_re[j] = t;
+            t = vib_im[i]; vib_im[i] = vib_im[j]; vib_im[j] = t;
+        }
+    }
+
+    for(uint32_t len = 2; len <= VIB_FFT_N; len <<= 1){
+        const uint32_t half = len >> 1;
+        const uint32_t step = VIB_TBL_N / len;
+
+        for(uint32_t k = 0; k < half; k++){
+            const int32_t wr = vib_cos(k * step);
+            const int32_t ws = vib_sin(k * step);
+
+            for(uint32_t a = k; a < VIB_FFT_N; a += len){
+                const uint32_t b = a + half;
+                /* (re + j im)(cos - j sin) */
+                const int32_t tr = (vib_re[b] * wr + vib_im[b] * ws) >> 15;
+                const int32_t ti = (vib_im[b] * wr - vib_re[b] * ws) >> 15;
+
+                vib_re[b] = (int16_t)((vib_re[a] - tr) >> 1);
+                vib_im[b] = (int16_t)((vib_im[a] - ti) >> 1);
+                vib_re[a] = (int16_t)((vib_re[a] + tr) >> 1);
+                vib_im[a] = (int16_t)((vib_im[a] + ti) >> 1);
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Convertit une puissance moyenne en amplitude (mg).
+ * @param  p_q16 Carré de l'amplitude (LSB², Q16).
+ * @return Amplitude (mg, saturée à 65535).
+ */
+static uint16_t vib_mg(uint64_t p_q16){
+    /* Gamme n : 32768 LSB pour (3 << n) g */
+    const uint64_t mg = ((uint64_t)vib_isqrt(p_q16) * (3000u << (vib_ranges & 0x03u))) >> (15 + 8);
+    return (mg > UINT16_MAX) ? (uint16_t)UINT16_MAX : (uint16_t)mg;
+}
+
+/**
+ * @brief  Analyse le bloc complet et cumule son spectre de puissance.
+ */
+static void vib_block(void){
+    int32_t sum = 0;
+    int32_t peak = 0;
+    int32_t shift = 0;
+
+    for(uint32_t n = 0; n < VIB_FFT_N; n++){
+        sum += vib_re[n];
+    }
+    const int32_t mean = sum / (int32_t)VIB_FFT_N;
+
+    /* Fenêtre de Hann et recherche du maximum */
+    for(uint32_t n = 0; n < VIB_FFT_N; n++){
+        const uint32_t h = ((n <= VIB_FFT_N / 2u) ? n : (VIB_FFT_N - n)) * VIB_STRIDE;
+        const int32_t v = ((vib_re[n] - mean) * (int32_t)vib_hann_q15[h]) / 32768;
+        const int32_t a = (v < 0) ? -v : v;
+
+        if(a > peak){
+            peak = a;
+        }
+        vib_re[n] = (int16_t)(v / 2);    // |v| < 2^16 : stocké divisé par 2, décalage corrigé ci-dessous
+        vib_im[n] = 0;
+    }
+    vib_blocks++;
+    if(peak == 0){
+        return;
+    }
+
+    /* Normalisation du maximum dans [2^13, 2^14[ */
+    peak /= 2;
+    while(peak >= (1 << 14)){
+        peak >>= 1;
+        shift--;
+    }
+    while(peak < (1 << 13)){
+        peak <<= 1;
+        shift++;
+    }
+    for(uint32_t n = 0; n < VIB_FFT_N; n++){
+        vib_re[n] = (int16_t)((shift >= 0) ? (vib_re[n] * (1 << shift)) : (vib_re[n] >> -shift));
+    }
+
+    vib_fft();
+
+    /* Puissance ramenée à l'entrée d'origine (LSB², Q16) : entrée /2 puis * 2^shift */
+    const int32_t p_shift = 16 + 2 - 2 * shift;
+    for(uint32_t k = 1; k < VIB_BINS; k++){
+        const uint32_t p = (uint32_t)(vib_re[k] * vib_re[k]) + (uint32_t)(vib_im[k] * vib_im[k]);
+        vib_acc[k] += (p_shift >= 0) ? ((uint64_t)p << p_shift) : (uint64_t)(p >> -p_shift);
+    }
+}
+
+/**
+ * @brief  Extrait la raie dominante et les bandes du spectre moyenné, émet le rapport.
+ * @details Fenêtre de Hann : une sinusoïde d'amplitude A donne A / 4 sur sa raie
+ * (spectre divisé par N), et sa puissance s'étale sur 1,5 raie équivalente, d'où
+ * A² = 32/3 x somme des puissances et valeur efficace² = 16/3 x somme. La
+ * fréquence est interpolée par une parabole sur les amplitudes des raies voisines.
+ * @param  timestamp_us Date du dernier échantillon analysé.
+ */
+static void vib_report(uint64_t timestamp_us){
+    uint8_t frame[VIB_FRAME_LEN];
+    uint16_t band_mg[VIB_BANDS];
+    uint32_t kp = 1;
+
+    for(uint32_t k = 2; k < VIB_BINS; k++){
+        if(vib_acc[k] > vib_acc[kp]){
+            kp = k;
+        }
+    }
+
+    for(uint32_t b = 0; b < VIB_BANDS; b++){
+        uint64_t e = 0;
+        for(uint32_t k = (b == 0u) ? 1u : b * VIB_BAND_BINS; k < (b + 1u) * VIB_BAND_BINS; k++){
+            e += vib_acc[k] / vib_blocks;
+        }
+        band_mg[b] = vib_mg((e * 16u) / 3u);
+    }
+
+    const uint64_t e_lo = (kp > 1u) ? vib_acc[kp - 1u] / vib_blocks : 0u;
+    const uint64_t e_0  = vib_acc[kp] / vib_blocks;
+    const uint64_t e_hi = (kp < VIB_BINS - 1u) ? vib_acc[kp + 1u] / vib_blocks : 0u;
+    vib_last_mg = vib_mg(((e_lo + e_0 + e_hi) * 32u) / 3u);
+
+    int32_t delta_q8 = 0;
+    if(kp > 1u && kp < VIB_BINS - 1u){
+        const int32_t m_lo = (int32_t)vib_isqrt(e_lo);
+        const int32_t m_0  = (int32_t)vib_isqrt(e_0);
+        const int32_t m_hi = (int32_t)vib_isqrt(e_hi);
+        const int32_t den  = 2 * m_0 - m_lo - m_hi;
+
+        if(den > 0){
+            delta_q8 = (int32_t)(((int64_t)(m_hi - m_lo) * 128) / den);
+            if(delta_q8 > 128) delta_q8 = 128;
+            if(delta_q8 < -128) delta_q8 = -128;
+        }
+    }
+
+    uint16_t fs_hz = 0;
+    vib_last_dhz = 0;
+    if(vib_in_us_q4 != 0u){
+        const uint64_t dhz = ((uint64_t)((int32_t)kp * 256 + delta_q8) * 160000000u) /
+                             ((uint64_t)256u * VIB_FFT_N * vib_in_us_q4);
+        vib_last_dhz = (dhz > UINT16_MAX) ? (uint16_t)UINT16_MAX : (uint16_t)dhz;
+        fs_hz = (uint16_t)(16000000u / vib_in_us_q4);
+    }
+
+    const uint32_t t32 = (uint32_t)timestamp_us;
+    frame[0] = 0xAA;
+    frame[1] = 0x55;
+    frame[2] = VIB_FRAME_TYPE;
+    frame[3] = (uint8_t)(VIB_FRAME_LEN - 5u);
+    memcpy(&frame[4], &t32, sizeof(t32));
+    memcpy(&frame[8], &fs_hz, sizeof(fs_hz));
+    memcpy(&frame[10], &vib_last_dhz, sizeof(vib_last_dhz));
+    memcpy(&frame[12], &vib_last_mg, sizeof(vib_last_mg));
+    memcpy(&frame[14], band_mg, sizeof(band_mg));
+    frame[14u + sizeof(band_mg)] = (uint8_t)(vib_axis - 1u);
+    frame[15u + sizeof(band_mg)] = vib_blocks;
+    frame[VIB_FRAME_LEN - 1u] = serial_crc8_atm(frame, (uint16_t)(VIB_FRAME_LEN - 1u));
+
+    (void)serial_write_all_nb(frame, VIB_FRAME_LEN);
+}
+
+void vib_configure(uint8_t cmd, uint8_t avg, uint8_t ranges){
+    vib_axis   = (cmd > VIB_AXIS_Z) ? (uint8_t)VIB_OFF : cmd;
+    vib_avg    = (avg == 0u) ? 1u : (avg > VIB_AVG_MAX) ? (uint8_t)VIB_AVG_MAX : avg;
+    vib_ranges = ranges;
+    vib_fill   = 0;
+    vib_blocks = 0;
+    memset(vib_acc, 0, sizeof(vib_acc));
+}
+
+void vib_record(const bmi088_raw_t *raw, uint64_t timestamp_us){
+    if(vib_axis == VIB_OFF){
+        return;
+    }
+
+    const uint64_t dt = timestamp_us - vib_last_us;
+    vib_last_us = timestamp_us;
+    if(dt != 0u && dt < 100000u){
+        const int32_t dt_q4 = (int32_t)dt * 16;
+        /* Échantillon manquant (écart > 2 périodes) : le bloc repart de zéro */
+        if(vib_in_us_q4 != 0u && (uint32_t)dt_q4 > 2u * vib_in_us_q4){
+            vib_fill = 0;
+        }
+        vib_in_us_q4 = (vib_in_us_q4 == 0u) ? (uint32_t)dt_q4 :
+                       (uint32_t)((int32_t)vib_in_us_q4 + (dt_q4 - (int32_t)vib_in_us_q4) / 16);
+    }
+    else{
+        vib_fill = 0;
+    }
+
+    vib_re[vib_fill++] = raw->accel[vib_axis - 1u];
+    if(vib_fill < VIB_FFT_N){
+        return;
+    }
+    vib_fill = 0;
+
+    vib_block();
+    if(vib_blocks >= vib_avg){
+        vib_report(timestamp_us);
+        vib_blocks = 0;
+        memset(vib_acc, 0, sizeof(vib_acc));
+    }
+}
+
+uint16_t vib_peak_dhz(void){
+    return vib_last_dhz;
+}
+
+uint16_t vib_peak_mg(void){
+    return vib_last_mg;
+}
+
+#endif /* VIB_ENABLE */
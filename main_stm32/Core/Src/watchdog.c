@@ -0,0 +1,65 @@
+/**
+ * @file    watchdog.c
+ * @brief   Implémentation du chien de garde matériel indépendant (IWDG).
+ * @details Accès direct aux registres (module HAL IWDG non généré par CubeMX).
+ */
+
+#include "main.h"
+#include "watchdog.h"
+
+/** @brief Clé de démarrage de l'IWDG. */
+#define IWDG_KEY_START      0xCCCCu
+/** @brief Clé de rafraîchissement. */
+#define IWDG_KEY_RELOAD     0xAAAAu
+/** @brief Clé de déverrouillage des registres PR / RLR. */
+#define IWDG_KEY_UNLOCK     0x5555u
+/** @brief Code de prédiviseur /32 : LSI 32 kHz -> 1 kHz. */
+#define IWDG_PR_DIV32       3u
+/** @brief Valeur maximale du registre de rechargement (12 bits). */
+#define IWDG_RLR_MAX        0x0FFFu
+
+/** @brief Dernier reset provoqué par l'IWDG (relevé au démarrage). */
+static uint8_t wdg_reset_flag = 0;
+
+/**
+ * @brief  Démarre le chien de garde.
+ * @param  timeout_ms Délai avant reset sans rafraîchissement (ms).
+ */
+void watchdog_start(uint16_t timeout_ms){
+    wdg_reset_flag = (RCC->CSR & RCC_CSR_IWDGRSTF) ? 1u : 0u;
+    RCC->CSR |= RCC_CSR_RMVF;
+
+    if(timeout_ms == 0){
+        timeout_ms = 1;
+    }
+    if(timeout_ms > IWDG_RLR_MAX){
+        timeout_ms = IWDG_RLR_MAX;
+    }
+
+    /* Compteur gelé pendant un arrêt débogueur */
+    RCC->APBENR1 |= RCC_APBENR1_DBGEN;
+    DBG->APBFZ1 |= DBG_APB_FZ1_DBG_IWDG_STOP;
+
+    IWDG->KR  = IWDG_KEY_START;
+    IWDG->KR  = IWDG_KEY_UNLOCK;
+    IWDG->PR  = IWDG_PR_DIV32;
+    IWDG->RLR = timeout_ms;
+    while(IWDG->SR & (IWDG_SR_PVU | IWDG_SR_RVU)){
+    }
+    IWDG->KR  = IWDG_KEY_RELOAD;
+}
+
+/**
+ * @brief  Rafraîchit le chien de garde.
+ */
+void watchdog_feed(void){
+    IWDG->KR = IWDG_KEY_RELOAD;
+}
+
+/**
+ * @brief  Indique si le dernier reset a été provoqué par le chien de garde.
+ * @return 1 si reset IWDG, 0 sinon.
+ */
+uint8_t watchdog_caused_reset(void){
+    return wdg_reset_flag;
+}
@@ -60,39 +60,65 @@ Reset_Handler:
   ldr   r0, =_estack
   mov   sp, r0          /* set stack pointer */
 
+/* SysTick free-running from reset (HCLK, 24 bits, no interrupt): time to main(),
+   read by mem_boot_stamp() until HAL_Init() reprograms it */
+  ldr   r0, =0xE000E010
+  ldr   r1, =0x00FFFFFF
+  str   r1, [r0, #4]    /* LOAD */
+  str   r1, [r0, #8]    /* VAL (any write clears it) */
+  movs  r1, #5          /* CLKSOURCE = HCLK, ENABLE */
+  str   r1, [r0]
+
 /* Call the clock system initialization function.*/
   bl  SystemInit
 
-/* Copy the data segment initializers from flash to SRAM */
+/* Copy the data segment initializers from flash to SRAM, 16 bytes per
+   iteration (ldm/stm), then the remaining words */
   ldr r0, =_sdata
   ldr r1, =_edata
   ldr r2, =_sidata
-  movs r3, #0
-  b LoopCopyDataInit
-
-CopyDataInit:
-  ldr r4, [r2, r3]
-  str r4, [r0, r3]
-  adds r3, r3, #4
-
-LoopCopyDataInit:
-  adds r4, r0, r3
-  cmp r4, r1
-  bcc CopyDataInit
-
-/* Zero fill the bss segment. */
-  ldr r2, =_sbss
-  ldr r4, =_ebss
-  movs r3, #0
-  b LoopFillZerobss
-
-FillZerobss:
-  str  r3, [r2]
-  adds r2, r2, #4
-
-LoopFillZerobss:
-  cmp r2, r4
-  bcc FillZerobss
+  subs r3, r1, r0
+  lsrs r3, r3, #4
+  beq LoopCopyDataTail
+
+CopyDataBlock:
+  ldmia r2!, {r4, r5, r6, r7}
+  stmia r0!, {r4, r5, r6, r7}
+  subs r3, r3, #1
+  bne CopyDataBlock
+
+LoopCopyDataTail:
+  cmp r0, r1
+  bhs ZeroBss
+  ldmia r2!, {r4}
+  stmia r0!, {r4}
+  b LoopCopyDataTail
+
+/* Zero fill the bss segment, 16 bytes per iteration. The .noinit section
+   (after .bss) is left untouched. */
+ZeroBss:
+  ldr r0, =_sbss
+  ldr r1, =_ebss
+  movs r4, #0
+  movs r5, #0
+  movs r6, #0
+  movs r7, #0
+  subs r3, r1, r0
+  lsrs r3, r3, #4
+  beq LoopFillZerobssTail
+
+FillZerobssBlock:
+  stmia r0!, {r4, r5, r6, r7}
+  subs r3, r3, #1
+  bne FillZerobssBlock
+
+LoopFillZerobssTail:
+  cmp r0, r1
+  bhs ZeroBssDone
+  stmia r0!, {r4}
+  b LoopFillZerobssTail
+
+ZeroBssDone:
 
 /* Call static constructors */
   bl __libc_init_array
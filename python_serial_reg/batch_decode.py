@@ -0,0 +1,419 @@
+##
+# @file batch_decode.py
+# @brief Décodage vectorisé (numpy) d'un enregistrement .tlm complet
+# @date 2025
+#
+# Pour l'analyse hors ligne, le décodage trame par trame (struct.unpack) coûte
+# plusieurs microsecondes par trame : une heure à 1 kHz demande plusieurs minutes.
+# Ici l'enregistrement est projeté en mémoire comme un tableau structuré numpy (les
+# enregistrements sont à pas fixe, REC_SIZE) et traité par blocs de BATCH_CHUNK :
+# - validation : enveloppe, longueur et CRC-8 de toutes les trames à la fois. Les
+#   trames du bloc sont triées par longueur décroissante et vues comme un tableau 2D
+#   d'octets ; la table du CRC est appliquée colonne par colonne aux seules lignes
+#   encore actives (un préfixe), soit une opération numpy par octet de la plus longue
+#   trame au lieu d'une boucle Python par octet de chaque trame ;
+# - décodage : les trames de même disposition (type, masque de champs, taille de lot
+#   delta) sont relues d'un coup par une vue dtype dérivée des formats de proto_defs.py,
+#   puis converties en unités physiques par opérations sur colonnes. Seuls les lots
+#   delta contenant des échappements passent par decode_delta_batch().
+#
+# Les échantillons produits ont la disposition de stp_sample_t (SAMPLE_DTYPE de
+# stm_proto.py) et les mêmes unités et conventions que stp_decode_frame() : dates
+# déroulées sur 64 bits, accélération en mm/s², gyroscope en rad/s, vitesse en mm/s.
+#
+# Usage : python batch_decode.py FICHIER.tlm [--npz SORTIE.npz]
+#
+
+import argparse
+import re
+import struct
+import sys
+import time
+
+try:
+    import numpy as np
+except ImportError as e:
+    raise ImportError("batch_decode.py nécessite numpy (pip install numpy)") from e
+
+from serial_reg import (ACCEL_RANGE_LSB, CRC8_TABLE, DEG_TO_RAD, FRAME_BURST, FRAME_CMD, FRAME_COMPACT,
+                        FRAME_FX, FRAME_IMU, FRAME_LEGACY, G_TO_MM_S2, GYRO_RANGE_LSB, REC_FILE_HDR,
+                        REC_FRAME_MAX, REC_MAGIC, REC_SIZE, REC_VERSION, TELEM_DELTA_ESCAPE, TELEM_F_ACCEL,
+                        TELEM_F_ATTITUDE, TELEM_F_GYRO, TELEM_F_MOTOR, TELEM_F_SENSOR, TELEM_F_SERVO,
+                        TELEM_F_SPEED, TELEM_F_TIMING, TELEM_FIELDS, TELEM_TYPE_COMPACT, TELEM_TYPE_DELTA,
+                        TELEM_TYPE_FIELDS, TELEM_TYPE_FX, TELEM_TYPE_LEGACY, decode_delta_batch)
+from stm_proto import SAMPLE_DTYPE
+
+## @brief Enregistrements traités par bloc (borne la mémoire des copies : ~70 Mo)
+BATCH_CHUNK = 1 << 18
+
+## @brief Champs valides d'un échantillon (STP_S_* de stm_proto.h)
+S_ACCEL = 0x01
+S_GYRO = 0x02
+S_SPEED = 0x04
+S_ATTITUDE = 0x08
+
+## @brief Enregistrement à pas fixe (REC_HDR puis la trame), lu sans copie
+REC_DTYPE = np.dtype({'names': ['host_ns', 'ts', 'seq', 'kind', 'len', 'frame'],
+                      'formats': ['<u8', '<u4', '<u2', 'u1', '<u2', ('u1', REC_FRAME_MAX)],
+                      'offsets': [0, 8, 12, 14, 16, 24],
+                      'itemsize': REC_SIZE})
+
+## @brief Table du CRC8 indexable par un tableau d'octets
+CRC8_LUT = np.array(CRC8_TABLE, dtype=np.uint8)
+
+## @brief Facteurs d'échelle BMI088 par code de gamme (scale_raw_axes)
+ACCEL_K = G_TO_MM_S2 / np.array(ACCEL_RANGE_LSB)
+GYRO_K = DEG_TO_RAD / np.array(GYRO_RANGE_LSB)
+
+_STRUCT_TO_NP = {'b': 'i1', 'B': 'u1', 'h': '<i2', 'H': '<u2', 'i': '<i4', 'I': '<u4',
+                 'q': '<i8', 'Q': '<u8', 'f': '<f4', 'd': '<f8'}
+
+##
+# @brief dtype numpy équivalent à un format struct (petit-boutiste, sans alignement)
+# @param st struct.Struct de proto_defs.py
+# @param names Noms des champs, un par élément du format ("3f" compte pour un champ) ;
+# None : f0, f1...
+# @return numpy.dtype de même taille que st
+def struct_dtype(st, names=None):
+    tokens = re.findall(r'(\d*)([a-zA-Z])', st.format.lstrip('<=!>@'))
+    if names is None:
+        names = [f"f{i}" for i in range(len(tokens))]
+    if len(names) != len(tokens):
+        raise ValueError(f"{st.format} : {len(tokens)} champs, {len(names)} noms")
+    fields = []
+    for name, (count, code) in zip(names, tokens):
+        if code not in _STRUCT_TO_NP:
+            raise ValueError(f"{st.format} : code '{code}' non pris en charge")
+        fields.append((name, _STRUCT_TO_NP[code], int(count)) if count else (name, _STRUCT_TO_NP[code]))
+    dt = np.dtype(fields)
+    if dt.itemsize != st.size:
+        raise ValueError(f"{st.format} : {dt.itemsize} octets au lieu de {st.size}")
+    return dt
+
+## @brief Entête commun des trames de télémétrie [AA 55 | type | LEN | seq | ts]
+_HDR = ('sync0', 'sync1', 'type', 'len', 'seq', 'ts')
+DT_LEGACY = struct_dtype(FRAME_LEGACY, _HDR + ('accel', 'gyro', 'speed', 'crc'))
+DT_FX = struct_dtype(FRAME_FX, _HDR + ('accel', 'gyro', 'speed', 'crc'))
+DT_COMPACT = struct_dtype(FRAME_COMPACT, _HDR + ('ranges', 'accel', 'gyro', 'speed', 'crc'))
+_HDR_DT = [('sync0', 'u1'), ('sync1', 'u1'), ('type', 'u1'), ('len', 'u1'), ('seq', '<u2'), ('ts', '<u4')]
+
+## @brief Nom des champs de la trame type 0x03
+FIELD_NAMES = {TELEM_F_ACCEL: 'accel', TELEM_F_GYRO: 'gyro', TELEM_F_SPEED: 'speed', TELEM_F_MOTOR: 'motor',
+               TELEM_F_SERVO: 'servo', TELEM_F_TIMING: 'timing', TELEM_F_ATTITUDE: 'attitude',
+               TELEM_F_SENSOR: 'sensor'}
+
+##
+# @brief dtype d'une trame type 0x03 pour un masque de champs donné
+def fields_dtype(mask):
+    fields = _HDR_DT + [('fields', 'u1')]
+    for bit, st in TELEM_FIELDS:
+        if mask & bit:
+            fields.append((FIELD_NAMES[bit], struct_dtype(st)))
+    return np.dtype(fields + [('crc', 'u1')])
+
+##
+# @brief dtype d'un lot delta (type 0x05) de count échantillons sans échappement
+def delta_dtype(count):
+    fields = _HDR_DT + [('ranges', 'u1'), ('count', 'u1'), ('speed', '<i2'), ('axes', '<i2', 6)]
+    if count > 1:
+        fields.append(('steps', [('dt', '<u2'), ('d', 'i1', 6)], count - 1))
+    return np.dtype(fields + [('crc', 'u1')])
+
+##
+# @brief Projette un enregistrement en mémoire
+# @param path Chemin du fichier .tlm
+# @return Tableau structuré REC_DTYPE (numpy.memmap, lecture seule)
+def load_records(path):
+    with open(path, 'rb') as f:
+        head = f.read(REC_FILE_HDR.size)
+        f.seek(0, 2)
+        size = f.tell()
+    if len(head) < REC_FILE_HDR.size:
+        raise ValueError("enregistrement vide")
+    magic, version, rec_size, _ = REC_FILE_HDR.unpack(head)
+    if magic != REC_MAGIC or version != REC_VERSION or rec_size != REC_SIZE:
+        raise ValueError("format d'enregistrement inconnu")
+    # Un enregistrement interrompu en fin de fichier est ignoré (TelemRecording)
+    count = (size - REC_FILE_HDR.size) // REC_SIZE
+    if count == 0:
+        return np.zeros(0, REC_DTYPE)
+    return np.memmap(path, dtype=REC_DTYPE, mode='r', offset=REC_FILE_HDR.size, shape=(count,))
+
+##
+# @brief CRC-8/ATM de chaque ligne d'un tableau d'octets 2D
+# @param rows Octets (lignes triées par longueur couverte décroissante)
+# @param body Octets couverts par le CRC pour chaque ligne (décroissant)
+# @return CRC de chaque ligne (uint8)
+def crc8_rows(rows, body):
+    crc = np.zeros(len(body), np.uint8)
+    if len(body) == 0:
+        return crc
+    # active[j] : lignes dont la j-ième colonne est couverte, un préfixe puisque body décroît
+    active = np.searchsorted(-body, -np.arange(int(body[0])), side='left')
+    for j, k in enumerate(active):
+        crc[:k] = CRC8_LUT[crc[:k] ^ rows[:k, j]]
+    return crc
+
+##
+# @brief Valide les trames d'un bloc d'enregistrements
+# Même contrôle que split_frames() : enveloppe et longueur des trames IMU, longueur des
+# réponses de commande et de lecture groupée (rangées sans leur SYNC), puis CRC
+# @param recs Tableau REC_DTYPE
+# @return Masque booléen des enregistrements valides
+def verify_records(recs):
+    frames = recs['frame']
+    length = recs['len'].astype(np.intp)
+    kind = recs['kind']
+    b1 = frames[:, 1].astype(np.intp)
+
+    imu = kind == FRAME_IMU
+    cmd = kind == FRAME_CMD
+    burst = kind == FRAME_BURST
+    ok = (length >= 4) & (length <= REC_FRAME_MAX)
+    ok &= ~imu | ((frames[:, 0] == 0xAA) & (b1 == 0x55) & (frames[:, 3].astype(np.intp) + 5 == length))
+    ok &= ~cmd | (length == 4)
+    ok &= ~burst | ((b1 > 0) & (2 * b1 + 3 == length))
+    ok &= imu | cmd | burst
+
+    idx = np.flatnonzero(ok)
+    body = length[idx] - 1
+    order = np.argsort(-body, kind='stable')
+    idx, body = idx[order], body[order]
+    if len(idx):
+        rows = frames[idx, :int(body[0]) + 1]
+        ok[idx] = crc8_rows(rows, body) == rows[np.arange(len(idx)), body]
+    return ok
+
+##
+# @brief Relit un groupe de trames de même disposition
+# @param frames Trames du bloc (2D)
+# @param idx Indices des trames du groupe
+# @param dt dtype de la disposition
+def _view(frames, idx, dt):
+    return np.ascontiguousarray(frames[idx, :dt.itemsize]).view(dt)[:, 0]
+
+def _samples(f, type_):
+    s = np.zeros(len(f), SAMPLE_DTYPE)
+    s['seq'] = f['seq']
+    s['type'] = type_
+    s['t_us'] = f['ts']
+    return s
+
+##
+# @brief Lots delta dont la disposition n'est pas fixe (échappements) : décodage par trame
+def _decode_delta_slow(frames, length, idx):
+    out, recs, subs = [], [], []
+    for i in idx:
+        frame = bytes(frames[i, :length[i]])
+        try:
+            ts, ranges, speed, batch = decode_delta_batch(frame[4:-1])
+        except struct.error:
+            continue
+        if frame[11] == 0:
+            continue
+        seq = struct.unpack_from('<H', frame, 4)[0]
+        axes = np.array([a for _, a in batch], np.int64)
+        s = np.zeros(len(batch), SAMPLE_DTYPE)
+        # Axes sur 16 bits, comme le firmware (l'ajout d'un delta reboucle)
+        axes = ((axes + 0x8000) & 0xFFFF) - 0x8000
+        s['accel'] = axes[:, 0:3] * ACCEL_K[ranges & 0x03]
+        s['gyro'] = axes[:, 3:6] * GYRO_K[min((ranges >> 2) & 0x07, 4)]
+        s['speed'] = speed
+        s['valid'] = S_ACCEL | S_GYRO | S_SPEED
+        s['seq'] = seq
+        s['type'] = TELEM_TYPE_DELTA
+        s['t_us'] = (ts + np.cumsum([dt for dt, _ in batch])) & 0xFFFFFFFF
+        out.append(s)
+        recs.append(np.full(len(batch), i, np.intp))
+        subs.append(np.arange(len(batch)))
+    return out, recs, subs
+
+##
+# @brief Décode la télémétrie d'un bloc d'enregistrements validés
+# @param recs Tableau REC_DTYPE
+# @param ok Masque des enregistrements valides (verify_records())
+# @return (échantillons SAMPLE_DTYPE dans l'ordre des enregistrements, dates 32 bits
+# non déroulées dans t_us ; indices des trames décodées ; leurs numéros de séquence)
+def decode_telemetry(recs, ok):
+    frames = recs['frame']
+    length = recs['len'].astype(np.intp)
+    ftype = frames[:, 2]
+    telem = ok & (recs['kind'] == FRAME_IMU)
+    out, rec_ix, sub_ix = [], [], []
+
+    def emit(s, idx, per_frame=1):
+        out.append(s)
+        rec_ix.append(np.repeat(idx, per_frame))
+        sub_ix.append(np.tile(np.arange(per_frame), len(idx)))
+
+    # Dispositions fixes : une vue par type
+    for type_, dt in ((TELEM_TYPE_LEGACY, DT_LEGACY), (TELEM_TYPE_FX, DT_FX), (TELEM_TYPE_COMPACT, DT_COMPACT)):
+        idx = np.flatnonzero(telem & (ftype == type_) & (length == dt.itemsize))
+        if len(idx) == 0:
+            continue
+        f = _view(frames, idx, dt)
+        s = _samples(f, type_)
+        if type_ == TELEM_TYPE_LEGACY:
+            s['accel'], s['gyro'], s['speed'] = f['accel'], f['gyro'], f['speed'] * 1000.0
+        elif type_ == TELEM_TYPE_FX:
+            s['accel'], s['gyro'], s['speed'] = f['accel'], f['gyro'] * 1e-6, f['speed']
+        else:
+            ranges = f['ranges']
+            s['accel'] = f['accel'] * ACCEL_K[ranges & 0x03][:, None]
+            s['gyro'] = f['gyro'] * GYRO_K[np.minimum((ranges >> 2) & 0x07, 4)][:, None]
+            s['speed'] = f['speed']
+        s['valid'] = S_ACCEL | S_GYRO | S_SPEED
+        emit(s, idx)
+
+    # Contenu choisi : une vue par masque de champs
+    fields = telem & (ftype == TELEM_TYPE_FIELDS)
+    masks = frames[:, 10]
+    for mask in np.unique(masks[fields]):
+        mask = int(mask)
+        dt = fields_dtype(mask)
+        idx = np.flatnonzero(fields & (masks == mask) & (length == dt.itemsize))
+        if len(idx) == 0:
+            continue
+        f = _view(frames, idx, dt)
+        s = _samples(f, TELEM_TYPE_FIELDS)
+        valid = 0
+        if mask & TELEM_F_ACCEL:
+            s['accel'] = f['accel']['f0']
+            valid |= S_ACCEL
+        if mask & TELEM_F_GYRO:
+            s['gyro'] = f['gyro']['f0'] * 1e-6
+            valid |= S_GYRO
+        if mask & TELEM_F_SPEED:
+            s['speed'] = f['speed']['f0']
+            valid |= S_SPEED
+        if mask & TELEM_F_ATTITUDE:
+            s['quat'] = f['attitude']['f0'] / 16384.0
+            valid |= S_ATTITUDE
+        s['valid'] = valid
+        emit(s, idx)
+
+    # Lots delta : sans échappement, la longueur fixe la disposition (4 + 22 + 8 x (count - 1) + 1)
+    delta = telem & (ftype == TELEM_TYPE_DELTA)
+    counts = frames[:, 11].astype(np.intp)
+    plain = delta & (counts > 0) & (length == 19 + 8 * counts)
+    slow = delta & ~plain
+    for count in np.unique(counts[plain]):
+        count = int(count)
+        dt = delta_dtype(count)
+        idx = np.flatnonzero(plain & (counts == count))
+        f = _view(frames, idx, dt)
+        axes = np.empty((len(f), count, 6), np.int64)
+        axes[:, 0] = f['axes']
+        t = np.zeros((len(f), count), np.int64)
+        t[:, 0] = f['ts']
+        if count > 1:
+            d = f['steps']['d'].astype(np.int64)
+            # Octet d'échappement malgré la longueur : trame laissée au décodage par trame
+            esc = (d == TELEM_DELTA_ESCAPE).any(axis=(1, 2))
+            if esc.any():
+                slow[idx[esc]] = True
+                f, d, axes, t, idx = f[~esc], d[~esc], axes[~esc], t[~esc], idx[~esc]
+            axes[:, 1:] = axes[:, :1] + np.cumsum(d, axis=1)
+            t[:, 1:] = t[:, :1] + np.cumsum(f['steps']['dt'].astype(np.int64), axis=1)
+        if len(idx) == 0:
+            continue
+        axes = ((axes + 0x8000) & 0xFFFF) - 0x8000
+        ranges = np.repeat(f['ranges'], count)
+        axes = axes.reshape(-1, 6)
+        s = np.zeros(len(axes), SAMPLE_DTYPE)
+        s['accel'] = axes[:, 0:3] * ACCEL_K[ranges & 0x03][:, None]
+        s['gyro'] = axes[:, 3:6] * GYRO_K[np.minimum((ranges >> 2) & 0x07, 4)][:, None]
+        s['speed'] = np.repeat(f['speed'], count)
+        s['valid'] = S_ACCEL | S_GYRO | S_SPEED
+        s['seq'] = np.repeat(f['seq'], count)
+        s['type'] = TELEM_TYPE_DELTA
+        s['t_us'] = (t & 0xFFFFFFFF).ravel()
+        emit(s, idx, count)
+
+    slow_out, slow_recs, slow_subs = _decode_delta_slow(frames, length, np.flatnonzero(slow))
+    out += slow_out
+    rec_ix += slow_recs
+    sub_ix += slow_subs
+
+    if not out:
+        return np.zeros(0, SAMPLE_DTYPE), np.zeros(0, np.intp), np.zeros(0, np.uint16)
+    samples = np.concatenate(out)
+    rec = np.concatenate(rec_ix)
+    order = np.lexsort((np.concatenate(sub_ix), rec))
+    samples, rec = samples[order], rec[order]
+    first = np.ones(len(rec), bool)
+    first[1:] = rec[1:] != rec[:-1]
+    return samples, rec[first], samples['seq'][first]
+
+##
+# @brief Déroule des dates firmware 32 bits sur 64 bits (un recul de plus d'une
+# demi-plage est un rebouclage, comme unwrap() de stm_proto.c)
+# @param t32 Dates µs (entiers < 2^32)
+# @return Dates µs déroulées (uint64)
+def unwrap_us(t32):
+    t = t32.astype(np.int64)
+    wraps = np.zeros(len(t), np.int64)
+    wraps[1:] = (t[:-1] - t[1:]) > 0x80000000
+    return (t + (np.cumsum(wraps) << 32)).astype(np.uint64)
+
+##
+# @brief Décode un enregistrement complet
+# @param path Chemin du fichier .tlm
+# @param chunk Enregistrements par bloc
+# @return (échantillons SAMPLE_DTYPE, dictionnaire de bilan)
+def decode_recording(path, chunk=BATCH_CHUNK):
+    recs = load_records(path)
+    stats = {'records': len(recs), 'imu': 0, 'cmd': 0, 'burst': 0, 'invalid': 0, 'frames': 0,
+             'rejected': 0, 'samples': 0, 'lost': 0, 'types': {}, 'duration_s': 0.0}
+    parts, seqs = [], []
+    for lo in range(0, len(recs), chunk):
+        part = recs[lo:lo + chunk]
+        ok = verify_records(part)
+        kind = part['kind']
+        stats['invalid'] += int(np.count_nonzero(~ok))
+        stats['imu'] += int(np.count_nonzero(ok & (kind == FRAME_IMU)))
+        stats['cmd'] += int(np.count_nonzero(ok & (kind == FRAME_CMD)))
+        stats['burst'] += int(np.count_nonzero(ok & (kind == FRAME_BURST)))
+        types, n = np.unique(part['frame'][ok & (kind == FRAME_IMU), 2], return_counts=True)
+        for t, c in zip(types.tolist(), n.tolist()):
+            stats['types'][t] = stats['types'].get(t, 0) + c
+        samples, rec, seq = decode_telemetry(part, ok)
+        telem = ok & (kind == FRAME_IMU) & np.isin(part['frame'][:, 2],
+                                                   (TELEM_TYPE_LEGACY, TELEM_TYPE_FX, TELEM_TYPE_FIELDS,
+                                                    TELEM_TYPE_COMPACT, TELEM_TYPE_DELTA))
+        stats['frames'] += len(rec)
+        stats['rejected'] += int(np.count_nonzero(telem)) - len(rec)
+        parts.append(samples)
+        seqs.append(seq)
+
+    samples = np.concatenate(parts) if parts else np.zeros(0, SAMPLE_DTYPE)
+    samples['t_us'] = unwrap_us(samples['t_us'])
+    seq = np.concatenate(seqs).astype(np.int64) if seqs else np.zeros(0, np.int64)
+    stats['samples'] = len(samples)
+    stats['lost'] = int((((seq[1:] - seq[:-1] - 1) & 0xFFFF)).sum())
+    if len(recs) > 1:
+        stats['duration_s'] = (int(recs['host_ns'][-1]) - int(recs['host_ns'][0])) / 1e9
+    return samples, stats
+
+def main():
+    parser = argparse.ArgumentParser(description="Décodage vectorisé d'un enregistrement .tlm")
+    parser.add_argument("path", metavar="FICHIER", help="enregistrement .tlm (TelemRecorder)")
+    parser.add_argument("--npz", metavar="SORTIE", help="écrit les échantillons (numpy.savez, clé 'samples')")
+    args = parser.parse_args()
+
+    t0 = time.perf_counter()
+    samples, s = decode_recording(args.path)
+    elapsed = time.perf_counter() - t0
+    types = " ".join(f"0x{t:02X}:{n}" for t, n in sorted(s['types'].items()))
+    print(f"{s['records']} enregistrements sur {s['duration_s']:.1f} s : "
+          f"{s['imu']} IMU ({types}), {s['cmd']} CMD, {s['burst']} BURST, {s['invalid']} invalides")
+    print(f"{s['frames']} trames de télémétrie -> {s['samples']} échantillons, "
+          f"{s['rejected']} rejetées, {s['lost']} perdues (séquence)")
+    rate = s['records'] / elapsed if elapsed > 0 else 0.0
+    print(f"décodé en {elapsed:.2f} s ({rate / 1e6:.2f} M enregistrements/s)")
+    if args.npz:
+        np.savez(args.npz, samples=samples)
+    return 1 if s['invalid'] else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
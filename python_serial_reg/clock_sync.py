@@ -0,0 +1,209 @@
+##
+# @file clock_sync.py
+# @brief Synchronisation d'horloge hôte <-> STM32 par échange d'échos (REG_PING)
+# @date 2025
+#
+# Chaque écho fournit quatre dates, façon NTP : émission hôte (h0), arrivée des octets
+# côté firmware (t_rx), remise de la réponse au TX (t_tx), réception hôte (h3). En
+# supposant l'aller et le retour symétriques, l'écart d'horloge vaut
+# ((t_rx - h0) + (t_tx - h3)) / 2, à la moitié de l'asymétrie près. Les échanges dont
+# le temps de liaison (h3 - h0 - (t_tx - t_rx)) est le plus court sont les moins
+# perturbés par les tampons USB : seuls ceux-là servent à l'ajustement linéaire
+# date firmware -> date hôte, qui estime à la fois le décalage et la dérive (ppm).
+#
+# Les dates firmware sont sur 32 bits (µs, rebouclage après ~71 min) : elles sont
+# déroulées sur 64 bits, comme les dates des trames de télémétrie converties par
+# ClockSync.mcu_to_host_ns().
+#
+# Usage : python clock_sync.py PORT [-n 200] [--baud 921600] [--interval 50]
+#
+
+import argparse
+import queue
+import sys
+import threading
+import time
+
+import serial
+
+from latency_bench import ECHO_TIMEOUT_S, reader, set_baud
+from serial_reg import BAUD_RATES, REG_PING, build_frame
+
+## @brief Fraction des échanges (liaison la plus courte) retenue pour l'ajustement
+SYNC_KEEP_FRACTION = 0.25
+## @brief Nombre minimal d'échanges retenus pour estimer une dérive
+SYNC_MIN_POINTS = 8
+## @brief Nombre d'échanges conservés (fenêtre glissante)
+SYNC_WINDOW = 512
+
+##
+# @class Unwrap32
+# @brief Déroule un compteur 32 bits monotone en valeur 64 bits
+class Unwrap32:
+    def __init__(self):
+        self.last = None
+        self.high = 0
+
+    ##
+    # @brief Valeur déroulée
+    # @param v Compteur 32 bits
+    def __call__(self, v):
+        if self.last is not None and v < self.last and (self.last - v) > 0x80000000:
+            self.high += 1 << 32
+        self.last = v
+        return self.high + v
+
+##
+# @class ClockSync
+# @brief Estimation du décalage et de la dérive de l'horloge firmware (µs) par rapport à l'hôte (ns)
+class ClockSync:
+    def __init__(self, window=SYNC_WINDOW):
+        self.window = window
+        self.samples = []       # (t_mcu µs déroulé, écart hôte - firmware ns, liaison ns)
+        self.unwrap = Unwrap32()
+        self.offset_ns = None   # Date hôte (ns) de la date firmware mcu_ref_us
+        self.mcu_ref_us = 0
+        self.drift = 0.0        # ns hôte par µs firmware, moins 1000
+
+    ##
+    # @brief Ajoute un échange d'écho
+    # @param h0_ns Émission de la commande (time.perf_counter_ns())
+    # @param h3_ns Réception de l'écho
+    # @param t_rx Arrivée des octets côté firmware (µs, 32 bits)
+    # @param t_tx Remise de la réponse au TX (µs, 32 bits)
+    def add(self, h0_ns, h3_ns, t_rx, t_tx):
+        fw_ns = ((t_tx - t_rx) & 0xFFFFFFFF) * 1000
+        link_ns = (h3_ns - h0_ns) - fw_ns
+        if link_ns < 0:
+            return
+        mid_us = self.unwrap(t_rx) + fw_ns / 2000.0
+        self.samples.append((mid_us, (h0_ns + h3_ns) / 2.0 - mid_us * 1000.0, link_ns))
+        if len(self.samples) > self.window:
+            del self.samples[0]
+
+    ##
+    # @brief Ajuste décalage et dérive sur les échanges à liaison la plus courte
+    # @return True si une estimation est disponible
+    def fit(self):
+        if not self.samples:
+            return False
+        best = sorted(self.samples, key=lambda s: s[2])
+        best = best[:max(1, int(len(best) * SYNC_KEEP_FRACTION))]
+        if len(best) < SYNC_MIN_POINTS:
+            self.mcu_ref_us, self.offset_ns = best[0][0], best[0][1]
+            self.drift = 0.0
+            return True
+        n = len(best)
+        mx = sum(s[0] for s in best) / n
+        my = sum(s[1] for s in best) / n
+        sxx = sum((s[0] - mx) ** 2 for s in best)
+        sxy = sum((s[0] - mx) * (s[1] - my) for s in best)
+        self.drift = sxy / sxx if sxx > 0 else 0.0
+        self.mcu_ref_us, self.offset_ns = mx, my
+        return True
+
+    ##
+    # @brief Déroule une date firmware 32 bits au plus près du dernier échange
+    # @param t32 Date firmware (µs, 32 bits)
+    # @return Date déroulée (µs)
+    def unwrap_near(self, t32):
+        ref = self.unwrap.high + (self.unwrap.last or 0)
+        v = (ref & ~0xFFFFFFFF) | (t32 & 0xFFFFFFFF)
+        if v - ref > 0x80000000:
+            v -= 1 << 32
+        elif ref - v > 0x80000000:
+            v += 1 << 32
+        return v
+
+    ##
+    # @brief Convertit une date firmware (trames de télémétrie, journal) en date hôte
+    # @param t32 Date firmware (µs, 32 bits)
+    # @return Date hôte (ns, même base que time.perf_counter_ns())
+    def mcu_to_host_ns(self, t32):
+        t_mcu_us = self.unwrap_near(t32)
+        return t_mcu_us * 1000.0 + self.offset_ns + self.drift * (t_mcu_us - self.mcu_ref_us)
+
+    ##
+    # @brief Convertit une date hôte en date firmware
+    # @param t_host_ns Date hôte (ns, time.perf_counter_ns())
+    # @return Date firmware déroulée (µs)
+    def host_to_mcu_us(self, t_host_ns):
+        # t_host = t_mcu * (1000 + drift) + offset - drift * ref
+        return (t_host_ns - self.offset_ns + self.drift * self.mcu_ref_us) / (1000.0 + self.drift)
+
+    ##
+    # @brief Dérive de l'horloge firmware par rapport à l'hôte
+    # @return Dérive en ppm (positive : le firmware retarde)
+    def drift_ppm(self):
+        return self.drift * 1000.0
+
+    ##
+    # @brief Écart type des échanges retenus autour de l'ajustement
+    # @return Résidu (µs)
+    def residual_us(self):
+        best = sorted(self.samples, key=lambda s: s[2])
+        best = best[:max(1, int(len(best) * SYNC_KEEP_FRACTION))]
+        res = [s[1] - (self.offset_ns + self.drift * (s[0] - self.mcu_ref_us)) for s in best]
+        return (sum(r * r for r in res) / len(res)) ** 0.5 / 1000.0
+
+    ##
+    # @brief Plus courte durée de liaison observée (borne de l'incertitude sur le décalage)
+    # @return Durée (µs)
+    def min_link_us(self):
+        return min(s[2] for s in self.samples) / 1000.0 if self.samples else 0.0
+
+def main():
+    parser = argparse.ArgumentParser(description="Synchronisation d'horloge par écho REG_PING")
+    parser.add_argument("port", help="port série (ex. /dev/ttyACM0, COM5)")
+    parser.add_argument("-n", "--count", type=int, default=200, help="nombre d'échanges")
+    parser.add_argument("--baud", type=int, default=BAUD_RATES[0], choices=BAUD_RATES, help="débit négocié avant la mesure")
+    parser.add_argument("--interval", type=float, default=50.0, help="pause entre deux échanges (ms)")
+    args = parser.parse_args()
+
+    ser = serial.Serial(args.port, BAUD_RATES[0], timeout=0.05)
+    if args.baud != BAUD_RATES[0]:
+        set_baud(ser, args.baud)
+
+    echoes = queue.Queue()
+    stop = threading.Event()
+    thread = threading.Thread(target=reader, args=(ser, echoes, stop), daemon=True)
+    thread.start()
+
+    sync = ClockSync()
+    lost = 0
+    try:
+        for i in range(args.count):
+            token = i & 0x7FFF
+            frame = build_frame(REG_PING & 0x7F, token & 0xFF, token >> 8)
+            h0 = time.perf_counter_ns()
+            ser.write(frame)
+            while True:
+                try:
+                    h3, (echo_token, t_rx, _t_parse, _t_app, t_tx) = echoes.get(timeout=ECHO_TIMEOUT_S)
+                except queue.Empty:
+                    lost += 1
+                    break
+                if echo_token == token:
+                    sync.add(h0, h3, t_rx, t_tx)
+                    break
+            if args.interval > 0:
+                time.sleep(args.interval / 1000.0)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        stop.set()
+        thread.join(timeout=1.0)
+        ser.close()
+
+    if not sync.fit():
+        print("aucun écho reçu")
+        return 1
+    print(f"{len(sync.samples)} échanges, {lost} perdus")
+    print(f"liaison min    : {sync.min_link_us():.0f} µs")
+    print(f"dérive         : {sync.drift_ppm():+.1f} ppm")
+    print(f"résidu         : {sync.residual_us():.1f} µs")
+    print(f"décalage       : {(sync.offset_ns - sync.mcu_ref_us * 1000.0) / 1e3:.1f} µs (perf_counter - firmware)")
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,336 @@
+##
+# @file decode_bench.py
+# @brief Banc de non-régression du découpage et du décodage de la télémétrie côté hôte
+# @date 2025
+#
+# Rejoue hors liaison, par tranches de lecture de taille aléatoire (comme ser.read() dans
+# _read_serial_loop), des flux synthétiques de trames de télémétrie à travers :
+# - le décodeur Python : split_frames / split_envelopes / split_cobs puis imu_samples(),
+#   le chemin de l'interface graphique (lecture puis décodage) dans un seul thread ;
+# - le décodeur natif : stm_proto.Splitter.decode() (host_lib, "make -C host_lib").
+#
+# Trois flux, générés avec une graine fixe (mêmes octets d'une exécution à l'autre) :
+# - clean : trames jointives ;
+# - noisy : octets altérés au hasard (--ber), trames touchées perdues ;
+# - misaligned : octets parasites entre les trames (dont des octets de synchronisation
+#   0xAA / 0x55 / 0xA5 ; en COBS, fragments de bloc clos par leur délimiteur), premier
+#   octet du flux au milieu d'une trame.
+#
+# Pour chaque décodeur et chaque flux, le rapport donne :
+# - trames décodées par seconde et temps processeur par trame (µs) ;
+# - trames intactes perdues (une corruption ne doit coûter que sa propre trame) et
+#   trames fantômes (décodées sans avoir été émises intactes) ;
+# - le recalage : octets reçus au-delà de la fin de la première trame intacte qui suit
+#   une perturbation avant qu'elle soit remise (moyenne, maximum), et la durée
+#   correspondante au débit --baud.
+#
+# Le rapport JSON (--out) se compare à un rapport précédent (--compare) ; avec
+# --tolerance, une baisse de débit de décodage au-delà du seuil fait échouer le banc
+# (code de sortie 1), pour un contrôle avant fusion des modifications de l'interface.
+#
+# Usage : python decode_bench.py [--frames 20000] [--format fx] [--mode raw]
+#                                [--decoders python native] [--out rapport.json]
+#                                [--compare precedent.json [--tolerance 10]]
+#
+
+import argparse
+import json
+import random
+import struct
+import sys
+import time
+
+from serial_reg import (FRAME_COMPACT, FRAME_FX, FRAME_IMU, FRAME_LEGACY, PROTO_SYNC, TELEM_TYPE_COMPACT,
+                        TELEM_TYPE_FX, TELEM_TYPE_LEGACY, build_frame, crc8_atm, imu_samples, split_cobs,
+                        split_envelopes, split_frames)
+
+## @brief Graine des flux synthétiques
+BENCH_SEED = 0x5EED
+## @brief Trames par flux (numéros de séquence distincts : au plus 65536)
+BENCH_FRAMES = 20000
+## @brief Taille maximale d'une tranche de lecture (octets)
+BENCH_CHUNK_MAX = 512
+## @brief Probabilité d'altération d'un octet du flux "noisy"
+BENCH_BER = 1e-3
+## @brief Octets parasites au plus entre deux trames du flux "misaligned"
+BENCH_GARBAGE_MAX = 24
+## @brief Une trame de commande (réponse 0xA5) toutes les N trames en mode raw
+BENCH_CMD_EVERY = 50
+## @brief Débit série de conversion du recalage en durée (bauds, 10 bits par octet)
+BENCH_BAUD = 921600
+## @brief Échantillons décodés par appel natif
+NATIVE_OUT = 1024
+
+BENCH_STREAMS = ["clean", "noisy", "misaligned"]
+BENCH_DECODERS = ["python", "native"]
+## @brief Formats de télémétrie générés : (type, structure)
+BENCH_FORMATS = {"legacy": (TELEM_TYPE_LEGACY, FRAME_LEGACY), "fx": (TELEM_TYPE_FX, FRAME_FX),
+                 "compact": (TELEM_TYPE_COMPACT, FRAME_COMPACT)}
+## @brief Découpeur Python et mode du découpeur natif (STP_MODE_*) de chaque format de flux
+BENCH_MODES = {"raw": (split_frames, 0), "envelope": (split_envelopes, 1), "cobs": (split_cobs, 2)}
+## @brief Grandeurs comparées d'un rapport à l'autre : (clé, format, sens favorable)
+COMPARE_KEYS = [("frames_s", ".0f", 1), ("cpu_us", ".2f", -1), ("lost", "d", -1), ("resync_max_bytes", "d", -1)]
+
+##
+# @brief Construit une trame de télémétrie de type donné (contenu pseudo-aléatoire)
+# @param rng Générateur
+# @param fmt Clé de BENCH_FORMATS
+# @param seq Numéro de séquence
+# @return Trame complète, CRC compris
+def make_frame(rng, fmt, seq):
+    type_, st = BENCH_FORMATS[fmt]
+    t_us = (seq * 1000) & 0xFFFFFFFF
+    if fmt == "legacy":
+        body = st.pack(0xAA, 0x55, type_, st.size - 5, seq, t_us,
+                       *[rng.uniform(-20000.0, 20000.0) for _ in range(3)],
+                       *[rng.uniform(-5.0, 5.0) for _ in range(3)], rng.uniform(-3.0, 3.0), 0)
+    elif fmt == "fx":
+        body = st.pack(0xAA, 0x55, type_, st.size - 5, seq, t_us,
+                       *[rng.randint(-200000, 200000) for _ in range(3)],
+                       *[rng.randint(-5000000, 5000000) for _ in range(3)], rng.randint(-3000, 3000), 0)
+    else:
+        body = st.pack(0xAA, 0x55, type_, st.size - 5, seq, t_us, 0x09,
+                       *[rng.randint(-32768, 32767) for _ in range(6)], rng.randint(-3000, 3000), 0)
+    return body[:-1] + bytes([crc8_atm(body[:-1])])
+
+##
+# @brief Encode une trame en COBS, délimiteur 0x00 final compris (firmware CAPS_LINK_COBS)
+def cobs_encode(frame):
+    out = bytearray([0])
+    code_pos, code = 0, 1
+    for b in frame:
+        if b:
+            out.append(b)
+            code += 1
+        if not b or code == 0xFF:
+            out[code_pos] = code
+            code_pos, code = len(out), 1
+            out.append(0)
+    out[code_pos] = code
+    out.append(0)
+    return bytes(out)
+
+##
+# @brief Génère un flux synthétique
+# @param stream Clé de BENCH_STREAMS
+# @param fmt Format des trames (BENCH_FORMATS)
+# @param mode Format du flux (BENCH_MODES)
+# @param frames Nombre de trames de télémétrie
+# @param ber Probabilité d'altération d'un octet (flux "noisy")
+# @return (octets, {seq: fin de la trame intacte dans le flux}, seq des trames qui suivent une perturbation)
+def make_stream(stream, fmt, mode, frames, ber):
+    rng = random.Random(f"{BENCH_SEED}:{stream}:{fmt}:{mode}")
+    out = bytearray(b"\x00" if mode == "cobs" else b"")
+    intact = {}
+    after = set()
+    disturbed = False
+
+    for seq in range(frames):
+        if stream == "misaligned":
+            n = rng.randint(0, BENCH_GARBAGE_MAX)
+            if n:
+                out += bytes(rng.choice((0xAA, 0x55, PROTO_SYNC, rng.randrange(1, 256))) for _ in range(n))
+                if mode == "cobs":
+                    out.append(0)       # Fragment de bloc : le délimiteur isole la trame suivante
+                disturbed = True
+        if mode == "raw" and seq % BENCH_CMD_EVERY == 0:
+            out += build_frame(0x80 | (seq & 0x7F), seq & 0xFF, 0)
+
+        raw = make_frame(rng, fmt, seq)
+        if stream == "misaligned" and seq == 0:
+            raw = raw[len(raw) // 2:]      # Lecture ouverte au milieu d'une trame
+            disturbed = True
+        data = bytearray(cobs_encode(raw) if mode == "cobs" else raw)
+        hit = False
+        if stream == "noisy":
+            for i in range(len(data)):
+                if rng.random() < ber:
+                    data[i] ^= rng.randrange(1, 256)
+                    hit = True
+        out += data
+
+        if hit or (stream == "misaligned" and seq == 0):
+            disturbed = True
+            continue
+        intact[seq] = len(out)
+        if disturbed:
+            after.add(seq)
+            disturbed = False
+    return bytes(out), intact, after
+
+##
+# @brief Découpe un flux en tranches de lecture de taille aléatoire
+def make_chunks(data, chunk_max):
+    rng = random.Random(BENCH_SEED)
+    chunks = []
+    pos = 0
+    while pos < len(data):
+        n = rng.randint(1, chunk_max)
+        chunks.append(data[pos:pos + n])
+        pos += n
+    return chunks
+
+##
+# @brief Décodeur Python : même boucle que _read_serial_loop, décodage des trames IMU
+# @return Liste de (seq, octets reçus à la remise)
+def run_python(chunks, mode):
+    split = BENCH_MODES[mode][0]
+    buf = bytearray()
+    seen = []
+    pos = 0
+
+    def emit(kind, packet):
+        if kind == FRAME_IMU and packet[2] in (TELEM_TYPE_LEGACY, TELEM_TYPE_FX, TELEM_TYPE_COMPACT):
+            imu_samples(packet)
+            seen.append((struct.unpack_from('<H', packet, 4)[0], pos))
+
+    for data in chunks:
+        pos += len(data)
+        buf.extend(data)
+        used = split(buf, emit)
+        if used:
+            del buf[:used]
+    return seen
+
+##
+# @brief Décodeur natif : découpage et décodage en un appel par tranche
+# @return Liste de (seq, octets reçus à la remise)
+def run_native(chunks, mode):
+    import stm_proto
+
+    sp = stm_proto.Splitter(BENCH_MODES[mode][1])
+    dec = stm_proto.Decoder()
+    out = stm_proto.SampleArray(NATIVE_OUT)
+    seen = []
+    pos = 0
+
+    for data in chunks:
+        pos += len(data)
+        n = sp.decode(dec, data, out)
+        while True:
+            seen.extend((s.seq, pos) for s in out[:n])
+            if n < NATIVE_OUT:
+                break
+            n = sp.decode(dec, b"", out)
+    return seen
+
+##
+# @brief Mesure un décodeur sur un flux
+# @return Résultat (dict), None si le décodeur n'est pas disponible
+def run_bench(decoder, stream, args):
+    data, intact, after = make_stream(stream, args.format, args.mode, args.frames, args.ber)
+    chunks = make_chunks(data, args.chunk)
+    run = run_python if decoder == "python" else run_native
+
+    try:
+        run(chunks[:4], args.mode)          # Chargement de la bibliothèque, caches
+    except ImportError as e:
+        print(f"{decoder}: {e}", file=sys.stderr)
+        return None
+
+    best = None
+    for _ in range(args.repeat):
+        c0, t0 = time.process_time(), time.perf_counter()
+        seen = run(chunks, args.mode)
+        wall, cpu = time.perf_counter() - t0, time.process_time() - c0
+        if best is None or wall < best[0]:
+            best = (wall, cpu, seen)
+    wall, cpu, seen = best
+
+    got = {}
+    for seq, pos in seen:
+        got.setdefault(seq, pos)
+    lost = sum(1 for s in intact if s not in got)
+    ghost = sum(1 for s in got if s not in intact)
+    delays = [got[s] - intact[s] for s in after if s in got]
+    resync_mean = sum(delays) / len(delays) if delays else 0.0
+    resync_max = max(delays) if delays else 0
+
+    return {"decoder": decoder, "stream": stream, "bytes": len(data), "frames": len(got),
+            "frames_s": len(got) / wall if wall > 0 else 0.0,
+            "cpu_us": cpu * 1e6 / len(got) if got else 0.0,
+            "mb_s": len(data) / wall / 1e6 if wall > 0 else 0.0,
+            "intact": len(intact), "lost": lost, "ghost": ghost, "disturbed": len(after),
+            "resync_mean_bytes": round(resync_mean, 1), "resync_max_bytes": resync_max,
+            "resync_max_ms": resync_max * 10.0 * 1000.0 / args.baud}
+
+##
+# @brief Affiche l'écart avec un rapport précédent
+# @param tolerance Baisse de débit tolérée (%), None : affichage seul
+# @return Nombre de régressions au-delà de la tolérance
+def compare(report, previous, tolerance):
+    old = {(r["decoder"], r["stream"]): r for r in previous.get("results", [])}
+    regressions = 0
+    diff = [k for k in ("frames", "format", "mode", "chunk", "ber") if previous.get(k) != report[k]]
+    if diff:
+        print(f"\nrapport {previous.get('date', '?')} non comparable (réglages différents : {', '.join(diff)})")
+        return 0
+    print(f"\ncomparaison avec {previous.get('date', '?')} (python {previous.get('python', '?')})")
+    print(f"{'décodeur/flux':<22}" + "".join(f"{k:>26}" for k, _, _ in COMPARE_KEYS))
+    for r in report["results"]:
+        ref = old.get((r["decoder"], r["stream"]))
+        if ref is None:
+            continue
+        cols = ""
+        for key, fmt, sign in COMPARE_KEYS:
+            a, b = ref.get(key), r.get(key)
+            if a is None or b is None:
+                cols += f"{'-':>26}"
+                continue
+            mark = "" if a == b else ("+" if (b - a) * sign > 0 else "!")
+            cols += f"{format(a, fmt) + ' -> ' + format(b, fmt) + mark:>26}"
+        slow = tolerance is not None and ref["frames_s"] > 0 and \
+            r["frames_s"] < ref["frames_s"] * (1.0 - tolerance / 100.0)
+        if slow or (tolerance is not None and r["lost"] > ref["lost"]):
+            regressions += 1
+            cols += "  RÉGRESSION"
+        print(f"{r['decoder'] + '/' + r['stream']:<22}{cols}")
+    return regressions
+
+def main():
+    parser = argparse.ArgumentParser(description="Banc de non-régression du décodeur de télémétrie hôte")
+    parser.add_argument("--frames", type=int, default=BENCH_FRAMES, help="trames par flux (<= 65536)")
+    parser.add_argument("--format", choices=sorted(BENCH_FORMATS), default="fx", help="format des trames")
+    parser.add_argument("--mode", choices=sorted(BENCH_MODES), default="raw", help="format du flux")
+    parser.add_argument("--streams", nargs="+", choices=BENCH_STREAMS, default=BENCH_STREAMS)
+    parser.add_argument("--decoders", nargs="+", choices=BENCH_DECODERS, default=BENCH_DECODERS)
+    parser.add_argument("--chunk", type=int, default=BENCH_CHUNK_MAX, help="tranche de lecture maximale (octets)")
+    parser.add_argument("--ber", type=float, default=BENCH_BER, help="probabilité d'altération d'un octet (noisy)")
+    parser.add_argument("--baud", type=int, default=BENCH_BAUD, help="débit de conversion du recalage en ms")
+    parser.add_argument("--repeat", type=int, default=3, help="mesures par cas (meilleure retenue)")
+    parser.add_argument("--out", help="rapport JSON")
+    parser.add_argument("--compare", help="rapport JSON précédent à comparer")
+    parser.add_argument("--tolerance", type=float,
+                        help="baisse de trames/s tolérée face à --compare (%%) ; au-delà, code de sortie 1")
+    args = parser.parse_args()
+    args.frames = max(1, min(args.frames, 65536))
+
+    report = {"date": time.strftime("%Y-%m-%d %H:%M:%S"), "python": sys.version.split()[0],
+              "frames": args.frames, "format": args.format, "mode": args.mode, "chunk": args.chunk,
+              "ber": args.ber, "results": []}
+
+    print(f"{args.frames} trames {args.format}, flux {args.mode}, lectures <= {args.chunk} octets")
+    print(f"{'décodeur/flux':<22}{'trames/s':>10}{'µs cpu':>8}{'Mo/s':>7}{'perdues':>9}{'fantômes':>9}"
+          f"{'recalage moy/max (octets)':>27}{'max ms':>8}")
+    for decoder in args.decoders:
+        for stream in args.streams:
+            r = run_bench(decoder, stream, args)
+            if r is None:
+                break
+            report["results"].append(r)
+            print(f"{decoder + '/' + stream:<22}{r['frames_s']:>10.0f}{r['cpu_us']:>8.2f}{r['mb_s']:>7.2f}"
+                  f"{r['lost']:>9}{r['ghost']:>9}"
+                  f"{format(r['resync_mean_bytes'], '.0f') + ' / ' + str(r['resync_max_bytes']):>27}"
+                  f"{r['resync_max_ms']:>8.2f}")
+
+    if args.out:
+        with open(args.out, "w", encoding="utf-8") as f:
+            json.dump(report, f, indent=2)
+    regressions = 0
+    if args.compare:
+        with open(args.compare, encoding="utf-8") as f:
+            regressions = compare(report, json.load(f), args.tolerance)
+    return 0 if report["results"] and regressions == 0 else 1
+
+if __name__ == "__main__":
+    sys.exit(main())
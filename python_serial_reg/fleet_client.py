@@ -0,0 +1,200 @@
+##
+# @file fleet_client.py
+# @brief Client du démon de flotte (fleet_daemon.py) et format des messages échangés
+# @date 2025
+#
+# Le démon garde les ports série ; les clients (interface, scripts) se connectent en
+# TCP local et reçoivent des trames déjà découpées et vérifiées (CRC) par le démon.
+# Chaque message, dans les deux sens, est [LEN u32 | TYPE u8 | corps] (LEN = 1 + corps) :
+#
+# - MSG_FRAME (démon -> client) : [LIEN u8 | NATURE u8 | t hôte ns u64 | trame]
+#   (NATURE : FRAME_IMU / FRAME_CMD / FRAME_BURST de serial_reg.py)
+# - MSG_WRITE (client -> démon) : [LIEN u8 | octets à émettre tels quels]
+# - MSG_JSON (deux sens) : objet JSON UTF-8 ; requêtes {"op": ...} du client,
+#   réponses et événements du démon (voir fleet_daemon.py)
+#
+# FleetLink imite la partie de serial.Serial utilisée par serial_reg.py (write, flush,
+# baudrate, port, is_open, close) : l'interface devient un client léger en ouvrant
+# "fleet://HÔTE:PORT/NOM" à la place d'un port série.
+#
+
+import json
+import socket
+import struct
+
+## @brief Adresse d'écoute par défaut du démon
+FLEET_HOST = "127.0.0.1"
+FLEET_PORT = 5760
+## @brief Préfixe des liens du démon dans la liste des ports de l'interface
+FLEET_SCHEME = "fleet://"
+
+## @brief Types de message
+MSG_FRAME = 0x46    # 'F'
+MSG_WRITE = 0x57    # 'W'
+MSG_JSON = 0x4A     # 'J'
+
+## @brief Entête de message [LEN u32 | TYPE u8] et entête de trame relayée [LIEN u8 | NATURE u8 | t ns u64]
+MSG_HDR = struct.Struct('<IB')
+FRAME_HDR = struct.Struct('<BBQ')
+
+## @brief Délai d'attente d'une réponse JSON (s)
+FLEET_REPLY_TIMEOUT_S = 2.0
+
+##
+# @brief Construit un message
+# @param msg_type Type (MSG_*)
+# @param body Corps (bytes)
+# @return Message prêt à émettre
+def pack_msg(msg_type, body):
+    return MSG_HDR.pack(len(body) + 1, msg_type) + body
+
+##
+# @brief Construit un message JSON
+# @param obj Objet sérialisable
+def pack_json(obj):
+    return pack_msg(MSG_JSON, json.dumps(obj, separators=(',', ':')).encode())
+
+##
+# @brief Découpe les messages complets d'un tampon de réception
+# @param buf Tampon (bytearray), non modifié
+# @return (liste de (type, corps), octets consommés)
+def split_msgs(buf):
+    msgs = []
+    pos = 0
+    n = len(buf)
+    while n - pos >= MSG_HDR.size:
+        length, msg_type = MSG_HDR.unpack_from(buf, pos)
+        end = pos + 4 + length
+        if end > n:
+            break
+        msgs.append((msg_type, bytes(buf[pos + MSG_HDR.size:end])))
+        pos = end
+    return msgs, pos
+
+##
+# @brief Découpe une adresse "fleet://HÔTE:PORT/NOM"
+# @return (hôte, port, nom)
+def parse_fleet_url(url):
+    rest = url[len(FLEET_SCHEME):]
+    addr, _, name = rest.partition('/')
+    host, _, port = addr.rpartition(':')
+    return host or FLEET_HOST, int(port) if port else FLEET_PORT, name
+
+##
+# @class FleetLink
+# @brief Lien d'un véhicule servi par le démon, vu comme un port série
+class FleetLink:
+    ##
+    # @param url Adresse "fleet://HÔTE:PORT/NOM"
+    def __init__(self, url):
+        self.port = url
+        host, port, self.name = parse_fleet_url(url)
+        self.sock = socket.create_connection((host, port), timeout=FLEET_REPLY_TIMEOUT_S)
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.buf = bytearray()
+        self.pending = []
+        self.is_open = True
+
+        links = self.request({"op": "links"})['links']
+        match = [l for l in links if l['name'] == self.name]
+        if not match:
+            self.close()
+            raise ValueError(f"lien inconnu du démon : {self.name}")
+        self.index = match[0]['index']
+        self._baud = match[0]['baud']
+        self.request({"op": "sub", "links": [self.index]})
+        self.sock.settimeout(0.1)
+
+    ##
+    # @brief Liste les liens d'un démon
+    # @return Adresses "fleet://HÔTE:PORT/NOM" (liste vide si le démon ne répond pas)
+    @staticmethod
+    def list_links(host=FLEET_HOST, port=FLEET_PORT):
+        try:
+            with socket.create_connection((host, port), timeout=0.5) as s:
+                s.sendall(pack_json({"op": "links"}))
+                buf = bytearray()
+                while True:
+                    data = s.recv(4096)
+                    if not data:
+                        return []
+                    buf += data
+                    msgs, _ = split_msgs(buf)
+                    for msg_type, body in msgs:
+                        if msg_type == MSG_JSON:
+                            reply = json.loads(body)
+                            if 'links' in reply:
+                                return [f"{FLEET_SCHEME}{host}:{port}/{l['name']}" for l in reply['links']]
+        except (OSError, ValueError):
+            return []
+
+    ##
+    # @brief Envoie une requête JSON et attend la réponse (les trames reçues entre-temps sont gardées)
+    # @param obj Requête {"op": ...}
+    # @return Réponse décodée
+    def request(self, obj):
+        self.sock.sendall(pack_json(obj))
+        while True:
+            for msg_type, body in self._recv():
+                if msg_type == MSG_JSON:
+                    reply = json.loads(body)
+                    if reply.get('op') == obj['op']:
+                        if 'error' in reply:
+                            raise ValueError(reply['error'])
+                        return reply
+                elif msg_type == MSG_FRAME:
+                    self.pending.append(body)
+
+    ##
+    # @brief Reçoit ce qui est disponible et découpe les messages complets
+    def _recv(self):
+        data = self.sock.recv(65536)
+        if not data:
+            self.is_open = False
+            raise OSError("démon de flotte déconnecté")
+        self.buf += data
+        msgs, used = split_msgs(self.buf)
+        del self.buf[:used]
+        return msgs
+
+    ##
+    # @brief Trames reçues pour ce lien (attente bornée par le délai de la socket)
+    # @return Liste de (nature, trame)
+    def read_frames(self):
+        out = [(b[1], b[FRAME_HDR.size:]) for b in self.pending]
+        self.pending = []
+        try:
+            msgs = self._recv()
+        except socket.timeout:
+            return out
+        for msg_type, body in msgs:
+            if msg_type == MSG_FRAME and body[0] == self.index:
+                out.append((body[1], body[FRAME_HDR.size:]))
+        return out
+
+    ##
+    # @brief Émet des octets sur le port série du véhicule
+    def write(self, data):
+        self.sock.sendall(pack_msg(MSG_WRITE, bytes([self.index]) + bytes(data)))
+        return len(data)
+
+    def flush(self):
+        pass
+
+    @property
+    def baudrate(self):
+        return self._baud
+
+    ##
+    # @brief Change le débit du port côté démon (après la commande REG_BAUD envoyée par l'appelant)
+    @baudrate.setter
+    def baudrate(self, baud):
+        self.sock.sendall(pack_json({"op": "baud", "link": self.index, "baud": baud}))
+        self._baud = baud
+
+    def close(self):
+        self.is_open = False
+        try:
+            self.sock.close()
+        except OSError:
+            pass
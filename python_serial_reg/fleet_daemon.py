@@ -0,0 +1,279 @@
+##
+# @file fleet_daemon.py
+# @brief Démon sans interface gérant plusieurs véhicules en parallèle
+# @date 2025
+#
+# Une seule boucle asyncio sert N ports série et M clients TCP locaux. Chaque lien a sa
+# propre chaîne de découpage (détection COBS, flux enveloppé annoncé par les capacités,
+# CRC) : un véhicule bavard ou débranché ne ralentit pas les autres. Les lectures sont
+# pilotées par la boucle (add_reader sur le descripteur du port, POSIX), sans thread par
+# port. Un port qui disparaît est rouvert toutes les FLEET_REOPEN_S secondes.
+#
+# Les clients (format des messages : fleet_client.py) reçoivent les trames validées des
+# liens auxquels ils sont abonnés (tous par défaut) et émettent des octets bruts vers un
+# lien. Un client trop lent perd des trames (comptées) au lieu de retenir la boucle.
+# Requêtes JSON :
+#   {"op": "links"}                         -> liens, état et compteurs
+#   {"op": "sub", "links": [i, ...] | null} -> abonnement (null : tous)
+#   {"op": "baud", "link": i, "baud": b}    -> débit du port (après REG_BAUD)
+# Événements JSON : {"op": "link", "index": i, "up": bool} à l'ouverture / la perte d'un port.
+#
+# Usage : python fleet_daemon.py NOM=PORT [NOM=PORT ...] [--baud 115200] [--listen 127.0.0.1:5760]
+#
+
+import argparse
+import asyncio
+import json
+import sys
+import time
+
+import serial
+
+from fleet_client import (FLEET_HOST, FLEET_PORT, FRAME_HDR, MSG_FRAME, MSG_JSON, MSG_WRITE,
+                          pack_json, pack_msg, split_msgs)
+from serial_reg import (BAUD_RATES, CAPS_LINK_COBS, CAPS_LINK_ENVELOPE, FRAME_IMU, REG_CAPS,
+                        TELEM_TYPE_CAPS, build_frame, decode_caps, probe_cobs, split_cobs,
+                        split_envelopes, split_frames)
+
+## @brief Délai entre deux tentatives d'ouverture d'un port perdu (s)
+FLEET_REOPEN_S = 1.0
+## @brief Octets en attente d'émission vers un client au-delà desquels ses trames sont jetées
+FLEET_CLIENT_BACKLOG = 1 << 20
+
+##
+# @class Link
+# @brief Un véhicule : port série et chaîne de découpage propre
+class Link:
+    def __init__(self, daemon, index, name, port, baud):
+        self.daemon = daemon
+        self.index = index
+        self.name = name
+        self.port = port
+        self.baud = baud
+        self.ser = None
+        self.buf = bytearray()
+        self.caps = None
+        self.cobs = False
+        self.envelope = False
+        self.frames = 0
+        self.rx_bytes = 0
+        self.tx_bytes = 0
+
+    ##
+    # @brief Ouvre le port et l'inscrit dans la boucle ; demande les capacités du firmware
+    # @return True si le port est ouvert
+    def open(self):
+        try:
+            self.ser = serial.Serial(self.port, self.baud, timeout=0)
+        except (OSError, serial.SerialException):
+            self.ser = None
+            return False
+        self.buf.clear()
+        self.caps = None
+        self.cobs = False
+        self.envelope = False
+        self.daemon.loop.add_reader(self.ser.fileno(), self._on_readable)
+        self.write(build_frame(REG_CAPS, 0, 0))
+        self.daemon.broadcast_json({"op": "link", "index": self.index, "up": True})
+        return True
+
+    ##
+    # @brief Retire le port de la boucle et le ferme
+    def close(self):
+        if self.ser is None:
+            return
+        self.daemon.loop.remove_reader(self.ser.fileno())
+        try:
+            self.ser.close()
+        except (OSError, serial.SerialException):
+            pass
+        self.ser = None
+        self.daemon.broadcast_json({"op": "link", "index": self.index, "up": False})
+
+    ##
+    # @brief Lecture non bloquante de tout ce qui est arrivé, puis découpage
+    def _on_readable(self):
+        try:
+            data = self.ser.read(max(1, self.ser.in_waiting))
+        except (OSError, serial.SerialException):
+            self.close()
+            return
+        if not data:
+            return
+        self.rx_bytes += len(data)
+        buf = self.buf
+        buf.extend(data)
+        if not self.cobs and self.caps is None and 0 in data and probe_cobs(buf):
+            self.cobs = True
+        if self.cobs:
+            used = split_cobs(buf, self._emit)
+        else:
+            used = (split_envelopes if self.envelope else split_frames)(buf, self._emit)
+        if used:
+            del buf[:used]
+
+    ##
+    # @brief Trame validée : suivi des capacités puis diffusion aux abonnés
+    def _emit(self, kind, packet):
+        self.frames += 1
+        if kind == FRAME_IMU and packet[2] == TELEM_TYPE_CAPS:
+            self.caps = decode_caps(packet)
+            self.envelope = bool(self.caps['link'] & CAPS_LINK_ENVELOPE)
+            self.cobs = bool(self.caps['link'] & CAPS_LINK_COBS)
+        self.daemon.broadcast_frame(self.index, kind, packet)
+
+    ##
+    # @brief Émet des octets vers le véhicule (ignoré si le port est fermé)
+    def write(self, data):
+        if self.ser is None:
+            return
+        try:
+            self.ser.write(data)
+            self.tx_bytes += len(data)
+        except (OSError, serial.SerialException):
+            self.close()
+
+    ##
+    # @brief Applique un nouveau débit au port ; le tampon de découpage repart à vide
+    def set_baud(self, baud):
+        self.baud = baud
+        self.buf.clear()
+        if self.ser is not None:
+            self.ser.baudrate = baud
+
+    ##
+    # @brief État et compteurs du lien
+    def info(self):
+        return {"index": self.index, "name": self.name, "port": self.port, "baud": self.baud,
+                "up": self.ser is not None, "frames": self.frames,
+                "rx_bytes": self.rx_bytes, "tx_bytes": self.tx_bytes,
+                "version": self.caps['version'] if self.caps else None}
+
+##
+# @class Client
+# @brief Client TCP local et son abonnement
+class Client:
+    def __init__(self, writer):
+        self.writer = writer
+        self.subs = None
+        self.dropped = 0
+
+    ##
+    # @brief Met un message en file d'émission (jeté si le client ne suit pas)
+    # @param msg Message complet
+    # @param droppable True pour une trame (jetable), False pour une réponse
+    def send(self, msg, droppable=True):
+        if droppable and self.writer.transport.get_write_buffer_size() > FLEET_CLIENT_BACKLOG:
+            self.dropped += 1
+            return
+        self.writer.write(msg)
+
+##
+# @class FleetDaemon
+# @brief Boucle de service : liens série, clients et reprise des ports perdus
+class FleetDaemon:
+    def __init__(self, specs, baud):
+        self.loop = None
+        self.links = [Link(self, i, name, port, baud) for i, (name, port) in enumerate(specs)]
+        self.clients = set()
+
+    ##
+    # @brief Diffuse une trame aux clients abonnés à son lien
+    def broadcast_frame(self, index, kind, packet):
+        if not self.clients:
+            return
+        msg = pack_msg(MSG_FRAME, FRAME_HDR.pack(index, kind, time.time_ns()) + packet)
+        for c in self.clients:
+            if c.subs is None or index in c.subs:
+                c.send(msg)
+
+    ##
+    # @brief Diffuse un événement JSON à tous les clients
+    def broadcast_json(self, obj):
+        msg = pack_json(obj)
+        for c in self.clients:
+            c.send(msg, droppable=False)
+
+    ##
+    # @brief Traite une requête JSON d'un client
+    def _request(self, client, req):
+        op = req.get('op')
+        reply = {"op": op}
+        if op == 'links':
+            reply['links'] = [l.info() for l in self.links]
+        elif op == 'sub':
+            subs = req.get('links')
+            client.subs = None if subs is None else set(subs)
+        elif op == 'baud':
+            i, baud = req.get('link'), req.get('baud')
+            if not (isinstance(i, int) and 0 <= i < len(self.links)) or baud not in BAUD_RATES:
+                reply['error'] = "lien ou débit invalide"
+            else:
+                self.links[i].set_baud(baud)
+        else:
+            reply['error'] = f"requête inconnue : {op}"
+        client.send(pack_json(reply), droppable=False)
+
+    ##
+    # @brief Session d'un client : découpe ses messages jusqu'à la déconnexion
+    async def _serve(self, reader, writer):
+        client = Client(writer)
+        self.clients.add(client)
+        buf = bytearray()
+        try:
+            while True:
+                data = await reader.read(65536)
+                if not data:
+                    break
+                buf += data
+                msgs, used = split_msgs(buf)
+                del buf[:used]
+                for msg_type, body in msgs:
+                    if msg_type == MSG_WRITE and body and body[0] < len(self.links):
+                        self.links[body[0]].write(body[1:])
+                    elif msg_type == MSG_JSON:
+                        try:
+                            self._request(client, json.loads(body))
+                        except ValueError:
+                            client.send(pack_json({"op": None, "error": "JSON invalide"}), droppable=False)
+        except ConnectionError:
+            pass
+        finally:
+            self.clients.discard(client)
+            writer.close()
+
+    ##
+    # @brief Rouvre périodiquement les ports fermés (absents au démarrage ou débranchés)
+    async def _reopen(self):
+        while True:
+            for link in self.links:
+                if link.ser is None and link.open():
+                    print(f"{link.name} : {link.port} ouvert", flush=True)
+            await asyncio.sleep(FLEET_REOPEN_S)
+
+    async def run(self, host, port):
+        self.loop = asyncio.get_running_loop()
+        server = await asyncio.start_server(self._serve, host, port)
+        print(f"démon de flotte : {len(self.links)} liens, écoute sur {host}:{port}", flush=True)
+        async with server:
+            await asyncio.gather(server.serve_forever(), self._reopen())
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Démon de flotte : plusieurs véhicules, clients TCP locaux")
+    parser.add_argument("links", nargs='+', metavar="NOM=PORT", help="lien nommé, ex. car1=/dev/ttyACM0")
+    parser.add_argument("--baud", type=int, default=BAUD_RATES[0], choices=BAUD_RATES)
+    parser.add_argument("--listen", default=f"{FLEET_HOST}:{FLEET_PORT}", metavar="HÔTE:PORT")
+    args = parser.parse_args()
+
+    specs = []
+    for spec in args.links:
+        name, sep, port = spec.partition('=')
+        if not sep or not name or not port:
+            parser.error(f"lien invalide : {spec}")
+        specs.append((name, port))
+    host, _, port = args.listen.rpartition(':')
+
+    try:
+        asyncio.run(FleetDaemon(specs, args.baud).run(host or FLEET_HOST, int(port)))
+    except KeyboardInterrupt:
+        sys.exit(0)
@@ -0,0 +1,233 @@
+##
+# @file fw_flash.py
+# @brief Mise à jour du firmware STM32 par la liaison série (REG_FW_UPDATE), sans ST-Link
+# @date 2025
+#
+# Compare le CRC-32 de chaque page en place à la nouvelle image et n'envoie que les pages
+# modifiées, compressées en PackBits. Avec --base (image actuellement flashée), une page
+# dont le CRC en place correspond à la base part en delta (XOR avec la base), presque
+# entièrement nul pour une modification locale. Le firmware prépare les pages dans sa
+# banque 2 puis les recopie d'un bloc à la validation et redémarre (cf. fw_update.h).
+#
+# Usage : python fw_flash.py PORT firmware.bin [--base ancien.bin] [--baud 921600] [--dry-run]
+#
+
+import argparse
+import queue
+import sys
+import threading
+import time
+import zlib
+
+import serial
+
+from latency_bench import set_baud
+from serial_reg import (BAUD_RATES, FRAME_IMU, REG_FW_UPDATE, TELEM_TYPE_FW,
+                        build_burst_frame, build_frame, decode_fw, split_frames)
+
+## @brief Registres par trame groupée (PROTO_BURST_MAX_REGS)
+BURST_MAX_REGS = 8
+## @brief Taille d'une page de flash (octets)
+FW_PAGE_SIZE = 2048
+## @brief Opcodes de REG_FW_UPDATE (fw_update.h)
+FW_OP_ABORT, FW_OP_BEGIN, FW_OP_QUERY, FW_OP_PAGE, FW_OP_COMMIT = range(5)
+FW_OP_SHIFT = 12
+## @brief Statuts d'acquittement (fw_update.h)
+FW_STATUS = ("ok", "occupé (véhicule en mouvement ?)", "hors séquence", "hors plage",
+             "flux mal formé", "CRC incorrect", "échec flash")
+FW_ST_OK = 0
+## @brief Drapeau de page : flux à combiner (XOR) avec la page en place
+FW_PAGE_F_XOR = 0x01
+## @brief Plus courte répétition codée par PackBits
+FW_RUN_MIN = 3
+## @brief Délai d'acquittement (s) : une page préparée demande un effacement et une programmation
+ACK_TIMEOUT_S = 1.0
+## @brief Essais par page avant abandon
+PAGE_RETRIES = 3
+
+##
+# @brief Compresse un bloc en PackBits (format décodé par fw_update.c)
+# @param data Octets à coder
+# @return Flux codé : c < 0x80 -> c + 1 littéraux ; c >= 0x80 -> octet suivant répété (c & 0x7F) + 3 fois
+def packbits(data):
+    out = bytearray()
+    lit = 0
+    i = 0
+
+    def flush(end):
+        for s in range(lit, end, 128):
+            chunk = data[s:min(end, s + 128)]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and run < 0x7F + FW_RUN_MIN and data[i + run] == data[i]:
+            run += 1
+        if run >= FW_RUN_MIN:
+            flush(i)
+            out.append(0x80 | (run - FW_RUN_MIN))
+            out.append(data[i])
+            lit = i + run
+        i += run
+    flush(len(data))
+    return bytes(out)
+
+##
+# @brief Construit le flux d'une page : en-tête (drapeaux, réservé, CRC-32) puis PackBits
+# @param page Contenu final de la page
+# @param base Contenu en place connu (delta XOR), ou None
+# @return Flux prêt à découper en trames groupées
+def page_stream(page, base):
+    flags = 0
+    body = packbits(page)
+    if base is not None:
+        delta = packbits(bytes(a ^ b for a, b in zip(page, base)))
+        if len(delta) < len(body):
+            flags, body = FW_PAGE_F_XOR, delta
+    crc = zlib.crc32(page)
+    return bytes([flags, 0]) + crc.to_bytes(4, 'little') + body
+
+##
+# @brief Découpe un flux en trames groupées adressées à REG_FW_UPDATE (bourrage final à 0)
+def stream_frames(stream):
+    if len(stream) & 1:
+        stream += b'\x00'
+    values = [stream[i] | (stream[i + 1] << 8) for i in range(0, len(stream), 2)]
+    return [build_burst_frame(REG_FW_UPDATE, values[i:i + BURST_MAX_REGS])
+            for i in range(0, len(values), BURST_MAX_REGS)]
+
+##
+# @brief Thread de lecture : remet les acquittements de mise à jour à une file
+def reader(ser, acks, stop):
+    buf = bytearray()
+
+    def emit(kind, packet):
+        if kind == FRAME_IMU and packet[2] == TELEM_TYPE_FW:
+            acks.put(decode_fw(packet))
+
+    while not stop.is_set():
+        data = ser.read(max(1, ser.in_waiting))
+        if not data:
+            continue
+        buf.extend(data)
+        used = split_frames(buf, emit)
+        if used:
+            del buf[:used]
+
+class FwLink:
+    ##
+    # @brief Liaison de mise à jour : commandes REG_FW_UPDATE et attente des acquittements
+    def __init__(self, ser, acks):
+        self.ser = ser
+        self.acks = acks
+
+    ##
+    # @brief Envoie une commande (et les trames qui la suivent) puis attend son acquittement
+    # @return (opcode, statut, argument, pages préparées, CRC) ou None si délai dépassé
+    def command(self, op, arg=0, frames=()):
+        value = (op << FW_OP_SHIFT) | arg
+        while not self.acks.empty():
+            self.acks.get_nowait()
+        self.ser.write(build_frame(REG_FW_UPDATE & 0x7F, value & 0xFF, value >> 8))
+        for frame in frames:
+            self.ser.write(frame)
+        deadline = time.monotonic() + ACK_TIMEOUT_S
+        while True:
+            try:
+                ack = self.acks.get(timeout=max(0.0, deadline - time.monotonic()))
+            except queue.Empty:
+                return None
+            if ack[0] == op and (op == FW_OP_BEGIN or ack[2] == arg):   # BEGIN : arg = pages de l'application
+                return ack
+
+def main():
+    parser = argparse.ArgumentParser(description="Mise à jour du firmware par la liaison série")
+    parser.add_argument("port", help="port série (ex. /dev/ttyACM0, COM5)")
+    parser.add_argument("image", help="image binaire (.bin, à partir de 0x08000000)")
+    parser.add_argument("--base", help="image actuellement flashée (pages modifiées envoyées en delta)")
+    parser.add_argument("--baud", type=int, default=BAUD_RATES[0], choices=BAUD_RATES, help="débit négocié avant l'envoi")
+    parser.add_argument("--dry-run", action="store_true", help="compare et prépare sans valider")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as f:
+        image = f.read()
+    image += b'\xff' * (-len(image) % FW_PAGE_SIZE)
+    base = b''
+    if args.base:
+        with open(args.base, "rb") as f:
+            base = f.read()
+        base += b'\xff' * (-len(base) % FW_PAGE_SIZE)
+
+    ser = serial.Serial(args.port, BAUD_RATES[0], timeout=0.05)
+    if args.baud != BAUD_RATES[0]:
+        set_baud(ser, args.baud)
+
+    acks = queue.Queue()
+    stop = threading.Event()
+    thread = threading.Thread(target=reader, args=(ser, acks, stop), daemon=True)
+    thread.start()
+    link = FwLink(ser, acks)
+
+    try:
+        ack = link.command(FW_OP_BEGIN)
+        if ack is None or ack[1] != FW_ST_OK:
+            print("session refusée :", "pas de réponse" if ack is None else FW_STATUS[ack[1]])
+            return 1
+        app_pages = ack[2]
+        pages = len(image) // FW_PAGE_SIZE
+        if pages > app_pages:
+            print(f"image trop grande : {pages} pages, {app_pages} disponibles")
+            link.command(FW_OP_ABORT)
+            return 1
+
+        t0 = time.monotonic()
+        sent = 0
+        staged = 0
+        for p in range(pages):
+            page = image[p * FW_PAGE_SIZE:(p + 1) * FW_PAGE_SIZE]
+            ack = link.command(FW_OP_QUERY, p)
+            if ack is None or ack[1] != FW_ST_OK:
+                print(f"page {p} : lecture du CRC impossible")
+                link.command(FW_OP_ABORT)
+                return 1
+            if ack[4] == zlib.crc32(page):
+                continue
+
+            known = base[p * FW_PAGE_SIZE:(p + 1) * FW_PAGE_SIZE]
+            frames = stream_frames(page_stream(page, known if known and zlib.crc32(known) == ack[4] else None))
+            for _ in range(PAGE_RETRIES):
+                ack = link.command(FW_OP_PAGE, p, frames)
+                if ack is not None and ack[1] == FW_ST_OK:
+                    break
+            if ack is None or ack[1] != FW_ST_OK:
+                print(f"page {p} refusée :", "pas de réponse" if ack is None else FW_STATUS[ack[1]])
+                link.command(FW_OP_ABORT)
+                return 1
+            staged = ack[3]
+            sent += sum(len(f) for f in frames)
+            print(f"page {p:3d} préparée ({sum(len(f) for f in frames)} octets)")
+
+        dt = time.monotonic() - t0
+        print(f"{staged}/{pages} pages modifiées, {sent} octets émis en {dt:.1f} s")
+        if staged == 0 or args.dry_run:
+            link.command(FW_OP_ABORT)
+            return 0
+
+        ack = link.command(FW_OP_COMMIT, staged)
+        if ack is None or ack[1] != FW_ST_OK:
+            print("validation refusée :", "pas de réponse" if ack is None else FW_STATUS[ack[1]])
+            link.command(FW_OP_ABORT)
+            return 1
+        print("recopie en cours, redémarrage du STM32")
+        return 0
+    except KeyboardInterrupt:
+        link.command(FW_OP_ABORT)
+        return 1
+    finally:
+        stop.set()
+        thread.join(timeout=1.0)
+        ser.close()
+
+if __name__ == "__main__":
+    sys.exit(main())
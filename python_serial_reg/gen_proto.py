@@ -0,0 +1,151 @@
+##
+# @file gen_proto.py
+# @brief Génère proto_defs.py à partir de la description du protocole du firmware
+# @date 2025
+#
+# Sources : main_stm32/Core/Inc/proto_def.h (version, types de trame, champs TELEM_F_*,
+# dispositions des trames fixes) et les adresses REG_* de serial_cmd.h. Le module
+# produit contient les constantes et des struct.Struct précompilés : l'hôte ne recopie
+# plus rien à la main et une trame modifiée côté firmware change aussi son décodage.
+# Les tailles déclarées dans PROTO_FIXED_FRAMES et les longueurs de PROTO_TELEM_FIELDS
+# sont vérifiées contre les formats struct ; toute incohérence arrête la génération.
+#
+# Usage : python gen_proto.py [--inc ../main_stm32/Core/Inc] [-o proto_defs.py]
+#
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+## @brief Formats struct des types C autorisés dans les dispositions
+C_TYPES = {
+    'uint8_t': 'B', 'int8_t': 'b',
+    'uint16_t': 'H', 'int16_t': 'h',
+    'uint32_t': 'I', 'int32_t': 'i',
+    'uint64_t': 'Q', 'int64_t': 'q',
+    'float': 'f',
+}
+
+RE_REG = re.compile(r'^#define\s+(REG_\w+)\s+(0x[0-9A-Fa-f]+|\d+)[uU]?\s*(?:$|/)', re.M)
+RE_CONST = re.compile(r'^#define\s+((?:PROTO_VERSION|CAPS)_\w+)\s+(0x[0-9A-Fa-f]+|\d+)[uU]?\s*(?:$|/)', re.M)
+RE_LIST = re.compile(r'^#define\s+(PROTO_\w+)\((?:\w+|F, A)\)\s*\\\n((?:.*\\\n)*.*)$', re.M)
+RE_ENTRY = re.compile(r'\b([XFA])\(([^()]*)\)')
+RE_INCLUDE = re.compile(r'\b(PROTO_HEADER)\(F, A\)')
+
+
+class ProtoError(Exception):
+    pass
+
+
+##
+# @brief Extrait les listes X-macro de proto_def.h
+# @param text Contenu du fichier
+# @return Dictionnaire nom de liste -> [(lettre, [arguments])]
+def parse_lists(text):
+    lists = {}
+    for name, body in RE_LIST.findall(text):
+        body = re.sub(r'/\*.*?\*/', '', body)
+        entries = []
+        for line in body.split('\n'):
+            inc = RE_INCLUDE.search(line)
+            if inc:
+                entries.extend(lists[inc.group(1)])
+                continue
+            for kind, args in RE_ENTRY.findall(line):
+                entries.append((kind, [a.strip() for a in args.split(',')]))
+        lists[name] = entries
+    return lists
+
+
+##
+# @brief Format struct little-endian d'une disposition PROTO_LAYOUT_*
+def layout_format(entries):
+    fmt = '<'
+    for kind, args in entries:
+        if args[0] not in C_TYPES:
+            raise ProtoError(f"type C non géré : {args[0]}")
+        code = C_TYPES[args[0]]
+        fmt += (args[2] + code) if kind == 'A' else code
+    return fmt
+
+
+##
+# @brief Construit le texte du module proto_defs.py
+# @param inc Répertoire Core/Inc du firmware
+def generate(inc):
+    with open(os.path.join(inc, 'proto_def.h'), encoding='utf-8') as f:
+        text = f.read()
+        lists = parse_lists(text)
+        consts = RE_CONST.findall(text)
+    with open(os.path.join(inc, 'serial_cmd.h'), encoding='utf-8') as f:
+        regs = RE_REG.findall(f.read())
+
+    out = ['##',
+           '# @file proto_defs.py',
+           '# @brief Constantes et formats du protocole série (fichier généré par gen_proto.py,',
+           '# ne pas modifier : éditer proto_def.h / serial_cmd.h puis relancer le générateur)',
+           '#',
+           '',
+           'import struct',
+           '',
+           '## @brief Adresses des registres virtuels (serial_cmd.h)']
+    for name, value in regs:
+        out.append(f'{name} = {value}')
+
+    out += ['', '## @brief Version du protocole et bits de la trame de capacités (proto_def.h)']
+    for name, value in consts:
+        out.append(f'{name} = {value}')
+    out.append('PROTO_VERSION = (PROTO_VERSION_MAJOR << 8) | PROTO_VERSION_MINOR')
+
+    out += ['', '## @brief Types de trame (PROTO_FRAME_TYPES)']
+    for _, (name, code) in lists['PROTO_FRAME_TYPES']:
+        out.append(f'TELEM_TYPE_{name} = {code}')
+
+    out += ['', '## @brief Champs de la trame type 0x03 (PROTO_TELEM_FIELDS) : bit, longueur, format']
+    fields = []
+    total = 0
+    for _, (name, bit, length, fmt) in lists['PROTO_TELEM_FIELDS']:
+        fmt = fmt.strip('"')
+        if struct.calcsize('<' + fmt) != int(length):
+            raise ProtoError(f"TELEM_F_{name} : format {fmt} ne fait pas {length} octets")
+        out.append(f'TELEM_F_{name} = {bit}')
+        fields.append(f"    (TELEM_F_{name}, struct.Struct('<{fmt}')),")
+        total += int(length)
+    out.append('TELEM_F_ALL = 0xFF')
+    out.append('## @brief Champs présents dans l\'ordre d\'émission, décodeur de chaque champ')
+    out.append('TELEM_FIELDS = [')
+    out += fields
+    out.append(']')
+    out.append(f'TELEM_FRAME_MAX_LEN = {4 + 2 + 4 + 1 + total + 1}')
+
+    out += ['', '## @brief Trames fixes (PROTO_FIXED_FRAMES) : décodeurs de la trame complète']
+    for _, (cname, layout, size) in lists['PROTO_FIXED_FRAMES']:
+        fmt = layout_format(lists[f'PROTO_LAYOUT_{layout}'])
+        if struct.calcsize(fmt) != int(size):
+            raise ProtoError(f"{cname} : format {fmt} ne fait pas {size} octets")
+        out.append(f"FRAME_{layout} = struct.Struct('{fmt}')  # {cname}, TELEM_TYPE_{layout}")
+    out.append('')
+    return '\n'.join(out)
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description="Génère proto_defs.py depuis proto_def.h et serial_cmd.h")
+    parser.add_argument('--inc', default=os.path.join(here, '..', 'main_stm32', 'Core', 'Inc'),
+                        help="Répertoire des en-têtes du firmware")
+    parser.add_argument('-o', '--output', default=os.path.join(here, 'proto_defs.py'))
+    args = parser.parse_args()
+    try:
+        text = generate(args.inc)
+    except (ProtoError, KeyError, OSError) as e:
+        print(f"gen_proto : {e}", file=sys.stderr)
+        return 1
+    with open(args.output, 'w', encoding='utf-8', newline='\n') as f:
+        f.write(text)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
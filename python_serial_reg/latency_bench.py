@@ -0,0 +1,136 @@
+##
+# @file latency_bench.py
+# @brief Banc de latence aller-retour hôte <-> STM32 par écho (REG_PING)
+# @date 2025
+#
+# Chaque écho est daté côté firmware (arrivée des octets, mise en file, boucle
+# principale, remise au TX) et côté hôte (émission, réception) ; les horloges ne sont
+# pas comparées entre elles, seules des durées le sont. La part "liaison" est
+# l'aller-retour hôte moins le temps passé dans le firmware : écriture hôte, USB-VCP,
+# UART dans les deux sens et DMA TX.
+#
+# Usage : python latency_bench.py PORT [-n 5000] [--baud 921600] [--interval 0]
+#
+
+import argparse
+import queue
+import sys
+import threading
+import time
+
+import serial
+
+from serial_reg import (BAUD_RATES, FRAME_IMU, REG_BAUD, REG_PING, TELEM_TYPE_ECHO,
+                        build_frame, decode_echo, split_frames)
+
+## @brief Délai maximal d'attente d'un écho (s) avant de le compter perdu
+ECHO_TIMEOUT_S = 0.25
+## @brief Centiles rapportés pour chaque étape
+PERCENTILES = [50, 90, 99, 99.9]
+
+##
+# @brief Centile d'une liste triée (plus proche rang)
+# @param values Valeurs triées
+# @param p Centile (0..100)
+def percentile(values, p):
+    if not values:
+        return 0.0
+    k = min(len(values) - 1, max(0, int(round(p / 100.0 * len(values) + 0.5)) - 1))
+    return values[k]
+
+##
+# @brief Thread de lecture : remet les trames d'écho (jeton, dates, instant hôte) à une file
+def reader(ser, echoes, stop):
+    buf = bytearray()
+
+    def emit(kind, packet):
+        if kind == FRAME_IMU and packet[2] == TELEM_TYPE_ECHO:
+            echoes.put((time.perf_counter_ns(), decode_echo(packet)))
+
+    while not stop.is_set():
+        data = ser.read(max(1, ser.in_waiting))
+        if not data:
+            continue
+        buf.extend(data)
+        used = split_frames(buf, emit)
+        if used:
+            del buf[:used]
+
+##
+# @brief Négocie un débit avec le STM32 (même séquence que l'interface graphique)
+def set_baud(ser, baud):
+    code = BAUD_RATES.index(baud)
+    ser.write(build_frame(REG_BAUD & 0x7F, code, 0))
+    ser.flush()
+    time.sleep(0.05)
+    ser.baudrate = baud
+    time.sleep(0.01)
+    ser.write(build_frame(0x80 | REG_BAUD, 1, 0))
+    time.sleep(0.05)
+    ser.reset_input_buffer()
+
+def main():
+    parser = argparse.ArgumentParser(description="Banc de latence par écho REG_PING")
+    parser.add_argument("port", help="port série (ex. /dev/ttyACM0, COM5)")
+    parser.add_argument("-n", "--count", type=int, default=5000, help="nombre d'échos")
+    parser.add_argument("--baud", type=int, default=BAUD_RATES[0], choices=BAUD_RATES, help="débit négocié avant la mesure")
+    parser.add_argument("--interval", type=float, default=0.0, help="pause entre deux échos (ms)")
+    args = parser.parse_args()
+
+    ser = serial.Serial(args.port, BAUD_RATES[0], timeout=0.05)
+    if args.baud != BAUD_RATES[0]:
+        set_baud(ser, args.baud)
+
+    echoes = queue.Queue()
+    stop = threading.Event()
+    thread = threading.Thread(target=reader, args=(ser, echoes, stop), daemon=True)
+    thread.start()
+
+    stages = {"parser": [], "boucle": [], "tx": [], "firmware": [], "liaison": [], "aller-retour": []}
+    lost = 0
+    try:
+        for i in range(args.count):
+            token = i & 0x7FFF
+            frame = build_frame(REG_PING & 0x7F, token & 0xFF, token >> 8)
+            t_send = time.perf_counter_ns()
+            ser.write(frame)
+            deadline = t_send + int(ECHO_TIMEOUT_S * 1e9)
+            while True:
+                try:
+                    t_recv, (echo_token, t_rx, t_parse, t_app, t_tx) = echoes.get(timeout=ECHO_TIMEOUT_S)
+                except queue.Empty:
+                    lost += 1
+                    break
+                if echo_token == token:
+                    rtt_us = (t_recv - t_send) / 1000.0
+                    fw_us = (t_tx - t_rx) & 0xFFFFFFFF
+                    stages["parser"].append((t_parse - t_rx) & 0xFFFFFFFF)
+                    stages["boucle"].append((t_app - t_parse) & 0xFFFFFFFF)
+                    stages["tx"].append((t_tx - t_app) & 0xFFFFFFFF)
+                    stages["firmware"].append(fw_us)
+                    stages["liaison"].append(rtt_us - fw_us)
+                    stages["aller-retour"].append(rtt_us)
+                    break
+                if t_recv > deadline:
+                    lost += 1
+                    break
+            if args.interval > 0:
+                time.sleep(args.interval / 1000.0)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        stop.set()
+        thread.join(timeout=1.0)
+        ser.close()
+
+    done = len(stages["aller-retour"])
+    print(f"{done} échos à {args.baud} bauds, {lost} perdus")
+    print(f"{'étape (µs)':<14}" + "".join(f"{'p' + str(p):>10}" for p in PERCENTILES) + f"{'max':>10}")
+    for name, values in stages.items():
+        values.sort()
+        cols = "".join(f"{percentile(values, p):>10.0f}" for p in PERCENTILES)
+        print(f"{name:<14}{cols}{(values[-1] if values else 0):>10.0f}")
+    return 0 if done else 1
+
+if __name__ == "__main__":
+    sys.exit(main())
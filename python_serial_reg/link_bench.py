@@ -0,0 +1,350 @@
+##
+# @file link_bench.py
+# @brief Banc de débit de bout en bout de la liaison, par mode (débit série, cadence, format, lots)
+# @date 2025
+#
+# Le firmware passe en source synthétique (REG_REPLAY = REPLAY_CMD_SYNTH, replay.h) : la
+# tâche IMU publie à sa cadence des échantillons datés sur une grille exacte, qui suivent
+# tout le chemin de la télémétrie (décimation, format, lots, buffer TX). Pour chaque mode,
+# le script mesure :
+# - les échantillons reçus par seconde et les octets reçus (part du débit série) ;
+# - les pertes, comptées sur la grille de dates (indépendantes du format et des lots) ;
+# - la latence échantillon -> hôte (centiles), date firmware convertie en date hôte par
+#   ClockSync à partir d'échos REG_PING intercalés ;
+# - la charge CPU de l'hôte (temps processeur du processus / durée).
+#
+# La régulation de débit (REG_TELEM_ADAPT) et la mise en veille (REG_IDLE_RATE) sont
+# coupées pendant la mesure : une saturation apparaît en pertes au lieu d'être absorbée.
+# Les registres modifiés sont relus avant et restaurés après le banc. COBS et enveloppe
+# sont des options de build : le rapport les relève dans la trame de capacités.
+#
+# Le rapport JSON (--out) porte les capacités du firmware ; --compare affiche l'écart
+# avec un rapport précédent (même mode), pour suivre les versions successives.
+#
+# Usage : python link_bench.py PORT [--modes 921600:1000:compact:12:10 ...] [--duration 5]
+#                              [--out rapport.json] [--compare precedent.json]
+#
+
+import argparse
+import json
+import queue
+import struct
+import sys
+import threading
+import time
+
+import serial
+
+from clock_sync import ClockSync, Unwrap32
+from latency_bench import ECHO_TIMEOUT_S, PERCENTILES, percentile, set_baud
+from serial_reg import (BAUD_RATES, FRAME_BURST, FRAME_IMU, REG_CAPS, REG_IDLE_RATE, REG_IMU_RATE, REG_PING,
+                        REG_REPLAY, REG_TELEM_ADAPT, REG_TELEM_BATCH, REG_TELEM_FORMAT, REG_TELEM_RATE,
+                        REPLAY_CMD_STOP, REPLAY_CMD_SYNTH, TELEM_TYPE_CAPS, TELEM_TYPE_COMPACT, TELEM_TYPE_DELTA,
+                        TELEM_TYPE_ECHO, TELEM_TYPE_FIELDS, TELEM_TYPE_FX, TELEM_TYPE_LEGACY, TELEM_TYPE_REG,
+                        build_frame, decode_caps, decode_echo, imu_samples, split_frames)
+
+## @brief Formats du flux rapide (TELEM_FMT_*, REG_TELEM_FORMAT)
+BENCH_FORMATS = {"legacy": 0, "compact": 1}
+## @brief Modes balayés par défaut : (débit, cadence Hz, format, taille de lot, latence de lot ms)
+BENCH_MODES = [(baud, rate, fmt, batch, lat)
+               for baud in BAUD_RATES[1:]
+               for rate in (100, 500, 1000)
+               for fmt, batch, lat in (("legacy", 1, 0), ("compact", 1, 0), ("compact", 12, 10))]
+## @brief Durée de mesure par mode (s)
+BENCH_DURATION_S = 5.0
+## @brief Mise en régime avant la mesure (s) : premiers échantillons et lots ignorés
+BENCH_WARMUP_S = 0.5
+## @brief Attente de vidage après l'arrêt de la source (s)
+BENCH_DRAIN_S = 0.3
+## @brief Période des échos de synchronisation d'horloge pendant la mesure (s)
+BENCH_PING_S = 0.05
+## @brief Registres sauvegardés puis restaurés : (premier registre, nombre)
+BENCH_SAVED = [(REG_TELEM_RATE, 4), (REG_IDLE_RATE, 1), (REG_TELEM_ADAPT, 1), (REG_IMU_RATE, 1)]
+## @brief Types de trame portant des échantillons
+TELEM_TYPES = (TELEM_TYPE_LEGACY, TELEM_TYPE_FX, TELEM_TYPE_FIELDS, TELEM_TYPE_COMPACT, TELEM_TYPE_DELTA)
+## @brief Grandeurs comparées entre deux rapports : (clé, format, sens favorable)
+COMPARE_KEYS = [("samples_s", ".0f", +1), ("loss_pct", ".3f", -1), ("lat_p50_ms", ".2f", -1),
+                ("lat_p99_ms", ".2f", -1), ("cpu_pct", ".1f", -1)]
+
+##
+# @class BenchLink
+# @brief Réception du banc : échantillons datés, échos, réponses de registres et capacités
+class BenchLink:
+    def __init__(self, ser):
+        self.ser = ser
+        self.lock = threading.Lock()
+        self.samples = []           # (arrivée hôte ns, date firmware µs 32 bits)
+        self.rx_bytes = 0
+        self.echoes = queue.Queue()
+        self.replies = queue.Queue()
+        self.caps = queue.Queue()
+        self.stop = threading.Event()
+        self.thread = threading.Thread(target=self._run, daemon=True)
+        self.thread.start()
+
+    def _run(self):
+        buf = bytearray()
+        while not self.stop.is_set():
+            data = self.ser.read(max(1, self.ser.in_waiting))
+            if not data:
+                continue
+            now = time.perf_counter_ns()
+            buf.extend(data)
+            frames = []
+            used = split_frames(buf, lambda k, p: frames.append((k, p)))
+            if used:
+                del buf[:used]
+            with self.lock:
+                self.rx_bytes += len(data)
+                for kind, packet in frames:
+                    self._frame(now, kind, packet)
+
+    def _frame(self, now, kind, packet):
+        if kind == FRAME_BURST:
+            self._reply(packet)
+            return
+        if kind != FRAME_IMU:
+            return
+        ftype = packet[2]
+        if ftype in TELEM_TYPES:
+            self.samples.extend((now, ts) for ts, _ in imu_samples(packet))
+        elif ftype == TELEM_TYPE_ECHO:
+            self.echoes.put((now, decode_echo(packet)))
+        elif ftype == TELEM_TYPE_REG:
+            self._reply(packet[4:])
+        elif ftype == TELEM_TYPE_CAPS:
+            self.caps.put(decode_caps(packet))
+
+    def _reply(self, packet):
+        count = packet[1]
+        if len(packet) >= 2 + 2 * count:
+            self.replies.put((packet[0] & 0x7F, struct.unpack_from(f'<{count}h', packet, 2)))
+
+    ##
+    # @brief Vide et renvoie les échantillons et octets reçus depuis le dernier appel
+    def take(self):
+        with self.lock:
+            samples, self.samples = self.samples, []
+            rx_bytes, self.rx_bytes = self.rx_bytes, 0
+        return samples, rx_bytes
+
+    def write_reg(self, addr, value):
+        self.ser.write(build_frame(addr & 0x7F, value & 0xFF, (value >> 8) & 0xFF))
+
+    ##
+    # @brief Lecture groupée de registres consécutifs
+    # @return Valeurs (int16) ou None si pas de réponse
+    def read_regs(self, addr, count):
+        while not self.replies.empty():
+            self.replies.get_nowait()
+        self.ser.write(build_frame(0x80 | addr, count, 0))
+        deadline = time.monotonic() + ECHO_TIMEOUT_S
+        while True:
+            try:
+                reg, values = self.replies.get(timeout=max(0.0, deadline - time.monotonic()))
+            except queue.Empty:
+                return None
+            if reg == addr and len(values) == count:
+                return values
+
+    ##
+    # @brief Demande la trame de capacités
+    # @return Dictionnaire CAPS_FIELDS, ou None
+    def read_caps(self):
+        self.write_reg(REG_CAPS, 0)
+        try:
+            return self.caps.get(timeout=ECHO_TIMEOUT_S)
+        except queue.Empty:
+            return None
+
+    ##
+    # @brief Émet un écho et l'ajoute à la synchronisation d'horloge s'il revient
+    def ping(self, sync, token):
+        frame = build_frame(REG_PING & 0x7F, token & 0xFF, token >> 8)
+        h0 = time.perf_counter_ns()
+        self.ser.write(frame)
+        deadline = time.monotonic() + ECHO_TIMEOUT_S
+        while True:
+            try:
+                h3, (echo_token, t_rx, _t_parse, _t_app, t_tx) = \
+                    self.echoes.get(timeout=max(0.0, deadline - time.monotonic()))
+            except queue.Empty:
+                return False
+            if echo_token == token:
+                sync.add(h0, h3, t_rx, t_tx)
+                return True
+
+    def close(self):
+        self.stop.set()
+        self.thread.join(timeout=1.0)
+
+##
+# @brief Clé d'un mode, commune aux rapports comparés
+def mode_key(mode):
+    baud, rate, fmt, batch, lat = mode
+    return f"{baud}:{rate}:{fmt}:{batch}:{lat}"
+
+##
+# @brief Analyse un mode "débit:cadence:format[:lot[:latence ms]]"
+def parse_mode(text):
+    parts = text.split(":")
+    if len(parts) < 3 or parts[2] not in BENCH_FORMATS:
+        raise argparse.ArgumentTypeError(f"mode invalide : {text}")
+    baud, rate = int(parts[0]), int(parts[1])
+    batch = int(parts[3]) if len(parts) > 3 else 1
+    lat = int(parts[4]) if len(parts) > 4 else 0
+    if baud not in BAUD_RATES:
+        raise argparse.ArgumentTypeError(f"débit non supporté : {baud}")
+    return baud, rate, parts[2], batch, lat
+
+##
+# @brief Pertes sur la grille de dates : rangs distincts reçus contre rangs attendus
+# @param stamps Dates firmware (µs, 32 bits), dans l'ordre de réception
+# @param period_us Période de la grille (1000000 // cadence, comme le firmware)
+# @return (attendus, reçus distincts, doublons)
+def grid_loss(stamps, period_us):
+    unwrap = Unwrap32()
+    t = [unwrap(s) for s in stamps]
+    if not t:
+        return 0, 0, 0
+    t0 = min(t)
+    ranks = [int(round((v - t0) / period_us)) for v in t]
+    unique = len(set(ranks))
+    return max(ranks) + 1, unique, len(ranks) - unique
+
+##
+# @brief Mesure un mode
+# @return Dictionnaire de résultats
+def run_mode(link, mode, duration):
+    baud, rate, fmt, batch, lat = mode
+    if link.ser.baudrate != baud:
+        set_baud(link.ser, baud)
+    link.write_reg(REG_REPLAY, REPLAY_CMD_STOP)
+    link.write_reg(REG_IDLE_RATE, 0)
+    link.write_reg(REG_TELEM_ADAPT, 1)
+    link.write_reg(REG_IMU_RATE, 0)
+    link.write_reg(REG_TELEM_RATE, rate)
+    link.write_reg(REG_TELEM_FORMAT, BENCH_FORMATS[fmt])        # flux d'état lent coupé
+    link.write_reg(REG_TELEM_BATCH, batch | (lat << 8))
+    applied = link.read_regs(REG_TELEM_RATE, 4)
+
+    sync = ClockSync()
+    token = 0
+    link.write_reg(REG_REPLAY, REPLAY_CMD_SYNTH)
+    t_warm = time.monotonic() + BENCH_WARMUP_S
+    while time.monotonic() < t_warm:
+        link.ping(sync, token)
+        token = (token + 1) & 0x7FFF
+        time.sleep(BENCH_PING_S)
+    link.take()
+
+    t0_ns = time.perf_counter_ns()
+    cpu0 = time.process_time()
+    t_end = time.monotonic() + duration
+    while time.monotonic() < t_end:
+        link.ping(sync, token)
+        token = (token + 1) & 0x7FFF
+        time.sleep(BENCH_PING_S)
+    wall_s = (time.perf_counter_ns() - t0_ns) / 1e9
+    cpu_s = time.process_time() - cpu0
+    samples, rx_bytes = link.take()
+    link.write_reg(REG_REPLAY, REPLAY_CMD_STOP)
+    time.sleep(BENCH_DRAIN_S)
+    link.take()
+
+    period_us = 1000000 // rate
+    expected, unique, dup = grid_loss([ts for _, ts in samples], period_us)
+    lat_ms = []
+    if sync.fit():
+        lat_ms = sorted((arrival - sync.mcu_to_host_ns(ts)) / 1e6 for arrival, ts in samples)
+    result = {
+        "mode": mode_key(mode),
+        "applied": list(applied) if applied else None,
+        "samples_s": unique / wall_s,
+        "expected_s": expected / wall_s,
+        "loss_pct": 100.0 * (expected - unique) / expected if expected else 100.0,
+        "duplicates": dup,
+        "bytes_s": rx_bytes / wall_s,
+        "link_pct": 100.0 * rx_bytes * 10 / (baud * wall_s),
+        "cpu_pct": 100.0 * cpu_s / wall_s,
+        "sync_residual_us": sync.residual_us() if sync.samples else None,
+    }
+    for p in PERCENTILES:
+        result[f"lat_p{p:g}_ms"] = percentile(lat_ms, p) if lat_ms else None
+    result["lat_max_ms"] = lat_ms[-1] if lat_ms else None
+    return result
+
+##
+# @brief Affiche l'écart avec un rapport précédent, mode par mode
+def compare(report, previous):
+    old = {m["mode"]: m for m in previous.get("modes", [])}
+    print(f"\ncomparaison avec {previous.get('date', '?')} (firmware {previous.get('caps', {}).get('version', '?')})")
+    print(f"{'mode':<26}" + "".join(f"{k:>22}" for k, _, _ in COMPARE_KEYS))
+    for m in report["modes"]:
+        ref = old.get(m["mode"])
+        if ref is None:
+            continue
+        cols = ""
+        for key, fmt, sign in COMPARE_KEYS:
+            a, b = ref.get(key), m.get(key)
+            if a is None or b is None:
+                cols += f"{'-':>22}"
+                continue
+            mark = "" if a == b else ("+" if (b - a) * sign > 0 else "!")
+            cols += f"{format(a, fmt) + ' -> ' + format(b, fmt) + mark:>22}"
+        print(f"{m['mode']:<26}{cols}")
+
+def main():
+    parser = argparse.ArgumentParser(description="Banc de débit de la liaison par mode (source synthétique)")
+    parser.add_argument("port", help="port série (ex. /dev/ttyACM0, COM5)")
+    parser.add_argument("--modes", nargs="+", type=parse_mode,
+                        help="modes débit:cadence:format[:lot[:latence ms]] (défaut : balayage BENCH_MODES)")
+    parser.add_argument("--duration", type=float, default=BENCH_DURATION_S, help="durée de mesure par mode (s)")
+    parser.add_argument("--out", help="rapport JSON")
+    parser.add_argument("--compare", help="rapport JSON précédent à comparer")
+    args = parser.parse_args()
+
+    ser = serial.Serial(args.port, BAUD_RATES[0], timeout=0.05)
+    link = BenchLink(ser)
+    report = {"date": time.strftime("%Y-%m-%d %H:%M:%S"), "port": args.port, "duration_s": args.duration,
+              "modes": []}
+    saved = []
+    try:
+        report["caps"] = link.read_caps() or {}
+        for addr, count in BENCH_SAVED:
+            values = link.read_regs(addr, count)
+            if values is not None:
+                saved.append((addr, values))
+
+        print(f"firmware {report['caps'].get('version', '?')}, {args.duration:.0f} s par mode")
+        print(f"{'mode':<26}{'éch/s':>9}{'attendus':>9}{'pertes %':>9}{'liaison %':>10}{'cpu %':>7}" +
+              "".join(f"{'p' + format(p, 'g') + ' ms':>10}" for p in PERCENTILES))
+        for mode in args.modes or BENCH_MODES:
+            r = run_mode(link, mode, args.duration)
+            report["modes"].append(r)
+            lat = "".join(f"{r[f'lat_p{p:g}_ms']:>10.2f}" if r[f'lat_p{p:g}_ms'] is not None else f"{'-':>10}"
+                          for p in PERCENTILES)
+            print(f"{r['mode']:<26}{r['samples_s']:>9.0f}{r['expected_s']:>9.0f}{r['loss_pct']:>9.2f}"
+                  f"{r['link_pct']:>10.1f}{r['cpu_pct']:>7.1f}{lat}")
+    except KeyboardInterrupt:
+        pass
+    finally:
+        link.write_reg(REG_REPLAY, REPLAY_CMD_STOP)
+        for addr, values in saved:
+            for i, v in enumerate(values):
+                link.write_reg(addr + i, v)
+        if ser.baudrate != BAUD_RATES[0]:
+            set_baud(ser, BAUD_RATES[0])
+        link.close()
+        ser.close()
+
+    if args.out:
+        with open(args.out, "w", encoding="utf-8") as f:
+            json.dump(report, f, indent=2)
+    if args.compare:
+        with open(args.compare, encoding="utf-8") as f:
+            compare(report, json.load(f))
+    return 0 if report["modes"] else 1
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,188 @@
+##
+# @file proto_defs.py
+# @brief Constantes et formats du protocole série (fichier généré par gen_proto.py,
+# ne pas modifier : éditer proto_def.h / serial_cmd.h puis relancer le générateur)
+#
+
+import struct
+
+## @brief Adresses des registres virtuels (serial_cmd.h)
+REG_SERVO_CMD = 0x00
+REG_MOTOR_CMD = 0x01
+REG_BMI = 0x02
+REG_IMU_CONFIG = 0x03
+REG_SPI_PRESC = 0x04
+REG_SPI_BENCH = 0x05
+REG_BAUD = 0x06
+REG_TELEM_RATE = 0x07
+REG_TELEM_FIELDS = 0x08
+REG_TELEM_FORMAT = 0x09
+REG_TELEM_BATCH = 0x0A
+REG_STAT_TELEM_SEQ = 0x0B
+REG_SNAPSHOT = 0x0B
+REG_STAT_TX_DROP = 0x0C
+REG_STAT_RX_DROP = 0x0D
+REG_KIN_SPEED = 0x0C
+REG_KIN_CURV = 0x0D
+REG_STAT_IMU_DROP = 0x0E
+REG_STAT_IDLE_PCT = 0x0F
+REG_PROF_SEL = 0x10
+REG_PROF_COUNT = 0x11
+REG_PROF_MIN = 0x12
+REG_PROF_AVG = 0x13
+REG_PROF_MAX = 0x14
+REG_PROF_HIST0 = 0x15
+REG_PROF_OVERRUNS = 0x1D
+REG_PROF_LATE_MAX = 0x1E
+REG_JITTER_MODE = 0x1F
+REG_SPEED_KP = 0x20
+REG_SPEED_KI = 0x21
+REG_SPEED_KD = 0x22
+REG_ESC_BRAKE_MS = 0x23
+REG_ESC_GAP_MS = 0x24
+REG_ESC_BRAKE_DEPTH = 0x25
+REG_SERVO_CDEG = 0x26
+REG_SERVO_SLEW = 0x27
+REG_FS_DECEL_MS = 0x28
+REG_FS_NEUTRAL_MS = 0x29
+REG_FS_DISARM_MS = 0x2A
+REG_FS_STAGE = 0x2B
+REG_HEARTBEAT = 0x2B
+REG_STAT_RX_REJECT = 0x2C
+REG_STAT_RX_RATE = 0x2D
+REG_STAT_RESET_CAUSE = 0x2E
+REG_FAULT = 0x2E
+REG_STAT_IMU_BUS_ERR = 0x2F
+REG_STAT_IMU_RECOVER = 0x30
+REG_STAT_STACK_PEAK = 0x31
+REG_STAT_STACK_SIZE = 0x32
+REG_STAT_RAM_DMA = 0x33
+REG_STAT_RAM_HOT = 0x34
+REG_STAT_RAM_STATIC = 0x35
+REG_STAT_RX_HWM = 0x36
+REG_STAT_TX_HWM = 0x37
+REG_STAT_RX_OVERRUN = 0x38
+REG_STAT_RAM_FUNC = 0x39
+REG_FW_UPDATE = 0x39
+REG_BOOT_STAGE_BASE = 0x3A
+REG_BOOT_STAGE_UNIT_US = 100
+REG_ATT_KP = 0x40
+REG_IMU_CAL = 0x41
+REG_IMU_OFS_BASE = 0x42
+REG_IMU_OFS_COUNT = 6
+REG_MOTOR_MAX_FWD = 0x48
+REG_MOTOR_MAX_REV = 0x49
+REG_SERVO_MIN_TICKS = 0x4A
+REG_SERVO_MAX_TICKS = 0x4B
+REG_NV_CMD = 0x4C
+REG_NV_KEYS = 0x4D
+REG_NV_GEN = 0x4E
+REG_IDLE_RATE = 0x4F
+REG_IDLE_HOLD_MS = 0x50
+REG_MOTION_MG = 0x51
+REG_IDLE_STATE = 0x52
+REG_PING = 0x53
+REG_TELEM_ADAPT = 0x54
+REG_TELEM_DECIM = 0x55
+REG_TELEM_EFF_RATE = 0x56
+REG_IMU_RATE = 0x57
+REG_HIST_CMD = 0x58
+REG_HIST_THR_MG = 0x59
+REG_HIST_POST = 0x5A
+REG_HIST_COUNT = 0x5B
+REG_HIST_TRIG = 0x5C
+REG_HIST_CHUNK = 0x5D
+REG_ODOM_CMD = 0x5E
+REG_ODOM_BASE = 0x5F
+REG_ODOM_COUNT = 5
+REG_TRAJ_CMD = 0x64
+REG_TRAJ_COUNT = 0x65
+REG_TRAJ_PT_BASE = 0x66
+REG_TRAJ_PT_LEN = 4
+REG_TRAJ_PT_SLOTS = 2
+REG_MOTOR_ACCEL = 0x6E
+REG_MOTOR_JERK = 0x6F
+REG_SERVO_ACCEL = 0x70
+REG_IMU_FILT = 0x71
+REG_IMU_FILT_DECIM = 0x72
+REG_VIB_CMD = 0x73
+REG_VIB_AVG = 0x74
+REG_VIB_PEAK_DHZ = 0x75
+REG_VIB_PEAK_MG = 0x76
+REG_ACT_SEL = 0x77
+REG_ACT_CMD = 0x78
+REG_ACT_OUT = 0x79
+REG_ACT_STATE = 0x7A
+REG_CAPS = 0x7B
+REG_PARK_MS = 0x7C
+REG_BATT_MV = 0x7D
+REG_BATT_NOM_MV = 0x7E
+REG_REPLAY = 0x7F
+REG_COUNT = 128
+REG_F_R = 0x01
+REG_F_W = 0x02
+REG_F_NV = 0x04
+
+## @brief Version du protocole et bits de la trame de capacités (proto_def.h)
+PROTO_VERSION_MAJOR = 1
+PROTO_VERSION_MINOR = 11
+CAPS_LINK_FRAMED = 0x01
+CAPS_LINK_SPI = 0x02
+CAPS_LINK_ENVELOPE = 0x04
+CAPS_LINK_COBS = 0x08
+CAPS_LINK_FW_UPDATE = 0x10
+PROTO_VERSION = (PROTO_VERSION_MAJOR << 8) | PROTO_VERSION_MINOR
+
+## @brief Types de trame (PROTO_FRAME_TYPES)
+TELEM_TYPE_LEGACY = 0x01
+TELEM_TYPE_FX = 0x02
+TELEM_TYPE_FIELDS = 0x03
+TELEM_TYPE_COMPACT = 0x04
+TELEM_TYPE_DELTA = 0x05
+TELEM_TYPE_ECHO = 0x06
+TELEM_TYPE_BENCH = 0x07
+TELEM_TYPE_LOG = 0x08
+TELEM_TYPE_HIST = 0x09
+TELEM_TYPE_VIB = 0x0A
+TELEM_TYPE_CAPS = 0x0B
+TELEM_TYPE_REG = 0x0C
+TELEM_TYPE_HIST_PACKED = 0x0D
+TELEM_TYPE_SNAP = 0x0E
+TELEM_TYPE_STATUS = 0x0F
+TELEM_TYPE_FW = 0x10
+TELEM_TYPE_FAULT = 0x11
+TELEM_TYPE_BMIREG = 0x12
+
+## @brief Champs de la trame type 0x03 (PROTO_TELEM_FIELDS) : bit, longueur, format
+TELEM_F_ACCEL = 0x01
+TELEM_F_GYRO = 0x02
+TELEM_F_SPEED = 0x04
+TELEM_F_MOTOR = 0x08
+TELEM_F_SERVO = 0x10
+TELEM_F_TIMING = 0x20
+TELEM_F_ATTITUDE = 0x40
+TELEM_F_SENSOR = 0x80
+TELEM_F_ALL = 0xFF
+## @brief Champs présents dans l'ordre d'émission, décodeur de chaque champ
+TELEM_FIELDS = [
+    (TELEM_F_ACCEL, struct.Struct('<3i')),
+    (TELEM_F_GYRO, struct.Struct('<3i')),
+    (TELEM_F_SPEED, struct.Struct('<h')),
+    (TELEM_F_MOTOR, struct.Struct('<hB')),
+    (TELEM_F_SERVO, struct.Struct('<b')),
+    (TELEM_F_TIMING, struct.Struct('<II')),
+    (TELEM_F_ATTITUDE, struct.Struct('<4h')),
+    (TELEM_F_SENSOR, struct.Struct('<Ih')),
+]
+TELEM_FRAME_MAX_LEN = 64
+
+## @brief Trames fixes (PROTO_FIXED_FRAMES) : décodeurs de la trame complète
+FRAME_LEGACY = struct.Struct('<BBBBHI3f3ffB')  # SerialImuFrame_t, TELEM_TYPE_LEGACY
+FRAME_FX = struct.Struct('<BBBBHI3i3ihB')  # SerialImuFrameFx_t, TELEM_TYPE_FX
+FRAME_COMPACT = struct.Struct('<BBBBHIB3h3hhB')  # SerialImuFrameCompact_t, TELEM_TYPE_COMPACT
+FRAME_ECHO = struct.Struct('<BBBBHIIIIB')  # SerialEchoFrame_t, TELEM_TYPE_ECHO
+FRAME_CAPS = struct.Struct('<BBBBHHBBHHBBBBHHBB')  # SerialCapsFrame_t, TELEM_TYPE_CAPS
+FRAME_SNAP = struct.Struct('<BBBBHIbhBBHBhII3i3iB')  # SerialSnapFrame_t, TELEM_TYPE_SNAP
+FRAME_FW = struct.Struct('<BBBBBBHBIB')  # SerialFwFrame_t, TELEM_TYPE_FW
+FRAME_FAULT = struct.Struct('<BBBBBBHII8IIHHHHB')  # SerialFaultFrame_t, TELEM_TYPE_FAULT
+FRAME_BMIREG = struct.Struct('<BBBBBBBBb16BB')  # SerialBmiRegFrame_t, TELEM_TYPE_BMIREG
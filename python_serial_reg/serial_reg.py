@@ -6,28 +6,1065 @@
 #
 
 import customtkinter as ctk
+from tkinter import filedialog
 import serial
 import serial.tools.list_ports
 import threading
+import queue
 import time
 import struct
+import math
+import mmap
+import sys
+import argparse
+
+## @brief Registres REG_*, types de trame TELEM_TYPE_*, champs TELEM_F_* et décodeurs des trames
+# fixes FRAME_*, générés depuis la description du firmware (gen_proto.py, proto_def.h)
+from proto_defs import *
+
+## @brief Client du démon de flotte : un lien "fleet://HÔTE:PORT/NOM" remplace le port série
+from fleet_client import FLEET_SCHEME, FleetLink, parse_fleet_url
+from telem_plot import SampleRing, TelemPlot
+
+## @brief Octet de synchronisation des trames de commande
+PROTO_SYNC = 0xA5
+
+## @brief Octet de synchronisation des trames d'écriture groupée
+PROTO_SYNC_BURST = 0xA6
+
+## @brief Débits supportés, indexés par code (registre REG_BAUD)
+BAUD_RATES = [115200, 460800, 921600, 2000000]
+
+## @brief Horloge capteur IMU : 24 bits, 39,0625 µs par LSB ; température inconnue
+IMU_SENSORTIME_US = 39.0625
+IMU_TEMP_UNKNOWN = -32768
+
+## @brief Sélection de sonde du profileur (REG_PROF_SEL) : 0x00..0x0F tâche, 0x10+k sonde hors ordonnanceur, bit 7 = RAZ
+PROF_SEL_PROBE = 0x10
+PROF_SEL_LATENESS = 0x40
+PROF_SEL_RESET = 0x80
+## @brief Sonde hors ordonnanceur : latence d'entrée de l'interruption TIM3 (banc de gigue)
+PROF_PROBE_TIM3_LATENCY = 4
+PROF_PROBE_MOTOR_ISR = 5
+## @brief Sondes de latence des commandes : arrivée DMA -> décodage, décodage -> application,
+# application -> écriture CCR, arrivée DMA -> écriture CCR (commandes d'actionneur)
+PROF_PROBE_CMD_RX = 6
+PROF_PROBE_CMD_QUEUE = 7
+PROF_PROBE_CMD_ACT = 8
+PROF_PROBE_CMD_E2E = 9
+## @brief Sonde du démarrage : reset -> main() (une mesure, recopie .data et mise à zéro .bss)
+PROF_PROBE_STARTUP = 10
+## @brief Sondes de la boucle de lacet chaînée à l'IMU (APP_IMU_CHAIN) : durée en PendSV, échantillon -> écriture CCR
+PROF_PROBE_IMU_CHAIN = 11
+PROF_PROBE_IMU_E2E = 12
+## @brief Banc de gigue (REG_JITTER_MODE) : bit 0 = sonde de latence TIM3 CH2, bit 1 = charge UART TX à plein débit
+JITTER_MODE_ISR_PROBE = 0x01
+JITTER_MODE_TX_STRESS = 0x02
+## @brief Étapes du failsafe gradué (REG_FS_STAGE)
+FS_STAGE_NAMES = ("OK", "DECEL", "NEUTRE", "DESARME")
+## @brief Période d'entretien de la liaison (s) : bien en deçà de REG_FS_DECEL_MS (200 ms par défaut)
+HEARTBEAT_PERIOD_S = 0.1
+## @brief Période de réémission de la consigne entre deux entretiens (s), au cas où une trame serait perdue
+COMMAND_REFRESH_S = 1.0
+## @brief Intervalle minimal entre deux trames de consignes des curseurs (s) : 50 trames/s au plus
+SETPOINT_PERIOD_S = 0.02
+HEARTBEAT_LABEL = f"Heart Beat ({HEARTBEAT_PERIOD_S * 1000:.0f}ms)"
+## @brief Étapes du démarrage datées depuis le reset à partir de REG_BOOT_STAGE_BASE (unité REG_BOOT_STAGE_UNIT_US, -1 si non atteinte)
+BOOT_STAGE_NAMES = ["hal", "actuators", "serial", "sched", "imu", "telemetry"]
+## @brief Calibration IMU (REG_IMU_CAL) : écriture 1 = gyroscope, 2 = gyroscope + accéléromètre (à plat), 3 = effacement ;
+# lecture = état (0 aucune, 1 en cours, 2 terminée, 3 mouvement, 4 erreur flash, 5 interrompue), bit 8 = en flash
+IMU_CAL_GYRO = 1
+IMU_CAL_GYRO_ACCEL = 2
+IMU_CAL_CLEAR = 3
+## @brief Auto-test IMU (REG_BMI) : écriture IMU_SELFTEST_RUN pour le relancer ;
+# lecture = état (octet bas, IMU_SELFTEST_NAMES) | capteurs en échec << 8 (IMU_SELFTEST_FAIL_BITS)
+IMU_SELFTEST_RUN = 1
+IMU_SELFTEST_NAMES = ["non lancé", "en cours", "réussi", "échec", "erreur SPI"]
+IMU_SELFTEST_FAIL_BITS = ["accel X", "accel Y", "accel Z", "gyro"]
+## @brief Profils latence / bruit de REG_IMU_CONFIG (bits 14-15) : remplacent ODR et bandes passantes,
+# gammes conservées ; en lecture, profil déduit de la configuration active (0 : réglage libre)
+IMU_CFG_PROFILE_SHIFT = 14
+IMU_PROFILE_NAMES = ["libre", "bas bruit (accel OSR4 400 Hz, gyro 116 Hz)",
+                     "équilibré (accel OSR2 800 Hz, gyro 230 Hz)", "basse latence (accel normal 1600 Hz, gyro 532 Hz)"]
+## @brief Configuration persistante : demande NV_CMD_* en écriture, résultat en lecture (NV_STATUS_NAMES)
+NV_CMD_SAVE = 1
+NV_CMD_CLEAR = 2
+## @brief Banc de préparation : écritures REG_F_NV retenues entre STAGE et COMMIT, appliquées d'un bloc
+NV_CMD_STAGE = 3
+NV_CMD_COMMIT = 4
+NV_CMD_DISCARD = 5
+NV_STATUS_NAMES = ["defaults", "loaded", "saved", "cleared", "flash error", "busy (motor running)", "invalid request",
+                   "staging", "committed", "discarded"]
+## @brief États de la mise en veille de la télémétrie (REG_IDLE_STATE)
+IDLE_STATE_NAMES = ["off", "active", "idle", "error"]
+## @brief Causes de sortie de veille du véhicule garé (lp_wake_t, REG_PARK_MS)
+PARK_WAKE_NAMES = {1: "uart", 2: "mouvement"}
+## @brief États de la détection de patinage / blocage (Motor_Traction_t, événement DLOG_TRACTION)
+TRAC_NAMES = ["rétablie", "patinage", "blocage"]
+## @brief Causes et unité de la mesure des défauts IMU (imu_health_cause_t, événement DLOG_IMU_HEALTH)
+IMU_HEALTH_CAUSES = {1: ("accéléromètre figé", "échantillons"), 2: ("gyroscope figé", "échantillons"),
+                     3: ("accéléromètre saturé", "échantillons/fenêtre"), 4: ("gyroscope saturé", "échantillons/fenêtre"),
+                     5: ("erreurs SPI", "erreurs/fenêtre"), 6: ("capteur muet", "ms")}
+## @brief Actions entreprises sur défaut IMU (imu_health_action_t)
+IMU_HEALTH_ACTIONS = ["signalé", "gamme élargie", "récupération"]
+## @brief Historique IMU figé sur événement : commandes de REG_HIST_CMD, état et source en lecture (état | source << 4)
+HIST_CMD_TRIGGER = 1
+HIST_CMD_REARM = 2
+HIST_STATE_NAMES = ["recording", "post-trigger", "frozen"]
+HIST_TRIG_NAMES = ["none", "host", "failsafe", "threshold"]
+## @brief Échantillons par bloc, délai d'attente d'un bloc (s) et nombre d'essais par bloc
+HIST_CHUNK = 12
+## @brief Téléchargement compressé (trame type 0x0D) : bit de REG_HIST_CHUNK, échappement Rice (rice.h)
+HIST_CHUNK_PACKED = 0x8000
+HIST_RICE_ESCAPE = 15
+HIST_TIMEOUT_S = 0.5
+HIST_RETRIES = 3
+## @brief Odométrie embarquée (REG_ODOM_CMD) : 1 pose, 2 pose + distance à zéro ; la pose
+# (REG_ODOM_COUNT registres à partir de REG_ODOM_BASE) se lit en une trame
+ODOM_CMD_RESET_POSE = 1
+ODOM_CMD_RESET_ALL = 2
+## @brief Tampon de trajectoire : commandes et états de REG_TRAJ_CMD ; emplacements de REG_TRAJ_PT_LEN registres
+# [date µs faible | date µs fort | braquage c° | vitesse mm/s] (la vitesse ajoute le point)
+TRAJ_CMD_CLEAR = 1
+TRAJ_CMD_START = 2
+TRAJ_CMD_STOP = 3
+## @brief Rejeu de mesures (REG_REPLAY) : commandes ; enregistrement injecté
+# [écart µs | ax | ay | az | gx | gy | gz (LSB) | vitesse mm/s] en une trame groupée ;
+# REPLAY_CMD_SYNTH : source synthétique datée sur une grille exacte (banc link_bench.py)
+REPLAY_CMD_STOP = 0
+REPLAY_CMD_START = 1
+REPLAY_CMD_SYNTH = 2
+TRAJ_STATE_NAMES = ["idle", "running", "done", "rejected"]
+TRAJ_LEN = 64
+## @brief Accès direct aux registres IMU par REG_BMI (bit 15 ; driver_ins.h), résultat en trame type 0x12 :
+# lecture = drapeau | gyro | (octets - 1) << 8 | adresse ; écriture = drapeau | écriture | octet (registre de la dernière lecture)
+BMI_REGIO_FLAG = 0x8000
+BMI_REGIO_WRITE = 0x4000
+BMI_REGIO_GYRO = 0x2000
+BMI_REGIO_MAX_LEN = 16
+BMI_SENSOR_NAMES = ("accel", "gyro")
+## @brief Fenêtre d'actionneurs : bit ESC de REG_ACT_SEL (bits 0..6 : index)
+ACT_SEL_MOTOR = 0x80
+## @brief Formats des points de journal, indexés par ID (même ordre que dlog_id_t)
+LOG_FORMATS = [
+    lambda a: f"boot {BOOT_STAGE_NAMES[a[0]] if 0 <= a[0] < len(BOOT_STAGE_NAMES) else a[0]} à {a[1]} us",
+    lambda a: f"failsafe {FS_STAGE_NAMES[a[0]] if 0 <= a[0] < len(FS_STAGE_NAMES) else a[0]} ({a[1]} ms sans commande)",
+    lambda a: f"IMU bus en échec : {a[0]} échecs consécutifs, {a[1]} timeouts, {a[2]} erreurs",
+    lambda a: f"IMU bus récupéré ({a[0]} récupérations)",
+    lambda a: f"UART RX overrun ({a[0]})",
+    lambda a: f"débit série {a[0]} bauds",
+    lambda a: f"télémétrie décimée 1/{a[0]} ({a[1]} octets TX libres, {a[2]} trames refusées)",
+    lambda a: f"historique IMU figé ({HIST_TRIG_NAMES[a[0]] if 0 <= a[0] < len(HIST_TRIG_NAMES) else a[0]}, "
+              f"{a[1]} échantillons, déclenchement au rang {a[2]})",
+    lambda a: f"réveil ({PARK_WAKE_NAMES.get(a[0], a[0])}) après {a[1]} ms de veille, "
+              f"télémétrie rétablie en {a[2]} us",
+    lambda a: f"endurance : boucle {a[0]} Hz, {a[1]} overruns, retard max {a[2]} us",
+    lambda a: f"auto-test IMU {imu_selftest_text(a[0] | (a[1] << 8))}",
+    lambda a: f"adhérence : {TRAC_NAMES[a[0]] if 0 <= a[0] < len(TRAC_NAMES) else a[0]} "
+              f"(consigne {a[1]} mm/s, mesure {a[2]} mm/s)",
+    lambda a: f"IMU : {IMU_HEALTH_CAUSES.get(a[0], (a[0], ''))[0]} ({a[1]} {IMU_HEALTH_CAUSES.get(a[0], ('', ''))[1]}), "
+              f"{IMU_HEALTH_ACTIONS[a[2]] if 0 <= a[2] < len(IMU_HEALTH_ACTIONS) else a[2]}",
+]
+BENCH_NAMES = ["crc8", "imu_read_all", "conv_float", "conv_fx", "motor_tick", "speedo_solve", "serial_write", "image", "budget"]
+## @brief Sources de la table des budgets d'exécution (ARG des entrées "budget", ordre de bench.c), 0xFF : créneau complet
+BUDGET_NAMES = ["motor", "imu", "speed", "telemetry", "watchdog", "battery", "status", "soak",
+                "serial_rx", "cmd", "motor_isr", "imu_spi_isr", "imu_drdy_isr", "imu_chain"]
+BENCH_BUDGET_SLOT = 0xFF
+## @brief Bornes hautes des classes d'histogramme du profileur (µs), dernière classe au-delà
+PROF_HIST_LIMITS_US = [4, 16, 64, 256, 1024, 4096, 16384]
+## @brief Échelles BMI088 (LSB/g et LSB/dps) indexées par code de gamme, identiques au firmware
+ACCEL_RANGE_LSB = [10922.67, 5461.33, 2730.67, 1365.33]
+GYRO_RANGE_LSB = [16.4, 32.768, 65.6, 131.2, 262.4]
+G_TO_MM_S2 = 9806.65
+DEG_TO_RAD = 0.017453292519943295
+## @brief Échappement des deltas du lot type 0x05 (suivi de la valeur absolue int16)
+TELEM_DELTA_ESCAPE = -128
+
+## @brief Nature des trames remises par le thread de lecture au thread de décodage
+FRAME_IMU = 0
+FRAME_CMD = 1
+FRAME_BURST = 2
+## @brief Profondeur de la file lecture -> décodage (trames ; au-delà, comptées perdues côté hôte)
+RX_QUEUE_DEPTH = 16384
+## @brief Période de rafraîchissement de l'interface (ms) : seul le thread Tk touche aux widgets
+UI_POLL_MS = 100
+## @brief Nombre maximal de lignes de log insérées par rafraîchissement
+UI_LOG_BATCH = 500
+
+## @brief Enregistrement de trames : magique et version de l'entête de fichier
+REC_MAGIC = b"STMTLM01"
+REC_VERSION = 1
+## @brief Entête de fichier [MAGIC | VERSION u16 | REC_SIZE u16 | réservé u32] (16 octets)
+REC_FILE_HDR = struct.Struct('<8sHHI')
+## @brief Entête d'enregistrement [t hôte ns u64 | timestamp µs u32 | séquence u16 | nature u8 | - | longueur u16 | -]
+# Timestamp et séquence sont ceux de la trame IMU (0 pour les réponses de commande) :
+# la suite des entêtes, à pas fixe, sert d'index sans relire les trames
+REC_HDR = struct.Struct('<QIHBxH6x')
+## @brief Place réservée à la trame (la plus longue trame IMU fait 4 + 255 + 1 octets)
+REC_FRAME_MAX = 264
+## @brief Taille fixe d'un enregistrement (octets)
+REC_SIZE = REC_HDR.size + REC_FRAME_MAX
+## @brief Facteur d'accélération de la relecture depuis l'interface (0 : au plus vite)
+REPLAY_SPEED = 10.0
+
+##
+# @brief Convertit des axes bruts BMI088 en unités physiques
+# @param axes Liste [ax, ay, az, gx, gy, gz] en LSB
+# @param ranges Octet de gammes (bits 0-1 accéléromètre, bits 2-4 gyroscope)
+# @return (accel en mm/s², gyro en rad/s)
+def scale_raw_axes(axes, ranges):
+    acc_k = G_TO_MM_S2 / ACCEL_RANGE_LSB[ranges & 0x03]
+    gyr_k = DEG_TO_RAD / GYRO_RANGE_LSB[min((ranges >> 2) & 0x07, 4)]
+    return [a * acc_k for a in axes[0:3]], [g * gyr_k for g in axes[3:6]]
+
+##
+# @brief Échantillons d'une trame de télémétrie, en unités d'affichage
+# @param packet Trame complète de type 0x01 à 0x05
+# @return Liste de (date µs 32 bits, [ax, ay, az mm/s², gx, gy, gz rad/s, vitesse m/s]) ;
+# NaN pour une voie absente d'une trame à contenu choisi
+def imu_samples(packet):
+    frame_type = packet[2]
+    if frame_type == TELEM_TYPE_COMPACT:
+        f = FRAME_COMPACT.unpack_from(packet)
+        acc, gyr = scale_raw_axes(f[7:13], f[6])
+        return [(f[5], acc + gyr + [f[13] / 1000.0])]
+    if frame_type == TELEM_TYPE_DELTA:
+        ts, ranges, speed_mms, batch = decode_delta_batch(packet[4:-1])
+        out = []
+        for dt, axes in batch:
+            ts = (ts + dt) & 0xFFFFFFFF
+            acc, gyr = scale_raw_axes(axes, ranges)
+            out.append((ts, acc + gyr + [speed_mms / 1000.0]))
+        return out
+    if frame_type == TELEM_TYPE_FX:
+        # Virgule fixe : mm/s², µrad/s, mm/s -> conversion flottante côté hôte
+        u = FRAME_FX.unpack(packet)
+        return [(u[5], [u[6], u[7], u[8], u[9] / 1e6, u[10] / 1e6, u[11] / 1e6, u[12] / 1000.0])]
+    if frame_type == TELEM_TYPE_FIELDS:
+        ts, fields = struct.unpack_from('<IB', packet, 6)
+        values = [math.nan] * 7
+        off = 11
+        for bit, field in TELEM_FIELDS:
+            if fields & bit:
+                if bit == TELEM_F_ACCEL:
+                    values[0:3] = field.unpack_from(packet, off)
+                elif bit == TELEM_F_GYRO:
+                    values[3:6] = [g / 1e6 for g in field.unpack_from(packet, off)]
+                elif bit == TELEM_F_SPEED:
+                    values[6] = field.unpack_from(packet, off)[0] / 1000.0
+                off += field.size
+        return [(ts, values)]
+    u = FRAME_LEGACY.unpack(packet)
+    return [(u[5], list(u[6:13]))]
+
+##
+# @brief Convertit le quaternion d'attitude du firmware en angles d'Euler
+# @param qw, qx, qy, qz Composantes du quaternion (norme ~1)
+# @return (roulis, tangage, lacet) en degrés
+def quat_to_euler_deg(qw, qx, qy, qz):
+    roll = math.atan2(2.0 * (qw * qx + qy * qz), 1.0 - 2.0 * (qx * qx + qy * qy))
+    pitch = math.asin(max(-1.0, min(1.0, 2.0 * (qw * qy - qz * qx))))
+    yaw = math.atan2(2.0 * (qw * qz + qx * qy), 1.0 - 2.0 * (qy * qy + qz * qz))
+    return math.degrees(roll), math.degrees(pitch), math.degrees(yaw)
+
+##
+# @brief Décode une trame à contenu choisi (type 0x03) ou du flux d'état lent (type 0x0F)
+# Offsets tirés de la table générée : l'ordre et la taille des champs suivent proto_def.h
+# @param packet Trame complète [AA 55 TYPE LEN | SEQ | TIMESTAMP | FIELDS | champs | CRC]
+# @return (timestamp µs, masque, dictionnaire bit TELEM_F_* -> valeurs)
+def decode_fields(packet):
+    timestamp, fields = struct.unpack_from('<IB', packet, 6)
+    values = {}
+    off = 11
+    for bit, field in TELEM_FIELDS:
+        if fields & bit:
+            values[bit] = field.unpack_from(packet, off)
+            off += field.size
+    return timestamp, fields, values
+
+##
+# @brief Lignes d'affichage des champs décodés par decode_fields()
+def telem_field_lines(values):
+    lines = []
+    if TELEM_F_ACCEL in values:
+        ax, ay, az = values[TELEM_F_ACCEL]
+        lines += ["ACCEL (mm/s²)", f"  X: {ax:>8d}", f"  Y: {ay:>8d}", f"  Z: {az:>8d}", ""]
+    if TELEM_F_GYRO in values:
+        gx, gy, gz = values[TELEM_F_GYRO]
+        lines += ["GYRO (rad/s)", f"  X: {gx / 1e6:>8.2f}", f"  Y: {gy / 1e6:>8.2f}", f"  Z: {gz / 1e6:>8.2f}"]
+    if TELEM_F_SPEED in values:
+        (speed,) = values[TELEM_F_SPEED]
+        lines += ["SPEED (m/s)", f"  {speed / 1000.0:>8.2f}"]
+    if TELEM_F_MOTOR in values:
+        motor_cmd, motor_state = values[TELEM_F_MOTOR]
+        lines += [f"MOTEUR : {motor_cmd} mm/s (état {motor_state})"]
+    if TELEM_F_SERVO in values:
+        (servo,) = values[TELEM_F_SERVO]
+        lines += [f"SERVO : {servo}°"]
+    if TELEM_F_TIMING in values:
+        latency, dropped = values[TELEM_F_TIMING]
+        lines += [f"LATENCE CMD MAX : {latency} µs", f"IMU PERDUS : {dropped}"]
+    if TELEM_F_ATTITUDE in values:
+        qw, qx, qy, qz = (v / 16384.0 for v in values[TELEM_F_ATTITUDE])
+        if qw or qx or qy or qz:
+            roll, pitch, yaw = quat_to_euler_deg(qw, qx, qy, qz)
+            lines += ["ATTITUDE (°)", f"  ROULIS : {roll:>7.1f}", f"  TANGAGE: {pitch:>7.1f}", f"  LACET  : {yaw:>7.1f}"]
+        else:
+            lines += ["ATTITUDE : estimateur absent"]
+    if TELEM_F_SENSOR in values:
+        sensor_time, temp_cdeg = values[TELEM_F_SENSOR]
+        lines += [f"HORLOGE IMU : {sensor_time * IMU_SENSORTIME_US / 1e6:.6f} s ({sensor_time})"]
+        lines += ["TEMP IMU : inconnue" if temp_cdeg == IMU_TEMP_UNKNOWN else f"TEMP IMU : {temp_cdeg / 100.0:.2f} °C"]
+    return lines
+
+##
+# @brief Décode le payload d'un lot delta (type 0x05)
+# @param payload Octets entre LEN et CRC
+# @return (timestamp µs du 1er échantillon, gammes, vitesse mm/s, liste de (dt_us, axes))
+def decode_delta_batch(payload):
+    ts_us, ranges, count, speed = struct.unpack_from('<IBBh', payload, 2)
+    off = 10
+    axes = list(struct.unpack_from('<6h', payload, off))
+    off += 12
+    samples = [(0, list(axes))]
+    for _ in range(count - 1):
+        (dt,) = struct.unpack_from('<H', payload, off)
+        off += 2
+        for i in range(6):
+            (d,) = struct.unpack_from('<b', payload, off)
+            off += 1
+            if d == TELEM_DELTA_ESCAPE:
+                (axes[i],) = struct.unpack_from('<h', payload, off)
+                off += 2
+            else:
+                axes[i] += d
+        samples.append((dt, list(axes)))
+    return ts_us, ranges, speed, samples
+
+##
+# @brief Décode une trame d'écho (type 0x06)
+# @param packet Trame complète [AA 55 06 LEN | JETON | T_RX | T_PARSE | T_APP | T_TX | CRC]
+# @return (jeton, dates firmware en µs : réception, mise en file, application, émission)
+def decode_echo(packet):
+    return FRAME_ECHO.unpack_from(packet)[4:9]
+
+## @brief Noms des champs de la trame de capacités, dans l'ordre de FRAME_CAPS après l'entête
+CAPS_FIELDS = ('version', 'types', 'fields', 'formats', 'rate_min_hz', 'rate_max_hz', 'bauds', 'link',
+               'burst_max_regs', 'cmd_queue_len', 'rx_ring', 'tx_ring', 'batch_max')
+
+##
+# @brief Décode la trame de capacités (type 0x0B, réponse à une écriture de REG_CAPS)
+# @param packet Trame complète
+# @return Dictionnaire CAPS_FIELDS -> valeur
+def decode_caps(packet):
+    return dict(zip(CAPS_FIELDS, FRAME_CAPS.unpack_from(packet)[4:-1]))
+
+## @brief Noms des champs de l'état instantané, dans l'ordre de FRAME_SNAP après l'entête (accel/gyro regroupés)
+SNAP_FIELDS = ('token', 't_us', 'servo_cmd', 'motor_cmd_mms', 'motor_state', 'go_forward', 'target_ticks',
+               'fs_stage', 'speed_mms', 'imu_seq', 'imu_t_us')
+
+##
+# @brief Décode la trame d'état instantané (type 0x0E, réponse à une écriture de REG_SNAPSHOT)
+# @param packet Trame complète
+# @return Dictionnaire SNAP_FIELDS -> valeur, plus 'accel' (mm/s²) et 'gyro' (µrad/s)
+def decode_snapshot(packet):
+    values = FRAME_SNAP.unpack_from(packet)[4:-1]
+    snap = dict(zip(SNAP_FIELDS, values))
+    snap['accel'] = values[11:14]
+    snap['gyro'] = values[14:17]
+    return snap
+
+##
+# @brief Décode l'acquittement d'une commande de mise à jour (type 0x10, REG_FW_UPDATE)
+# @param packet Trame complète
+# @return (opcode, statut, argument, pages préparées, CRC-32 de page)
+def decode_fw(packet):
+    return FRAME_FW.unpack_from(packet)[4:9]
+
+##
+# @brief Décode le résultat d'un accès direct aux registres IMU (type 0x12)
+# @param packet Trame complète
+# @return (écriture, capteur, adresse, octets lus, code BMI08, octets lus)
+def decode_bmireg(packet):
+    values = FRAME_BMIREG.unpack_from(packet)[4:-1]
+    write, sensor, addr, count, status = values[:5]
+    return write, sensor, addr, count, status, bytes(values[5:5 + min(count, BMI_REGIO_MAX_LEN)])
+
+## @brief Causes d'un relevé de faute (fault_cause_t, fault_log.h)
+FAULT_CAUSE_NAMES = ("aucune", "chien de garde", "HardFault")
+FAULT_CAUSE_HARDFAULT = 2
+## @brief Champs de la trame de relevé de faute, hors registres (PROTO_LAYOUT_FAULT)
+FAULT_FIELDS = ('cause', 'task', 'count', 'uptime_ms', 'loops')
+FAULT_LINK_FIELDS = ('sp', 'rx_drop', 'tx_drop', 'rx_overrun', 'telem_seq')
+
+##
+# @brief Décode un relevé de faute persistant (type 0x11, REG_FAULT)
+# @param packet Trame complète
+# @return Dictionnaire des champs ; 'regs' : (r0, r1, r2, r3, r12, lr, pc, xpsr)
+def decode_fault(packet):
+    values = FRAME_FAULT.unpack_from(packet)[4:-1]
+    fault = dict(zip(FAULT_FIELDS, values[:5]))
+    fault['regs'] = values[5:13]
+    fault.update(zip(FAULT_LINK_FIELDS, values[13:]))
+    return fault
+
+##
+# @brief Débits série annoncés par une trame de capacités
+# @param caps Capacités (decode_caps)
+# @return Liste des débits, par code croissant
+def caps_baud_rates(caps):
+    return [b for code, b in enumerate(BAUD_RATES) if caps['bauds'] & (1 << code)]
+
+##
+# @brief Décode une trame du journal (type 0x08)
+# @param packet Trame complète [AA 55 08 LEN | SEQ | T_US | ID | N | ARGS i32 x N | CRC]
+# @return (numéro, date firmware µs, ID, liste des arguments)
+def decode_log(packet):
+    seq, t_us, log_id, n = struct.unpack_from('<HIBB', packet, 4)
+    n = min(n, (len(packet) - 13) // 4)
+    return seq, t_us, log_id, list(struct.unpack_from(f'<{n}i', packet, 12))
+
+##
+# @brief Décode un bloc de l'historique IMU (type 0x09)
+# @param packet Trame complète [AA 55 09 LEN | INDEX | TOTAL | TRIG | RANGES | COUNT | {T_US | 6 x int16} x COUNT | CRC]
+# @return (numéro du bloc, échantillons figés, rang du déclenchement, gammes, liste de (t_us, axes))
+def decode_hist_chunk(packet):
+    index, total, trig, ranges, count = struct.unpack_from('<HHHBB', packet, 4)
+    count = min(count, (len(packet) - 13) // 16)
+    samples = []
+    for i in range(count):
+        rec = struct.unpack_from('<I6h', packet, 12 + 16 * i)
+        samples.append((rec[0], list(rec[1:])))
+    return index, total, trig, ranges, samples
+
+##
+# @brief Décode un bloc compressé de l'historique IMU (type 0x0D)
+# Premier échantillon en clair puis, par échantillon, 7 résidus codés Rice (date en
+# différence seconde, six axes en différence simple), bits poids faible d'abord
+# @param packet Trame complète [AA 55 0D LEN | FIRST | TOTAL | TRIG | RANGES | COUNT | K x 7 | T_US | 6 x int16 | flux | CRC]
+# @return (rang du premier échantillon, échantillons figés, rang du déclenchement, gammes, liste de (t_us, axes))
+def decode_hist_packed(packet):
+    first, total, trig, ranges, count = struct.unpack_from('<HHHBB', packet, 4)
+    if count == 0:
+        return first, total, trig, ranges, []
+    ks = packet[12:19]
+    t_us, *axes = struct.unpack_from('<I6h', packet, 19)
+    samples = [(t_us, axes)]
+    bits = int.from_bytes(packet[35:-1], 'little')
+    pos = 0
+    dt = 0
+    for _ in range(count - 1):
+        res = []
+        for k in ks:
+            q = 0
+            while q < HIST_RICE_ESCAPE and (bits >> (pos + q)) & 1:
+                q += 1
+            if q == HIST_RICE_ESCAPE:
+                v = (bits >> (pos + q)) & 0xFFFFFFFF
+                pos += q + 32
+            else:
+                pos += q + 1
+                v = (q << k) | ((bits >> pos) & ((1 << k) - 1))
+                pos += k
+            res.append((v >> 1) ^ -(v & 1))
+        dt = (dt + res[0]) & 0xFFFFFFFF
+        t_us = (t_us + dt) & 0xFFFFFFFF
+        axes = [a + d for a, d in zip(axes, res[1:])]
+        samples.append((t_us, axes))
+    return first, total, trig, ranges, samples
+
+##
+# @brief Décode un rapport vibratoire (type 0x0A)
+# @param packet Trame complète [AA 55 0A LEN | T_US | FS_HZ | PEAK_DHZ | PEAK_MG | BAND_MG x 4 | AXIS | BLOCKS | CRC]
+# @return (date firmware µs, cadence Hz, raie dominante Hz, amplitude mg, valeurs efficaces par bande mg, axe, spectres)
+def decode_vib(packet):
+    t_us, fs_hz, peak_dhz, peak_mg = struct.unpack_from('<IHHH', packet, 4)
+    bands = list(struct.unpack_from('<4H', packet, 14))
+    axis, blocks = struct.unpack_from('<BB', packet, 22)
+    return t_us, fs_hz, peak_dhz / 10.0, peak_mg, bands, "XYZ"[axis] if axis < 3 else axis, blocks
+
+##
+# @brief Décode la pose lue en bloc à partir de REG_ODOM_BASE
+# @param values REG_ODOM_COUNT registres int16
+# @return (x en m, y en m, cap en °, distance cumulée en m)
+def decode_odom_pose(values):
+    dist_mm = (values[3] & 0xFFFF) | ((values[4] & 0xFFFF) << 16)
+    return values[0] / 100.0, values[1] / 100.0, values[2] / 100.0, dist_mm / 1000.0
+
+##
+# @brief Met en forme le résultat de l'auto-test IMU lu dans REG_BMI
+# @param value Registre (état | capteurs en échec << 8)
+def imu_selftest_text(value):
+    state, fail = value & 0xFF, (value >> 8) & 0xFF
+    text = IMU_SELFTEST_NAMES[state] if state < len(IMU_SELFTEST_NAMES) else str(state)
+    failed = [name for bit, name in enumerate(IMU_SELFTEST_FAIL_BITS) if fail & (1 << bit)]
+    return f"{text} ({', '.join(failed)})" if failed else text
+
+##
+# @brief Met en forme un point de journal
+# @param log_id Identifiant (dlog_id_t)
+# @param args Arguments entiers
+def format_log(log_id, args):
+    if log_id < len(LOG_FORMATS):
+        try:
+            return LOG_FORMATS[log_id](args)
+        except IndexError:
+            pass
+    return f"id{log_id} {args}"
+
+##
+# @brief Construit la table du CRC8 (Polynôme 0x07) : une entrée par valeur d'octet
+# @return Liste de 256 octets
+def _crc8_make_table():
+    table = []
+    for i in range(256):
+        crc = i
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+        table.append(crc)
+    return table
+
+## @brief Table du CRC8, calculée une fois au chargement
+CRC8_TABLE = _crc8_make_table()
 
 ##
 # @brief Calcule le CRC8 (Polynôme 0x07, Init 0x00)
-# @param data Liste des octets à traiter
+# @param data Octets à traiter (liste, bytes, bytearray ou memoryview)
 # @return L'octet de CRC calculé
 def crc8_atm(data):
     crc = 0x00
+    table = CRC8_TABLE
     for byte in data:
-        crc ^= byte
-        for _ in range(8):
-            if crc & 0x80:
-                crc = (crc << 1) ^ 0x07
-            else:
-                crc = (crc << 1)
-            crc &= 0xFF
+        crc = table[crc ^ byte]
     return crc
 
+##
+# @brief Découpe les trames complètes d'un tampon de réception
+# Trames IMU (0xAA 0x55, type, longueur), réponses synchronisées (0xA5, 5 octets),
+# lectures groupées (0xA6) et réponses historiques (4 octets, bit7 = 0). Un octet
+# qui n'ouvre pas de trame valide est sauté ; le tampon n'est pas modifié
+# @param buf Tampon de réception (bytearray)
+# @param emit Fonction appelée avec (nature, paquet) pour chaque trame valide
+# @return Nombre d'octets consommés en tête du tampon
+def split_frames(buf, emit):
+    n = len(buf)
+    pos = 0
+    with memoryview(buf) as mv:
+        while pos < n:
+            b0 = buf[pos]
+            # CAS 1 : Trame IMU (Start 0xAA 0x55), CRC sur tout sauf le dernier octet
+            if b0 == 0xAA:
+                if n - pos < 2: break
+                if buf[pos + 1] != 0x55:
+                    pos += 1
+                    continue
+                if n - pos < 4: break
+                # Taille totale = entête (4) + payload (len) + CRC (1)
+                end = pos + 4 + buf[pos + 3] + 1
+                if end > n: break
+                if crc8_atm(mv[pos:end - 1]) == buf[end - 1]:
+                    emit(FRAME_IMU, bytes(mv[pos:end]))
+                    pos = end
+                else:
+                    pos += 1
+
+            # CAS 2 : Réponse Commande synchronisée (Start 0xA5), paquet sans le SYNC
+            elif b0 == PROTO_SYNC:
+                end = pos + 5
+                if end > n: break
+                if crc8_atm(mv[pos + 1:end - 1]) == buf[end - 1]:
+                    emit(FRAME_CMD, bytes(mv[pos + 1:end]))
+                    pos = end
+                else:
+                    pos += 1
+
+            # CAS 3 : Réponse de lecture groupée (Start 0xA6), paquet sans le SYNC
+            elif b0 == PROTO_SYNC_BURST:
+                if n - pos < 3: break
+                count = buf[pos + 2]
+                if count == 0:
+                    pos += 1
+                    continue
+                end = pos + 4 + 2 * count
+                if end > n: break
+                if crc8_atm(mv[pos + 1:end - 1]) == buf[end - 1]:
+                    emit(FRAME_BURST, bytes(mv[pos + 1:end]))
+                    pos = end
+                else:
+                    pos += 1
+
+            # CAS 4 : Réponse Commande format historique (Header bit7=0)
+            elif (b0 & 0x80) == 0x00:
+                end = pos + 4
+                if end > n: break
+                if crc8_atm(mv[pos:end - 1]) == buf[end - 1]:
+                    emit(FRAME_CMD, bytes(mv[pos:end]))
+                    pos = end
+                else:
+                    pos += 1
+
+            # CAS 5 : Octet inconnu
+            else:
+                pos += 1
+    return pos
+
+## @brief Début de l'enveloppe commune des trames montantes
+ENV_SYNC = b'\xAA\x55'
+
+##
+# @brief Découpe les trames d'un flux entièrement enveloppé (CAPS_LINK_ENVELOPE)
+# Chaque trame est [0xAA 0x55 | type | longueur | payload | CRC] : une trame valide est
+# sautée d'un bloc d'après sa longueur, le recalage cherche la synchronisation suivante
+# (bytearray.find) au lieu d'avancer octet par octet
+# @param buf Tampon de réception (bytearray)
+# @param emit Fonction appelée avec (FRAME_IMU, trame) pour chaque trame valide
+# @return Nombre d'octets consommés en tête du tampon
+def split_envelopes(buf, emit):
+    n = len(buf)
+    pos = 0
+    with memoryview(buf) as mv:
+        while True:
+            pos = buf.find(ENV_SYNC, pos)
+            if pos < 0:
+                # Un 0xAA final peut ouvrir la trame suivante
+                return n - 1 if n and buf[n - 1] == 0xAA else n
+            if n - pos < 4:
+                return pos
+            end = pos + 4 + buf[pos + 3] + 1
+            if end > n:
+                return pos
+            if crc8_atm(mv[pos:end - 1]) == buf[end - 1]:
+                emit(FRAME_IMU, bytes(mv[pos:end]))
+                pos = end
+            else:
+                pos += 1
+
+##
+# @brief Décode un bloc COBS (sans son délimiteur 0x00)
+# Recopie par tranches : un code n annonce n-1 octets non nuls, suivis d'un 0x00 sauf
+# pour le code 0xFF et en fin de bloc
+# @param block Bloc encodé
+# @return Trame décodée, None si le bloc est invalide
+def cobs_decode(block):
+    out = bytearray()
+    n = len(block)
+    pos = 0
+    while pos < n:
+        code = block[pos]
+        end = pos + code
+        if code == 0 or end > n:
+            return None
+        out += block[pos + 1:end]
+        pos = end
+        if code != 0xFF and pos < n:
+            out.append(0)
+    return out
+
+##
+# @brief Vérifie qu'une trame décodée est une enveloppe complète [0xAA 0x55 | type | LEN | ... | CRC]
+def _is_envelope(frame):
+    return (frame is not None and len(frame) >= 5 and frame[:2] == ENV_SYNC
+            and len(frame) == frame[3] + 5 and crc8_atm(frame[:-1]) == frame[-1])
+
+##
+# @brief Découpe les trames d'un flux COBS (CAPS_LINK_COBS)
+# Le flux est coupé sur les délimiteurs 0x00 (bytes.split) ; chaque bloc décodé doit être
+# une enveloppe valide. Un bloc corrompu ne coûte que sa propre trame
+# @param buf Tampon de réception (bytearray)
+# @param emit Fonction appelée avec (FRAME_IMU, trame) pour chaque trame valide
+# @return Nombre d'octets consommés en tête du tampon
+def split_cobs(buf, emit):
+    last = buf.rfind(0)
+    if last < 0:
+        return 0
+    for block in bytes(buf[:last]).split(b'\x00'):
+        if block:
+            frame = cobs_decode(block)
+            if _is_envelope(frame):
+                emit(FRAME_IMU, bytes(frame))
+    return last + 1
+
+##
+# @brief Reconnaît un flux COBS avant réception des capacités (la trame de capacités
+# est elle-même encodée) : un bloc complet entre deux 0x00 qui décode en enveloppe valide
+# @param buf Tampon de réception
+# @return True si le flux est encodé COBS
+def probe_cobs(buf):
+    blocks = bytes(buf).split(b'\x00')[1:-1]
+    return any(_is_envelope(cobs_decode(b)) for b in blocks if b)
+
+##
+# @brief Construit une trame de commande synchronisée [SYNC | HDR | D0 | D1 | CRC]
+# @param hdr Octet d'entête (bit7 = R/W, bits6..0 = adresse)
+# @param d0 Premier octet de donnée
+# @param d1 Second octet de donnée
+# @return La trame prête à émettre
+def build_frame(hdr, d0, d1):
+    payload = [hdr & 0xFF, d0 & 0xFF, d1 & 0xFF]
+    return bytearray([PROTO_SYNC] + payload + [crc8_atm(payload)])
+
+##
+# @brief Construit une trame d'écriture groupée [SYNC_BURST | ADDR | COUNT | N x int16 | CRC]
+# @param addr Adresse du premier registre
+# @param values Liste des valeurs 16 bits signées (1 à 8)
+# @return La trame prête à émettre
+def build_burst_frame(addr, values):
+    payload = [addr & 0x7F, len(values)]
+    for v in values:
+        payload += [v & 0xFF, (v >> 8) & 0xFF]
+    return bytearray([PROTO_SYNC_BURST] + payload + [crc8_atm(payload)])
+
+##
+# @brief Construit les trames de téléversement d'une trajectoire, deux points par trame
+# @param points Liste de (date relative µs, braquage c°, vitesse mm/s), dates croissantes
+# @return Liste de trames groupées, à émettre après TRAJ_CMD_CLEAR et avant TRAJ_CMD_START
+def build_traj_frames(points):
+    frames = []
+    for i in range(0, len(points), 2):
+        values = []
+        for t_us, cdeg, mms in points[i:i + 2]:
+            values += [t_us & 0xFFFF, (t_us >> 16) & 0xFFFF, cdeg, mms]
+        frames.append(build_burst_frame(REG_TRAJ_PT_BASE, values))
+    return frames
+
+##
+# @brief Construit les trames d'accès direct à un registre IMU (REG_BMI)
+# @param gyro Capteur : gyroscope (True) ou accéléromètre
+# @param addr Adresse du premier registre
+# @param count Octets lus (1 à BMI_REGIO_MAX_LEN) ; ignoré en écriture
+# @param value Octet à écrire, ou None pour une simple lecture
+# @return Liste de trames : sélection et lecture, puis écriture et relecture le cas échéant
+def build_bmi_reg_frames(gyro, addr, count=1, value=None):
+    sel = BMI_REGIO_FLAG | (BMI_REGIO_GYRO if gyro else 0) | ((max(1, min(count, BMI_REGIO_MAX_LEN)) - 1) << 8) | (addr & 0x7F)
+    frames = [build_frame(REG_BMI & 0x7F, sel & 0xFF, sel >> 8)]
+    if value is not None:
+        wr = BMI_REGIO_FLAG | BMI_REGIO_WRITE | (value & 0xFF)
+        frames.append(build_frame(REG_BMI & 0x7F, wr & 0xFF, wr >> 8))
+    return frames
+
+##
+# @brief Construit la trame de commande cinématique (kin.h) : une trame par pas de contrôle
+# @param speed_mms Vitesse linéaire (mm/s)
+# @param curv_pkm Courbure (km⁻¹, positive à gauche) ; une vitesse de lacet r (mrad/s)
+# se ramène à r * 1000 / speed_mms
+# @return Trame groupée REG_KIN_SPEED, REG_KIN_CURV
+def build_kin_frame(speed_mms, curv_pkm):
+    clamp = lambda v: max(-32768, min(32767, int(v)))
+    return build_burst_frame(REG_KIN_SPEED, [clamp(speed_mms), clamp(curv_pkm)])
+
+##
+# @brief Construit les trames de rejeu d'un enregistrement (REG_REPLAY, replay.h)
+# Seules les trames brutes (compactes 0x04, lots delta 0x05) sont rejouées : les axes
+# y sont en LSB, comme à la sortie du capteur
+# @param recording Enregistrement ouvert (TelemRecording)
+# @return Liste de (écart µs avec l'échantillon précédent, trame groupée)
+def build_inject_frames(recording):
+    samples = []
+    for i in range(len(recording)):
+        _, kind, frame = recording.record(i)
+        if kind != FRAME_IMU:
+            continue
+        if frame[2] == TELEM_TYPE_COMPACT:
+            f = FRAME_COMPACT.unpack_from(frame)
+            samples.append((f[5], list(f[7:13]), f[13]))
+        elif frame[2] == TELEM_TYPE_DELTA:
+            ts, _, speed, batch = decode_delta_batch(frame[4:-1])
+            for dt, axes in batch:
+                ts = (ts + dt) & 0xFFFFFFFF
+                samples.append((ts, axes, speed))
+    frames = []
+    prev_ts = samples[0][0] if samples else 0
+    for ts, axes, speed in samples:
+        dt = min((ts - prev_ts) & 0xFFFFFFFF, 0xFFFF)
+        prev_ts = ts
+        frames.append((dt, build_burst_frame(REG_REPLAY, [dt] + axes + [speed])))
+    return frames
+
+##
+# @class TelemRecorder
+# @brief Écrit les trames validées dans un fichier binaire à enregistrements fixes
+# Fichier en ajout seul : un enregistrement interrompu en fin de fichier est ignoré à la lecture
+class TelemRecorder:
+
+    ##
+    # @brief Crée le fichier et écrit son entête
+    # @param path Chemin du fichier
+    def __init__(self, path):
+        self.path = path
+        self.count = 0
+        self.file = open(path, 'wb')
+        self.file.write(REC_FILE_HDR.pack(REC_MAGIC, REC_VERSION, REC_SIZE, 0))
+
+    ##
+    # @brief Ajoute une trame
+    # @param kind Nature (FRAME_IMU, FRAME_CMD, FRAME_BURST)
+    # @param packet Trame validée telle que remise par split_frames()
+    def write(self, kind, packet):
+        seq = ts = 0
+        if kind == FRAME_IMU and len(packet) >= 10:
+            seq, ts = struct.unpack_from('<HI', packet, 4)
+        record = bytearray(REC_SIZE)
+        REC_HDR.pack_into(record, 0, time.time_ns(), ts, seq, kind, len(packet))
+        record[REC_HDR.size:REC_HDR.size + len(packet)] = packet
+        self.file.write(record)
+        self.count += 1
+
+    ##
+    # @brief Vide les tampons et ferme le fichier
+    def close(self):
+        self.file.close()
+
+##
+# @class TelemRecording
+# @brief Lecture d'un enregistrement par projection mémoire (accès direct au i-ème enregistrement)
+class TelemRecording:
+
+    ##
+    # @brief Ouvre et vérifie un enregistrement
+    # @param path Chemin du fichier
+    def __init__(self, path):
+        self.file = open(path, 'rb')
+        try:
+            self.map = mmap.mmap(self.file.fileno(), 0, access=mmap.ACCESS_READ)
+        except ValueError:
+            self.file.close()
+            raise ValueError("enregistrement vide")
+        magic, version, rec_size, _ = REC_FILE_HDR.unpack_from(self.map, 0)
+        if magic != REC_MAGIC or version != REC_VERSION or rec_size != REC_SIZE:
+            self.close()
+            raise ValueError("format d'enregistrement inconnu")
+        self.count = (len(self.map) - REC_FILE_HDR.size) // REC_SIZE
+
+    def __len__(self):
+        return self.count
+
+    ##
+    # @brief Entête du i-ème enregistrement
+    # @return (t hôte ns, timestamp µs, séquence, nature, longueur)
+    def header(self, i):
+        return REC_HDR.unpack_from(self.map, REC_FILE_HDR.size + i * REC_SIZE)
+
+    ##
+    # @brief i-ème enregistrement complet
+    # @return (t hôte ns, nature, trame)
+    def record(self, i):
+        base = REC_FILE_HDR.size + i * REC_SIZE
+        host_ns, _, _, kind, length = REC_HDR.unpack_from(self.map, base)
+        start = base + REC_HDR.size
+        return host_ns, kind, self.map[start:start + length]
+
+    ##
+    # @brief Premier enregistrement à partir d'un instant hôte (recherche dichotomique)
+    # @param host_ns Instant hôte (ns)
+    # @return Indice du premier enregistrement tel que t hôte >= host_ns
+    def find_time(self, host_ns):
+        lo, hi = 0, self.count
+        while lo < hi:
+            mid = (lo + hi) // 2
+            if self.header(mid)[0] < host_ns:
+                lo = mid + 1
+            else:
+                hi = mid
+        return lo
+
+    def close(self):
+        self.map.close()
+        self.file.close()
+
+##
+# @brief Vérifie un enregistrement hors ligne : redécoupe les trames, suit les séquences
+# Les trames enregistrées sont concaténées et repassées dans split_frames(), comme à la
+# réception : un écart signale une régression du découpage ou du format
+# @param path Chemin du fichier
+# @return Dictionnaire de bilan
+def replay_summary(path):
+    rec = TelemRecording(path)
+    stats = {'records': len(rec), 'imu': 0, 'cmd': 0, 'burst': 0, 'mismatch': 0,
+             'lost': 0, 'types': {}, 'duration_s': 0.0}
+    names = {FRAME_IMU: 'imu', FRAME_CMD: 'cmd', FRAME_BURST: 'burst'}
+    seq_next = None
+    try:
+        for i in range(len(rec)):
+            _, kind, frame = rec.record(i)
+            # Réponses de commande rangées sans leur octet de synchronisation
+            raw = bytearray(frame)
+            if kind == FRAME_CMD:
+                raw.insert(0, PROTO_SYNC)
+            elif kind == FRAME_BURST:
+                raw.insert(0, PROTO_SYNC_BURST)
+            out = []
+            split_frames(raw, lambda k, p: out.append((k, p)))
+            if out != [(kind, frame)]:
+                stats['mismatch'] += 1
+                continue
+            stats[names[kind]] += 1
+            if kind == FRAME_IMU:
+                stats['types'][frame[2]] = stats['types'].get(frame[2], 0) + 1
+                if frame[2] in (TELEM_TYPE_ECHO, TELEM_TYPE_BENCH, TELEM_TYPE_LOG, TELEM_TYPE_HIST, TELEM_TYPE_VIB,
+                                TELEM_TYPE_CAPS, TELEM_TYPE_REG, TELEM_TYPE_HIST_PACKED, TELEM_TYPE_SNAP,
+                                TELEM_TYPE_STATUS, TELEM_TYPE_FW, TELEM_TYPE_FAULT, TELEM_TYPE_BMIREG):
+                    continue
+                (seq,) = struct.unpack_from('<H', frame, 4)
+                if seq_next is not None:
+                    stats['lost'] += (seq - seq_next) & 0xFFFF
+                seq_next = (seq + 1) & 0xFFFF
+        if len(rec) > 1:
+            stats['duration_s'] = (rec.header(len(rec) - 1)[0] - rec.header(0)[0]) / 1e9
+    finally:
+        rec.close()
+    return stats
+
+## @brief Disposition des deux consignes dans la trame groupée
+SETPOINT_PACK = struct.Struct('<hh')
+
+##
+# @class SetpointFrame
+# @brief Trame groupée servo + moteur préallouée (REG_SERVO_CMD, REG_MOTOR_CMD)
+# Les consignes sont écrites en place et le CRC recalculé par table sur une vue fixe :
+# aucune allocation par émission
+class SetpointFrame:
+    def __init__(self):
+        self.buf = build_burst_frame(REG_SERVO_CMD, [0, 0])
+        self.crc_view = memoryview(self.buf)[1:-1]
+
+    ##
+    # @brief Met à jour les consignes et le CRC
+    # @return Le tampon de la trame (réutilisé à chaque appel)
+    def update(self, servo, motor):
+        SETPOINT_PACK.pack_into(self.buf, 3, servo, motor)
+        self.buf[-1] = crc8_atm(self.crc_view)
+        return self.buf
+
+##
+# @class LinkScheduler
+# @brief Entretien de la liaison et émission des consignes sur un thread dédié
+# Les échéances sont tenues sur time.monotonic() (next += période, sans dérive) : la
+# charge de l'interface Tk ne décale plus les trames. Les consignes servo et moteur
+# (curseurs) sont regroupées : seules les dernières valeurs sont retenues et partent
+# ensemble dans une trame groupée, au plus une fois par SETPOINT_PERIOD_S, quel que soit
+# le rythme des rappels des curseurs. Une autre consigne (champs de saisie) part tout de
+# suite. Entre deux consignes, seule la trame minimale d'entretien (REG_HEARTBEAT) est
+# émise, la consigne n'étant réémise que toutes les COMMAND_REFRESH_S secondes
+class LinkScheduler:
+    ##
+    # @param write Fonction d'émission (bytes)
+    # @param period_s Période d'entretien (s)
+    def __init__(self, write, period_s=HEARTBEAT_PERIOD_S):
+        self.write = write
+        self.period_s = period_s
+        self.heartbeat = bytes(build_frame(REG_HEARTBEAT, 0, 0))
+        self.command = None
+        self.pending = False
+        self.setpoints = [0, 0]
+        self.setpoint_dirty = False
+        self.setpoint_frame = SetpointFrame()
+        self.lock = threading.Lock()
+        self.wake = threading.Event()
+        self.stop_evt = threading.Event()
+        self.thread = None
+        self.sent = 0
+        self.coalesced = 0
+        self.late_max_s = 0.0
+        self.error = None
+
+    ##
+    # @brief Remplace la consigne (émise dès le réveil du thread)
+    # @param frame Trame complète, None pour le seul entretien
+    def set_command(self, frame):
+        with self.lock:
+            self.command = bytes(frame) if frame is not None else None
+            self.pending = frame is not None
+        self.wake.set()
+
+    ##
+    # @brief Retient une consigne servo ou moteur, émise à la prochaine échéance de regroupement
+    # Elle devient la consigne entretenue (réémise toutes les COMMAND_REFRESH_S)
+    # @param servo Braquage (°), None : inchangé
+    # @param motor Vitesse (mm/s), None : inchangée
+    def set_setpoints(self, servo=None, motor=None):
+        with self.lock:
+            if self.setpoint_dirty:
+                self.coalesced += 1
+            if servo is not None:
+                self.setpoints[0] = servo
+            if motor is not None:
+                self.setpoints[1] = motor
+            self.setpoint_dirty = True
+            self.command = None
+            self.pending = False
+        self.wake.set()
+
+    def start(self):
+        self.stop_evt.clear()
+        self.thread = threading.Thread(target=self._run, name="link-scheduler", daemon=True)
+        self.thread.start()
+
+    def stop(self):
+        self.stop_evt.set()
+        self.wake.set()
+        if self.thread is not None:
+            self.thread.join(timeout=1.0)
+            self.thread = None
+
+    def _send(self, frame):
+        try:
+            self.write(frame)
+            self.sent += 1
+        except Exception as e:
+            self.error = e
+            self.stop_evt.set()
+
+    def _run(self):
+        deadline = time.monotonic()
+        refresh = deadline + COMMAND_REFRESH_S
+        setpoint_next = deadline
+        setpoint_active = False
+        while True:
+            wait_until = deadline
+            if self.setpoint_dirty:
+                wait_until = min(wait_until, setpoint_next)
+            self.wake.wait(max(0.0, wait_until - time.monotonic()))
+            self.wake.clear()
+            if self.stop_evt.is_set():
+                break
+            now = time.monotonic()
+            with self.lock:
+                command, pending = self.command, self.pending
+                self.pending = False
+                setpoint_due = self.setpoint_dirty and now >= setpoint_next
+                if setpoint_due:
+                    self.setpoint_dirty = False
+                    servo, motor = self.setpoints
+            if pending:
+                # Nouvelle consigne : émise hors échéance, l'échéancier n'est pas décalé
+                setpoint_active = False
+                self._send(command)
+                refresh = now + COMMAND_REFRESH_S
+            if setpoint_due:
+                setpoint_active = True
+                self._send(self.setpoint_frame.update(servo, motor))
+                setpoint_next = now + SETPOINT_PERIOD_S
+                refresh = now + COMMAND_REFRESH_S
+            if now < deadline:
+                continue
+
+            self.late_max_s = max(self.late_max_s, now - deadline)
+            if not pending and not setpoint_due:
+                if now >= refresh and setpoint_active:
+                    with self.lock:
+                        servo, motor = self.setpoints
+                    self._send(self.setpoint_frame.update(servo, motor))
+                    refresh = now + COMMAND_REFRESH_S
+                elif now >= refresh and command is not None:
+                    self._send(command)
+                    refresh = now + COMMAND_REFRESH_S
+                else:
+                    self._send(self.heartbeat)
+            deadline += self.period_s
+            if deadline <= now:
+                # Thread suspendu plus d'une période : reprise sur l'heure courante
+                deadline = now + self.period_s
+
 ##
 # @class SerialApp
 # @brief Classe principale de l'application graphique
@@ -36,23 +1073,63 @@ class SerialApp(ctk.CTk):
     ##
     # @brief Constructeur de l'application
     # Initialise la fenêtre, les variables et l'interface
-    def __init__(self):
+    # @param fleet Adresse "HÔTE:PORT" d'un démon de flotte dont les liens sont proposés (None : aucun)
+    def __init__(self, fleet=None):
         super().__init__()
 
         self.title("STM32 Robot Controller")
-        self.geometry("1100x720")
+        self.geometry("1100x960")
         
         self.ser = None
+        self.fleet = fleet
         self.is_connected = False
         self.read_thread = None
+        self.decode_thread = None
         self.stop_thread = False
         self.is_auto_sending = False
+        self.scheduler = None
         
-        self.rx_buffer = bytearray()
+        # Lecture -> décodage : file de trames ; décodage/Tk -> interface : file de logs
+        # et dernier texte IMU, consommés par _ui_poll() dans le thread Tk
+        self.rx_queue = queue.Queue(maxsize=RX_QUEUE_DEPTH)
+        self.rx_flush = False
+        self.log_queue = queue.SimpleQueue()
+        self.imu_text = None
+        self.imu_shown = None
+        # Dernière trame du flux d'état lent (type 0x0F), ajoutée au bas de l'affichage IMU
+        self.status_lines = []
+        # Échantillons de télémétrie pour le tracé : producteur = thread de décodage, lecteur = Tk
+        self.plot_ring = SampleRing()
         self.last_imu_update = 0
+        # Suivi des pertes de télémétrie via le numéro de séquence
+        self.telem_seq_next = None
+        self.telem_lost = 0
+        # Trames décodées (débit affiché) et trames jetées faute de place dans la file
+        self.telem_frames = 0
+        self.telem_frames_shown = 0
+        self.host_drop = 0
+        # Suivi des pertes du journal firmware (numéro propre au journal)
+        self.log_seq_next = None
+        # Enregistreur (alimenté par le thread de décodage) et relecture en cours
+        self.recorder = None
+        self.replay_thread = None
+        # Injection d'un enregistrement dans le firmware (mode rejeu)
+        self.inject_thread = None
+        # Téléchargement de l'historique IMU : dernier bloc reçu, signalé par hist_event
+        self.hist_thread = None
+        self.hist_reply = None
+        self.hist_event = threading.Event()
+        # Capacités annoncées par le firmware (None : pas encore reçues), appliquées à l'UI par _ui_poll
+        self.caps = None
+        self.caps_shown = None
+        # Flux entièrement enveloppé (annoncé par les capacités) : découpage par split_envelopes()
+        self.envelope = False
+        # Flux encodé COBS (reconnu par probe_cobs() ou annoncé par les capacités) : split_cobs()
+        self.cobs = False
 
         self._init_ui()
         self._refresh_ports()
+        self.ui_poll_id = self.after(UI_POLL_MS, self._ui_poll)
 
     ##
     # @brief Initialisation des composants graphiques
@@ -74,6 +1151,13 @@ class SerialApp(ctk.CTk):
         self.lbl_status = ctk.CTkLabel(self.frame_conn, text="Déconnecté", text_color="red")
         self.lbl_status.pack(side="left", padx=10)
 
+        self.btn_baud = ctk.CTkButton(self.frame_conn, text="Appliquer débit", width=120, command=self._change_baud)
+        self.btn_baud.pack(side="right", padx=5)
+
+        self.combo_baud = ctk.CTkComboBox(self.frame_conn, values=[str(b) for b in BAUD_RATES], width=110)
+        self.combo_baud.set(str(BAUD_RATES[0]))
+        self.combo_baud.pack(side="right", padx=5)
+
         # --- Section Commande Manuelle ---
         self.frame_cmd = ctk.CTkFrame(self)
         self.frame_cmd.pack(pady=5, padx=10, fill="x")
@@ -94,15 +1178,27 @@ class SerialApp(ctk.CTk):
         self.btn_send = ctk.CTkButton(self.frame_cmd, text="ENVOYER", command=self._send_frame)
         self.btn_send.grid(row=1, column=3, padx=5, pady=5)
 
-        self.btn_auto = ctk.CTkButton(self.frame_cmd, text="Heart Beat (100ms)", fg_color="orange", command=self._toggle_auto_send)
+        self.btn_auto = ctk.CTkButton(self.frame_cmd, text=HEARTBEAT_LABEL, fg_color="orange", command=self._toggle_auto_send)
         self.btn_auto.grid(row=1, column=4, padx=5, pady=5)
 
         self.btn_clear = ctk.CTkButton(self.frame_cmd, text="Clear Logs", fg_color="gray", width=80, command=self._clear_terminal)
         self.btn_clear.grid(row=1, column=5, padx=20, pady=5)
 
+        self.btn_record = ctk.CTkButton(self.frame_cmd, text="Enregistrer", fg_color="gray", width=100, command=self._toggle_record)
+        self.btn_record.grid(row=1, column=6, padx=5, pady=5)
+
+        self.btn_replay = ctk.CTkButton(self.frame_cmd, text="Rejouer", fg_color="gray", width=80, command=self._start_replay)
+        self.btn_replay.grid(row=1, column=7, padx=5, pady=5)
+
+        self.btn_hist = ctk.CTkButton(self.frame_cmd, text="Historique", fg_color="gray", width=90, command=self._start_hist_download)
+        self.btn_hist.grid(row=1, column=8, padx=5, pady=5)
+
+        self.btn_inject = ctk.CTkButton(self.frame_cmd, text="Injecter", fg_color="gray", width=80, command=self._start_inject)
+        self.btn_inject.grid(row=1, column=9, padx=5, pady=5)
+
         # Ligne 2 : Info bulle
         self.lbl_rw_info = ctk.CTkLabel(self.frame_cmd, text="", text_color="gray", font=("Arial", 11))
-        self.lbl_rw_info.grid(row=2, column=0, columnspan=6, padx=5, pady=(0, 5), sticky="w")
+        self.lbl_rw_info.grid(row=2, column=0, columnspan=10, padx=5, pady=(0, 5), sticky="w")
 
         # --- Section Pilotage Direct ---
         self.frame_pilot = ctk.CTkFrame(self)
@@ -143,6 +1239,11 @@ class SerialApp(ctk.CTk):
         self.txt_imu.grid(row=1, column=1, padx=5, pady=5, sticky="nsew")
         self.txt_imu.configure(state="disabled", font=("Consolas", 14))
 
+        # Tracé de tous les échantillons reçus (anneau rempli par le thread de décodage)
+        self.plot = TelemPlot(self.frame_split, self.plot_ring, height=260)
+        self.plot.grid(row=2, column=0, columnspan=2, padx=5, pady=5, sticky="nsew")
+        self.plot.start()
+
     ##
     # @brief Met à jour l'affichage selon le mode Read/Write sélectionné
     def _update_rw_mode(self):
@@ -157,6 +1258,9 @@ class SerialApp(ctk.CTk):
     # @brief Rafraîchit la liste des ports COM disponibles
     def _refresh_ports(self):
         ports_list = [p.device for p in serial.tools.list_ports.comports()]
+        if self.fleet:
+            host, port, _ = parse_fleet_url(FLEET_SCHEME + self.fleet)
+            ports_list += FleetLink.list_links(host, port)
         if not ports_list:
             self.combo_ports.configure(values=["Aucun port"])
         else:
@@ -173,54 +1277,127 @@ class SerialApp(ctk.CTk):
         if not self.is_connected:
             port = self.combo_ports.get()
             if port == "Aucun port": return
+            if self.replay_thread is not None and self.replay_thread.is_alive():
+                self._log_cmd("Erreur: Relecture en cours")
+                return
             
             try:
-                self.ser = serial.Serial(port, 115200, timeout=0.1)
+                if port.startswith(FLEET_SCHEME):
+                    self.ser = FleetLink(port)
+                else:
+                    self.ser = serial.Serial(port, BAUD_RATES[0], timeout=0.1)
                 self.is_connected = True
                 self.btn_connect.configure(text="Déconnexion", fg_color="red")
                 self.lbl_status.configure(text=f"Connecté à {port}", text_color="green")
                 
-                self.rx_buffer = bytearray()
+                self.rx_queue = queue.Queue(maxsize=RX_QUEUE_DEPTH)
+                self.rx_flush = False
                 self.stop_thread = False
-                self.read_thread = threading.Thread(target=self._read_serial_loop)
+                self.decode_thread = threading.Thread(target=self._decode_loop, daemon=True)
+                self.decode_thread.start()
+                self.read_thread = threading.Thread(target=self._read_serial_loop, daemon=True)
                 self.read_thread.start()
+
+                # Consigne nulle : réarme le moteur si le failsafe l'a désarmé
+                self.ser.write(build_frame(REG_MOTOR_CMD, 0, 0))
+                # Capacités du firmware : une seule trame type 0x0B au lieu de sonder
+                self.caps = None
+                self.envelope = False
+                self.cobs = False
+                self.ser.write(build_frame(REG_CAPS, 0, 0))
                 
             except Exception as e:
                 self._log_cmd(f"Erreur connexion: {e}")
         else:
-            self.is_auto_sending = False
-            self.btn_auto.configure(text="Heart Beat (100ms)", fg_color="orange")
-            self.stop_thread = True
+            self._stop_auto_send()
+            self._stop_threads()
             if self.ser:
                 self.ser.close()
             self.is_connected = False
             self.btn_connect.configure(text="Connexion", fg_color="green")
             self.lbl_status.configure(text="Déconnecté", text_color="red")
 
+    ##
+    # @brief Négocie un nouveau débit avec le STM32
+    # Écrit le code dans REG_BAUD à l'ancien débit, attend l'acquittement, bascule
+    # le port puis confirme par une lecture de REG_BAUD (le STM32 revient à 115200
+    # bauds sans confirmation sous 1 s)
+    def _change_baud(self):
+        if not self.is_connected or not self.ser:
+            self._log_cmd("Erreur: Non connecté")
+            return
+
+        try:
+            baud = int(self.combo_baud.get())
+            code = BAUD_RATES.index(baud)
+        except ValueError:
+            self._log_cmd("Erreur: Débit non supporté")
+            return
+
+        if baud == self.ser.baudrate:
+            return
+
+        try:
+            self.ser.write(build_frame(REG_BAUD & 0x7F, code, 0))
+            self.ser.flush()
+            time.sleep(0.05)
+
+            self.ser.baudrate = baud
+            self.rx_flush = True
+            time.sleep(0.01)
+
+            self.ser.write(build_frame(0x80 | REG_BAUD, 1, 0))
+
+            self._log_cmd(f"Débit série : {baud} bauds")
+            self.lbl_status.configure(text=f"Connecté à {self.ser.port} ({baud})", text_color="green")
+        except Exception as e:
+            self._log_cmd(f"Erreur changement débit: {e}")
+
     ##
     # @brief Active ou désactive l'envoi automatique (Heart Beat)
-    def _toggle_auto_send(self):
+    # La consigne des champs de saisie est confiée à l'ordonnanceur de liaison (thread
+    # dédié) qui l'entretient à HEARTBEAT_PERIOD_S ; à l'arrêt, plus rien n'est émis et
+    # le failsafe du firmware reprend la main
+    # @param send_entry Émet la consigne des champs de saisie au démarrage (False : consigne des curseurs)
+    def _toggle_auto_send(self, send_entry=True):
         if not self.is_connected:
             self._log_cmd("Erreur: Non connecté")
             return
 
         if not self.is_auto_sending:
+            self.scheduler = LinkScheduler(lambda data: self.ser.write(data))
+            self.scheduler.start()
             self.is_auto_sending = True
             self.btn_auto.configure(text="STOP Auto", fg_color="red")
-            self._auto_send_loop()
+            if send_entry:
+                self._send_frame()
+            self._watch_scheduler()
         else:
-            self.is_auto_sending = False
-            self.btn_auto.configure(text="Heart Beat (100ms)", fg_color="orange")
+            self._stop_auto_send()
 
     ##
-    # @brief Boucle d'envoi automatique (Thread non-bloquant via .after)
-    def _auto_send_loop(self):
-        if self.is_auto_sending and self.is_connected:
-            self._send_frame()
-            self.after(100, self._auto_send_loop)
-        else:
-            self.is_auto_sending = False
-            self.btn_auto.configure(text="Heart Beat (100ms)", fg_color="orange")
+    # @brief Arrête l'ordonnanceur de liaison et rapporte sa tenue des échéances
+    def _stop_auto_send(self):
+        self.is_auto_sending = False
+        self.btn_auto.configure(text=HEARTBEAT_LABEL, fg_color="orange")
+        if self.scheduler is not None:
+            self.scheduler.stop()
+            self._log_cmd(f"Heart Beat : {self.scheduler.sent} trames, "
+                          f"{self.scheduler.coalesced} consignes regroupées, "
+                          f"retard max {self.scheduler.late_max_s * 1000:.1f} ms")
+            if self.scheduler.error is not None:
+                self._log_cmd(f"Erreur envoi: {self.scheduler.error}")
+            self.scheduler = None
+
+    ##
+    # @brief Surveille l'ordonnanceur (arrêt sur erreur d'émission ou déconnexion)
+    def _watch_scheduler(self):
+        if not self.is_auto_sending:
+            return
+        if not self.is_connected or self.scheduler is None or self.scheduler.stop_evt.is_set():
+            self._stop_auto_send()
+            return
+        self.after(500, self._watch_scheduler)
 
     ##
     # @brief Construit et envoie la trame série basée sur les champs de saisie
@@ -259,11 +1436,18 @@ class SerialApp(ctk.CTk):
                 d0 = data_val & 0xFF        
                 d1 = (data_val >> 8) & 0xFF 
 
-            payload = [hdr, d0, d1]
-            crc = crc8_atm(payload)
-            frame = bytearray(payload + [crc])
+            frame = build_frame(hdr, d0, d1)
 
-            self.ser.write(frame)
+            if self.is_auto_sending and self.scheduler is not None and not is_read and addr in (REG_SERVO_CMD, REG_MOTOR_CMD):
+                # Consigne servo / moteur : regroupée avec celle des curseurs
+                if addr == REG_SERVO_CMD:
+                    self.scheduler.set_setpoints(servo=data_val)
+                else:
+                    self.scheduler.set_setpoints(motor=data_val)
+            elif self.is_auto_sending and self.scheduler is not None:
+                self.scheduler.set_command(frame)
+            else:
+                self.ser.write(frame)
             
             hex_frame = " ".join([f"{b:02X}" for b in frame])
             mode_str = "READ" if is_read else "WRITE"
@@ -276,51 +1460,35 @@ class SerialApp(ctk.CTk):
         except Exception as e:
             self._log_cmd(f"Erreur envoi: {e}")
 
+    ##
+    # @brief Remet une consigne de curseur à l'ordonnanceur de liaison (regroupement)
+    # Active le Heart Beat si éteint ; rien n'est construit ni émis ici : un glissement
+    # produit des dizaines de rappels par seconde, une seule trame part par SETPOINT_PERIOD_S
+    # @param servo Braquage (°), None : inchangé
+    # @param motor Vitesse (mm/s), None : inchangée
+    def _post_setpoints(self, servo=None, motor=None):
+        if not self.is_auto_sending:
+            if not self.is_connected:
+                return
+            self._toggle_auto_send(send_entry=False)
+        if self.scheduler is not None:
+            self.scheduler.set_setpoints(servo=servo, motor=motor)
+
     ##
     # @brief Callback du slider Servo
-    # Met à jour les champs manuels et force l'activation du Heart Beat
     # @param value Valeur du slider (float)
     def _on_servo_slide(self, value):
         angle = int(value)
         self.lbl_servo.configure(text=f"Servo: {angle}°")
-        
-        # Mise à jour des champs de texte pour que le Heart Beat envoie la bonne valeur
-        self.entry_reg.delete(0, "end")
-        self.entry_reg.insert(0, "00") # Reg Servo
-        self.entry_data.delete(0, "end")
-        self.entry_data.insert(0, str(angle))
-
-        # Force le mode WRITE si on était en READ
-        if self.switch_rw.get() == 1:
-            self.switch_rw.toggle()
-            self._update_rw_mode()
-        
-        # Active le Heart Beat si éteint
-        if not self.is_auto_sending:
-            self._toggle_auto_send()
+        self._post_setpoints(servo=angle)
 
     ##
     # @brief Callback du slider Moteur
-    # Met à jour les champs manuels et force l'activation du Heart Beat
     # @param value Valeur du slider (float)
     def _on_motor_slide(self, value):
         speed = int(value)
         self.lbl_motor.configure(text=f"Moteur: {speed} mm/s")
-        
-        # 1. Mise à jour des champs de texte
-        self.entry_reg.delete(0, "end")
-        self.entry_reg.insert(0, "01") # Reg Moteur
-        self.entry_data.delete(0, "end")
-        self.entry_data.insert(0, str(speed))
-
-        # 2. Force le mode WRITE
-        if self.switch_rw.get() == 1:
-            self.switch_rw.toggle()
-            self._update_rw_mode()
-
-        # 3. Active le Heart Beat si éteint
-        if not self.is_auto_sending:
-            self._toggle_auto_send()
+        self._post_setpoints(motor=speed)
 
     ##
     # @brief Procédure d'arrêt d'urgence
@@ -340,83 +1508,401 @@ class SerialApp(ctk.CTk):
         self.entry_data.delete(0, "end")
         self.entry_data.insert(0, "0")
         
-        # On force le Heart Beat pour envoyer l'arrêt en boucle
-        if not self.is_auto_sending:
-            self._toggle_auto_send()
+        # Servo et moteur remis à zéro dans une seule trame groupée
+        if self.is_connected and self.ser:
+            try:
+                self.ser.write(build_burst_frame(0x00, [0, 0]))
+            except Exception as e:
+                self._log_cmd(f"Erreur envoi: {e}")
+
+        # On force le Heart Beat pour entretenir l'arrêt
+        self._post_setpoints(servo=0, motor=0)
             
         self._log_cmd("!!! ARU SEND !!!")
 
     ##
     # @brief Thread de lecture du port série
-    # Décode les trames IMU (37 octets) et les réponses Commandes (4 octets)
+    # Lecture bloquante (délai du port : 0,1 s) de tout ce qui est disponible, découpage
+    # des trames par split_frames() puis remise au thread de décodage via rx_queue.
+    # Le tampon n'est compacté qu'une fois par bloc lu
     def _read_serial_loop(self):
-        IMU_SIZE = 37 
-        CMD_SIZE = 4
+        buf = bytearray()
+        rx_queue = self.rx_queue
+
+        def emit(kind, packet):
+            try:
+                rx_queue.put_nowait((kind, packet))
+            except queue.Full:
+                self.host_drop += 1
+
+        # Lien du démon de flotte : trames déjà découpées et vérifiées par le démon
+        if isinstance(self.ser, FleetLink):
+            while not self.stop_thread and self.ser.is_open:
+                try:
+                    for kind, packet in self.ser.read_frames():
+                        emit(kind, packet)
+                except OSError:
+                    break
+            rx_queue.put(None)
+            return
 
         while not self.stop_thread and self.ser and self.ser.is_open:
             try:
-                if self.ser.in_waiting > 0:
-                    data = self.ser.read(self.ser.in_waiting)
-                    self.rx_buffer.extend(data)
-                    
-                    while len(self.rx_buffer) > 0:
-                        # CAS 1 : Trame IMU (Start 0xAA 0x55)
-                        if self.rx_buffer[0] == 0xAA:
-                            if len(self.rx_buffer) < 2: break
-                            if self.rx_buffer[1] == 0x55:
-                                if len(self.rx_buffer) < IMU_SIZE: break
-                                packet = self.rx_buffer[:IMU_SIZE]
-                                if crc8_atm(packet[:-1]) == packet[-1]:
-                                    self._decode_and_show_imu(packet)
-                                    del self.rx_buffer[:IMU_SIZE]
-                                    continue
-                                else:
-                                    del self.rx_buffer[:1]
-                                    continue
-                            else:
-                                del self.rx_buffer[:1]
-                                continue
-                        
-                        # CAS 2 : Réponse Commande (Header bit7=0)
-                        elif (self.rx_buffer[0] & 0x80) == 0x00:
-                            if len(self.rx_buffer) < CMD_SIZE: break
-                            packet = self.rx_buffer[:CMD_SIZE]
-                            if crc8_atm(packet[:-1]) == packet[-1]:
-                                self._decode_and_log_cmd(packet)
-                                del self.rx_buffer[:CMD_SIZE]
-                                continue
-                            else:
-                                del self.rx_buffer[:1]
-                                continue
-
-                        # CAS 3 : Octet inconnu
-                        else:
-                            del self.rx_buffer[:1]
-                else:
-                    time.sleep(0.005)
+                data = self.ser.read(max(1, self.ser.in_waiting))
             except Exception:
                 break
+            if self.rx_flush:
+                self.rx_flush = False
+                buf.clear()
+            if not data:
+                continue
+            buf.extend(data)
+            if not self.cobs and self.caps is None and 0 in data and probe_cobs(buf):
+                self.cobs = True
+            if self.cobs:
+                used = split_cobs(buf, emit)
+            else:
+                used = (split_envelopes if self.envelope else split_frames)(buf, emit)
+            if used:
+                del buf[:used]
+
+        rx_queue.put(None)
+
+    ##
+    # @brief Thread de décodage : consomme rx_queue jusqu'à la sentinelle None
+    # Toutes les trames IMU passent par le suivi de séquence ; seul le texte affiché
+    # est limité à 10 Hz
+    def _decode_loop(self):
+        rx_queue = self.rx_queue
+        while True:
+            item = rx_queue.get()
+            if item is None:
+                break
+            kind, packet = item
+            recorder = self.recorder
+            if recorder is not None:
+                try:
+                    recorder.write(kind, packet)
+                except (OSError, ValueError):
+                    self.recorder = None
+                    self._log_cmd(f"Erreur enregistrement: {recorder.path}")
+            if kind == FRAME_IMU and packet[2] == TELEM_TYPE_ECHO:
+                self._decode_and_log_echo(packet)
+            elif kind == FRAME_IMU and packet[2] == TELEM_TYPE_BENCH:
+                self._decode_and_log_bench(packet)
+            elif kind == FRAME_IMU and packet[2] == TELEM_TYPE_LOG:
+                self._decode_and_log_log(packet)
+            elif kind == FRAME_IMU and packet[2] == TELEM_TYPE_HIST:
+                self.hist_reply = decode_hist_chunk(packet)
+                self.hist_event.set()
+            elif kind == FRAME_IMU and packet[2] == TELEM_TYPE_HIST_PACKED:
+                self.hist_reply = decode_hist_packed(packet)
+                self.hist_event.set()
+            elif kind == FRAME_IMU and packet[2] == TELEM_TYPE_VIB:
+                self._decode_and_log_vib(packet)
+            elif kind == FRAME_IMU and packet[2] == TELEM_TYPE_CAPS:
+                self._decode_and_log_caps(packet)
+            elif kind == FRAME_IMU and packet[2] == TELEM_TYPE_SNAP:
+                self._decode_and_log_snapshot(packet)
+            elif kind == FRAME_IMU and packet[2] == TELEM_TYPE_FAULT:
+                self._decode_and_log_fault(packet)
+            elif kind == FRAME_IMU and packet[2] == TELEM_TYPE_BMIREG:
+                self._decode_and_log_bmireg(packet)
+            elif kind == FRAME_IMU and packet[2] == TELEM_TYPE_STATUS:
+                _, fields, values = decode_fields(packet)
+                self.status_lines = ["", f"--- ÉTAT (0x{fields:02X}) ---"] + telem_field_lines(values)
+            elif kind == FRAME_IMU and packet[2] == TELEM_TYPE_REG:
+                # Réponse enveloppée : même payload qu'une lecture groupée [HDR | COUNT | N x int16 | CRC]
+                self._decode_and_log_burst(packet[4:])
+            elif kind == FRAME_IMU:
+                self._decode_and_show_imu(packet)
+            elif kind == FRAME_CMD:
+                self._decode_and_log_cmd(packet)
+            else:
+                self._decode_and_log_burst(packet)
+
+    ##
+    # @brief Démarre ou arrête l'enregistrement des trames reçues
+    def _toggle_record(self):
+        if self.recorder is None:
+            path = filedialog.asksaveasfilename(defaultextension=".tlm", filetypes=[("Télémétrie", "*.tlm")])
+            if not path: return
+            try:
+                self.recorder = TelemRecorder(path)
+            except OSError as e:
+                self._log_cmd(f"Erreur enregistrement: {e}")
+                return
+            self.btn_record.configure(text="STOP Enreg.", fg_color="red")
+            self._log_cmd(f"Enregistrement : {path}")
+        else:
+            recorder, self.recorder = self.recorder, None
+            # Laisse le thread de décodage terminer l'écriture en cours
+            time.sleep(0.05)
+            recorder.close()
+            self.btn_record.configure(text="Enregistrer", fg_color="gray")
+            self._log_cmd(f"Enregistrement terminé : {recorder.count} trames")
+
+    ##
+    # @brief Relit un enregistrement à travers le décodeur (hors connexion)
+    def _start_replay(self):
+        if self.is_connected:
+            self._log_cmd("Erreur: Déconnecter avant de rejouer")
+            return
+        if self.replay_thread is not None and self.replay_thread.is_alive():
+            return
+        path = filedialog.askopenfilename(filetypes=[("Télémétrie", "*.tlm"), ("Tous", "*")])
+        if not path: return
+        try:
+            recording = TelemRecording(path)
+        except (OSError, ValueError) as e:
+            self._log_cmd(f"Erreur relecture: {e}")
+            return
+
+        self.telem_seq_next = None
+        self.telem_lost = 0
+        self.stop_thread = False
+        self.rx_queue = queue.Queue(maxsize=RX_QUEUE_DEPTH)
+        self.decode_thread = threading.Thread(target=self._decode_loop, daemon=True)
+        self.decode_thread.start()
+        self.replay_thread = threading.Thread(target=self._replay_loop, args=(recording, REPLAY_SPEED), daemon=True)
+        self.replay_thread.start()
+        self._log_cmd(f"Relecture x{REPLAY_SPEED:g} : {len(recording)} trames")
+
+    ##
+    # @brief Thread de relecture : cadence les trames selon l'heure hôte enregistrée
+    # @param recording Enregistrement ouvert (refermé en fin de relecture)
+    # @param speed Facteur d'accélération (0 : au plus vite)
+    def _replay_loop(self, recording, speed):
+        rx_queue = self.rx_queue
+        start = time.perf_counter()
+        t0 = recording.header(0)[0] if len(recording) else 0
+        try:
+            for i in range(len(recording)):
+                if self.stop_thread: break
+                host_ns, kind, frame = recording.record(i)
+                if speed > 0:
+                    delay = (host_ns - t0) / 1e9 / speed - (time.perf_counter() - start)
+                    if delay > 0:
+                        time.sleep(delay)
+                rx_queue.put((kind, frame))
+        finally:
+            rx_queue.put(None)
+            recording.close()
+        self._log_cmd(f"Relecture terminée en {time.perf_counter() - start:.1f} s")
+
+    ##
+    # @brief Rejoue un enregistrement brut dans le firmware connecté (mode rejeu, REG_REPLAY)
+    # Les gammes capteur configurées doivent être celles de l'enregistrement
+    def _start_inject(self):
+        if not self.is_connected or not self.ser:
+            self._log_cmd("Erreur: Non connecté")
+            return
+        if self.inject_thread is not None and self.inject_thread.is_alive():
+            return
+        path = filedialog.askopenfilename(filetypes=[("Télémétrie", "*.tlm"), ("Tous", "*")])
+        if not path: return
+        try:
+            recording = TelemRecording(path)
+        except (OSError, ValueError) as e:
+            self._log_cmd(f"Erreur injection: {e}")
+            return
+        try:
+            frames = build_inject_frames(recording)
+        finally:
+            recording.close()
+        if not frames:
+            self._log_cmd("Erreur injection: aucune trame compacte ou delta")
+            return
+        self.inject_thread = threading.Thread(target=self._inject_loop, args=(frames,), daemon=True)
+        self.inject_thread.start()
+
+    ##
+    # @brief Thread d'injection : cadence les enregistrements selon leurs écarts enregistrés
+    # Le nombre d'échantillons publiés (lecture de REG_REPLAY) est demandé avant l'arrêt
+    # @param frames Liste de (écart µs, trame groupée) issue de build_inject_frames()
+    def _inject_loop(self, frames):
+        self._log_cmd(f"Injection : {len(frames)} échantillons")
+        start = time.perf_counter()
+        t_us = 0
+        try:
+            self.ser.write(build_frame(REG_REPLAY, REPLAY_CMD_START, 0))
+            for dt, frame in frames:
+                if self.stop_thread or not self.ser: break
+                t_us += dt
+                delay = t_us / 1e6 - (time.perf_counter() - start)
+                if delay > 0:
+                    time.sleep(delay)
+                self.ser.write(frame)
+            self.ser.write(build_frame(0x80 | REG_REPLAY, 1, 0))
+            self.ser.write(build_frame(REG_REPLAY, REPLAY_CMD_STOP, 0))
+        except (serial.SerialException, OSError, AttributeError) as e:
+            self._log_cmd(f"Injection : erreur {e}")
+            return
+        self._log_cmd(f"Injection terminée en {time.perf_counter() - start:.1f} s")
+
+    ##
+    # @brief Télécharge l'historique IMU figé vers un fichier CSV
+    def _start_hist_download(self):
+        if not self.is_connected or not self.ser:
+            self._log_cmd("Erreur: Non connecté")
+            return
+        if self.hist_thread is not None and self.hist_thread.is_alive():
+            return
+        path = filedialog.asksaveasfilename(defaultextension=".csv", filetypes=[("CSV", "*.csv")])
+        if not path: return
+        self.hist_thread = threading.Thread(target=self._hist_download_loop, args=(path,), daemon=True)
+        self.hist_thread.start()
+
+    ##
+    # @brief Demande un bloc de l'historique et attend sa réponse
+    # @param index Numéro du bloc, ou rang du premier échantillon si packed
+    # @param packed Bloc compressé (type 0x0D) au lieu du bloc brut
+    # @return Bloc décodé (decode_hist_chunk / decode_hist_packed) ou None après HIST_RETRIES essais
+    def _hist_request(self, index, packed=False):
+        arg = (index | HIST_CHUNK_PACKED) if packed else index
+        for _ in range(HIST_RETRIES):
+            if self.stop_thread or not self.ser: break
+            self.hist_event.clear()
+            self.ser.write(build_frame(REG_HIST_CHUNK, arg & 0xFF, (arg >> 8) & 0xFF))
+            if self.hist_event.wait(HIST_TIMEOUT_S) and self.hist_reply[0] == index:
+                return self.hist_reply
+        return None
+
+    ##
+    # @brief Thread de téléchargement : un bloc à la fois, puis écriture du CSV
+    # Blocs compressés si le firmware annonce la trame type 0x0D : la suite est demandée
+    # à partir du dernier échantillon reçu (nombre d'échantillons variable par trame)
+    # Colonnes : rang, date firmware (µs), axes bruts, axes convertis (mm/s², rad/s), déclenchement
+    # @param path Fichier de sortie
+    def _hist_download_loop(self, path):
+        start = time.perf_counter()
+        rows = []
+        index = 0
+        total = trig = ranges = 0
+        packed = bool(self.caps and self.caps['types'] & (1 << TELEM_TYPE_HIST_PACKED))
+        try:
+            while True:
+                reply = self._hist_request(len(rows) if packed else index, packed)
+                if reply is None:
+                    self._log_cmd(f"Historique : bloc {index} sans réponse, abandon")
+                    return
+                _, total, trig, ranges, samples = reply
+                if total == 0:
+                    self._log_cmd("Historique : non figé (déclencher via REG_HIST_CMD = 1)")
+                    return
+                if not samples:
+                    self._log_cmd(f"Historique : bloc {index} vide, abandon")
+                    return
+                rows.extend(samples)
+                index += 1
+                if (len(rows) if packed else index * HIST_CHUNK) >= total:
+                    break
+        except (serial.SerialException, OSError) as e:
+            self._log_cmd(f"Historique : erreur {e}")
+            return
+        try:
+            with open(path, 'w') as f:
+                f.write("n,t_us,ax,ay,az,gx,gy,gz,ax_mms2,ay_mms2,az_mms2,gx_rads,gy_rads,gz_rads,trigger\n")
+                for n, (t_us, axes) in enumerate(rows):
+                    acc, gyr = scale_raw_axes(axes, ranges)
+                    f.write(f"{n},{t_us},{','.join(str(a) for a in axes)},"
+                            f"{','.join(f'{v:.1f}' for v in acc)},{','.join(f'{v:.5f}' for v in gyr)},"
+                            f"{1 if n == trig else 0}\n")
+        except OSError as e:
+            self._log_cmd(f"Historique : erreur écriture {e}")
+            return
+        self._log_cmd(f"Historique : {len(rows)} échantillons (déclenchement au rang {trig}) en "
+                      f"{time.perf_counter() - start:.1f} s -> {path}")
+
+    ##
+    # @brief Arrête les threads de lecture et de décodage (avant fermeture du port)
+    def _stop_threads(self):
+        self.stop_thread = True
+        for thread in (self.read_thread, self.replay_thread, self.decode_thread):
+            if thread is not None and thread is not threading.current_thread():
+                thread.join(timeout=1.0)
+        self.read_thread = None
+        self.replay_thread = None
+        self.decode_thread = None
+
+    ##
+    # @brief Rafraîchissement périodique de l'interface (thread Tk)
+    # Vide la file de logs par lots et affiche le dernier texte IMU produit
+    def _ui_poll(self):
+        lines = []
+        try:
+            while len(lines) < UI_LOG_BATCH:
+                lines.append(self.log_queue.get_nowait())
+        except queue.Empty:
+            pass
+        if lines:
+            self.txt_log.configure(state="normal")
+            self.txt_log.insert("end", "\n".join(lines) + "\n")
+            self.txt_log.see("end")
+            self.txt_log.configure(state="disabled")
+
+        text = self.imu_text
+        if text is not None and text is not self.imu_shown:
+            self.imu_shown = text
+            self.txt_imu.configure(state="normal")
+            self.txt_imu.delete("1.0", "end")
+            self.txt_imu.insert("end", text)
+            self.txt_imu.configure(state="disabled")
+
+        caps = self.caps
+        if caps is not None and caps is not self.caps_shown:
+            self.caps_shown = caps
+            # Débits proposés limités à ceux du firmware, le plus rapide présélectionné
+            rates = caps_baud_rates(caps) or BAUD_RATES[:1]
+            self.combo_baud.configure(values=[str(b) for b in rates])
+            self.combo_baud.set(str(rates[-1]))
+
+        self.ui_poll_id = self.after(UI_POLL_MS, self._ui_poll)
+
+    ##
+    # @brief Lignes de bilan communes aux affichages de télémétrie
+    # @param now Instant courant (s)
+    # @return Liste de lignes (pertes firmware, débit décodé, pertes hôte)
+    def _telem_footer(self, now):
+        dt = now - self.last_imu_update
+        rate = (self.telem_frames - self.telem_frames_shown) / dt if dt > 0 else 0.0
+        self.telem_frames_shown = self.telem_frames
+        return [f"TRAMES PERDUES : {self.telem_lost}",
+                f"DÉBIT : {rate:.0f} trames/s",
+                f"PERTES HÔTE : {self.host_drop}"] + self.status_lines
 
     ##
     # @brief Décode et affiche les données IMU
-    # @param packet Le paquet brut de 33 octets
+    # @param packet Le paquet brut (39 octets en type 0x01, 37 octets en type 0x02)
     def _decode_and_show_imu(self, packet):
         try:
+            (seq,) = struct.unpack_from('<H', packet, 4)
+            if self.telem_seq_next is not None:
+                self.telem_lost += (seq - self.telem_seq_next) & 0xFFFF
+            self.telem_seq_next = (seq + 1) & 0xFFFF
+            self.telem_frames += 1
+
+            # Tous les échantillons vont au tracé ; seul le texte est limité à 10 Hz
+            samples = imu_samples(packet)
+            ring = self.plot_ring
+            for ts, values in samples:
+                ring.push(ts, values)
+
             now = time.time()
-            # Limite le rafraichissement UI à 10Hz
             if (now - self.last_imu_update) < 0.1:
                 return
+            footer = self._telem_footer(now)
             self.last_imu_update = now
-            
-            unpacked = struct.unpack('<BBBBIf f f f f f f B', packet)
-            timestamp = unpacked[4]
-            ax, ay, az = unpacked[5], unpacked[6], unpacked[7]
-            gx, gy, gz = unpacked[8], unpacked[9], unpacked[10]
-            speed = unpacked[11]
+
+            if packet[2] == TELEM_TYPE_FIELDS:
+                self._decode_and_show_telem(packet, footer)
+                return
+            # Lot delta : seul le dernier échantillon est affiché
+            timestamp, (ax, ay, az, gx, gy, gz, speed) = samples[-1]
 
             display_text = (
                 f"--- IMU DATA UPDATE ---\n"
-                f"TIMESTAMP : {timestamp} ms\n\n"
+                f"TIMESTAMP : {timestamp} µs\n\n"
                 f"ACCEL (mm/s²)\n"
                 f"  X: {ax:>8.2f}\n"
                 f"  Y: {ay:>8.2f}\n"
@@ -426,15 +1912,129 @@ class SerialApp(ctk.CTk):
                 f"  Y: {gy:>8.2f}\n"
                 f"  Z: {gz:>8.2f}\n"
                 f"SPEED (m/s)\n"
-                f"  {speed:>8.2f}\n"
-            )
-            self.txt_imu.configure(state="normal")
-            self.txt_imu.delete("1.0", "end")
-            self.txt_imu.insert("end", display_text)
-            self.txt_imu.configure(state="disabled")
+                f"  {speed:>8.2f}\n\n"
+            ) + "\n".join(footer) + "\n"
+            self.imu_text = display_text
         except Exception:
             pass
 
+    ##
+    # @brief Décode et affiche une trame de télémétrie à contenu choisi (type 0x03)
+    # Champs présents selon le masque (REG_TELEM_FIELDS), dans l'ordre des bits
+    # @param packet Le paquet brut [AA 55 03 LEN | SEQ | TIMESTAMP | FIELDS | champs | CRC]
+    # @param footer Lignes de bilan (_telem_footer)
+    def _decode_and_show_telem(self, packet, footer):
+        timestamp, fields, values = decode_fields(packet)
+        lines = [f"--- TELEMETRY (0x{fields:02X}) ---", f"TIMESTAMP : {timestamp} µs", ""]
+        lines += telem_field_lines(values)
+        lines += footer
+
+        self.imu_text = "\n".join(lines) + "\n"
+
+    ##
+    # @brief Log une trame d'écho : durée de chaque étape côté firmware
+    # @param packet Trame complète type 0x06
+    def _decode_and_log_echo(self, packet):
+        token, t_rx, t_parse, t_app, t_tx = decode_echo(packet)
+        self._log_cmd(f"RX [PING {token}]: parser {(t_parse - t_rx) & 0xFFFFFFFF} us, "
+                      f"boucle {(t_app - t_parse) & 0xFFFFFFFF} us, TX {(t_tx - t_app) & 0xFFFFFFFF} us")
+
+    ##
+    # @brief Log un résultat du banc de mesure (une ligne CSV par routine et variante)
+    # @param packet Trame complète type 0x07 [AA 55 07 LEN | ARG | ID | CALLS | MIN | AVG | MAX | CRC]
+    def _decode_and_log_bench(self, packet):
+        arg, bench_id, calls, c_min, c_avg, c_max = struct.unpack_from('<HBHIII', packet, 4)
+        name = BENCH_NAMES[bench_id] if bench_id < len(BENCH_NAMES) else f"id{bench_id}"
+        if name == "budget":
+            # MIN = budget, AVG = marge signée, MAX = pire cas (µs) ; CALLS = 0 : source absente du build
+            source = "slot" if arg == BENCH_BUDGET_SLOT else (BUDGET_NAMES[arg] if arg < len(BUDGET_NAMES) else f"src{arg}")
+            margin = c_avg - (1 << 32) if c_avg & 0x80000000 else c_avg
+            verdict = "PASS" if margin >= 0 else "FAIL"
+            if calls == 0:
+                verdict, margin = "N/A", 0
+            self._log_cmd(f"BENCH,budget,{source},{verdict},{c_min},{c_max},{margin}")
+            return
+        self._log_cmd(f"BENCH,{name},{arg},{calls},{c_min},{c_avg},{c_max}")
+
+    ##
+    # @brief Log un point du journal firmware, en signalant les enregistrements perdus
+    # @param packet Trame complète type 0x08
+    def _decode_and_log_log(self, packet):
+        seq, t_us, log_id, args = decode_log(packet)
+        if self.log_seq_next is not None and seq != self.log_seq_next:
+            self._log_cmd(f"LOG: {(seq - self.log_seq_next) & 0xFFFF} entrées perdues")
+        self.log_seq_next = (seq + 1) & 0xFFFF
+        self._log_cmd(f"LOG [{t_us / 1e6:.6f}s] {format_log(log_id, args)}")
+
+    ##
+    # @brief Décode et log un rapport vibratoire
+    # @param packet Trame complète type 0x0A
+    def _decode_and_log_vib(self, packet):
+        t_us, fs_hz, peak_hz, peak_mg, bands, axis, blocks = decode_vib(packet)
+        self._log_cmd(f"VIB [{t_us / 1e6:.6f}s] axe {axis} ({blocks} x {fs_hz} Hz) : "
+                      f"pic {peak_hz:.1f} Hz {peak_mg} mg, bandes {' / '.join(str(b) for b in bands)} mg eff")
+
+    ##
+    # @brief Décode et log la trame de capacités, puis la publie pour l'interface
+    # @param packet Trame complète type 0x0B
+    def _decode_and_log_caps(self, packet):
+        caps = decode_caps(packet)
+        major, minor = caps['version'] >> 8, caps['version'] & 0xFF
+        if major != PROTO_VERSION_MAJOR:
+            self._log_cmd(f"Attention : protocole firmware v{major}.{minor}, hôte v{PROTO_VERSION_MAJOR}.{PROTO_VERSION_MINOR}")
+        types = [f"0x{t:02X}" for t in range(16) if caps['types'] & (1 << t)]
+        self._log_cmd(f"CAPS v{major}.{minor} : trames {' '.join(types)}, champs 0x{caps['fields']:02X}, "
+                      f"{caps['rate_min_hz']}..{caps['rate_max_hz']} Hz, "
+                      f"{'/'.join(str(b) for b in caps_baud_rates(caps))} bauds, "
+                      f"rings RX {caps['rx_ring']} / TX {caps['tx_ring']} o, lots de {caps['batch_max']}")
+        self.caps = caps
+        self.envelope = bool(caps['link'] & CAPS_LINK_ENVELOPE)
+        self.cobs = bool(caps['link'] & CAPS_LINK_COBS)
+
+    ##
+    # @brief Log un état instantané : consignes, ESC, vitesse et dernier échantillon IMU au même instant
+    # @param packet Trame complète type 0x0E
+    def _decode_and_log_snapshot(self, packet):
+        s = decode_snapshot(packet)
+        fs = FS_STAGE_NAMES[s['fs_stage']] if s['fs_stage'] < len(FS_STAGE_NAMES) else s['fs_stage']
+        line = (f"SNAP {s['token']} [{s['t_us'] / 1e6:.6f}s] servo {s['servo_cmd']}°, "
+                f"moteur {s['motor_cmd_mms']} mm/s (état {s['motor_state']}, "
+                f"{'avant' if s['go_forward'] else 'arrière'}, CCR {s['target_ticks']}), failsafe {fs}, "
+                f"vitesse {s['speed_mms']} mm/s")
+        if s['imu_seq']:
+            age_us = (s['t_us'] - s['imu_t_us']) & 0xFFFFFFFF
+            line += (f", IMU #{s['imu_seq']} il y a {age_us} us : accel {'/'.join(str(a) for a in s['accel'])} mm/s², "
+                     f"gyro {'/'.join(str(g) for g in s['gyro'])} µrad/s")
+        self._log_cmd(line)
+
+    ##
+    # @brief Log le résultat d'un accès direct aux registres IMU
+    # @param packet Trame complète type 0x12
+    def _decode_and_log_bmireg(self, packet):
+        write, sensor, addr, count, status, data = decode_bmireg(packet)
+        name = BMI_SENSOR_NAMES[sensor] if sensor < len(BMI_SENSOR_NAMES) else sensor
+        op = "écriture" if write else "lecture"
+        if status != 0:
+            self._log_cmd(f"BMI {name} {op} 0x{addr:02X} : échec (code {status})")
+        else:
+            self._log_cmd(f"BMI {name} {op} 0x{addr:02X} : {' '.join(f'{b:02X}' for b in data)}")
+
+    ##
+    # @brief Log un relevé de faute : cause, tâche en cours, registres empilés et compteurs de liaison
+    # @param packet Trame complète type 0x11
+    def _decode_and_log_fault(self, packet):
+        f = decode_fault(packet)
+        cause = FAULT_CAUSE_NAMES[f['cause']] if f['cause'] < len(FAULT_CAUSE_NAMES) else f['cause']
+        task = "hors tâche" if f['task'] == 0xFF else f"tâche {f['task']}"
+        line = (f"FAUTE #{f['count']} : {cause} à {f['uptime_ms'] / 1000:.3f}s, {task}, "
+                f"{f['loops']} boucles ; liaison : RX perdus {f['rx_drop']}, TX refusées {f['tx_drop']}, "
+                f"overruns {f['rx_overrun']}, télémétrie #{f['telem_seq']}")
+        if f['cause'] == FAULT_CAUSE_HARDFAULT:
+            r0, r1, r2, r3, r12, lr, pc, xpsr = f['regs']
+            line += (f"\n  pc 0x{pc:08X} lr 0x{lr:08X} sp 0x{f['sp']:08X} xpsr 0x{xpsr:08X}"
+                     f"\n  r0 0x{r0:08X} r1 0x{r1:08X} r2 0x{r2:08X} r3 0x{r3:08X} r12 0x{r12:08X}")
+        self._log_cmd(line)
+
     ##
     # @brief Décode et log les réponses aux commandes READ
     # @param packet Le paquet brut de 4 octets
@@ -452,17 +2052,40 @@ class SerialApp(ctk.CTk):
             hex_str = f"{header:02X} {d0:02X} {d1:02X} {crc:02X}"
             
             self._log_cmd(f"RX [READ Reg:0x{addr:02X}]: {hex_str} (Value_decimal={value})")
+            if addr == REG_BATT_MV:
+                self._log_cmd("BATTERIE : mesure absente" if value == 0 else f"BATTERIE : {value / 1000.0:.2f} V")
         except Exception as e:
             self._log_cmd(f"Erreur Decode CMD: {e}")
 
+    ##
+    # @brief Décode et log une réponse de lecture groupée
+    # @param packet Le paquet sans l'octet de synchronisation [HDR | COUNT | N x int16 | CRC]
+    def _decode_and_log_burst(self, packet):
+        try:
+            addr = packet[0] & 0x7F
+            count = packet[1]
+            values = struct.unpack(f'<{count}h', bytes(packet[2:2 + 2 * count]))
+            for i, value in enumerate(values):
+                self._log_cmd(f"RX [READ Reg:0x{(addr + i) & 0x7F:02X}]: (Value_decimal={value})")
+            if addr == REG_PROF_COUNT and count >= REG_PROF_LATE_MAX - REG_PROF_COUNT + 1:
+                runs, t_min, t_avg, t_max = (v & 0xFFFF if i == 0 else v for i, v in enumerate(values[:4]))
+                hist = [v & 0xFFFF for v in values[REG_PROF_HIST0 - REG_PROF_COUNT:REG_PROF_HIST0 - REG_PROF_COUNT + 8]]
+                edges = [f"<{l}" for l in PROF_HIST_LIMITS_US] + [f">={PROF_HIST_LIMITS_US[-1]}"]
+                self._log_cmd(f"PROFIL: n={runs} min={t_min}us moy={t_avg}us max={t_max}us "
+                              f"overruns={values[12] & 0xFFFF} retard_max={values[13]}us")
+                self._log_cmd("PROFIL HISTO: " + " ".join(f"{e}:{h}" for e, h in zip(edges, hist)))
+            if addr == REG_ODOM_BASE and count >= REG_ODOM_COUNT:
+                x, y, heading, dist = decode_odom_pose(values)
+                self._log_cmd(f"ODOMETRIE: x={x:.2f}m y={y:.2f}m cap={heading:.2f}° distance={dist:.3f}m")
+        except Exception as e:
+            self._log_cmd(f"Erreur Decode BURST: {e}")
+
     ##
     # @brief Ajoute un message dans la console de logs
+    # Appelable depuis n'importe quel thread : le message est affiché par _ui_poll()
     # @param message Le texte à afficher
     def _log_cmd(self, message):
-        self.txt_log.configure(state="normal")
-        self.txt_log.insert("end", message + "\n")
-        self.txt_log.see("end")
-        self.txt_log.configure(state="disabled")
+        self.log_queue.put(message)
     
     ##
     # @brief Efface la console de logs
@@ -475,16 +2098,37 @@ class SerialApp(ctk.CTk):
     # @brief Gestion de la fermeture de la fenêtre
     # Arrête les threads et ferme le port série
     def on_closing(self):
-        self.stop_thread = True
+        self.after_cancel(self.ui_poll_id)
+        self.plot.stop()
+        if self.scheduler is not None:
+            self.scheduler.stop()
+            self.scheduler = None
         self.is_auto_sending = False
+        self._stop_threads()
+        if self.recorder is not None:
+            self.recorder.close()
+            self.recorder = None
         if self.ser and self.ser.is_open:
             self.ser.close()
         self.destroy()
 
 if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Interface de contrôle Robot STM32")
+    parser.add_argument("--replay", metavar="FICHIER", help="vérifie un enregistrement .tlm hors ligne, sans interface")
+    parser.add_argument("--fleet", metavar="HÔTE:PORT", help="propose les liens d'un démon de flotte (fleet_daemon.py)")
+    args = parser.parse_args()
+    if args.replay:
+        s = replay_summary(args.replay)
+        rate = s['imu'] / s['duration_s'] if s['duration_s'] > 0 else 0.0
+        types = " ".join(f"0x{t:02X}:{n}" for t, n in sorted(s['types'].items()))
+        print(f"{s['records']} enregistrements sur {s['duration_s']:.1f} s : "
+              f"{s['imu']} IMU ({rate:.0f}/s, {types}), {s['cmd']} CMD, {s['burst']} BURST")
+        print(f"trames perdues (séquence) : {s['lost']}, trames non redécoupées : {s['mismatch']}")
+        sys.exit(1 if s['mismatch'] else 0)
+
     ctk.set_appearance_mode("Dark")
     ctk.set_default_color_theme("blue")
     
-    app = SerialApp()
+    app = SerialApp(fleet=args.fleet)
     app.protocol("WM_DELETE_WINDOW", app.on_closing)
     app.mainloop()
@@ -0,0 +1,308 @@
+##
+# @file soak_test.py
+# @brief Essai d'endurance : télémétrie à pleine cadence et trafic de commandes pendant des heures
+# @date 2025
+#
+# Les défauts de production n'apparaissent qu'après des heures : rebouclage de
+# GetMicrosTotal() à ~71 minutes, débordement d'un ring, déclenchement du failsafe,
+# pile qui grossit. Le script tient la liaison chargée (consignes à SOAK_CMD_HZ,
+# télémétrie à la cadence demandée) et relit chaque seconde les compteurs du firmware
+# par lectures groupées. Chaque fenêtre de SOAK_WINDOW_S produit une ligne de bilan
+# (débits, pertes, erreurs, latence maximale, jauges) ; en fin d'essai, la pente de
+# chaque grandeur (par heure) montre les dérives que les totaux masquent.
+#
+# Avec un firmware construit en mode endurance (-DAPP_SOAK=1), le rebouclage des
+# dates survient dès les premières minutes et le bilan DLOG_SOAK fournit la cadence
+# de boucle, les overruns et le pire retard de libération de l'ordonnanceur.
+#
+# Usage : python soak_test.py PORT [--hours 8] [--baud 921600] [--rate 1000] [--window 60] [--csv soak.csv]
+#
+
+import argparse
+import csv
+import math
+import queue
+import struct
+import sys
+import threading
+import time
+
+import serial
+
+from latency_bench import set_baud
+from serial_reg import (BAUD_RATES, FRAME_BURST, FRAME_IMU, REG_SERVO_CMD, REG_STAT_RX_HWM, REG_STAT_RX_REJECT,
+                        REG_STAT_TELEM_SEQ, REG_TELEM_RATE, TELEM_TYPE_COMPACT, TELEM_TYPE_DELTA, TELEM_TYPE_FIELDS,
+                        TELEM_TYPE_FX, TELEM_TYPE_LEGACY, TELEM_TYPE_LOG, TELEM_TYPE_REG, build_burst_frame,
+                        build_frame, decode_log, split_frames)
+
+## @brief Durée d'une fenêtre de bilan (s)
+SOAK_WINDOW_S = 60.0
+## @brief Période de relecture des compteurs du firmware (s)
+SOAK_POLL_S = 1.0
+## @brief Cadence des consignes servo + moteur (Hz)
+SOAK_CMD_HZ = 50.0
+## @brief Balayage du servo : amplitude (degrés) et fréquence (Hz) ; moteur toujours à 0
+SOAK_SERVO_DEG = 10
+SOAK_SERVO_HZ = 0.5
+## @brief Délai au-delà duquel une lecture sans réponse est comptée perdue (s)
+SOAK_READ_TIMEOUT_S = 0.5
+## @brief Lectures groupées des compteurs : (premier registre, noms des registres consécutifs)
+SOAK_READS = [(REG_STAT_TELEM_SEQ, ('telem_seq', 'tx_drop', 'rx_drop', 'imu_drop', 'idle_pct')),
+              (REG_STAT_RX_REJECT, ('rx_reject', 'rx_rate', 'reset_cause', 'imu_bus_err', 'imu_recover',
+                                    'stack_peak')),
+              (REG_STAT_RX_HWM, ('rx_hwm', 'tx_hwm', 'rx_overrun'))]
+## @brief Compteurs firmware (différence modulo 65536 sur la fenêtre) ; les autres registres sont des jauges
+SOAK_COUNTERS = ('tx_drop', 'rx_drop', 'imu_drop', 'rx_reject', 'imu_bus_err', 'rx_overrun')
+SOAK_GAUGES = ('idle_pct', 'stack_peak', 'rx_hwm', 'tx_hwm')
+## @brief Grandeurs dont le bilan de fin d'essai donne aussi le total
+SOAK_TOTALS = SOAK_COUNTERS + ('lost', 'resync_B', 'overruns', 'reads_lost', 'failsafe', 'reboots', 'ts_wraps',
+                               'ts_back')
+## @brief Identifiants du journal suivis (dlog_id_t)
+LOG_BOOT_STAGE = 0
+LOG_FAILSAFE = 1
+LOG_SOAK = 9
+## @brief Types de trame portant un numéro de séquence de télémétrie
+TELEM_TYPES = (TELEM_TYPE_LEGACY, TELEM_TYPE_FX, TELEM_TYPE_FIELDS, TELEM_TYPE_COMPACT, TELEM_TYPE_DELTA)
+## @brief Colonnes d'une ligne de bilan : (nom, largeur, format)
+SOAK_COLUMNS = [('t_h', 6, '.2f'), ('telem_hz', 8, '.0f'), ('lost', 6, 'd'), ('resync_B', 8, 'd')] + \
+               [(c, 9, 'd') for c in SOAK_COUNTERS] + [(g, 10, 'd') for g in SOAK_GAUGES] + \
+               [('loop_hz', 8, 'd'), ('overruns', 8, 'd'), ('late_max_us', 11, 'd'), ('lat_max_ms', 10, '.1f'),
+                ('reads_lost', 10, 'd'), ('failsafe', 8, 'd'), ('reboots', 7, 'd'), ('ts_wraps', 8, 'd'),
+                ('ts_back', 7, 'd')]
+
+##
+# @class LinkMonitor
+# @brief Comptes de la liaison sur la fenêtre courante, tenus par le thread de lecture
+class LinkMonitor:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.replies = queue.Queue()    # (instant de réception, registre, valeurs)
+        self.seq_next = None
+        self.last_ts = None
+        self.fs_stage = 0
+        self.soak = None                # Dernier bilan DLOG_SOAK (boucle Hz, overruns, retard max µs)
+        self.window = self._fresh()
+
+    @staticmethod
+    def _fresh():
+        return {'frames': 0, 'lost': 0, 'resync': 0, 'failsafe': 0, 'reboots': 0, 'ts_wraps': 0, 'ts_back': 0,
+                'loop_hz': None}
+
+    ##
+    # @brief Rend les comptes de la fenêtre écoulée et en ouvre une nouvelle
+    def take(self):
+        with self.lock:
+            w, self.window = self.window, self._fresh()
+            w['soak'] = self.soak
+        return w
+
+    ##
+    # @brief Découpe et comptabilise les trames d'un tampon de réception
+    # @return Nombre d'octets consommés
+    def feed(self, buf):
+        frames = []
+        used = split_frames(buf, lambda k, p: frames.append((k, p)))
+        now = time.monotonic()
+        with self.lock:
+            w = self.window
+            # Octets sautés au recalage (CRC faux, trame tronquée) ; SYNC retiré des réponses
+            w['resync'] += used - sum(len(p) + (k != FRAME_IMU) for k, p in frames)
+            for kind, packet in frames:
+                self._frame(w, kind, packet, now)
+        return used
+
+    def _frame(self, w, kind, packet, now):
+        if kind == FRAME_BURST:
+            self._reply(now, packet)
+            return
+        if kind != FRAME_IMU:
+            return
+        ftype = packet[2]
+        if ftype == TELEM_TYPE_REG:
+            self._reply(now, packet[4:])
+        elif ftype == TELEM_TYPE_LOG:
+            _, _, log_id, args = decode_log(packet)
+            if log_id == LOG_FAILSAFE and args:
+                if args[0] != 0 and self.fs_stage == 0:
+                    w['failsafe'] += 1
+                self.fs_stage = args[0]
+            elif log_id == LOG_BOOT_STAGE and args and args[0] == 0:
+                w['reboots'] += 1
+                self.seq_next = self.last_ts = None
+            elif log_id == LOG_SOAK and len(args) == 3:
+                self.soak = args
+                w['loop_hz'] = args[0] if w['loop_hz'] is None else min(w['loop_hz'], args[0])
+        elif ftype in TELEM_TYPES and len(packet) >= 10:
+            seq, ts = struct.unpack_from('<HI', packet, 4)
+            w['frames'] += 1
+            if self.seq_next is not None:
+                w['lost'] += (seq - self.seq_next) & 0xFFFF
+            self.seq_next = (seq + 1) & 0xFFFF
+            if self.last_ts is not None and ts < self.last_ts:
+                if self.last_ts - ts > 0x80000000:
+                    w['ts_wraps'] += 1
+                else:
+                    w['ts_back'] += 1
+            self.last_ts = ts
+
+    def _reply(self, now, packet):
+        count = packet[1]
+        if len(packet) >= 2 + 2 * count:
+            self.replies.put((now, packet[0] & 0x7F, struct.unpack_from(f'<{count}h', packet, 2)))
+
+##
+# @brief Thread de lecture
+def reader(ser, monitor, stop):
+    buf = bytearray()
+    while not stop.is_set():
+        data = ser.read(max(1, ser.in_waiting))
+        if not data:
+            continue
+        buf.extend(data)
+        used = monitor.feed(buf)
+        if used:
+            del buf[:used]
+
+##
+# @brief Pente d'une grandeur par moindres carrés
+# @param ts Dates (h)
+# @param vs Valeurs
+# @return Variation par heure
+def slope_per_hour(ts, vs):
+    n = len(ts)
+    if n < 2:
+        return 0.0
+    mt, mv = sum(ts) / n, sum(vs) / n
+    den = sum((t - mt) ** 2 for t in ts)
+    return sum((t - mt) * (v - mv) for t, v in zip(ts, vs)) / den if den else 0.0
+
+##
+# @brief Bilan de fin d'essai : totaux et tendances de chaque grandeur
+# @param rows Lignes de bilan des fenêtres
+def print_trends(rows):
+    print(f"\n{'grandeur':<12}{'total':>10}{'début':>10}{'fin':>10}{'max':>10}{'pente/h':>10}")
+    for name, _, _ in SOAK_COLUMNS[1:]:
+        pts = [(r['t_h'], r[name]) for r in rows if r[name] is not None]
+        if not pts:
+            continue
+        ts, vs = zip(*pts)
+        total = f"{sum(vs):>10.0f}" if name in SOAK_TOTALS else f"{'':>10}"
+        print(f"{name:<12}{total}{vs[0]:>10.4g}{vs[-1]:>10.4g}{max(vs):>10.4g}{slope_per_hour(ts, vs):>+10.3g}")
+
+def main():
+    parser = argparse.ArgumentParser(description="Essai d'endurance de la liaison et du firmware")
+    parser.add_argument("port", help="port série (ex. /dev/ttyACM0, COM5)")
+    parser.add_argument("--hours", type=float, default=8.0, help="durée de l'essai (h)")
+    parser.add_argument("--baud", type=int, default=BAUD_RATES[2], choices=BAUD_RATES, help="débit négocié")
+    parser.add_argument("--rate", type=int, default=1000, help="cadence de télémétrie demandée (REG_TELEM_RATE, Hz)")
+    parser.add_argument("--window", type=float, default=SOAK_WINDOW_S, help="durée d'une fenêtre de bilan (s)")
+    parser.add_argument("--servo-deg", type=int, default=SOAK_SERVO_DEG, help="amplitude du balayage servo (°, 0 : fixe)")
+    parser.add_argument("--csv", metavar="FICHIER", help="écrit les lignes de bilan au format CSV")
+    args = parser.parse_args()
+
+    ser = serial.Serial(args.port, BAUD_RATES[0], timeout=0.05)
+    if args.baud != BAUD_RATES[0]:
+        set_baud(ser, args.baud)
+    ser.write(build_frame(REG_TELEM_RATE, args.rate & 0xFF, args.rate >> 8))
+
+    monitor = LinkMonitor()
+    stop = threading.Event()
+    thread = threading.Thread(target=reader, args=(ser, monitor, stop), daemon=True)
+    thread.start()
+
+    out = open(args.csv, 'w', newline='') if args.csv else None
+    writer = csv.writer(out) if out else None
+    if writer:
+        writer.writerow([name for name, _, _ in SOAK_COLUMNS])
+    print("".join(f"{name:>{width + 1}}" for name, width, _ in SOAK_COLUMNS))
+
+    start = time.monotonic()
+    end = start + args.hours * 3600.0
+    next_cmd = next_poll = start
+    next_window = start + args.window
+    window_start = start
+    regs, regs_start = {}, None
+    pending = {}                    # registre -> instant d'émission de la lecture
+    latencies, reads_lost = [], 0
+    overruns_prev = None
+    rows = []
+    monitor.take()
+    try:
+        while True:
+            now = time.monotonic()
+            if now >= end:
+                break
+
+            if now >= next_cmd:
+                servo = round(args.servo_deg * math.sin(2.0 * math.pi * SOAK_SERVO_HZ * (now - start)))
+                ser.write(build_burst_frame(REG_SERVO_CMD, [servo, 0]))
+                next_cmd += 1.0 / SOAK_CMD_HZ
+
+            if now >= next_poll:
+                for addr, names in SOAK_READS:
+                    if addr in pending:
+                        reads_lost += 1
+                    pending[addr] = time.monotonic()
+                    ser.write(build_frame(0x80 | addr, len(names), 0))
+                next_poll += SOAK_POLL_S
+
+            while True:
+                try:
+                    t_rx, addr, values = monitor.replies.get_nowait()
+                except queue.Empty:
+                    break
+                for first, names in SOAK_READS:
+                    if addr == first and first in pending:
+                        latencies.append(t_rx - pending.pop(first))
+                        regs.update(zip(names, values))
+            for addr, t_tx in list(pending.items()):
+                if now - t_tx > SOAK_READ_TIMEOUT_S:
+                    del pending[addr]
+                    reads_lost += 1
+
+            if now >= next_window:
+                w = monitor.take()
+                dt = now - window_start
+                row = {'t_h': (now - start) / 3600.0, 'telem_hz': w['frames'] / dt, 'lost': w['lost'],
+                       'resync_B': w['resync'], 'loop_hz': w['loop_hz'],
+                       'lat_max_ms': max(latencies) * 1e3 if latencies else None, 'reads_lost': reads_lost,
+                       'failsafe': w['failsafe'], 'reboots': w['reboots'], 'ts_wraps': w['ts_wraps'],
+                       'ts_back': w['ts_back']}
+                for c in SOAK_COUNTERS:
+                    row[c] = ((regs[c] - regs_start[c]) & 0xFFFF) if regs_start and c in regs and c in regs_start else None
+                for g in SOAK_GAUGES:
+                    row[g] = regs.get(g)
+                soak = w['soak']
+                row['overruns'] = soak[1] - overruns_prev if soak and overruns_prev is not None else None
+                row['late_max_us'] = soak[2] if soak else None
+                overruns_prev = soak[1] if soak else None
+                rows.append(row)
+
+                print("".join(f"{'-':>{width + 1}}" if row[name] is None else f"{row[name]:>{width + 1}{fmt}}"
+                              for name, width, fmt in SOAK_COLUMNS), flush=True)
+                if writer:
+                    writer.writerow(['' if row[name] is None else row[name] for name, _, _ in SOAK_COLUMNS])
+                    out.flush()
+
+                regs_start = dict(regs)
+                latencies, reads_lost = [], 0
+                window_start = now
+                next_window += args.window
+
+            time.sleep(max(0.0, min(next_cmd, next_poll, next_window) - time.monotonic()))
+    except KeyboardInterrupt:
+        pass
+    finally:
+        ser.write(build_burst_frame(REG_SERVO_CMD, [0, 0]))
+        stop.set()
+        thread.join(timeout=1.0)
+        ser.close()
+        if out:
+            out.close()
+
+    if rows:
+        print_trends(rows)
+    return 1 if any(r['reboots'] or r['ts_back'] for r in rows) else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
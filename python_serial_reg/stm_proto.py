@@ -0,0 +1,288 @@
+##
+# @file stm_proto.py
+# @brief Liaison Python (ctypes) de la bibliothèque native host_lib/libstm_proto.so
+# @date 2025
+#
+# Même découpage, décodage et synchronisation que serial_reg.py / clock_sync.py, mais
+# compilés : une lecture de plusieurs kilo-octets est découpée et décodée en un seul
+# appel, vers un tableau contigu d'échantillons (SAMPLE_DTYPE pour numpy.frombuffer,
+# sans copie). ctypes suffit : aucune dépendance de compilation côté Python.
+#
+# La bibliothèque se construit avec "make -C host_lib" ; STM_PROTO_LIB permet d'en
+# donner un autre chemin.
+#
+# Usage :
+#   sp = Splitter(); dec = Decoder()
+#   n = sp.decode(dec, ser.read(4096), samples)     # samples = SampleArray(1024)
+#   for s in samples[:n]: ... s.t_us, s.accel[0] ...
+#
+
+import ctypes
+import os
+
+## @brief Chemin par défaut de la bibliothèque (construite par host_lib/Makefile)
+STM_PROTO_LIB = os.environ.get('STM_PROTO_LIB', os.path.join(
+    os.path.dirname(os.path.abspath(__file__)), '..', 'host_lib', 'libstm_proto.so'))
+
+## @brief Constantes de stm_proto.h
+STP_RX_BUF_LEN = 4096
+STP_FRAME_MAX_LEN = 260
+STP_BURST_MAX_REGS = 8
+STP_CLOCK_WINDOW = 512
+
+STP_MODE_RAW = 0
+STP_MODE_ENVELOPE = 1
+STP_MODE_COBS = 2
+
+STP_S_ACCEL = 0x01
+STP_S_GYRO = 0x02
+STP_S_SPEED = 0x04
+STP_S_ATTITUDE = 0x08
+
+class Frame(ctypes.Structure):
+    _fields_ = [('data', ctypes.POINTER(ctypes.c_uint8)),
+                ('len', ctypes.c_uint16),
+                ('kind', ctypes.c_uint8)]
+
+class _Splitter(ctypes.Structure):
+    _fields_ = [('buf', ctypes.c_uint8 * STP_RX_BUF_LEN),
+                ('cobs', ctypes.c_uint8 * STP_FRAME_MAX_LEN),
+                ('len', ctypes.c_size_t),
+                ('pos', ctypes.c_size_t),
+                ('mode', ctypes.c_uint8),
+                ('frames', ctypes.c_uint64),
+                ('skipped', ctypes.c_uint64),
+                ('overflow', ctypes.c_uint64)]
+
+##
+# @class Sample
+# @brief Échantillon de télémétrie (stp_sample_t, 64 octets)
+class Sample(ctypes.Structure):
+    _fields_ = [('t_us', ctypes.c_uint64),
+                ('seq', ctypes.c_uint16),
+                ('type', ctypes.c_uint8),
+                ('valid', ctypes.c_uint8),
+                ('accel', ctypes.c_float * 3),
+                ('gyro', ctypes.c_float * 3),
+                ('speed', ctypes.c_float),
+                ('quat', ctypes.c_float * 4),
+                ('reserved', ctypes.c_uint32 * 2)]
+
+## @brief Description numpy de Sample (numpy.dtype(SAMPLE_DTYPE)), pour lire un SampleArray sans copie
+SAMPLE_DTYPE = [('t_us', '<u8'), ('seq', '<u2'), ('type', 'u1'), ('valid', 'u1'),
+                ('accel', '<f4', 3), ('gyro', '<f4', 3), ('speed', '<f4'),
+                ('quat', '<f4', 4), ('reserved', '<u4', 2)]
+
+class _Decoder(ctypes.Structure):
+    _fields_ = [('last_t32', ctypes.c_uint32),
+                ('high', ctypes.c_uint64),
+                ('started', ctypes.c_uint8),
+                ('seq_next', ctypes.c_uint16),
+                ('lost', ctypes.c_uint64),
+                ('decoded', ctypes.c_uint64)]
+
+class _ClockPoint(ctypes.Structure):
+    _fields_ = [('mcu_us', ctypes.c_double),
+                ('offset_ns', ctypes.c_double),
+                ('link_ns', ctypes.c_double)]
+
+class _Clock(ctypes.Structure):
+    _fields_ = [('pts', _ClockPoint * STP_CLOCK_WINDOW),
+                ('count', ctypes.c_uint32),
+                ('next', ctypes.c_uint32),
+                ('last_t32', ctypes.c_uint32),
+                ('high', ctypes.c_uint64),
+                ('started', ctypes.c_uint8),
+                ('mcu_ref_us', ctypes.c_double),
+                ('offset_ns', ctypes.c_double),
+                ('drift', ctypes.c_double)]
+
+## @brief Rappel des trames autres que la télémétrie : (ctx, const stp_frame_t *)
+OTHER_CB = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.POINTER(Frame))
+
+_lib = None
+
+##
+# @brief Charge la bibliothèque et déclare les prototypes (une seule fois)
+def _load():
+    global _lib
+    if _lib is not None:
+        return _lib
+    try:
+        lib = ctypes.CDLL(STM_PROTO_LIB)
+    except OSError as e:
+        raise ImportError(f"{STM_PROTO_LIB} introuvable : construire avec \"make -C host_lib\" ({e})") from e
+
+    u8p = ctypes.POINTER(ctypes.c_uint8)
+    size = ctypes.c_size_t
+    lib.stp_crc8.argtypes = [ctypes.c_char_p, size]
+    lib.stp_crc8.restype = ctypes.c_uint8
+    lib.stp_splitter_init.argtypes = [ctypes.POINTER(_Splitter), ctypes.c_uint8]
+    lib.stp_splitter_set_mode.argtypes = [ctypes.POINTER(_Splitter), ctypes.c_uint8]
+    lib.stp_push.argtypes = [ctypes.POINTER(_Splitter), ctypes.c_char_p, size]
+    lib.stp_push.restype = size
+    lib.stp_next.argtypes = [ctypes.POINTER(_Splitter), ctypes.POINTER(Frame)]
+    lib.stp_next.restype = ctypes.c_int
+    lib.stp_decoder_init.argtypes = [ctypes.POINTER(_Decoder)]
+    lib.stp_decode_frame.argtypes = [ctypes.POINTER(_Decoder), ctypes.c_char_p, size,
+                                     ctypes.POINTER(Sample), size]
+    lib.stp_decode_frame.restype = size
+    lib.stp_decode.argtypes = [ctypes.POINTER(_Splitter), ctypes.POINTER(_Decoder), ctypes.c_char_p,
+                               size, ctypes.POINTER(Sample), size, OTHER_CB, ctypes.c_void_p]
+    lib.stp_decode.restype = size
+    lib.stp_build_cmd.argtypes = [u8p, ctypes.c_uint8, ctypes.c_uint16]
+    lib.stp_build_cmd.restype = size
+    lib.stp_build_burst.argtypes = [u8p, ctypes.c_uint8, ctypes.POINTER(ctypes.c_int16), ctypes.c_uint8]
+    lib.stp_build_burst.restype = size
+    lib.stp_clock_init.argtypes = [ctypes.POINTER(_Clock)]
+    lib.stp_clock_add.argtypes = [ctypes.POINTER(_Clock), ctypes.c_int64, ctypes.c_int64,
+                                  ctypes.c_uint32, ctypes.c_uint32]
+    lib.stp_clock_fit.argtypes = [ctypes.POINTER(_Clock)]
+    lib.stp_clock_fit.restype = ctypes.c_int
+    lib.stp_clock_mcu_to_host_ns.argtypes = [ctypes.POINTER(_Clock), ctypes.c_uint32]
+    lib.stp_clock_mcu_to_host_ns.restype = ctypes.c_double
+    _lib = lib
+    return lib
+
+##
+# @brief Tableau contigu d'échantillons à remplir par Splitter.decode()
+# @param n Nombre de places
+def SampleArray(n):
+    return (Sample * n)()
+
+##
+# @brief CRC-8/ATM (identique à serial_reg.crc8_atm)
+def crc8(data):
+    data = bytes(data)
+    return _load().stp_crc8(data, len(data))
+
+##
+# @brief Trame de commande [A5 | HDR | D0 | D1 | CRC] (identique à serial_reg.build_frame)
+def build_frame(hdr, d0, d1):
+    out = (ctypes.c_uint8 * 5)()
+    n = _load().stp_build_cmd(out, hdr & 0xFF, (d0 & 0xFF) | ((d1 & 0xFF) << 8))
+    return bytes(out[:n])
+
+##
+# @brief Trame d'écriture groupée (identique à serial_reg.build_burst_frame)
+# @param addr Premier registre
+# @param values Valeurs int16 (1 à STP_BURST_MAX_REGS)
+def build_burst_frame(addr, values):
+    vals = (ctypes.c_int16 * len(values))(*[((v + 0x8000) & 0xFFFF) - 0x8000 for v in values])
+    out = (ctypes.c_uint8 * (4 + 2 * STP_BURST_MAX_REGS))()
+    n = _load().stp_build_burst(out, addr, vals, len(values))
+    if n == 0:
+        raise ValueError(f"1 à {STP_BURST_MAX_REGS} registres par trame groupée")
+    return bytes(out[:n])
+
+##
+# @class Decoder
+# @brief État de décodage d'un lien (déroulement des dates, pertes)
+class Decoder:
+    def __init__(self):
+        self._lib = _load()
+        self.state = _Decoder()
+        self._lib.stp_decoder_init(ctypes.byref(self.state))
+
+    ##
+    # @brief Décode une trame enveloppée déjà découpée
+    # @param frame Trame complète
+    # @param out Tableau d'échantillons (SampleArray)
+    # @return Échantillons écrits
+    def decode_frame(self, frame, out):
+        frame = bytes(frame)
+        return self._lib.stp_decode_frame(ctypes.byref(self.state), frame, len(frame), out, len(out))
+
+    @property
+    def lost(self):
+        return self.state.lost
+
+    @property
+    def decoded(self):
+        return self.state.decoded
+
+##
+# @class Splitter
+# @brief Découpage des trames d'un lien
+class Splitter:
+    ##
+    # @param mode STP_MODE_RAW, STP_MODE_ENVELOPE ou STP_MODE_COBS
+    def __init__(self, mode=STP_MODE_RAW):
+        self._lib = _load()
+        self.state = _Splitter()
+        self._lib.stp_splitter_init(ctypes.byref(self.state), mode)
+
+    ##
+    # @brief Change le format du flux (capacités reçues)
+    def set_mode(self, mode):
+        self._lib.stp_splitter_set_mode(ctypes.byref(self.state), mode)
+
+    ##
+    # @brief Ajoute des octets reçus et rend les trames complètes
+    # @return Liste de (nature, trame) comme l'emit de serial_reg.split_frames
+    def feed(self, data):
+        data = bytes(data)
+        fr = Frame()
+        out = []
+        while True:
+            used = self._lib.stp_push(ctypes.byref(self.state), data, len(data))
+            data = data[used:]
+            while self._lib.stp_next(ctypes.byref(self.state), ctypes.byref(fr)):
+                out.append((fr.kind, ctypes.string_at(fr.data, fr.len)))
+            if not data or used == 0:
+                return out
+
+    ##
+    # @brief Découpe et décode en un seul appel
+    # @param dec Decoder du lien
+    # @param data Octets reçus (b"" : reprise sur les octets en attente quand out était plein)
+    # @param out Tableau d'échantillons (SampleArray)
+    # @param other Appelée avec (nature, trame) pour les autres trames (None : ignorées)
+    # @return Échantillons écrits dans out
+    def decode(self, dec, data, out, other=None):
+        data = bytes(data)
+        if other is None:
+            cb = OTHER_CB()
+        else:
+            cb = OTHER_CB(lambda _ctx, fr: other(fr.contents.kind,
+                                                  ctypes.string_at(fr.contents.data, fr.contents.len)))
+        return self._lib.stp_decode(ctypes.byref(self.state), ctypes.byref(dec.state), data, len(data),
+                                    out, len(out), cb, None)
+
+    @property
+    def frames(self):
+        return self.state.frames
+
+    @property
+    def skipped(self):
+        return self.state.skipped
+
+    @property
+    def overflow(self):
+        return self.state.overflow
+
+##
+# @class ClockSync
+# @brief Synchronisation d'horloge native (même interface que clock_sync.ClockSync pour add/fit/mcu_to_host_ns)
+class ClockSync:
+    def __init__(self):
+        self._lib = _load()
+        self.state = _Clock()
+        self._lib.stp_clock_init(ctypes.byref(self.state))
+
+    def add(self, h0_ns, h3_ns, t_rx, t_tx):
+        self._lib.stp_clock_add(ctypes.byref(self.state), h0_ns, h3_ns, t_rx & 0xFFFFFFFF, t_tx & 0xFFFFFFFF)
+
+    def fit(self):
+        return bool(self._lib.stp_clock_fit(ctypes.byref(self.state)))
+
+    def mcu_to_host_ns(self, t32):
+        return self._lib.stp_clock_mcu_to_host_ns(ctypes.byref(self.state), t32 & 0xFFFFFFFF)
+
+    @property
+    def offset_ns(self):
+        return self.state.offset_ns
+
+    @property
+    def drift(self):
+        return self.state.drift
@@ -0,0 +1,265 @@
+##
+# @file telem_plot.py
+# @brief Tracé temps réel de la télémétrie, décimé min/max par colonne de pixels
+# @date 2025
+#
+# Le thread de décodage pousse chaque échantillon dans un anneau SampleRing
+# (producteur unique, sans verrou : l'index d'écriture n'est publié qu'après les
+# données, une affectation d'entier étant atomique sous le GIL). Le thread Tk relit
+# l'anneau à PLOT_REFRESH_MS : les nouveaux échantillons sont rangés par colonne de
+# pixels (minimum et maximum de chaque voie), puis chaque voie est redessinée en une
+# seule ligne du canevas (coords), sans créer ni détruire d'objets. Tous les
+# échantillons reçus marquent le tracé, quel que soit le débit, pour un coût de
+# dessin borné par la largeur du canevas.
+#
+
+import math
+import tkinter as tk
+from array import array
+
+## @brief Capacité de l'anneau (échantillons, puissance de 2) : plus d'une fenêtre à plein débit
+PLOT_RING_LEN = 1 << 16
+## @brief Marge laissée au producteur quand le lecteur a pris du retard (échantillons)
+PLOT_RING_MARGIN = PLOT_RING_LEN // 8
+## @brief Durée affichée (s) et période de redessin (ms)
+PLOT_WINDOW_S = 10.0
+PLOT_REFRESH_MS = 50
+## @brief Voies d'un échantillon : accélération (mm/s²), gyroscope (rad/s), vitesse (m/s)
+PLOT_CHANNELS = 7
+## @brief Bandes du tracé : (titre, voies, facteur d'affichage)
+PLOT_STRIPS = [("ACCEL (m/s²)", (0, 1, 2), 1e-3),
+               ("GYRO (rad/s)", (3, 4, 5), 1.0),
+               ("VITESSE (m/s)", (6,), 1.0)]
+PLOT_COLORS = ["#e06c75", "#98c379", "#61afef"]
+PLOT_BG = "#1e1e1e"
+PLOT_GRID = "#3a3a3a"
+PLOT_TEXT = "#c0c0c0"
+## @brief Marge gauche (libellés d'échelle) et hauteur du titre de bande (pixels)
+PLOT_LEFT_PX = 56
+PLOT_TITLE_PX = 14
+
+##
+# @class SampleRing
+# @brief Anneau d'échantillons à un producteur (thread de décodage) et un lecteur (thread Tk)
+class SampleRing:
+    def __init__(self, size=PLOT_RING_LEN, channels=PLOT_CHANNELS):
+        self.size = size
+        self.mask = size - 1
+        self.t = array('q', bytes(8 * size))
+        self.v = [array('f', bytes(4 * size)) for _ in range(channels)]
+        self.head = 0           # Échantillons écrits depuis le début (publié en dernier)
+        self._last = None
+        self._high = 0
+
+    ##
+    # @brief Ajoute un échantillon (producteur seulement)
+    # @param t32 Date firmware (µs, 32 bits), déroulée sur 64 bits ici
+    # @param values Voies (NaN : absente de la trame)
+    def push(self, t32, values):
+        last = self._last
+        if last is not None and t32 < last and (last - t32) > 0x80000000:
+            self._high += 1 << 32
+        self._last = t32
+        i = self.head & self.mask
+        self.t[i] = self._high + t32
+        for c, x in enumerate(values):
+            self.v[c][i] = x
+        self.head += 1
+
+    ##
+    # @brief Plage lisible depuis la position d'un lecteur
+    # @param tail Position du lecteur (échantillons lus)
+    # @return (début, fin, échantillons sautés) : indices absolus [début, fin)
+    def readable(self, tail):
+        head = self.head
+        oldest = head - (self.size - PLOT_RING_MARGIN)
+        if tail < oldest:
+            return oldest, head, oldest - tail
+        return tail, head, 0
+
+##
+# @class ColumnDecimator
+# @brief Minimum et maximum de chaque voie par colonne de pixels, sur une fenêtre glissante
+# Les colonnes sont rangées en tampon circulaire indexé par leur numéro absolu
+# (date // durée d'une colonne) : un échantillon ne coûte qu'une comparaison par voie
+class ColumnDecimator:
+    def __init__(self, columns, window_us, channels=PLOT_CHANNELS):
+        self.columns = max(2, int(columns))
+        self.col_us = max(1, int(window_us // self.columns))
+        self.channels = channels
+        self.col_id = [-1] * self.columns
+        self.lo = [[0.0] * self.columns for _ in range(channels)]
+        self.hi = [[0.0] * self.columns for _ in range(channels)]
+        self.newest = None
+
+    ##
+    # @brief Range les échantillons [start, end) de l'anneau
+    def add(self, ring, start, end):
+        n, mask, col_us = self.columns, ring.mask, self.col_us
+        col_id, t, v = self.col_id, ring.t, ring.v
+        for k in range(start, end):
+            i = k & mask
+            col = t[i] // col_us
+            slot = col % n
+            fresh = col_id[slot] != col
+            if fresh:
+                col_id[slot] = col
+            for c in range(self.channels):
+                x = v[c][i]
+                if x != x:
+                    # Voie absente (NaN) : la colonne fraîche reste vide pour elle
+                    if fresh:
+                        self.lo[c][slot] = math.inf
+                        self.hi[c][slot] = -math.inf
+                    continue
+                lo, hi = self.lo[c], self.hi[c]
+                if fresh or lo[slot] > hi[slot]:
+                    lo[slot] = hi[slot] = x
+                elif x < lo[slot]:
+                    lo[slot] = x
+                elif x > hi[slot]:
+                    hi[slot] = x
+            # Date en recul de plus d'une fenêtre (redémarrage du firmware) : on repart de là
+            if self.newest is None or col > self.newest or col < self.newest - n:
+                self.newest = col
+
+    ##
+    # @brief Colonnes visibles, de la plus ancienne à la plus récente
+    # @return Liste de (x, slot) des colonnes renseignées
+    def visible(self):
+        if self.newest is None:
+            return []
+        n, first = self.columns, self.newest - self.columns + 1
+        return [(x, (first + x) % n) for x in range(n) if self.col_id[(first + x) % n] == first + x]
+
+    ##
+    # @brief Bornes d'un ensemble de voies sur les colonnes visibles
+    # @return (min, max), None si aucune valeur
+    def bounds(self, cols, channels):
+        lo, hi = math.inf, -math.inf
+        for c in channels:
+            clo, chi = self.lo[c], self.hi[c]
+            for _, s in cols:
+                if clo[s] < lo:
+                    lo = clo[s]
+                if chi[s] > hi:
+                    hi = chi[s]
+        return (lo, hi) if lo <= hi else None
+
+    ##
+    # @brief Coordonnées d'une voie : un trait vertical min -> max par colonne, reliés
+    # @param cols Colonnes visibles (visible())
+    # @param y Fonction valeur -> ordonnée (pixels)
+    # @param x0 Abscisse de la première colonne
+    def coords(self, c, cols, y, x0):
+        lo, hi = self.lo[c], self.hi[c]
+        out = []
+        up = True
+        for x, s in cols:
+            a, b = lo[s], hi[s]
+            if a > b:
+                continue
+            px = x0 + x
+            # Sens alterné : le trait suivant repart du bout atteint par le précédent
+            if up:
+                out += (px, y(a), px, y(b))
+            else:
+                out += (px, y(b), px, y(a))
+            up = not up
+        return out
+
+##
+# @class TelemPlot
+# @brief Canevas à trois bandes (accélération, gyroscope, vitesse) alimenté par un SampleRing
+class TelemPlot(tk.Canvas):
+    def __init__(self, master, ring, height=300):
+        super().__init__(master, height=height, bg=PLOT_BG, highlightthickness=0)
+        self.ring = ring
+        self.tail = ring.head
+        self.skipped = 0
+        self.dec = None
+        self.lines = []
+        self.labels = []
+        self.after_id = None
+        self.bind("<Configure>", lambda _e: self._layout())
+
+    ##
+    # @brief Démarre les redessins périodiques
+    def start(self):
+        if self.after_id is None:
+            self.after_id = self.after(PLOT_REFRESH_MS, self._refresh)
+
+    def stop(self):
+        if self.after_id is not None:
+            self.after_cancel(self.after_id)
+            self.after_id = None
+
+    ##
+    # @brief (Re)crée les objets du canevas et la décimation à la taille courante
+    # L'historique encore présent dans l'anneau est rangé à nouveau : le tracé survit
+    # au redimensionnement
+    def _layout(self):
+        w, h = self.winfo_width(), self.winfo_height()
+        if w <= PLOT_LEFT_PX + 2 or h <= 3 * PLOT_TITLE_PX:
+            return
+        self.delete("all")
+        window_us = int(PLOT_WINDOW_S * 1e6)
+        self.dec = ColumnDecimator(w - PLOT_LEFT_PX, window_us)
+        strip_h = h / len(PLOT_STRIPS)
+        self.lines = []
+        self.labels = []
+        for k, (title, channels, _) in enumerate(PLOT_STRIPS):
+            top = k * strip_h
+            self.create_line(PLOT_LEFT_PX, top + strip_h - 1, w, top + strip_h - 1, fill=PLOT_GRID)
+            self.create_text(PLOT_LEFT_PX + 4, top + 2, text=title, anchor="nw", fill=PLOT_TEXT, font=("Consolas", 9))
+            self.labels.append((self.create_text(PLOT_LEFT_PX - 4, top + PLOT_TITLE_PX, anchor="ne", fill=PLOT_TEXT,
+                                                 font=("Consolas", 8)),
+                                self.create_text(PLOT_LEFT_PX - 4, top + strip_h - 2, anchor="se", fill=PLOT_TEXT,
+                                                 font=("Consolas", 8))))
+            self.lines.append([self.create_line(0, 0, 0, 0, fill=PLOT_COLORS[i % len(PLOT_COLORS)])
+                               for i in range(len(channels))])
+
+        # Historique : tout ce qui est encore lisible et tombe dans la fenêtre
+        start, end, _ = self.ring.readable(0)
+        self.dec.add(self.ring, start, end)
+        self.tail = end
+        self._draw()
+
+    def _refresh(self):
+        self.after_id = self.after(PLOT_REFRESH_MS, self._refresh)
+        if self.dec is None:
+            return
+        start, end, skipped = self.ring.readable(self.tail)
+        self.skipped += skipped
+        if end == start:
+            return
+        self.dec.add(self.ring, start, end)
+        self.tail = end
+        self._draw()
+
+    ##
+    # @brief Redessine toutes les voies (un appel coords par voie)
+    def _draw(self):
+        dec = self.dec
+        cols = dec.visible()
+        strip_h = self.winfo_height() / len(PLOT_STRIPS)
+        for k, (_, channels, scale) in enumerate(PLOT_STRIPS):
+            top = k * strip_h + PLOT_TITLE_PX
+            span_h = strip_h - PLOT_TITLE_PX - 4
+            b = dec.bounds(cols, channels)
+            if b is None:
+                for line in self.lines[k]:
+                    self.coords(line, 0, 0, 0, 0)
+                continue
+            lo, hi = b
+            if hi - lo < 1e-9:
+                lo, hi = lo - 0.5 / scale, hi + 0.5 / scale
+            k_px = span_h / (hi - lo)
+            y = lambda v, lo=lo, top=top, k_px=k_px: top + span_h - (v - lo) * k_px
+            for c, line in zip(channels, self.lines[k]):
+                pts = dec.coords(c, cols, y, PLOT_LEFT_PX)
+                if len(pts) < 4:
+                    pts = [0, 0, 0, 0]
+                self.coords(line, *pts)
+            self.itemconfigure(self.labels[k][0], text=f"{hi * scale:.3g}")
+            self.itemconfigure(self.labels[k][1], text=f"{lo * scale:.3g}")